@@ -0,0 +1,126 @@
+//
+//  HUMAStarPathfinderTMXLayerAdapter.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 8/5/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+#import "HUMAStarPathfinder.h"
+
+/**
+ *	A ready-made HUMAStarPathfinderDelegate for Cocos2d tile maps. Instead of looking up tile properties for every query, the adapter builds a
+ *  GID-indexed table of walkability and cost from the tileset properties once, then answers queries by indexing straight into the layers'
+ *  tiles arrays. Tiles are handed to the pathfinder in bulk, so the pathfinder caches them (see -invalidateCachedTilesInRect:).
+ *
+ *  A tile with a GID is walkable if its walkablePropertyName property is true. A tile without a GID is walkable. A tile's cost is its
+ *  costPropertyName property, or the pathfinder's baseMovementCost if it has none.
+ *
+ *  The adapter reads the layers' tiles directly, so don't call -releaseMap on either layer while the adapter is in use.
+ */
+@interface HUMAStarPathfinderTMXLayerAdapter : NSObject <HUMAStarPathfinderDelegate>
+
+/**
+ *	The pathfinder the adapter provides tile data to. Setting this property also makes the adapter the pathfinder's delegate. The pathfinder doesn't
+ *  retain its delegate, so you must keep a strong reference to the adapter.
+ */
+@property (nonatomic, weak) HUMAStarPathfinder *pathfinder;
+
+/**
+ *	The tile map the layers belong to. Used to look up tileset properties.
+ */
+@property (nonatomic, strong, readonly) CCTMXTiledMap *tiledMap;
+
+/**
+ *	The layer whose tiles determine walkability, or nil if every tile is walkable.
+ */
+@property (nonatomic, strong, readonly) CCTMXLayer *walkabilityLayer;
+
+/**
+ *	The layer whose tiles determine movement cost, or nil if every tile uses the pathfinder's baseMovementCost.
+ */
+@property (nonatomic, strong, readonly) CCTMXLayer *costLayer;
+
+/**
+ *	The name of the tile property holding walkability. Changing it rebuilds the lookup tables.
+ *
+ *  The default value is @"walkable".
+ */
+@property (nonatomic, copy) NSString *walkablePropertyName;
+
+/**
+ *	The name of the tile property holding movement cost. Changing it rebuilds the lookup tables.
+ *
+ *  The default value is @"cost".
+ */
+@property (nonatomic, copy) NSString *costPropertyName;
+
+/**
+ *	Initializes and returns a newly allocated adapter for the provided layers of a tile map.
+ *
+ *	@param	tiledMap				The tile map the layers belong to.
+ *	@param	walkabilityLayerName	The name of the layer that determines walkability, or nil if every tile is walkable.
+ *	@param	costLayerName			The name of the layer that determines movement cost, or nil to use the base movement cost everywhere.
+ *
+ *	@return	An initialized adapter.
+ */
++ (instancetype)adapterWithTiledMap:(CCTMXTiledMap *)tiledMap walkabilityLayerNamed:(NSString *)walkabilityLayerName costLayerNamed:(NSString *)costLayerName;
+
+/**
+ *	Initializes and returns a newly allocated adapter for the provided layers of a tile map.
+ *
+ *	@param	tiledMap			The tile map the layers belong to.
+ *	@param	walkabilityLayer	The layer that determines walkability, or nil if every tile is walkable.
+ *	@param	costLayer			The layer that determines movement cost, or nil to use the base movement cost everywhere.
+ *
+ *	@return	An initialized adapter.
+ */
+- (id)initWithTiledMap:(CCTMXTiledMap *)tiledMap walkabilityLayer:(CCTMXLayer *)walkabilityLayer costLayer:(CCTMXLayer *)costLayer;
+
+/**
+ *	Rebuilds the GID lookup tables from the tileset properties and invalidates the pathfinder's cached tiles. Call this if tile properties are changed at runtime.
+ */
+- (void)reloadTileProperties;
+
+///---------------------------
+/// @name Editing Tiles
+///---------------------------
+
+/**
+ *	Sets the tile GID on a layer and invalidates the pathfinder's cached data for that tile. Use these in place of the CCTMXLayer methods of the same
+ *  name so the pathfinder sees the change.
+ *
+ *	@param	gid				The new GID. Must belong to the layer's tileset.
+ *	@param	tileCoordinate	The location of the tile within the layer.
+ *	@param	layer			The layer to edit.
+ */
+- (void)setTileGID:(uint32_t)gid at:(CGPoint)tileCoordinate inLayer:(CCTMXLayer *)layer;
+- (void)setTileGID:(uint32_t)gid at:(CGPoint)tileCoordinate withFlags:(ccTMXTileFlags)flags inLayer:(CCTMXLayer *)layer;
+
+/**
+ *	Removes the tile from a layer and invalidates the pathfinder's cached data for that tile.
+ *
+ *	@param	tileCoordinate	The location of the tile within the layer.
+ *	@param	layer			The layer to edit.
+ */
+- (void)removeTileAt:(CGPoint)tileCoordinate inLayer:(CCTMXLayer *)layer;
+
+///---------------------------
+/// @name Navigation Meshes
+///---------------------------
+
+/**
+ *	Builds a navigation mesh (see -[HUMAStarPathfinder navigationMeshWithObstaclePolygons:polylines:cellsPerTile:]) that leaves out the
+ *  pathfinder's unwalkable tiles and the collision shapes of an object group. Polygon objects are obstacles, polyline objects block the cells
+ *  they cross, and any other object with a width and height, such as a rectangle or an ellipse, blocks its bounding box.
+ *
+ *	@param	groupName		The name of the object group holding the collision shapes.
+ *	@param	cellsPerTile	The number of mesh cells across each tile. Between 1 and 16.
+ *
+ *	@return	The navigation mesh, or nil if the adapter has no pathfinder.
+ */
+- (HUMAStarPathfinderNavigationMesh *)navigationMeshWithObstacleGroupNamed:(NSString *)groupName cellsPerTile:(NSUInteger)cellsPerTile;
+
+@end
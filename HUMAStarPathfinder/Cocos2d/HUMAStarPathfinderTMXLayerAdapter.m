@@ -0,0 +1,331 @@
+//
+//  HUMAStarPathfinderTMXLayerAdapter.m
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 8/5/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import "HUMAStarPathfinderTMXLayerAdapter.h"
+#import "HUMAStarPathfinderNavigationMesh.h"
+
+/**
+ *	Stored in the cost table for GIDs without a cost property. Resolved to the pathfinder's baseMovementCost when queried.
+ */
+static const uint32_t HUMTMXDefaultCost = UINT32_MAX;
+
+@interface HUMAStarPathfinderTMXLayerAdapter () {
+	uint8_t *_walkableForGID;
+	uint32_t _walkableGIDCount;
+
+	uint32_t *_costForGID;
+	uint32_t _costGIDCount;
+}
+
+@end
+
+@implementation HUMAStarPathfinderTMXLayerAdapter
+
++ (instancetype)adapterWithTiledMap:(CCTMXTiledMap *)tiledMap walkabilityLayerNamed:(NSString *)walkabilityLayerName costLayerNamed:(NSString *)costLayerName {
+	CCTMXLayer *walkabilityLayer = walkabilityLayerName ? [tiledMap layerNamed:walkabilityLayerName] : nil;
+	CCTMXLayer *costLayer = costLayerName ? [tiledMap layerNamed:costLayerName] : nil;
+
+	return [[self alloc] initWithTiledMap:tiledMap walkabilityLayer:walkabilityLayer costLayer:costLayer];
+}
+
+- (id)initWithTiledMap:(CCTMXTiledMap *)tiledMap walkabilityLayer:(CCTMXLayer *)walkabilityLayer costLayer:(CCTMXLayer *)costLayer {
+	NSAssert(tiledMap, @"tiledMap cannot be nil.");
+	NSAssert(!walkabilityLayer || walkabilityLayer.tiles, @"The walkability layer's tiles have been released.");
+	NSAssert(!costLayer || costLayer.tiles, @"The cost layer's tiles have been released.");
+
+	self = [super init];
+	if (self) {
+		_tiledMap = tiledMap;
+		_walkabilityLayer = walkabilityLayer;
+		_costLayer = costLayer;
+		_walkablePropertyName = [@"walkable" copy];
+		_costPropertyName = [@"cost" copy];
+
+		[self buildLookupTables];
+	}
+
+	return self;
+}
+
+- (void)dealloc {
+	free(_walkableForGID);
+	free(_costForGID);
+}
+
+#pragma mark - Properties
+- (void)setPathfinder:(HUMAStarPathfinder *)pathfinder {
+	_pathfinder = pathfinder;
+	pathfinder.delegate = self;
+}
+
+- (void)setWalkablePropertyName:(NSString *)walkablePropertyName {
+	if (![_walkablePropertyName isEqualToString:walkablePropertyName]) {
+		_walkablePropertyName = [walkablePropertyName copy];
+		[self reloadTileProperties];
+	}
+}
+
+- (void)setCostPropertyName:(NSString *)costPropertyName {
+	if (![_costPropertyName isEqualToString:costPropertyName]) {
+		_costPropertyName = [costPropertyName copy];
+		[self reloadTileProperties];
+	}
+}
+
+#pragma mark - Lookup Tables
+- (void)reloadTileProperties {
+	[self buildLookupTables];
+	[self.pathfinder invalidateAllCachedTiles];
+}
+
+/**
+ *	Determines the number of GIDs a layer can hold: every GID in its tileset, plus any larger GID already placed in the layer.
+ *
+ *	@param	layer	The layer being inspected.
+ *
+ *	@return	One more than the largest GID the layer can reference.
+ */
+- (uint32_t)GIDCountForLayer:(CCTMXLayer *)layer {
+	CCTMXTilesetInfo *tileset = layer.tileset;
+	uint32_t count = 1;
+
+	if (tileset && tileset.tileSize.width > 0 && tileset.tileSize.height > 0) {
+		NSUInteger columns = (tileset.imageSize.width - tileset.margin * 2 + tileset.spacing) / (tileset.tileSize.width + tileset.spacing);
+		NSUInteger rows = (tileset.imageSize.height - tileset.margin * 2 + tileset.spacing) / (tileset.tileSize.height + tileset.spacing);
+		count = MAX(count, tileset.firstGid + columns * rows);
+	}
+
+	uint32_t *tiles = layer.tiles;
+	NSUInteger tileCount = layer.layerSize.width * layer.layerSize.height;
+
+	for (NSUInteger i = 0; i < tileCount; i++) {
+		uint32_t gid = tiles[i] & kCCFlippedMask;
+		count = MAX(count, gid + 1);
+	}
+
+	return count;
+}
+
+- (void)buildLookupTables {
+	free(_walkableForGID);
+	free(_costForGID);
+	_walkableForGID = NULL;
+	_costForGID = NULL;
+	_walkableGIDCount = 0;
+	_costGIDCount = 0;
+
+	if (self.walkabilityLayer) {
+		_walkableGIDCount = [self GIDCountForLayer:self.walkabilityLayer];
+		_walkableForGID = malloc(_walkableGIDCount * sizeof(uint8_t));
+
+		// tiles without a GID are walkable. Tiles with a GID are only walkable if their properties say so.
+		_walkableForGID[0] = 1;
+		for (uint32_t gid = 1; gid < _walkableGIDCount; gid++) {
+			NSDictionary *properties = [self.tiledMap propertiesForGID:gid];
+			_walkableForGID[gid] = [properties[self.walkablePropertyName] boolValue] ? 1 : 0;
+		}
+	}
+
+	if (self.costLayer) {
+		_costGIDCount = [self GIDCountForLayer:self.costLayer];
+		_costForGID = malloc(_costGIDCount * sizeof(uint32_t));
+
+		_costForGID[0] = HUMTMXDefaultCost;
+		for (uint32_t gid = 1; gid < _costGIDCount; gid++) {
+			NSDictionary *properties = [self.tiledMap propertiesForGID:gid];
+			id cost = properties[self.costPropertyName];
+			_costForGID[gid] = cost ? (uint32_t)[cost integerValue] : HUMTMXDefaultCost;
+		}
+	}
+}
+
+static inline BOOL HUMTMXWalkableForGID(const uint8_t *table, uint32_t count, uint32_t gid) {
+	gid &= kCCFlippedMask;
+	return gid < count ? table[gid] : NO;
+}
+
+static inline NSUInteger HUMTMXCostForGID(const uint32_t *table, uint32_t count, uint32_t gid, NSUInteger defaultCost) {
+	gid &= kCCFlippedMask;
+	uint32_t cost = gid < count ? table[gid] : HUMTMXDefaultCost;
+	return cost == HUMTMXDefaultCost ? defaultCost : cost;
+}
+
+#pragma mark - Editing Tiles
+- (void)setTileGID:(uint32_t)gid at:(CGPoint)tileCoordinate inLayer:(CCTMXLayer *)layer {
+	[self setTileGID:gid at:tileCoordinate withFlags:0 inLayer:layer];
+}
+
+- (void)setTileGID:(uint32_t)gid at:(CGPoint)tileCoordinate withFlags:(ccTMXTileFlags)flags inLayer:(CCTMXLayer *)layer {
+	NSAssert(layer != self.walkabilityLayer || (gid & kCCFlippedMask) < _walkableGIDCount, @"The GID does not belong to the walkability layer's tileset.");
+	NSAssert(layer != self.costLayer || (gid & kCCFlippedMask) < _costGIDCount, @"The GID does not belong to the cost layer's tileset.");
+
+	[layer setTileGID:gid at:tileCoordinate withFlags:flags];
+	[self invalidateTileAt:tileCoordinate inLayer:layer];
+}
+
+- (void)removeTileAt:(CGPoint)tileCoordinate inLayer:(CCTMXLayer *)layer {
+	[layer removeTileAt:tileCoordinate];
+	[self invalidateTileAt:tileCoordinate inLayer:layer];
+}
+
+- (void)invalidateTileAt:(CGPoint)tileCoordinate inLayer:(CCTMXLayer *)layer {
+	if (layer == self.walkabilityLayer || layer == self.costLayer) {
+		[self.pathfinder invalidateCachedTilesInRect:CGRectMake(tileCoordinate.x, tileCoordinate.y, 1, 1)];
+	}
+}
+
+#pragma mark - Navigation Meshes
+/**
+ *	Converts a point of an object to a position for the pathfinder. Cocos2d stores object coordinates in map pixels with the origin at the
+ *  bottom-left, while the pathfinder may use another tile size and origin.
+ */
+- (NSValue *)positionForObjectPoint:(CGPoint)point {
+	CGSize mapTileSize = self.tiledMap.tileSize;
+	CGSize tileSize = self.pathfinder.tileSize;
+	CGFloat x = point.x / mapTileSize.width * tileSize.width;
+	CGFloat y = point.y / mapTileSize.height * tileSize.height;
+
+	if (self.pathfinder.coordinateSystemOrigin == HUMCoodinateSystemOriginTopLeft) {
+		y = self.pathfinder.tileMapSize.height * tileSize.height - y;
+	}
+
+	return [NSValue valueWithCGPoint:CGPointMake(x, y)];
+}
+
+/**
+ *	Parses the points of a polygon or polyline object, a list of "x,y" pairs relative to the object's position with y pointing down.
+ *
+ *	@return	An NSArray of NSValue-wrapped positions.
+ */
+- (NSArray *)positionsForObjectPoints:(NSString *)pointsString origin:(CGPoint)origin {
+	NSMutableArray *positions = [NSMutableArray array];
+
+	for (NSString *pair in [pointsString componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]]) {
+		NSArray *components = [pair componentsSeparatedByString:@","];
+		if (components.count != 2) {
+			continue;
+		}
+
+		CGPoint point = CGPointMake(origin.x + [components[0] floatValue], origin.y - [components[1] floatValue]);
+		[positions addObject:[self positionForObjectPoint:point]];
+	}
+
+	return positions;
+}
+
+- (HUMAStarPathfinderNavigationMesh *)navigationMeshWithObstacleGroupNamed:(NSString *)groupName cellsPerTile:(NSUInteger)cellsPerTile {
+	if (!self.pathfinder) {
+		return nil;
+	}
+
+	CCTMXObjectGroup *group = [self.tiledMap objectGroupNamed:groupName];
+	NSMutableArray *polygons = [NSMutableArray array];
+	NSMutableArray *polylines = [NSMutableArray array];
+
+	for (NSDictionary *object in group.objects) {
+		CGPoint origin = CGPointMake([object[@"x"] floatValue], [object[@"y"] floatValue]);
+		CGFloat width = [object[@"width"] floatValue];
+		CGFloat height = [object[@"height"] floatValue];
+
+		if (object[@"polygonPoints"]) {
+			[polygons addObject:[self positionsForObjectPoints:object[@"polygonPoints"] origin:origin]];
+		}
+		else if (object[@"polylinePoints"]) {
+			[polylines addObject:[self positionsForObjectPoints:object[@"polylinePoints"] origin:origin]];
+		}
+		else if (width > 0 && height > 0) {
+			// the object's y is the bottom of its bounding box
+			[polygons addObject:@[[self positionForObjectPoint:origin],
+								  [self positionForObjectPoint:CGPointMake(origin.x + width, origin.y)],
+								  [self positionForObjectPoint:CGPointMake(origin.x + width, origin.y + height)],
+								  [self positionForObjectPoint:CGPointMake(origin.x, origin.y + height)]]];
+		}
+	}
+
+	return [self.pathfinder navigationMeshWithObstaclePolygons:polygons polylines:polylines cellsPerTile:cellsPerTile];
+}
+
+#pragma mark - HUMAStarPathfinderDelegate
+- (BOOL)pathfinder:(HUMAStarPathfinder *)pathfinder canWalkToNodeAtTileLocation:(CGPoint)tileLocation {
+	CCTMXLayer *layer = self.walkabilityLayer;
+	if (!layer) {
+		return YES;
+	}
+
+	NSUInteger index = tileLocation.x + tileLocation.y * layer.layerSize.width;
+	return HUMTMXWalkableForGID(_walkableForGID, _walkableGIDCount, layer.tiles[index]);
+}
+
+- (NSUInteger)pathfinder:(HUMAStarPathfinder *)pathfinder costForNodeAtTileLocation:(CGPoint)tileLocation {
+	CCTMXLayer *layer = self.costLayer;
+	if (!layer) {
+		return pathfinder.baseMovementCost;
+	}
+
+	NSUInteger index = tileLocation.x + tileLocation.y * layer.layerSize.width;
+	return HUMTMXCostForGID(_costForGID, _costGIDCount, layer.tiles[index], pathfinder.baseMovementCost);
+}
+
+- (void)pathfinder:(HUMAStarPathfinder *)pathfinder getWalkableFlags:(BOOL *)walkableFlags forTilesInRect:(CGRect)tileRect {
+	NSUInteger minX = tileRect.origin.x;
+	NSUInteger minY = tileRect.origin.y;
+	NSUInteger width = tileRect.size.width;
+	NSUInteger height = tileRect.size.height;
+	CCTMXLayer *layer = self.walkabilityLayer;
+
+	if (!layer) {
+		memset(walkableFlags, YES, width * height * sizeof(BOOL));
+		return;
+	}
+
+	const uint32_t *tiles = layer.tiles;
+	const uint8_t *table = _walkableForGID;
+	uint32_t count = _walkableGIDCount;
+	NSUInteger layerWidth = layer.layerSize.width;
+
+	for (NSUInteger y = 0; y < height; y++) {
+		const uint32_t *row = tiles + (minY + y) * layerWidth + minX;
+		BOOL *flags = walkableFlags + y * width;
+
+		for (NSUInteger x = 0; x < width; x++) {
+			flags[x] = HUMTMXWalkableForGID(table, count, row[x]);
+		}
+	}
+}
+
+- (void)pathfinder:(HUMAStarPathfinder *)pathfinder getCosts:(NSUInteger *)costs forTilesInRect:(CGRect)tileRect {
+	NSUInteger minX = tileRect.origin.x;
+	NSUInteger minY = tileRect.origin.y;
+	NSUInteger width = tileRect.size.width;
+	NSUInteger height = tileRect.size.height;
+	NSUInteger defaultCost = pathfinder.baseMovementCost;
+	CCTMXLayer *layer = self.costLayer;
+
+	if (!layer) {
+		for (NSUInteger i = 0; i < width * height; i++) {
+			costs[i] = defaultCost;
+		}
+		return;
+	}
+
+	const uint32_t *tiles = layer.tiles;
+	const uint32_t *table = _costForGID;
+	uint32_t count = _costGIDCount;
+	NSUInteger layerWidth = layer.layerSize.width;
+
+	for (NSUInteger y = 0; y < height; y++) {
+		const uint32_t *row = tiles + (minY + y) * layerWidth + minX;
+		NSUInteger *rowCosts = costs + y * width;
+
+		for (NSUInteger x = 0; x < width; x++) {
+			rowCosts[x] = HUMTMXCostForGID(table, count, row[x], defaultCost);
+		}
+	}
+}
+
+@end
@@ -8,6 +8,69 @@
 
 #import <Foundation/Foundation.h>
 
+/**
+ *	The domain of the errors reported by HUMAStarPathfinder.
+ */
+extern NSString * const HUMAStarPathfinderErrorDomain;
+
+typedef NS_ENUM(NSInteger, HUMAStarPathfinderErrorCode) {
+	/**
+	 *	The navigation file, or the map it is checked against, couldn't be read.
+	 */
+	HUMAStarPathfinderErrorNavigationFileUnreadable = 1,
+	
+	/**
+	 *	The file isn't a navigation file, or is truncated.
+	 */
+	HUMAStarPathfinderErrorNavigationFileInvalid,
+	
+	/**
+	 *	The navigation file was written by a newer, incompatible version of the format.
+	 */
+	HUMAStarPathfinderErrorNavigationFileUnsupportedVersion,
+	
+	/**
+	 *	The navigation file was built from a different version of the map and needs to be baked again.
+	 */
+	HUMAStarPathfinderErrorNavigationFileStale,
+	
+	/**
+	 *	The data isn't a serialized subgoal graph, or is truncated.
+	 */
+	HUMAStarPathfinderErrorSubgoalGraphInvalid,
+	
+	/**
+	 *	The subgoal graph was serialized by a newer, incompatible version of the format.
+	 */
+	HUMAStarPathfinderErrorSubgoalGraphUnsupportedVersion,
+	
+	/**
+	 *	The subgoal graph was built from a different map, or with different movement rules, and needs to be built again.
+	 */
+	HUMAStarPathfinderErrorSubgoalGraphStale,
+	
+	/**
+	 *	The data isn't a serialized contraction hierarchy, or is truncated.
+	 */
+	HUMAStarPathfinderErrorContractionHierarchyInvalid,
+	
+	/**
+	 *	The contraction hierarchy was serialized by a newer, incompatible version of the format.
+	 */
+	HUMAStarPathfinderErrorContractionHierarchyUnsupportedVersion,
+	
+	/**
+	 *	The contraction hierarchy was built from a different map, with different costs, or with different movement rules, and needs to be
+	 *  built again.
+	 */
+	HUMAStarPathfinderErrorContractionHierarchyStale,
+	
+	/**
+	 *	The trace file couldn't be created.
+	 */
+	HUMAStarPathfinderErrorTraceUnwritable
+};
+
 typedef NS_ENUM(NSUInteger, HUMAStarDistanceType) {
 	/**
 	 *	Useful when on a square grid that allows 4 directions of movement. Also known as taxicab distance.
@@ -40,11 +103,122 @@ typedef NS_ENUM(NSUInteger, HUMCoodinateSystemOrigin) {
 	HUMCoodinateSystemOriginBottomLeft
 };
 
-@class HUMAStarPathfinderNode;
+typedef NS_ENUM(NSUInteger, HUMAStarSearchMode) {
+	/**
+	 *	Searches from the start toward the target.
+	 */
+	HUMAStarSearchModeUnidirectional = 0,
+	
+	/**
+	 *	Searches from the start and from the target at the same time until the two searches meet. Tends to expand fewer tiles when the
+	 *  heuristic is weak compared to tile costs, for example on maps with large movement costs, and more when it is already a close estimate.
+	 *  Finds a path of the same cost as HUMAStarSearchModeUnidirectional whenever the heuristic never overestimates.
+	 */
+	HUMAStarSearchModeBidirectional,
+	
+	/**
+	 *	A breadth-first search that expands 64 tiles at a time from a bit-packed copy of the map's walkability, for large, open maps where
+	 *  every move costs the same. Only used when pathDiagonally is NO, the delegate doesn't implement either cost method, and there are no
+	 *  cost layers. Otherwise the query runs as HUMAStarSearchModeUnidirectional. Walkability comes from the clearance map, which is built on
+	 *  the first such query.
+	 */
+	HUMAStarSearchModeBreadthFirst,
+	
+	/**
+	 *	Searches a graph of the corners of unwalkable tiles that can see each other, for sparse maps with few obstacles. Paths may move in any
+	 *  direction, so they cut straight across open ground and turn only at corners, and are the shortest such paths. Only used when unitSize is
+	 *  1, pathDiagonally is YES, the delegate doesn't implement either cost method, and there are no cost layers. Otherwise the query runs as
+	 *  HUMAStarSearchModeUnidirectional. The graph is built on the first such query and brought up to date from -invalidateCachedTilesInRect:.
+	 */
+	HUMAStarSearchModeVisibilityGraph,
+	
+	/**
+	 *	A fringe search that only keeps state for the tiles it reaches, and never holds more than boundedSearchMemoryLimit bytes of it, for
+	 *  huge maps where a search context for every tile won't fit. If the search outgrows the limit it goes on as an A* that keeps four bits for
+	 *  each tile of the map and state only for its open tiles, and if even that doesn't fit, finishes as an iterative deepening A*, which can
+	 *  take far longer. A query that expands four tiles for each byte of the limit gives up and returns nil. Finds a path of the same cost
+	 *  as HUMAStarSearchModeUnidirectional whenever the heuristic never overestimates. Swamps are not skipped. See -boundedSearchStatistics.
+	 */
+	HUMAStarSearchModeBoundedMemory
+};
+
+typedef NS_ENUM(NSUInteger, HUMAStarMemoryLayout) {
+	/**
+	 *	Search state is stored one row of tiles after another. Best for small maps, where the whole search fits in the cache anyway.
+	 */
+	HUMAStarMemoryLayoutRowMajor = 0,
+	
+	/**
+	 *	Search state is stored in 16x16 tile blocks, each stored row by row, so the tiles above and below a tile are usually in the same block
+	 *  instead of a whole map row away.
+	 */
+	HUMAStarMemoryLayoutBlocked,
+	
+	/**
+	 *	Search state is stored in 16x16 tile blocks, each stored along a Z-order (Morton) curve, so neighboring tiles in any direction are
+	 *  usually in the same cache line.
+	 */
+	HUMAStarMemoryLayoutMorton
+};
+
+typedef NS_OPTIONS(NSUInteger, HUMAStarReachabilityOptions) {
+	/**
+	 *	Only the bitmap of reachable tiles.
+	 */
+	HUMAStarReachabilityOptionsNone = 0,
+	
+	/**
+	 *	Also record the movement cost of the cheapest path to every reachable tile.
+	 */
+	HUMAStarReachabilityOptionsIncludeCosts = 1 << 0,
+	
+	/**
+	 *	Also record the tile before every reachable tile on its cheapest path, so the path to any of them can be rebuilt.
+	 */
+	HUMAStarReachabilityOptionsIncludeParents = 1 << 1
+};
+
+/**
+ *	How a paged map's chunks have been loaded since the statistics were last reset.
+ */
+typedef struct {
+	NSUInteger residentChunkCount;		// chunks currently holding memory
+	NSUInteger loadCount;				// chunks loaded, including prefetches
+	NSUInteger faultCount;				// times a query had to wait for a chunk to load
+	NSUInteger prefetchCount;			// chunks loaded in the background
+	NSUInteger evictionCount;			// chunks dropped to stay within residentChunkLimit
+	NSUInteger queryCount;				// queries run against the paged map
+	NSUInteger lastQueryFaultCount;		// the faults of the query that finished last
+	NSUInteger maximumQueryFaultCount;	// the most faults of any single query
+} HUMAStarChunkStatistics;
+
+/**
+ *	How much memory HUMAStarSearchModeBoundedMemory queries have used since the statistics were last reset.
+ */
+typedef struct {
+	NSUInteger queryCount;					// bounded memory queries run
+	NSUInteger iterativeDeepeningCount;		// queries that outgrew the limit and finished with iterative deepening
+	NSUInteger memoryLimitCount;			// queries that failed because their path didn't fit in the limit
+	NSUInteger expansionLimitCount;			// queries that gave up after expanding four tiles for each byte of the limit
+	NSUInteger lastQueryPeakBytes;			// the most scratch memory the query that finished last held at once
+	NSUInteger maximumQueryPeakBytes;		// the most scratch memory any single query held at once
+} HUMAStarBoundedSearchStatistics;
+
+@class HUMAStarPathfinderReachableTiles;
+@class HUMAStarPathfinderRepairedPath;
+@class HUMAStarPathfinderFlowField;
+@class HUMAStarPathfinderNavigationMesh;
+@class HUMAStarPathfinderSubgoalGraph;
+@class HUMAStarPathfinderContractionHierarchy;
 @protocol HUMAStarPathfinderDelegate;
+@protocol HUMAStarPathfinderChunkProvider;
 
 /**
  *	An implementation of the A* Pathfinding algorithm for calculating a path between two points on a tile-based grid.
+ *
+ *  The pathfinder only holds the map data (size, walkability, costs, and movement rules). Each query runs against its own search context
+ *  taken from an internal pool, so a single pathfinder can be searched from any number of threads at once. Configure the pathfinder before
+ *  searching from multiple threads; changing its properties while queries are in flight only affects queries started afterwards.
  */
 @interface HUMAStarPathfinder : NSObject
 
@@ -121,6 +295,75 @@ typedef NS_ENUM(NSUInteger, HUMCoodinateSystemOrigin) {
  */
 @property (nonatomic, assign) NSUInteger baseMovementCost;
 
+/**
+ *	How the per-tile search state is laid out in memory. Doesn't affect the paths found, only how quickly they're found. The blocked layouts
+ *  have only been measured faster on maps of 2048x2048 tiles and up with tile costs, by up to about 20% and not in every run. Below that they
+ *  are within noise of row-major. Set it right after creating the pathfinder, since search contexts created for another layout are
+ *  reallocated the next time they're used.
+ *
+ *  The default value is HUMAStarMemoryLayoutRowMajor.
+ */
+@property (nonatomic, assign) HUMAStarMemoryLayout memoryLayout;
+
+/**
+ *	The most bytes of search state a HUMAStarSearchModeBoundedMemory query may hold at once, not counting the path it returns. A query whose
+ *  limit can't hold the tiles of its path returns nil, as does one that expands four tiles for each byte of the limit without reaching its
+ *  target, which only happens once it has fallen back to iterative deepening. Must be at least 2048.
+ *
+ *  The default value is 262144.
+ */
+@property (nonatomic, assign) NSUInteger boundedSearchMemoryLimit;
+
+/**
+ *	If YES, searches skip swamps: dead-end rooms, pockets along corridors, and other small regions a cheapest path never has to enter unless it
+ *  starts or ends inside one. The swamps are found from the walkability of the whole map on the first query after it's set, and kept up to
+ *  date from -invalidateCachedTilesInRect:. Regions with a single way in are skipped whatever the costs and unit size. Regions with more
+ *  are only skipped when every tile costs baseMovementCost and unitSize is 1. Paths cost the same either way, but searches expand far
+ *  fewer tiles on maps with many side rooms and dead ends.
+ *
+ *  The default value is NO.
+ */
+@property (nonatomic, assign) BOOL prunesSwamps;
+
+/**
+ *	Provides the walkability and cost of a map too large to hold in memory, one square chunk at a time. When set, the pathfinder keeps at most
+ *  residentChunkLimit chunks loaded, evicting the least recently used ones, and asks the provider for the others as searches reach them.
+ *  The chunks around every chunk a search enters are loaded in the background, so a search only waits on chunks it outruns the prefetching
+ *  for. The delegate isn't asked about walkability or costs while a chunk provider is set.
+ *
+ *  Queries that need every tile, flow fields and queries with a unitSize above 1, HUMAStarSearchModeBreadthFirst or HUMAStarSearchModeVisibilityGraph, still read the whole map,
+ *  as does finding swamps when prunesSwamps is YES.
+ *
+ *  The default value is nil.
+ */
+@property (nonatomic, weak) id<HUMAStarPathfinderChunkProvider> chunkProvider;
+
+/**
+ *	The width and height in tiles of the chunks the chunk provider is asked for. Must be a power of two between 2 and 4096. Changing it discards
+ *  every loaded chunk.
+ *
+ *  The default value is 64.
+ */
+@property (nonatomic, assign) NSUInteger chunkSize;
+
+/**
+ *	The number of chunks kept loaded. A query holds on to up to four chunks while it runs, so the limit is only exceeded when more queries than
+ *  a quarter of it run at once. Changing it discards every loaded chunk.
+ *
+ *  The default value is 64.
+ */
+@property (nonatomic, assign) NSUInteger residentChunkLimit;
+
+/**
+ *	YES, if a navigation file is loaded. See -loadNavigationFileAtPath:sourceMapPath:error:.
+ */
+@property (nonatomic, readonly, getter = isNavigationFileLoaded) BOOL navigationFileLoaded;
+
+/**
+ *	YES, while queries are being recorded to a trace. See -startRecordingTraceToPath:error:.
+ */
+@property (nonatomic, readonly, getter = isRecordingTrace) BOOL recordingTrace;
+
 ///---------------------------
 /// @name Initialization
 ///---------------------------
@@ -165,6 +408,407 @@ typedef NS_ENUM(NSUInteger, HUMCoodinateSystemOrigin) {
  */
 - (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target;
 
+/**
+ *	Finds the shortest path from the start point to the target point for a unit that covers unitSize x unitSize tiles. The unit is anchored at
+ *  its top-left tile (the tile with the lowest x and y tile location) and covers the tiles to the right and below it, so every point in the path is
+ *  the position of the unit's anchor tile.
+ *
+ *  The first query with a unitSize greater than 1 builds a clearance map holding the largest square of walkable tiles anchored at every tile,
+ *  which is kept up to date incrementally as tiles are invalidated with -invalidateCachedTilesInRect:. Whenever the walkability of a tile
+ *  changes you must invalidate it, even if the delegate doesn't implement the bulk query methods.
+ *
+ *	@param	start		A CGPoint where the path should start.
+ *	@param	target		A CGPoint where the path should end.
+ *	@param	unitSize	The width and height of the unit in tiles. Must be between 1 and 255. A unitSize of 1 is equivalent to -findPathFromStart:toTarget:.
+ *
+ *	@return	See -findPathFromStart:toTarget:.
+ */
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target unitSize:(NSUInteger)unitSize;
+
+/**
+ *	Finds the shortest path from the start point to the target point for a unit that covers unitSize x unitSize tiles, using the provided search mode.
+ *
+ *	@param	start		A CGPoint where the path should start.
+ *	@param	target		A CGPoint where the path should end.
+ *	@param	unitSize	See -findPathFromStart:toTarget:unitSize:.
+ *	@param	searchMode	Whether to search from the start only, or from the start and target at once.
+ *
+ *	@return	See -findPathFromStart:toTarget:.
+ */
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target unitSize:(NSUInteger)unitSize searchMode:(HUMAStarSearchMode)searchMode;
+
+/**
+ *	Quickly finds the first part of a path from the start point toward the target point, for a unit to follow while the shortest path is still
+ *  being searched for. A greedy search heads straight for the target, expanding at most expansionLimit tiles, and stops at the tile closest
+ *  to the target if it doesn't reach it. The path only moves between walkable tiles, but can be much longer than the shortest one.
+ *
+ *	@param	start			A CGPoint where the path should start.
+ *	@param	target			A CGPoint the path should head toward.
+ *	@param	expansionLimit	The most tiles the search may expand.
+ *
+ *	@return	An NSArray of NSValue-wrapped CGPoints from the start toward the target, ending at the target if the search reached it. If the start and
+ *			target nodes are equal, the target node is not walkable, there is no valid path, or no tile closer to the target was found, then nil.
+ */
+- (NSArray *)findProvisionalPathFromStart:(CGPoint)start toTarget:(CGPoint)target expansionLimit:(NSUInteger)expansionLimit;
+
+/**
+ *	Releases the pooled search contexts that are not currently in use by a query. Useful when responding to a memory warning.
+ */
+- (void)purgeSearchContexts;
+
+/**
+ *	How much memory HUMAStarSearchModeBoundedMemory queries have used.
+ */
+- (HUMAStarBoundedSearchStatistics)boundedSearchStatistics;
+
+/**
+ *	Resets every count in boundedSearchStatistics.
+ */
+- (void)resetBoundedSearchStatistics;
+
+///---------------------------
+/// @name Path Costs
+///---------------------------
+
+/**
+ *	Finds the cost of the shortest path from the start point to the target point, without building the path. Cheaper than
+ *  -findPathFromStart:toTarget: when only the cost matters, e.g. to pick the closest of several destinations.
+ *
+ *	@param	start	A CGPoint where the path would start.
+ *	@param	target	A CGPoint where the path would end.
+ *
+ *	@return	The sum of the movement costs of the path's moves, 0 if the start and target nodes are equal, or NSNotFound if the target node is
+ *			not walkable or there is no valid path.
+ */
+- (NSUInteger)pathCostFromStart:(CGPoint)start toTarget:(CGPoint)target;
+
+/**
+ *	Finds the cost of the shortest path from the start point to the target point for a unit that covers unitSize x unitSize tiles, without
+ *  building the path. The path is always searched for with A*, as with HUMAStarSearchModeUnidirectional.
+ *
+ *	@param	start		A CGPoint where the path would start.
+ *	@param	target		A CGPoint where the path would end.
+ *	@param	unitSize	See -findPathFromStart:toTarget:unitSize:.
+ *
+ *	@return	See -pathCostFromStart:toTarget:.
+ */
+- (NSUInteger)pathCostFromStart:(CGPoint)start toTarget:(CGPoint)target unitSize:(NSUInteger)unitSize;
+
+/**
+ *	Finds the cost of the shortest path from the start point to each of several target points with a single search, which is guided toward the
+ *  bounds of the targets and stops once it has reached all of them. Much faster than a query per target when the targets are close together,
+ *  such as the cells of a formation or the candidates for the nearest resource.
+ *
+ *	@param	costs		Filled with count costs, in the order of the targets. See -pathCostFromStart:toTarget: for the value of each.
+ *	@param	start		A CGPoint where the paths would start.
+ *	@param	targets		count CGPoints where the paths would end.
+ *	@param	count		The number of targets.
+ *	@param	unitSize	See -findPathFromStart:toTarget:unitSize:.
+ */
+- (void)getPathCosts:(NSUInteger *)costs fromStart:(CGPoint)start toTargets:(const CGPoint *)targets count:(NSUInteger)count unitSize:(NSUInteger)unitSize;
+
+///---------------------------
+/// @name Path Repair
+///---------------------------
+
+/**
+ *	Brings a path up to date after tiles along it changed, without searching for the whole path again. If a move of the path is no longer
+ *  walkable, a detour from the tile before the first broken move to the tile after the last one is searched for within a few tiles of the
+ *  broken part and spliced into the path. Only if there is no such detour is the whole path searched for again, from its first point to its
+ *  last. A detour is the cheapest one near the broken part, but the repaired path as a whole may cost more than a new one would.
+ *
+ *  Invalidate the changed tiles with -invalidateCachedTilesInRect: first. Trim the points a unit has already passed from the path, so it
+ *  starts at the unit's position.
+ *
+ *	@param	path		A path returned by -findPathFromStart:toTarget:unitSize: for the same unitSize. Paths from HUMAStarSearchModeVisibilityGraph
+ *						can't be repaired and are always searched for again.
+ *	@param	tileRect	The rect of tiles that changed, in tile coordinates. Only moves into or past these tiles are checked.
+ *	@param	unitSize	See -findPathFromStart:toTarget:unitSize:.
+ *
+ *	@return	The path to follow, and whether it was repaired or searched for again.
+ */
+- (HUMAStarPathfinderRepairedPath *)repairPath:(NSArray *)path changedTilesInRect:(CGRect)tileRect unitSize:(NSUInteger)unitSize;
+
+///---------------------------
+/// @name Reachability
+///---------------------------
+
+/**
+ *	Finds every tile that can be reached from a tile for at most a maximum movement cost, using the same walkability, diagonal, and cost rules
+ *  as -findPathFromStart:toTarget:. Runs a single search no matter how many tiles are in range, which makes it suited to highlighting a unit's
+ *  movement range. Records costs and parents.
+ *
+ *	@param	tileLocation	The tile location to start from. It is always reachable, even if it isn't walkable.
+ *	@param	maximumCost		The largest movement cost a reachable tile may have.
+ *
+ *	@return	The reachable tiles, or nil if tileLocation is outside the tile map.
+ */
+- (HUMAStarPathfinderReachableTiles *)reachableTilesFromTile:(CGPoint)tileLocation withinCost:(NSUInteger)maximumCost;
+
+/**
+ *	Finds every tile that can be reached from a tile for at most a maximum movement cost, recording only what the options ask for.
+ *
+ *	@param	tileLocation	The tile location to start from. It is always reachable, even if it isn't walkable.
+ *	@param	maximumCost		The largest movement cost a reachable tile may have.
+ *	@param	options			Whether to record costs and parents in addition to the bitmap of reachable tiles.
+ *
+ *	@return	The reachable tiles, or nil if tileLocation is outside the tile map.
+ */
+- (HUMAStarPathfinderReachableTiles *)reachableTilesFromTile:(CGPoint)tileLocation withinCost:(NSUInteger)maximumCost options:(HUMAStarReachabilityOptions)options;
+
+///---------------------------
+/// @name Flow Fields
+///---------------------------
+
+/**
+ *	Computes the cost of the cheapest path from every tile to a target tile, and the first move of each of those paths, using the same
+ *  walkability, diagonal, and cost rules as -findPathFromStart:toTarget:. Suited to sending many units to the same rally point. The map is
+ *  split into blocks that are dispatched concurrently on the global concurrent queue. The speedup on multiple cores hasn't been measured. The
+ *  result is identical to a single Dijkstra search over the whole map however many cores it runs on.
+ *
+ *	@param	targetTileLocation	The tile location every path should lead to.
+ *
+ *	@return	The flow field, or nil if targetTileLocation is outside the tile map.
+ */
+- (HUMAStarPathfinderFlowField *)flowFieldToTile:(CGPoint)targetTileLocation;
+
+///---------------------------
+/// @name Navigation Meshes
+///---------------------------
+
+/**
+ *	Builds a navigation mesh of the map's walkable space for searching large, open maps. Searches over the mesh expand a few rectangles of
+ *  open ground instead of every tile in them, and return paths that run straight between obstacle corners rather than from tile center to
+ *  tile center. Tiles that aren't walkable and every tile covered by an obstacle are left out of the mesh.
+ *
+ *  Each tile is split into cellsPerTile x cellsPerTile cells, and obstacles block every cell they overlap, so paths keep clear of obstacles
+ *  but may stay up to a cell further away than they need to. Movement costs, diagonal rules, and cost layers don't apply to the mesh.
+ *
+ *	@param	polygons		NSArrays of NSValue-wrapped CGPoints, each the vertices of a closed obstacle polygon in positions relative to the
+ *							coordinateSystemOrigin. For example, the polygonPoints of the objects of a TMX object group. May be nil.
+ *	@param	polylines		NSArrays of NSValue-wrapped CGPoints, each an open chain of segments, such as walls, that blocks the cells it
+ *							crosses. May be nil.
+ *	@param	cellsPerTile	The number of cells across each tile. Between 1 and 16. Higher values follow obstacles more closely at the cost
+ *							of a larger mesh.
+ *
+ *	@return	The navigation mesh, or nil if the tileMapSize is empty.
+ */
+- (HUMAStarPathfinderNavigationMesh *)navigationMeshWithObstaclePolygons:(NSArray *)polygons polylines:(NSArray *)polylines cellsPerTile:(NSUInteger)cellsPerTile;
+
+///---------------------------
+/// @name Subgoal Graphs
+///---------------------------
+
+/**
+ *	Builds a subgoal graph of the map for fast shortest path queries. The graph is built from the walkability of every tile and the current
+ *  pathDiagonally, ignoreDiagonalBarriers and pathCanCrossBorders, and finds the same shortest paths as -findPathFromStart:toTarget: when
+ *  every tile costs the baseMovementCost. Tile costs and cost layers don't apply to it. Building takes time, so for large maps build the
+ *  graph offline, save its -dataRepresentation, and read it back with -subgoalGraphWithData:error:.
+ *
+ *	@return	The subgoal graph, or nil if the tileMapSize is empty, or pathDiagonally is YES and the baseMovementCost is below 3, which makes
+ *			a diagonal move cost no more than a straight one.
+ */
+- (HUMAStarPathfinderSubgoalGraph *)subgoalGraph;
+
+/**
+ *	Reads back a subgoal graph serialized with -[HUMAStarPathfinderSubgoalGraph dataRepresentation]. The graph must have been built from a
+ *  map of the same size and walkability, with the same movement rules and baseMovementCost, so reading it checks the walkability of every tile.
+ *
+ *	@param	data	The serialized graph.
+ *	@param	error	Set to an error in the HUMAStarPathfinderErrorDomain if the graph can't be used. May be NULL.
+ *
+ *	@return	The subgoal graph, or nil.
+ */
+- (HUMAStarPathfinderSubgoalGraph *)subgoalGraphWithData:(NSData *)data error:(NSError **)error;
+
+///---------------------------
+/// @name Contraction Hierarchies
+///---------------------------
+
+/**
+ *	Builds a contraction hierarchy of the map for fast cheapest path queries on maps that never change. Unlike a subgoal graph, the hierarchy
+ *  keeps the cost of every tile, including delegate costs and cost layers, and finds paths that cost the same as the ones
+ *  -findPathFromStart:toTarget: finds with the current movement rules. Contraction runs on every core, but still takes seconds on large maps,
+ *  so build the hierarchy offline, save its -dataRepresentation, and read it back with -contractionHierarchyWithData:error:.
+ *
+ *	@return	The contraction hierarchy, or nil if the tileMapSize is empty.
+ */
+- (HUMAStarPathfinderContractionHierarchy *)contractionHierarchy;
+
+/**
+ *	Reads back a contraction hierarchy serialized with -[HUMAStarPathfinderContractionHierarchy dataRepresentation]. The hierarchy must have
+ *  been built from a map of the same size, walkability, and costs, with the same movement rules, so reading it samples every tile.
+ *
+ *	@param	data	The serialized hierarchy.
+ *	@param	error	Set to an error in the HUMAStarPathfinderErrorDomain if the hierarchy can't be used. May be NULL.
+ *
+ *	@return	The contraction hierarchy, or nil.
+ */
+- (HUMAStarPathfinderContractionHierarchy *)contractionHierarchyWithData:(NSData *)data error:(NSError **)error;
+
+///---------------------------
+/// @name Cost Layers
+///---------------------------
+
+/**
+ *	The names of the cost layers, in the order they were added.
+ */
+- (NSArray *)costLayerNames;
+
+/**
+ *	Adds a named layer of per-tile values, all starting at 0. Every search adds the weighted sum of all layers to the cost of each tile,
+ *  rounded to the nearest integer and clamped to 0, on top of the cost from the delegate or baseMovementCost. The weighted sum is kept up to
+ *  date as layers change, so searches read a single value per tile however many layers there are.
+ *
+ *  Changing the tileMapSize resets the values of every layer to 0.
+ *
+ *	@param	name	A name for the layer, for example @"threat". Must not already be in use.
+ *	@param	weight	The weight the layer's values are added with. Negative weights make tiles cheaper.
+ */
+- (void)addCostLayerNamed:(NSString *)name weight:(CGFloat)weight;
+
+/**
+ *	Removes a cost layer.
+ *
+ *	@param	name	The name of the layer.
+ */
+- (void)removeCostLayerNamed:(NSString *)name;
+
+/**
+ *	@param	name	The name of the layer.
+ *
+ *	@return	The weight of the layer, or 0 if there is no layer with the name.
+ */
+- (CGFloat)weightForCostLayerNamed:(NSString *)name;
+
+/**
+ *	Changes the weight of a cost layer.
+ *
+ *	@param	weight	The new weight.
+ *	@param	name	The name of the layer.
+ */
+- (void)setWeight:(CGFloat)weight forCostLayerNamed:(NSString *)name;
+
+/**
+ *	Replaces the values of a rect of tiles in a cost layer. Only the tiles in the rect are recombined.
+ *
+ *	@param	values		tileRect.size.width * tileRect.size.height values, in row-major order.
+ *	@param	tileRect	The rect of tiles to replace, in tile coordinates. Tiles outside the tile map are ignored.
+ *	@param	name		The name of the layer.
+ */
+- (void)setValues:(const float *)values forTilesInRect:(CGRect)tileRect inCostLayerNamed:(NSString *)name;
+
+/**
+ *	Sets every tile in a rect of a cost layer to the same value.
+ *
+ *	@param	tileRect	The rect of tiles to set, in tile coordinates. Tiles outside the tile map are ignored.
+ *	@param	value		The new value.
+ *	@param	name		The name of the layer.
+ */
+- (void)fillTilesInRect:(CGRect)tileRect withValue:(float)value inCostLayerNamed:(NSString *)name;
+
+/**
+ *	Multiplies every value of a cost layer by factor and adds offset in a single pass over the layer. Useful for decaying a threat or
+ *  congestion map over time.
+ *
+ *	@param	name	The name of the layer.
+ *	@param	factor	The factor to multiply every value by, for example 0.9 to decay it by 10%.
+ *	@param	offset	The value to add to every value afterwards.
+ */
+- (void)scaleCostLayerNamed:(NSString *)name byFactor:(float)factor offset:(float)offset;
+
+///---------------------------
+/// @name Navigation Files
+///---------------------------
+
+/**
+ *	Memory maps a navigation file baked offline with HUMNavigationBaker (see Tools/HUMNavigationBaker) and uses it in place. Loading only reads
+ *  the file's header, so it takes the same time for any map size, and the pages of the file are shared with the OS file cache instead of
+ *  copied into the heap.
+ *
+ *  While a navigation file is loaded, the tileMapSize is the file's size and walkability comes from the file instead of the delegate. So do
+ *  costs, if the file has them. Searches between tiles in different connected components of the file's map return an empty path without
+ *  searching, as long as the pathfinder's movement rules allow no moves the file's components weren't built with.
+ *
+ *  Don't load or unload a navigation file while queries are running.
+ *
+ *	@param	path			The path of the navigation file.
+ *	@param	sourceMapPath	The path of the map the file was baked from, or nil. If provided, the file is rejected if the map has changed since.
+ *	@param	error			Set to an error in the HUMAStarPathfinderErrorDomain if the file can't be used. May be NULL.
+ *
+ *	@return	YES, if the file was loaded. NO, otherwise, in which case any previously loaded navigation file is still in use.
+ */
+- (BOOL)loadNavigationFileAtPath:(NSString *)path sourceMapPath:(NSString *)sourceMapPath error:(NSError **)error;
+
+/**
+ *	Unmaps the loaded navigation file. Walkability and costs come from the delegate again.
+ */
+- (void)unloadNavigationFile;
+
+///---------------------------
+/// @name Paged Maps
+///---------------------------
+
+/**
+ *	How the chunks of the paged map have been loaded. All zeros if there is no chunkProvider.
+ */
+- (HUMAStarChunkStatistics)chunkStatistics;
+
+/**
+ *	Resets every count in chunkStatistics except residentChunkCount.
+ */
+- (void)resetChunkStatistics;
+
+///---------------------------
+/// @name Tile Caching
+///---------------------------
+
+/**
+ *	Fetches and caches the tiles in the provided rect ahead of time using the delegate's bulk query methods. Tiles are otherwise fetched in blocks
+ *  as a search first reaches them. Does nothing if the delegate doesn't implement -pathfinder:getWalkableFlags:forTilesInRect: or
+ *  -pathfinder:getCosts:forTilesInRect:.
+ *
+ *	@param	tileRect	The rect of tiles to fetch, in tile coordinates.
+ */
+- (void)prefetchTilesInRect:(CGRect)tileRect;
+
+/**
+ *	Discards any cached walkability and costs for the tiles in the provided rect. They will be fetched from the delegate again the next time they are needed.
+ *  The clearance of the surrounding tiles is updated before the next query with a unitSize greater than 1.
+ *
+ *	@param	tileRect	The rect of tiles that changed, in tile coordinates.
+ */
+- (void)invalidateCachedTilesInRect:(CGRect)tileRect;
+
+/**
+ *	Discards all cached walkability and costs.
+ */
+- (void)invalidateAllCachedTiles;
+
+///---------------------------
+/// @name Query Traces
+///---------------------------
+
+/**
+ *	Starts recording every query the pathfinder runs to a trace file, along with the map it ran against and the settings it ran with, so slow
+ *  queries seen in the app can be replayed offline with the humtracereplay tool. The map is stored as the walkability and costs the searches
+ *  saw, with cost layers applied, so the trace doesn't need the delegate, navigation file, or chunk provider it came from.
+ *
+ *	The whole map is sampled when recording starts and again before the first query after any change to the whole map, so recording is best
+ *  kept to maps small enough to sample quickly. Changes to a rect of tiles, through -invalidateCachedTilesInRect: or a cost layer, only record
+ *  those tiles. Any recording already in progress is stopped first.
+ *
+ *	@param	path	The path of the trace file. Any file at the path is replaced.
+ *	@param	error	Set to an error in the HUMAStarPathfinderErrorDomain if the file can't be created. May be NULL.
+ *
+ *	@return	YES if recording started.
+ */
+- (BOOL)startRecordingTraceToPath:(NSString *)path error:(NSError **)error;
+
+/**
+ *	Stops recording and finishes the trace file. Does nothing if no trace is being recorded.
+ */
+- (void)stopRecordingTrace;
 
 ///---------------------------
 /// @name Position Helpers
@@ -194,12 +838,34 @@ typedef NS_ENUM(NSUInteger, HUMCoodinateSystemOrigin) {
  */
 - (CGPoint)tileLocationForPosition:(CGPoint)position;
 
+/**
+ *	Converts many tile locations to positions on screen at once, with the result -positionForTileLocation: gives for each, rounded to a float.
+ *  Faster than converting one point at a time when positioning many sprites a frame.
+ *
+ *	@param	positions		A buffer of count x, y pairs, filled with the position in the center of each tile. May be the same buffer as tileLocations.
+ *	@param	tileLocations	count x, y pairs of tile locations.
+ *	@param	count			The number of points.
+ */
+- (void)getPositions:(float *)positions forTileLocations:(const float *)tileLocations count:(NSUInteger)count;
+
+/**
+ *	Converts many positions on screen to tile locations at once, with the result -tileLocationForPosition: gives for each. Faster than converting
+ *  one point at a time when locating many units a frame.
+ *
+ *	@param	tileLocations	A buffer of count x, y pairs, filled with the location of the tile holding each position. May be the same buffer as positions.
+ *	@param	positions		count x, y pairs of positions on screen.
+ *	@param	count			The number of points.
+ */
+- (void)getTileLocations:(float *)tileLocations forPositions:(const float *)positions count:(NSUInteger)count;
+
 @end
 
 
 /**
  *	The delegate of a HUMAStarPathFinding object must conform to the HUMAStarPathfinderDelegate protocol. All methods are required and are used to determine the
  *  walkability of tiles.
+ *
+ *  If the pathfinder is searched from multiple threads, the delegate methods are called on each of those threads and must be safe to call concurrently.
  */
 @protocol HUMAStarPathfinderDelegate <NSObject>
 
@@ -227,4 +893,51 @@ typedef NS_ENUM(NSUInteger, HUMCoodinateSystemOrigin) {
  */
 - (NSUInteger)pathfinder:(HUMAStarPathfinder *)pathfinder costForNodeAtTileLocation:(CGPoint)tileLocation;
 
-@end
\ No newline at end of file
+/**
+ *	Asks the delegate for the walkability of every tile in a rect in a single call. Implement this when walkability is already stored in an array
+ *  (for example, a tile layer's GIDs) to avoid a message send per tile. A rect with a height of 1 is a single row.
+ *
+ *  When implemented, the pathfinder fetches walkability in blocks and caches the results, so -pathfinder:canWalkToNodeAtTileLocation: is no longer
+ *  called during a search. Call -invalidateCachedTilesInRect: on the pathfinder whenever the walkability of a tile changes.
+ *
+ *	@param	pathfinder		The pathfinder being used.
+ *	@param	walkableFlags	A buffer of tileRect.size.width * tileRect.size.height flags to fill in row-major order, starting with the tile at tileRect.origin.
+ *	@param	tileRect		The rect of tiles being inspected. Always lies within the tile map.
+ */
+- (void)pathfinder:(HUMAStarPathfinder *)pathfinder getWalkableFlags:(BOOL *)walkableFlags forTilesInRect:(CGRect)tileRect;
+
+/**
+ *	Asks the delegate for the cost of every tile in a rect in a single call. The cost counterpart of -pathfinder:getWalkableFlags:forTilesInRect:.
+ *
+ *  When implemented, the pathfinder fetches costs in blocks and caches the results, so -pathfinder:costForNodeAtTileLocation: is no longer
+ *  called during a search. Call -invalidateCachedTilesInRect: on the pathfinder whenever the cost of a tile changes.
+ *
+ *	@param	pathfinder		The pathfinder being used.
+ *	@param	costs			A buffer of tileRect.size.width * tileRect.size.height costs to fill in row-major order, starting with the tile at tileRect.origin.
+ *	@param	tileRect		The rect of tiles being inspected. Always lies within the tile map.
+ */
+- (void)pathfinder:(HUMAStarPathfinder *)pathfinder getCosts:(NSUInteger *)costs forTilesInRect:(CGRect)tileRect;
+
+@end
+
+
+/**
+ *	A chunk provider loads the tile data of a paged map (see chunkProvider) on demand, usually from disk.
+ */
+@protocol HUMAStarPathfinderChunkProvider <NSObject>
+
+@required
+/**
+ *	Asks the provider for the walkability and cost of every tile in a chunk. Called from whichever thread first needs the chunk, or from a
+ *  background queue when the chunk is prefetched, so it must be safe to call from multiple threads at once.
+ *
+ *	@param	pathfinder		The pathfinder being used.
+ *	@param	tileRect		The rect of tiles in the chunk. Chunks along the right and bottom edges of the map are cut short by the map's edges.
+ *	@param	walkableFlags	A buffer of tileRect.size.width * tileRect.size.height flags to fill in row-major order, starting with the tile at tileRect.origin.
+ *	@param	costs			A buffer of tileRect.size.width * tileRect.size.height costs to fill in the same order. Already filled with the baseMovementCost.
+ *
+ *	@return	YES, if the chunk was loaded. NO, if it couldn't be, in which case its tiles are treated as unwalkable until they are invalidated.
+ */
+- (BOOL)pathfinder:(HUMAStarPathfinder *)pathfinder loadChunkInRect:(CGRect)tileRect walkableFlags:(BOOL *)walkableFlags costs:(NSUInteger *)costs;
+
+@end
@@ -7,26 +7,151 @@
 //
 
 #import "HUMAStarPathfinder.h"
-#import "HUMAStarPathfinderNode.h"
+#import "HUMAStarPathfinderSearchContext.h"
+#import "HUMAStarPathfinderReachableTiles.h"
+#import "HUMAStarPathfinderRepairedPath.h"
+#import "HUMAStarPathfinderFlowField.h"
+#import "HUMAStarPathfinderFlowFieldSolver.h"
+#import "HUMAStarPathfinderTileCache.h"
+#import "HUMAStarPathfinderClearanceMap.h"
+#import "HUMAStarPathfinderCostLayers.h"
+#import "HUMAStarPathfinderNavigationFile.h"
+#import "HUMAStarPathfinderChunkCache.h"
+#import "HUMAStarPathfinderNavigationMesh.h"
+#import "HUMAStarPathfinderVisibilityGraph.h"
+#import "HUMAStarPathfinderSwamps.h"
+#import "HUMAStarPathfinderSubgoalGraph.h"
+#import "HUMAStarPathfinderContractionHierarchy.h"
+#import "HUMAStarPathfinderBoundedSearch.h"
+#import "HUMAStarPathfinderPathRepair.h"
+#import "HUMAStarPathfinderTrace.h"
+#import "HUMAStarPathfinderCoordinates.h"
+#import <pthread.h>
+
+NSString * const HUMAStarPathfinderErrorDomain = @"HUMAStarPathfinderErrorDomain";
 
 @interface HUMAStarPathfinder () {
 	struct {
 		unsigned int delegateCanWalkToNodeAtTileLocation:1;
 		unsigned int delegateCostForNodeAtTileLocation:1;
+		unsigned int delegateGetWalkableFlagsForTilesInRect:1;
+		unsigned int delegateGetCostsForTilesInRect:1;
 	} _delegateFlags;
+	
+	HUMTileCache *_tileCache;
+	
+	HUMClearanceMap *_clearanceMap;
+	pthread_rwlock_t _clearanceLock;
+	
+	HUMVisibilityGraph *_visibilityGraph;
+	pthread_rwlock_t _visibilityLock;
+	
+	HUMSwampMap *_swampMap;
+	pthread_rwlock_t _swampLock;
+	
+	HUMCostLayers *_costLayers;
+	pthread_rwlock_t _costLayerLock;
+	
+	HUMNavigationData *_navigationData;
+	
+	HUMChunkCache *_chunkCache;
+	
+	HUMAStarBoundedSearchStatistics _boundedSearchStatistics;
+	pthread_mutex_t _boundedSearchStatisticsLock;
+	
+	HUMTraceWriter *_traceWriter;
+	BOOL _traceMapStale;			// the whole map changed since it was last recorded
+	pthread_mutex_t _traceLock;
 }
 
-@property (nonatomic, strong) HUMAStarPathfinderNode *startNode;
-@property (nonatomic, strong) HUMAStarPathfinderNode *targetNode;
-@property (nonatomic, assign) CGPoint startPoint;
-
 @property (nonatomic, assign) CGFloat diagonalMovementCost;
 
-@property (nonatomic, copy) NSMutableArray *openList;
-@property (nonatomic, copy) NSMutableArray *closedList;
-@property (nonatomic, copy) NSMutableArray *shortestPath;
+@property (nonatomic, strong) NSMutableArray *searchContextPool;
+@property (nonatomic, strong) NSMutableArray *pendingClearanceRects;
+@property (nonatomic, strong) NSMutableArray *pendingVisibilityRects;
+@property (nonatomic, strong) NSMutableArray *pendingSwampRects;
+@property (nonatomic, strong) NSMutableArray *mutableCostLayerNames;
 @end
 
+#pragma mark - Tile Functions
+/**
+ *	Determines if a tile is valid based on its location.
+ *
+ *	@param	mapSize				The size of the tile map in tiles.
+ *	@param	tileLocation		The location of the tile within the tile matrix.
+ *
+ *	@return	YES, if the tile is valid. NO, otherwise.
+ */
+static inline BOOL HUMAStarIsTileValidAtLocation(CGSize mapSize, CGPoint tileLocation) {
+	BOOL validTile = YES;
+	if (tileLocation.x < 0 ||
+		tileLocation.y < 0 ||
+		tileLocation.x >= mapSize.width ||
+		tileLocation.y >= mapSize.height) {
+		validTile = NO;
+	}
+	
+	return validTile;
+}
+
+static CGPoint HUMAStarTileLocationForPosition(const HUMAStarSearchSettings *settings, CGPoint position) {
+	CGSize tileSize = settings->tileSize;
+	CGSize mapSize = settings->tileMapSize;
+	
+	NSInteger x = position.x / tileSize.width;
+	NSInteger y = 0;
+	
+	if (settings->coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		y = ((mapSize.height * tileSize.height) - position.y) / tileSize.height;
+	}
+	else if (settings->coordinateSystemOrigin == HUMCoodinateSystemOriginTopLeft) {
+		y = position.y / tileSize.height;
+	}
+	
+	return CGPointMake(x, y);
+}
+
+static CGPoint HUMAStarPositionForTileLocation(const HUMAStarSearchSettings *settings, CGPoint tileLocation) {
+	CGSize mapSize = settings->tileMapSize;
+	CGSize tileSize = settings->tileSize;
+
+	CGFloat x = (tileLocation.x * tileSize.width) + tileSize.width / 2.0f;
+	CGFloat y = 0.0f;
+	
+	if (settings->coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		y = (mapSize.height * tileSize.height) - (tileLocation.y * tileSize.height) - tileSize.height / 2.0f;
+	}
+	else if (settings->coordinateSystemOrigin == HUMCoodinateSystemOriginTopLeft) {
+		y = (tileLocation.y * tileSize.height) + tileSize.height / 2.0f;
+	}
+	
+	return CGPointMake(x, y);
+}
+
+/**
+ *	Converts a position to fractional tile coordinates, where tile (x, y) covers [x, x + 1) x [y, y + 1) and y grows downward.
+ */
+static void HUMAStarGetTileCoordinatesForPosition(const HUMAStarSearchSettings *settings, CGPoint position, double *x, double *y) {
+	CGSize tileSize = settings->tileSize;
+	
+	*x = position.x / tileSize.width;
+	*y = position.y / tileSize.height;
+	
+	if (settings->coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		*y = settings->tileMapSize.height - *y;
+	}
+}
+
+static CGPoint HUMAStarPositionForTileCoordinates(const HUMAStarSearchSettings *settings, double x, double y) {
+	CGSize tileSize = settings->tileSize;
+	
+	if (settings->coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		y = settings->tileMapSize.height - y;
+	}
+	
+	return CGPointMake(x * tileSize.width, y * tileSize.height);
+}
+
 @implementation HUMAStarPathfinder
 
 - (id)init {
@@ -42,6 +167,14 @@
 - (id)initWithTileMapSize:(CGSize)mapSize tileSize:(CGSize)tileSize delegate:(id<HUMAStarPathfinderDelegate>)delegate {
 	self = [super init];
 	if (self) {
+		// the locks are used by the setters below, so they have to be ready first
+		pthread_rwlock_init(&_clearanceLock, NULL);
+		pthread_rwlock_init(&_visibilityLock, NULL);
+		pthread_rwlock_init(&_swampLock, NULL);
+		pthread_rwlock_init(&_costLayerLock, NULL);
+		pthread_mutex_init(&_boundedSearchStatisticsLock, NULL);
+		pthread_mutex_init(&_traceLock, NULL);
+		
 		_tileMapSize = mapSize;
 		_tileSize = tileSize;
 		_pathDiagonally = YES;
@@ -49,24 +182,52 @@
 		_ignoreDiagonalBarriers = NO;
 		_distanceType = HUMAStarDistanceTypeManhattan;
 		_coordinateSystemOrigin = HUMCoodinateSystemOriginBottomLeft;
+		_memoryLayout = HUMAStarMemoryLayoutRowMajor;
+		_chunkSize = 64;
+		_residentChunkLimit = 64;
+		_boundedSearchMemoryLimit = 256 * 1024;
 		[self setBaseMovementCost:10];
 		_diagonalMovementCost = [self calculateDiagonalMovementCost];
-		_openList = [NSMutableArray array];
-		_closedList = [NSMutableArray array];
-		_shortestPath = [NSMutableArray array];
+		_searchContextPool = [NSMutableArray array];
+		_pendingClearanceRects = [NSMutableArray array];
+		_pendingVisibilityRects = [NSMutableArray array];
+		_pendingSwampRects = [NSMutableArray array];
+		_mutableCostLayerNames = [NSMutableArray array];
 		
 		[self setDelegate:delegate];
+		[self rebuildCostLayers];
 	}
 	
 	return self;	
 }
 
+- (void)dealloc {
+	HUMTileCacheFree(_tileCache);
+	HUMClearanceMapFree(_clearanceMap);
+	pthread_rwlock_destroy(&_clearanceLock);
+	HUMVisibilityGraphFree(_visibilityGraph);
+	pthread_rwlock_destroy(&_visibilityLock);
+	HUMSwampMapFree(_swampMap);
+	pthread_rwlock_destroy(&_swampLock);
+	HUMCostLayersFree(_costLayers);
+	pthread_rwlock_destroy(&_costLayerLock);
+	HUMNavigationDataClose(_navigationData);
+	HUMChunkCacheFree(_chunkCache);
+	pthread_mutex_destroy(&_boundedSearchStatisticsLock);
+	HUMTraceWriterClose(_traceWriter);
+	pthread_mutex_destroy(&_traceLock);
+}
+
 #pragma mark - Properties
 - (void)setDelegate:(id<HUMAStarPathfinderDelegate>)delegate {
 	_delegate = delegate;
 	
 	_delegateFlags.delegateCanWalkToNodeAtTileLocation = [_delegate respondsToSelector:@selector(pathfinder:canWalkToNodeAtTileLocation:)];
 	_delegateFlags.delegateCostForNodeAtTileLocation = [_delegate respondsToSelector:@selector(pathfinder:costForNodeAtTileLocation:)];
+	_delegateFlags.delegateGetWalkableFlagsForTilesInRect = [_delegate respondsToSelector:@selector(pathfinder:getWalkableFlags:forTilesInRect:)];
+	_delegateFlags.delegateGetCostsForTilesInRect = [_delegate respondsToSelector:@selector(pathfinder:getCosts:forTilesInRect:)];
+	
+	[self rebuildTileCache];
 }
 
 - (void)setTileMapSize:(CGSize)tileMapSize {
@@ -74,6 +235,9 @@
 	
 	if (!CGSizeEqualToSize(_tileMapSize, tileMapSize)) {
 		_tileMapSize = tileMapSize;
+		[self rebuildTileCache];
+		[self rebuildChunkCache];
+		[self rebuildCostLayers];
 	}
 }
 
@@ -91,379 +255,2255 @@
 	if (_baseMovementCost != baseMovementCost) {
 		_baseMovementCost = baseMovementCost;
 		_diagonalMovementCost = [self calculateDiagonalMovementCost];
+		
+		// bulk cost queries may fall back to the base movement cost, so anything already cached could be stale
+		[self invalidateAllCachedTiles];
 	}
 }
 
-- (CGFloat)calculateDiagonalMovementCost {
-	return sqrtf((_baseMovementCost * _baseMovementCost) + (_baseMovementCost * _baseMovementCost));
+- (void)setChunkProvider:(id<HUMAStarPathfinderChunkProvider>)chunkProvider {
+	if (_chunkProvider != chunkProvider) {
+		_chunkProvider = chunkProvider;
+		[self rebuildChunkCache];
+	}
 }
 
-#pragma mark - Pathfinding
-- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target {
-	self.startPoint = start;
-	
-	CGPoint startTileLocation = [self tileLocationForPosition:start];
-	CGPoint targetTileLocation = [self tileLocationForPosition:target];
+- (void)setChunkSize:(NSUInteger)chunkSize {
+	NSAssert(chunkSize >= 2 && chunkSize <= 4096 && (chunkSize & (chunkSize - 1)) == 0, @"chunkSize must be a power of two between 2 and 4096.");
 	
-	self.startNode = [HUMAStarPathfinderNode nodeWithLocation:startTileLocation];
-	self.targetNode = [HUMAStarPathfinderNode nodeWithLocation:targetTileLocation];
-	
-	if ([self.startNode isEqual:self.targetNode]) {
-		return nil;
+	if (_chunkSize != chunkSize) {
+		_chunkSize = chunkSize;
+		[self rebuildChunkCache];
 	}
+}
+
+- (void)setResidentChunkLimit:(NSUInteger)residentChunkLimit {
+	NSAssert(residentChunkLimit > 0, @"residentChunkLimit must be a value greater than 0.");
 	
-	// check to make sure we can actually get a path to the target node
-	if (![self canWalkToNodeAtTileLocation:targetTileLocation]) {
-		return nil;
+	if (_residentChunkLimit != residentChunkLimit) {
+		_residentChunkLimit = residentChunkLimit;
+		[self rebuildChunkCache];
 	}
+}
+
+- (void)setBoundedSearchMemoryLimit:(NSUInteger)boundedSearchMemoryLimit {
+	NSAssert(boundedSearchMemoryLimit >= HUMBoundedSearchMinimumMemoryLimit, @"boundedSearchMemoryLimit must be at least %d.", HUMBoundedSearchMinimumMemoryLimit);
+	_boundedSearchMemoryLimit = boundedSearchMemoryLimit;
+}
+
+- (CGFloat)calculateDiagonalMovementCost {
+	return sqrtf((_baseMovementCost * _baseMovementCost) + (_baseMovementCost * _baseMovementCost));
+}
 
-	[self.openList removeAllObjects];
-	[self.closedList removeAllObjects];
-	[self.shortestPath removeAllObjects];
+#pragma mark - Navigation Files
+/**
+ *	Creates the error reported when a navigation file can't be loaded.
+ */
+static NSError *HUMAStarPathfinderNavigationFileError(HUMNavigationFileStatus status, NSString *path) {
+	HUMAStarPathfinderErrorCode code = HUMAStarPathfinderErrorNavigationFileUnreadable;
+	NSString *description = nil;
+	
+	switch (status) {
+		case HUMNavigationFileStatusInvalid:
+			code = HUMAStarPathfinderErrorNavigationFileInvalid;
+			description = @"The file isn't a navigation file, or is truncated.";
+			break;
+			
+		case HUMNavigationFileStatusUnsupportedVersion:
+			code = HUMAStarPathfinderErrorNavigationFileUnsupportedVersion;
+			description = @"The navigation file was written by an unsupported version of the format.";
+			break;
+			
+		case HUMNavigationFileStatusStale:
+			code = HUMAStarPathfinderErrorNavigationFileStale;
+			description = @"The navigation file was built from a different version of the map.";
+			break;
+			
+		default:
+			description = @"The file couldn't be read.";
+			break;
+	}
 	
-	// determine if the end node is walkable? (eg. on a wall, sky, other obstacle)
+	return [NSError errorWithDomain:HUMAStarPathfinderErrorDomain code:code userInfo:@{ NSLocalizedDescriptionKey : description, NSFilePathErrorKey : path }];
+}
 
-	// 1) Add the current node to the open list
-	[self insertInOpenSteps:self.startNode];
+- (BOOL)loadNavigationFileAtPath:(NSString *)path sourceMapPath:(NSString *)sourceMapPath error:(NSError **)error {
+	NSParameterAssert(path);
 	
-	while (self.openList.count > 0) {
-		// 2) Get the node with the lower F value
-		HUMAStarPathfinderNode *checkingNode = self.openList[0];
-				
-		// 3) Add the checking node to the closed list and remove it from the open list
-		[self.openList removeObject:checkingNode];
-		[self.closedList addObject:checkingNode];
+	uint64_t sourceChecksum = 0;
+	
+	if (sourceMapPath) {
+		sourceChecksum = HUMNavigationChecksumFile([sourceMapPath fileSystemRepresentation]);
 		
-		if ([checkingNode isEqual:self.targetNode]) {
-			self.targetNode.parentNode = checkingNode.parentNode;
+		if (sourceChecksum == 0) {
+			if (error) {
+				*error = HUMAStarPathfinderNavigationFileError(HUMNavigationFileStatusUnreadable, sourceMapPath);
+			}
 			
-			// 6) Traceback from the target node to the start node and build out the path
-			[self generatePath];
-			break;
+			return NO;
 		}
-		
-		// 4) Get all valid adjacent nodes
-		NSArray *neighbors = [self findAdjacentNodesForNode:checkingNode];
-		
-		// 5) Determine the values for the current node's adjacent nodes (N, NE, E, SE, S, SW, W, NW)
-		for (HUMAStarPathfinderNode *node in neighbors) {
-			[self determineNodeValuesForAdjacentNode:node currentNode:checkingNode];
+	}
+	
+	HUMNavigationFileStatus status = HUMNavigationFileStatusOK;
+	HUMNavigationData *navigationData = HUMNavigationDataOpen([path fileSystemRepresentation], sourceChecksum, &status);
+	
+	if (!navigationData) {
+		if (error) {
+			*error = HUMAStarPathfinderNavigationFileError(status, path);
 		}
+		
+		return NO;
 	}
 	
-	return [NSArray arrayWithArray:self.shortestPath];
+	HUMNavigationDataClose(_navigationData);
+	_navigationData = navigationData;
+	
+	self.tileMapSize = CGSizeMake(navigationData->width, navigationData->height);
+	[self discardClearanceMap];
+	[self discardVisibilityGraph];
+	[self discardSwampMap];
+	[self traceMapChanged];
+	
+	return YES;
 }
 
-/**
- *	Sets any new G, H, and parent values for the provided adjacent node.
- *
- *	@param	adjacentNode	The node that is adjacent to the currentNode.
- *	@param	currentNode		The node that is the origin for the adjacentNode.
- */
-- (void)determineNodeValuesForAdjacentNode:(HUMAStarPathfinderNode *)adjacentNode currentNode:(HUMAStarPathfinderNode *)currentNode {
-	BOOL neighborInOpenList = [self.openList containsObject:adjacentNode];
-	HUMAStarPathfinderNode *neighborNode = neighborInOpenList ? [self.openList objectAtIndex:[self.openList indexOfObject:adjacentNode]] : adjacentNode;
-	
-	if ([self.closedList containsObject:neighborNode]) {
+- (void)unloadNavigationFile {
+	if (!_navigationData) {
 		return;
 	}
 	
-	NSInteger newGCost = currentNode.gCost + [self costToMoveFromNode:currentNode toNode:adjacentNode];
+	HUMNavigationDataClose(_navigationData);
+	_navigationData = NULL;
 	
-	if (neighborInOpenList) {
-		neighborNode = [self.openList objectAtIndex:[self.openList indexOfObject:adjacentNode]];
-	}
+	[self discardClearanceMap];
+	[self discardVisibilityGraph];
+	[self discardSwampMap];
+	[self traceMapChanged];
+}
+
+- (BOOL)isNavigationFileLoaded {
+	return _navigationData != NULL;
+}
+
+#pragma mark - Paged Maps
+/**
+ *	Loads a chunk of the paged map from the chunk provider.
+ */
+static bool HUMAStarPathfinderLoadChunk(void *info, int32_t x, int32_t y, int32_t width, int32_t height, uint8_t *walkable, uint32_t *costs, int32_t stride) {
+	HUMAStarPathfinder *pathfinder = (__bridge HUMAStarPathfinder *)info;
+	size_t tileCount = (size_t)width * (size_t)height;
+	BOOL *walkableFlags = calloc(tileCount, sizeof(BOOL));
+	NSUInteger *tileCosts = malloc(tileCount * sizeof(NSUInteger));
+	BOOL loaded = NO;
 	
-	if (neighborInOpenList == NO || newGCost < adjacentNode.gCost) {
-		neighborNode.gCost = newGCost;
-		neighborNode.hValue = neighborNode.hValue > 0 ? adjacentNode.hValue : [self calculateHeuristicForNode:neighborNode];
-		neighborNode.parentNode = currentNode;
+	if (walkableFlags && tileCosts) {
+		NSUInteger baseMovementCost = pathfinder.baseMovementCost;
+		for (size_t i = 0; i < tileCount; i++) {
+			tileCosts[i] = baseMovementCost;
+		}
 		
-		if (neighborInOpenList == NO) {
-			[self insertInOpenSteps:neighborNode];
+		// prefetches run on a dispatch queue, which doesn't drain an autorelease pool of its own between blocks
+		@autoreleasepool {
+			loaded = [pathfinder.chunkProvider pathfinder:pathfinder loadChunkInRect:CGRectMake(x, y, width, height) walkableFlags:walkableFlags costs:tileCosts];
 		}
-		else {
-			[self.openList removeObjectAtIndex:[self.openList indexOfObject:neighborNode]];
-			[self insertInOpenSteps:neighborNode];
-			// the neighbor can be reached with a lower gCost changing the fValue.
-			// we need to adjust the open list to compensate. The may be automatically done when adding an object to the open list
+	}
+	
+	if (loaded) {
+		for (int32_t row = 0; row < height; row++) {
+			for (int32_t column = 0; column < width; column++) {
+				walkable[row * stride + column] = walkableFlags[row * width + column] ? 1 : 0;
+				costs[row * stride + column] = (uint32_t)MIN(tileCosts[row * width + column], (NSUInteger)UINT32_MAX);
+			}
 		}
 	}
+	
+	free(walkableFlags);
+	free(tileCosts);
+	
+	return loaded;
 }
 
 /**
- *	Generates an array of points connecting the start node to the target node by backtracing through each parent, starting at the target node.
+ *	Runs a chunk prefetch on a low priority global queue.
  */
-- (void)generatePath {
-	HUMAStarPathfinderNode *node = self.targetNode;
-	
-	while (node.parentNode) {
-		CGPoint screenPosition = [self positionForTileLocation:node.tileLocation];
-#if TARGET_OS_IPHONE
-		[self.shortestPath insertObject:[NSValue valueWithCGPoint:screenPosition] atIndex:0];
-#else
-		[self.shortestPath insertObject:[NSValue valueWithPoint:screenPosition] atIndex:0];
-#endif
-		node = node.parentNode;
-	}
-	
-#if TARGET_OS_IPHONE
-	[self.shortestPath insertObject:[NSValue valueWithCGPoint:self.startPoint] atIndex:0];
-#else
-	[self.shortestPath insertObject:[NSValue valueWithPoint:self.startPoint] atIndex:0];
-#endif
+static void HUMAStarPathfinderDispatchPrefetch(void *info, void *context, void (*work)(void *context)) {
+	dispatch_async_f(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), context, work);
 }
 
 /**
- *	Calculates the cost to move from one node to another.
- *
- *	@param	fromNode	The start node.
- *	@param	toNode		The destination node.
- *
- *	@return	The base movement cost, if moving horizontally or vertically. The diagonal movement cost, if moving diagonally.
+ *	Recreates the chunk cache to match the current map size, chunk size, and resident limit. Only exists while there is a chunk provider.
  */
-- (NSInteger)costToMoveFromNode:(HUMAStarPathfinderNode *)fromNode toNode:(HUMAStarPathfinderNode *)toNode {
-	CGPoint fromLocation = fromNode.tileLocation;
-	CGPoint toLocation = toNode.tileLocation;
-	
-	NSInteger baseMovementCost = self.baseMovementCost;
-	CGFloat diagonalMovementCost = self.diagonalMovementCost;
+- (void)rebuildChunkCache {
+	HUMChunkCacheFree(_chunkCache);
+	_chunkCache = NULL;
 	
-	if (_delegateFlags.delegateCostForNodeAtTileLocation) {
-		baseMovementCost = [self.delegate pathfinder:self costForNodeAtTileLocation:toLocation];
-		diagonalMovementCost = sqrtf((baseMovementCost * baseMovementCost) + (baseMovementCost * baseMovementCost));
+	if (self.chunkProvider && self.tileMapSize.width > 0 && self.tileMapSize.height > 0) {
+		int32_t chunkShift = 0;
+		while (((NSUInteger)1 << chunkShift) < self.chunkSize) {
+			chunkShift++;
+		}
+		
+		_chunkCache = HUMChunkCacheCreate(self.tileMapSize.width, self.tileMapSize.height, chunkShift, (int32_t)MIN(self.residentChunkLimit, (NSUInteger)INT32_MAX),
+										  HUMAStarPathfinderLoadChunk, (__bridge void *)self, HUMAStarPathfinderDispatchPrefetch, NULL);
 	}
 	
-	if ((fromLocation.x != toLocation.x) && (fromLocation.y != toLocation.y)) {
-		return diagonalMovementCost;
-	}
-	else {
-		return baseMovementCost;
-	}
+	[self discardClearanceMap];
+	[self discardVisibilityGraph];
+	[self discardSwampMap];
+	[self traceMapChanged];
 }
 
 /**
- *	Calculates the estimated minimum cost (heuristic) the provided node to the target node using the set heuristic type.
- *
- *	@param	node	The source node being used to calculate the heuristic.
+ *	Starts a cursor into the paged map, if there is one and a navigation file isn't taking its place.
  *
- *	@return	The provided node's heuristic.
+ *	@return	The cursor, or NULL. Must be finished with HUMChunkCursorFinish.
  */
-- (CGFloat)calculateHeuristicForNode:(HUMAStarPathfinderNode *)node {
-	CGPoint nodeTileLocation = node.tileLocation;
-	CGPoint targetTileLocation = self.targetNode.tileLocation;
+- (HUMChunkCursor *)beginChunkCursor:(HUMChunkCursor *)cursor {
+	if (!_chunkCache || _navigationData) {
+		return NULL;
+	}
 	
-	NSInteger distanceX = abs(nodeTileLocation.x - targetTileLocation.x);
-	NSInteger distanceY = abs(nodeTileLocation.y - targetTileLocation.y);
+	HUMChunkCursorInit(cursor, _chunkCache);
+	return cursor;
+}
 
-	CGFloat heuristic = 0.0f;
+- (HUMAStarChunkStatistics)chunkStatistics {
+	HUMAStarChunkStatistics statistics = { 0 };
 	
-	switch (self.distanceType) {
-		case HUMAStarDistanceTypeEuclidian:
-			heuristic = sqrtf((distanceX * distanceX) + (distanceY * distanceY));
-			break;
-			
-		case HUMAStarDistanceTypeChebyshev:
-			heuristic = MAX(distanceX, distanceY);
-			break;
-			
-		case HUMAStarDistanceTypeManhattan:
-		default:
-			heuristic = distanceX + distanceY;
-			break;
+	if (_chunkCache) {
+		HUMChunkCacheStatistics cacheStatistics = HUMChunkCacheGetStatistics(_chunkCache);
+		
+		pthread_mutex_lock(&_chunkCache->lock);
+		statistics.residentChunkCount = _chunkCache->residentCount;
+		pthread_mutex_unlock(&_chunkCache->lock);
+		
+		statistics.loadCount = (NSUInteger)cacheStatistics.loadCount;
+		statistics.faultCount = (NSUInteger)cacheStatistics.faultCount;
+		statistics.prefetchCount = (NSUInteger)cacheStatistics.prefetchCount;
+		statistics.evictionCount = (NSUInteger)cacheStatistics.evictionCount;
+		statistics.queryCount = (NSUInteger)cacheStatistics.queryCount;
+		statistics.lastQueryFaultCount = cacheStatistics.lastQueryFaultCount;
+		statistics.maximumQueryFaultCount = cacheStatistics.maximumQueryFaultCount;
 	}
 	
-	
-	return heuristic;
+	return statistics;
+}
+
+- (void)resetChunkStatistics {
+	if (_chunkCache) {
+		HUMChunkCacheResetStatistics(_chunkCache);
+	}
 }
 
+#pragma mark - Tile Caching
 /**
- *	Finds all valid adjacent nodes neighboring the provided node.
- *
- *	@param	node	The origin node.
- *
- *	@return	An NSArray of all valid adjacent nodes.
- */
-- (NSArray *)findAdjacentNodesForNode:(HUMAStarPathfinderNode *)node {
-	CGPoint nodeTileLocation = node.tileLocation;
-	NSMutableArray *neighbors = [NSMutableArray arrayWithCapacity:8];
-	BOOL hasNorth = NO, hasSouth = NO, hasEast = NO, hasWest = NO;
-	BOOL checkNorthEast = YES, checkSouthEast = YES, checkSouthWest = YES, checkNorthWest = YES;
-	// link adjacent nodes to the checking node ignoring whether they are walkable or not.
-	// if a tile location is outside the bounds of the map then ignore them
-
-	// N node
-	CGPoint tileLocation = CGPointMake(nodeTileLocation.x, nodeTileLocation.y - 1);
-	if ([self isTileValidAtLocation:tileLocation] && [self canWalkToNodeAtTileLocation:tileLocation]) {
-		[neighbors addObject:[HUMAStarPathfinderNode nodeWithLocation:tileLocation]];
-		hasNorth = YES;
-	}
-	
-	// E node
-	tileLocation = CGPointMake(node.tileLocation.x + 1, node.tileLocation.y);
-	if ([self isTileValidAtLocation:tileLocation] && [self canWalkToNodeAtTileLocation:tileLocation]) {
-		[neighbors addObject:[HUMAStarPathfinderNode nodeWithLocation:tileLocation]];
-		hasEast = YES;
-	}
-	
-	// S node
-	tileLocation = CGPointMake(node.tileLocation.x, node.tileLocation.y + 1);
-	if ([self isTileValidAtLocation:tileLocation] && [self canWalkToNodeAtTileLocation:tileLocation]) {
-		[neighbors addObject:[HUMAStarPathfinderNode nodeWithLocation:tileLocation]];
-		hasSouth = YES;
-	}
-	
-	// W node
-	tileLocation = CGPointMake(node.tileLocation.x - 1, node.tileLocation.y);
-	if ([self isTileValidAtLocation:tileLocation] && [self canWalkToNodeAtTileLocation:tileLocation]) {
-		[neighbors addObject:[HUMAStarPathfinderNode nodeWithLocation:tileLocation]];
-		hasWest = YES;
-	}
-	
-	if (self.pathDiagonally) {
-		if (!self.ignoreDiagonalBarriers) {
-			// determine if we have diagonal neighbors. If crossing borders is allowed, we only need one of the two cardinal
-			// tiles to be valid. Otherwise, we need both.
-			if (self.pathCanCrossBorders) {
-				checkNorthEast = hasNorth || hasEast;
-				checkSouthEast = hasSouth || hasEast;
-				checkSouthWest = hasSouth || hasWest;
-				checkNorthWest = hasNorth || hasWest;
-			}
-			else {
-				checkNorthEast = hasNorth && hasEast;
-				checkSouthEast = hasSouth && hasEast;
-				checkSouthWest = hasSouth && hasWest;
-				checkNorthWest = hasNorth && hasWest;
-			}
-		}
-				
-		// NE node
-		tileLocation = CGPointMake(node.tileLocation.x + 1, node.tileLocation.y - 1);
-		if (checkNorthEast && [self isTileValidAtLocation:tileLocation] && [self canWalkToNodeAtTileLocation:tileLocation]) {
-			[neighbors addObject:[HUMAStarPathfinderNode nodeWithLocation:tileLocation]];
-		}
+ *	Fills a rect of the tile cache from the delegate's bulk query methods.
+ */
+static void HUMAStarPathfinderFillTileCache(void *info, int32_t x, int32_t y, int32_t width, int32_t height, uint8_t *walkable, uint32_t *costs, int32_t stride) {
+	HUMAStarPathfinder *pathfinder = (__bridge HUMAStarPathfinder *)info;
+	id<HUMAStarPathfinderDelegate> delegate = pathfinder.delegate;
+	CGRect tileRect = CGRectMake(x, y, width, height);
+	
+	if (walkable) {
+		BOOL walkableFlags[HUMTileCacheBlockSize * HUMTileCacheBlockSize];
+		[delegate pathfinder:pathfinder getWalkableFlags:walkableFlags forTilesInRect:tileRect];
 		
-		// SE node
-		tileLocation = CGPointMake(node.tileLocation.x + 1, node.tileLocation.y + 1);
-		if (checkSouthEast && [self isTileValidAtLocation:tileLocation] && [self canWalkToNodeAtTileLocation:tileLocation]) {
-			[neighbors addObject:[HUMAStarPathfinderNode nodeWithLocation:tileLocation]];
-		}
-
-		// SW node
-		tileLocation = CGPointMake(node.tileLocation.x - 1, node.tileLocation.y + 1);
-		if (checkSouthWest &&[self isTileValidAtLocation:tileLocation] && [self canWalkToNodeAtTileLocation:tileLocation]) {
-			[neighbors addObject:[HUMAStarPathfinderNode nodeWithLocation:tileLocation]];
+		for (int32_t row = 0; row < height; row++) {
+			for (int32_t column = 0; column < width; column++) {
+				walkable[row * stride + column] = walkableFlags[row * width + column] ? 1 : 0;
+			}
 		}
+	}
+	
+	if (costs) {
+		NSUInteger tileCosts[HUMTileCacheBlockSize * HUMTileCacheBlockSize];
+		[delegate pathfinder:pathfinder getCosts:tileCosts forTilesInRect:tileRect];
 		
-		// NW node
-		tileLocation = CGPointMake(node.tileLocation.x - 1, node.tileLocation.y - 1);
-		if (checkNorthWest &&[self isTileValidAtLocation:tileLocation] && [self canWalkToNodeAtTileLocation:tileLocation]) {
-			[neighbors addObject:[HUMAStarPathfinderNode nodeWithLocation:tileLocation]];
+		for (int32_t row = 0; row < height; row++) {
+			for (int32_t column = 0; column < width; column++) {
+				NSUInteger cost = tileCosts[row * width + column];
+				costs[row * stride + column] = (uint32_t)MIN(cost, (NSUInteger)UINT32_MAX);
+			}
 		}
 	}
-	return neighbors;
 }
 
-#pragma mark - Tile Helpers
 /**
- *	Determines if a node is walkable. If a delegate is provided, the delegate will be asked. Otherwise, YES.
- *
- *	@param	location	The tile location in question.
- *
- *	@return	YES, if the tile can be traversed. NO, otherwise.
+ *	Recreates the tile cache to match the current map size and the bulk query methods the delegate implements.
  */
-- (BOOL)canWalkToNodeAtTileLocation:(CGPoint)location {
-	BOOL walkable = YES;
+- (void)rebuildTileCache {
+	HUMTileCacheFree(_tileCache);
+	_tileCache = NULL;
 	
-	if (_delegateFlags.delegateCanWalkToNodeAtTileLocation) {
-		walkable = [self.delegate pathfinder:self canWalkToNodeAtTileLocation:location];
+	BOOL cachesWalkability = _delegateFlags.delegateGetWalkableFlagsForTilesInRect;
+	BOOL cachesCosts = _delegateFlags.delegateGetCostsForTilesInRect;
+	
+	if ((cachesWalkability || cachesCosts) && self.tileMapSize.width > 0 && self.tileMapSize.height > 0) {
+		_tileCache = HUMTileCacheCreate(self.tileMapSize.width, self.tileMapSize.height, cachesWalkability, cachesCosts, HUMAStarPathfinderFillTileCache, (__bridge void *)self);
 	}
 	
-	return walkable;
+	[self discardClearanceMap];
+	[self discardVisibilityGraph];
+	[self discardSwampMap];
+	[self traceMapChanged];
 }
 
-/**
- *	Determines if a tile is valid based on its location.
- *
- *	@param	tileLocation		The location of the tile within the tile matrix.
- *
- *	@return	YES, if the tile is valid. NO, otherwise.
- */
-- (BOOL)isTileValidAtLocation:(CGPoint)tileLocation {
-	BOOL validTile = YES;
-	if (tileLocation.x < 0 ||
-		tileLocation.y < 0 ||
-		tileLocation.x >= self.tileMapSize.width ||
-		tileLocation.y >= self.tileMapSize.height) {
-		validTile = NO;
+- (void)prefetchTilesInRect:(CGRect)tileRect {
+	if (_tileCache) {
+		HUMTileCachePrefetch(_tileCache, tileRect.origin.x, tileRect.origin.y, tileRect.size.width, tileRect.size.height);
 	}
-	
-	return validTile;
 }
 
-- (CGPoint)tileLocationForPosition:(CGPoint)position {
-	CGSize tileSize = self.tileSize;
-	CGSize mapSize = self.tileMapSize;
+- (void)invalidateCachedTilesInRect:(CGRect)tileRect {
+	if (_tileCache) {
+		HUMTileCacheInvalidate(_tileCache, tileRect.origin.x, tileRect.origin.y, tileRect.size.width, tileRect.size.height);
+	}
 	
-	NSInteger x = position.x / tileSize.width;
-	NSInteger y = 0;
+	if (_chunkCache) {
+		HUMChunkCacheInvalidate(_chunkCache, tileRect.origin.x, tileRect.origin.y, tileRect.size.width, tileRect.size.height);
+	}
 	
-	if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
-		y = ((mapSize.height * tileSize.height) - position.y) / tileSize.height;
+	// the clearance map is brought up to date by the next query that needs it. Holding the read lock means a clearance map that is
+	// being built right now can't miss this change.
+	pthread_rwlock_rdlock(&_clearanceLock);
+	if (_clearanceMap) {
+		@synchronized(self.pendingClearanceRects) {
+			[self.pendingClearanceRects addObject:[NSValue valueWithBytes:&tileRect objCType:@encode(CGRect)]];
+		}
 	}
-	else if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginTopLeft) {
-		y = position.y / tileSize.height;
+	pthread_rwlock_unlock(&_clearanceLock);
+	
+	pthread_rwlock_rdlock(&_visibilityLock);
+	if (_visibilityGraph) {
+		@synchronized(self.pendingVisibilityRects) {
+			[self.pendingVisibilityRects addObject:[NSValue valueWithBytes:&tileRect objCType:@encode(CGRect)]];
+		}
 	}
+	pthread_rwlock_unlock(&_visibilityLock);
 	
-	return CGPointMake(x, y);
+	pthread_rwlock_rdlock(&_swampLock);
+	if (_swampMap) {
+		@synchronized(self.pendingSwampRects) {
+			[self.pendingSwampRects addObject:[NSValue valueWithBytes:&tileRect objCType:@encode(CGRect)]];
+		}
+	}
+	pthread_rwlock_unlock(&_swampLock);
+	
+	[self recordTraceTilesInRect:tileRect source:HUMTraceEditInvalidation];
 }
 
-- (CGPoint)positionForTileLocation:(CGPoint)tileLocation {
-	CGSize mapSize = self.tileMapSize;
-	CGSize tileSize = self.tileSize;
-
-	CGFloat x = (tileLocation.x * tileSize.width) + tileSize.width / 2.0f;
-	CGFloat y = 0.0f;
+- (void)invalidateAllCachedTiles {
+	if (_tileCache) {
+		HUMTileCacheInvalidateAll(_tileCache);
+	}
 	
-	if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
-		y = (mapSize.height * tileSize.height) - (tileLocation.y * tileSize.height) - tileSize.height / 2.0f;
+	if (_chunkCache) {
+		HUMChunkCacheInvalidateAll(_chunkCache);
 	}
-	else if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginTopLeft) {
-		y = (tileLocation.y * tileSize.height) + tileSize.height / 2.0f;
+	
+	[self discardClearanceMap];
+	[self discardVisibilityGraph];
+	[self discardSwampMap];
+	[self traceMapChanged];
+}
+
+#pragma mark - Clearance
+- (void)discardClearanceMap {
+	pthread_rwlock_wrlock(&_clearanceLock);
+	
+	HUMClearanceMapFree(_clearanceMap);
+	_clearanceMap = NULL;
+	
+	@synchronized(self.pendingClearanceRects) {
+		[self.pendingClearanceRects removeAllObjects];
 	}
 	
-	return CGPointMake(x, y);
+	pthread_rwlock_unlock(&_clearanceLock);
 }
 
-#pragma mark - CHANGE LATER TO BINARY HEAP
-- (void)insertInOpenSteps:(HUMAStarPathfinderNode *)node {
-	int stepFScore = node.fValue; // Compute only once the step F score's
-	int count = [self.openList count];
-	int i = 0; // It will be the index at which we will insert the step
-	for (; i < count; i++) {
-		if (stepFScore <= [[self.openList objectAtIndex:i] fValue]) { // if the step F score's is lower or equals to the step at index i
-			// Then we found the index at which we have to insert the new step
-			break;
+/**
+ *	Fills a buffer with the walkability of every tile in a rect.
+ *
+ *	@param	walkable	A buffer of tileRect.size.width * tileRect.size.height flags, filled in row-major order.
+ *	@param	tileRect	The rect of tiles to inspect. Must lie within the tile map.
+ */
+- (void)getWalkableFlags:(uint8_t *)walkable forTilesInRect:(CGRect)tileRect {
+	NSInteger minX = tileRect.origin.x;
+	NSInteger minY = tileRect.origin.y;
+	NSInteger width = tileRect.size.width;
+	NSInteger height = tileRect.size.height;
+	
+	[self prefetchTilesInRect:tileRect];
+	
+	HUMChunkCursor chunkCursor;
+	HUMChunkCursor *cursor = [self beginChunkCursor:&chunkCursor];
+	
+	for (NSInteger y = 0; y < height; y++) {
+		for (NSInteger x = 0; x < width; x++) {
+			if (cursor) {
+				walkable[y * width + x] = HUMChunkCursorIsWalkable(cursor, (int32_t)(minX + x), (int32_t)(minY + y));
+			}
+			else {
+				walkable[y * width + x] = [self canWalkToNodeAtTileLocation:CGPointMake(minX + x, minY + y)] ? 1 : 0;
+			}
 		}
 	}
-	// Insert the new step at the good index to preserve the F score ordering
-	[self.openList insertObject:node atIndex:i];
+	
+	if (cursor) {
+		HUMChunkCursorFinish(cursor);
+	}
 }
 
-
-- (HUMAStarPathfinderNode *)smallestFValueNode {
-	int smallest = NSIntegerMax;
-	HUMAStarPathfinderNode *smallestNode = nil;
+/**
+ *	Builds the clearance map if it doesn't exist yet, or applies any tile changes reported since it was last used.
+ */
+- (void)updateClearanceMap {
+	pthread_rwlock_wrlock(&_clearanceLock);
 	
-	for (HUMAStarPathfinderNode *node in self.openList) {
-		if (node.fValue < smallest) {
-			smallest = node.fValue;
-			smallestNode = node;
+	NSArray *pendingRects = nil;
+	@synchronized(self.pendingClearanceRects) {
+		pendingRects = [self.pendingClearanceRects copy];
+		[self.pendingClearanceRects removeAllObjects];
+	}
+	
+	CGRect mapRect = CGRectMake(0, 0, self.tileMapSize.width, self.tileMapSize.height);
+	
+	if (!_clearanceMap) {
+		uint8_t *walkable = malloc((size_t)(mapRect.size.width * mapRect.size.height));
+		[self getWalkableFlags:walkable forTilesInRect:mapRect];
+		_clearanceMap = HUMClearanceMapCreate(mapRect.size.width, mapRect.size.height, walkable);
+		free(walkable);
+	}
+	else {
+		for (NSValue *rectValue in pendingRects) {
+			CGRect tileRect;
+			[rectValue getValue:&tileRect];
+			tileRect = CGRectIntersection(CGRectIntegral(tileRect), mapRect);
+			
+			if (CGRectIsEmpty(tileRect)) {
+				continue;
+			}
+			
+			uint8_t *walkable = malloc((size_t)(tileRect.size.width * tileRect.size.height));
+			[self getWalkableFlags:walkable forTilesInRect:tileRect];
+			HUMClearanceMapUpdate(_clearanceMap, tileRect.origin.x, tileRect.origin.y, tileRect.size.width, tileRect.size.height, walkable);
+			free(walkable);
 		}
 	}
 	
-	return smallestNode;
+	pthread_rwlock_unlock(&_clearanceLock);
+}
+
+/**
+ *	Takes the clearance map's read lock, building or updating the map first if needed. Must be balanced with -unlockClearanceMap.
+ */
+- (void)lockUpToDateClearanceMap {
+	BOOL upToDate = NO;
+	
+	while (!upToDate) {
+		[self updateClearanceMap];
+		
+		pthread_rwlock_rdlock(&_clearanceLock);
+		upToDate = (_clearanceMap != NULL);
+		
+		// the map may have been discarded by another thread before we got the lock
+		if (!upToDate) {
+			pthread_rwlock_unlock(&_clearanceLock);
+		}
+	}
+}
+
+- (void)unlockClearanceMap {
+	pthread_rwlock_unlock(&_clearanceLock);
+}
+
+#pragma mark - Visibility Graph
+- (void)discardVisibilityGraph {
+	pthread_rwlock_wrlock(&_visibilityLock);
+	
+	HUMVisibilityGraphFree(_visibilityGraph);
+	_visibilityGraph = NULL;
+	
+	@synchronized(self.pendingVisibilityRects) {
+		[self.pendingVisibilityRects removeAllObjects];
+	}
+	
+	pthread_rwlock_unlock(&_visibilityLock);
+}
+
+/**
+ *	Builds the visibility graph if it doesn't exist yet, or applies any tile changes reported since it was last used. If memory runs out
+ *  while applying a change, the graph is discarded and built again by the next query.
+ */
+- (void)updateVisibilityGraph {
+	pthread_rwlock_wrlock(&_visibilityLock);
+	
+	NSArray *pendingRects = nil;
+	@synchronized(self.pendingVisibilityRects) {
+		pendingRects = [self.pendingVisibilityRects copy];
+		[self.pendingVisibilityRects removeAllObjects];
+	}
+	
+	CGRect mapRect = CGRectMake(0, 0, self.tileMapSize.width, self.tileMapSize.height);
+	
+	if (!_visibilityGraph) {
+		uint8_t *walkable = malloc((size_t)(mapRect.size.width * mapRect.size.height));
+		[self getWalkableFlags:walkable forTilesInRect:mapRect];
+		_visibilityGraph = HUMVisibilityGraphCreate(mapRect.size.width, mapRect.size.height, walkable);
+		free(walkable);
+	}
+	else {
+		for (NSValue *rectValue in pendingRects) {
+			CGRect tileRect;
+			[rectValue getValue:&tileRect];
+			tileRect = CGRectIntersection(CGRectIntegral(tileRect), mapRect);
+			
+			if (CGRectIsEmpty(tileRect)) {
+				continue;
+			}
+			
+			uint8_t *walkable = malloc((size_t)(tileRect.size.width * tileRect.size.height));
+			[self getWalkableFlags:walkable forTilesInRect:tileRect];
+			BOOL updated = HUMVisibilityGraphUpdate(_visibilityGraph, tileRect.origin.x, tileRect.origin.y, tileRect.size.width, tileRect.size.height, walkable);
+			free(walkable);
+			
+			if (!updated) {
+				HUMVisibilityGraphFree(_visibilityGraph);
+				_visibilityGraph = NULL;
+				break;
+			}
+		}
+	}
+	
+	pthread_rwlock_unlock(&_visibilityLock);
+}
+
+/**
+ *	Takes the visibility graph's read lock, building or updating the graph first if needed. Must be balanced with -unlockVisibilityGraph.
+ *
+ *	@return	The graph, or NULL if it couldn't be built or was discarded by another thread in the meantime.
+ */
+- (HUMVisibilityGraph *)lockUpToDateVisibilityGraph {
+	[self updateVisibilityGraph];
+	pthread_rwlock_rdlock(&_visibilityLock);
+	
+	return _visibilityGraph;
+}
+
+- (void)unlockVisibilityGraph {
+	pthread_rwlock_unlock(&_visibilityLock);
+}
+
+#pragma mark - Swamps
+- (void)setPrunesSwamps:(BOOL)prunesSwamps {
+	_prunesSwamps = prunesSwamps;
+	
+	if (!prunesSwamps) {
+		[self discardSwampMap];
+	}
+}
+
+- (void)discardSwampMap {
+	pthread_rwlock_wrlock(&_swampLock);
+	
+	HUMSwampMapFree(_swampMap);
+	_swampMap = NULL;
+	
+	@synchronized(self.pendingSwampRects) {
+		[self.pendingSwampRects removeAllObjects];
+	}
+	
+	pthread_rwlock_unlock(&_swampLock);
+}
+
+/**
+ *	Finds the swamps if they haven't been found for the current movement rules and base movement cost yet, or applies any tile changes
+ *  reported since they were last used. If memory runs out while applying a change, the swamps are found again by the next query.
+ *
+ *	@param	neighbors	The movement rules of the query about to run.
+ */
+- (void)updateSwampMapForNeighbors:(HUMSearchNeighbors)neighbors {
+	pthread_rwlock_wrlock(&_swampLock);
+	
+	NSArray *pendingRects = nil;
+	@synchronized(self.pendingSwampRects) {
+		pendingRects = [self.pendingSwampRects copy];
+		[self.pendingSwampRects removeAllObjects];
+	}
+	
+	CGRect mapRect = CGRectMake(0, 0, self.tileMapSize.width, self.tileMapSize.height);
+	uint32_t cost = (uint32_t)self.baseMovementCost;
+	
+	// the paths around a swamp are only measured for one set of movement rules and one cost
+	if (_swampMap && (_swampMap->neighbors != neighbors || _swampMap->cost != cost)) {
+		HUMSwampMapFree(_swampMap);
+		_swampMap = NULL;
+	}
+	
+	if (!_swampMap) {
+		uint8_t *walkable = malloc((size_t)(mapRect.size.width * mapRect.size.height));
+		[self getWalkableFlags:walkable forTilesInRect:mapRect];
+		_swampMap = HUMSwampMapCreate(mapRect.size.width, mapRect.size.height, walkable, neighbors, cost);
+		free(walkable);
+	}
+	else {
+		for (NSValue *rectValue in pendingRects) {
+			CGRect tileRect;
+			[rectValue getValue:&tileRect];
+			tileRect = CGRectIntersection(CGRectIntegral(tileRect), mapRect);
+			
+			if (CGRectIsEmpty(tileRect)) {
+				continue;
+			}
+			
+			uint8_t *walkable = malloc((size_t)(tileRect.size.width * tileRect.size.height));
+			[self getWalkableFlags:walkable forTilesInRect:tileRect];
+			BOOL updated = HUMSwampMapUpdate(_swampMap, tileRect.origin.x, tileRect.origin.y, tileRect.size.width, tileRect.size.height, walkable);
+			free(walkable);
+			
+			if (!updated) {
+				HUMSwampMapFree(_swampMap);
+				_swampMap = NULL;
+				break;
+			}
+		}
+	}
+	
+	pthread_rwlock_unlock(&_swampLock);
+}
+
+/**
+ *	Takes the swamp map's read lock, finding or updating the swamps first if needed. Must be balanced with -unlockSwampMap.
+ *
+ *	@return	The swamp map, or NULL if it couldn't be built or was discarded by another thread in the meantime.
+ */
+- (HUMSwampMap *)lockUpToDateSwampMapForNeighbors:(HUMSearchNeighbors)neighbors {
+	[self updateSwampMapForNeighbors:neighbors];
+	pthread_rwlock_rdlock(&_swampLock);
+	
+	return _swampMap;
+}
+
+- (void)unlockSwampMap {
+	pthread_rwlock_unlock(&_swampLock);
+}
+
+#pragma mark - Cost Layers
+/**
+ *	Recreates the cost layers to match the current map size, keeping every layer's name and weight but resetting its values to 0.
+ */
+- (void)rebuildCostLayers {
+	pthread_rwlock_wrlock(&_costLayerLock);
+	
+	HUMCostLayers *costLayers = HUMCostLayersCreate(self.tileMapSize.width, self.tileMapSize.height);
+	if (costLayers && _costLayers) {
+		for (int32_t i = 0; i < _costLayers->layerCount; i++) {
+			HUMCostLayersAdd(costLayers, _costLayers->layers[i].weight);
+		}
+	}
+	
+	HUMCostLayersFree(_costLayers);
+	_costLayers = costLayers;
+	
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	[self traceMapChanged];
+}
+
+/**
+ *	The index of a cost layer. Must be called with the cost layer lock held.
+ *
+ *	@return	The index, or -1 if there is no layer with the name.
+ */
+- (int32_t)indexOfCostLayerNamed:(NSString *)name {
+	NSUInteger index = [self.mutableCostLayerNames indexOfObject:name];
+	return index == NSNotFound ? -1 : (int32_t)index;
+}
+
+- (NSArray *)costLayerNames {
+	pthread_rwlock_rdlock(&_costLayerLock);
+	NSArray *names = [self.mutableCostLayerNames copy];
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	return names;
+}
+
+- (void)addCostLayerNamed:(NSString *)name weight:(CGFloat)weight {
+	NSParameterAssert(name);
+	
+	pthread_rwlock_wrlock(&_costLayerLock);
+	
+	NSAssert([self indexOfCostLayerNamed:name] == -1, @"A cost layer named %@ already exists.", name);
+	
+	if (_costLayers && [self indexOfCostLayerNamed:name] == -1 && HUMCostLayersAdd(_costLayers, weight) != -1) {
+		[self.mutableCostLayerNames addObject:[name copy]];
+	}
+	
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	[self traceMapChanged];
+}
+
+- (void)removeCostLayerNamed:(NSString *)name {
+	pthread_rwlock_wrlock(&_costLayerLock);
+	
+	int32_t index = [self indexOfCostLayerNamed:name];
+	if (index != -1) {
+		HUMCostLayersRemove(_costLayers, index);
+		[self.mutableCostLayerNames removeObjectAtIndex:index];
+	}
+	
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	[self traceMapChanged];
+}
+
+- (CGFloat)weightForCostLayerNamed:(NSString *)name {
+	pthread_rwlock_rdlock(&_costLayerLock);
+	
+	int32_t index = [self indexOfCostLayerNamed:name];
+	CGFloat weight = index != -1 ? _costLayers->layers[index].weight : 0.0f;
+	
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	return weight;
+}
+
+- (void)setWeight:(CGFloat)weight forCostLayerNamed:(NSString *)name {
+	pthread_rwlock_wrlock(&_costLayerLock);
+	HUMCostLayersSetWeight(_costLayers, [self indexOfCostLayerNamed:name], weight);
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	[self traceMapChanged];
+}
+
+- (void)setValues:(const float *)values forTilesInRect:(CGRect)tileRect inCostLayerNamed:(NSString *)name {
+	pthread_rwlock_wrlock(&_costLayerLock);
+	HUMCostLayersSetValues(_costLayers, [self indexOfCostLayerNamed:name], tileRect.origin.x, tileRect.origin.y, tileRect.size.width, tileRect.size.height, values);
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	[self recordTraceTilesInRect:tileRect source:HUMTraceEditCostLayer];
+}
+
+- (void)fillTilesInRect:(CGRect)tileRect withValue:(float)value inCostLayerNamed:(NSString *)name {
+	pthread_rwlock_wrlock(&_costLayerLock);
+	HUMCostLayersFill(_costLayers, [self indexOfCostLayerNamed:name], tileRect.origin.x, tileRect.origin.y, tileRect.size.width, tileRect.size.height, value);
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	[self recordTraceTilesInRect:tileRect source:HUMTraceEditCostLayer];
+}
+
+- (void)scaleCostLayerNamed:(NSString *)name byFactor:(float)factor offset:(float)offset {
+	pthread_rwlock_wrlock(&_costLayerLock);
+	HUMCostLayersScale(_costLayers, [self indexOfCostLayerNamed:name], factor, offset);
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	[self traceMapChanged];
+}
+
+#pragma mark - Search Contexts
+- (HUMAStarSearchSettings)currentSearchSettings {
+	HUMAStarSearchSettings settings;
+	settings.tileMapSize = self.tileMapSize;
+	settings.tileSize = self.tileSize;
+	settings.distanceType = self.distanceType;
+	settings.coordinateSystemOrigin = self.coordinateSystemOrigin;
+	settings.pathDiagonally = self.pathDiagonally;
+	settings.ignoreDiagonalBarriers = self.ignoreDiagonalBarriers;
+	settings.pathCanCrossBorders = self.pathCanCrossBorders;
+	settings.baseMovementCost = self.baseMovementCost;
+	settings.diagonalMovementCost = self.diagonalMovementCost;
+	settings.memoryLayout = self.memoryLayout;
+	settings.boundedSearchMemoryLimit = self.boundedSearchMemoryLimit;
+	
+	return settings;
+}
+
+/**
+ *	Takes a search context out of the pool, creating a new one if every pooled context is in use by another query. The context is loaded
+ *  with a snapshot of the current map data and movement rules.
+ *
+ *	@return	A search context owned exclusively by the caller until it is returned with -enqueueSearchContext:.
+ */
+- (HUMAStarPathfinderSearchContext *)dequeueSearchContext {
+	HUMAStarPathfinderSearchContext *context = nil;
+	
+	@synchronized(self.searchContextPool) {
+		context = [self.searchContextPool lastObject];
+		if (context) {
+			[self.searchContextPool removeLastObject];
+		}
+	}
+	
+	if (!context) {
+		context = [[HUMAStarPathfinderSearchContext alloc] init];
+	}
+	
+	context.settings = [self currentSearchSettings];
+	
+	if (_chunkCache && !_navigationData) {
+		[context beginChunkCursorWithCache:_chunkCache];
+	}
+	
+	return context;
+}
+
+/**
+ *	Returns a search context to the pool so it can be reused by the next query.
+ *
+ *	@param	context	A context previously returned by -dequeueSearchContext.
+ */
+- (void)enqueueSearchContext:(HUMAStarPathfinderSearchContext *)context {
+	[context reset];
+	
+	@synchronized(self.searchContextPool) {
+		[self.searchContextPool addObject:context];
+	}
+}
+
+- (void)purgeSearchContexts {
+	@synchronized(self.searchContextPool) {
+		[self.searchContextPool removeAllObjects];
+	}
+}
+
+#pragma mark - Pathfinding
+/**
+ *	What the sample function needs to know about the running query.
+ */
+typedef struct {
+	__unsafe_unretained HUMAStarPathfinder *pathfinder;
+	NSUInteger unitSize;
+	NSUInteger baseMovementCost;
+	HUMChunkCursor *chunkCursor;	// the query's cursor into the paged map, or NULL
+} HUMAStarPathfinderSampleInfo;
+
+/**
+ *	Samples the walkability and cost of a tile for the search. Units larger than one tile use the clearance map, a loaded navigation file
+ *  takes the place of the delegate, and the cost layers are added to the cost. The clearance map and cost layers must be locked by the caller.
+ */
+static void HUMAStarPathfinderSampleTile(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost) {
+	HUMAStarPathfinderSampleInfo *sampleInfo = info;
+	HUMAStarPathfinder *pathfinder = sampleInfo->pathfinder;
+	HUMTileCache *tileCache = pathfinder->_tileCache;
+	CGPoint tileLocation = CGPointMake(x, y);
+	
+	if (sampleInfo->unitSize > 1) {
+		*walkable = HUMClearanceMapClearance(pathfinder->_clearanceMap, x, y) >= sampleInfo->unitSize;
+	}
+	else if (sampleInfo->chunkCursor) {
+		*walkable = HUMChunkCursorIsWalkable(sampleInfo->chunkCursor, x, y);
+	}
+	else {
+		*walkable = [pathfinder canWalkToNodeAtTileLocation:tileLocation];
+	}
+	
+	if (!*walkable) {
+		return;
+	}
+	
+	HUMNavigationData *navigationData = pathfinder->_navigationData;
+	
+	if (navigationData && navigationData->costs) {
+		*cost = HUMNavigationDataCost(navigationData, x, y, (uint32_t)sampleInfo->baseMovementCost);
+	}
+	else if (sampleInfo->chunkCursor) {
+		*cost = HUMChunkCursorCost(sampleInfo->chunkCursor, x, y);
+	}
+	else if (tileCache && tileCache->costs) {
+		*cost = HUMTileCacheCost(tileCache, x, y);
+	}
+	else if (pathfinder->_delegateFlags.delegateCostForNodeAtTileLocation) {
+		*cost = (uint32_t)MIN([pathfinder.delegate pathfinder:pathfinder costForNodeAtTileLocation:tileLocation], (NSUInteger)UINT32_MAX);
+	}
+	else {
+		*cost = (uint32_t)sampleInfo->baseMovementCost;
+	}
+	
+	HUMCostLayers *costLayers = pathfinder->_costLayers;
+	if (costLayers && costLayers->layerCount > 0) {
+		*cost = HUMCostLayersApply(costLayers, x, y, *cost);
+	}
+}
+
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target {
+	return [self findPathFromStart:start toTarget:target unitSize:1];
+}
+
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target unitSize:(NSUInteger)unitSize {
+	return [self findPathFromStart:start toTarget:target unitSize:unitSize searchMode:HUMAStarSearchModeUnidirectional];
+}
+
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target unitSize:(NSUInteger)unitSize searchMode:(HUMAStarSearchMode)searchMode {
+	NSAssert(unitSize > 0 && unitSize <= HUMClearanceMapMaximumClearance, @"unitSize must be between 1 and %d.", HUMClearanceMapMaximumClearance);
+	
+	// the map is sampled before the query is timed, and before any lock the sampling takes is held
+	BOOL recordsTrace = self.isRecordingTrace;
+	if (recordsTrace) {
+		[self recordTraceMapIfChanged];
+	}
+	
+	CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+	
+	HUMAStarPathfinderSearchContext *context = [self dequeueSearchContext];
+	context.unitSize = unitSize;
+	context.searchMode = searchMode;
+	
+	// the breadth-first search reads walkability from the clearance map, whatever the unit size
+	BOOL usesClearanceMap = (unitSize > 1 || searchMode == HUMAStarSearchModeBreadthFirst);
+	
+	BOOL usesVisibilityGraph = (unitSize == 1 && searchMode == HUMAStarSearchModeVisibilityGraph);
+	
+	// every search mode but the bounded one can fall back to A*, which is the one that skips swamps
+	context.prunesSwamps = self.prunesSwamps && searchMode != HUMAStarSearchModeBoundedMemory;
+	
+	if (usesClearanceMap) {
+		[self lockUpToDateClearanceMap];
+	}
+	
+	if (usesVisibilityGraph) {
+		[self lockUpToDateVisibilityGraph];
+	}
+	
+	if (context.prunesSwamps) {
+		HUMAStarSearchSettings settings = context.settings;
+		[self lockUpToDateSwampMapForNeighbors:HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders)];
+	}
+	
+	pthread_rwlock_rdlock(&_costLayerLock);
+	NSArray *path = [self findPathFromStart:start toTarget:target context:context];
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	if (context.prunesSwamps) {
+		[self unlockSwampMap];
+	}
+	
+	if (usesVisibilityGraph) {
+		[self unlockVisibilityGraph];
+	}
+	
+	if (usesClearanceMap) {
+		[self unlockClearanceMap];
+	}
+	
+	if (recordsTrace) {
+		[self recordTraceQueryFromStart:start toTarget:target path:path latency:CFAbsoluteTimeGetCurrent() - startTime context:context];
+	}
+	
+	[self enqueueSearchContext:context];
+	
+	return path;
+}
+
+- (NSArray *)findProvisionalPathFromStart:(CGPoint)start toTarget:(CGPoint)target expansionLimit:(NSUInteger)expansionLimit {
+	HUMAStarPathfinderSearchContext *context = [self dequeueSearchContext];
+	context.unitSize = 1;
+	context.searchMode = HUMAStarSearchModeUnidirectional;
+	context.prunesSwamps = NO;
+	
+	pthread_rwlock_rdlock(&_costLayerLock);
+	NSArray *path = [self findProvisionalPathFromStart:start toTarget:target expansionLimit:expansionLimit context:context];
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	[self enqueueSearchContext:context];
+	
+	return path;
+}
+
+/**
+ *	Runs a single greedy query using only the scratch state held by the provided context.
+ *
+ *	@param	context	The context owned by this query.
+ *
+ *	@return	See -findProvisionalPathFromStart:toTarget:expansionLimit:.
+ */
+- (NSArray *)findProvisionalPathFromStart:(CGPoint)start toTarget:(CGPoint)target expansionLimit:(NSUInteger)expansionLimit context:(HUMAStarPathfinderSearchContext *)context {
+	HUMAStarSearchSettings settings = context.settings;
+	context.startPoint = start;
+	
+	CGPoint startTileLocation = HUMAStarTileLocationForPosition(&settings, start);
+	CGPoint targetTileLocation = HUMAStarTileLocationForPosition(&settings, target);
+	
+	if (CGPointEqualToPoint(startTileLocation, targetTileLocation)) {
+		return nil;
+	}
+	
+	if (!HUMAStarIsTileValidAtLocation(settings.tileMapSize, startTileLocation) || !HUMAStarIsTileValidAtLocation(settings.tileMapSize, targetTileLocation)) {
+		return nil;
+	}
+	
+	HUMAStarPathfinderSampleInfo sampleInfo = { self, 1, settings.baseMovementCost, context.chunkCursor };
+	
+	bool targetWalkable = false;
+	uint32_t targetCost = 0;
+	HUMAStarPathfinderSampleTile(&sampleInfo, targetTileLocation.x, targetTileLocation.y, &targetWalkable, &targetCost);
+	
+	if (!targetWalkable) {
+		return nil;
+	}
+	
+	HUMSearchNeighbors neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+	HUMNavigationData *navigationData = _navigationData;
+	
+	// a greedy search toward a target in another component would lead the unit into a dead end
+	if (navigationData && navigationData->components && HUMNavigationNeighborsCompatible(neighbors, navigationData->componentNeighbors)) {
+		uint32_t startComponent = HUMNavigationDataComponent(navigationData, startTileLocation.x, startTileLocation.y);
+		uint32_t targetComponent = HUMNavigationDataComponent(navigationData, targetTileLocation.x, targetTileLocation.y);
+		
+		if (startComponent != 0 && targetComponent != 0 && startComponent != targetComponent) {
+			return nil;
+		}
+	}
+	
+	if (![context prepareForTileMapSize:settings.tileMapSize memoryLayout:settings.memoryLayout]) {
+		return nil;
+	}
+	
+	HUMSearchContext *search = context.search;
+	HUMSearchQuery query = { 0 };
+	query.startX = startTileLocation.x;
+	query.startY = startTileLocation.y;
+	query.targetX = targetTileLocation.x;
+	query.targetY = targetTileLocation.y;
+	query.neighbors = neighbors;
+	query.heuristic = (HUMSearchHeuristic)settings.distanceType;
+	query.sample = HUMAStarPathfinderSampleTile;
+	query.info = &sampleInfo;
+	
+	int32_t limit = (int32_t)MIN(expansionLimit, (NSUInteger)INT32_MAX);
+	
+	if (!HUMSearchFindProvisionalPath(search, &query, limit) || search->meetingNode == search->startNode) {
+		return nil;
+	}
+	
+	return [self generatePathInContext:context];
+}
+
+/**
+ *	Runs a single query using only the scratch state held by the provided context.
+ *
+ *	@param	start	A CGPoint where the path should start.
+ *	@param	target	A CGPoint where the path should end.
+ *	@param	context	The context owned by this query.
+ *
+ *	@return	See -findPathFromStart:toTarget:.
+ */
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target context:(HUMAStarPathfinderSearchContext *)context {
+	HUMAStarSearchSettings settings = context.settings;
+	context.startPoint = start;
+	
+	CGPoint startTileLocation = HUMAStarTileLocationForPosition(&settings, start);
+	CGPoint targetTileLocation = HUMAStarTileLocationForPosition(&settings, target);
+	
+	if (CGPointEqualToPoint(startTileLocation, targetTileLocation)) {
+		return nil;
+	}
+	
+	if (!HUMAStarIsTileValidAtLocation(settings.tileMapSize, startTileLocation) || !HUMAStarIsTileValidAtLocation(settings.tileMapSize, targetTileLocation)) {
+		return nil;
+	}
+	
+	HUMAStarPathfinderSampleInfo sampleInfo = { self, context.unitSize, settings.baseMovementCost, context.chunkCursor };
+	
+	// check to make sure we can actually get a path to the target node
+	bool targetWalkable = false;
+	uint32_t targetCost = 0;
+	HUMAStarPathfinderSampleTile(&sampleInfo, targetTileLocation.x, targetTileLocation.y, &targetWalkable, &targetCost);
+	
+	if (!targetWalkable) {
+		return nil;
+	}
+	
+	HUMSearchNeighbors neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+	
+	// tiles in different components of the navigation file can't reach each other. A unit larger than a tile only ever moves between tiles a
+	// single tile unit could, so the same holds for it.
+	HUMNavigationData *navigationData = _navigationData;
+	
+	if (navigationData && navigationData->components && HUMNavigationNeighborsCompatible(neighbors, navigationData->componentNeighbors)) {
+		uint32_t startComponent = HUMNavigationDataComponent(navigationData, startTileLocation.x, startTileLocation.y);
+		uint32_t targetComponent = HUMNavigationDataComponent(navigationData, targetTileLocation.x, targetTileLocation.y);
+		
+		if (startComponent != 0 && targetComponent != 0 && startComponent != targetComponent) {
+			return @[];
+		}
+	}
+	
+	if (context.searchMode == HUMAStarSearchModeBreadthFirst && !settings.pathDiagonally && [self hasUniformCosts]) {
+		return [self findBreadthFirstPathFromTile:startTileLocation toTile:targetTileLocation context:context];
+	}
+	
+	if (context.searchMode == HUMAStarSearchModeVisibilityGraph && context.unitSize == 1 && settings.pathDiagonally && _visibilityGraph && [self hasUniformCosts]) {
+		return [self findVisibilityGraphPathToTarget:targetTileLocation context:context];
+	}
+	
+	// the bounded search keeps its own state, so the context never allocates state for the whole map
+	if (context.searchMode == HUMAStarSearchModeBoundedMemory) {
+		HUMBoundedSearchQuery query = { 0 };
+		query.width = settings.tileMapSize.width;
+		query.height = settings.tileMapSize.height;
+		query.startX = startTileLocation.x;
+		query.startY = startTileLocation.y;
+		query.targetX = targetTileLocation.x;
+		query.targetY = targetTileLocation.y;
+		query.neighbors = neighbors;
+		query.heuristic = (HUMSearchHeuristic)settings.distanceType;
+		query.sample = HUMAStarPathfinderSampleTile;
+		query.info = &sampleInfo;
+		query.memoryLimit = settings.boundedSearchMemoryLimit;
+		
+		return [self findBoundedPathWithQuery:&query context:context];
+	}
+	
+	if (![context prepareForTileMapSize:settings.tileMapSize memoryLayout:settings.memoryLayout]) {
+		return nil;
+	}
+	
+	HUMSearchContext *search = context.search;
+	HUMSearchQuery query = { 0 };
+	query.startX = startTileLocation.x;
+	query.startY = startTileLocation.y;
+	query.targetX = targetTileLocation.x;
+	query.targetY = targetTileLocation.y;
+	query.neighbors = neighbors;
+	query.heuristic = (HUMSearchHeuristic)settings.distanceType;
+	query.sample = HUMAStarPathfinderSampleTile;
+	query.info = &sampleInfo;
+	query.bidirectional = (context.searchMode == HUMAStarSearchModeBidirectional);
+	
+	HUMSwampMap *swampMap = context.prunesSwamps ? _swampMap : NULL;
+	
+	if (swampMap && swampMap->neighbors == neighbors) {
+		// a swamp with more than one door is only skipped if every path around it costs what it was measured with. One with a single door
+		// never has to be entered, whatever the costs.
+		BOOL measuredCosts = (context.unitSize == 1 && [self hasUniformCosts] && swampMap->cost == settings.baseMovementCost);
+		query.prunedTiles = measuredCosts ? swampMap->swampTiles : swampMap->deadEndTiles;
+		HUMSwampMapGetSwampBounds(swampMap, query.startX, query.startY, &query.keptRects[0]);
+		HUMSwampMapGetSwampBounds(swampMap, query.targetX, query.targetY, &query.keptRects[1]);
+	}
+	
+	if (!HUMSearchFindPath(search, &query)) {
+		return @[];
+	}
+	
+	return [self generatePathInContext:context];
+}
+
+/**
+ *	Runs a bounded memory search and records how much memory it held.
+ *
+ *	@return	See -findPathFromStart:toTarget:. Also nil if the search ran out of memory or reached its expansion limit.
+ */
+- (NSArray *)findBoundedPathWithQuery:(const HUMBoundedSearchQuery *)query context:(HUMAStarPathfinderSearchContext *)context {
+	HUMBoundedSearchResult result;
+	HUMBoundedSearchFindPath(query, &result);
+	
+	pthread_mutex_lock(&_boundedSearchStatisticsLock);
+	_boundedSearchStatistics.queryCount++;
+	_boundedSearchStatistics.iterativeDeepeningCount += result.iterativeDeepening ? 1 : 0;
+	_boundedSearchStatistics.memoryLimitCount += (result.status == HUMBoundedSearchStatusMemoryLimit) ? 1 : 0;
+	_boundedSearchStatistics.expansionLimitCount += (result.status == HUMBoundedSearchStatusExpansionLimit) ? 1 : 0;
+	_boundedSearchStatistics.lastQueryPeakBytes = result.peakBytes;
+	_boundedSearchStatistics.maximumQueryPeakBytes = MAX(_boundedSearchStatistics.maximumQueryPeakBytes, result.peakBytes);
+	pthread_mutex_unlock(&_boundedSearchStatisticsLock);
+	
+	NSArray *path = nil;
+	
+	if (result.status == HUMBoundedSearchStatusFound) {
+		path = [self generatePathWithTileXs:result.xs ys:result.ys count:result.count context:context];
+	}
+	else if (result.status == HUMBoundedSearchStatusNoPath) {
+		path = @[];
+	}
+	
+	HUMBoundedSearchResultFree(&result);
+	
+	return path;
+}
+
+- (HUMAStarBoundedSearchStatistics)boundedSearchStatistics {
+	pthread_mutex_lock(&_boundedSearchStatisticsLock);
+	HUMAStarBoundedSearchStatistics statistics = _boundedSearchStatistics;
+	pthread_mutex_unlock(&_boundedSearchStatisticsLock);
+	
+	return statistics;
+}
+
+- (void)resetBoundedSearchStatistics {
+	pthread_mutex_lock(&_boundedSearchStatisticsLock);
+	memset(&_boundedSearchStatistics, 0, sizeof(HUMAStarBoundedSearchStatistics));
+	pthread_mutex_unlock(&_boundedSearchStatisticsLock);
+}
+
+/**
+ *	Determines if every tile costs the same, so the shortest path is also the cheapest. Must be called with the cost layer lock held.
+ */
+- (BOOL)hasUniformCosts {
+	if (_delegateFlags.delegateCostForNodeAtTileLocation || _delegateFlags.delegateGetCostsForTilesInRect) {
+		return NO;
+	}
+	
+	if ((_navigationData && _navigationData->costs) || (_chunkCache && !_navigationData)) {
+		return NO;
+	}
+	
+	return !_costLayers || _costLayers->layerCount == 0;
+}
+
+/**
+ *	Runs a bit-parallel breadth-first search. Must be called with the clearance map locked.
+ *
+ *	@return	See -findPathFromStart:toTarget:.
+ */
+- (NSArray *)findBreadthFirstPathFromTile:(CGPoint)startTileLocation toTile:(CGPoint)targetTileLocation context:(HUMAStarPathfinderSearchContext *)context {
+	if (![context prepareBitSearchForTileMapSize:context.settings.tileMapSize]) {
+		return nil;
+	}
+	
+	HUMBitSearchContext *bitSearch = context.bitSearch;
+	HUMBitSearchLoadClearance(bitSearch, _clearanceMap->clearance, (uint8_t)context.unitSize);
+	
+	if (!HUMBitSearchFindPath(bitSearch, startTileLocation.x, startTileLocation.y, targetTileLocation.x, targetTileLocation.y)) {
+		return @[];
+	}
+	
+	int32_t length = HUMBitSearchCopyPath(bitSearch, NULL, NULL, 0);
+	int32_t *xs = malloc(length * sizeof(int32_t));
+	int32_t *ys = malloc(length * sizeof(int32_t));
+	HUMBitSearchCopyPath(bitSearch, xs, ys, length);
+	
+	NSArray *path = [self generatePathWithTileXs:xs ys:ys count:length context:context];
+	
+	free(xs);
+	free(ys);
+	
+	return path;
+}
+
+/**
+ *	Finds an any-angle path through the visibility graph, from the context's start point to the center of the target tile. Must be called with
+ *  the visibility graph locked.
+ *
+ *	@return	See -findPathFromStart:toTarget:.
+ */
+- (NSArray *)findVisibilityGraphPathToTarget:(CGPoint)targetTileLocation context:(HUMAStarPathfinderSearchContext *)context {
+	HUMAStarSearchSettings settings = context.settings;
+	HUMVisibilityGraph *graph = _visibilityGraph;
+	
+	double startX, startY;
+	HUMAStarGetTileCoordinatesForPosition(&settings, context.startPoint, &startX, &startY);
+	
+	// the start tile has to be walkable for the path to leave it in a straight line
+	CGPoint startTileLocation = HUMAStarTileLocationForPosition(&settings, context.startPoint);
+	if (!graph->walkable[(NSInteger)startTileLocation.y * graph->width + (NSInteger)startTileLocation.x]) {
+		return @[];
+	}
+	
+	HUMVisibilityPath path;
+	if (!HUMVisibilityGraphFindPath(graph, startX, startY, targetTileLocation.x + 0.5, targetTileLocation.y + 0.5, &path)) {
+		HUMVisibilityPathFree(&path);
+		return @[];
+	}
+	
+	NSMutableArray *points = [NSMutableArray arrayWithCapacity:path.count];
+	
+	for (int32_t i = 0; i < path.count; i++) {
+		CGPoint position = i == 0 ? context.startPoint : HUMAStarPositionForTileCoordinates(&settings, path.xs[i], path.ys[i]);
+#if TARGET_OS_IPHONE
+		[points addObject:[NSValue valueWithCGPoint:position]];
+#else
+		[points addObject:[NSValue valueWithPoint:position]];
+#endif
+	}
+	
+	HUMVisibilityPathFree(&path);
+	
+	return [NSArray arrayWithArray:points];
+}
+
+/**
+ *	Generates an array of points connecting the start point to the target node from the tiles of the path found by the last search.
+ *
+ *	@param	context	The context of the running query.
+ *
+ *	@return	An NSArray of NSValues, starting at the context's start point.
+ */
+- (NSArray *)generatePathInContext:(HUMAStarPathfinderSearchContext *)context {
+	HUMSearchContext *search = context.search;
+	
+	int32_t length = HUMSearchCopyPath(search, NULL, NULL, 0);
+	int32_t *xs = malloc(length * sizeof(int32_t));
+	int32_t *ys = malloc(length * sizeof(int32_t));
+	HUMSearchCopyPath(search, xs, ys, length);
+	
+	NSArray *path = [self generatePathWithTileXs:xs ys:ys count:length context:context];
+	
+	free(xs);
+	free(ys);
+	
+	return path;
+}
+
+/**
+ *	Generates an array of points connecting the start point to the target node from the tiles of a path.
+ *
+ *	@param	xs		The x of every tile of the path, starting at the start tile.
+ *	@param	ys		The y of every tile of the path.
+ *	@param	count	The number of tiles in the path.
+ *	@param	context	The context of the running query.
+ *
+ *	@return	An NSArray of NSValues, starting at the context's start point.
+ */
+- (NSArray *)generatePathWithTileXs:(const int32_t *)xs ys:(const int32_t *)ys count:(int32_t)count context:(HUMAStarPathfinderSearchContext *)context {
+	HUMAStarSearchSettings settings = context.settings;
+	NSMutableArray *shortestPath = [NSMutableArray arrayWithCapacity:count];
+	
+#if TARGET_OS_IPHONE
+	[shortestPath addObject:[NSValue valueWithCGPoint:context.startPoint]];
+#else
+	[shortestPath addObject:[NSValue valueWithPoint:context.startPoint]];
+#endif
+	
+	// the first tile is the start tile, which is replaced by the exact start point
+	for (int32_t i = 1; i < count; i++) {
+		CGPoint screenPosition = HUMAStarPositionForTileLocation(&settings, CGPointMake(xs[i], ys[i]));
+#if TARGET_OS_IPHONE
+		[shortestPath addObject:[NSValue valueWithCGPoint:screenPosition]];
+#else
+		[shortestPath addObject:[NSValue valueWithPoint:screenPosition]];
+#endif
+	}
+	
+	return [NSArray arrayWithArray:shortestPath];
+}
+
+#pragma mark - Path Costs
+- (NSUInteger)pathCostFromStart:(CGPoint)start toTarget:(CGPoint)target {
+	return [self pathCostFromStart:start toTarget:target unitSize:1];
+}
+
+- (NSUInteger)pathCostFromStart:(CGPoint)start toTarget:(CGPoint)target unitSize:(NSUInteger)unitSize {
+	NSUInteger cost = NSNotFound;
+	[self getPathCosts:&cost fromStart:start toTargets:&target count:1 unitSize:unitSize];
+	
+	return cost;
+}
+
+- (void)getPathCosts:(NSUInteger *)costs fromStart:(CGPoint)start toTargets:(const CGPoint *)targets count:(NSUInteger)count unitSize:(NSUInteger)unitSize {
+	NSAssert(unitSize > 0 && unitSize <= HUMClearanceMapMaximumClearance, @"unitSize must be between 1 and %d.", HUMClearanceMapMaximumClearance);
+	
+	if (count == 0) {
+		return;
+	}
+	
+	HUMAStarPathfinderSearchContext *context = [self dequeueSearchContext];
+	context.unitSize = unitSize;
+	context.searchMode = HUMAStarSearchModeUnidirectional;
+	
+	// only a search toward a single target can skip swamps, since the swamps kept open depend on the target
+	context.prunesSwamps = self.prunesSwamps && count == 1;
+	
+	if (unitSize > 1) {
+		[self lockUpToDateClearanceMap];
+	}
+	
+	if (context.prunesSwamps) {
+		HUMAStarSearchSettings settings = context.settings;
+		[self lockUpToDateSwampMapForNeighbors:HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders)];
+	}
+	
+	pthread_rwlock_rdlock(&_costLayerLock);
+	[self getPathCosts:costs fromStart:start toTargets:targets count:count context:context];
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	if (context.prunesSwamps) {
+		[self unlockSwampMap];
+	}
+	
+	if (unitSize > 1) {
+		[self unlockClearanceMap];
+	}
+	
+	[self enqueueSearchContext:context];
+}
+
+/**
+ *	Finds the costs of the paths to the targets using only the scratch state held by the provided context. Targets that can't be reached, whether
+ *  because they're off the map, not walkable, or in a different component of the navigation file, are never handed to the search.
+ *
+ *	@param	context	The context owned by this query.
+ */
+- (void)getPathCosts:(NSUInteger *)costs fromStart:(CGPoint)start toTargets:(const CGPoint *)targets count:(NSUInteger)count context:(HUMAStarPathfinderSearchContext *)context {
+	HUMAStarSearchSettings settings = context.settings;
+	CGPoint startTileLocation = HUMAStarTileLocationForPosition(&settings, start);
+	
+	for (NSUInteger i = 0; i < count; i++) {
+		costs[i] = NSNotFound;
+	}
+	
+	if (!HUMAStarIsTileValidAtLocation(settings.tileMapSize, startTileLocation) || ![context prepareForTileMapSize:settings.tileMapSize memoryLayout:settings.memoryLayout]) {
+		return;
+	}
+	
+	HUMAStarPathfinderSampleInfo sampleInfo = { self, context.unitSize, settings.baseMovementCost, context.chunkCursor };
+	HUMSearchNeighbors neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+	
+	HUMNavigationData *navigationData = _navigationData;
+	BOOL usesComponents = (navigationData && navigationData->components && HUMNavigationNeighborsCompatible(neighbors, navigationData->componentNeighbors));
+	uint32_t startComponent = usesComponents ? HUMNavigationDataComponent(navigationData, startTileLocation.x, startTileLocation.y) : 0;
+	
+	int32_t *xs = malloc(count * sizeof(int32_t));
+	int32_t *ys = malloc(count * sizeof(int32_t));
+	NSUInteger *indexes = malloc(count * sizeof(NSUInteger));
+	int32_t searchCount = 0;
+	
+	for (NSUInteger i = 0; i < count; i++) {
+		CGPoint targetTileLocation = HUMAStarTileLocationForPosition(&settings, targets[i]);
+		
+		if (!HUMAStarIsTileValidAtLocation(settings.tileMapSize, targetTileLocation)) {
+			continue;
+		}
+		
+		if (CGPointEqualToPoint(startTileLocation, targetTileLocation)) {
+			costs[i] = 0;
+			continue;
+		}
+		
+		if (usesComponents) {
+			uint32_t targetComponent = HUMNavigationDataComponent(navigationData, targetTileLocation.x, targetTileLocation.y);
+			
+			if (startComponent != 0 && targetComponent != 0 && startComponent != targetComponent) {
+				continue;
+			}
+		}
+		
+		xs[searchCount] = targetTileLocation.x;
+		ys[searchCount] = targetTileLocation.y;
+		indexes[searchCount] = i;
+		searchCount++;
+	}
+	
+	HUMSearchContext *search = context.search;
+	
+	if (searchCount == 1) {
+		// a single target is searched for like a path, so swamps are skipped and the search stops at the target
+		HUMSearchQuery query = { 0 };
+		query.startX = startTileLocation.x;
+		query.startY = startTileLocation.y;
+		query.targetX = xs[0];
+		query.targetY = ys[0];
+		query.neighbors = neighbors;
+		query.heuristic = (HUMSearchHeuristic)settings.distanceType;
+		query.sample = HUMAStarPathfinderSampleTile;
+		query.info = &sampleInfo;
+		
+		HUMSwampMap *swampMap = context.prunesSwamps ? _swampMap : NULL;
+		
+		if (swampMap && swampMap->neighbors == neighbors) {
+			BOOL measuredCosts = (context.unitSize == 1 && [self hasUniformCosts] && swampMap->cost == settings.baseMovementCost);
+			query.prunedTiles = measuredCosts ? swampMap->swampTiles : swampMap->deadEndTiles;
+			HUMSwampMapGetSwampBounds(swampMap, query.startX, query.startY, &query.keptRects[0]);
+			HUMSwampMapGetSwampBounds(swampMap, query.targetX, query.targetY, &query.keptRects[1]);
+		}
+		
+		bool targetWalkable = false;
+		uint32_t targetCost = 0;
+		HUMAStarPathfinderSampleTile(&sampleInfo, query.targetX, query.targetY, &targetWalkable, &targetCost);
+		
+		if (targetWalkable && HUMSearchFindPath(search, &query)) {
+			costs[indexes[0]] = HUMSearchPathCost(search);
+		}
+	}
+	else if (searchCount > 1) {
+		uint32_t *searchCosts = malloc(searchCount * sizeof(uint32_t));
+		
+		HUMSearchCostQuery query;
+		query.startX = startTileLocation.x;
+		query.startY = startTileLocation.y;
+		query.targetXs = xs;
+		query.targetYs = ys;
+		query.targetCount = searchCount;
+		query.neighbors = neighbors;
+		query.heuristic = (HUMSearchHeuristic)settings.distanceType;
+		query.sample = HUMAStarPathfinderSampleTile;
+		query.info = &sampleInfo;
+		
+		HUMSearchFindCosts(search, &query, searchCosts);
+		
+		for (int32_t i = 0; i < searchCount; i++) {
+			if (searchCosts[i] != UINT32_MAX) {
+				costs[indexes[i]] = searchCosts[i];
+			}
+		}
+		
+		free(searchCosts);
+	}
+	
+	free(xs);
+	free(ys);
+	free(indexes);
+}
+
+#pragma mark - Query Traces
+- (BOOL)startRecordingTraceToPath:(NSString *)path error:(NSError **)error {
+	NSParameterAssert(path);
+	
+	[self stopRecordingTrace];
+	
+	HUMTraceWriter *writer = HUMTraceWriterOpen([path fileSystemRepresentation]);
+	
+	if (!writer) {
+		if (error) {
+			*error = [NSError errorWithDomain:HUMAStarPathfinderErrorDomain code:HUMAStarPathfinderErrorTraceUnwritable userInfo:@{ NSLocalizedDescriptionKey : @"The trace file couldn't be created.", NSFilePathErrorKey : path }];
+		}
+	
+		return NO;
+	}
+	
+	pthread_mutex_lock(&_traceLock);
+	_traceWriter = writer;
+	_traceMapStale = YES;
+	pthread_mutex_unlock(&_traceLock);
+	
+	return YES;
+}
+
+- (void)stopRecordingTrace {
+	pthread_mutex_lock(&_traceLock);
+	HUMTraceWriterClose(_traceWriter);
+	_traceWriter = NULL;
+	pthread_mutex_unlock(&_traceLock);
+}
+
+- (BOOL)isRecordingTrace {
+	pthread_mutex_lock(&_traceLock);
+	BOOL recording = (_traceWriter != NULL);
+	pthread_mutex_unlock(&_traceLock);
+	
+	return recording;
+}
+
+/**
+ *	Marks the whole map as changed, so it's sampled and recorded again before the next query is.
+ */
+- (void)traceMapChanged {
+	pthread_mutex_lock(&_traceLock);
+	_traceMapStale = (_traceWriter != NULL);
+	pthread_mutex_unlock(&_traceLock);
+}
+
+/**
+ *	Samples and records the whole map if it changed since it was last recorded. Must not be called with the cost layer lock held.
+ */
+- (void)recordTraceMapIfChanged {
+	pthread_mutex_lock(&_traceLock);
+	BOOL changed = (_traceWriter != NULL && _traceMapStale);
+	_traceMapStale = NO;
+	pthread_mutex_unlock(&_traceLock);
+	
+	if (!changed) {
+		return;
+	}
+	
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	size_t tileCount = (size_t)(settings.tileMapSize.width * settings.tileMapSize.height);
+	uint8_t *walkable = malloc(tileCount);
+	uint32_t *costs = malloc(tileCount * sizeof(uint32_t));
+	
+	if (walkable && costs) {
+		[self sampleWalkableFlags:walkable costs:costs settings:&settings];
+	
+		pthread_mutex_lock(&_traceLock);
+		if (_traceWriter) {
+			HUMTraceWriteMap(_traceWriter, settings.tileMapSize.width, settings.tileMapSize.height, walkable, costs);
+		}
+		pthread_mutex_unlock(&_traceLock);
+	}
+	
+	free(walkable);
+	free(costs);
+}
+
+/**
+ *	Samples and records the tiles in a rect that changed, unless the whole map is about to be recorded again anyway. Must not be called with
+ *  the cost layer lock held.
+ *
+ *	@param	tileRect	The rect of tiles that changed, in tile coordinates.
+ *	@param	source		What changed them.
+ */
+- (void)recordTraceTilesInRect:(CGRect)tileRect source:(HUMTraceEditSource)source {
+	pthread_mutex_lock(&_traceLock);
+	BOOL recordsTiles = (_traceWriter != NULL && !_traceMapStale);
+	pthread_mutex_unlock(&_traceLock);
+	
+	if (!recordsTiles) {
+		return;
+	}
+	
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	CGRect mapRect = CGRectMake(0, 0, settings.tileMapSize.width, settings.tileMapSize.height);
+	tileRect = CGRectIntersection(CGRectIntegral(tileRect), mapRect);
+	
+	if (CGRectIsEmpty(tileRect)) {
+		return;
+	}
+	
+	HUMSearchTileRect rect = { tileRect.origin.x, tileRect.origin.y, tileRect.size.width, tileRect.size.height };
+	uint8_t *walkable = malloc((size_t)rect.width * rect.height);
+	uint32_t *costs = malloc((size_t)rect.width * rect.height * sizeof(uint32_t));
+	
+	if (walkable && costs) {
+		HUMChunkCursor chunkCursor;
+		HUMAStarPathfinderSampleInfo sampleInfo = { self, 1, settings.baseMovementCost, [self beginChunkCursor:&chunkCursor] };
+	
+		pthread_rwlock_rdlock(&_costLayerLock);
+	
+		for (int32_t y = 0; y < rect.height; y++) {
+			for (int32_t x = 0; x < rect.width; x++) {
+				bool tileWalkable = false;
+				uint32_t tileCost = 0;
+				HUMAStarPathfinderSampleTile(&sampleInfo, rect.x + x, rect.y + y, &tileWalkable, &tileCost);
+	
+				walkable[y * rect.width + x] = tileWalkable;
+				costs[y * rect.width + x] = tileCost;
+			}
+		}
+	
+		pthread_rwlock_unlock(&_costLayerLock);
+	
+		if (sampleInfo.chunkCursor) {
+			HUMChunkCursorFinish(sampleInfo.chunkCursor);
+		}
+	
+		pthread_mutex_lock(&_traceLock);
+		if (_traceWriter && !_traceMapStale) {
+			HUMTraceWriteEdit(_traceWriter, source, rect, walkable, costs);
+		}
+		pthread_mutex_unlock(&_traceLock);
+	}
+	
+	free(walkable);
+	free(costs);
+}
+
+/**
+ *	Records a query that just ran, along with the settings it ran with. Must be called before the context is returned to the pool.
+ *
+ *	@param	path	The path the query returned.
+ *	@param	latency	How long the query took, in seconds.
+ */
+- (void)recordTraceQueryFromStart:(CGPoint)start toTarget:(CGPoint)target path:(NSArray *)path latency:(CFTimeInterval)latency context:(HUMAStarPathfinderSearchContext *)context {
+	HUMAStarSearchSettings settings = context.settings;
+	CGPoint startTileLocation = HUMAStarTileLocationForPosition(&settings, start);
+	CGPoint targetTileLocation = HUMAStarTileLocationForPosition(&settings, target);
+	
+	HUMTraceSettings traceSettings = { 0 };
+	traceSettings.neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+	traceSettings.heuristic = (HUMSearchHeuristic)settings.distanceType;
+	traceSettings.layout = (HUMSearchLayout)settings.memoryLayout;
+	traceSettings.baseMovementCost = (uint32_t)settings.baseMovementCost;
+	traceSettings.boundedSearchMemoryLimit = settings.boundedSearchMemoryLimit;
+	traceSettings.prunesSwamps = self.prunesSwamps;
+	
+	pthread_rwlock_rdlock(&_costLayerLock);
+	traceSettings.uniformCosts = [self hasUniformCosts];
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	HUMTraceQuery query = { 0 };
+	query.startX = startTileLocation.x;
+	query.startY = startTileLocation.y;
+	query.targetX = targetTileLocation.x;
+	query.targetY = targetTileLocation.y;
+	query.unitSize = (uint32_t)context.unitSize;
+	query.searchMode = (uint32_t)context.searchMode;
+	query.result = !path ? HUMTraceResultNone : (path.count == 0 ? HUMTraceResultNoPath : HUMTraceResultPath);
+	query.pathCount = (uint32_t)path.count;
+	query.latency = (uint64_t)(MAX(latency, 0.0) * 1e9);
+	
+	pthread_mutex_lock(&_traceLock);
+	if (_traceWriter) {
+		HUMTraceWriteSettings(_traceWriter, &traceSettings);
+		HUMTraceWriteQuery(_traceWriter, &query);
+	}
+	pthread_mutex_unlock(&_traceLock);
+}
+
+#pragma mark - Path Repair
+- (HUMAStarPathfinderRepairedPath *)repairPath:(NSArray *)path changedTilesInRect:(CGRect)tileRect unitSize:(NSUInteger)unitSize {
+	NSParameterAssert(path.count >= 2);
+	NSAssert(unitSize > 0 && unitSize <= HUMClearanceMapMaximumClearance, @"unitSize must be between 1 and %d.", HUMClearanceMapMaximumClearance);
+	
+	HUMAStarPathfinderSearchContext *context = [self dequeueSearchContext];
+	context.unitSize = unitSize;
+	
+	if (unitSize > 1) {
+		[self lockUpToDateClearanceMap];
+	}
+	
+	pthread_rwlock_rdlock(&_costLayerLock);
+	HUMAStarPathfinderRepairedPath *repairedPath = [self repairPath:path changedTilesInRect:tileRect context:context];
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	if (unitSize > 1) {
+		[self unlockClearanceMap];
+	}
+	
+	[self enqueueSearchContext:context];
+	
+	if (repairedPath) {
+		return repairedPath;
+	}
+	
+	// no detour nearby, so the path has to be searched for again, with every lock it needs
+#if TARGET_OS_IPHONE
+	CGPoint start = [path[0] CGPointValue];
+	CGPoint target = [[path lastObject] CGPointValue];
+#else
+	CGPoint start = [path[0] pointValue];
+	CGPoint target = [[path lastObject] pointValue];
+#endif
+	
+	NSArray *replannedPath = [self findPathFromStart:start toTarget:target unitSize:unitSize];
+	return [[HUMAStarPathfinderRepairedPath alloc] initWithPath:replannedPath repaired:NO replanned:YES];
+}
+
+/**
+ *	Checks the moves of a path near the changed tiles and splices in a detour around any that are broken.
+ *
+ *	@return	The repaired or unchanged path, or nil if it has to be searched for again.
+ */
+- (HUMAStarPathfinderRepairedPath *)repairPath:(NSArray *)path changedTilesInRect:(CGRect)tileRect context:(HUMAStarPathfinderSearchContext *)context {
+	HUMAStarSearchSettings settings = context.settings;
+	NSUInteger count = path.count;
+	
+	int32_t *xs = malloc(count * sizeof(int32_t));
+	int32_t *ys = malloc(count * sizeof(int32_t));
+	
+	if (!xs || !ys || ![context prepareForTileMapSize:settings.tileMapSize memoryLayout:settings.memoryLayout]) {
+		free(xs);
+		free(ys);
+		return nil;
+	}
+	
+	for (NSUInteger i = 0; i < count; i++) {
+#if TARGET_OS_IPHONE
+		CGPoint position = [path[i] CGPointValue];
+#else
+		CGPoint position = [path[i] pointValue];
+#endif
+		CGPoint tileLocation = HUMAStarTileLocationForPosition(&settings, position);
+		
+		if (i == 0) {
+			context.startPoint = position;
+		}
+		
+		if (!HUMAStarIsTileValidAtLocation(settings.tileMapSize, tileLocation)) {
+			free(xs);
+			free(ys);
+			return nil;
+		}
+		
+		xs[i] = tileLocation.x;
+		ys[i] = tileLocation.y;
+	}
+	
+	HUMAStarPathfinderSampleInfo sampleInfo = { self, context.unitSize, settings.baseMovementCost, context.chunkCursor };
+	
+	// a unit is anchored at its top-left tile, so a changed tile affects every anchor up to unitSize - 1 tiles above and to the left of it
+	CGRect integralRect = CGRectIntegral(tileRect);
+	int32_t reach = (int32_t)context.unitSize - 1;
+	
+	HUMPathRepairQuery query = { 0 };
+	query.xs = xs;
+	query.ys = ys;
+	query.count = (int32_t)count;
+	query.changedRect.x = (int32_t)CGRectGetMinX(integralRect) - reach;
+	query.changedRect.y = (int32_t)CGRectGetMinY(integralRect) - reach;
+	query.changedRect.width = (int32_t)CGRectGetWidth(integralRect) + reach;
+	query.changedRect.height = (int32_t)CGRectGetHeight(integralRect) + reach;
+	query.neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+	query.heuristic = (HUMSearchHeuristic)settings.distanceType;
+	query.sample = HUMAStarPathfinderSampleTile;
+	query.info = &sampleInfo;
+	
+	HUMPathRepairResult result;
+	HUMPathRepair(context.search, &query, &result);
+	
+	HUMAStarPathfinderRepairedPath *repairedPath = nil;
+	
+	if (result.status == HUMPathRepairStatusUnchanged) {
+		repairedPath = [[HUMAStarPathfinderRepairedPath alloc] initWithPath:path repaired:NO replanned:NO];
+	}
+	else if (result.status == HUMPathRepairStatusRepaired) {
+		NSArray *points = [self generatePathWithTileXs:result.xs ys:result.ys count:result.count context:context];
+		repairedPath = [[HUMAStarPathfinderRepairedPath alloc] initWithPath:points repaired:YES replanned:NO];
+	}
+	
+	HUMPathRepairResultFree(&result);
+	free(xs);
+	free(ys);
+	
+	return repairedPath;
+}
+
+#pragma mark - Reachability
+- (HUMAStarPathfinderReachableTiles *)reachableTilesFromTile:(CGPoint)tileLocation withinCost:(NSUInteger)maximumCost {
+	return [self reachableTilesFromTile:tileLocation withinCost:maximumCost options:HUMAStarReachabilityOptionsIncludeCosts | HUMAStarReachabilityOptionsIncludeParents];
+}
+
+- (HUMAStarPathfinderReachableTiles *)reachableTilesFromTile:(CGPoint)tileLocation withinCost:(NSUInteger)maximumCost options:(HUMAStarReachabilityOptions)options {
+	HUMAStarPathfinderSearchContext *context = [self dequeueSearchContext];
+	HUMAStarSearchSettings settings = context.settings;
+	
+	if (!HUMAStarIsTileValidAtLocation(settings.tileMapSize, tileLocation) || ![context prepareForTileMapSize:settings.tileMapSize memoryLayout:settings.memoryLayout]) {
+		[self enqueueSearchContext:context];
+		return nil;
+	}
+	
+	HUMSearchContext *search = context.search;
+	HUMAStarPathfinderSampleInfo sampleInfo = { self, 1, settings.baseMovementCost, context.chunkCursor };
+	
+	HUMSearchReachQuery query;
+	query.startX = tileLocation.x;
+	query.startY = tileLocation.y;
+	query.maximumCost = (uint32_t)MIN(maximumCost, (NSUInteger)UINT32_MAX - 1);
+	query.neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+	query.sample = HUMAStarPathfinderSampleTile;
+	query.info = &sampleInfo;
+	
+	pthread_rwlock_rdlock(&_costLayerLock);
+	int32_t count = HUMSearchFindReachable(search, &query);
+	pthread_rwlock_unlock(&_costLayerLock);
+	
+	size_t tileCount = (size_t)search->width * (size_t)search->height;
+	uint8_t *bitmap = malloc((tileCount + 7) / 8);
+	uint32_t *costs = (options & HUMAStarReachabilityOptionsIncludeCosts) ? malloc(tileCount * sizeof(uint32_t)) : NULL;
+	int32_t *parents = (options & HUMAStarReachabilityOptionsIncludeParents) ? malloc(tileCount * sizeof(int32_t)) : NULL;
+	
+	HUMSearchCopyReachable(search, bitmap, costs, parents);
+	
+	[self enqueueSearchContext:context];
+	
+	return [[HUMAStarPathfinderReachableTiles alloc] initWithTileMapSize:settings.tileMapSize originTileLocation:tileLocation maximumCost:maximumCost count:count bitmapNoCopy:bitmap costsNoCopy:costs parentsNoCopy:parents];
+}
+
+#pragma mark - Flow Fields
+/**
+ *	Runs the flow field solver's blocks on the global concurrent queue.
+ */
+static void HUMAStarPathfinderApply(void *info, size_t iterations, void *context, void (*work)(void *context, size_t iteration)) {
+	dispatch_apply_f(iterations, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), context, work);
+}
+
+/**
+ *	Samples the walkability and entry cost of every tile the way a search would, including cost layers. Rows are sampled in parallel, each
+ *  with its own cursor into the paged map.
+ *
+ *	@param	walkable	tileMapSize.width * tileMapSize.height flags, row-major.
+ *	@param	costs		tileMapSize.width * tileMapSize.height entry costs, row-major.
+ */
+- (void)sampleWalkableFlags:(uint8_t *)walkable costs:(uint32_t *)costs settings:(const HUMAStarSearchSettings *)settings {
+	size_t width = settings->tileMapSize.width;
+	size_t height = settings->tileMapSize.height;
+	NSUInteger baseMovementCost = settings->baseMovementCost;
+	
+	pthread_rwlock_rdlock(&_costLayerLock);
+	
+	dispatch_apply(height, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t y) {
+		HUMChunkCursor chunkCursor;
+		HUMAStarPathfinderSampleInfo sampleInfo = { self, 1, baseMovementCost, [self beginChunkCursor:&chunkCursor] };
+		
+		for (size_t x = 0; x < width; x++) {
+			bool tileWalkable = false;
+			uint32_t tileCost = 0;
+			HUMAStarPathfinderSampleTile(&sampleInfo, (int32_t)x, (int32_t)y, &tileWalkable, &tileCost);
+			
+			walkable[y * width + x] = tileWalkable;
+			costs[y * width + x] = tileCost;
+		}
+		
+		if (sampleInfo.chunkCursor) {
+			HUMChunkCursorFinish(sampleInfo.chunkCursor);
+		}
+	});
+	
+	pthread_rwlock_unlock(&_costLayerLock);
+}
+
+- (HUMAStarPathfinderFlowField *)flowFieldToTile:(CGPoint)targetTileLocation {
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	
+	if (!HUMAStarIsTileValidAtLocation(settings.tileMapSize, targetTileLocation)) {
+		return nil;
+	}
+	
+	size_t width = settings.tileMapSize.width;
+	size_t height = settings.tileMapSize.height;
+	uint8_t *walkable = malloc(width * height);
+	uint32_t *costs = malloc(width * height * sizeof(uint32_t));
+	uint32_t *integration = malloc(width * height * sizeof(uint32_t));
+	int8_t *directions = malloc(width * height);
+	
+	if (!walkable || !costs || !integration || !directions) {
+		free(walkable);
+		free(costs);
+		free(integration);
+		free(directions);
+		return nil;
+	}
+	
+	// the solver needs every tile up front
+	[self sampleWalkableFlags:walkable costs:costs settings:&settings];
+	
+	HUMFlowFieldQuery query;
+	query.width = (int32_t)width;
+	query.height = (int32_t)height;
+	query.walkable = walkable;
+	query.costs = costs;
+	query.neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+	query.targetX = targetTileLocation.x;
+	query.targetY = targetTileLocation.y;
+	query.apply = HUMAStarPathfinderApply;
+	query.applyInfo = NULL;
+	
+	BOOL solved = HUMFlowFieldSolve(&query, integration, directions);
+	
+	free(walkable);
+	free(costs);
+	
+	if (!solved) {
+		free(integration);
+		free(directions);
+		return nil;
+	}
+	
+	return [[HUMAStarPathfinderFlowField alloc] initWithTileMapSize:settings.tileMapSize targetTileLocation:targetTileLocation integrationNoCopy:integration directionsNoCopy:directions];
+}
+
+#pragma mark - Navigation Meshes
+/**
+ *	Blocks the cells an obstacle covers.
+ *
+ *	@param	obstacle	NSValue-wrapped CGPoints, in positions.
+ *	@param	closed			YES for a polygon, NO for a polyline.
+ */
+- (void)blockCells:(uint8_t *)walkable width:(int32_t)width height:(int32_t)height cellsPerTile:(NSUInteger)cellsPerTile obstacle:(NSArray *)points closed:(BOOL)closed settings:(const HUMAStarSearchSettings *)settings {
+	int32_t count = (int32_t)points.count;
+	float *xs = malloc(MAX(count, 1) * sizeof(float));
+	float *ys = malloc(MAX(count, 1) * sizeof(float));
+	
+	if (xs && ys) {
+		for (int32_t i = 0; i < count; i++) {
+#if TARGET_OS_IPHONE
+			CGPoint position = [points[i] CGPointValue];
+#else
+			CGPoint position = [points[i] pointValue];
+#endif
+			CGFloat tileY = position.y / settings->tileSize.height;
+			
+			if (settings->coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+				tileY = settings->tileMapSize.height - tileY;
+			}
+			
+			xs[i] = position.x / settings->tileSize.width * cellsPerTile;
+			ys[i] = tileY * cellsPerTile;
+		}
+		
+		HUMNavMeshBlockObstacle(walkable, width, height, xs, ys, count, closed);
+	}
+	
+	free(xs);
+	free(ys);
+}
+
+- (HUMAStarPathfinderNavigationMesh *)navigationMeshWithObstaclePolygons:(NSArray *)polygons polylines:(NSArray *)polylines cellsPerTile:(NSUInteger)cellsPerTile {
+	NSAssert(cellsPerTile > 0 && cellsPerTile <= 16, @"cellsPerTile must be between 1 and 16.");
+	
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	
+	if (settings.tileMapSize.width <= 0 || settings.tileMapSize.height <= 0) {
+		return nil;
+	}
+	
+	NSInteger tileWidth = settings.tileMapSize.width;
+	NSInteger tileHeight = settings.tileMapSize.height;
+	int32_t width = (int32_t)(tileWidth * cellsPerTile);
+	int32_t height = (int32_t)(tileHeight * cellsPerTile);
+	uint8_t *tiles = malloc(tileWidth * tileHeight);
+	uint8_t *cells = malloc((size_t)width * height);
+	
+	if (!tiles || !cells) {
+		free(tiles);
+		free(cells);
+		return nil;
+	}
+	
+	[self getWalkableFlags:tiles forTilesInRect:CGRectMake(0, 0, tileWidth, tileHeight)];
+	
+	for (int32_t y = 0; y < height; y++) {
+		for (int32_t x = 0; x < width; x++) {
+			cells[y * width + x] = tiles[(y / cellsPerTile) * tileWidth + x / cellsPerTile];
+		}
+	}
+	
+	free(tiles);
+	
+	for (NSArray *polygon in polygons) {
+		[self blockCells:cells width:width height:height cellsPerTile:cellsPerTile obstacle:polygon closed:YES settings:&settings];
+	}
+	
+	for (NSArray *polyline in polylines) {
+		[self blockCells:cells width:width height:height cellsPerTile:cellsPerTile obstacle:polyline closed:NO settings:&settings];
+	}
+	
+	HUMNavMesh *mesh = HUMNavMeshCreate(width, height, cells);
+	free(cells);
+	
+	if (!mesh) {
+		return nil;
+	}
+	
+	return [[HUMAStarPathfinderNavigationMesh alloc] initWithTileMapSize:settings.tileMapSize tileSize:settings.tileSize coordinateSystemOrigin:settings.coordinateSystemOrigin cellsPerTile:cellsPerTile meshNoCopy:mesh];
+}
+
+#pragma mark - Subgoal Graphs
+- (HUMAStarPathfinderSubgoalGraph *)subgoalGraph {
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	
+	if (settings.tileMapSize.width <= 0 || settings.tileMapSize.height <= 0) {
+		return nil;
+	}
+	
+	CGRect mapRect = CGRectMake(0, 0, settings.tileMapSize.width, settings.tileMapSize.height);
+	uint8_t *walkable = malloc((size_t)(mapRect.size.width * mapRect.size.height));
+	
+	if (!walkable) {
+		return nil;
+	}
+	
+	[self getWalkableFlags:walkable forTilesInRect:mapRect];
+	
+	HUMSearchNeighbors neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+	HUMSubgoalGraph *graph = HUMSubgoalGraphCreate(mapRect.size.width, mapRect.size.height, walkable, neighbors, (uint32_t)MIN(settings.baseMovementCost, (NSUInteger)UINT32_MAX));
+	free(walkable);
+	
+	if (!graph) {
+		return nil;
+	}
+	
+	return [[HUMAStarPathfinderSubgoalGraph alloc] initWithTileSize:settings.tileSize coordinateSystemOrigin:settings.coordinateSystemOrigin graphNoCopy:graph];
+}
+
+- (HUMAStarPathfinderSubgoalGraph *)subgoalGraphWithData:(NSData *)data error:(NSError **)error {
+	HUMSubgoalGraphStatus status = HUMSubgoalGraphStatusOK;
+	HUMSubgoalGraph *graph = HUMSubgoalGraphCreateWithData(data.bytes, data.length, &status);
+	HUMAStarPathfinderErrorCode code = HUMAStarPathfinderErrorSubgoalGraphInvalid;
+	NSString *description = @"The data isn't a subgoal graph, or is truncated.";
+	
+	if (graph) {
+		HUMAStarSearchSettings settings = [self currentSearchSettings];
+		HUMSearchNeighbors neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+		size_t tileCount = (size_t)graph->width * graph->height;
+		uint8_t *walkable = NULL;
+		BOOL current = (graph->width == settings.tileMapSize.width && graph->height == settings.tileMapSize.height &&
+						graph->neighbors == neighbors && graph->cardinalCost == settings.baseMovementCost);
+		
+		if (current) {
+			walkable = malloc(tileCount);
+			current = (walkable != NULL);
+		}
+		
+		if (current) {
+			[self getWalkableFlags:walkable forTilesInRect:CGRectMake(0, 0, graph->width, graph->height)];
+			
+			for (size_t i = 0; i < tileCount && current; i++) {
+				current = (walkable[i] != 0) == (graph->walkable[i] != 0);
+			}
+		}
+		
+		free(walkable);
+		
+		if (current) {
+			return [[HUMAStarPathfinderSubgoalGraph alloc] initWithTileSize:settings.tileSize coordinateSystemOrigin:settings.coordinateSystemOrigin graphNoCopy:graph];
+		}
+		
+		HUMSubgoalGraphFree(graph);
+		code = HUMAStarPathfinderErrorSubgoalGraphStale;
+		description = @"The subgoal graph was built from a different map or with different movement rules.";
+	}
+	else if (status == HUMSubgoalGraphStatusUnsupportedVersion) {
+		code = HUMAStarPathfinderErrorSubgoalGraphUnsupportedVersion;
+		description = @"The subgoal graph was serialized by an unsupported version of the format.";
+	}
+	else if (status == HUMSubgoalGraphStatusOutOfMemory) {
+		return nil;
+	}
+	
+	if (error) {
+		*error = [NSError errorWithDomain:HUMAStarPathfinderErrorDomain code:code userInfo:@{ NSLocalizedDescriptionKey : description }];
+	}
+	
+	return nil;
+}
+
+#pragma mark - Contraction Hierarchies
+- (HUMAStarPathfinderContractionHierarchy *)contractionHierarchy {
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	
+	if (settings.tileMapSize.width <= 0 || settings.tileMapSize.height <= 0) {
+		return nil;
+	}
+	
+	size_t tileCount = (size_t)(settings.tileMapSize.width * settings.tileMapSize.height);
+	uint8_t *walkable = malloc(tileCount);
+	uint32_t *costs = malloc(tileCount * sizeof(uint32_t));
+	
+	if (!walkable || !costs) {
+		free(walkable);
+		free(costs);
+		return nil;
+	}
+	
+	[self sampleWalkableFlags:walkable costs:costs settings:&settings];
+	
+	HUMContractionBuild build;
+	build.width = settings.tileMapSize.width;
+	build.height = settings.tileMapSize.height;
+	build.walkable = walkable;
+	build.costs = costs;
+	build.neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+	build.apply = HUMAStarPathfinderApply;
+	build.applyInfo = NULL;
+	
+	HUMContractionHierarchy *hierarchy = HUMContractionHierarchyCreate(&build);
+	free(walkable);
+	free(costs);
+	
+	if (!hierarchy) {
+		return nil;
+	}
+	
+	return [[HUMAStarPathfinderContractionHierarchy alloc] initWithTileSize:settings.tileSize coordinateSystemOrigin:settings.coordinateSystemOrigin hierarchyNoCopy:hierarchy];
+}
+
+- (HUMAStarPathfinderContractionHierarchy *)contractionHierarchyWithData:(NSData *)data error:(NSError **)error {
+	HUMContractionHierarchyStatus status = HUMContractionHierarchyStatusOK;
+	HUMContractionHierarchy *hierarchy = HUMContractionHierarchyCreateWithData(data.bytes, data.length, &status);
+	HUMAStarPathfinderErrorCode code = HUMAStarPathfinderErrorContractionHierarchyInvalid;
+	NSString *description = @"The data isn't a contraction hierarchy, or is truncated.";
+	
+	if (hierarchy) {
+		HUMAStarSearchSettings settings = [self currentSearchSettings];
+		HUMSearchNeighbors neighbors = HUMSearchNeighborsForRules(settings.pathDiagonally, settings.ignoreDiagonalBarriers, settings.pathCanCrossBorders);
+		size_t tileCount = (size_t)hierarchy->width * hierarchy->height;
+		uint8_t *walkable = NULL;
+		uint32_t *costs = NULL;
+		BOOL current = (hierarchy->width == settings.tileMapSize.width && hierarchy->height == settings.tileMapSize.height && hierarchy->neighbors == neighbors);
+		
+		if (current) {
+			walkable = malloc(tileCount);
+			costs = malloc(tileCount * sizeof(uint32_t));
+			current = (walkable && costs);
+		}
+		
+		// the costs of unwalkable tiles are never used, so only walkable tiles have to match
+		if (current) {
+			[self sampleWalkableFlags:walkable costs:costs settings:&settings];
+			
+			for (size_t i = 0; i < tileCount && current; i++) {
+				current = (walkable[i] != 0) == (hierarchy->walkable[i] != 0) && (!walkable[i] || costs[i] == hierarchy->costs[i]);
+			}
+		}
+		
+		free(walkable);
+		free(costs);
+		
+		if (current) {
+			return [[HUMAStarPathfinderContractionHierarchy alloc] initWithTileSize:settings.tileSize coordinateSystemOrigin:settings.coordinateSystemOrigin hierarchyNoCopy:hierarchy];
+		}
+		
+		HUMContractionHierarchyFree(hierarchy);
+		code = HUMAStarPathfinderErrorContractionHierarchyStale;
+		description = @"The contraction hierarchy was built from a different map, with different costs, or with different movement rules.";
+	}
+	else if (status == HUMContractionHierarchyStatusUnsupportedVersion) {
+		code = HUMAStarPathfinderErrorContractionHierarchyUnsupportedVersion;
+		description = @"The contraction hierarchy was serialized by an unsupported version of the format.";
+	}
+	else if (status == HUMContractionHierarchyStatusOutOfMemory) {
+		return nil;
+	}
+	
+	if (error) {
+		*error = [NSError errorWithDomain:HUMAStarPathfinderErrorDomain code:code userInfo:@{ NSLocalizedDescriptionKey : description }];
+	}
+	
+	return nil;
+}
+
+#pragma mark - Tile Helpers
+/**
+ *	Determines if a node is walkable. If a navigation file is loaded, the file will be used. If the map is paged, its chunks will be used. If the walkability of tiles is cached, the cache will be used. If a delegate is provided, the delegate will be asked. Otherwise, YES.
+ *
+ *	@param	location	The tile location in question.
+ *
+ *	@return	YES, if the tile can be traversed. NO, otherwise.
+ */
+- (BOOL)canWalkToNodeAtTileLocation:(CGPoint)location {
+	BOOL walkable = YES;
+	
+	if (_navigationData) {
+		walkable = HUMNavigationDataIsWalkable(_navigationData, location.x, location.y);
+	}
+	else if (_chunkCache) {
+		HUMChunkCursor chunkCursor;
+		HUMChunkCursorInit(&chunkCursor, _chunkCache);
+		walkable = HUMChunkCursorIsWalkable(&chunkCursor, location.x, location.y);
+		HUMChunkCursorFinish(&chunkCursor);
+	}
+	else if (_tileCache && _tileCache->walkable) {
+		walkable = HUMTileCacheIsWalkable(_tileCache, location.x, location.y);
+	}
+	else if (_delegateFlags.delegateCanWalkToNodeAtTileLocation) {
+		walkable = [self.delegate pathfinder:self canWalkToNodeAtTileLocation:location];
+	}
+	
+	return walkable;
+}
+
+- (CGPoint)tileLocationForPosition:(CGPoint)position {
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	return HUMAStarTileLocationForPosition(&settings, position);
+}
+
+- (CGPoint)positionForTileLocation:(CGPoint)tileLocation {
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	return HUMAStarPositionForTileLocation(&settings, tileLocation);
+}
+
+/**
+ *	The transform the batch conversions use, matching HUMAStarTileLocationForPosition and HUMAStarPositionForTileLocation.
+ */
+static HUMCoordinateTransform HUMAStarCoordinateTransform(const HUMAStarSearchSettings *settings) {
+	HUMCoordinateTransform transform;
+	transform.tileWidth = settings->tileSize.width;
+	transform.tileHeight = settings->tileSize.height;
+	transform.mapHeight = settings->tileMapSize.height * settings->tileSize.height;
+	transform.flipsY = (settings->coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft);
+	
+	return transform;
+}
+
+- (void)getPositions:(float *)positions forTileLocations:(const float *)tileLocations count:(NSUInteger)count {
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	HUMCoordinateTransform transform = HUMAStarCoordinateTransform(&settings);
+	HUMCoordinatesPositionsForTileLocations(&transform, tileLocations, positions, count);
+}
+
+- (void)getTileLocations:(float *)tileLocations forPositions:(const float *)positions count:(NSUInteger)count {
+	HUMAStarSearchSettings settings = [self currentSearchSettings];
+	HUMCoordinateTransform transform = HUMAStarCoordinateTransform(&settings);
+	HUMCoordinatesTileLocationsForPositions(&transform, positions, tileLocations, count);
 }
 
 @end
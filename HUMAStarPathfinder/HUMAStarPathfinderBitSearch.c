@@ -0,0 +1,545 @@
+//
+//  HUMAStarPathfinderBitSearch.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderBitSearch.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__x86_64__) && (defined(__clang__) || defined(__GNUC__))
+#include <immintrin.h>
+#define HUM_BIT_SEARCH_AVX2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+/**
+ *	The range of an empty row. Chosen so widening it by a word in either direction can't overflow.
+ */
+#define HUMBitSearchEmptyFirst (INT32_MAX - 1)
+#define HUMBitSearchEmptyLast (INT32_MIN + 1)
+
+#define HUM_ALWAYS_INLINE static inline __attribute__((always_inline))
+
+#pragma mark - Expansion Kernels
+/**
+ *	The rows a kernel reads and writes to expand one row of the current layer into the next.
+ */
+typedef struct {
+	const uint64_t *above;		// the current layer, one row up
+	const uint64_t *row;		// the current layer
+	const uint64_t *below;		// the current layer, one row down
+	const uint64_t *walkable;
+	uint64_t *visited;
+	uint64_t *next;
+	uint64_t *parity;			// the parity plane of the next layer's distance, or NULL if it is a multiple of 3
+} HUMBitSearchRow;
+
+/**
+ *	Computes words [first, last) of a row of the next layer: every walkable, unvisited tile next to a tile of the current layer. Marks them
+ *  visited and records their parity.
+ *
+ *	@return	The bitwise or of the words written, which is 0 if the row of the next layer is empty.
+ */
+typedef uint64_t (*HUMBitSearchExpandFunction)(const HUMBitSearchRow *row, int32_t first, int32_t last);
+
+/**
+ *	Expands words one at a time. Inlined into every kernel to finish the words left over after its vector loop, since most rows of a layer
+ *  only span a word or two.
+ */
+HUM_ALWAYS_INLINE uint64_t HUMBitSearchExpandWords(const HUMBitSearchRow *r, int32_t first, int32_t last) {
+	uint64_t any = 0;
+
+	for (int32_t w = first; w < last; w++) {
+		uint64_t layer = r->row[w];
+
+		// bit i is tile x = 64w + i, so shifting left moves the layer east and shifting right moves it west
+		uint64_t reached = r->above[w] | r->below[w] | (layer << 1) | (r->row[w - 1] >> 63) | (layer >> 1) | (r->row[w + 1] << 63);
+		uint64_t next = reached & r->walkable[w] & ~r->visited[w];
+
+		r->next[w] = next;
+		r->visited[w] |= next;
+		if (r->parity) {
+			r->parity[w] |= next;
+		}
+
+		any |= next;
+	}
+
+	return any;
+}
+
+static uint64_t HUMBitSearchExpandScalar(const HUMBitSearchRow *r, int32_t first, int32_t last) {
+	return HUMBitSearchExpandWords(r, first, last);
+}
+
+#if defined(__SSE2__)
+/**
+ *	Expands the two words at w.
+ */
+HUM_ALWAYS_INLINE __m128i HUMBitSearchExpandPair(const HUMBitSearchRow *r, int32_t w) {
+	__m128i layer = _mm_loadu_si128((const __m128i *)(r->row + w));
+	__m128i west = _mm_loadu_si128((const __m128i *)(r->row + w - 1));
+	__m128i east = _mm_loadu_si128((const __m128i *)(r->row + w + 1));
+
+	__m128i reached = _mm_or_si128(_mm_loadu_si128((const __m128i *)(r->above + w)), _mm_loadu_si128((const __m128i *)(r->below + w)));
+	reached = _mm_or_si128(reached, _mm_or_si128(_mm_slli_epi64(layer, 1), _mm_srli_epi64(west, 63)));
+	reached = _mm_or_si128(reached, _mm_or_si128(_mm_srli_epi64(layer, 1), _mm_slli_epi64(east, 63)));
+
+	__m128i visited = _mm_loadu_si128((const __m128i *)(r->visited + w));
+	__m128i next = _mm_andnot_si128(visited, _mm_and_si128(reached, _mm_loadu_si128((const __m128i *)(r->walkable + w))));
+
+	_mm_storeu_si128((__m128i *)(r->next + w), next);
+	_mm_storeu_si128((__m128i *)(r->visited + w), _mm_or_si128(visited, next));
+	if (r->parity) {
+		_mm_storeu_si128((__m128i *)(r->parity + w), _mm_or_si128(_mm_loadu_si128((const __m128i *)(r->parity + w)), next));
+	}
+
+	return next;
+}
+
+static uint64_t HUMBitSearchExpandSSE2(const HUMBitSearchRow *r, int32_t first, int32_t last) {
+	__m128i any = _mm_setzero_si128();
+	int32_t w = first;
+
+	for (; w + 2 <= last; w += 2) {
+		any = _mm_or_si128(any, HUMBitSearchExpandPair(r, w));
+	}
+
+	uint64_t lanes[2];
+	_mm_storeu_si128((__m128i *)lanes, any);
+
+	return lanes[0] | lanes[1] | HUMBitSearchExpandWords(r, w, last);
+}
+#endif
+
+#if HUM_BIT_SEARCH_AVX2
+__attribute__((target("avx2")))
+static uint64_t HUMBitSearchExpandAVX2(const HUMBitSearchRow *r, int32_t first, int32_t last) {
+	__m256i any = _mm256_setzero_si256();
+	int32_t w = first;
+
+	for (; w + 4 <= last; w += 4) {
+		__m256i layer = _mm256_loadu_si256((const __m256i *)(r->row + w));
+		__m256i west = _mm256_loadu_si256((const __m256i *)(r->row + w - 1));
+		__m256i east = _mm256_loadu_si256((const __m256i *)(r->row + w + 1));
+
+		__m256i reached = _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(r->above + w)), _mm256_loadu_si256((const __m256i *)(r->below + w)));
+		reached = _mm256_or_si256(reached, _mm256_or_si256(_mm256_slli_epi64(layer, 1), _mm256_srli_epi64(west, 63)));
+		reached = _mm256_or_si256(reached, _mm256_or_si256(_mm256_srli_epi64(layer, 1), _mm256_slli_epi64(east, 63)));
+
+		__m256i visited = _mm256_loadu_si256((const __m256i *)(r->visited + w));
+		__m256i next = _mm256_andnot_si256(visited, _mm256_and_si256(reached, _mm256_loadu_si256((const __m256i *)(r->walkable + w))));
+
+		_mm256_storeu_si256((__m256i *)(r->next + w), next);
+		_mm256_storeu_si256((__m256i *)(r->visited + w), _mm256_or_si256(visited, next));
+		if (r->parity) {
+			_mm256_storeu_si256((__m256i *)(r->parity + w), _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(r->parity + w)), next));
+		}
+
+		any = _mm256_or_si256(any, next);
+	}
+
+	__m128i anyPair = _mm_or_si128(_mm256_castsi256_si128(any), _mm256_extracti128_si256(any, 1));
+
+	if (w + 2 <= last) {
+		anyPair = _mm_or_si128(anyPair, HUMBitSearchExpandPair(r, w));
+		w += 2;
+	}
+
+	uint64_t lanes[2];
+	_mm_storeu_si128((__m128i *)lanes, anyPair);
+
+	return lanes[0] | lanes[1] | HUMBitSearchExpandWords(r, w, last);
+}
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+static uint64_t HUMBitSearchExpandNEON(const HUMBitSearchRow *r, int32_t first, int32_t last) {
+	uint64x2_t any = vdupq_n_u64(0);
+	int32_t w = first;
+
+	for (; w + 2 <= last; w += 2) {
+		uint64x2_t layer = vld1q_u64(r->row + w);
+		uint64x2_t west = vld1q_u64(r->row + w - 1);
+		uint64x2_t east = vld1q_u64(r->row + w + 1);
+
+		uint64x2_t reached = vorrq_u64(vld1q_u64(r->above + w), vld1q_u64(r->below + w));
+		reached = vorrq_u64(reached, vorrq_u64(vshlq_n_u64(layer, 1), vshrq_n_u64(west, 63)));
+		reached = vorrq_u64(reached, vorrq_u64(vshrq_n_u64(layer, 1), vshlq_n_u64(east, 63)));
+
+		uint64x2_t visited = vld1q_u64(r->visited + w);
+		uint64x2_t next = vbicq_u64(vandq_u64(reached, vld1q_u64(r->walkable + w)), visited);
+
+		vst1q_u64(r->next + w, next);
+		vst1q_u64(r->visited + w, vorrq_u64(visited, next));
+		if (r->parity) {
+			vst1q_u64(r->parity + w, vorrq_u64(vld1q_u64(r->parity + w), next));
+		}
+
+		any = vorrq_u64(any, next);
+	}
+
+	return vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1) | HUMBitSearchExpandWords(r, w, last);
+}
+#endif
+
+/**
+ *	The kernel for every instruction set, or NULL where it isn't compiled in for this architecture.
+ */
+static const HUMBitSearchExpandFunction HUMBitSearchExpandFunctions[HUMBitSearchInstructionSetCount] = {
+	HUMBitSearchExpandScalar,
+#if defined(__SSE2__)
+	HUMBitSearchExpandSSE2,
+#else
+	NULL,
+#endif
+#if HUM_BIT_SEARCH_AVX2
+	HUMBitSearchExpandAVX2,
+#else
+	NULL,
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	HUMBitSearchExpandNEON
+#else
+	NULL
+#endif
+};
+
+HUMBitSearchInstructionSet HUMBitSearchBestInstructionSet(void) {
+#if HUM_BIT_SEARCH_AVX2
+	// checks both the CPU and that the OS saves the AVX registers
+	if (__builtin_cpu_supports("avx2")) {
+		return HUMBitSearchInstructionSetAVX2;
+	}
+#endif
+
+#if defined(__SSE2__)
+	return HUMBitSearchInstructionSetSSE2;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	return HUMBitSearchInstructionSetNEON;
+#else
+	return HUMBitSearchInstructionSetScalar;
+#endif
+}
+
+#pragma mark - Context
+HUMBitSearchContext *HUMBitSearchContextCreate(int32_t width, int32_t height) {
+	HUMBitSearchContext *context = calloc(1, sizeof(HUMBitSearchContext));
+	if (!context) {
+		return NULL;
+	}
+
+	int32_t wordsPerRow = (width + 63) / 64;
+	size_t rows = (size_t)height + 2;
+
+	context->width = width;
+	context->height = height;
+	context->wordsPerRow = wordsPerRow;
+	context->stride = wordsPerRow + 2;
+	context->instructionSet = HUMBitSearchBestInstructionSet();
+	context->visitedMinRow = 1;
+	context->visitedMaxRow = 0;
+	context->distance = -1;
+
+	size_t words = rows * (size_t)context->stride;
+	context->walkable = calloc(words, sizeof(uint64_t));
+	context->visited = calloc(words, sizeof(uint64_t));
+	context->layer = calloc(words, sizeof(uint64_t));
+	context->nextLayer = calloc(words, sizeof(uint64_t));
+	context->parity[0] = calloc(words, sizeof(uint64_t));
+	context->parity[1] = calloc(words, sizeof(uint64_t));
+	context->layerFirst = malloc(rows * sizeof(int32_t));
+	context->layerLast = malloc(rows * sizeof(int32_t));
+	context->nextFirst = malloc(rows * sizeof(int32_t));
+	context->nextLast = malloc(rows * sizeof(int32_t));
+
+	if (!context->walkable || !context->visited || !context->layer || !context->nextLayer || !context->parity[0] || !context->parity[1] ||
+		!context->layerFirst || !context->layerLast || !context->nextFirst || !context->nextLast) {
+		HUMBitSearchContextFree(context);
+		return NULL;
+	}
+
+	for (size_t row = 0; row < rows; row++) {
+		context->layerFirst[row] = context->nextFirst[row] = HUMBitSearchEmptyFirst;
+		context->layerLast[row] = context->nextLast[row] = HUMBitSearchEmptyLast;
+	}
+
+	return context;
+}
+
+void HUMBitSearchContextFree(HUMBitSearchContext *context) {
+	if (!context) {
+		return;
+	}
+
+	free(context->walkable);
+	free(context->visited);
+	free(context->layer);
+	free(context->nextLayer);
+	free(context->parity[0]);
+	free(context->parity[1]);
+	free(context->layerFirst);
+	free(context->layerLast);
+	free(context->nextFirst);
+	free(context->nextLast);
+	free(context);
+}
+
+void HUMBitSearchLoadClearance(HUMBitSearchContext *context, const uint8_t *clearance, uint8_t minimumClearance) {
+	const int32_t width = context->width;
+
+	for (int32_t y = 0; y < context->height; y++) {
+		const uint8_t *source = clearance + (size_t)y * width;
+		uint64_t *words = context->walkable + (size_t)(y + 1) * context->stride + 1;
+		int32_t x = 0;
+
+#if defined(__SSE2__)
+		// a byte is at least the minimum if raising it to the minimum leaves it unchanged
+		const __m128i minimum = _mm_set1_epi8((char)minimumClearance);
+
+		for (; x + 64 <= width; x += 64) {
+			uint64_t word = 0;
+
+			for (int32_t chunk = 0; chunk < 4; chunk++) {
+				__m128i bytes = _mm_loadu_si128((const __m128i *)(source + x + chunk * 16));
+				uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(bytes, minimum), bytes));
+				word |= (uint64_t)mask << (chunk * 16);
+			}
+
+			words[x >> 6] = word;
+		}
+#endif
+
+		for (; x < width; x += 64) {
+			int32_t count = width - x < 64 ? width - x : 64;
+			uint64_t word = 0;
+
+			for (int32_t bit = 0; bit < count; bit++) {
+				word |= (uint64_t)(source[x + bit] >= minimumClearance) << bit;
+			}
+
+			words[x >> 6] = word;
+		}
+	}
+}
+
+#pragma mark - Search
+static inline bool HUMBitSearchTest(const HUMBitSearchContext *context, const uint64_t *bits, int32_t x, int32_t y) {
+	// x may be -1 or width, which land in the zero padding
+	int32_t column = x + 64;
+	return (bits[(size_t)(y + 1) * context->stride + (column >> 6)] >> (column & 63)) & 1;
+}
+
+/**
+ *	Zeroes the words of a layer buffer its row ranges say may be non-zero, and empties the ranges.
+ */
+static void HUMBitSearchClearLayer(HUMBitSearchContext *context, uint64_t *layer, int32_t *first, int32_t *last, int32_t minRow, int32_t maxRow) {
+	for (int32_t row = minRow; row <= maxRow; row++) {
+		if (first[row] < last[row]) {
+			memset(layer + (size_t)row * context->stride + first[row], 0, (size_t)(last[row] - first[row]) * sizeof(uint64_t));
+		}
+
+		first[row] = HUMBitSearchEmptyFirst;
+		last[row] = HUMBitSearchEmptyLast;
+	}
+}
+
+/**
+ *	Clears the state left behind by the last search. Only rows that tiles were visited in can hold any bits.
+ */
+static void HUMBitSearchReset(HUMBitSearchContext *context, int32_t minRow, int32_t maxRow) {
+	if (minRow > maxRow) {
+		return;
+	}
+
+	size_t offset = (size_t)minRow * context->stride;
+	size_t bytes = (size_t)(maxRow - minRow + 1) * context->stride * sizeof(uint64_t);
+
+	memset(context->visited + offset, 0, bytes);
+	memset(context->parity[0] + offset, 0, bytes);
+	memset(context->parity[1] + offset, 0, bytes);
+	HUMBitSearchClearLayer(context, context->layer, context->layerFirst, context->layerLast, minRow, maxRow);
+	HUMBitSearchClearLayer(context, context->nextLayer, context->nextFirst, context->nextLast, minRow, maxRow);
+}
+
+bool HUMBitSearchFindPath(HUMBitSearchContext *context, int32_t startX, int32_t startY, int32_t targetX, int32_t targetY) {
+	HUMBitSearchExpandFunction expand = HUMBitSearchExpandFunctions[context->instructionSet];
+	if (!expand) {
+		expand = HUMBitSearchExpandScalar;
+	}
+
+	const int32_t stride = context->stride;
+	const int32_t lastWord = context->wordsPerRow + 1;
+
+	HUMBitSearchReset(context, context->visitedMinRow, context->visitedMaxRow);
+
+	// rows and words below are padded indexes, so the tile row y is row y + 1
+	int32_t layerMin = startY + 1;
+	int32_t layerMax = startY + 1;
+	int32_t visitedMin = layerMin;
+	int32_t visitedMax = layerMax;
+
+	int32_t startWord = (startX >> 6) + 1;
+	size_t startIndex = (size_t)layerMin * stride + startWord;
+	context->layer[startIndex] = (uint64_t)1 << (startX & 63);
+	context->visited[startIndex] = context->layer[startIndex];
+	context->layerFirst[layerMin] = startWord;
+	context->layerLast[layerMin] = startWord + 1;
+
+	context->startX = startX;
+	context->startY = startY;
+	context->targetX = targetX;
+	context->targetY = targetY;
+	context->distance = 0;
+
+	bool found = (startX == targetX && startY == targetY);
+
+	while (!found && layerMin <= layerMax) {
+		context->distance++;
+
+		int32_t remainder = context->distance % 3;
+		uint64_t *parity = remainder == 0 ? NULL : context->parity[remainder - 1];
+
+		int32_t nextMin = INT32_MAX;
+		int32_t nextMax = INT32_MIN;
+		int32_t fromRow = layerMin - 1 < 1 ? 1 : layerMin - 1;
+		int32_t toRow = layerMax + 1 > context->height ? context->height : layerMax + 1;
+
+		for (int32_t row = fromRow; row <= toRow; row++) {
+			const int32_t *first = context->layerFirst;
+			const int32_t *last = context->layerLast;
+
+			// vertical moves stay within a word, horizontal moves can carry into the next word
+			int32_t from = first[row] - 1;
+			from = first[row - 1] < from ? first[row - 1] : from;
+			from = first[row + 1] < from ? first[row + 1] : from;
+			from = from < 1 ? 1 : from;
+
+			int32_t to = last[row] + 1;
+			to = last[row - 1] > to ? last[row - 1] : to;
+			to = last[row + 1] > to ? last[row + 1] : to;
+			to = to > lastWord ? lastWord : to;
+
+			if (from >= to) {
+				continue;
+			}
+
+			size_t offset = (size_t)row * stride;
+			HUMBitSearchRow rowState = {
+				context->layer + offset - stride, context->layer + offset, context->layer + offset + stride, context->walkable + offset,
+				context->visited + offset, context->nextLayer + offset, parity ? parity + offset : NULL
+			};
+
+			// the next layer is all zeroes before the row is written, so a row that stays empty is left with an empty range
+			if (!expand(&rowState, from, to)) {
+				continue;
+			}
+
+			// narrow the range to the words that are actually set, so it doesn't grow a word every layer
+			const uint64_t *next = context->nextLayer + offset;
+			int32_t firstSet = from;
+			int32_t lastSet = to;
+
+			while (!next[firstSet]) {
+				firstSet++;
+			}
+
+			while (!next[lastSet - 1]) {
+				lastSet--;
+			}
+
+			// words outside the narrowed range were written with zeroes, which don't need clearing
+			context->nextFirst[row] = firstSet;
+			context->nextLast[row] = lastSet;
+			nextMin = row < nextMin ? row : nextMin;
+			nextMax = row > nextMax ? row : nextMax;
+		}
+
+		// the current layer is spent. Clear it so it can hold the layer after next.
+		HUMBitSearchClearLayer(context, context->layer, context->layerFirst, context->layerLast, layerMin, layerMax);
+
+		uint64_t *layer = context->layer;
+		context->layer = context->nextLayer;
+		context->nextLayer = layer;
+
+		int32_t *first = context->layerFirst;
+		context->layerFirst = context->nextFirst;
+		context->nextFirst = first;
+
+		int32_t *last = context->layerLast;
+		context->layerLast = context->nextLast;
+		context->nextLast = last;
+
+		layerMin = nextMin;
+		layerMax = nextMax;
+		visitedMin = nextMin < visitedMin ? nextMin : visitedMin;
+		visitedMax = nextMax > visitedMax && nextMax != INT32_MIN ? nextMax : visitedMax;
+
+		found = HUMBitSearchTest(context, context->visited, targetX, targetY);
+	}
+
+	// the bits of this search are needed to copy the path, so they're cleared when the next search starts instead of now
+	context->visitedMinRow = visitedMin;
+	context->visitedMaxRow = visitedMax;
+	context->distance = found ? context->distance : -1;
+
+	return found;
+}
+
+int32_t HUMBitSearchCopyPath(const HUMBitSearchContext *context, int32_t *xs, int32_t *ys, int32_t capacity) {
+	if (context->distance < 0) {
+		return 0;
+	}
+
+	static const int32_t offsetX[4] = { 0, 1, 0, -1 };
+	static const int32_t offsetY[4] = { -1, 0, 1, 0 };
+
+	int32_t x = context->targetX;
+	int32_t y = context->targetY;
+
+	for (int32_t distance = context->distance; distance >= 0; distance--) {
+		if (distance < capacity) {
+			xs[distance] = x;
+			ys[distance] = y;
+		}
+
+		if (distance == 0) {
+			break;
+		}
+
+		// every visited neighbor is one move closer, equally far, or one move further from the start. The distance modulo 3 tells them apart.
+		int32_t remainder = (distance - 1) % 3;
+
+		for (int32_t direction = 0; direction < 4; direction++) {
+			int32_t neighborX = x + offsetX[direction];
+			int32_t neighborY = y + offsetY[direction];
+
+			if (neighborY < 0 || neighborY >= context->height || !HUMBitSearchTest(context, context->visited, neighborX, neighborY)) {
+				continue;
+			}
+
+			int32_t neighborRemainder = HUMBitSearchTest(context, context->parity[0], neighborX, neighborY) ? 1 : (HUMBitSearchTest(context, context->parity[1], neighborX, neighborY) ? 2 : 0);
+
+			if (neighborRemainder == remainder) {
+				x = neighborX;
+				y = neighborY;
+				break;
+			}
+		}
+	}
+
+	return context->distance + 1;
+}
@@ -0,0 +1,98 @@
+//
+//  HUMAStarPathfinderBitSearch.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderBitSearch_h
+#define HUMAStarPathfinder_HUMAStarPathfinderBitSearch_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ *	The instruction sets the expansion kernels are written for. HUMBitSearchBestInstructionSet picks the fastest one the CPU supports at
+ *  runtime, so a single binary runs everywhere.
+ */
+typedef enum {
+	HUMBitSearchInstructionSetScalar = 0,
+	HUMBitSearchInstructionSetSSE2,
+	HUMBitSearchInstructionSetAVX2,
+	HUMBitSearchInstructionSetNEON,
+	HUMBitSearchInstructionSetCount
+} HUMBitSearchInstructionSet;
+
+/**
+ *	A breadth-first search over a 4-connected grid where every move costs the same, run 64 tiles at a time. Walkability and the search state
+ *  are packed one bit per tile, and each layer of the search is the previous layer shifted one tile in every direction, masked by the
+ *  walkable tiles that haven't been visited yet. Only the words around the current layer are touched.
+ *
+ *	Every row is padded with a zero word on either side and the grid with a zero row above and below, so shifts never need bounds checks.
+ *  Tile (x, y) is bit x % 64 of word x / 64 + 1 of row y + 1.
+ */
+typedef struct {
+	int32_t width;
+	int32_t height;
+	int32_t wordsPerRow;	// the words covering a row of tiles, not counting padding
+	int32_t stride;			// the distance between rows in words, including padding
+
+	uint64_t *walkable;
+	uint64_t *visited;
+	uint64_t *layer;		// the tiles reached by the current layer
+	uint64_t *nextLayer;
+	uint64_t *parity[2];	// the distance of every visited tile modulo 3: 1 sets parity[0], 2 sets parity[1]
+
+	int32_t *layerFirst;	// per row, the first and one past the last word of layer that may be non-zero. Empty rows have first >= last.
+	int32_t *layerLast;
+	int32_t *nextFirst;
+	int32_t *nextLast;
+
+	HUMBitSearchInstructionSet instructionSet;
+
+	int32_t startX;
+	int32_t startY;
+	int32_t targetX;
+	int32_t targetY;
+	int32_t distance;		// the number of moves in the path found by the last search, or -1
+
+	int32_t visitedMinRow;	// the padded rows the last search visited tiles in, which are the only rows it left bits in
+	int32_t visitedMaxRow;
+} HUMBitSearchContext;
+
+/**
+ *	The fastest instruction set the expansion kernels support on this CPU.
+ */
+HUMBitSearchInstructionSet HUMBitSearchBestInstructionSet(void);
+
+/**
+ *	Creates a context for a map of a fixed size, using HUMBitSearchBestInstructionSet. Every tile starts out blocked.
+ */
+HUMBitSearchContext *HUMBitSearchContextCreate(int32_t width, int32_t height);
+void HUMBitSearchContextFree(HUMBitSearchContext *context);
+
+/**
+ *	Packs the walkability of every tile from a clearance map: a tile is walkable if its clearance is at least minimumClearance.
+ *
+ *	@param	clearance			width * height clearances, row-major.
+ *	@param	minimumClearance	The clearance a tile needs to be walkable. The unit size.
+ */
+void HUMBitSearchLoadClearance(HUMBitSearchContext *context, const uint8_t *clearance, uint8_t minimumClearance);
+
+/**
+ *	Runs a breadth-first search from the start to the target, which must lie within the map. The start doesn't need to be walkable.
+ *
+ *	@return	true if a path was found.
+ */
+bool HUMBitSearchFindPath(HUMBitSearchContext *context, int32_t startX, int32_t startY, int32_t targetX, int32_t targetY);
+
+/**
+ *	Copies the tiles of the path found by the last search into the buffers, from the start tile to the target tile. Ties between equally
+ *  short paths are broken the same way every time.
+ *
+ *	@return	The number of tiles in the path. If larger than capacity, only the first capacity tiles are copied.
+ */
+int32_t HUMBitSearchCopyPath(const HUMBitSearchContext *context, int32_t *xs, int32_t *ys, int32_t capacity);
+
+#endif
@@ -0,0 +1,1130 @@
+//
+//  HUMAStarPathfinderBoundedSearch.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderBoundedSearch.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// north, east, south, west, then the diagonals between them
+static const int32_t HUMBoundedSearchDirectionX[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+static const int32_t HUMBoundedSearchDirectionY[8] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+
+// the buckets of f iterative deepening counts the tiles it leaves out in, to pick the limit of the next iteration
+#define HUMBoundedSearchLimitBucketCount 64
+
+enum {
+	HUMBoundedSearchEntryInFringe = 1 << 0
+};
+
+/**
+ *	A tile the fringe has reached. The entries in the fringe are linked into a list.
+ */
+typedef struct {
+	int32_t tile;		// y * width + x
+	uint32_t g;
+	int32_t parent;		// the entry of the tile before this one on the cheapest path found to it, or -1
+	int32_t next;		// the next entry in the fringe
+	int32_t previous;	// the previous entry in the fringe
+	uint8_t flags;
+} HUMBoundedSearchEntry;
+
+/**
+ *	An open tile of the compact search. Closed tiles only keep the direction they were reached from, in the direction map.
+ */
+typedef struct {
+	int32_t tile;		// or the next free entry, once the tile is closed
+	uint32_t g;
+	float f;
+	int32_t heapIndex;
+	uint8_t direction;	// the direction the tile was reached in
+} HUMBoundedSearchOpenEntry;
+
+enum {
+	HUMBoundedSearchDirectionUnreached = 0,		// 1 to 8: closed, and reached in direction - 1
+	HUMBoundedSearchDirectionStart = 9,
+	HUMBoundedSearchDirectionOpen = 10
+};
+
+/**
+ *	A tile on the path iterative deepening is following, and how far through its moves the search is.
+ */
+typedef struct {
+	int32_t tile;
+	uint32_t g;
+	uint8_t next;		// the next direction to try
+	uint8_t moves;		// a bit for each direction the tile can be left in
+} HUMBoundedSearchFrame;
+
+/**
+ *	The cheapest cost iterative deepening has reached a tile at. The cache is only a hint: entries are replaced freely, and losing one only
+ *  means a tile may be followed again.
+ */
+typedef struct {
+	int32_t tile;		// or -1 for an empty place
+	uint32_t g;
+	int32_t iteration;	// the iteration the tile was last reached in
+} HUMBoundedSearchCacheEntry;
+
+typedef struct {
+	const HUMBoundedSearchQuery *query;
+	HUMBoundedSearchResult *result;
+	int32_t directionCount;
+
+	HUMBoundedSearchEntry *entries;
+	int32_t entryCapacity;
+	int32_t entryCount;
+
+	int32_t *slots;		// fringe: 2 * entryCapacity places holding the entry of each tile, or -1
+	int32_t slotShift;
+
+	int32_t fringe;		// the first entry in the fringe, or -1
+
+	uint8_t *directions;		// compact: four bits a tile, HUMBoundedSearchDirectionUnreached and the others
+	HUMBoundedSearchOpenEntry *open;
+	int32_t openCapacity;
+	int32_t freeOpen;			// the first free open entry, or -1
+	int32_t *openSlots;			// 2 * openCapacity places holding the open entry of each tile, or -1
+	int32_t openShift;
+	int32_t *heap;
+	int32_t heapCount;
+
+	HUMBoundedSearchFrame *path;		// iterative deepening: the path being followed, from the start tile
+	int32_t pathCapacity;
+	HUMBoundedSearchCacheEntry *cache;	// iterative deepening: HUMBoundedSearchBucketSize places per bucket
+	int32_t cacheCapacity;
+
+	uint64_t expansionLimit;
+	size_t bytes;		// scratch memory held right now
+} HUMBoundedSearch;
+
+#pragma mark - Memory
+static void HUMBoundedSearchHold(HUMBoundedSearch *search, size_t bytes) {
+	search->bytes = bytes;
+
+	if (bytes > search->result->peakBytes) {
+		search->result->peakBytes = bytes;
+	}
+}
+
+static inline size_t HUMBoundedSearchSlotBytes(int32_t entryCapacity) {
+	return 2 * (size_t)entryCapacity * sizeof(int32_t);
+}
+
+static inline size_t HUMBoundedSearchEntryBytes(int32_t entryCapacity) {
+	return (size_t)entryCapacity * sizeof(HUMBoundedSearchEntry);
+}
+
+static inline uint32_t HUMBoundedSearchHash(int32_t tile) {
+	return (uint32_t)tile * 2654435761u;
+}
+
+/**
+ *	Finds the place of a tile in the fringe's hash table.
+ *
+ *	@return	The place holding the tile, or the empty place it would go in.
+ */
+static uint32_t HUMBoundedSearchFindSlot(const HUMBoundedSearch *search, int32_t tile) {
+	uint32_t mask = (2 * (uint32_t)search->entryCapacity) - 1;
+	uint32_t slot = HUMBoundedSearchHash(tile) >> search->slotShift;
+
+	while (search->slots[slot] >= 0 && search->entries[search->slots[slot]].tile != tile) {
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+static bool HUMBoundedSearchAllocateSlots(HUMBoundedSearch *search) {
+	uint32_t slotCount = 2 * (uint32_t)search->entryCapacity;
+
+	search->slots = malloc(slotCount * sizeof(int32_t));
+	if (!search->slots) {
+		return false;
+	}
+
+	memset(search->slots, 0xff, slotCount * sizeof(int32_t));
+
+	search->slotShift = 32;
+	while ((1u << (32 - search->slotShift)) < slotCount) {
+		search->slotShift--;
+	}
+
+	for (int32_t i = 0; i < search->entryCount; i++) {
+		search->slots[HUMBoundedSearchFindSlot(search, search->entries[i].tile)] = i;
+	}
+
+	HUMBoundedSearchHold(search, search->bytes + slotCount * sizeof(int32_t));
+	return true;
+}
+
+/**
+ *	Doubles the fringe's table, as long as both the old and new entries fit within the memory limit while they're copied.
+ *
+ *	@return	false if the table couldn't grow, in which case the entries are left as they were but the slots may be gone.
+ */
+static bool HUMBoundedSearchGrow(HUMBoundedSearch *search) {
+	const size_t limit = search->query->memoryLimit;
+	int32_t capacity = search->entryCapacity;
+
+	if (capacity > INT32_MAX / 4) {
+		return false;
+	}
+
+	size_t entryBytes = HUMBoundedSearchEntryBytes(capacity);
+	size_t grownEntryBytes = HUMBoundedSearchEntryBytes(2 * capacity);
+
+	if (entryBytes + grownEntryBytes > limit || grownEntryBytes + HUMBoundedSearchSlotBytes(2 * capacity) > limit) {
+		return false;
+	}
+
+	// the slots are rebuilt from the entries, so they don't have to be held while the entries are copied
+	free(search->slots);
+	search->slots = NULL;
+	HUMBoundedSearchHold(search, entryBytes + grownEntryBytes);
+
+	HUMBoundedSearchEntry *entries = realloc(search->entries, grownEntryBytes);
+	if (!entries) {
+		HUMBoundedSearchHold(search, entryBytes);
+		return false;
+	}
+
+	search->entries = entries;
+	search->entryCapacity = 2 * capacity;
+	HUMBoundedSearchHold(search, grownEntryBytes);
+
+	return HUMBoundedSearchAllocateSlots(search);
+}
+
+#pragma mark - Moves
+static inline float HUMBoundedSearchEstimate(HUMSearchHeuristic heuristic, int32_t x, int32_t y, int32_t targetX, int32_t targetY) {
+	int32_t distanceX = abs(x - targetX);
+	int32_t distanceY = abs(y - targetY);
+
+	switch (heuristic) {
+		case HUMSearchHeuristicEuclidian:
+			return sqrtf((float)(distanceX * distanceX + distanceY * distanceY));
+
+		case HUMSearchHeuristicChebyshev:
+			return (float)(distanceX > distanceY ? distanceX : distanceY);
+
+		case HUMSearchHeuristicNone:
+			return 0.0f;
+
+		case HUMSearchHeuristicManhattan:
+		default:
+			return (float)(distanceX + distanceY);
+	}
+}
+
+static inline double HUMBoundedSearchF(const HUMBoundedSearch *search, int32_t tile, uint32_t g) {
+	const HUMBoundedSearchQuery *query = search->query;
+	return g + (double)HUMBoundedSearchEstimate(query->heuristic, tile % query->width, tile / query->width, query->targetX, query->targetY);
+}
+
+static bool HUMBoundedSearchSample(const HUMBoundedSearch *search, int32_t x, int32_t y, uint32_t *cost) {
+	const HUMBoundedSearchQuery *query = search->query;
+
+	if (x < 0 || y < 0 || x >= query->width || y >= query->height) {
+		return false;
+	}
+
+	bool walkable = false;
+	*cost = 0;
+	query->sample(query->info, x, y, &walkable, cost);
+
+	return walkable;
+}
+
+/**
+ *	Finds the moves out of a tile, with the same corner rules as HUMSearchFindPath.
+ *
+ *	@param	costs	Set to the cost of each move, if provided.
+ *
+ *	@return	A bit for each direction that can be moved in.
+ */
+static uint8_t HUMBoundedSearchMoves(const HUMBoundedSearch *search, int32_t tile, uint32_t *costs) {
+	const HUMSearchNeighbors neighbors = search->query->neighbors;
+	int32_t x = tile % search->query->width;
+	int32_t y = tile / search->query->width;
+	uint8_t moves = 0;
+	uint32_t cost = 0;
+
+	for (int32_t direction = 0; direction < 4; direction++) {
+		if (HUMBoundedSearchSample(search, x + HUMBoundedSearchDirectionX[direction], y + HUMBoundedSearchDirectionY[direction], &cost)) {
+			moves |= (uint8_t)(1 << direction);
+			if (costs) {
+				costs[direction] = cost;
+			}
+		}
+	}
+
+	if (neighbors == HUMSearchNeighborsCardinal) {
+		return moves;
+	}
+
+	for (int32_t direction = 4; direction < 8; direction++) {
+		// the cardinal directions on either side of a diagonal: north and south for y, east and west for x
+		bool verticalOpen = moves & (1 << (HUMBoundedSearchDirectionY[direction] < 0 ? 0 : 2));
+		bool horizontalOpen = moves & (1 << (HUMBoundedSearchDirectionX[direction] > 0 ? 1 : 3));
+
+		if (neighbors == HUMSearchNeighborsDiagonalCrossBorders && !verticalOpen && !horizontalOpen) {
+			continue;
+		}
+
+		if (neighbors == HUMSearchNeighborsDiagonalStrict && !(verticalOpen && horizontalOpen)) {
+			continue;
+		}
+
+		if (HUMBoundedSearchSample(search, x + HUMBoundedSearchDirectionX[direction], y + HUMBoundedSearchDirectionY[direction], &cost)) {
+			moves |= (uint8_t)(1 << direction);
+			if (costs) {
+				costs[direction] = HUMSearchDiagonalCost(cost);
+			}
+		}
+	}
+
+	return moves;
+}
+
+static inline int32_t HUMBoundedSearchNeighbor(const HUMBoundedSearch *search, int32_t tile, int32_t direction) {
+	return tile + HUMBoundedSearchDirectionY[direction] * search->query->width + HUMBoundedSearchDirectionX[direction];
+}
+
+#pragma mark - Fringe
+static void HUMBoundedSearchUnlink(HUMBoundedSearch *search, int32_t index) {
+	HUMBoundedSearchEntry *entry = &search->entries[index];
+
+	if (entry->previous >= 0) {
+		search->entries[entry->previous].next = entry->next;
+	}
+	else {
+		search->fringe = entry->next;
+	}
+
+	if (entry->next >= 0) {
+		search->entries[entry->next].previous = entry->previous;
+	}
+
+	entry->flags &= (uint8_t)~HUMBoundedSearchEntryInFringe;
+}
+
+static void HUMBoundedSearchLinkAfter(HUMBoundedSearch *search, int32_t index, int32_t after) {
+	HUMBoundedSearchEntry *entry = &search->entries[index];
+	HUMBoundedSearchEntry *afterEntry = &search->entries[after];
+
+	entry->previous = after;
+	entry->next = afterEntry->next;
+
+	if (afterEntry->next >= 0) {
+		search->entries[afterEntry->next].previous = index;
+	}
+
+	afterEntry->next = index;
+	entry->flags |= HUMBoundedSearchEntryInFringe;
+}
+
+/**
+ *	Adds an entry for a tile the fringe hasn't reached before, growing the table if it's full.
+ *
+ *	@return	The entry, or -1 if the table is full and can't grow within the memory limit.
+ */
+static int32_t HUMBoundedSearchAdd(HUMBoundedSearch *search, int32_t tile) {
+	if (search->entryCount == search->entryCapacity && !HUMBoundedSearchGrow(search)) {
+		return -1;
+	}
+
+	int32_t index = search->entryCount++;
+	search->slots[HUMBoundedSearchFindSlot(search, tile)] = index;
+
+	HUMBoundedSearchEntry *entry = &search->entries[index];
+	entry->tile = tile;
+	entry->g = UINT32_MAX;
+	entry->parent = -1;
+	entry->next = -1;
+	entry->previous = -1;
+	entry->flags = 0;
+
+	return index;
+}
+
+/**
+ *	Runs the fringe search. Each pass walks the fringe from the front, expanding every tile whose f is within the limit and skipping the rest,
+ *  and a tile's children are put right after it so they're visited in the same pass. The next pass raises the limit to the smallest f that
+ *  was skipped.
+ *
+ *	@param	limit	Set to the f limit of the pass the search stopped in.
+ *
+ *	@return	The target's entry, -1 if there is no path, -2 if the fringe outgrew the memory limit, or -3 if the search reached its expansion limit.
+ */
+static int32_t HUMBoundedSearchRunFringe(HUMBoundedSearch *search, double *limit) {
+	const HUMBoundedSearchQuery *query = search->query;
+	const int32_t target = query->targetY * query->width + query->targetX;
+	const int32_t start = query->startY * query->width + query->startX;
+
+	int32_t startEntry = HUMBoundedSearchAdd(search, start);
+	search->entries[startEntry].g = 0;
+	search->entries[startEntry].flags = HUMBoundedSearchEntryInFringe;
+	search->fringe = startEntry;
+
+	*limit = HUMBoundedSearchF(search, start, 0);
+
+	while (search->fringe >= 0) {
+		double nextLimit = INFINITY;
+		int32_t index = search->fringe;
+
+		while (index >= 0) {
+			int32_t tile = search->entries[index].tile;
+			uint32_t g = search->entries[index].g;
+			double f = HUMBoundedSearchF(search, tile, g);
+
+			if (f > *limit) {
+				nextLimit = f < nextLimit ? f : nextLimit;
+				index = search->entries[index].next;
+				continue;
+			}
+
+			if (tile == target) {
+				return index;
+			}
+
+			if (search->result->expandedCount == search->expansionLimit) {
+				return -3;
+			}
+
+			search->result->expandedCount++;
+
+			uint32_t costs[8];
+			uint8_t moves = HUMBoundedSearchMoves(search, tile, costs);
+
+			for (int32_t direction = 0; direction < search->directionCount; direction++) {
+				if (!(moves & (1 << direction))) {
+					continue;
+				}
+
+				int32_t neighbor = HUMBoundedSearchNeighbor(search, tile, direction);
+				uint32_t neighborG = g + costs[direction];
+				int32_t neighborIndex = search->slots[HUMBoundedSearchFindSlot(search, neighbor)];
+
+				if (neighborIndex >= 0) {
+					if (neighborG >= search->entries[neighborIndex].g) {
+						continue;
+					}
+
+					if (search->entries[neighborIndex].flags & HUMBoundedSearchEntryInFringe) {
+						HUMBoundedSearchUnlink(search, neighborIndex);
+					}
+				}
+				else {
+					neighborIndex = HUMBoundedSearchAdd(search, neighbor);
+					if (neighborIndex < 0) {
+						return -2;
+					}
+				}
+
+				search->entries[neighborIndex].g = neighborG;
+				search->entries[neighborIndex].parent = index;
+				HUMBoundedSearchLinkAfter(search, neighborIndex, index);
+			}
+
+			int32_t next = search->entries[index].next;
+			HUMBoundedSearchUnlink(search, index);
+			index = next;
+		}
+
+		if (nextLimit == INFINITY) {
+			break;
+		}
+
+		*limit = nextLimit;
+		search->result->iterationCount++;
+	}
+
+	return -1;
+}
+
+#pragma mark - Compact
+static inline uint8_t HUMBoundedSearchDirection(const HUMBoundedSearch *search, int32_t tile) {
+	return (search->directions[tile >> 1] >> ((tile & 1) << 2)) & 0xf;
+}
+
+static inline void HUMBoundedSearchSetDirection(HUMBoundedSearch *search, int32_t tile, uint8_t direction) {
+	int32_t shift = (tile & 1) << 2;
+	search->directions[tile >> 1] = (uint8_t)((search->directions[tile >> 1] & ~(0xf << shift)) | (direction << shift));
+}
+
+/**
+ *	Finds the place of an open tile in the compact search's hash table.
+ *
+ *	@return	The place holding the tile, or the empty place it would go in.
+ */
+static uint32_t HUMBoundedSearchFindOpenSlot(const HUMBoundedSearch *search, int32_t tile) {
+	uint32_t mask = (2 * (uint32_t)search->openCapacity) - 1;
+	uint32_t slot = HUMBoundedSearchHash(tile) >> search->openShift;
+
+	while (search->openSlots[slot] >= 0 && search->open[search->openSlots[slot]].tile != tile) {
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+/**
+ *	Empties the place of a tile that was closed, moving up the tiles after it that were put further from their own place.
+ */
+static void HUMBoundedSearchRemoveOpenSlot(HUMBoundedSearch *search, uint32_t slot) {
+	uint32_t mask = (2 * (uint32_t)search->openCapacity) - 1;
+	uint32_t next = slot;
+
+	while (true) {
+		search->openSlots[slot] = -1;
+
+		do {
+			next = (next + 1) & mask;
+
+			if (search->openSlots[next] < 0) {
+				return;
+			}
+		} while (((next - (HUMBoundedSearchHash(search->open[search->openSlots[next]].tile) >> search->openShift)) & mask) < ((next - slot) & mask));
+
+		search->openSlots[slot] = search->openSlots[next];
+		slot = next;
+	}
+}
+
+static inline bool HUMBoundedSearchHeapLess(const HUMBoundedSearch *search, int32_t a, int32_t b) {
+	const HUMBoundedSearchOpenEntry *entryA = &search->open[a];
+	const HUMBoundedSearchOpenEntry *entryB = &search->open[b];
+
+	// among equal f, the tile furthest along is closer to the target
+	return entryA->f < entryB->f || (entryA->f == entryB->f && entryA->g > entryB->g);
+}
+
+static void HUMBoundedSearchHeapSet(HUMBoundedSearch *search, int32_t index, int32_t entry) {
+	search->heap[index] = entry;
+	search->open[entry].heapIndex = index;
+}
+
+static void HUMBoundedSearchHeapUp(HUMBoundedSearch *search, int32_t index) {
+	int32_t entry = search->heap[index];
+
+	while (index > 0) {
+		int32_t parent = (index - 1) / 2;
+
+		if (!HUMBoundedSearchHeapLess(search, entry, search->heap[parent])) {
+			break;
+		}
+
+		HUMBoundedSearchHeapSet(search, index, search->heap[parent]);
+		index = parent;
+	}
+
+	HUMBoundedSearchHeapSet(search, index, entry);
+}
+
+static int32_t HUMBoundedSearchHeapPop(HUMBoundedSearch *search) {
+	int32_t top = search->heap[0];
+	int32_t entry = search->heap[--search->heapCount];
+	int32_t index = 0;
+
+	while (search->heapCount > 0) {
+		int32_t child = 2 * index + 1;
+
+		if (child >= search->heapCount) {
+			break;
+		}
+
+		if (child + 1 < search->heapCount && HUMBoundedSearchHeapLess(search, search->heap[child + 1], search->heap[child])) {
+			child++;
+		}
+
+		if (!HUMBoundedSearchHeapLess(search, search->heap[child], entry)) {
+			break;
+		}
+
+		HUMBoundedSearchHeapSet(search, index, search->heap[child]);
+		index = child;
+	}
+
+	if (search->heapCount > 0) {
+		HUMBoundedSearchHeapSet(search, index, entry);
+	}
+
+	return top;
+}
+
+/**
+ *	Replaces the fringe's table with the direction map of the compact search, and gives the rest of the memory limit to its open tiles.
+ *
+ *	@return	false if the direction map leaves no room for HUMBoundedSearchMinimumTileCount open tiles.
+ */
+static bool HUMBoundedSearchAllocateCompact(HUMBoundedSearch *search) {
+	const HUMBoundedSearchQuery *query = search->query;
+	const size_t directionBytes = ((size_t)query->width * (size_t)query->height + 1) / 2;
+	const size_t openBytes = sizeof(HUMBoundedSearchOpenEntry) + 3 * sizeof(int32_t);	// an entry, two places, and a place in the heap
+
+	free(search->entries);
+	free(search->slots);
+	search->entries = NULL;
+	search->slots = NULL;
+	HUMBoundedSearchHold(search, 0);
+
+	if (directionBytes + HUMBoundedSearchMinimumTileCount * openBytes > query->memoryLimit) {
+		return false;
+	}
+
+	// a power of two, for the hash table
+	int32_t capacity = HUMBoundedSearchMinimumTileCount;
+	while (capacity < INT32_MAX / 4 && directionBytes + 2 * (size_t)capacity * openBytes <= query->memoryLimit) {
+		capacity *= 2;
+	}
+
+	search->directions = calloc(directionBytes, 1);
+	search->open = malloc((size_t)capacity * sizeof(HUMBoundedSearchOpenEntry));
+	search->openSlots = malloc(2 * (size_t)capacity * sizeof(int32_t));
+	search->heap = malloc((size_t)capacity * sizeof(int32_t));
+
+	if (!search->directions || !search->open || !search->openSlots || !search->heap) {
+		return false;
+	}
+
+	search->openCapacity = capacity;
+	search->openShift = 32;
+	while ((1u << (32 - search->openShift)) < 2 * (uint32_t)capacity) {
+		search->openShift--;
+	}
+
+	memset(search->openSlots, 0xff, 2 * (size_t)capacity * sizeof(int32_t));
+
+	for (int32_t i = 0; i < capacity; i++) {
+		search->open[i].tile = i + 1 < capacity ? i + 1 : -1;
+	}
+
+	search->freeOpen = 0;
+	search->heapCount = 0;
+	HUMBoundedSearchHold(search, directionBytes + (size_t)capacity * openBytes);
+
+	return true;
+}
+
+static void HUMBoundedSearchFreeCompact(HUMBoundedSearch *search) {
+	free(search->directions);
+	free(search->open);
+	free(search->openSlots);
+	free(search->heap);
+	search->directions = NULL;
+	search->open = NULL;
+	search->openSlots = NULL;
+	search->heap = NULL;
+}
+
+/**
+ *	Opens a tile, or lowers its cost if it's already open and the new one is lower.
+ *
+ *	@return	false if there is no room left for another open tile.
+ */
+static bool HUMBoundedSearchOpen(HUMBoundedSearch *search, int32_t tile, uint32_t g, uint8_t direction) {
+	uint32_t slot = HUMBoundedSearchFindOpenSlot(search, tile);
+	int32_t index = search->openSlots[slot];
+
+	if (index >= 0) {
+		if (g >= search->open[index].g) {
+			return true;
+		}
+	}
+	else {
+		if (search->freeOpen < 0) {
+			return false;
+		}
+
+		index = search->freeOpen;
+		search->freeOpen = search->open[index].tile;
+		search->openSlots[slot] = index;
+		search->open[index].tile = tile;
+		HUMBoundedSearchHeapSet(search, search->heapCount++, index);
+		HUMBoundedSearchSetDirection(search, tile, HUMBoundedSearchDirectionOpen);
+	}
+
+	search->open[index].g = g;
+	search->open[index].f = (float)HUMBoundedSearchF(search, tile, g);
+	search->open[index].direction = direction;
+	HUMBoundedSearchHeapUp(search, search->open[index].heapIndex);
+
+	return true;
+}
+
+/**
+ *	Runs A* with the same rules as HUMSearchFindPath, but keeping the open tiles in a hash table and nothing for a closed tile except the
+ *  direction it was reached in. On an open map, the open tiles are only the edge of the area searched, so this fits maps whose tiles far
+ *  outnumber what the fringe could hold.
+ *
+ *	@param	limit	Raised to the f of the open tile the search stopped at, if it ran out of room.
+ *
+ *	@return	The target tile, -1 if there is no path, -2 if the open tiles outgrew the memory limit, or -3 if the search reached its expansion limit.
+ */
+static int32_t HUMBoundedSearchRunCompact(HUMBoundedSearch *search, double *limit) {
+	const HUMBoundedSearchQuery *query = search->query;
+	const int32_t target = query->targetY * query->width + query->targetX;
+	const int32_t start = query->startY * query->width + query->startX;
+
+	HUMBoundedSearchOpen(search, start, 0, 0);
+
+	while (search->heapCount > 0) {
+		int32_t index = HUMBoundedSearchHeapPop(search);
+		HUMBoundedSearchOpenEntry entry = search->open[index];
+
+		HUMBoundedSearchRemoveOpenSlot(search, HUMBoundedSearchFindOpenSlot(search, entry.tile));
+		search->open[index].tile = search->freeOpen;
+		search->freeOpen = index;
+		HUMBoundedSearchSetDirection(search, entry.tile, entry.tile == start ? HUMBoundedSearchDirectionStart : (uint8_t)(entry.direction + 1));
+
+		if (entry.tile == target) {
+			search->result->cost = entry.g;
+			return target;
+		}
+
+		if (search->result->expandedCount == search->expansionLimit) {
+			return -3;
+		}
+
+		search->result->expandedCount++;
+
+		uint32_t costs[8];
+		uint8_t moves = HUMBoundedSearchMoves(search, entry.tile, costs);
+
+		for (int32_t direction = 0; direction < search->directionCount; direction++) {
+			if (!(moves & (1 << direction))) {
+				continue;
+			}
+
+			int32_t neighbor = HUMBoundedSearchNeighbor(search, entry.tile, direction);
+			uint8_t state = HUMBoundedSearchDirection(search, neighbor);
+
+			if (state != HUMBoundedSearchDirectionUnreached && state != HUMBoundedSearchDirectionOpen) {
+				continue;
+			}
+
+			if (!HUMBoundedSearchOpen(search, neighbor, entry.g + costs[direction], (uint8_t)direction)) {
+				*limit = entry.f > *limit ? entry.f : *limit;
+				return -2;
+			}
+		}
+	}
+
+	return -1;
+}
+
+#pragma mark - Iterative Deepening
+static bool HUMBoundedSearchAllocatePath(HUMBoundedSearchResult *result, int32_t count) {
+	result->xs = malloc((size_t)count * sizeof(int32_t));
+	result->ys = malloc((size_t)count * sizeof(int32_t));
+	result->count = count;
+
+	return result->xs && result->ys;
+}
+
+/**
+ *	Looks a tile up in the cache. A tile that isn't cached replaces an entry of its bucket from an earlier iteration, or else the one reached at
+ *  the highest cost, if that cost is higher than its own. Tiles reached cheaply are kept, since they lead to the most tiles.
+ *
+ *	@param	g	The cost the tile was reached at.
+ *	@param	added	Set to true if the tile wasn't in the cache.
+ *
+ *	@return	The tile's entry, which is new if added was set, or NULL if the tile wasn't cached.
+ */
+static HUMBoundedSearchCacheEntry *HUMBoundedSearchCacheEntryForTile(HUMBoundedSearch *search, int32_t tile, uint32_t g, int32_t iteration, bool *added) {
+	int32_t bucketCount = search->cacheCapacity / HUMBoundedSearchBucketSize;
+	HUMBoundedSearchCacheEntry *bucket = &search->cache[(HUMBoundedSearchHash(tile) % (uint32_t)bucketCount) * HUMBoundedSearchBucketSize];
+	HUMBoundedSearchCacheEntry *replaced = &bucket[0];
+
+	for (int32_t i = 0; i < HUMBoundedSearchBucketSize; i++) {
+		if (bucket[i].tile == tile) {
+			*added = false;
+			return &bucket[i];
+		}
+
+		if (bucket[i].iteration < replaced->iteration || (bucket[i].iteration == replaced->iteration && bucket[i].g > replaced->g)) {
+			replaced = &bucket[i];
+		}
+	}
+
+	*added = true;
+
+	if (replaced->iteration == iteration && replaced->g <= g) {
+		return NULL;
+	}
+
+	replaced->tile = tile;
+
+	return replaced;
+}
+
+/**
+ *	Replaces the fringe's table with the path stack and the cache of iterative deepening, splitting the memory limit between them. The path
+ *  gets a quarter, but never more places than there are tiles, and the cache gets the rest.
+ *
+ *	@return	false if the memory limit can't hold both.
+ */
+static bool HUMBoundedSearchAllocateIterativeDeepening(HUMBoundedSearch *search) {
+	const HUMBoundedSearchQuery *query = search->query;
+	const size_t limit = query->memoryLimit;
+
+	free(search->entries);
+	free(search->slots);
+	search->entries = NULL;
+	search->slots = NULL;
+	HUMBoundedSearchFreeCompact(search);
+	HUMBoundedSearchHold(search, 0);
+
+	size_t tileCount = (size_t)query->width * (size_t)query->height;
+	size_t pathCapacity = limit / 4 / sizeof(HUMBoundedSearchFrame);
+	pathCapacity = pathCapacity < tileCount ? pathCapacity : tileCount;
+	pathCapacity = pathCapacity < INT32_MAX ? pathCapacity : INT32_MAX;
+
+	size_t pathBytes = pathCapacity * sizeof(HUMBoundedSearchFrame);
+	size_t cacheCapacity = (limit - pathBytes) / sizeof(HUMBoundedSearchCacheEntry) / HUMBoundedSearchBucketSize * HUMBoundedSearchBucketSize;
+	cacheCapacity = cacheCapacity < INT32_MAX / 2 ? cacheCapacity : INT32_MAX / 2;
+
+	if (cacheCapacity < HUMBoundedSearchBucketSize) {
+		return false;
+	}
+
+	search->path = malloc(pathBytes);
+	search->cache = malloc(cacheCapacity * sizeof(HUMBoundedSearchCacheEntry));
+
+	if (!search->path || !search->cache) {
+		return false;
+	}
+
+	search->pathCapacity = (int32_t)pathCapacity;
+	search->cacheCapacity = (int32_t)cacheCapacity;
+	HUMBoundedSearchHold(search, pathBytes + cacheCapacity * sizeof(HUMBoundedSearchCacheEntry));
+
+	for (int32_t i = 0; i < search->cacheCapacity; i++) {
+		search->cache[i].tile = -1;
+		search->cache[i].g = 0;
+		search->cache[i].iteration = 0;
+	}
+
+	return true;
+}
+
+/**
+ *	Picks the f limit of the next iteration from the f of the tiles the last one left out, so that it expands about twice as many tiles.
+ *  Raising the limit only to the smallest f left out would take an iteration for nearly every cost the paths can have, since the heuristic
+ *  counts tiles while moves cost baseMovementCost.
+ *
+ *	@param	counts	The tiles left out by the bucket of their f. Bucket i holds f up to limit + (i + 1) * width, and the last one everything over.
+ *	@param	expandedCount	The tiles the last iteration expanded.
+ */
+static double HUMBoundedSearchNextLimit(const uint32_t *counts, double limit, double width, double smallestF, double largestF, uint64_t expandedCount) {
+	uint64_t count = 0;
+
+	for (int32_t i = 0; i < HUMBoundedSearchLimitBucketCount - 1; i++) {
+		count += counts[i];
+
+		if (count >= expandedCount) {
+			double nextLimit = limit + (i + 1) * width;
+			return nextLimit < smallestF ? smallestF : nextLimit;
+		}
+	}
+
+	return largestF;
+}
+
+/**
+ *	Stores the path on the stack as the result, replacing any path stored before.
+ */
+static bool HUMBoundedSearchCopyPathStack(HUMBoundedSearch *search, int32_t count, HUMBoundedSearchResult *result) {
+	const int32_t width = search->query->width;
+
+	HUMBoundedSearchResultFree(result);
+
+	if (!HUMBoundedSearchAllocatePath(result, count)) {
+		return false;
+	}
+
+	result->cost = search->path[count - 1].g;
+
+	for (int32_t i = 0; i < count; i++) {
+		result->xs[i] = search->path[i].tile % width;
+		result->ys[i] = search->path[i].tile / width;
+	}
+
+	return true;
+}
+
+/**
+ *	Runs iterative deepening A* from the start, beginning with an f limit no search has found the target within yet. Each iteration follows
+ *  every path whose f stays within the limit depth first, keeping only that path, and the next raises the limit so it expands about twice as
+ *  many tiles. Since that can raise the limit past the cost of the cheapest path, reaching the target stores the path and lowers the limit
+ *  below its cost for the rest of the iteration, which then only finds cheaper paths.
+ *
+ *	A tile reached again at a cost no lower than the one the cache holds for it isn't followed again, which also keeps paths from looping,
+ *  unless the tile isn't cached. A path that outgrows its stack isn't followed further.
+ *
+ *	@return	0 if the path was stored in the result, -1 if there is no path, -2 if the path to the target didn't fit, or -3 if the search reached
+ *			its expansion limit.
+ */
+static int32_t HUMBoundedSearchRunIterativeDeepening(HUMBoundedSearch *search, double limit) {
+	const HUMBoundedSearchQuery *query = search->query;
+	const int32_t target = query->targetY * query->width + query->targetX;
+	const int32_t start = query->startY * query->width + query->startX;
+	HUMBoundedSearchFrame *path = search->path;
+	HUMBoundedSearchResult *result = search->result;
+
+	result->iterativeDeepening = true;
+
+	for (int32_t iteration = 1; ; iteration++) {
+		uint32_t counts[HUMBoundedSearchLimitBucketCount] = { 0 };
+		const double width = limit / 256 > 1 ? limit / 256 : 1;
+		const uint64_t expandedCount = result->expandedCount;
+		double smallestF = INFINITY;
+		double largestF = 0;
+		bool found = false;
+		bool overflowed = false;
+		bool added = false;
+
+		HUMBoundedSearchCacheEntry *startEntry = HUMBoundedSearchCacheEntryForTile(search, start, 0, iteration, &added);
+		if (startEntry) {
+			startEntry->g = 0;
+			startEntry->iteration = iteration;
+		}
+
+		path[0].tile = start;
+		path[0].g = 0;
+		path[0].next = 0;
+		int32_t depth = 0;
+
+		while (depth >= 0) {
+			HUMBoundedSearchFrame *frame = &path[depth];
+
+			if (frame->next == 0) {
+				double f = HUMBoundedSearchF(search, frame->tile, frame->g);
+
+				if (f > limit) {
+					if (!found) {
+						int32_t bucket = (int32_t)((f - limit) / width);
+						counts[bucket < HUMBoundedSearchLimitBucketCount ? bucket : HUMBoundedSearchLimitBucketCount - 1]++;
+						smallestF = f < smallestF ? f : smallestF;
+						largestF = f > largestF ? f : largestF;
+					}
+
+					depth--;
+					continue;
+				}
+
+				if (frame->tile == target) {
+					if (!HUMBoundedSearchCopyPathStack(search, depth + 1, result)) {
+						return -2;
+					}
+
+					// costs are whole numbers, so this leaves out every path that doesn't cost less
+					found = true;
+					limit = frame->g - 0.5;
+					depth--;
+					continue;
+				}
+
+				if (result->expandedCount == search->expansionLimit) {
+					return -3;
+				}
+
+				result->expandedCount++;
+				frame->moves = HUMBoundedSearchMoves(search, frame->tile, NULL);
+			}
+
+			if (frame->next >= search->directionCount) {
+				depth--;
+				continue;
+			}
+
+			int32_t direction = frame->next++;
+			if (!(frame->moves & (1 << direction))) {
+				continue;
+			}
+
+			if (depth + 1 == search->pathCapacity) {
+				overflowed = true;
+				continue;
+			}
+
+			int32_t neighbor = HUMBoundedSearchNeighbor(search, frame->tile, direction);
+			uint32_t cost = 0;
+			HUMBoundedSearchSample(search, neighbor % query->width, neighbor / query->width, &cost);
+
+			uint32_t neighborG = frame->g + (direction < 4 ? cost : HUMSearchDiagonalCost(cost));
+			HUMBoundedSearchCacheEntry *entry = HUMBoundedSearchCacheEntryForTile(search, neighbor, neighborG, iteration, &added);
+
+			// reached this iteration, the tile was already followed from a cost at least this low. Reached in an earlier one, it will be followed
+			// again this iteration from that cost or a lower one.
+			if (!added && (entry->iteration == iteration ? neighborG >= entry->g : neighborG > entry->g)) {
+				continue;
+			}
+
+			if (entry) {
+				entry->g = neighborG;
+				entry->iteration = iteration;
+			}
+
+			depth++;
+			path[depth].tile = neighbor;
+			path[depth].g = neighborG;
+			path[depth].next = 0;
+		}
+
+		if (found) {
+			return 0;
+		}
+
+		// only a pass that left nothing out proves there's no path
+		if (smallestF == INFINITY) {
+			return overflowed ? -2 : -1;
+		}
+
+		limit = HUMBoundedSearchNextLimit(counts, limit, width, smallestF, largestF, result->expandedCount - expandedCount);
+		result->iterationCount++;
+	}
+}
+
+#pragma mark - Searching
+static bool HUMBoundedSearchCopyDirectionPath(HUMBoundedSearch *search, int32_t tile, HUMBoundedSearchResult *result) {
+	const int32_t width = search->query->width;
+	int32_t count = 1;
+
+	for (int32_t i = tile; HUMBoundedSearchDirection(search, i) != HUMBoundedSearchDirectionStart; count++) {
+		i = HUMBoundedSearchNeighbor(search, i, (HUMBoundedSearchDirection(search, i) - 1) ^ 2);
+	}
+
+	uint32_t cost = result->cost;
+	if (!HUMBoundedSearchAllocatePath(result, count)) {
+		return false;
+	}
+
+	result->cost = cost;
+
+	for (int32_t i = tile; count > 0; ) {
+		count--;
+		result->xs[count] = i % width;
+		result->ys[count] = i / width;
+
+		if (count > 0) {
+			i = HUMBoundedSearchNeighbor(search, i, (HUMBoundedSearchDirection(search, i) - 1) ^ 2);
+		}
+	}
+
+	return true;
+}
+
+static bool HUMBoundedSearchCopyPath(HUMBoundedSearch *search, int32_t index, HUMBoundedSearchResult *result) {
+	const int32_t width = search->query->width;
+	int32_t count = 0;
+
+	for (int32_t i = index; i >= 0; i = search->entries[i].parent) {
+		count++;
+	}
+
+	if (!HUMBoundedSearchAllocatePath(result, count)) {
+		return false;
+	}
+
+	result->cost = search->entries[index].g;
+
+	for (int32_t i = index; i >= 0; i = search->entries[i].parent) {
+		count--;
+		result->xs[count] = search->entries[i].tile % width;
+		result->ys[count] = search->entries[i].tile / width;
+	}
+
+	return true;
+}
+
+void HUMBoundedSearchFindPath(const HUMBoundedSearchQuery *query, HUMBoundedSearchResult *result) {
+	memset(result, 0, sizeof(HUMBoundedSearchResult));
+	result->status = HUMBoundedSearchStatusMemoryLimit;
+
+	HUMBoundedSearch search;
+	memset(&search, 0, sizeof(HUMBoundedSearch));
+	search.query = query;
+	search.result = result;
+	search.directionCount = query->neighbors == HUMSearchNeighborsCardinal ? 4 : 8;
+	search.fringe = -1;
+	search.expansionLimit = query->expansionLimit > 0 ? query->expansionLimit : HUMBoundedSearchExpansionsPerByte * (uint64_t)query->memoryLimit;
+
+	// the largest table up to the initial size that fits, which also leaves room for the iterative deepening table
+	int32_t capacity = HUMBoundedSearchInitialTileCount;
+	while (capacity > HUMBoundedSearchMinimumTileCount && HUMBoundedSearchEntryBytes(capacity) + HUMBoundedSearchSlotBytes(capacity) > query->memoryLimit) {
+		capacity /= 2;
+	}
+
+	if (HUMBoundedSearchEntryBytes(capacity) + HUMBoundedSearchSlotBytes(capacity) > query->memoryLimit) {
+		return;
+	}
+
+	search.entries = malloc(HUMBoundedSearchEntryBytes(capacity));
+	search.entryCapacity = capacity;
+
+	if (!search.entries) {
+		return;
+	}
+
+	HUMBoundedSearchHold(&search, HUMBoundedSearchEntryBytes(capacity));
+
+	double limit = HUMBoundedSearchF(&search, query->startY * query->width + query->startX, 0);
+	int32_t found = -2;
+
+	if (HUMBoundedSearchAllocateSlots(&search)) {
+		found = HUMBoundedSearchRunFringe(&search, &limit);
+
+		if (found >= 0) {
+			result->status = HUMBoundedSearchCopyPath(&search, found, result) ? HUMBoundedSearchStatusFound : HUMBoundedSearchStatusMemoryLimit;
+		}
+	}
+
+	if (found == -2 && HUMBoundedSearchAllocateCompact(&search)) {
+		int32_t target = HUMBoundedSearchRunCompact(&search, &limit);
+		found = target >= 0 ? 0 : target;
+
+		if (target >= 0) {
+			result->status = HUMBoundedSearchCopyDirectionPath(&search, target, result) ? HUMBoundedSearchStatusFound : HUMBoundedSearchStatusMemoryLimit;
+		}
+	}
+
+	if (found == -2) {
+		found = HUMBoundedSearchAllocateIterativeDeepening(&search) ? HUMBoundedSearchRunIterativeDeepening(&search, limit) : -2;
+
+		if (found >= 0) {
+			result->status = HUMBoundedSearchStatusFound;
+		}
+		else {
+			HUMBoundedSearchResultFree(result);
+		}
+	}
+
+	if (found == -1) {
+		result->status = HUMBoundedSearchStatusNoPath;
+	}
+	else if (found == -3) {
+		result->status = HUMBoundedSearchStatusExpansionLimit;
+	}
+
+	free(search.entries);
+	free(search.slots);
+	HUMBoundedSearchFreeCompact(&search);
+	free(search.path);
+	free(search.cache);
+}
+
+void HUMBoundedSearchResultFree(HUMBoundedSearchResult *result) {
+	free(result->xs);
+	free(result->ys);
+	result->xs = NULL;
+	result->ys = NULL;
+	result->count = 0;
+}
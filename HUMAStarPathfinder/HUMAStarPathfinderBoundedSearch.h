@@ -0,0 +1,103 @@
+//
+//  HUMAStarPathfinderBoundedSearch.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderBoundedSearch_h
+#define HUMAStarPathfinder_HUMAStarPathfinderBoundedSearch_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "HUMAStarPathfinderSearch.h"
+
+/**
+ *	The fewest tiles a bounded search needs room for. A memory limit too small for this many fails without searching.
+ */
+#define HUMBoundedSearchMinimumTileCount 64
+
+/**
+ *	The smallest memory limit with room for HUMBoundedSearchMinimumTileCount tiles, at 32 bytes a tile for the fringe's entries and hash table.
+ */
+#define HUMBoundedSearchMinimumMemoryLimit (HUMBoundedSearchMinimumTileCount * 32)
+
+/**
+ *	The number of tiles the table starts with room for, doubling whenever it fills up until it reaches the memory limit.
+ */
+#define HUMBoundedSearchInitialTileCount 1024
+
+/**
+ *	The number of places in the cache a tile can be stored at once the search has fallen back to iterative deepening.
+ */
+#define HUMBoundedSearchBucketSize 8
+
+/**
+ *	The number of tiles a search expands for each byte of its memory limit before it gives up, when the query doesn't set a limit of its own.
+ *  That's twice the most tiles the compact A* can hold, so only iterative deepening ever gives up with the default limit.
+ */
+#define HUMBoundedSearchExpansionsPerByte 4
+
+typedef struct {
+	int32_t width;
+	int32_t height;
+	int32_t startX;
+	int32_t startY;
+	int32_t targetX;
+	int32_t targetY;
+	HUMSearchNeighbors neighbors;
+	HUMSearchHeuristic heuristic;
+	HUMSearchSampleFunction sample;
+	void *info;
+	size_t memoryLimit;			// the most bytes of scratch memory the search may hold at once
+	uint64_t expansionLimit;	// the most tiles the search may expand, or 0 for HUMBoundedSearchExpansionsPerByte times the memory limit
+} HUMBoundedSearchQuery;
+
+typedef enum {
+	HUMBoundedSearchStatusFound = 0,
+	HUMBoundedSearchStatusNoPath,
+	HUMBoundedSearchStatusMemoryLimit,		// the memory limit couldn't hold the tiles of the path
+	HUMBoundedSearchStatusExpansionLimit	// the search expanded as many tiles as it may without reaching the target
+} HUMBoundedSearchStatus;
+
+/**
+ *	The result of HUMBoundedSearchFindPath. Free it with HUMBoundedSearchResultFree.
+ */
+typedef struct {
+	HUMBoundedSearchStatus status;
+	int32_t *xs;				// every tile of the path, from the start tile to the target tile, both included
+	int32_t *ys;
+	int32_t count;
+	uint32_t cost;
+
+	size_t peakBytes;			// the most bytes of scratch memory held at once, not counting the path
+	bool iterativeDeepening;	// the search outgrew the memory limit and was finished with iterative deepening
+	int32_t iterationCount;		// the times the f limit was raised
+	uint64_t expandedCount;		// tiles expanded, counting every time a tile is expanded again
+} HUMBoundedSearchResult;
+
+/**
+ *	Finds a cheapest path with a fringe search, which expands tiles in the same order of f as A* a limit at a time, without an open list.
+ *  Instead of state for every tile of the map, it keeps a hash table of only the tiles it has reached, which grows up to the memory
+ *  limit. Every move is charged the same way as HUMSearchFindPath, and the path found costs the same whenever the heuristic never overestimates.
+ *
+ *	If the fringe outgrows the memory limit, the table is freed and the search starts again from the start tile as an A* that keeps four bits
+ *  for every tile of the map, for whether it's closed and the direction it was reached in, and state only for its open tiles. On an open map
+ *  those are just the edge of the area searched, so it fits maps with many times the tiles the fringe could hold.
+ *
+ *	If the map is too large for that too, or its open tiles outgrow the limit, the search starts again as an iterative deepening A*. A quarter
+ *  of the limit holds the path it is following, and the rest caches the cheapest cost tiles were reached at, so that most tiles aren't
+ *  expanded twice in an iteration. The cache only saves time: when it fills up, entries are replaced. Only a path longer than the path stack
+ *  fails, and a cheaper path that long may be passed over for a longer one that fits. Once the tiles within reach outnumber what the cache
+ *  holds, iterative deepening expands far more tiles than A*, so every search stops once it has expanded expansionLimit tiles.
+ *
+ *	The start and target must lie within the map, and the target must be walkable. The start doesn't have to be.
+ *
+ *	@param	result	Filled with the result. Must be freed with HUMBoundedSearchResultFree, whatever the status.
+ */
+void HUMBoundedSearchFindPath(const HUMBoundedSearchQuery *query, HUMBoundedSearchResult *result);
+void HUMBoundedSearchResultFree(HUMBoundedSearchResult *result);
+
+#endif
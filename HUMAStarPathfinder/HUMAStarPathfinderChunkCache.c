@@ -0,0 +1,434 @@
+//
+//  HUMAStarPathfinderChunkCache.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderChunkCache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#pragma mark - Chunks
+
+static HUMChunk *HUMChunkCreate(HUMChunkCache *cache) {
+	size_t area = (size_t)1 << (2 * cache->chunkShift);
+	HUMChunk *chunk = calloc(1, sizeof(HUMChunk));
+	if (!chunk) {
+		return NULL;
+	}
+
+	chunk->cache = cache;
+	chunk->walkable = malloc(area * sizeof(uint8_t));
+	chunk->costs = malloc(area * sizeof(uint32_t));
+
+	if (!chunk->walkable || !chunk->costs) {
+		free(chunk->walkable);
+		free(chunk->costs);
+		free(chunk);
+		return NULL;
+	}
+
+	cache->residentCount++;
+
+	return chunk;
+}
+
+static void HUMChunkFree(HUMChunk *chunk) {
+	chunk->cache->residentCount--;
+
+	free(chunk->walkable);
+	free(chunk->costs);
+	free(chunk);
+}
+
+static void HUMChunkCacheUnlink(HUMChunk *chunk) {
+	chunk->previous->next = chunk->next;
+	chunk->next->previous = chunk->previous;
+	chunk->previous = NULL;
+	chunk->next = NULL;
+}
+
+static void HUMChunkCachePushFront(HUMChunkCache *cache, HUMChunk *chunk) {
+	chunk->previous = &cache->lru;
+	chunk->next = cache->lru.next;
+	cache->lru.next->previous = chunk;
+	cache->lru.next = chunk;
+}
+
+#pragma mark - Cache
+
+HUMChunkCache *HUMChunkCacheCreate(int32_t width, int32_t height, int32_t chunkShift, int32_t residentLimit, HUMChunkCacheLoadFunction load, void *loadInfo, HUMChunkCacheDispatchFunction dispatch, void *dispatchInfo) {
+	if (width <= 0 || height <= 0 || chunkShift < 1 || chunkShift > 12 || residentLimit < 1 || !load) {
+		return NULL;
+	}
+
+	HUMChunkCache *cache = calloc(1, sizeof(HUMChunkCache));
+	if (!cache) {
+		return NULL;
+	}
+
+	int32_t chunkSize = 1 << chunkShift;
+
+	cache->width = width;
+	cache->height = height;
+	cache->chunkShift = chunkShift;
+	cache->chunkColumns = (width + chunkSize - 1) >> chunkShift;
+	cache->chunkRows = (height + chunkSize - 1) >> chunkShift;
+	cache->residentLimit = residentLimit;
+	cache->chunks = calloc((size_t)cache->chunkColumns * (size_t)cache->chunkRows, sizeof(HUMChunk *));
+	cache->lru.previous = &cache->lru;
+	cache->lru.next = &cache->lru;
+	cache->load = load;
+	cache->loadInfo = loadInfo;
+	cache->dispatch = dispatch;
+	cache->dispatchInfo = dispatchInfo;
+	pthread_mutex_init(&cache->lock, NULL);
+	pthread_cond_init(&cache->loaded, NULL);
+
+	if (!cache->chunks) {
+		HUMChunkCacheFree(cache);
+		return NULL;
+	}
+
+	return cache;
+}
+
+void HUMChunkCacheFree(HUMChunkCache *cache) {
+	if (!cache) {
+		return;
+	}
+
+	// prefetches hold a pointer to the cache until they finish
+	pthread_mutex_lock(&cache->lock);
+	while (cache->pendingPrefetchCount > 0) {
+		pthread_cond_wait(&cache->loaded, &cache->lock);
+	}
+	pthread_mutex_unlock(&cache->lock);
+
+	if (cache->chunks) {
+		size_t chunkCount = (size_t)cache->chunkColumns * (size_t)cache->chunkRows;
+
+		for (size_t i = 0; i < chunkCount; i++) {
+			if (cache->chunks[i]) {
+				HUMChunkFree(cache->chunks[i]);
+			}
+		}
+	}
+
+	pthread_mutex_destroy(&cache->lock);
+	pthread_cond_destroy(&cache->loaded);
+	free(cache->chunks);
+	free(cache);
+}
+
+/**
+ *	Takes the least recently used chunk out of the cache. NULL if every chunk is pinned or loading. Must be called with the lock held.
+ */
+static HUMChunk *HUMChunkCacheEvict(HUMChunkCache *cache) {
+	HUMChunk *chunk = cache->lru.previous;
+	if (chunk == &cache->lru) {
+		return NULL;
+	}
+
+	HUMChunkCacheUnlink(chunk);
+	cache->chunks[chunk->chunkIndex] = NULL;
+	cache->statistics.evictionCount++;
+
+	return chunk;
+}
+
+/**
+ *	A chunk to load into: a new one while the cache is under its resident limit, otherwise the least recently used one. Must be called with
+ *  the lock held.
+ *
+ *	@param	mayExceedLimit	Allocate a new chunk if every loaded chunk is in use, rather than returning NULL.
+ */
+static HUMChunk *HUMChunkCacheTakeChunk(HUMChunkCache *cache, bool mayExceedLimit) {
+	if (cache->residentCount >= cache->residentLimit) {
+		HUMChunk *chunk = HUMChunkCacheEvict(cache);
+
+		if (chunk || !mayExceedLimit) {
+			return chunk;
+		}
+	}
+
+	return HUMChunkCreate(cache);
+}
+
+/**
+ *	Called with the lock held once nothing is using a chunk anymore. Returns it to the LRU list, or frees it if it was invalidated, then
+ *  evicts chunks until the cache is back within its resident limit.
+ */
+static void HUMChunkCacheRelease(HUMChunkCache *cache, HUMChunk *chunk) {
+	if (chunk->detached) {
+		HUMChunkFree(chunk);
+	}
+	else {
+		HUMChunkCachePushFront(cache, chunk);
+	}
+
+	while (cache->residentCount > cache->residentLimit) {
+		HUMChunk *evicted = HUMChunkCacheEvict(cache);
+		if (!evicted) {
+			break;
+		}
+
+		HUMChunkFree(evicted);
+	}
+}
+
+static void HUMChunkCacheUnpin(HUMChunkCache *cache, HUMChunk *chunk) {
+	if (--chunk->pinCount == 0) {
+		HUMChunkCacheRelease(cache, chunk);
+	}
+}
+
+/**
+ *	Loads a chunk that has been marked as loading. Must be called with the lock held, which is released while the load function runs so
+ *  other threads can keep using the chunks that are already loaded.
+ */
+static void HUMChunkCacheLoad(HUMChunkCache *cache, HUMChunk *chunk) {
+	int32_t chunkSize = 1 << cache->chunkShift;
+	int32_t x = (chunk->chunkIndex % cache->chunkColumns) << cache->chunkShift;
+	int32_t y = (chunk->chunkIndex / cache->chunkColumns) << cache->chunkShift;
+	int32_t width = x + chunkSize > cache->width ? cache->width - x : chunkSize;
+	int32_t height = y + chunkSize > cache->height ? cache->height - y : chunkSize;
+
+	pthread_mutex_unlock(&cache->lock);
+
+	if (!cache->load(cache->loadInfo, x, y, width, height, chunk->walkable, chunk->costs, chunkSize)) {
+		memset(chunk->walkable, 0, (size_t)chunkSize * chunkSize);
+	}
+
+	pthread_mutex_lock(&cache->lock);
+
+	chunk->state = HUMChunkStateReady;
+	cache->statistics.loadCount++;
+	pthread_cond_broadcast(&cache->loaded);
+}
+
+/**
+ *	Pins the chunk with the provided index, loading it first if needed. Must be called with the lock held.
+ *
+ *	@param	faulted	Set to true if the chunk wasn't ready, so the caller had to wait for it.
+ */
+static HUMChunk *HUMChunkCacheAcquire(HUMChunkCache *cache, int32_t chunkIndex, bool *faulted) {
+	for (;;) {
+		HUMChunk *chunk = cache->chunks[chunkIndex];
+
+		if (!chunk) {
+			chunk = HUMChunkCacheTakeChunk(cache, true);
+			if (!chunk) {
+				return NULL;
+			}
+
+			chunk->chunkIndex = chunkIndex;
+			chunk->state = HUMChunkStateLoading;
+			chunk->pinCount = 1;
+			chunk->detached = false;
+			cache->chunks[chunkIndex] = chunk;
+
+			*faulted = true;
+			HUMChunkCacheLoad(cache, chunk);
+
+			return chunk;
+		}
+
+		if (chunk->state == HUMChunkStateLoading) {
+			// another query or a prefetch is loading it. Look it up again afterwards, since it may have been invalidated in the meantime.
+			*faulted = true;
+			pthread_cond_wait(&cache->loaded, &cache->lock);
+			continue;
+		}
+
+		if (chunk->pinCount++ == 0) {
+			HUMChunkCacheUnlink(chunk);
+		}
+
+		return chunk;
+	}
+}
+
+static void HUMChunkCachePrefetchChunk(void *context) {
+	HUMChunk *chunk = context;
+	HUMChunkCache *cache = chunk->cache;
+
+	pthread_mutex_lock(&cache->lock);
+
+	HUMChunkCacheLoad(cache, chunk);
+	cache->statistics.prefetchCount++;
+
+	// a query may have started waiting on the chunk while it loaded
+	if (chunk->pinCount == 0) {
+		HUMChunkCacheRelease(cache, chunk);
+	}
+
+	cache->pendingPrefetchCount--;
+	pthread_cond_broadcast(&cache->loaded);
+
+	pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ *	Starts loading a chunk in the background if it isn't loaded, there's room for it without evicting a chunk in use, and not too many
+ *  prefetches are running already. Must be called with the lock held.
+ */
+static void HUMChunkCachePrefetch(HUMChunkCache *cache, int32_t chunkIndex) {
+	if (!cache->dispatch || cache->chunks[chunkIndex] || cache->pendingPrefetchCount >= HUMChunkCacheMaximumPrefetches) {
+		return;
+	}
+
+	HUMChunk *chunk = HUMChunkCacheTakeChunk(cache, false);
+	if (!chunk) {
+		return;
+	}
+
+	chunk->chunkIndex = chunkIndex;
+	chunk->state = HUMChunkStateLoading;
+	chunk->pinCount = 0;
+	chunk->detached = false;
+	cache->chunks[chunkIndex] = chunk;
+	cache->pendingPrefetchCount++;
+
+	cache->dispatch(cache->dispatchInfo, chunk, HUMChunkCachePrefetchChunk);
+}
+
+/**
+ *	Removes a chunk from the cache. It's freed right away if nothing is using it. Must be called with the lock held.
+ */
+static void HUMChunkCacheDrop(HUMChunkCache *cache, int32_t chunkIndex) {
+	HUMChunk *chunk = cache->chunks[chunkIndex];
+	if (!chunk) {
+		return;
+	}
+
+	cache->chunks[chunkIndex] = NULL;
+
+	if (chunk->state == HUMChunkStateReady && chunk->pinCount == 0) {
+		HUMChunkCacheUnlink(chunk);
+		HUMChunkFree(chunk);
+	}
+	else {
+		chunk->detached = true;
+	}
+}
+
+void HUMChunkCacheInvalidate(HUMChunkCache *cache, int32_t x, int32_t y, int32_t width, int32_t height) {
+	int32_t maxX = x + width - 1;
+	int32_t maxY = y + height - 1;
+
+	x = x < 0 ? 0 : x;
+	y = y < 0 ? 0 : y;
+	maxX = maxX >= cache->width ? cache->width - 1 : maxX;
+	maxY = maxY >= cache->height ? cache->height - 1 : maxY;
+
+	if (width <= 0 || height <= 0 || x > maxX || y > maxY) {
+		return;
+	}
+
+	pthread_mutex_lock(&cache->lock);
+
+	for (int32_t chunkY = y >> cache->chunkShift; chunkY <= maxY >> cache->chunkShift; chunkY++) {
+		for (int32_t chunkX = x >> cache->chunkShift; chunkX <= maxX >> cache->chunkShift; chunkX++) {
+			HUMChunkCacheDrop(cache, chunkY * cache->chunkColumns + chunkX);
+		}
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+}
+
+void HUMChunkCacheInvalidateAll(HUMChunkCache *cache) {
+	HUMChunkCacheInvalidate(cache, 0, 0, cache->width, cache->height);
+}
+
+HUMChunkCacheStatistics HUMChunkCacheGetStatistics(HUMChunkCache *cache) {
+	pthread_mutex_lock(&cache->lock);
+	HUMChunkCacheStatistics statistics = cache->statistics;
+	pthread_mutex_unlock(&cache->lock);
+
+	return statistics;
+}
+
+void HUMChunkCacheRecordQuery(HUMChunkCache *cache, uint32_t faultCount) {
+	pthread_mutex_lock(&cache->lock);
+
+	cache->statistics.queryCount++;
+	cache->statistics.lastQueryFaultCount = faultCount;
+
+	if (faultCount > cache->statistics.maximumQueryFaultCount) {
+		cache->statistics.maximumQueryFaultCount = faultCount;
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+}
+
+void HUMChunkCacheResetStatistics(HUMChunkCache *cache) {
+	pthread_mutex_lock(&cache->lock);
+	memset(&cache->statistics, 0, sizeof(HUMChunkCacheStatistics));
+	pthread_mutex_unlock(&cache->lock);
+}
+
+#pragma mark - Cursors
+
+void HUMChunkCursorInit(HUMChunkCursor *cursor, HUMChunkCache *cache) {
+	cursor->cache = cache;
+	cursor->faultCount = 0;
+
+	for (int32_t entry = 0; entry < 4; entry++) {
+		cursor->chunkIndices[entry] = -1;
+		cursor->chunks[entry] = NULL;
+	}
+}
+
+void HUMChunkCursorFinish(HUMChunkCursor *cursor) {
+	HUMChunkCache *cache = cursor->cache;
+
+	pthread_mutex_lock(&cache->lock);
+
+	for (int32_t entry = 0; entry < 4; entry++) {
+		if (cursor->chunks[entry]) {
+			HUMChunkCacheUnpin(cache, cursor->chunks[entry]);
+		}
+
+		cursor->chunkIndices[entry] = -1;
+		cursor->chunks[entry] = NULL;
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+}
+
+void HUMChunkCursorMove(HUMChunkCursor *cursor, int32_t entry, int32_t chunkIndex) {
+	HUMChunkCache *cache = cursor->cache;
+	bool faulted = false;
+
+	pthread_mutex_lock(&cache->lock);
+
+	if (cursor->chunks[entry]) {
+		HUMChunkCacheUnpin(cache, cursor->chunks[entry]);
+	}
+
+	cursor->chunks[entry] = HUMChunkCacheAcquire(cache, chunkIndex, &faulted);
+	cursor->chunkIndices[entry] = chunkIndex;
+
+	if (faulted) {
+		cursor->faultCount++;
+		cache->statistics.faultCount++;
+	}
+
+	// the search's frontier has spread into this chunk, so the chunks around it are the ones it will need next
+	int32_t chunkX = chunkIndex % cache->chunkColumns;
+	int32_t chunkY = chunkIndex / cache->chunkColumns;
+
+	for (int32_t neighborY = chunkY - 1; neighborY <= chunkY + 1; neighborY++) {
+		for (int32_t neighborX = chunkX - 1; neighborX <= chunkX + 1; neighborX++) {
+			if (neighborX >= 0 && neighborY >= 0 && neighborX < cache->chunkColumns && neighborY < cache->chunkRows) {
+				HUMChunkCachePrefetch(cache, neighborY * cache->chunkColumns + neighborX);
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+}
@@ -0,0 +1,175 @@
+//
+//  HUMAStarPathfinderChunkCache.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderChunkCache_h
+#define HUMAStarPathfinder_HUMAStarPathfinderChunkCache_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+/**
+ *	The most chunks that may be loading in the background at once.
+ */
+#define HUMChunkCacheMaximumPrefetches 8
+
+/**
+ *	Called by the cache to load the walkability and cost of a chunk, usually from disk. Rows are written stride entries apart starting at the
+ *  provided pointers. Called without the cache's lock held, from the thread that needs the chunk or from a prefetch.
+ *
+ *	@return	false if the chunk couldn't be loaded, in which case every tile in it is treated as blocked until it is invalidated.
+ */
+typedef bool (*HUMChunkCacheLoadFunction)(void *info, int32_t x, int32_t y, int32_t width, int32_t height, uint8_t *walkable, uint32_t *costs, int32_t stride);
+
+/**
+ *	Runs work(context) asynchronously. Matches the shape of dispatch_async_f.
+ */
+typedef void (*HUMChunkCacheDispatchFunction)(void *info, void *context, void (*work)(void *context));
+
+typedef enum {
+	HUMChunkStateLoading = 0,
+	HUMChunkStateReady
+} HUMChunkState;
+
+typedef struct HUMChunk {
+	struct HUMChunkCache *cache;
+	int32_t chunkIndex;
+	int32_t pinCount;			// the cursors using the chunk. Pinned and loading chunks are never evicted.
+	HUMChunkState state;
+	bool detached;				// invalidated while in use. Freed once the last cursor lets go of it.
+
+	struct HUMChunk *previous;	// the LRU list, which holds every ready chunk that isn't pinned, most recently used first
+	struct HUMChunk *next;
+
+	uint8_t *walkable;			// chunkSize * chunkSize flags, row-major
+	uint32_t *costs;			// chunkSize * chunkSize entry costs
+} HUMChunk;
+
+typedef struct {
+	uint64_t loadCount;			// chunks loaded, including prefetches
+	uint64_t faultCount;		// times a query had to wait for a chunk to load
+	uint64_t prefetchCount;		// chunks loaded in the background
+	uint64_t evictionCount;		// chunks dropped to stay within the resident limit
+	uint64_t queryCount;		// queries recorded with HUMChunkCacheRecordQuery
+	uint32_t lastQueryFaultCount;
+	uint32_t maximumQueryFaultCount;
+} HUMChunkCacheStatistics;
+
+/**
+ *	The walkability and cost of a map too large to hold in memory, stored as square chunks that are loaded on demand and evicted least
+ *  recently used first once more than residentLimit are loaded. Safe to use from multiple threads, each through its own cursor.
+ */
+typedef struct HUMChunkCache {
+	int32_t width;
+	int32_t height;
+	int32_t chunkShift;			// chunks are 1 << chunkShift tiles across
+	int32_t chunkColumns;
+	int32_t chunkRows;
+	int32_t residentLimit;
+	int32_t residentCount;		// chunks holding memory, including loading and pinned ones
+
+	HUMChunk **chunks;			// per chunk index, the chunk holding it, or NULL if it isn't loaded
+	HUMChunk lru;				// the sentinel of the LRU list
+
+	HUMChunkCacheLoadFunction load;
+	void *loadInfo;
+	HUMChunkCacheDispatchFunction dispatch;
+	void *dispatchInfo;
+	int32_t pendingPrefetchCount;	// prefetches that haven't finished yet
+
+	HUMChunkCacheStatistics statistics;
+
+	pthread_mutex_t lock;
+	pthread_cond_t loaded;		// signaled whenever a chunk finishes loading
+} HUMChunkCache;
+
+/**
+ *	A query's view of the cache. Holds up to four chunks pinned, one for each combination of odd and even chunk coordinates, so a search
+ *  moving around a chunk corner never has to go back to the cache. Reads of pinned chunks take no locks.
+ */
+typedef struct {
+	HUMChunkCache *cache;
+	int32_t chunkIndices[4];
+	HUMChunk *chunks[4];
+	uint32_t faultCount;		// the times this cursor had to wait for a chunk to load
+} HUMChunkCursor;
+
+/**
+ *	Creates a cache for a map of the provided size.
+ *
+ *	@param	chunkShift		Chunks are 1 << chunkShift tiles across. Between 1 and 12.
+ *	@param	residentLimit	The number of chunks kept loaded. Exceeded only while more chunks than that are pinned at once.
+ *	@param	dispatch		Runs prefetches in the background. NULL disables prefetching.
+ */
+HUMChunkCache *HUMChunkCacheCreate(int32_t width, int32_t height, int32_t chunkShift, int32_t residentLimit, HUMChunkCacheLoadFunction load, void *loadInfo, HUMChunkCacheDispatchFunction dispatch, void *dispatchInfo);
+
+/**
+ *	Waits for any running prefetches, then frees the cache. No cursor may still be using it.
+ */
+void HUMChunkCacheFree(HUMChunkCache *cache);
+
+/**
+ *	Drops every chunk intersecting the rect so it is loaded again the next time it is read. Cursors already using one of the chunks keep
+ *  reading the old data until they move off it.
+ */
+void HUMChunkCacheInvalidate(HUMChunkCache *cache, int32_t x, int32_t y, int32_t width, int32_t height);
+void HUMChunkCacheInvalidateAll(HUMChunkCache *cache);
+
+HUMChunkCacheStatistics HUMChunkCacheGetStatistics(HUMChunkCache *cache);
+
+/**
+ *	Adds a finished query's faults to the statistics.
+ */
+void HUMChunkCacheRecordQuery(HUMChunkCache *cache, uint32_t faultCount);
+void HUMChunkCacheResetStatistics(HUMChunkCache *cache);
+
+void HUMChunkCursorInit(HUMChunkCursor *cursor, HUMChunkCache *cache);
+
+/**
+ *	Lets go of every chunk the cursor holds.
+ */
+void HUMChunkCursorFinish(HUMChunkCursor *cursor);
+
+/**
+ *	Points one of the cursor's entries at a chunk, loading it if needed, and queues the chunks around it to be prefetched.
+ */
+void HUMChunkCursorMove(HUMChunkCursor *cursor, int32_t entry, int32_t chunkIndex);
+
+/**
+ *	The chunk holding a tile, and the tile's offset within it. NULL if the chunk couldn't be allocated.
+ */
+static inline HUMChunk *HUMChunkCursorChunk(HUMChunkCursor *cursor, int32_t x, int32_t y, int32_t *offset) {
+	const HUMChunkCache *cache = cursor->cache;
+	int32_t shift = cache->chunkShift;
+	int32_t mask = (1 << shift) - 1;
+	int32_t chunkX = x >> shift;
+	int32_t chunkY = y >> shift;
+	int32_t entry = (chunkX & 1) | ((chunkY & 1) << 1);
+	int32_t chunkIndex = chunkY * cache->chunkColumns + chunkX;
+
+	if (cursor->chunkIndices[entry] != chunkIndex) {
+		HUMChunkCursorMove(cursor, entry, chunkIndex);
+	}
+
+	*offset = ((y & mask) << shift) | (x & mask);
+	return cursor->chunks[entry];
+}
+
+static inline bool HUMChunkCursorIsWalkable(HUMChunkCursor *cursor, int32_t x, int32_t y) {
+	int32_t offset;
+	HUMChunk *chunk = HUMChunkCursorChunk(cursor, x, y, &offset);
+	return chunk && chunk->walkable[offset];
+}
+
+static inline uint32_t HUMChunkCursorCost(HUMChunkCursor *cursor, int32_t x, int32_t y) {
+	int32_t offset;
+	HUMChunk *chunk = HUMChunkCursorChunk(cursor, x, y, &offset);
+	return chunk ? chunk->costs[offset] : 0;
+}
+
+#endif
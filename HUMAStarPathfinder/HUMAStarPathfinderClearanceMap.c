@@ -0,0 +1,112 @@
+//
+//  HUMAStarPathfinderClearanceMap.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderClearanceMap.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ *	Computes the clearance of a single tile from its walkability and the already computed clearance of its E, S, and SE neighbors.
+ *  Tiles outside the map have a clearance of 0.
+ */
+static inline uint8_t HUMClearanceMapCompute(const HUMClearanceMap *map, int32_t x, int32_t y, bool walkable) {
+	if (!walkable) {
+		return 0;
+	}
+
+	int32_t width = map->width;
+	const uint8_t *clearance = map->clearance;
+
+	uint32_t east = (x + 1 < width) ? clearance[y * width + x + 1] : 0;
+	uint32_t south = (y + 1 < map->height) ? clearance[(y + 1) * width + x] : 0;
+	uint32_t southEast = (x + 1 < width && y + 1 < map->height) ? clearance[(y + 1) * width + x + 1] : 0;
+
+	uint32_t smallest = east < south ? east : south;
+	smallest = smallest < southEast ? smallest : southEast;
+
+	return smallest + 1 > HUMClearanceMapMaximumClearance ? HUMClearanceMapMaximumClearance : (uint8_t)(smallest + 1);
+}
+
+HUMClearanceMap *HUMClearanceMapCreate(int32_t width, int32_t height, const uint8_t *walkable) {
+	HUMClearanceMap *map = calloc(1, sizeof(HUMClearanceMap));
+	if (!map) {
+		return NULL;
+	}
+
+	map->width = width;
+	map->height = height;
+	map->clearance = malloc((size_t)width * (size_t)height);
+
+	if (!map->clearance) {
+		HUMClearanceMapFree(map);
+		return NULL;
+	}
+
+	// every tile only depends on tiles below and to the right of it, so a single reverse pass computes the whole map
+	for (int32_t y = height - 1; y >= 0; y--) {
+		for (int32_t x = width - 1; x >= 0; x--) {
+			map->clearance[y * width + x] = HUMClearanceMapCompute(map, x, y, walkable[y * width + x]);
+		}
+	}
+
+	return map;
+}
+
+void HUMClearanceMapFree(HUMClearanceMap *map) {
+	if (!map) {
+		return;
+	}
+
+	free(map->clearance);
+	free(map);
+}
+
+void HUMClearanceMapUpdate(HUMClearanceMap *map, int32_t x, int32_t y, int32_t width, int32_t height, const uint8_t *walkable) {
+	int32_t mapWidth = map->width;
+	int32_t maxX = x + width - 1;
+	int32_t maxY = y + height - 1;
+
+	if (x < 0 || y < 0 || width <= 0 || height <= 0 || maxX >= mapWidth || maxY >= map->height) {
+		return;
+	}
+
+	// a tile only affects the clearance of tiles up to the maximum clearance above and to the left of it
+	int32_t minX = x - HUMClearanceMapMaximumClearance;
+	int32_t minY = y - HUMClearanceMapMaximumClearance;
+	minX = minX < 0 ? 0 : minX;
+	minY = minY < 0 ? 0 : minY;
+
+	for (int32_t row = maxY; row >= minY; row--) {
+		bool rowChanged = false;
+
+		for (int32_t column = maxX; column >= minX; column--) {
+			uint8_t *clearance = &map->clearance[row * mapWidth + column];
+			bool tileWalkable;
+
+			if (row >= y && column >= x) {
+				tileWalkable = walkable[(row - y) * width + (column - x)];
+			}
+			else {
+				// the walkability of tiles outside the edited rect hasn't changed, and is recorded by a non-zero clearance
+				tileWalkable = *clearance > 0;
+			}
+
+			uint8_t newClearance = HUMClearanceMapCompute(map, column, row, tileWalkable);
+			if (newClearance != *clearance) {
+				*clearance = newClearance;
+				rowChanged = true;
+			}
+		}
+
+		// rows above the edited rect only change if the row below them did
+		if (!rowChanged && row <= y) {
+			break;
+		}
+	}
+}
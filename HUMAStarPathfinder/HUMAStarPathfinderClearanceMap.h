@@ -0,0 +1,48 @@
+//
+//  HUMAStarPathfinderClearanceMap.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderClearanceMap_h
+#define HUMAStarPathfinder_HUMAStarPathfinderClearanceMap_h
+
+#include <stdint.h>
+
+/**
+ *	The largest clearance that is tracked. Larger squares are clamped to this value.
+ */
+#define HUMClearanceMapMaximumClearance 255
+
+/**
+ *	Holds the clearance of every tile: the size of the largest square of walkable tiles whose top-left tile (lowest x and y) is that tile.
+ *  A unit with a footprint of N x N tiles anchored at its top-left tile fits on any tile with a clearance of at least N. Non-walkable tiles
+ *  have a clearance of 0.
+ */
+typedef struct {
+	int32_t width;
+	int32_t height;
+	uint8_t *clearance;
+} HUMClearanceMap;
+
+/**
+ *	Creates a clearance map from a row-major array of walkable flags, computed in a single linear pass.
+ */
+HUMClearanceMap *HUMClearanceMapCreate(int32_t width, int32_t height, const uint8_t *walkable);
+void HUMClearanceMapFree(HUMClearanceMap *map);
+
+/**
+ *	Updates the walkability of a rect of tiles and recomputes the clearance of only the tiles it can affect: those up and to the left of the
+ *  rect within HUMClearanceMapMaximumClearance tiles, stopping early once a row is unchanged.
+ *
+ *	@param	walkable	The new walkable flags of the rect, row-major, width * height entries.
+ */
+void HUMClearanceMapUpdate(HUMClearanceMap *map, int32_t x, int32_t y, int32_t width, int32_t height, const uint8_t *walkable);
+
+static inline uint8_t HUMClearanceMapClearance(const HUMClearanceMap *map, int32_t x, int32_t y) {
+	return map->clearance[y * map->width + x];
+}
+
+#endif
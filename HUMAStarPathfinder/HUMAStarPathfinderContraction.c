@@ -0,0 +1,1419 @@
+//
+//  HUMAStarPathfinderContraction.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderContraction.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	int32_t width;
+	int32_t height;
+	uint32_t neighbors;
+	int32_t nodeCount;
+	int32_t forwardCount;
+	int32_t backwardCount;
+} HUMContractionHierarchyHeader;
+
+static const int8_t HUMContractionDirectionX[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+static const int8_t HUMContractionDirectionY[8] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+
+#pragma mark - Moves
+
+static inline bool HUMContractionIsWalkable(const HUMContractionHierarchy *hierarchy, int32_t x, int32_t y) {
+	return x >= 0 && y >= 0 && x < hierarchy->width && y < hierarchy->height && hierarchy->walkable[y * hierarchy->width + x];
+}
+
+static inline int32_t HUMContractionDirectionCount(const HUMContractionHierarchy *hierarchy) {
+	return hierarchy->neighbors == HUMSearchNeighborsCardinal ? 4 : 8;
+}
+
+/**
+ *	Determines if a unit on tile (x, y) can move in a direction, under the same corner rules as HUMSearchFindPath.
+ */
+static bool HUMContractionCanMove(const HUMContractionHierarchy *hierarchy, int32_t x, int32_t y, int32_t direction) {
+	int32_t directionX = HUMContractionDirectionX[direction];
+	int32_t directionY = HUMContractionDirectionY[direction];
+
+	if (!HUMContractionIsWalkable(hierarchy, x + directionX, y + directionY)) {
+		return false;
+	}
+
+	if (direction < 4 || hierarchy->neighbors == HUMSearchNeighborsDiagonal) {
+		return true;
+	}
+
+	bool horizontal = HUMContractionIsWalkable(hierarchy, x + directionX, y);
+	bool vertical = HUMContractionIsWalkable(hierarchy, x, y + directionY);
+
+	return hierarchy->neighbors == HUMSearchNeighborsDiagonalCrossBorders ? (horizontal || vertical) : (horizontal && vertical);
+}
+
+static inline uint32_t HUMContractionMoveCost(const HUMContractionHierarchy *hierarchy, int32_t tile, int32_t direction) {
+	uint32_t cost = hierarchy->costs[tile];
+	return direction < 4 ? cost : HUMSearchDiagonalCost(cost);
+}
+
+/**
+ *	Adds two costs, saturating at UINT32_MAX.
+ */
+static inline uint32_t HUMContractionAddCosts(uint32_t a, uint32_t b) {
+	uint64_t sum = (uint64_t)a + b;
+	return sum < UINT32_MAX ? (uint32_t)sum : UINT32_MAX;
+}
+
+#pragma mark - Open List
+
+typedef struct {
+	uint32_t key;
+	int32_t node;
+} HUMContractionHeapEntry;
+
+/**
+ *	A binary heap that a node is pushed onto again whenever its cost improves. Entries that are out of date by the time they're popped are
+ *  skipped by comparing their key to the node's cost.
+ */
+typedef struct {
+	HUMContractionHeapEntry *entries;
+	int32_t count;
+	int32_t capacity;
+} HUMContractionHeap;
+
+static bool HUMContractionHeapPush(HUMContractionHeap *heap, int32_t node, uint32_t key) {
+	if (heap->count == heap->capacity) {
+		int32_t capacity = heap->capacity > 0 ? heap->capacity * 2 : 64;
+		HUMContractionHeapEntry *entries = realloc(heap->entries, (size_t)capacity * sizeof(HUMContractionHeapEntry));
+
+		if (!entries) {
+			return false;
+		}
+
+		heap->entries = entries;
+		heap->capacity = capacity;
+	}
+
+	int32_t index = heap->count++;
+
+	while (index > 0) {
+		int32_t parent = (index - 1) / 2;
+		if (heap->entries[parent].key <= key) {
+			break;
+		}
+
+		heap->entries[index] = heap->entries[parent];
+		index = parent;
+	}
+
+	heap->entries[index].key = key;
+	heap->entries[index].node = node;
+
+	return true;
+}
+
+static HUMContractionHeapEntry HUMContractionHeapPop(HUMContractionHeap *heap) {
+	HUMContractionHeapEntry top = heap->entries[0];
+	HUMContractionHeapEntry last = heap->entries[--heap->count];
+	int32_t index = 0;
+
+	while (1) {
+		int32_t child = 2 * index + 1;
+		if (child >= heap->count) {
+			break;
+		}
+
+		if (child + 1 < heap->count && heap->entries[child + 1].key < heap->entries[child].key) {
+			child++;
+		}
+
+		if (last.key <= heap->entries[child].key) {
+			break;
+		}
+
+		heap->entries[index] = heap->entries[child];
+		index = child;
+	}
+
+	if (heap->count > 0) {
+		heap->entries[index] = last;
+	}
+
+	return top;
+}
+
+#pragma mark - Building
+
+typedef struct {
+	HUMContractionEdge *edges;
+	int32_t count;
+	int32_t capacity;
+} HUMContractionEdgeList;
+
+typedef struct {
+	int32_t source;
+	int32_t target;
+	uint32_t cost;
+	int32_t middle;
+} HUMContractionShortcut;
+
+/**
+ *	The scratch memory of one worker: the costs of its current witness search, and the shortcuts it has found this round.
+ */
+typedef struct {
+	uint32_t *distance;		// nodeCount costs, UINT32_MAX for nodes the witness search hasn't reached
+	uint32_t *targetCosts;	// nodeCount costs of the paths through the node being contracted, UINT32_MAX for nodes that aren't targets
+	int32_t *touched;
+	int32_t touchedCount;
+	HUMContractionHeap heap;
+
+	HUMContractionShortcut *shortcuts;
+	int32_t shortcutCount;
+	int32_t shortcutCapacity;
+
+	bool failed;			// set if the worker ran out of memory
+} HUMContractionWorker;
+
+enum {
+	HUMContractionNodeRemaining = 0,
+	HUMContractionNodeSelected,		// being contracted this round
+	HUMContractionNodeContracted
+};
+
+/**
+ *	The graph while it's being contracted. A node's edge lists only hold nodes that are still remaining, except once the node itself has been
+ *  contracted, when they're frozen into its edges up the hierarchy.
+ */
+typedef struct {
+	HUMContractionHierarchy *hierarchy;
+	const HUMContractionBuild *build;
+
+	HUMContractionEdgeList *outgoing;
+	HUMContractionEdgeList *incoming;	// with node set to the source of each edge
+
+	uint8_t *state;
+	int32_t *priority;
+	int32_t *contractedNeighbors;	// edges to nodes already contracted
+	int32_t *depths;				// one more than the deepest contracted neighbor, so nodes contracted in a chain are spread out
+
+	int32_t *items;				// the nodes the current parallel step works on
+	int32_t itemCount;
+
+	HUMContractionWorker workers[HUMContractionWorkerCount];
+} HUMContractionBuilder;
+
+typedef void (*HUMContractionStepFunction)(HUMContractionBuilder *builder, HUMContractionWorker *worker, int32_t node);
+
+/**
+ *	A step that only reads and writes the node's own state, and needs none of a worker's scratch memory.
+ */
+typedef void (*HUMContractionNodeFunction)(HUMContractionBuilder *builder, int32_t node);
+
+typedef struct {
+	HUMContractionBuilder *builder;
+	HUMContractionStepFunction step;		// or NULL to run nodeStep
+	HUMContractionNodeFunction nodeStep;
+} HUMContractionStep;
+
+static bool HUMContractionEdgeListAppend(HUMContractionEdgeList *list, int32_t node, uint32_t cost, int32_t middle) {
+	if (list->count == list->capacity) {
+		int32_t capacity = list->capacity > 0 ? list->capacity * 2 : 8;
+		HUMContractionEdge *edges = realloc(list->edges, (size_t)capacity * sizeof(HUMContractionEdge));
+
+		if (!edges) {
+			return false;
+		}
+
+		list->edges = edges;
+		list->capacity = capacity;
+	}
+
+	HUMContractionEdge *edge = &list->edges[list->count++];
+	edge->node = node;
+	edge->cost = cost;
+	edge->middle = middle;
+
+	return true;
+}
+
+static HUMContractionEdge *HUMContractionEdgeListFind(HUMContractionEdgeList *list, int32_t node) {
+	for (int32_t i = 0; i < list->count; i++) {
+		if (list->edges[i].node == node) {
+			return &list->edges[i];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ *	Adds an edge to the graph, or lowers the cost of the edge already between the two nodes.
+ */
+static bool HUMContractionAddEdge(HUMContractionBuilder *builder, int32_t source, int32_t target, uint32_t cost, int32_t middle) {
+	HUMContractionEdge *outgoing = HUMContractionEdgeListFind(&builder->outgoing[source], target);
+
+	if (outgoing) {
+		if (cost < outgoing->cost) {
+			HUMContractionEdge *incoming = HUMContractionEdgeListFind(&builder->incoming[target], source);
+
+			outgoing->cost = incoming->cost = cost;
+			outgoing->middle = incoming->middle = middle;
+		}
+
+		return true;
+	}
+
+	return HUMContractionEdgeListAppend(&builder->outgoing[source], target, cost, middle) && HUMContractionEdgeListAppend(&builder->incoming[target], source, cost, middle);
+}
+
+/**
+ *	Runs a step over every item, split between the workers. Each worker takes every HUMContractionWorkerCount-th item so that the expensive
+ *  nodes, which tend to be next to each other, are spread between them.
+ */
+static void HUMContractionRunWorker(void *context, size_t iteration) {
+	HUMContractionStep *step = context;
+	HUMContractionBuilder *builder = step->builder;
+	HUMContractionWorker *worker = &builder->workers[iteration];
+
+	for (int32_t i = (int32_t)iteration; i < builder->itemCount && !worker->failed; i += HUMContractionWorkerCount) {
+		if (step->step) {
+			step->step(builder, worker, builder->items[i]);
+		}
+		else {
+			step->nodeStep(builder, builder->items[i]);
+		}
+	}
+}
+
+static bool HUMContractionRunStep(HUMContractionBuilder *builder, HUMContractionStep *step) {
+	if (builder->build->apply) {
+		builder->build->apply(builder->build->applyInfo, HUMContractionWorkerCount, step, HUMContractionRunWorker);
+	}
+	else {
+		for (size_t i = 0; i < HUMContractionWorkerCount; i++) {
+			HUMContractionRunWorker(step, i);
+		}
+	}
+
+	for (int32_t i = 0; i < HUMContractionWorkerCount; i++) {
+		if (builder->workers[i].failed) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool HUMContractionRun(HUMContractionBuilder *builder, HUMContractionStepFunction function) {
+	HUMContractionStep step = { builder, function, NULL };
+	return HUMContractionRunStep(builder, &step);
+}
+
+static bool HUMContractionRunNodes(HUMContractionBuilder *builder, HUMContractionNodeFunction function) {
+	HUMContractionStep step = { builder, NULL, function };
+	return HUMContractionRunStep(builder, &step);
+}
+
+/**
+ *	Runs a Dijkstra search from the source through the remaining nodes, other than the excluded one, settling nodes until every target has
+ *  been reached for no more than its target cost, the cheapest open node costs more than the limit, or settleLimit nodes have been settled. Every
+ *  node it reached is left in the worker's distance array until HUMContractionWitnessReset is called.
+ */
+static void HUMContractionWitnessSearch(HUMContractionBuilder *builder, HUMContractionWorker *worker, int32_t source, int32_t excluded, uint32_t limit, int32_t targetCount, int32_t settleLimit) {
+	HUMContractionHeap *heap = &worker->heap;
+	int32_t settled = 0;
+
+	worker->distance[source] = 0;
+	worker->touched[worker->touchedCount++] = source;
+	heap->count = 0;
+
+	if (!HUMContractionHeapPush(heap, source, 0)) {
+		worker->failed = true;
+		return;
+	}
+
+	while (heap->count > 0 && targetCount > 0) {
+		HUMContractionHeapEntry entry = HUMContractionHeapPop(heap);
+
+		if (entry.key > worker->distance[entry.node]) {
+			continue;
+		}
+
+		if (entry.key > limit || ++settled > settleLimit) {
+			break;
+		}
+
+		const HUMContractionEdgeList *edges = &builder->outgoing[entry.node];
+
+		for (int32_t i = 0; i < edges->count; i++) {
+			int32_t neighbor = edges->edges[i].node;
+			uint32_t distance = HUMContractionAddCosts(entry.key, edges->edges[i].cost);
+
+			if (neighbor == excluded || builder->state[neighbor] != HUMContractionNodeRemaining || distance > limit || distance >= worker->distance[neighbor]) {
+				continue;
+			}
+
+			if (worker->distance[neighbor] == UINT32_MAX) {
+				worker->touched[worker->touchedCount++] = neighbor;
+			}
+
+			// a target is witnessed as soon as it's reached for no more than the path through the node being contracted
+			if (distance <= worker->targetCosts[neighbor] && worker->distance[neighbor] > worker->targetCosts[neighbor]) {
+				targetCount--;
+			}
+
+			worker->distance[neighbor] = distance;
+
+			if (!HUMContractionHeapPush(heap, neighbor, distance)) {
+				worker->failed = true;
+				return;
+			}
+		}
+	}
+
+	heap->count = 0;
+}
+
+static void HUMContractionWitnessReset(HUMContractionWorker *worker) {
+	for (int32_t i = 0; i < worker->touchedCount; i++) {
+		worker->distance[worker->touched[i]] = UINT32_MAX;
+	}
+
+	worker->touchedCount = 0;
+}
+
+/**
+ *	Finds the shortcuts contracting a node needs: one between each in-neighbor and out-neighbor whose path through the node is cheaper than any
+ *  witness path around it. A witness search that gives up keeps the shortcut, which is never wrong, only redundant.
+ *
+ *	@param	record	Whether to add the shortcuts to the worker's list, or only count them. Counting only estimates the priority of the node, so its
+ *					witness searches give up sooner.
+ *
+ *	@return	The number of shortcuts.
+ */
+static int32_t HUMContractionFindShortcuts(HUMContractionBuilder *builder, HUMContractionWorker *worker, int32_t node, bool record) {
+	const HUMContractionEdgeList *incoming = &builder->incoming[node];
+	const HUMContractionEdgeList *outgoing = &builder->outgoing[node];
+	int32_t count = 0;
+
+	for (int32_t i = 0; i < incoming->count && !worker->failed; i++) {
+		int32_t source = incoming->edges[i].node;
+		uint32_t sourceCost = incoming->edges[i].cost;
+		uint32_t limit = 0;
+		int32_t targetCount = 0;
+
+		for (int32_t j = 0; j < outgoing->count; j++) {
+			uint32_t cost = HUMContractionAddCosts(sourceCost, outgoing->edges[j].cost);
+
+			if (outgoing->edges[j].node != source) {
+				worker->targetCosts[outgoing->edges[j].node] = cost;
+				limit = cost > limit ? cost : limit;
+				targetCount++;
+			}
+		}
+
+		if (targetCount == 0) {
+			continue;
+		}
+
+		HUMContractionWitnessSearch(builder, worker, source, node, limit, targetCount, record ? HUMContractionWitnessSettleLimit : HUMContractionEstimateSettleLimit);
+
+		for (int32_t j = 0; j < outgoing->count && !worker->failed; j++) {
+			int32_t target = outgoing->edges[j].node;
+			uint32_t cost = HUMContractionAddCosts(sourceCost, outgoing->edges[j].cost);
+
+			if (target == source || worker->distance[target] <= cost) {
+				continue;
+			}
+
+			count++;
+
+			if (!record) {
+				continue;
+			}
+
+			if (worker->shortcutCount == worker->shortcutCapacity) {
+				int32_t capacity = worker->shortcutCapacity > 0 ? worker->shortcutCapacity * 2 : 256;
+				HUMContractionShortcut *shortcuts = realloc(worker->shortcuts, (size_t)capacity * sizeof(HUMContractionShortcut));
+
+				if (!shortcuts) {
+					worker->failed = true;
+					break;
+				}
+
+				worker->shortcuts = shortcuts;
+				worker->shortcutCapacity = capacity;
+			}
+
+			HUMContractionShortcut *shortcut = &worker->shortcuts[worker->shortcutCount++];
+			shortcut->source = source;
+			shortcut->target = target;
+			shortcut->cost = cost;
+			shortcut->middle = node;
+		}
+
+		for (int32_t j = 0; j < outgoing->count; j++) {
+			worker->targetCosts[outgoing->edges[j].node] = UINT32_MAX;
+		}
+
+		HUMContractionWitnessReset(worker);
+	}
+
+	return count;
+}
+
+/**
+ *	Twice the edge difference of a node, plus the edges it had to nodes already contracted and twice its depth.
+ */
+static void HUMContractionUpdatePriority(HUMContractionBuilder *builder, HUMContractionWorker *worker, int32_t node) {
+	int32_t shortcuts = HUMContractionFindShortcuts(builder, worker, node, false);
+	int32_t edgeDifference = shortcuts - builder->incoming[node].count - builder->outgoing[node].count;
+
+	builder->priority[node] = 2 * edgeDifference + builder->contractedNeighbors[node] + 2 * builder->depths[node];
+}
+
+/**
+ *	A fixed scramble of a node's index, which breaks ties between nodes of the same priority without favoring one corner of the map.
+ */
+static inline uint32_t HUMContractionTieBreak(int32_t node) {
+	uint32_t hash = (uint32_t)node * 0x9e3779b1u;
+	return hash ^ (hash >> 16);
+}
+
+static inline bool HUMContractionPrecedes(const HUMContractionBuilder *builder, int32_t a, int32_t b) {
+	if (builder->priority[a] != builder->priority[b]) {
+		return builder->priority[a] < builder->priority[b];
+	}
+
+	uint32_t tieA = HUMContractionTieBreak(a);
+	uint32_t tieB = HUMContractionTieBreak(b);
+
+	return tieA != tieB ? tieA < tieB : a < b;
+}
+
+/**
+ *	Selects a node for this round if it comes before all of its neighbors, so the nodes of a round are never neighbors. The node with the
+ *  lowest priority is always selected, so every round contracts at least one node.
+ */
+static void HUMContractionSelect(HUMContractionBuilder *builder, int32_t node) {
+	const HUMContractionEdgeList *lists[2] = { &builder->incoming[node], &builder->outgoing[node] };
+
+	for (int32_t i = 0; i < 2; i++) {
+		for (int32_t j = 0; j < lists[i]->count; j++) {
+			if (!HUMContractionPrecedes(builder, node, lists[i]->edges[j].node)) {
+				return;
+			}
+		}
+	}
+
+	builder->state[node] = HUMContractionNodeSelected;
+}
+
+static void HUMContractionContract(HUMContractionBuilder *builder, HUMContractionWorker *worker, int32_t node) {
+	HUMContractionFindShortcuts(builder, worker, node, true);
+}
+
+/**
+ *	Drops the edges to nodes contracted in the last round.
+ */
+static void HUMContractionCompact(HUMContractionBuilder *builder, int32_t node) {
+	HUMContractionEdgeList *lists[2] = { &builder->incoming[node], &builder->outgoing[node] };
+
+	for (int32_t i = 0; i < 2; i++) {
+		int32_t count = 0;
+
+		for (int32_t j = 0; j < lists[i]->count; j++) {
+			if (builder->state[lists[i]->edges[j].node] != HUMContractionNodeContracted) {
+				lists[i]->edges[count++] = lists[i]->edges[j];
+			}
+		}
+
+		lists[i]->count = count;
+	}
+}
+
+/**
+ *	Copies the frozen edge lists of every node into one array.
+ */
+static bool HUMContractionFlatten(const HUMContractionEdgeList *lists, int32_t nodeCount, int32_t **first, HUMContractionEdge **edges, int32_t *edgeCount) {
+	int64_t count = 0;
+
+	for (int32_t i = 0; i < nodeCount; i++) {
+		count += lists[i].count;
+	}
+
+	if (count > INT32_MAX) {
+		return false;
+	}
+
+	*first = malloc(((size_t)nodeCount + 1) * sizeof(int32_t));
+	*edges = malloc(((size_t)count + 1) * sizeof(HUMContractionEdge));
+	*edgeCount = (int32_t)count;
+
+	if (!*first || !*edges) {
+		return false;
+	}
+
+	int32_t offset = 0;
+
+	for (int32_t i = 0; i < nodeCount; i++) {
+		(*first)[i] = offset;
+
+		if (lists[i].count > 0) {
+			memcpy(*edges + offset, lists[i].edges, (size_t)lists[i].count * sizeof(HUMContractionEdge));
+		}
+
+		offset += lists[i].count;
+	}
+
+	(*first)[nodeCount] = offset;
+
+	return true;
+}
+
+/**
+ *	Allocates a hierarchy and its per-tile arrays, and numbers the walkable tiles.
+ */
+static HUMContractionHierarchy *HUMContractionHierarchyAllocate(int32_t width, int32_t height, HUMSearchNeighbors neighbors) {
+	if (width <= 0 || height <= 0 || (uint64_t)width * height > INT32_MAX || neighbors >= HUMSearchNeighborsCount) {
+		return NULL;
+	}
+
+	HUMContractionHierarchy *hierarchy = calloc(1, sizeof(HUMContractionHierarchy));
+	if (!hierarchy) {
+		return NULL;
+	}
+
+	size_t tileCount = (size_t)width * height;
+
+	hierarchy->width = width;
+	hierarchy->height = height;
+	hierarchy->neighbors = neighbors;
+	hierarchy->walkable = malloc(tileCount);
+	hierarchy->costs = malloc(tileCount * sizeof(uint32_t));
+	hierarchy->nodeAtTile = malloc(tileCount * sizeof(int32_t));
+
+	if (!hierarchy->walkable || !hierarchy->costs || !hierarchy->nodeAtTile) {
+		HUMContractionHierarchyFree(hierarchy);
+		return NULL;
+	}
+
+	return hierarchy;
+}
+
+/**
+ *	Numbers the walkable tiles in row-major order once walkable has been filled in.
+ */
+static bool HUMContractionHierarchyNumberNodes(HUMContractionHierarchy *hierarchy) {
+	size_t tileCount = (size_t)hierarchy->width * hierarchy->height;
+	int32_t nodeCount = 0;
+
+	for (size_t i = 0; i < tileCount; i++) {
+		nodeCount += hierarchy->walkable[i] != 0;
+	}
+
+	hierarchy->nodeCount = nodeCount;
+	hierarchy->nodeTiles = malloc(((size_t)nodeCount + 1) * sizeof(int32_t));
+	hierarchy->ranks = malloc(((size_t)nodeCount + 1) * sizeof(int32_t));
+
+	if (!hierarchy->nodeTiles || !hierarchy->ranks) {
+		return false;
+	}
+
+	nodeCount = 0;
+
+	for (size_t i = 0; i < tileCount; i++) {
+		if (hierarchy->walkable[i]) {
+			hierarchy->nodeTiles[nodeCount] = (int32_t)i;
+			hierarchy->nodeAtTile[i] = nodeCount++;
+		}
+		else {
+			hierarchy->nodeAtTile[i] = -1;
+		}
+	}
+
+	return true;
+}
+
+static void HUMContractionBuilderFree(HUMContractionBuilder *builder) {
+	int32_t nodeCount = builder->hierarchy ? builder->hierarchy->nodeCount : 0;
+
+	for (int32_t i = 0; builder->outgoing && i < nodeCount; i++) {
+		free(builder->outgoing[i].edges);
+	}
+
+	for (int32_t i = 0; builder->incoming && i < nodeCount; i++) {
+		free(builder->incoming[i].edges);
+	}
+
+	for (int32_t i = 0; i < HUMContractionWorkerCount; i++) {
+		free(builder->workers[i].distance);
+		free(builder->workers[i].targetCosts);
+		free(builder->workers[i].touched);
+		free(builder->workers[i].heap.entries);
+		free(builder->workers[i].shortcuts);
+	}
+
+	free(builder->outgoing);
+	free(builder->incoming);
+	free(builder->state);
+	free(builder->priority);
+	free(builder->contractedNeighbors);
+	free(builder->depths);
+	free(builder->items);
+}
+
+HUMContractionHierarchy *HUMContractionHierarchyCreate(const HUMContractionBuild *build) {
+	HUMContractionHierarchy *hierarchy = HUMContractionHierarchyAllocate(build->width, build->height, build->neighbors);
+	if (!hierarchy) {
+		return NULL;
+	}
+
+	size_t tileCount = (size_t)build->width * build->height;
+
+	for (size_t i = 0; i < tileCount; i++) {
+		hierarchy->walkable[i] = build->walkable[i] != 0;
+	}
+
+	memcpy(hierarchy->costs, build->costs, tileCount * sizeof(uint32_t));
+
+	HUMContractionBuilder builder;
+	memset(&builder, 0, sizeof(builder));
+	builder.hierarchy = hierarchy;
+	builder.build = build;
+
+	bool built = false;
+	int32_t *remaining = NULL;
+	int32_t *dirtyNodes = NULL;
+	int32_t *dirtyRounds = NULL;
+
+	if (!HUMContractionHierarchyNumberNodes(hierarchy)) {
+		goto done;
+	}
+
+	size_t nodeCount = (size_t)hierarchy->nodeCount;
+
+	builder.outgoing = calloc(nodeCount + 1, sizeof(HUMContractionEdgeList));
+	builder.incoming = calloc(nodeCount + 1, sizeof(HUMContractionEdgeList));
+	builder.state = calloc(nodeCount + 1, 1);
+	builder.priority = malloc((nodeCount + 1) * sizeof(int32_t));
+	builder.contractedNeighbors = calloc(nodeCount + 1, sizeof(int32_t));
+	builder.depths = calloc(nodeCount + 1, sizeof(int32_t));
+	builder.items = malloc((nodeCount + 1) * sizeof(int32_t));
+	remaining = malloc((nodeCount + 1) * sizeof(int32_t));
+	dirtyNodes = malloc((nodeCount + 1) * sizeof(int32_t));
+	dirtyRounds = calloc(nodeCount + 1, sizeof(int32_t));
+
+	if (!builder.outgoing || !builder.incoming || !builder.state || !builder.priority || !builder.contractedNeighbors || !builder.depths || !builder.items || !remaining || !dirtyNodes || !dirtyRounds) {
+		goto done;
+	}
+
+	for (int32_t i = 0; i < HUMContractionWorkerCount; i++) {
+		HUMContractionWorker *worker = &builder.workers[i];
+
+		worker->distance = malloc((nodeCount + 1) * sizeof(uint32_t));
+		worker->targetCosts = malloc((nodeCount + 1) * sizeof(uint32_t));
+		worker->touched = malloc((nodeCount + 1) * sizeof(int32_t));
+
+		if (!worker->distance || !worker->targetCosts || !worker->touched) {
+			goto done;
+		}
+
+		for (size_t j = 0; j < nodeCount; j++) {
+			worker->distance[j] = worker->targetCosts[j] = UINT32_MAX;
+		}
+	}
+
+	// every move between neighboring walkable tiles is an edge
+	for (int32_t node = 0; node < hierarchy->nodeCount; node++) {
+		int32_t tile = hierarchy->nodeTiles[node];
+		int32_t x = tile % hierarchy->width;
+		int32_t y = tile / hierarchy->width;
+
+		for (int32_t direction = 0; direction < HUMContractionDirectionCount(hierarchy); direction++) {
+			if (!HUMContractionCanMove(hierarchy, x, y, direction)) {
+				continue;
+			}
+
+			int32_t neighborTile = tile + HUMContractionDirectionY[direction] * hierarchy->width + HUMContractionDirectionX[direction];
+			int32_t neighbor = hierarchy->nodeAtTile[neighborTile];
+
+			if (!HUMContractionEdgeListAppend(&builder.outgoing[node], neighbor, HUMContractionMoveCost(hierarchy, neighborTile, direction), -1) ||
+				!HUMContractionEdgeListAppend(&builder.incoming[neighbor], node, HUMContractionMoveCost(hierarchy, neighborTile, direction), -1)) {
+				goto done;
+			}
+		}
+
+		remaining[node] = node;
+		builder.items[node] = node;
+	}
+
+	int32_t remainingCount = hierarchy->nodeCount;
+	int32_t rank = 0;
+
+	builder.itemCount = hierarchy->nodeCount;
+
+	if (!HUMContractionRun(&builder, HUMContractionUpdatePriority)) {
+		goto done;
+	}
+
+	for (int32_t round = 1; remainingCount > 0; round++) {
+		memcpy(builder.items, remaining, (size_t)remainingCount * sizeof(int32_t));
+		builder.itemCount = remainingCount;
+
+		if (!HUMContractionRunNodes(&builder, HUMContractionSelect)) {
+			goto done;
+		}
+
+		int32_t selectedCount = 0;
+		int32_t stillRemaining = 0;
+
+		for (int32_t i = 0; i < remainingCount; i++) {
+			int32_t node = remaining[i];
+
+			if (builder.state[node] == HUMContractionNodeSelected) {
+				builder.items[selectedCount++] = node;
+			}
+			else {
+				remaining[stillRemaining++] = node;
+			}
+		}
+
+		remainingCount = stillRemaining;
+		builder.itemCount = selectedCount;
+
+		for (int32_t i = 0; i < HUMContractionWorkerCount; i++) {
+			builder.workers[i].shortcutCount = 0;
+		}
+
+		if (!HUMContractionRun(&builder, HUMContractionContract)) {
+			goto done;
+		}
+
+		// a neighbor of several contracted nodes is only queued once, the first time its round number is stamped
+		int32_t dirtyCount = 0;
+
+		for (int32_t i = 0; i < selectedCount; i++) {
+			int32_t node = builder.items[i];
+			HUMContractionEdgeList *lists[2] = { &builder.incoming[node], &builder.outgoing[node] };
+
+			builder.state[node] = HUMContractionNodeContracted;
+			hierarchy->ranks[node] = rank++;
+
+			for (int32_t j = 0; j < 2; j++) {
+				for (int32_t k = 0; k < lists[j]->count; k++) {
+					int32_t neighbor = lists[j]->edges[k].node;
+
+					builder.contractedNeighbors[neighbor]++;
+
+					if (builder.depths[neighbor] <= builder.depths[node]) {
+						builder.depths[neighbor] = builder.depths[node] + 1;
+					}
+
+					if (dirtyRounds[neighbor] != round) {
+						dirtyRounds[neighbor] = round;
+						dirtyNodes[dirtyCount++] = neighbor;
+					}
+				}
+			}
+		}
+
+		for (int32_t i = 0; i < HUMContractionWorkerCount; i++) {
+			const HUMContractionWorker *worker = &builder.workers[i];
+
+			for (int32_t j = 0; j < worker->shortcutCount; j++) {
+				const HUMContractionShortcut *shortcut = &worker->shortcuts[j];
+
+				if (!HUMContractionAddEdge(&builder, shortcut->source, shortcut->target, shortcut->cost, shortcut->middle)) {
+					goto done;
+				}
+			}
+		}
+
+		memcpy(builder.items, dirtyNodes, (size_t)dirtyCount * sizeof(int32_t));
+		builder.itemCount = dirtyCount;
+
+		if (!HUMContractionRunNodes(&builder, HUMContractionCompact) || !HUMContractionRun(&builder, HUMContractionUpdatePriority)) {
+			goto done;
+		}
+	}
+
+	built = HUMContractionFlatten(builder.outgoing, hierarchy->nodeCount, &hierarchy->firstForward, &hierarchy->forward, &hierarchy->forwardCount) &&
+			HUMContractionFlatten(builder.incoming, hierarchy->nodeCount, &hierarchy->firstBackward, &hierarchy->backward, &hierarchy->backwardCount);
+
+done:
+	HUMContractionBuilderFree(&builder);
+	free(remaining);
+	free(dirtyNodes);
+	free(dirtyRounds);
+
+	if (!built) {
+		HUMContractionHierarchyFree(hierarchy);
+		return NULL;
+	}
+
+	return hierarchy;
+}
+
+void HUMContractionHierarchyFree(HUMContractionHierarchy *hierarchy) {
+	if (!hierarchy) {
+		return;
+	}
+
+	free(hierarchy->walkable);
+	free(hierarchy->costs);
+	free(hierarchy->nodeAtTile);
+	free(hierarchy->nodeTiles);
+	free(hierarchy->ranks);
+	free(hierarchy->firstForward);
+	free(hierarchy->forward);
+	free(hierarchy->firstBackward);
+	free(hierarchy->backward);
+	free(hierarchy);
+}
+
+#pragma mark - Searching
+
+/**
+ *	A shortcut waiting to be unpacked: the edge from source to target through middle.
+ */
+typedef struct {
+	int32_t source;
+	int32_t target;
+	int32_t middle;
+} HUMContractionUnpackEntry;
+
+struct HUMContractionSearch {
+	const HUMContractionHierarchy *hierarchy;
+
+	uint32_t *distance[2];		// forward from the start, backward from the target
+	int32_t *parent[2];			// the node each node was reached from, or -1 for the nodes a direction started from
+	int32_t *parentEdge[2];		// the index of the edge it was reached by in the hierarchy's forward or backward edges
+	int32_t *touched;			// nodes reached by either direction
+	int32_t touchedCount;
+	HUMContractionHeap heaps[2];
+
+	HUMContractionUnpackEntry *stack;
+	int32_t stackCapacity;
+};
+
+HUMContractionSearch *HUMContractionSearchCreate(const HUMContractionHierarchy *hierarchy) {
+	HUMContractionSearch *search = calloc(1, sizeof(HUMContractionSearch));
+	if (!search) {
+		return NULL;
+	}
+
+	size_t nodeCount = (size_t)hierarchy->nodeCount + 1;
+
+	search->hierarchy = hierarchy;
+	search->touched = malloc(nodeCount * sizeof(int32_t));
+
+	bool allocated = search->touched != NULL;
+
+	for (int32_t i = 0; i < 2; i++) {
+		search->distance[i] = malloc(nodeCount * sizeof(uint32_t));
+		search->parent[i] = malloc(nodeCount * sizeof(int32_t));
+		search->parentEdge[i] = malloc(nodeCount * sizeof(int32_t));
+		allocated = allocated && search->distance[i] && search->parent[i] && search->parentEdge[i];
+	}
+
+	if (!allocated) {
+		HUMContractionSearchFree(search);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < nodeCount; i++) {
+		search->distance[0][i] = search->distance[1][i] = UINT32_MAX;
+	}
+
+	return search;
+}
+
+void HUMContractionSearchFree(HUMContractionSearch *search) {
+	if (!search) {
+		return;
+	}
+
+	for (int32_t i = 0; i < 2; i++) {
+		free(search->distance[i]);
+		free(search->parent[i]);
+		free(search->parentEdge[i]);
+		free(search->heaps[i].entries);
+	}
+
+	free(search->touched);
+	free(search->stack);
+	free(search);
+}
+
+/**
+ *	Records a cheaper way to reach a node in one direction.
+ *
+ *	@return	false if the open list couldn't grow.
+ */
+static bool HUMContractionSearchReach(HUMContractionSearch *search, int32_t direction, int32_t node, uint32_t distance, int32_t parent, int32_t parentEdge) {
+	if (distance >= search->distance[direction][node]) {
+		return true;
+	}
+
+	if (search->distance[0][node] == UINT32_MAX && search->distance[1][node] == UINT32_MAX) {
+		search->touched[search->touchedCount++] = node;
+	}
+
+	search->distance[direction][node] = distance;
+	search->parent[direction][node] = parent;
+	search->parentEdge[direction][node] = parentEdge;
+
+	return HUMContractionHeapPush(&search->heaps[direction], node, distance);
+}
+
+static void HUMContractionSearchReset(HUMContractionSearch *search) {
+	for (int32_t i = 0; i < search->touchedCount; i++) {
+		search->distance[0][search->touched[i]] = search->distance[1][search->touched[i]] = UINT32_MAX;
+	}
+
+	search->touchedCount = 0;
+	search->heaps[0].count = search->heaps[1].count = 0;
+}
+
+static int32_t HUMContractionFindEdge(const HUMContractionEdge *edges, const int32_t *first, int32_t owner, int32_t node) {
+	for (int32_t i = first[owner]; i < first[owner + 1]; i++) {
+		if (edges[i].node == node) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static bool HUMContractionPathAppend(const HUMContractionHierarchy *hierarchy, HUMContractionPath *path, int32_t *capacity, int32_t tile) {
+	// a cheapest path never visits a tile twice, so a longer one means the data is corrupt
+	if (path->count > hierarchy->nodeCount) {
+		return false;
+	}
+
+	if (path->count == *capacity) {
+		int32_t newCapacity = *capacity > 0 ? *capacity * 2 : 64;
+		int32_t *xs = realloc(path->xs, (size_t)newCapacity * sizeof(int32_t));
+
+		if (!xs) {
+			return false;
+		}
+
+		path->xs = xs;
+
+		int32_t *ys = realloc(path->ys, (size_t)newCapacity * sizeof(int32_t));
+
+		if (!ys) {
+			return false;
+		}
+
+		path->ys = ys;
+		*capacity = newCapacity;
+	}
+
+	path->xs[path->count] = tile % hierarchy->width;
+	path->ys[path->count] = tile / hierarchy->width;
+	path->count++;
+
+	return true;
+}
+
+/**
+ *	Appends the tiles after the source of an edge, up to and including its target. A shortcut is split into its two halves, both stored with
+ *  its middle node, until only moves between neighboring tiles are left.
+ */
+static bool HUMContractionUnpackEdge(HUMContractionSearch *search, HUMContractionPath *path, int32_t *capacity, int32_t source, int32_t target, int32_t middle) {
+	const HUMContractionHierarchy *hierarchy = search->hierarchy;
+	int32_t stackCount = 0;
+
+	HUMContractionUnpackEntry entry = { source, target, middle };
+
+	while (1) {
+		if (entry.middle == -1) {
+			if (!HUMContractionPathAppend(hierarchy, path, capacity, hierarchy->nodeTiles[entry.target])) {
+				return false;
+			}
+
+			if (stackCount == 0) {
+				return true;
+			}
+
+			entry = search->stack[--stackCount];
+			continue;
+		}
+
+		int32_t first = HUMContractionFindEdge(hierarchy->backward, hierarchy->firstBackward, entry.middle, entry.source);
+		int32_t second = HUMContractionFindEdge(hierarchy->forward, hierarchy->firstForward, entry.middle, entry.target);
+
+		if (first == -1 || second == -1) {
+			return false;
+		}
+
+		if (stackCount == search->stackCapacity) {
+			int32_t stackCapacity = search->stackCapacity > 0 ? search->stackCapacity * 2 : 32;
+			HUMContractionUnpackEntry *stack = realloc(search->stack, (size_t)stackCapacity * sizeof(HUMContractionUnpackEntry));
+
+			if (!stack) {
+				return false;
+			}
+
+			search->stack = stack;
+			search->stackCapacity = stackCapacity;
+		}
+
+		// the second half waits on the stack while the first is unpacked
+		HUMContractionUnpackEntry secondHalf = { entry.middle, entry.target, hierarchy->forward[second].middle };
+		search->stack[stackCount++] = secondHalf;
+
+		entry.target = entry.middle;
+		entry.middle = hierarchy->backward[first].middle;
+	}
+}
+
+/**
+ *	Walks the parents of both directions out from where they met and unpacks every edge between them.
+ */
+static bool HUMContractionSearchUnpack(HUMContractionSearch *search, int32_t startTile, int32_t meetingNode, HUMContractionPath *path) {
+	const HUMContractionHierarchy *hierarchy = search->hierarchy;
+	int32_t capacity = 0;
+
+	// the forward parents lead back to the start, so reverse them first, reusing the backward parents of the nodes on the way
+	int32_t root = meetingNode;
+	int32_t next = -1;
+	int32_t nextEdge = -1;
+
+	while (1) {
+		int32_t parent = search->parent[0][root];
+		int32_t parentEdge = search->parentEdge[0][root];
+
+		search->parent[0][root] = next;
+		search->parentEdge[0][root] = nextEdge;
+
+		if (parent == -1) {
+			break;
+		}
+
+		next = root;
+		nextEdge = parentEdge;
+		root = parent;
+	}
+
+	if (!HUMContractionPathAppend(hierarchy, path, &capacity, startTile)) {
+		return false;
+	}
+
+	// an unwalkable start isn't a node, so the forward search started from the tiles around it
+	if (hierarchy->nodeTiles[root] != startTile && !HUMContractionPathAppend(hierarchy, path, &capacity, hierarchy->nodeTiles[root])) {
+		return false;
+	}
+
+	for (int32_t node = root; search->parent[0][node] != -1; node = search->parent[0][node]) {
+		int32_t edge = search->parentEdge[0][node];
+
+		if (!HUMContractionUnpackEdge(search, path, &capacity, node, hierarchy->forward[edge].node, hierarchy->forward[edge].middle)) {
+			return false;
+		}
+	}
+
+	for (int32_t node = meetingNode; search->parent[1][node] != -1; node = search->parent[1][node]) {
+		int32_t edge = search->parentEdge[1][node];
+
+		if (!HUMContractionUnpackEdge(search, path, &capacity, node, search->parent[1][node], hierarchy->backward[edge].middle)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool HUMContractionSearchFindPath(HUMContractionSearch *search, int32_t startX, int32_t startY, int32_t targetX, int32_t targetY, HUMContractionPath *path) {
+	const HUMContractionHierarchy *hierarchy = search->hierarchy;
+	memset(path, 0, sizeof(HUMContractionPath));
+
+	if (startX < 0 || startY < 0 || startX >= hierarchy->width || startY >= hierarchy->height ||
+		targetX < 0 || targetY < 0 || targetX >= hierarchy->width || targetY >= hierarchy->height) {
+		return false;
+	}
+
+	int32_t startTile = startY * hierarchy->width + startX;
+	int32_t startNode = hierarchy->nodeAtTile[startTile];
+	int32_t targetNode = hierarchy->nodeAtTile[targetY * hierarchy->width + targetX];
+
+	if (targetNode == -1) {
+		return false;
+	}
+
+	bool allocated = true;
+
+	if (startNode != -1) {
+		allocated = HUMContractionSearchReach(search, 0, startNode, 0, -1, -1);
+	}
+	else {
+		for (int32_t direction = 0; direction < HUMContractionDirectionCount(hierarchy); direction++) {
+			if (HUMContractionCanMove(hierarchy, startX, startY, direction)) {
+				int32_t tile = startTile + HUMContractionDirectionY[direction] * hierarchy->width + HUMContractionDirectionX[direction];
+				allocated = allocated && HUMContractionSearchReach(search, 0, hierarchy->nodeAtTile[tile], HUMContractionMoveCost(hierarchy, tile, direction), -1, -1);
+			}
+		}
+	}
+
+	allocated = allocated && HUMContractionSearchReach(search, 1, targetNode, 0, -1, -1);
+
+	uint32_t best = UINT32_MAX;
+	int32_t meetingNode = -1;
+
+	// each direction runs until its cheapest open node can't lead to a cheaper path than the best one where the two have met
+	while (allocated) {
+		int32_t direction = -1;
+
+		for (int32_t i = 0; i < 2; i++) {
+			const HUMContractionHeap *heap = &search->heaps[i];
+
+			if (heap->count > 0 && heap->entries[0].key < best && (direction == -1 || heap->entries[0].key < search->heaps[direction].entries[0].key)) {
+				direction = i;
+			}
+		}
+
+		if (direction == -1) {
+			break;
+		}
+
+		HUMContractionHeapEntry entry = HUMContractionHeapPop(&search->heaps[direction]);
+
+		if (entry.key > search->distance[direction][entry.node]) {
+			continue;
+		}
+
+		path->nodesSettled++;
+
+		uint32_t other = search->distance[1 - direction][entry.node];
+		if (other != UINT32_MAX && HUMContractionAddCosts(entry.key, other) < best) {
+			best = HUMContractionAddCosts(entry.key, other);
+			meetingNode = entry.node;
+		}
+
+		const HUMContractionEdge *edges = direction == 0 ? hierarchy->forward : hierarchy->backward;
+		const int32_t *first = direction == 0 ? hierarchy->firstForward : hierarchy->firstBackward;
+
+		for (int32_t i = first[entry.node]; i < first[entry.node + 1] && allocated; i++) {
+			allocated = HUMContractionSearchReach(search, direction, edges[i].node, HUMContractionAddCosts(entry.key, edges[i].cost), entry.node, i);
+		}
+	}
+
+	bool found = allocated && meetingNode != -1 && HUMContractionSearchUnpack(search, startTile, meetingNode, path);
+
+	if (found) {
+		path->cost = best;
+	}
+
+	HUMContractionSearchReset(search);
+
+	return found;
+}
+
+void HUMContractionPathFree(HUMContractionPath *path) {
+	free(path->xs);
+	free(path->ys);
+	path->xs = NULL;
+	path->ys = NULL;
+	path->count = 0;
+}
+
+#pragma mark - Serialization
+
+/**
+ *	The sizes of the parts of serialized data, each padded to 4 bytes: the header, the walkable bits, the tile costs, the ranks, and the
+ *  offsets and edges of both directions.
+ */
+static uint64_t HUMContractionHierarchyDataSize(int32_t width, int32_t height, int32_t nodeCount, int32_t forwardCount, int32_t backwardCount, uint64_t *walkableSize) {
+	uint64_t tileCount = (uint64_t)width * height;
+	*walkableSize = ((tileCount + 7) / 8 + 3) & ~(uint64_t)3;
+
+	return sizeof(HUMContractionHierarchyHeader) + *walkableSize + tileCount * 4 + (uint64_t)nodeCount * 4 +
+		   2 * ((uint64_t)nodeCount + 1) * 4 + ((uint64_t)forwardCount + backwardCount) * sizeof(HUMContractionEdge);
+}
+
+void *HUMContractionHierarchyCopyData(const HUMContractionHierarchy *hierarchy, size_t *size) {
+	uint64_t walkableSize = 0;
+	uint64_t dataSize = HUMContractionHierarchyDataSize(hierarchy->width, hierarchy->height, hierarchy->nodeCount, hierarchy->forwardCount, hierarchy->backwardCount, &walkableSize);
+
+	if (dataSize > SIZE_MAX) {
+		return NULL;
+	}
+
+	uint8_t *data = calloc(1, (size_t)dataSize);
+	if (!data) {
+		return NULL;
+	}
+
+	HUMContractionHierarchyHeader header = { HUMContractionHierarchyMagic, HUMContractionHierarchyVersion, hierarchy->width, hierarchy->height, hierarchy->neighbors, hierarchy->nodeCount, hierarchy->forwardCount, hierarchy->backwardCount };
+	uint8_t *cursor = data;
+	size_t tileCount = (size_t)hierarchy->width * hierarchy->height;
+	size_t nodeCount = (size_t)hierarchy->nodeCount;
+
+	memcpy(cursor, &header, sizeof(header));
+	cursor += sizeof(header);
+
+	for (size_t i = 0; i < tileCount; i++) {
+		if (hierarchy->walkable[i]) {
+			cursor[i / 8] |= (uint8_t)(1 << (i % 8));
+		}
+	}
+	cursor += walkableSize;
+
+	memcpy(cursor, hierarchy->costs, tileCount * 4);
+	cursor += tileCount * 4;
+
+	if (nodeCount > 0) {
+		memcpy(cursor, hierarchy->ranks, nodeCount * 4);
+		cursor += nodeCount * 4;
+	}
+
+	memcpy(cursor, hierarchy->firstForward, (nodeCount + 1) * 4);
+	cursor += (nodeCount + 1) * 4;
+
+	if (hierarchy->forwardCount > 0) {
+		memcpy(cursor, hierarchy->forward, (size_t)hierarchy->forwardCount * sizeof(HUMContractionEdge));
+		cursor += (size_t)hierarchy->forwardCount * sizeof(HUMContractionEdge);
+	}
+
+	memcpy(cursor, hierarchy->firstBackward, (nodeCount + 1) * 4);
+	cursor += (nodeCount + 1) * 4;
+
+	if (hierarchy->backwardCount > 0) {
+		memcpy(cursor, hierarchy->backward, (size_t)hierarchy->backwardCount * sizeof(HUMContractionEdge));
+	}
+
+	*size = (size_t)dataSize;
+
+	return data;
+}
+
+/**
+ *	Checks that one direction's edges are in range and climb the hierarchy, and that every shortcut's middle node was contracted before its
+ *  source and target.
+ */
+static bool HUMContractionEdgesAreValid(const HUMContractionHierarchy *hierarchy, const int32_t *first, const HUMContractionEdge *edges, int32_t edgeCount) {
+	if (first[0] != 0 || first[hierarchy->nodeCount] != edgeCount) {
+		return false;
+	}
+
+	for (int32_t node = 0; node < hierarchy->nodeCount; node++) {
+		if (first[node] > first[node + 1] || first[node + 1] > edgeCount) {
+			return false;
+		}
+
+		for (int32_t i = first[node]; i < first[node + 1]; i++) {
+			const HUMContractionEdge *edge = &edges[i];
+
+			if (edge->node < 0 || edge->node >= hierarchy->nodeCount || hierarchy->ranks[edge->node] <= hierarchy->ranks[node]) {
+				return false;
+			}
+
+			if (edge->middle != -1 && (edge->middle < 0 || edge->middle >= hierarchy->nodeCount || hierarchy->ranks[edge->middle] >= hierarchy->ranks[node])) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+HUMContractionHierarchy *HUMContractionHierarchyCreateWithData(const void *bytes, size_t size, HUMContractionHierarchyStatus *status) {
+	HUMContractionHierarchyHeader header;
+	*status = HUMContractionHierarchyStatusInvalid;
+
+	if (size < sizeof(header)) {
+		return NULL;
+	}
+
+	memcpy(&header, bytes, sizeof(header));
+
+	if (header.magic != HUMContractionHierarchyMagic) {
+		return NULL;
+	}
+
+	if (header.version != HUMContractionHierarchyVersion) {
+		*status = HUMContractionHierarchyStatusUnsupportedVersion;
+		return NULL;
+	}
+
+	if (header.width <= 0 || header.height <= 0 || (uint64_t)header.width * header.height > INT32_MAX || header.nodeCount < 0 ||
+		header.forwardCount < 0 || header.backwardCount < 0 || header.neighbors >= HUMSearchNeighborsCount) {
+		return NULL;
+	}
+
+	uint64_t walkableSize = 0;
+	if (HUMContractionHierarchyDataSize(header.width, header.height, header.nodeCount, header.forwardCount, header.backwardCount, &walkableSize) != size) {
+		return NULL;
+	}
+
+	HUMContractionHierarchy *hierarchy = HUMContractionHierarchyAllocate(header.width, header.height, header.neighbors);
+	if (!hierarchy) {
+		*status = HUMContractionHierarchyStatusOutOfMemory;
+		return NULL;
+	}
+
+	const uint8_t *cursor = (const uint8_t *)bytes + sizeof(header);
+	size_t tileCount = (size_t)header.width * header.height;
+	size_t nodeCount = (size_t)header.nodeCount;
+
+	for (size_t i = 0; i < tileCount; i++) {
+		hierarchy->walkable[i] = (cursor[i / 8] >> (i % 8)) & 1;
+	}
+	cursor += walkableSize;
+
+	memcpy(hierarchy->costs, cursor, tileCount * 4);
+	cursor += tileCount * 4;
+
+	if (!HUMContractionHierarchyNumberNodes(hierarchy)) {
+		HUMContractionHierarchyFree(hierarchy);
+		*status = HUMContractionHierarchyStatusOutOfMemory;
+		return NULL;
+	}
+
+	// the nodes are the walkable tiles, so their number is implied by the walkable bits
+	if (hierarchy->nodeCount != header.nodeCount) {
+		HUMContractionHierarchyFree(hierarchy);
+		return NULL;
+	}
+
+	hierarchy->forwardCount = header.forwardCount;
+	hierarchy->backwardCount = header.backwardCount;
+	hierarchy->firstForward = malloc((nodeCount + 1) * sizeof(int32_t));
+	hierarchy->forward = malloc(((size_t)header.forwardCount + 1) * sizeof(HUMContractionEdge));
+	hierarchy->firstBackward = malloc((nodeCount + 1) * sizeof(int32_t));
+	hierarchy->backward = malloc(((size_t)header.backwardCount + 1) * sizeof(HUMContractionEdge));
+
+	if (!hierarchy->firstForward || !hierarchy->forward || !hierarchy->firstBackward || !hierarchy->backward) {
+		HUMContractionHierarchyFree(hierarchy);
+		*status = HUMContractionHierarchyStatusOutOfMemory;
+		return NULL;
+	}
+
+	memcpy(hierarchy->ranks, cursor, nodeCount * 4);
+	cursor += nodeCount * 4;
+	memcpy(hierarchy->firstForward, cursor, (nodeCount + 1) * 4);
+	cursor += (nodeCount + 1) * 4;
+	memcpy(hierarchy->forward, cursor, (size_t)header.forwardCount * sizeof(HUMContractionEdge));
+	cursor += (size_t)header.forwardCount * sizeof(HUMContractionEdge);
+	memcpy(hierarchy->firstBackward, cursor, (nodeCount + 1) * 4);
+	cursor += (nodeCount + 1) * 4;
+	memcpy(hierarchy->backward, cursor, (size_t)header.backwardCount * sizeof(HUMContractionEdge));
+
+	if (!HUMContractionEdgesAreValid(hierarchy, hierarchy->firstForward, hierarchy->forward, hierarchy->forwardCount) ||
+		!HUMContractionEdgesAreValid(hierarchy, hierarchy->firstBackward, hierarchy->backward, hierarchy->backwardCount)) {
+		HUMContractionHierarchyFree(hierarchy);
+		return NULL;
+	}
+
+	*status = HUMContractionHierarchyStatusOK;
+
+	return hierarchy;
+}
@@ -0,0 +1,161 @@
+//
+//  HUMAStarPathfinderContraction.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderContraction_h
+#define HUMAStarPathfinder_HUMAStarPathfinderContraction_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "HUMAStarPathfinderSearch.h"
+
+/**
+ *	The number of workers contraction splits its searches between, each with its own scratch memory sized to the map.
+ */
+#define HUMContractionWorkerCount 8
+
+/**
+ *	The most nodes a witness search settles before giving up and keeping the shortcut it was looking for a way around.
+ */
+#define HUMContractionWitnessSettleLimit 64
+
+/**
+ *	The most nodes a witness search settles while estimating how many shortcuts contracting a node would add.
+ */
+#define HUMContractionEstimateSettleLimit 16
+
+/**
+ *	One directed edge of the hierarchy. A shortcut stands for the cheapest path from its source through its middle node to its target, and
+ *  both halves are themselves edges of the hierarchy stored with the middle node, which is contracted before either end.
+ */
+typedef struct {
+	int32_t node;		// the other end of the edge
+	uint32_t cost;
+	int32_t middle;		// the node the shortcut was made by contracting, or -1 for a move between two neighboring tiles
+} HUMContractionEdge;
+
+/**
+ *	A contraction hierarchy of a grid with per-tile entry costs. The walkable tiles are the nodes, numbered in row-major order, and moves between
+ *  them are the edges, costing the entry cost of the tile moved onto like HUMSearchFindPath. Nodes are contracted one at a time, least important
+ *  first: a node is removed from the graph and a shortcut is added between each pair of its neighbors whose cheapest path ran through it.
+ *  Every node keeps only its edges to nodes contracted after it, so a search from either end only ever climbs the hierarchy, and a query
+ *  settles a few hundred nodes where A* would expand tens of thousands of tiles.
+ *
+ *	The hierarchy never changes once built, so it can be searched from any number of threads at once, each with its own HUMContractionSearch.
+ */
+typedef struct {
+	int32_t width;
+	int32_t height;
+	HUMSearchNeighbors neighbors;
+
+	uint8_t *walkable;			// width * height flags, row-major. The hierarchy's own copy.
+	uint32_t *costs;			// width * height entry costs, row-major
+	int32_t *nodeAtTile;		// width * height, the node of each tile, or -1
+
+	int32_t nodeCount;
+	int32_t *nodeTiles;			// the tile index (y * width + x) of each node
+	int32_t *ranks;				// the order each node was contracted in
+
+	int32_t *firstForward;		// nodeCount + 1 offsets into forward
+	HUMContractionEdge *forward;	// the edges leaving each node toward nodes of a higher rank
+	int32_t forwardCount;
+
+	int32_t *firstBackward;		// nodeCount + 1 offsets into backward
+	HUMContractionEdge *backward;	// the edges entering each node from nodes of a higher rank, with node set to the source
+	int32_t backwardCount;
+} HUMContractionHierarchy;
+
+/**
+ *	Runs work(context, i) for every i below iterations and returns once all of them have finished. Matches the shape of dispatch_apply_f.
+ */
+typedef void (*HUMContractionApplyFunction)(void *info, size_t iterations, void *context, void (*work)(void *context, size_t iteration));
+
+typedef struct {
+	int32_t width;
+	int32_t height;
+	const uint8_t *walkable;	// row-major, width * height flags
+	const uint32_t *costs;		// row-major, width * height entry costs
+	HUMSearchNeighbors neighbors;
+
+	HUMContractionApplyFunction apply;	// NULL contracts every node on the calling thread
+	void *applyInfo;
+} HUMContractionBuild;
+
+/**
+ *	Scratch memory for searching a hierarchy, which can be reused for any number of queries but only by one thread at a time.
+ */
+typedef struct HUMContractionSearch HUMContractionSearch;
+
+/**
+ *	A path found by HUMContractionSearchFindPath. Free it with HUMContractionPathFree.
+ */
+typedef struct {
+	int32_t *xs;				// every tile of the path, from the start tile to the target tile, both included
+	int32_t *ys;
+	int32_t count;
+	uint32_t cost;
+	int32_t nodesSettled;		// nodes taken off the open lists of both directions
+} HUMContractionPath;
+
+#define HUMContractionHierarchyMagic 0x48435548	// "HUCH"
+#define HUMContractionHierarchyVersion 1
+
+/**
+ *	The result of reading a serialized hierarchy.
+ */
+typedef enum {
+	HUMContractionHierarchyStatusOK = 0,
+	HUMContractionHierarchyStatusInvalid,				// not a contraction hierarchy, truncated, or inconsistent
+	HUMContractionHierarchyStatusUnsupportedVersion,
+	HUMContractionHierarchyStatusOutOfMemory
+} HUMContractionHierarchyStatus;
+
+/**
+ *	Contracts every walkable tile of a grid. Nodes are ordered mostly by their edge difference, the number of shortcuts contracting them
+ *  would add minus the number of edges it would remove, and also by how many of their neighbors are already contracted, so that
+ *  contraction spreads evenly over the map. Each round contracts every node that comes before all of its neighbors in that order. No two of them are neighbors, so
+ *  their shortcuts are found in parallel, with witness searches that avoid the whole round, and then added to the graph together. Only the
+ *  neighbors of contracted nodes have their order updated for the next round.
+ *
+ *	@return	The hierarchy, or NULL if scratch memory couldn't be allocated.
+ */
+HUMContractionHierarchy *HUMContractionHierarchyCreate(const HUMContractionBuild *build);
+void HUMContractionHierarchyFree(HUMContractionHierarchy *hierarchy);
+
+HUMContractionSearch *HUMContractionSearchCreate(const HUMContractionHierarchy *hierarchy);
+void HUMContractionSearchFree(HUMContractionSearch *search);
+
+/**
+ *	Finds a cheapest path between two tiles with a bidirectional Dijkstra search that only follows edges up the hierarchy, then unpacks every
+ *  shortcut on it into the moves it stands for. The target must be walkable. The start doesn't have to be, as long as a unit standing on it
+ *  could step off, as with HUMSearchFindPath. The path costs the same as the one HUMSearchFindPath finds with the same movement rules.
+ *
+ *	@param	path	Filled with the path if one is found. Must be freed with HUMContractionPathFree, whatever the result.
+ *
+ *	@return	true if a path was found.
+ */
+bool HUMContractionSearchFindPath(HUMContractionSearch *search, int32_t startX, int32_t startY, int32_t targetX, int32_t targetY, HUMContractionPath *path);
+void HUMContractionPathFree(HUMContractionPath *path);
+
+/**
+ *	Serializes a hierarchy, including the walkability and costs it was built from. The data starts with a header holding
+ *  HUMContractionHierarchyMagic and HUMContractionHierarchyVersion, and all values are little-endian.
+ *
+ *	@return	A malloc'd buffer the caller frees, or NULL if it couldn't be allocated.
+ */
+void *HUMContractionHierarchyCopyData(const HUMContractionHierarchy *hierarchy, size_t *size);
+
+/**
+ *	Reads a hierarchy serialized by HUMContractionHierarchyCopyData, checking that every index in it is in range and that every edge and
+ *  shortcut climbs the hierarchy, so unpacking a path always ends.
+ *
+ *	@return	The hierarchy, or NULL with the reason in status.
+ */
+HUMContractionHierarchy *HUMContractionHierarchyCreateWithData(const void *bytes, size_t size, HUMContractionHierarchyStatus *status);
+
+#endif
@@ -0,0 +1,66 @@
+//
+//  HUMAStarPathfinderContractionHierarchy.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HUMAStarPathfinder.h"
+#import "HUMAStarPathfinderContraction.h"
+
+/**
+ *	A contraction hierarchy of a static tile map, as built by -[HUMAStarPathfinder contractionHierarchy]. Every tile is ranked by how
+ *  important it is to the map's cheapest paths, and shortcuts stand in for the cheapest paths through the less important tiles. A search
+ *  from each end only climbs the ranks, settling a few hundred tiles, and the shortcuts on the path it finds are unpacked back into tiles.
+ *
+ *  The hierarchy never changes once built, so it can be searched from any number of threads at once. Build a new one when the map changes.
+ */
+@interface HUMAStarPathfinderContractionHierarchy : NSObject
+
+/**
+ *	Creates a contraction hierarchy that takes ownership of a hierarchy created with HUMContractionHierarchyCreate or
+ *  HUMContractionHierarchyCreateWithData. The hierarchy is freed when the contraction hierarchy is deallocated.
+ *
+ *	@param	tileSize	The size of each tile in points.
+ *	@param	origin		The coordinate system positions are given in.
+ *	@param	hierarchy	The hierarchy of the tile map.
+ */
+- (id)initWithTileSize:(CGSize)tileSize coordinateSystemOrigin:(HUMCoodinateSystemOrigin)origin hierarchyNoCopy:(HUMContractionHierarchy *)hierarchy;
+
+@property (nonatomic, readonly) CGSize tileMapSize;
+@property (nonatomic, readonly) CGSize tileSize;
+@property (nonatomic, readonly) HUMCoodinateSystemOrigin coordinateSystemOrigin;
+
+/**
+ *	The number of shortcuts and moves between neighboring tiles the hierarchy keeps, counting both search directions.
+ */
+@property (nonatomic, readonly) NSUInteger edgeCount;
+
+/**
+ *	The underlying hierarchy.
+ */
+@property (nonatomic, readonly) const HUMContractionHierarchy *hierarchy;
+
+/**
+ *	Serializes the hierarchy, along with the walkability and costs it was built from, so it can be built offline and read back with
+ *  -[HUMAStarPathfinder contractionHierarchyWithData:error:].
+ *
+ *	@return	The serialized hierarchy, or nil if it couldn't be allocated.
+ */
+- (NSData *)dataRepresentation;
+
+/**
+ *	Finds a cheapest path from the start point to the target point through the hierarchy.
+ *
+ *	@param	start	A CGPoint where the path should start.
+ *	@param	target	A CGPoint where the path should end.
+ *
+ *	@return	An NSArray of NSValue-wrapped CGPoints, starting with start and followed by the center of every tile after the start tile, as
+ *			returned by -[HUMAStarPathfinder findPathFromStart:toTarget:]. nil if the start and target are in the same tile, either is outside
+ *			the map, or the target isn't walkable. An empty array if there is no path between them.
+ */
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target;
+
+@end
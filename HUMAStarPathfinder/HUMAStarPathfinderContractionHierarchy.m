@@ -0,0 +1,156 @@
+//
+//  HUMAStarPathfinderContractionHierarchy.m
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import "HUMAStarPathfinderContractionHierarchy.h"
+
+@interface HUMAStarPathfinderContractionHierarchy ()
+@property (nonatomic, strong) NSMutableArray *searchPool;	// NSValue-wrapped HUMContractionSearch pointers not in use by a query
+@end
+
+@implementation HUMAStarPathfinderContractionHierarchy
+
+- (id)initWithTileSize:(CGSize)tileSize coordinateSystemOrigin:(HUMCoodinateSystemOrigin)origin hierarchyNoCopy:(HUMContractionHierarchy *)hierarchy {
+	NSParameterAssert(hierarchy);
+
+	self = [super init];
+	if (self) {
+		_tileMapSize = CGSizeMake(hierarchy->width, hierarchy->height);
+		_tileSize = tileSize;
+		_coordinateSystemOrigin = origin;
+		_hierarchy = hierarchy;
+		_searchPool = [NSMutableArray array];
+	}
+
+	return self;
+}
+
+- (void)dealloc {
+	for (NSValue *search in _searchPool) {
+		HUMContractionSearchFree([search pointerValue]);
+	}
+
+	HUMContractionHierarchyFree((HUMContractionHierarchy *)_hierarchy);
+}
+
+- (NSUInteger)edgeCount {
+	return (NSUInteger)_hierarchy->forwardCount + (NSUInteger)_hierarchy->backwardCount;
+}
+
+- (NSData *)dataRepresentation {
+	size_t size = 0;
+	void *bytes = HUMContractionHierarchyCopyData(_hierarchy, &size);
+
+	if (!bytes) {
+		return nil;
+	}
+
+	return [NSData dataWithBytesNoCopy:bytes length:size freeWhenDone:YES];
+}
+
+#pragma mark - Coordinates
+/**
+ *	Converts a position to the tile it lies in, where y grows downward from the top of the map.
+ */
+- (BOOL)getTileX:(int32_t *)x y:(int32_t *)y forPosition:(CGPoint)position {
+	CGFloat tileY = position.y / self.tileSize.height;
+
+	if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		tileY = self.tileMapSize.height - tileY;
+	}
+
+	CGFloat tileX = position.x / self.tileSize.width;
+
+	if (tileX < 0 || tileY < 0 || tileX >= self.tileMapSize.width || tileY >= self.tileMapSize.height) {
+		return NO;
+	}
+
+	*x = (int32_t)tileX;
+	*y = (int32_t)tileY;
+
+	return YES;
+}
+
+- (CGPoint)positionForTileX:(int32_t)x y:(int32_t)y {
+	CGFloat tileY = y + 0.5;
+
+	if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		tileY = self.tileMapSize.height - tileY;
+	}
+
+	return CGPointMake((x + 0.5) * self.tileSize.width, tileY * self.tileSize.height);
+}
+
+#pragma mark - Searches
+/**
+ *	Takes a search out of the pool, creating a new one if every pooled search is in use by another query.
+ *
+ *	@return	A search owned exclusively by the caller until it is returned with -enqueueSearch:, or NULL if it couldn't be allocated.
+ */
+- (HUMContractionSearch *)dequeueSearch {
+	HUMContractionSearch *search = NULL;
+
+	@synchronized(self.searchPool) {
+		search = [[self.searchPool lastObject] pointerValue];
+		if (search) {
+			[self.searchPool removeLastObject];
+		}
+	}
+
+	return search ? search : HUMContractionSearchCreate(_hierarchy);
+}
+
+- (void)enqueueSearch:(HUMContractionSearch *)search {
+	@synchronized(self.searchPool) {
+		[self.searchPool addObject:[NSValue valueWithPointer:search]];
+	}
+}
+
+#pragma mark - Queries
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target {
+	int32_t startX, startY, targetX, targetY;
+
+	if (![self getTileX:&startX y:&startY forPosition:start] || ![self getTileX:&targetX y:&targetY forPosition:target]) {
+		return nil;
+	}
+
+	if ((startX == targetX && startY == targetY) || !_hierarchy->walkable[targetY * _hierarchy->width + targetX]) {
+		return nil;
+	}
+
+	HUMContractionSearch *search = [self dequeueSearch];
+	if (!search) {
+		return nil;
+	}
+
+	HUMContractionPath path;
+	BOOL found = HUMContractionSearchFindPath(search, startX, startY, targetX, targetY, &path);
+	[self enqueueSearch:search];
+
+	if (!found) {
+		HUMContractionPathFree(&path);
+		return @[];
+	}
+
+	NSMutableArray *points = [NSMutableArray arrayWithCapacity:path.count];
+
+	// the first tile is the start tile, which is replaced by the exact start point
+	for (int32_t i = 0; i < path.count; i++) {
+		CGPoint position = i == 0 ? start : [self positionForTileX:path.xs[i] y:path.ys[i]];
+#if TARGET_OS_IPHONE
+		[points addObject:[NSValue valueWithCGPoint:position]];
+#else
+		[points addObject:[NSValue valueWithPoint:position]];
+#endif
+	}
+
+	HUMContractionPathFree(&path);
+
+	return [NSArray arrayWithArray:points];
+}
+
+@end
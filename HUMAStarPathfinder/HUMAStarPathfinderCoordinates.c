@@ -0,0 +1,58 @@
+//
+//  HUMAStarPathfinderCoordinates.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderCoordinates.h"
+
+#include <math.h>
+
+/**
+ *	Rounds toward zero like converting to an integer and back, which is what the single point methods do. Adding zero turns the -0 that
+ *  truncating a small negative value gives into 0.
+ */
+static inline HUMCoordinateFloat HUMCoordinateTruncate(HUMCoordinateFloat value) {
+#if HUMCoordinateFloatIsDouble
+	return trunc(value) + 0.0;
+#else
+	return truncf(value) + 0.0f;
+#endif
+}
+
+// The origin is folded into an offset and a direction for y, so both origins run the same loop without a branch per point, and the
+// compiler can vectorize it. The results are exact: 0 + y is y and h + -y is h - y.
+
+void HUMCoordinatesTileLocationsForPositions(const HUMCoordinateTransform *transform, const float *positions, float *tileLocations, size_t count) {
+	const HUMCoordinateFloat tileWidth = transform->tileWidth;
+	const HUMCoordinateFloat tileHeight = transform->tileHeight;
+	const HUMCoordinateFloat originY = transform->flipsY ? transform->mapHeight : 0;
+	const HUMCoordinateFloat directionY = transform->flipsY ? -1 : 1;
+
+	for (size_t i = 0; i < count; i++) {
+		HUMCoordinateFloat x = positions[2 * i];
+		HUMCoordinateFloat y = positions[2 * i + 1];
+
+		tileLocations[2 * i] = (float)HUMCoordinateTruncate(x / tileWidth);
+		tileLocations[2 * i + 1] = (float)HUMCoordinateTruncate((originY + directionY * y) / tileHeight);
+	}
+}
+
+void HUMCoordinatesPositionsForTileLocations(const HUMCoordinateTransform *transform, const float *tileLocations, float *positions, size_t count) {
+	const HUMCoordinateFloat tileWidth = transform->tileWidth;
+	const HUMCoordinateFloat tileHeight = transform->tileHeight;
+	const HUMCoordinateFloat halfTileWidth = tileWidth / 2.0f;
+	const HUMCoordinateFloat halfTileHeight = tileHeight / 2.0f;
+	const HUMCoordinateFloat originY = transform->flipsY ? transform->mapHeight : 0;
+	const HUMCoordinateFloat directionY = transform->flipsY ? -1 : 1;
+
+	for (size_t i = 0; i < count; i++) {
+		HUMCoordinateFloat x = tileLocations[2 * i];
+		HUMCoordinateFloat y = tileLocations[2 * i + 1];
+
+		positions[2 * i] = (float)((x * tileWidth) + halfTileWidth);
+		positions[2 * i + 1] = (float)((originY + directionY * (y * tileHeight)) + directionY * halfTileHeight);
+	}
+}
@@ -0,0 +1,50 @@
+//
+//  HUMAStarPathfinderCoordinates.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderCoordinates_h
+#define HUMAStarPathfinder_HUMAStarPathfinderCoordinates_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ *	The precision conversions are computed in. It matches CGFloat, which is a double on 64-bit platforms and a float otherwise, so a batch
+ *  conversion gives exactly the result of converting each point with the pathfinder's single point methods.
+ */
+#if defined(__LP64__) && __LP64__
+typedef double HUMCoordinateFloat;
+#define HUMCoordinateFloatIsDouble 1
+#else
+typedef float HUMCoordinateFloat;
+#define HUMCoordinateFloatIsDouble 0
+#endif
+
+typedef struct {
+	HUMCoordinateFloat tileWidth;
+	HUMCoordinateFloat tileHeight;
+	HUMCoordinateFloat mapHeight;	// the height of the map in points, tileMapSize.height * tileSize.height
+	bool flipsY;					// positions are relative to the bottom-left, so y grows upward
+} HUMCoordinateTransform;
+
+/**
+ *	Converts positions to the locations of the tiles holding them.
+ *
+ *	@param	positions		count x, y pairs.
+ *	@param	tileLocations	Filled with count x, y pairs of whole tile coordinates. May be the same buffer as positions.
+ */
+void HUMCoordinatesTileLocationsForPositions(const HUMCoordinateTransform *transform, const float *positions, float *tileLocations, size_t count);
+
+/**
+ *	Converts tile locations to the positions of the centers of the tiles.
+ *
+ *	@param	tileLocations	count x, y pairs.
+ *	@param	positions		Filled with count x, y pairs. May be the same buffer as tileLocations.
+ */
+void HUMCoordinatesPositionsForTileLocations(const HUMCoordinateTransform *transform, const float *tileLocations, float *positions, size_t count);
+
+#endif
@@ -0,0 +1,206 @@
+//
+//  HUMAStarPathfinderCostLayers.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderCostLayers.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#pragma mark - Row Kernels
+// simple loops over restrict-qualified rows, so they are vectorized by the compiler
+
+static void HUMCostLayersRowScale(float *restrict destination, const float *restrict source, float factor, int32_t count) {
+	for (int32_t i = 0; i < count; i++) {
+		destination[i] = source[i] * factor;
+	}
+}
+
+static void HUMCostLayersRowAddScaled(float *restrict destination, const float *restrict source, float factor, int32_t count) {
+	for (int32_t i = 0; i < count; i++) {
+		destination[i] += source[i] * factor;
+	}
+}
+
+static void HUMCostLayersRowMultiplyAdd(float *restrict values, float factor, float offset, int32_t count) {
+	for (int32_t i = 0; i < count; i++) {
+		values[i] = values[i] * factor + offset;
+	}
+}
+
+#pragma mark - Combining
+/**
+ *	Recomputes the weighted sum of every layer for a contiguous span of tiles. Each tile is summed from scratch rather than adjusted by a
+ *  difference, so rounding errors can't build up over many updates.
+ */
+static void HUMCostLayersCombineSpan(HUMCostLayers *costLayers, size_t offset, int32_t count) {
+	float *combined = costLayers->combined + offset;
+	const HUMCostLayer *layers = costLayers->layers;
+
+	if (costLayers->layerCount == 0) {
+		memset(combined, 0, (size_t)count * sizeof(float));
+		return;
+	}
+
+	HUMCostLayersRowScale(combined, layers[0].values + offset, layers[0].weight, count);
+
+	for (int32_t i = 1; i < costLayers->layerCount; i++) {
+		HUMCostLayersRowAddScaled(combined, layers[i].values + offset, layers[i].weight, count);
+	}
+}
+
+static void HUMCostLayersCombine(HUMCostLayers *costLayers, int32_t x, int32_t y, int32_t width, int32_t height) {
+	for (int32_t row = y; row < y + height; row++) {
+		HUMCostLayersCombineSpan(costLayers, (size_t)row * costLayers->width + x, width);
+	}
+}
+
+static void HUMCostLayersCombineAll(HUMCostLayers *costLayers) {
+	HUMCostLayersCombineSpan(costLayers, 0, costLayers->width * costLayers->height);
+}
+
+/**
+ *	Clips a rect to the map.
+ *
+ *	@return	false if nothing is left of it.
+ */
+static int HUMCostLayersClip(const HUMCostLayers *costLayers, int32_t *x, int32_t *y, int32_t *width, int32_t *height) {
+	int32_t minX = *x < 0 ? 0 : *x;
+	int32_t minY = *y < 0 ? 0 : *y;
+	int32_t maxX = *x + *width > costLayers->width ? costLayers->width : *x + *width;
+	int32_t maxY = *y + *height > costLayers->height ? costLayers->height : *y + *height;
+
+	if (minX >= maxX || minY >= maxY) {
+		return 0;
+	}
+
+	*x = minX;
+	*y = minY;
+	*width = maxX - minX;
+	*height = maxY - minY;
+
+	return 1;
+}
+
+#pragma mark - Layers
+HUMCostLayers *HUMCostLayersCreate(int32_t width, int32_t height) {
+	HUMCostLayers *costLayers = calloc(1, sizeof(HUMCostLayers));
+	if (!costLayers) {
+		return NULL;
+	}
+
+	costLayers->width = width;
+	costLayers->height = height;
+	costLayers->combined = calloc((size_t)width * (size_t)height, sizeof(float));
+
+	if (!costLayers->combined) {
+		HUMCostLayersFree(costLayers);
+		return NULL;
+	}
+
+	return costLayers;
+}
+
+void HUMCostLayersFree(HUMCostLayers *costLayers) {
+	if (!costLayers) {
+		return;
+	}
+
+	for (int32_t i = 0; i < costLayers->layerCount; i++) {
+		free(costLayers->layers[i].values);
+	}
+
+	free(costLayers->layers);
+	free(costLayers->combined);
+	free(costLayers);
+}
+
+int32_t HUMCostLayersAdd(HUMCostLayers *costLayers, float weight) {
+	if (costLayers->layerCount == costLayers->layerCapacity) {
+		int32_t capacity = costLayers->layerCapacity ? costLayers->layerCapacity * 2 : 4;
+		HUMCostLayer *layers = realloc(costLayers->layers, (size_t)capacity * sizeof(HUMCostLayer));
+		if (!layers) {
+			return -1;
+		}
+
+		costLayers->layers = layers;
+		costLayers->layerCapacity = capacity;
+	}
+
+	float *values = calloc((size_t)costLayers->width * (size_t)costLayers->height, sizeof(float));
+	if (!values) {
+		return -1;
+	}
+
+	// a layer of zeros doesn't change the combined costs
+	int32_t index = costLayers->layerCount++;
+	costLayers->layers[index].values = values;
+	costLayers->layers[index].weight = weight;
+
+	return index;
+}
+
+void HUMCostLayersRemove(HUMCostLayers *costLayers, int32_t index) {
+	if (index < 0 || index >= costLayers->layerCount) {
+		return;
+	}
+
+	free(costLayers->layers[index].values);
+	memmove(costLayers->layers + index, costLayers->layers + index + 1, (size_t)(costLayers->layerCount - index - 1) * sizeof(HUMCostLayer));
+	costLayers->layerCount--;
+
+	HUMCostLayersCombineAll(costLayers);
+}
+
+void HUMCostLayersSetWeight(HUMCostLayers *costLayers, int32_t index, float weight) {
+	if (index < 0 || index >= costLayers->layerCount || costLayers->layers[index].weight == weight) {
+		return;
+	}
+
+	costLayers->layers[index].weight = weight;
+	HUMCostLayersCombineAll(costLayers);
+}
+
+void HUMCostLayersSetValues(HUMCostLayers *costLayers, int32_t index, int32_t x, int32_t y, int32_t width, int32_t height, const float *values) {
+	int32_t clippedX = x, clippedY = y, clippedWidth = width, clippedHeight = height;
+
+	if (index < 0 || index >= costLayers->layerCount || !HUMCostLayersClip(costLayers, &clippedX, &clippedY, &clippedWidth, &clippedHeight)) {
+		return;
+	}
+
+	float *layerValues = costLayers->layers[index].values;
+	for (int32_t row = clippedY; row < clippedY + clippedHeight; row++) {
+		memcpy(layerValues + (size_t)row * costLayers->width + clippedX, values + (size_t)(row - y) * width + (clippedX - x), (size_t)clippedWidth * sizeof(float));
+	}
+
+	HUMCostLayersCombine(costLayers, clippedX, clippedY, clippedWidth, clippedHeight);
+}
+
+void HUMCostLayersFill(HUMCostLayers *costLayers, int32_t index, int32_t x, int32_t y, int32_t width, int32_t height, float value) {
+	if (index < 0 || index >= costLayers->layerCount || !HUMCostLayersClip(costLayers, &x, &y, &width, &height)) {
+		return;
+	}
+
+	float *layerValues = costLayers->layers[index].values;
+	for (int32_t row = y; row < y + height; row++) {
+		float *rowValues = layerValues + (size_t)row * costLayers->width + x;
+		for (int32_t column = 0; column < width; column++) {
+			rowValues[column] = value;
+		}
+	}
+
+	HUMCostLayersCombine(costLayers, x, y, width, height);
+}
+
+void HUMCostLayersScale(HUMCostLayers *costLayers, int32_t index, float factor, float offset) {
+	if (index < 0 || index >= costLayers->layerCount) {
+		return;
+	}
+
+	HUMCostLayersRowMultiplyAdd(costLayers->layers[index].values, factor, offset, costLayers->width * costLayers->height);
+	HUMCostLayersCombineAll(costLayers);
+}
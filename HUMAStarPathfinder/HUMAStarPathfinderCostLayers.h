@@ -0,0 +1,85 @@
+//
+//  HUMAStarPathfinderCostLayers.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderCostLayers_h
+#define HUMAStarPathfinder_HUMAStarPathfinderCostLayers_h
+
+#include <stdint.h>
+
+/**
+ *	A dense, row-major grid of per-tile values and the weight they are added to tile costs with.
+ */
+typedef struct {
+	float *values;
+	float weight;
+} HUMCostLayer;
+
+/**
+ *	A stack of cost layers and the weighted sum of all of them, which is kept up to date as layers change so a search only reads one value
+ *  per tile no matter how many layers there are.
+ */
+typedef struct {
+	int32_t width;
+	int32_t height;
+	int32_t layerCount;
+	int32_t layerCapacity;
+	HUMCostLayer *layers;
+	float *combined;
+} HUMCostLayers;
+
+HUMCostLayers *HUMCostLayersCreate(int32_t width, int32_t height);
+void HUMCostLayersFree(HUMCostLayers *costLayers);
+
+/**
+ *	Adds a layer with every value set to 0.
+ *
+ *	@return	The index of the new layer, or -1 if it couldn't be allocated.
+ */
+int32_t HUMCostLayersAdd(HUMCostLayers *costLayers, float weight);
+
+/**
+ *	Removes a layer. Layers after it move down one index.
+ */
+void HUMCostLayersRemove(HUMCostLayers *costLayers, int32_t index);
+
+void HUMCostLayersSetWeight(HUMCostLayers *costLayers, int32_t index, float weight);
+
+/**
+ *	Replaces the values of a rect of a layer.
+ *
+ *	@param	values	The new values, row-major, width * height entries.
+ */
+void HUMCostLayersSetValues(HUMCostLayers *costLayers, int32_t index, int32_t x, int32_t y, int32_t width, int32_t height, const float *values);
+
+/**
+ *	Sets every value in a rect of a layer to the same value.
+ */
+void HUMCostLayersFill(HUMCostLayers *costLayers, int32_t index, int32_t x, int32_t y, int32_t width, int32_t height, float value);
+
+/**
+ *	Multiplies every value of a layer by factor and then adds offset, for example to decay a threat map a little every frame.
+ */
+void HUMCostLayersScale(HUMCostLayers *costLayers, int32_t index, float factor, float offset);
+
+/**
+ *	Adds the weighted layers to a tile's cost, rounded to the nearest integer and clamped to 0.
+ */
+static inline uint32_t HUMCostLayersApply(const HUMCostLayers *costLayers, int32_t x, int32_t y, uint32_t cost) {
+	float combinedCost = (float)cost + costLayers->combined[y * costLayers->width + x];
+
+	if (combinedCost <= 0.0f) {
+		return 0;
+	}
+	else if (combinedCost >= 4294967040.0f) {	// the largest float below UINT32_MAX
+		return UINT32_MAX;
+	}
+
+	return (uint32_t)(combinedCost + 0.5f);
+}
+
+#endif
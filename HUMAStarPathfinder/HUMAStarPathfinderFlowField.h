@@ -0,0 +1,60 @@
+//
+//  HUMAStarPathfinderFlowField.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *	The cost of the cheapest path from every tile to a target tile, and the first move of that path, as found by
+ *  -[HUMAStarPathfinder flowFieldToTile:]. Any number of units can follow the field to the target without running a search of their own.
+ *  Tile indexes are row-major: y * tileMapSize.width + x.
+ */
+@interface HUMAStarPathfinderFlowField : NSObject
+
+/**
+ *	Creates a flow field that takes ownership of buffers allocated with malloc. The buffers are freed when the flow field is deallocated.
+ *
+ *	@param	tileMapSize		The size of the tile map the buffers cover.
+ *	@param	target			The tile location every path leads to.
+ *	@param	integration		The cost from every tile to the target, or UINT32_MAX.
+ *	@param	directions		The index of the first move from every tile into HUMFlowFieldDirectionX and HUMFlowFieldDirectionY, or -1.
+ */
+- (id)initWithTileMapSize:(CGSize)tileMapSize targetTileLocation:(CGPoint)target integrationNoCopy:(uint32_t *)integration directionsNoCopy:(int8_t *)directions;
+
+@property (nonatomic, readonly) CGSize tileMapSize;
+@property (nonatomic, readonly) CGPoint targetTileLocation;
+
+/**
+ *	The integration field: the cost of the cheapest path from every tile to the target, or UINT32_MAX if the tile can't reach it.
+ */
+@property (nonatomic, readonly) const uint32_t *integration;
+
+/**
+ *	The direction field: the index of the first move of the cheapest path from every tile, in the order N, E, S, W, NE, SE, SW, NW, where N
+ *  is toward a lower y. -1 for the target and tiles that can't reach it.
+ */
+@property (nonatomic, readonly) const int8_t *directions;
+
+/**
+ *	The cost of the cheapest path from a tile to the target.
+ *
+ *	@param	tileLocation	The tile location in question.
+ *
+ *	@return	The cost, or NSNotFound if the tile is outside the tile map or can't reach the target.
+ */
+- (NSUInteger)costFromTileLocation:(CGPoint)tileLocation;
+
+/**
+ *	The next tile on the cheapest path from a tile to the target.
+ *
+ *	@param	tileLocation	The tile location in question.
+ *
+ *	@return	The next tile location, or tileLocation itself if it is the target, is outside the tile map, or can't reach the target.
+ */
+- (CGPoint)nextTileLocationFromTileLocation:(CGPoint)tileLocation;
+
+@end
@@ -0,0 +1,68 @@
+//
+//  HUMAStarPathfinderFlowField.m
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import "HUMAStarPathfinderFlowField.h"
+#import "HUMAStarPathfinderFlowFieldSolver.h"
+
+@implementation HUMAStarPathfinderFlowField
+
+- (id)initWithTileMapSize:(CGSize)tileMapSize targetTileLocation:(CGPoint)target integrationNoCopy:(uint32_t *)integration directionsNoCopy:(int8_t *)directions {
+	NSParameterAssert(integration);
+	NSParameterAssert(directions);
+	
+	self = [super init];
+	if (self) {
+		_tileMapSize = tileMapSize;
+		_targetTileLocation = target;
+		_integration = integration;
+		_directions = directions;
+	}
+	
+	return self;
+}
+
+- (void)dealloc {
+	free((void *)_integration);
+	free((void *)_directions);
+}
+
+/**
+ *	Converts a tile location to a tile index.
+ *
+ *	@return	The tile index, or -1 if the tile location is outside the tile map.
+ */
+- (NSInteger)indexForTileLocation:(CGPoint)tileLocation {
+	if (tileLocation.x < 0 || tileLocation.y < 0 || tileLocation.x >= self.tileMapSize.width || tileLocation.y >= self.tileMapSize.height) {
+		return -1;
+	}
+	
+	return (NSInteger)tileLocation.y * (NSInteger)self.tileMapSize.width + (NSInteger)tileLocation.x;
+}
+
+- (NSUInteger)costFromTileLocation:(CGPoint)tileLocation {
+	NSInteger index = [self indexForTileLocation:tileLocation];
+	
+	if (index == -1 || _integration[index] == UINT32_MAX) {
+		return NSNotFound;
+	}
+	
+	return _integration[index];
+}
+
+- (CGPoint)nextTileLocationFromTileLocation:(CGPoint)tileLocation {
+	NSInteger index = [self indexForTileLocation:tileLocation];
+	
+	if (index == -1 || _directions[index] == HUMFlowFieldDirectionNone) {
+		return tileLocation;
+	}
+	
+	int8_t direction = _directions[index];
+	return CGPointMake(tileLocation.x + HUMFlowFieldDirectionX[direction], tileLocation.y + HUMFlowFieldDirectionY[direction]);
+}
+
+@end
@@ -0,0 +1,500 @@
+//
+//  HUMAStarPathfinderFlowFieldSolver.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderFlowFieldSolver.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+const int8_t HUMFlowFieldDirectionX[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+const int8_t HUMFlowFieldDirectionY[8] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+
+#pragma mark - Moves
+static inline bool HUMFlowFieldIsWalkable(const HUMFlowFieldQuery *query, int32_t x, int32_t y) {
+	return x >= 0 && y >= 0 && x < query->width && y < query->height && query->walkable[y * query->width + x];
+}
+
+static inline int32_t HUMFlowFieldDirectionCount(const HUMFlowFieldQuery *query) {
+	return query->neighbors == HUMSearchNeighborsCardinal ? 4 : 8;
+}
+
+/**
+ *	Determines if a unit on tile (x, y) can move in a direction, following the same diagonal rules as the search.
+ */
+static inline bool HUMFlowFieldCanMove(const HUMFlowFieldQuery *query, int32_t x, int32_t y, int32_t direction) {
+	int32_t directionX = HUMFlowFieldDirectionX[direction];
+	int32_t directionY = HUMFlowFieldDirectionY[direction];
+
+	if (!HUMFlowFieldIsWalkable(query, x + directionX, y + directionY)) {
+		return false;
+	}
+
+	if (direction < 4 || query->neighbors == HUMSearchNeighborsDiagonal) {
+		return true;
+	}
+
+	bool horizontal = HUMFlowFieldIsWalkable(query, x + directionX, y);
+	bool vertical = HUMFlowFieldIsWalkable(query, x, y + directionY);
+
+	return query->neighbors == HUMSearchNeighborsDiagonalCrossBorders ? (horizontal || vertical) : (horizontal && vertical);
+}
+
+/**
+ *	The cost of moving in a direction onto a tile, which is that tile's entry cost.
+ */
+static inline uint64_t HUMFlowFieldMoveCost(const HUMFlowFieldQuery *query, int32_t tile, int32_t direction) {
+	uint32_t cost = query->costs[tile];
+	return direction < 4 ? cost : HUMSearchDiagonalCost(cost);
+}
+
+#pragma mark - Open List
+typedef struct {
+	uint32_t key;
+	int32_t item;
+} HUMFlowFieldHeapEntry;
+
+typedef struct {
+	HUMFlowFieldHeapEntry *entries;
+	int32_t *positions;	// indexed by item, -1 when the item isn't in the heap
+	int32_t count;
+} HUMFlowFieldHeap;
+
+static void HUMFlowFieldHeapSiftUp(HUMFlowFieldHeap *heap, int32_t index) {
+	HUMFlowFieldHeapEntry entry = heap->entries[index];
+
+	while (index > 0) {
+		int32_t parentIndex = (index - 1) >> 1;
+		if (heap->entries[parentIndex].key <= entry.key) {
+			break;
+		}
+
+		heap->entries[index] = heap->entries[parentIndex];
+		heap->positions[heap->entries[index].item] = index;
+		index = parentIndex;
+	}
+
+	heap->entries[index] = entry;
+	heap->positions[entry.item] = index;
+}
+
+static void HUMFlowFieldHeapUpdate(HUMFlowFieldHeap *heap, int32_t item, uint32_t key) {
+	int32_t index = heap->positions[item];
+
+	if (index == -1) {
+		index = heap->count++;
+	}
+
+	heap->entries[index].key = key;
+	heap->entries[index].item = item;
+	HUMFlowFieldHeapSiftUp(heap, index);
+}
+
+static int32_t HUMFlowFieldHeapPop(HUMFlowFieldHeap *heap) {
+	int32_t item = heap->entries[0].item;
+	heap->positions[item] = -1;
+
+	if (--heap->count > 0) {
+		HUMFlowFieldHeapEntry entry = heap->entries[heap->count];
+		int32_t index = 0;
+
+		while (1) {
+			int32_t child = (index << 1) + 1;
+			if (child >= heap->count) {
+				break;
+			}
+
+			if (child + 1 < heap->count && heap->entries[child + 1].key < heap->entries[child].key) {
+				child++;
+			}
+
+			if (entry.key <= heap->entries[child].key) {
+				break;
+			}
+
+			heap->entries[index] = heap->entries[child];
+			heap->positions[heap->entries[index].item] = index;
+			index = child;
+		}
+
+		heap->entries[index] = entry;
+		heap->positions[entry.item] = index;
+	}
+
+	return item;
+}
+
+#pragma mark - Directions
+typedef struct {
+	const HUMFlowFieldQuery *query;
+	const uint32_t *integration;
+	int8_t *directions;
+} HUMFlowFieldDirectionState;
+
+/**
+ *	Picks the first move of the cheapest path from every tile in a band of rows. Only depends on the integration field, so the direction
+ *  field is the same however the integration field was computed.
+ */
+static void HUMFlowFieldComputeDirections(void *context, size_t iteration) {
+	HUMFlowFieldDirectionState *state = context;
+	const HUMFlowFieldQuery *query = state->query;
+	const uint32_t *integration = state->integration;
+	int32_t width = query->width;
+	int32_t directionCount = HUMFlowFieldDirectionCount(query);
+	int32_t minY = (int32_t)iteration * HUMFlowFieldBlockSize;
+	int32_t maxY = minY + HUMFlowFieldBlockSize < query->height ? minY + HUMFlowFieldBlockSize : query->height;
+
+	for (int32_t y = minY; y < maxY; y++) {
+		for (int32_t x = 0; x < width; x++) {
+			int32_t tile = y * width + x;
+			int8_t bestDirection = HUMFlowFieldDirectionNone;
+			uint64_t bestCost = UINT32_MAX;
+
+			if (x != query->targetX || y != query->targetY) {
+				for (int32_t direction = 0; direction < directionCount; direction++) {
+					if (!HUMFlowFieldCanMove(query, x, y, direction)) {
+						continue;
+					}
+
+					int32_t neighbor = tile + HUMFlowFieldDirectionY[direction] * width + HUMFlowFieldDirectionX[direction];
+					if (integration[neighbor] == UINT32_MAX) {
+						continue;
+					}
+
+					uint64_t cost = integration[neighbor] + HUMFlowFieldMoveCost(query, neighbor, direction);
+					if (cost < bestCost) {
+						bestCost = cost;
+						bestDirection = (int8_t)direction;
+					}
+				}
+			}
+
+			state->directions[tile] = bestDirection;
+		}
+	}
+}
+
+static void HUMFlowFieldApply(const HUMFlowFieldQuery *query, size_t iterations, void *context, void (*work)(void *context, size_t iteration)) {
+	if (query->apply) {
+		query->apply(query->applyInfo, iterations, context, work);
+		return;
+	}
+
+	for (size_t i = 0; i < iterations; i++) {
+		work(context, i);
+	}
+}
+
+static void HUMFlowFieldSolveDirections(const HUMFlowFieldQuery *query, const uint32_t *integration, int8_t *directions) {
+	if (!directions) {
+		return;
+	}
+
+	HUMFlowFieldDirectionState state = { query, integration, directions };
+	size_t bands = (size_t)(query->height + HUMFlowFieldBlockSize - 1) / HUMFlowFieldBlockSize;
+
+	HUMFlowFieldApply(query, bands, &state, HUMFlowFieldComputeDirections);
+}
+
+#pragma mark - Blocks
+typedef struct {
+	const HUMFlowFieldQuery *query;
+	uint32_t *integration;
+	uint32_t *pending;		// per block, the smallest improved value along its edge since it was last solved, or UINT32_MAX
+	int32_t blockColumns;
+	const int32_t *phaseBlocks;
+} HUMFlowFieldBlockState;
+
+/**
+ *	Lowers a block's pending value. Called concurrently by the blocks around it.
+ */
+static inline void HUMFlowFieldMarkPending(uint32_t *pending, uint32_t value) {
+	uint32_t current = __atomic_load_n(pending, __ATOMIC_RELAXED);
+
+	while (value < current && !__atomic_compare_exchange_n(pending, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+	}
+}
+
+/**
+ *	Solves one block exactly given the current values around it: seeds every tile on its edge from the tiles just outside, then runs a
+ *  Dijkstra search confined to the block. Marks the neighboring blocks pending wherever a value along the edge improved.
+ */
+static void HUMFlowFieldSolveBlock(void *context, size_t iteration) {
+	HUMFlowFieldBlockState *state = context;
+	const HUMFlowFieldQuery *query = state->query;
+	uint32_t *integration = state->integration;
+	int32_t width = query->width;
+	int32_t height = query->height;
+	int32_t directionCount = HUMFlowFieldDirectionCount(query);
+
+	int32_t block = state->phaseBlocks[iteration];
+	int32_t minX = (block % state->blockColumns) * HUMFlowFieldBlockSize;
+	int32_t minY = (block / state->blockColumns) * HUMFlowFieldBlockSize;
+	int32_t maxX = minX + HUMFlowFieldBlockSize < width ? minX + HUMFlowFieldBlockSize : width;
+	int32_t maxY = minY + HUMFlowFieldBlockSize < height ? minY + HUMFlowFieldBlockSize : height;
+	int32_t blockWidth = maxX - minX;
+
+	HUMFlowFieldHeapEntry entries[HUMFlowFieldBlockSize * HUMFlowFieldBlockSize];
+	int32_t positions[HUMFlowFieldBlockSize * HUMFlowFieldBlockSize];
+	uint8_t improved[HUMFlowFieldBlockSize * HUMFlowFieldBlockSize];
+	HUMFlowFieldHeap heap = { entries, positions, 0 };
+
+	memset(positions, 0xff, sizeof(positions));
+	memset(improved, 0, sizeof(improved));
+
+	// 1) seed the edge from the tiles around the block
+	for (int32_t y = minY; y < maxY; y++) {
+		for (int32_t x = minX; x < maxX; x++) {
+			bool isTarget = (x == query->targetX && y == query->targetY);
+			if (!isTarget && x > minX && x < maxX - 1 && y > minY && y < maxY - 1) {
+				continue;
+			}
+
+			int32_t tile = y * width + x;
+			uint64_t best = isTarget ? 0 : integration[tile];
+
+			for (int32_t direction = 0; direction < directionCount; direction++) {
+				int32_t neighborX = x + HUMFlowFieldDirectionX[direction];
+				int32_t neighborY = y + HUMFlowFieldDirectionY[direction];
+
+				if (neighborX >= minX && neighborX < maxX && neighborY >= minY && neighborY < maxY) {
+					continue;
+				}
+
+				if (!HUMFlowFieldCanMove(query, x, y, direction)) {
+					continue;
+				}
+
+				int32_t neighbor = neighborY * width + neighborX;
+				if (integration[neighbor] != UINT32_MAX) {
+					uint64_t cost = integration[neighbor] + HUMFlowFieldMoveCost(query, neighbor, direction);
+					best = cost < best ? cost : best;
+				}
+			}
+
+			if (best < integration[tile]) {
+				int32_t local = (y - minY) * blockWidth + (x - minX);
+				integration[tile] = (uint32_t)best;
+				improved[local] = 1;
+				HUMFlowFieldHeapUpdate(&heap, local, (uint32_t)best);
+			}
+		}
+	}
+
+	// 2) spread the improvements through the block
+	while (heap.count > 0) {
+		int32_t local = HUMFlowFieldHeapPop(&heap);
+		int32_t x = minX + local % blockWidth;
+		int32_t y = minY + local / blockWidth;
+		int32_t tile = y * width + x;
+
+		// units can step off a tile that isn't walkable, but never onto one
+		if (!query->walkable[tile]) {
+			continue;
+		}
+
+		for (int32_t direction = 0; direction < directionCount; direction++) {
+			int32_t fromX = x - HUMFlowFieldDirectionX[direction];
+			int32_t fromY = y - HUMFlowFieldDirectionY[direction];
+
+			if (fromX < minX || fromX >= maxX || fromY < minY || fromY >= maxY || !HUMFlowFieldCanMove(query, fromX, fromY, direction)) {
+				continue;
+			}
+
+			int32_t from = fromY * width + fromX;
+			uint64_t cost = integration[tile] + HUMFlowFieldMoveCost(query, tile, direction);
+
+			if (cost < integration[from]) {
+				int32_t fromLocal = (fromY - minY) * blockWidth + (fromX - minX);
+				integration[from] = (uint32_t)cost;
+				improved[fromLocal] = 1;
+				HUMFlowFieldHeapUpdate(&heap, fromLocal, (uint32_t)cost);
+			}
+		}
+	}
+
+	// 3) blocks next to an improved, walkable edge tile have to be solved again
+	for (int32_t y = minY; y < maxY; y++) {
+		for (int32_t x = minX; x < maxX; x++) {
+			if (x > minX && x < maxX - 1 && y > minY && y < maxY - 1) {
+				continue;
+			}
+
+			if (!improved[(y - minY) * blockWidth + (x - minX)] || !query->walkable[y * width + x]) {
+				continue;
+			}
+
+			for (int32_t direction = 0; direction < directionCount; direction++) {
+				int32_t neighborX = x + HUMFlowFieldDirectionX[direction];
+				int32_t neighborY = y + HUMFlowFieldDirectionY[direction];
+
+				if (neighborX < 0 || neighborY < 0 || neighborX >= width || neighborY >= height) {
+					continue;
+				}
+
+				if (neighborX >= minX && neighborX < maxX && neighborY >= minY && neighborY < maxY) {
+					continue;
+				}
+
+				int32_t neighborBlock = (neighborY / HUMFlowFieldBlockSize) * state->blockColumns + neighborX / HUMFlowFieldBlockSize;
+				HUMFlowFieldMarkPending(&state->pending[neighborBlock], integration[y * width + x]);
+			}
+		}
+	}
+}
+
+#pragma mark - Solving
+/**
+ *	The width of the band of pending values solved in each round: roughly the cost of crossing a block. Solving blocks far beyond the nearest
+ *  pending value would only have them solved again once cheaper values arrive, while a narrower band leaves fewer blocks to run in parallel.
+ */
+static uint32_t HUMFlowFieldBandWidth(const HUMFlowFieldQuery *query) {
+	size_t tileCount = (size_t)query->width * (size_t)query->height;
+	uint64_t totalCost = 0;
+	size_t walkableCount = 0;
+
+	for (size_t i = 0; i < tileCount; i++) {
+		if (query->walkable[i]) {
+			totalCost += query->costs[i];
+			walkableCount++;
+		}
+	}
+
+	uint64_t averageCost = walkableCount ? totalCost / walkableCount : 1;
+	uint64_t bandWidth = (averageCost ? averageCost : 1) * HUMFlowFieldBlockSize;
+
+	return bandWidth < UINT32_MAX ? (uint32_t)bandWidth : UINT32_MAX;
+}
+
+bool HUMFlowFieldSolve(const HUMFlowFieldQuery *query, uint32_t *integration, int8_t *directions) {
+	int32_t blockColumns = (query->width + HUMFlowFieldBlockSize - 1) / HUMFlowFieldBlockSize;
+	int32_t blockRows = (query->height + HUMFlowFieldBlockSize - 1) / HUMFlowFieldBlockSize;
+	int32_t blockCount = blockColumns * blockRows;
+
+	uint32_t *pending = malloc((size_t)blockCount * sizeof(uint32_t));
+	int32_t *phaseBlocks = malloc((size_t)blockCount * sizeof(int32_t));
+
+	if (!pending || !phaseBlocks) {
+		free(pending);
+		free(phaseBlocks);
+		return false;
+	}
+
+	size_t tileCount = (size_t)query->width * (size_t)query->height;
+	for (size_t i = 0; i < tileCount; i++) {
+		integration[i] = UINT32_MAX;
+	}
+
+	for (int32_t i = 0; i < blockCount; i++) {
+		pending[i] = UINT32_MAX;
+	}
+
+	pending[(query->targetY / HUMFlowFieldBlockSize) * blockColumns + query->targetX / HUMFlowFieldBlockSize] = 0;
+
+	HUMFlowFieldBlockState state = { query, integration, pending, blockColumns, phaseBlocks };
+	uint32_t bandWidth = HUMFlowFieldBandWidth(query);
+
+	while (1) {
+		// like Dijkstra, solve the blocks nearest the target first, a band at a time, so most blocks are final the first time they are solved
+		uint32_t smallestPending = UINT32_MAX;
+		for (int32_t i = 0; i < blockCount; i++) {
+			smallestPending = pending[i] < smallestPending ? pending[i] : smallestPending;
+		}
+
+		if (smallestPending == UINT32_MAX) {
+			break;
+		}
+
+		uint32_t threshold = smallestPending < UINT32_MAX - bandWidth ? smallestPending + bandWidth : UINT32_MAX - 1;
+
+		// blocks of the same phase never touch, not even at a corner, so each one only reads values no other thread is writing
+		for (int32_t phase = 0; phase < 4; phase++) {
+			int32_t count = 0;
+
+			for (int32_t blockY = phase >> 1; blockY < blockRows; blockY += 2) {
+				for (int32_t blockX = phase & 1; blockX < blockColumns; blockX += 2) {
+					int32_t block = blockY * blockColumns + blockX;
+					if (pending[block] <= threshold) {
+						pending[block] = UINT32_MAX;
+						phaseBlocks[count++] = block;
+					}
+				}
+			}
+
+			if (count > 0) {
+				HUMFlowFieldApply(query, (size_t)count, &state, HUMFlowFieldSolveBlock);
+			}
+		}
+	}
+
+	free(pending);
+	free(phaseBlocks);
+
+	HUMFlowFieldSolveDirections(query, integration, directions);
+
+	return true;
+}
+
+bool HUMFlowFieldSolveSequential(const HUMFlowFieldQuery *query, uint32_t *integration, int8_t *directions) {
+	int32_t width = query->width;
+	int32_t directionCount = HUMFlowFieldDirectionCount(query);
+	size_t tileCount = (size_t)width * (size_t)query->height;
+
+	HUMFlowFieldHeap heap;
+	heap.entries = malloc(tileCount * sizeof(HUMFlowFieldHeapEntry));
+	heap.positions = malloc(tileCount * sizeof(int32_t));
+	heap.count = 0;
+
+	if (!heap.entries || !heap.positions) {
+		free(heap.entries);
+		free(heap.positions);
+		return false;
+	}
+
+	memset(heap.positions, 0xff, tileCount * sizeof(int32_t));
+	for (size_t i = 0; i < tileCount; i++) {
+		integration[i] = UINT32_MAX;
+	}
+
+	int32_t target = query->targetY * width + query->targetX;
+	integration[target] = 0;
+	HUMFlowFieldHeapUpdate(&heap, target, 0);
+
+	while (heap.count > 0) {
+		int32_t tile = HUMFlowFieldHeapPop(&heap);
+		int32_t x = tile % width;
+		int32_t y = tile / width;
+
+		if (!query->walkable[tile]) {
+			continue;
+		}
+
+		for (int32_t direction = 0; direction < directionCount; direction++) {
+			int32_t fromX = x - HUMFlowFieldDirectionX[direction];
+			int32_t fromY = y - HUMFlowFieldDirectionY[direction];
+
+			if (fromX < 0 || fromY < 0 || fromX >= width || fromY >= query->height || !HUMFlowFieldCanMove(query, fromX, fromY, direction)) {
+				continue;
+			}
+
+			int32_t from = fromY * width + fromX;
+			uint64_t cost = integration[tile] + HUMFlowFieldMoveCost(query, tile, direction);
+
+			if (cost < integration[from]) {
+				integration[from] = (uint32_t)cost;
+				HUMFlowFieldHeapUpdate(&heap, from, (uint32_t)cost);
+			}
+		}
+	}
+
+	free(heap.entries);
+	free(heap.positions);
+
+	HUMFlowFieldSolveDirections(query, integration, directions);
+
+	return true;
+}
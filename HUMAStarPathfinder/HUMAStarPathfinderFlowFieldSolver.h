@@ -0,0 +1,72 @@
+//
+//  HUMAStarPathfinderFlowFieldSolver.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderFlowFieldSolver_h
+#define HUMAStarPathfinder_HUMAStarPathfinderFlowFieldSolver_h
+
+#include <stddef.h>
+#include "HUMAStarPathfinderSearch.h"
+
+/**
+ *	The width and height in tiles of the blocks the parallel solver splits the map into.
+ */
+#define HUMFlowFieldBlockSize 32
+
+/**
+ *	The direction of a tile with no move toward the target: the target itself, and tiles that can't reach it.
+ */
+#define HUMFlowFieldDirectionNone -1
+
+/**
+ *	The tile offsets of each direction, in the order N, E, S, W, NE, SE, SW, NW.
+ */
+extern const int8_t HUMFlowFieldDirectionX[8];
+extern const int8_t HUMFlowFieldDirectionY[8];
+
+/**
+ *	Runs work(context, i) for every i below iterations and returns once all of them have finished. Matches the shape of dispatch_apply_f.
+ */
+typedef void (*HUMFlowFieldApplyFunction)(void *info, size_t iterations, void *context, void (*work)(void *context, size_t iteration));
+
+typedef struct {
+	int32_t width;
+	int32_t height;
+	const uint8_t *walkable;	// row-major, width * height flags
+	const uint32_t *costs;		// row-major, width * height entry costs
+	HUMSearchNeighbors neighbors;
+	int32_t targetX;
+	int32_t targetY;
+
+	HUMFlowFieldApplyFunction apply;	// NULL runs every block on the calling thread
+	void *applyInfo;
+} HUMFlowFieldQuery;
+
+/**
+ *	Computes the integration field, the cost of the cheapest path from every tile to the target, and the direction field, the first move
+ *  of that path, in parallel. Moves follow the same rules as HUMSearchFindPath: entering a tile costs its entry cost, or the diagonal cost
+ *  of it, and only walkable tiles can be entered. A tile that isn't walkable still gets a value if a unit standing on it could step off.
+ *
+ *  The map is split into blocks that are each solved exactly with a local Dijkstra search seeded from the values around them. Like Dijkstra,
+ *  blocks are solved nearest the target first, one band of costs at a time, and a block is only solved again when a value along its edge
+ *  improves. Blocks are processed in four phases so that no two neighboring blocks are ever solved at once. The shortest path costs are unique, so the result is identical to HUMFlowFieldSolveSequential's regardless of
+ *  scheduling.
+ *
+ *	@param	integration	width * height costs, or UINT32_MAX for tiles that can't reach the target.
+ *	@param	directions	width * height indexes into HUMFlowFieldDirectionX and HUMFlowFieldDirectionY, or HUMFlowFieldDirectionNone. Ties
+ *						between moves go to the lowest index. May be NULL.
+ *
+ *	@return	false if scratch memory couldn't be allocated.
+ */
+bool HUMFlowFieldSolve(const HUMFlowFieldQuery *query, uint32_t *integration, int8_t *directions);
+
+/**
+ *	Computes the same fields as HUMFlowFieldSolve with a single Dijkstra search over the whole map.
+ */
+bool HUMFlowFieldSolveSequential(const HUMFlowFieldQuery *query, uint32_t *integration, int8_t *directions);
+
+#endif
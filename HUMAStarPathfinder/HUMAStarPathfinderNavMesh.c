@@ -0,0 +1,784 @@
+//
+//  HUMAStarPathfinderNavMesh.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderNavMesh.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma mark - Obstacles
+
+static inline void HUMNavMeshBlock(uint8_t *walkable, int32_t width, int32_t x, int32_t y) {
+	walkable[y * width + x] = 0;
+}
+
+/**
+ *	Determines if a segment passes through the interior of a cell, rather than missing it or only running along its border. Clips the segment
+ *  to the closed cell, then checks if the midpoint of what's left lies strictly inside the cell, which it does exactly when the clipped
+ *  segment isn't empty and isn't confined to the border.
+ */
+static bool HUMNavMeshSegmentEntersCell(float x0, float y0, float x1, float y1, int32_t cellX, int32_t cellY) {
+	float dx = x1 - x0;
+	float dy = y1 - y0;
+	float t0 = 0.0f;
+	float t1 = 1.0f;
+	float p[4] = { -dx, dx, -dy, dy };
+	float q[4] = { x0 - cellX, cellX + 1 - x0, y0 - cellY, cellY + 1 - y0 };
+
+	for (int i = 0; i < 4; i++) {
+		if (p[i] == 0.0f) {
+			if (q[i] < 0.0f) {
+				return false;
+			}
+
+			continue;
+		}
+
+		float t = q[i] / p[i];
+
+		if (p[i] < 0.0f) {
+			if (t > t1) {
+				return false;
+			}
+
+			if (t > t0) {
+				t0 = t;
+			}
+		}
+		else {
+			if (t < t0) {
+				return false;
+			}
+
+			if (t < t1) {
+				t1 = t;
+			}
+		}
+	}
+
+	float t = (t0 + t1) * 0.5f;
+	float x = x0 + dx * t;
+	float y = y0 + dy * t;
+
+	return x > cellX && x < cellX + 1 && y > cellY && y < cellY + 1;
+}
+
+static int HUMNavMeshCompareFloats(const void *a, const void *b) {
+	float left = *(const float *)a;
+	float right = *(const float *)b;
+	return (left > right) - (left < right);
+}
+
+void HUMNavMeshBlockObstacle(uint8_t *walkable, int32_t width, int32_t height, const float *xs, const float *ys, int32_t count, bool closed) {
+	if (count < 1) {
+		return;
+	}
+
+	// a single vertex is an edge from the vertex to itself
+	int32_t edgeCount = count == 1 ? 1 : (closed && count > 2 ? count : count - 1);
+
+	// every cell an edge passes through
+	for (int32_t i = 0; i < edgeCount; i++) {
+		float x0 = xs[i];
+		float y0 = ys[i];
+		float x1 = xs[(i + 1) % count];
+		float y1 = ys[(i + 1) % count];
+
+		int32_t minX = (int32_t)floorf(fminf(x0, x1));
+		int32_t maxX = (int32_t)floorf(fmaxf(x0, x1));
+		int32_t minY = (int32_t)floorf(fminf(y0, y1));
+		int32_t maxY = (int32_t)floorf(fmaxf(y0, y1));
+
+		minX = minX < 0 ? 0 : minX;
+		minY = minY < 0 ? 0 : minY;
+		maxX = maxX >= width ? width - 1 : maxX;
+		maxY = maxY >= height ? height - 1 : maxY;
+
+		for (int32_t y = minY; y <= maxY; y++) {
+			for (int32_t x = minX; x <= maxX; x++) {
+				if (HUMNavMeshSegmentEntersCell(x0, y0, x1, y1, x, y)) {
+					HUMNavMeshBlock(walkable, width, x, y);
+				}
+			}
+		}
+	}
+
+	if (!closed || count < 3) {
+		return;
+	}
+
+	// every cell whose center is inside the polygon, one row of centers at a time using the even-odd rule
+	float minY = ys[0];
+	float maxY = ys[0];
+
+	for (int32_t i = 1; i < count; i++) {
+		minY = fminf(minY, ys[i]);
+		maxY = fmaxf(maxY, ys[i]);
+	}
+
+	int32_t firstRow = (int32_t)ceilf(minY - 0.5f);
+	int32_t lastRow = (int32_t)floorf(maxY - 0.5f);
+	firstRow = firstRow < 0 ? 0 : firstRow;
+	lastRow = lastRow >= height ? height - 1 : lastRow;
+
+	float *crossings = malloc(count * sizeof(float));
+	if (!crossings) {
+		return;
+	}
+
+	for (int32_t row = firstRow; row <= lastRow; row++) {
+		float centerY = row + 0.5f;
+		int32_t crossingCount = 0;
+
+		for (int32_t i = 0; i < count; i++) {
+			float x0 = xs[i];
+			float y0 = ys[i];
+			float x1 = xs[(i + 1) % count];
+			float y1 = ys[(i + 1) % count];
+
+			// half-open in y, so a vertex on the line is counted once
+			if ((y0 <= centerY) != (y1 <= centerY)) {
+				crossings[crossingCount++] = x0 + (centerY - y0) * (x1 - x0) / (y1 - y0);
+			}
+		}
+
+		qsort(crossings, crossingCount, sizeof(float), HUMNavMeshCompareFloats);
+
+		for (int32_t i = 0; i + 1 < crossingCount; i += 2) {
+			int32_t firstColumn = (int32_t)ceilf(crossings[i] - 0.5f);
+			int32_t lastColumn = (int32_t)floorf(crossings[i + 1] - 0.5f);
+			firstColumn = firstColumn < 0 ? 0 : firstColumn;
+			lastColumn = lastColumn >= width ? width - 1 : lastColumn;
+
+			for (int32_t x = firstColumn; x <= lastColumn; x++) {
+				HUMNavMeshBlock(walkable, width, x, row);
+			}
+		}
+	}
+
+	free(crossings);
+}
+
+#pragma mark - Building
+
+typedef struct {
+	int32_t from;
+	HUMNavMeshPortal portal;
+} HUMNavMeshPendingPortal;
+
+typedef struct {
+	HUMNavMeshPendingPortal *portals;
+	int32_t count;
+	int32_t capacity;
+} HUMNavMeshPortalList;
+
+static bool HUMNavMeshAddPortal(HUMNavMeshPortalList *list, int32_t from, int32_t to, float ax, float ay, float bx, float by) {
+	if (list->count == list->capacity) {
+		int32_t capacity = list->capacity ? list->capacity * 2 : 64;
+		HUMNavMeshPendingPortal *portals = realloc(list->portals, capacity * sizeof(HUMNavMeshPendingPortal));
+		if (!portals) {
+			return false;
+		}
+
+		list->portals = portals;
+		list->capacity = capacity;
+	}
+
+	HUMNavMeshPendingPortal *pending = &list->portals[list->count++];
+	pending->from = from;
+	pending->portal.neighbor = to;
+	pending->portal.ax = ax;
+	pending->portal.ay = ay;
+	pending->portal.bx = bx;
+	pending->portal.by = by;
+
+	return true;
+}
+
+/**
+ *	Adds a portal in both directions for every run of cells along an edge of a polygon that belongs to the same neighbor.
+ *
+ *	@param	vertical	true for the polygon's right edge, false for its bottom edge.
+ */
+static bool HUMNavMeshAddEdgePortals(const HUMNavMesh *mesh, HUMNavMeshPortalList *list, int32_t index, bool vertical) {
+	const HUMNavMeshPolygon *polygon = &mesh->polygons[index];
+	int32_t line = vertical ? polygon->x + polygon->width : polygon->y + polygon->height;
+	int32_t first = vertical ? polygon->y : polygon->x;
+	int32_t length = vertical ? polygon->height : polygon->width;
+
+	if (line >= (vertical ? mesh->width : mesh->height)) {
+		return true;
+	}
+
+	int32_t runStart = first;
+	int32_t runNeighbor = -1;
+
+	for (int32_t i = first; i <= first + length; i++) {
+		int32_t neighbor = -1;
+		if (i < first + length) {
+			neighbor = vertical ? mesh->polygonIndices[i * mesh->width + line] : mesh->polygonIndices[line * mesh->width + i];
+		}
+
+		if (neighbor == runNeighbor) {
+			continue;
+		}
+
+		if (runNeighbor != -1) {
+			float ax = vertical ? line : runStart;
+			float ay = vertical ? runStart : line;
+			float bx = vertical ? line : i;
+			float by = vertical ? i : line;
+
+			if (!HUMNavMeshAddPortal(list, index, runNeighbor, ax, ay, bx, by) || !HUMNavMeshAddPortal(list, runNeighbor, index, ax, ay, bx, by)) {
+				return false;
+			}
+		}
+
+		runStart = i;
+		runNeighbor = neighbor;
+	}
+
+	return true;
+}
+
+HUMNavMesh *HUMNavMeshCreate(int32_t width, int32_t height, const uint8_t *walkable) {
+	if (width <= 0 || height <= 0) {
+		return NULL;
+	}
+
+	HUMNavMesh *mesh = calloc(1, sizeof(HUMNavMesh));
+	if (!mesh) {
+		return NULL;
+	}
+
+	size_t cellCount = (size_t)width * height;
+	int32_t polygonCapacity = 64;
+
+	mesh->width = width;
+	mesh->height = height;
+	mesh->polygonIndices = malloc(cellCount * sizeof(int32_t));
+	mesh->polygons = malloc(polygonCapacity * sizeof(HUMNavMeshPolygon));
+
+	if (!mesh->polygonIndices || !mesh->polygons) {
+		HUMNavMeshFree(mesh);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < cellCount; i++) {
+		mesh->polygonIndices[i] = -1;
+	}
+
+	// greedily cover the walkable cells with rectangles: from the first uncovered cell, as far right as possible, then as far down as the
+	// whole span allows
+	for (int32_t y = 0; y < height; y++) {
+		for (int32_t x = 0; x < width; x++) {
+			if (!walkable[y * width + x] || mesh->polygonIndices[y * width + x] != -1) {
+				continue;
+			}
+
+			int32_t right = x + 1;
+			while (right < width && walkable[y * width + right] && mesh->polygonIndices[y * width + right] == -1) {
+				right++;
+			}
+
+			int32_t bottom = y + 1;
+			for (; bottom < height; bottom++) {
+				bool spanFree = true;
+
+				for (int32_t column = x; column < right; column++) {
+					if (!walkable[bottom * width + column] || mesh->polygonIndices[bottom * width + column] != -1) {
+						spanFree = false;
+						break;
+					}
+				}
+
+				if (!spanFree) {
+					break;
+				}
+			}
+
+			if (mesh->polygonCount == polygonCapacity) {
+				polygonCapacity *= 2;
+				HUMNavMeshPolygon *polygons = realloc(mesh->polygons, polygonCapacity * sizeof(HUMNavMeshPolygon));
+				if (!polygons) {
+					HUMNavMeshFree(mesh);
+					return NULL;
+				}
+
+				mesh->polygons = polygons;
+			}
+
+			int32_t index = mesh->polygonCount++;
+			HUMNavMeshPolygon *polygon = &mesh->polygons[index];
+			polygon->x = x;
+			polygon->y = y;
+			polygon->width = right - x;
+			polygon->height = bottom - y;
+
+			for (int32_t row = y; row < bottom; row++) {
+				for (int32_t column = x; column < right; column++) {
+					mesh->polygonIndices[row * width + column] = index;
+				}
+			}
+		}
+	}
+
+	// polygons that only touch at a corner aren't connected, the same as a strict diagonal move
+	HUMNavMeshPortalList list = { NULL, 0, 0 };
+
+	for (int32_t i = 0; i < mesh->polygonCount; i++) {
+		if (!HUMNavMeshAddEdgePortals(mesh, &list, i, true) || !HUMNavMeshAddEdgePortals(mesh, &list, i, false)) {
+			free(list.portals);
+			HUMNavMeshFree(mesh);
+			return NULL;
+		}
+	}
+
+	// group the portals by the polygon they lead out of
+	mesh->portalCount = list.count;
+	mesh->portals = malloc((list.count > 0 ? list.count : 1) * sizeof(HUMNavMeshPortal));
+
+	if (!mesh->portals) {
+		free(list.portals);
+		HUMNavMeshFree(mesh);
+		return NULL;
+	}
+
+	for (int32_t i = 0; i < mesh->polygonCount; i++) {
+		mesh->polygons[i].portalCount = 0;
+	}
+
+	for (int32_t i = 0; i < list.count; i++) {
+		mesh->polygons[list.portals[i].from].portalCount++;
+	}
+
+	int32_t offset = 0;
+	for (int32_t i = 0; i < mesh->polygonCount; i++) {
+		mesh->polygons[i].firstPortal = offset;
+		offset += mesh->polygons[i].portalCount;
+		mesh->polygons[i].portalCount = 0;
+	}
+
+	for (int32_t i = 0; i < list.count; i++) {
+		HUMNavMeshPolygon *polygon = &mesh->polygons[list.portals[i].from];
+		mesh->portals[polygon->firstPortal + polygon->portalCount++] = list.portals[i].portal;
+	}
+
+	free(list.portals);
+
+	return mesh;
+}
+
+void HUMNavMeshFree(HUMNavMesh *mesh) {
+	if (!mesh) {
+		return;
+	}
+
+	free(mesh->polygonIndices);
+	free(mesh->polygons);
+	free(mesh->portals);
+	free(mesh);
+}
+
+#pragma mark - Searching
+
+typedef struct {
+	float f;
+	int32_t polygon;
+} HUMNavMeshHeapEntry;
+
+/**
+ *	The scratch memory of one search, indexed by polygon.
+ */
+typedef struct {
+	float *g;
+	float *entryX;			// where the path enters each polygon
+	float *entryY;
+	int32_t *parentPortal;	// the index of the portal the path enters through, or -1
+	int32_t *parent;
+	int32_t *heapIndex;		// -1 if not on the open list, -2 once closed
+	HUMNavMeshHeapEntry *heap;
+	int32_t heapCount;
+} HUMNavMeshSearch;
+
+static void HUMNavMeshHeapSwap(HUMNavMeshSearch *search, int32_t a, int32_t b) {
+	HUMNavMeshHeapEntry entry = search->heap[a];
+	search->heap[a] = search->heap[b];
+	search->heap[b] = entry;
+	search->heapIndex[search->heap[a].polygon] = a;
+	search->heapIndex[search->heap[b].polygon] = b;
+}
+
+static void HUMNavMeshHeapUp(HUMNavMeshSearch *search, int32_t index) {
+	while (index > 0) {
+		int32_t parent = (index - 1) / 2;
+		if (search->heap[parent].f <= search->heap[index].f) {
+			break;
+		}
+
+		HUMNavMeshHeapSwap(search, parent, index);
+		index = parent;
+	}
+}
+
+static int32_t HUMNavMeshHeapPop(HUMNavMeshSearch *search) {
+	int32_t polygon = search->heap[0].polygon;
+	search->heapCount--;
+
+	if (search->heapCount > 0) {
+		search->heap[0] = search->heap[search->heapCount];
+		search->heapIndex[search->heap[0].polygon] = 0;
+
+		int32_t index = 0;
+		for (;;) {
+			int32_t smallest = index;
+			int32_t left = index * 2 + 1;
+			int32_t right = left + 1;
+
+			if (left < search->heapCount && search->heap[left].f < search->heap[smallest].f) {
+				smallest = left;
+			}
+
+			if (right < search->heapCount && search->heap[right].f < search->heap[smallest].f) {
+				smallest = right;
+			}
+
+			if (smallest == index) {
+				break;
+			}
+
+			HUMNavMeshHeapSwap(search, smallest, index);
+			index = smallest;
+		}
+	}
+
+	search->heapIndex[polygon] = -2;
+	return polygon;
+}
+
+static void HUMNavMeshHeapPush(HUMNavMeshSearch *search, int32_t polygon, float f) {
+	int32_t index = search->heapIndex[polygon];
+
+	if (index < 0) {
+		index = search->heapCount++;
+		search->heap[index].polygon = polygon;
+		search->heapIndex[polygon] = index;
+	}
+
+	search->heap[index].f = f;
+	HUMNavMeshHeapUp(search, index);
+}
+
+static inline float HUMNavMeshDistance(float x0, float y0, float x1, float y1) {
+	return sqrtf((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+}
+
+/**
+ *	The point on a portal that makes the shortest detour from a point to the target: where the straight line between them crosses the
+ *  portal if it does, otherwise the nearer end of the portal.
+ */
+static void HUMNavMeshCrossingPoint(const HUMNavMeshPortal *portal, float x, float y, float targetX, float targetY, float *crossingX, float *crossingY) {
+	float portalX = portal->bx - portal->ax;
+	float portalY = portal->by - portal->ay;
+	float lineX = targetX - x;
+	float lineY = targetY - y;
+	float denominator = lineX * portalY - lineY * portalX;
+
+	if (denominator != 0.0f) {
+		float t = ((portal->ax - x) * lineY - (portal->ay - y) * lineX) / denominator;
+
+		if (t >= 0.0f && t <= 1.0f) {
+			*crossingX = portal->ax + portalX * t;
+			*crossingY = portal->ay + portalY * t;
+			return;
+		}
+	}
+
+	float viaA = HUMNavMeshDistance(x, y, portal->ax, portal->ay) + HUMNavMeshDistance(portal->ax, portal->ay, targetX, targetY);
+	float viaB = HUMNavMeshDistance(x, y, portal->bx, portal->by) + HUMNavMeshDistance(portal->bx, portal->by, targetX, targetY);
+
+	*crossingX = viaA <= viaB ? portal->ax : portal->bx;
+	*crossingY = viaA <= viaB ? portal->ay : portal->by;
+}
+
+/**
+ *	Runs A* over the polygons. A polygon's g is the length of the path through the points where it crosses each portal, each point the one
+ *  on its portal closest to the straight line from the previous one to the target, which is close to the length of the final path once
+ *  pulled taut.
+ *
+ *	@return	true if the target polygon was reached.
+ */
+static bool HUMNavMeshSearchCorridor(const HUMNavMesh *mesh, HUMNavMeshSearch *search, int32_t startPolygon, int32_t targetPolygon, float startX, float startY, float targetX, float targetY, int32_t *expanded) {
+	for (int32_t i = 0; i < mesh->polygonCount; i++) {
+		search->heapIndex[i] = -1;
+	}
+
+	search->heapCount = 0;
+	search->g[startPolygon] = 0.0f;
+	search->entryX[startPolygon] = startX;
+	search->entryY[startPolygon] = startY;
+	search->parent[startPolygon] = -1;
+	search->parentPortal[startPolygon] = -1;
+	HUMNavMeshHeapPush(search, startPolygon, HUMNavMeshDistance(startX, startY, targetX, targetY));
+
+	while (search->heapCount > 0) {
+		int32_t current = HUMNavMeshHeapPop(search);
+		(*expanded)++;
+
+		if (current == targetPolygon) {
+			return true;
+		}
+
+		const HUMNavMeshPolygon *polygon = &mesh->polygons[current];
+		float x = search->entryX[current];
+		float y = search->entryY[current];
+
+		for (int32_t i = 0; i < polygon->portalCount; i++) {
+			int32_t portalIndex = polygon->firstPortal + i;
+			const HUMNavMeshPortal *portal = &mesh->portals[portalIndex];
+			int32_t neighbor = portal->neighbor;
+
+			if (search->heapIndex[neighbor] == -2) {
+				continue;
+			}
+
+			float entryX, entryY;
+			HUMNavMeshCrossingPoint(portal, x, y, targetX, targetY, &entryX, &entryY);
+
+			float g = search->g[current] + HUMNavMeshDistance(x, y, entryX, entryY);
+			float h = HUMNavMeshDistance(entryX, entryY, targetX, targetY);
+
+			// the target's g includes the last leg, so it is only popped once no other polygon can lead to a shorter path
+			if (neighbor == targetPolygon) {
+				g += h;
+				h = 0.0f;
+			}
+
+			if (search->heapIndex[neighbor] >= 0 && g >= search->g[neighbor]) {
+				continue;
+			}
+
+			search->g[neighbor] = g;
+			search->entryX[neighbor] = entryX;
+			search->entryY[neighbor] = entryY;
+			search->parent[neighbor] = current;
+			search->parentPortal[neighbor] = portalIndex;
+			HUMNavMeshHeapPush(search, neighbor, g + h);
+		}
+	}
+
+	return false;
+}
+
+/**
+ *	Twice the signed area of the triangle abc. Positive when c lies to the right of ab in a y-down coordinate system.
+ */
+static inline float HUMNavMeshTriangleArea2(float ax, float ay, float bx, float by, float cx, float cy) {
+	return (cx - ax) * (by - ay) - (bx - ax) * (cy - ay);
+}
+
+static inline bool HUMNavMeshPointsEqual(float ax, float ay, float bx, float by) {
+	return (ax - bx) * (ax - bx) + (ay - by) * (ay - by) < 1e-12f;
+}
+
+/**
+ *	Pulls a path taut through a corridor of portals (the simple stupid funnel algorithm). The first portal is the start point and the last the
+ *  target point, both degenerate.
+ *
+ *	@return	The number of corners written to xs and ys, which must hold portalCount points.
+ */
+static int32_t HUMNavMeshStringPull(const float *leftX, const float *leftY, const float *rightX, const float *rightY, int32_t portalCount, float *xs, float *ys) {
+	int32_t count = 0;
+	float apexX = leftX[0], apexY = leftY[0];
+	float portalLeftX = leftX[0], portalLeftY = leftY[0];
+	float portalRightX = rightX[0], portalRightY = rightY[0];
+	int32_t apexIndex = 0, leftIndex = 0, rightIndex = 0;
+
+	xs[count] = apexX;
+	ys[count] = apexY;
+	count++;
+
+	for (int32_t i = 1; i < portalCount; i++) {
+		float lx = leftX[i], ly = leftY[i];
+		float rx = rightX[i], ry = rightY[i];
+
+		// narrow the funnel from the right
+		if (HUMNavMeshTriangleArea2(apexX, apexY, portalRightX, portalRightY, rx, ry) <= 0.0f) {
+			if (HUMNavMeshPointsEqual(apexX, apexY, portalRightX, portalRightY) || HUMNavMeshTriangleArea2(apexX, apexY, portalLeftX, portalLeftY, rx, ry) > 0.0f) {
+				portalRightX = rx;
+				portalRightY = ry;
+				rightIndex = i;
+			}
+			else {
+				// the right side crossed over the left, so the left point is a corner. Restart from it.
+				apexX = portalLeftX;
+				apexY = portalLeftY;
+				apexIndex = leftIndex;
+
+				if (!HUMNavMeshPointsEqual(xs[count - 1], ys[count - 1], apexX, apexY)) {
+					xs[count] = apexX;
+					ys[count] = apexY;
+					count++;
+				}
+
+				portalRightX = portalLeftX = apexX;
+				portalRightY = portalLeftY = apexY;
+				leftIndex = rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+
+		// narrow the funnel from the left
+		if (HUMNavMeshTriangleArea2(apexX, apexY, portalLeftX, portalLeftY, lx, ly) >= 0.0f) {
+			if (HUMNavMeshPointsEqual(apexX, apexY, portalLeftX, portalLeftY) || HUMNavMeshTriangleArea2(apexX, apexY, portalRightX, portalRightY, lx, ly) < 0.0f) {
+				portalLeftX = lx;
+				portalLeftY = ly;
+				leftIndex = i;
+			}
+			else {
+				apexX = portalRightX;
+				apexY = portalRightY;
+				apexIndex = rightIndex;
+
+				if (!HUMNavMeshPointsEqual(xs[count - 1], ys[count - 1], apexX, apexY)) {
+					xs[count] = apexX;
+					ys[count] = apexY;
+					count++;
+				}
+
+				portalRightX = portalLeftX = apexX;
+				portalRightY = portalLeftY = apexY;
+				leftIndex = rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+	}
+
+	float targetX = leftX[portalCount - 1];
+	float targetY = leftY[portalCount - 1];
+
+	if (count == 1 || !HUMNavMeshPointsEqual(xs[count - 1], ys[count - 1], targetX, targetY)) {
+		xs[count] = targetX;
+		ys[count] = targetY;
+		count++;
+	}
+
+	return count;
+}
+
+bool HUMNavMeshFindPath(const HUMNavMesh *mesh, float startX, float startY, float targetX, float targetY, HUMNavMeshPath *path) {
+	memset(path, 0, sizeof(HUMNavMeshPath));
+
+	int32_t startPolygon = HUMNavMeshPolygonAt(mesh, startX, startY);
+	int32_t targetPolygon = HUMNavMeshPolygonAt(mesh, targetX, targetY);
+
+	if (startPolygon == -1 || targetPolygon == -1) {
+		return false;
+	}
+
+	int32_t polygonCount = mesh->polygonCount;
+	HUMNavMeshSearch search;
+	search.g = malloc(polygonCount * sizeof(float));
+	search.entryX = malloc(polygonCount * sizeof(float));
+	search.entryY = malloc(polygonCount * sizeof(float));
+	search.parentPortal = malloc(polygonCount * sizeof(int32_t));
+	search.parent = malloc(polygonCount * sizeof(int32_t));
+	search.heapIndex = malloc(polygonCount * sizeof(int32_t));
+	search.heap = malloc(polygonCount * sizeof(HUMNavMeshHeapEntry));
+
+	bool found = false;
+	float *portalCoordinates = NULL;
+
+	if (!search.g || !search.entryX || !search.entryY || !search.parentPortal || !search.parent || !search.heapIndex || !search.heap) {
+		goto cleanup;
+	}
+
+	if (!HUMNavMeshSearchCorridor(mesh, &search, startPolygon, targetPolygon, startX, startY, targetX, targetY, &path->polygonsExpanded)) {
+		goto cleanup;
+	}
+
+	// the corridor's portals, from the target back to the start, plus the start and target themselves
+	int32_t portalCount = 2;
+	for (int32_t polygon = targetPolygon; search.parent[polygon] != -1; polygon = search.parent[polygon]) {
+		portalCount++;
+	}
+
+	portalCoordinates = malloc(4 * portalCount * sizeof(float));
+	path->xs = malloc(portalCount * sizeof(float));
+	path->ys = malloc(portalCount * sizeof(float));
+
+	if (!portalCoordinates || !path->xs || !path->ys) {
+		goto cleanup;
+	}
+
+	float *leftX = portalCoordinates;
+	float *leftY = leftX + portalCount;
+	float *rightX = leftY + portalCount;
+	float *rightY = rightX + portalCount;
+
+	leftX[0] = rightX[0] = startX;
+	leftY[0] = rightY[0] = startY;
+	leftX[portalCount - 1] = rightX[portalCount - 1] = targetX;
+	leftY[portalCount - 1] = rightY[portalCount - 1] = targetY;
+
+	int32_t index = portalCount - 2;
+	for (int32_t polygon = targetPolygon; search.parent[polygon] != -1; polygon = search.parent[polygon], index--) {
+		const HUMNavMeshPortal *portal = &mesh->portals[search.parentPortal[polygon]];
+		const HUMNavMeshPolygon *from = &mesh->polygons[search.parent[polygon]];
+
+		// a is on the left when looking across the portal from the polygon the path comes from
+		float centerX = from->x + from->width * 0.5f;
+		float centerY = from->y + from->height * 0.5f;
+		float middleX = (portal->ax + portal->bx) * 0.5f;
+		float middleY = (portal->ay + portal->by) * 0.5f;
+
+		if (HUMNavMeshTriangleArea2(centerX, centerY, middleX, middleY, portal->ax, portal->ay) < 0.0f) {
+			leftX[index] = portal->ax;
+			leftY[index] = portal->ay;
+			rightX[index] = portal->bx;
+			rightY[index] = portal->by;
+		}
+		else {
+			leftX[index] = portal->bx;
+			leftY[index] = portal->by;
+			rightX[index] = portal->ax;
+			rightY[index] = portal->ay;
+		}
+	}
+
+	path->count = HUMNavMeshStringPull(leftX, leftY, rightX, rightY, portalCount, path->xs, path->ys);
+
+	for (int32_t i = 1; i < path->count; i++) {
+		path->length += HUMNavMeshDistance(path->xs[i - 1], path->ys[i - 1], path->xs[i], path->ys[i]);
+	}
+
+	found = true;
+
+cleanup:
+	free(search.g);
+	free(search.entryX);
+	free(search.entryY);
+	free(search.parentPortal);
+	free(search.parent);
+	free(search.heapIndex);
+	free(search.heap);
+	free(portalCoordinates);
+
+	return found;
+}
+
+void HUMNavMeshPathFree(HUMNavMeshPath *path) {
+	free(path->xs);
+	free(path->ys);
+	path->xs = NULL;
+	path->ys = NULL;
+	path->count = 0;
+}
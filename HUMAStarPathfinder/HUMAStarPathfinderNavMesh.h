@@ -0,0 +1,110 @@
+//
+//  HUMAStarPathfinderNavMesh.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderNavMesh_h
+#define HUMAStarPathfinder_HUMAStarPathfinderNavMesh_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ *	The edge two polygons share, which a path crosses to get from one to the other.
+ */
+typedef struct {
+	int32_t neighbor;		// the polygon on the other side
+	float ax;				// the ends of the shared edge, a before b along the edge
+	float ay;
+	float bx;
+	float by;
+} HUMNavMeshPortal;
+
+/**
+ *	A convex polygon of walkable space. Every polygon is a rectangle of cells, so any two points inside it can be joined with a straight line.
+ */
+typedef struct {
+	int32_t x;
+	int32_t y;
+	int32_t width;
+	int32_t height;
+	int32_t firstPortal;	// the polygon's portals are portals[firstPortal] to portals[firstPortal + portalCount - 1]
+	int32_t portalCount;
+} HUMNavMeshPolygon;
+
+/**
+ *	A navigation mesh over a grid of cells, made of as few convex polygons as a greedy merge of the walkable cells finds. Large open areas
+ *  become a handful of polygons, so searching the mesh expands far fewer nodes than searching the cells. Coordinates are in cells, with
+ *  cell (x, y) covering [x, x + 1) x [y, y + 1). Never changes once created, so it can be searched from any number of threads at once.
+ */
+typedef struct HUMNavMesh {
+	int32_t width;
+	int32_t height;
+	int32_t *polygonIndices;	// width * height, the polygon covering each cell, or -1 for blocked cells
+
+	HUMNavMeshPolygon *polygons;
+	int32_t polygonCount;
+	HUMNavMeshPortal *portals;
+	int32_t portalCount;
+} HUMNavMesh;
+
+/**
+ *	A path found by HUMNavMeshFindPath. Free it with HUMNavMeshPathFree.
+ */
+typedef struct {
+	float *xs;					// the corners of the path, from the start to the target, both included
+	float *ys;
+	int32_t count;
+	float length;
+	int32_t polygonsExpanded;	// how many polygons the search expanded
+} HUMNavMeshPath;
+
+/**
+ *	Marks every cell an obstacle covers as blocked. A cell is covered if an edge of the obstacle passes through its interior, or if the
+ *  obstacle is closed and contains the cell's center. Edges that only run along the border of a cell don't block it, so obstacles drawn along
+ *  cell lines don't spill into the cells next to them.
+ *
+ *	@param	walkable	width * height flags, row-major.
+ *	@param	xs			The obstacle's vertices, in cells.
+ *	@param	ys
+ *	@param	count		The number of vertices.
+ *	@param	closed		true for a polygon, which also blocks its inside. false for a polyline, which only blocks the cells along it.
+ */
+void HUMNavMeshBlockObstacle(uint8_t *walkable, int32_t width, int32_t height, const float *xs, const float *ys, int32_t count, bool closed);
+
+/**
+ *	Builds a navigation mesh from the walkable cells of a grid.
+ *
+ *	@param	walkable	width * height flags, row-major.
+ *
+ *	@return	The mesh, or NULL if it couldn't be allocated.
+ */
+HUMNavMesh *HUMNavMeshCreate(int32_t width, int32_t height, const uint8_t *walkable);
+void HUMNavMeshFree(HUMNavMesh *mesh);
+
+/**
+ *	Finds a path between two points by running A* over the polygons, then pulling the corridor of polygons it found taut with the funnel
+ *  algorithm. The path is the shortest through that corridor, which is nearly always the shortest overall.
+ *
+ *	@param	path	Filled with the path if one is found. Must be freed with HUMNavMeshPathFree, whatever the result.
+ *
+ *	@return	true if a path was found. false if the start or target is outside the mesh, or they aren't connected.
+ */
+bool HUMNavMeshFindPath(const HUMNavMesh *mesh, float startX, float startY, float targetX, float targetY, HUMNavMeshPath *path);
+void HUMNavMeshPathFree(HUMNavMeshPath *path);
+
+/**
+ *	The polygon containing a point, or -1 if the point is outside the mesh.
+ */
+static inline int32_t HUMNavMeshPolygonAt(const HUMNavMesh *mesh, float x, float y) {
+	if (!(x >= 0.0f && y >= 0.0f && x < mesh->width && y < mesh->height)) {
+		return -1;
+	}
+
+	return mesh->polygonIndices[(int32_t)y * mesh->width + (int32_t)x];
+}
+
+#endif
@@ -0,0 +1,417 @@
+//
+//  HUMAStarPathfinderNavigationFile.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderNavigationFile.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HUMNavigationFNVOffsetBasis 0xcbf29ce484222325ULL
+#define HUMNavigationFNVPrime 0x100000001b3ULL
+
+static size_t HUMNavigationAlign(size_t offset) {
+	return (offset + HUMNavigationFileAlignment - 1) & ~(size_t)(HUMNavigationFileAlignment - 1);
+}
+
+#pragma mark - Checksums
+
+uint64_t HUMNavigationChecksum(const void *bytes, size_t length, uint64_t seed) {
+	const uint8_t *byte = bytes;
+	uint64_t hash = seed ? seed : HUMNavigationFNVOffsetBasis;
+
+	for (size_t i = 0; i < length; i++) {
+		hash ^= byte[i];
+		hash *= HUMNavigationFNVPrime;
+	}
+
+	return hash;
+}
+
+uint64_t HUMNavigationChecksumFile(const char *path) {
+	FILE *file = fopen(path, "rb");
+	if (!file) {
+		return 0;
+	}
+
+	uint8_t buffer[65536];
+	uint64_t hash = HUMNavigationFNVOffsetBasis;
+	size_t length;
+
+	while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+		hash = HUMNavigationChecksum(buffer, length, hash);
+	}
+
+	bool failed = ferror(file);
+	fclose(file);
+
+	return failed ? 0 : hash;
+}
+
+#pragma mark - Components
+
+/**
+ *	The index of the set a tile belongs to, halving the path to it on the way.
+ */
+static uint32_t HUMNavigationFind(uint32_t *parents, uint32_t tile) {
+	while (parents[tile] != tile) {
+		parents[tile] = parents[parents[tile]];
+		tile = parents[tile];
+	}
+
+	return tile;
+}
+
+static void HUMNavigationUnion(uint32_t *parents, uint32_t a, uint32_t b) {
+	a = HUMNavigationFind(parents, a);
+	b = HUMNavigationFind(parents, b);
+
+	// the lower index becomes the root, so roots are always the first tile of their set in row-major order
+	if (a < b) {
+		parents[b] = a;
+	}
+	else if (b < a) {
+		parents[a] = b;
+	}
+}
+
+uint32_t HUMNavigationLabelComponents(int32_t width, int32_t height, const uint8_t *walkable, HUMSearchNeighbors neighbors, uint32_t *components) {
+	size_t tileCount = (size_t)width * (size_t)height;
+	uint32_t *parents = malloc(tileCount * sizeof(uint32_t));
+	if (!parents) {
+		memset(components, 0, tileCount * sizeof(uint32_t));
+		return 0;
+	}
+
+	for (size_t tile = 0; tile < tileCount; tile++) {
+		parents[tile] = (uint32_t)tile;
+	}
+
+	// every move can be made in both directions, so joining each tile to its west, north-west, north, and north-east neighbors covers them all
+	for (int32_t y = 0; y < height; y++) {
+		for (int32_t x = 0; x < width; x++) {
+			uint32_t tile = (uint32_t)(y * width + x);
+
+			if (!walkable[tile]) {
+				continue;
+			}
+
+			bool west = x > 0 && walkable[tile - 1];
+			bool north = y > 0 && walkable[tile - width];
+
+			if (west) {
+				HUMNavigationUnion(parents, tile, tile - 1);
+			}
+
+			if (north) {
+				HUMNavigationUnion(parents, tile, tile - width);
+			}
+
+			if (neighbors == HUMSearchNeighborsCardinal || y == 0) {
+				continue;
+			}
+
+			// a diagonal move's corner tiles are the same from either end: for the north-west move, the west and north tiles
+			if (x > 0 && walkable[tile - width - 1]) {
+				bool allowed = (neighbors == HUMSearchNeighborsDiagonal ||
+								(neighbors == HUMSearchNeighborsDiagonalCrossBorders && (west || north)) ||
+								(neighbors == HUMSearchNeighborsDiagonalStrict && west && north));
+
+				if (allowed) {
+					HUMNavigationUnion(parents, tile, tile - width - 1);
+				}
+			}
+
+			if (x < width - 1 && walkable[tile - width + 1]) {
+				bool east = walkable[tile + 1];
+				bool allowed = (neighbors == HUMSearchNeighborsDiagonal ||
+								(neighbors == HUMSearchNeighborsDiagonalCrossBorders && (east || north)) ||
+								(neighbors == HUMSearchNeighborsDiagonalStrict && east && north));
+
+				if (allowed) {
+					HUMNavigationUnion(parents, tile, tile - width + 1);
+				}
+			}
+		}
+	}
+
+	// roots come before the rest of their set, so a single pass can number them in order and copy each root's label to its set
+	uint32_t count = 0;
+
+	for (size_t tile = 0; tile < tileCount; tile++) {
+		if (!walkable[tile]) {
+			components[tile] = 0;
+		}
+		else if (parents[tile] == tile) {
+			components[tile] = ++count;
+		}
+		else {
+			components[tile] = components[HUMNavigationFind(parents, (uint32_t)tile)];
+		}
+	}
+
+	free(parents);
+
+	return count;
+}
+
+bool HUMNavigationNeighborsCompatible(HUMSearchNeighbors search, HUMSearchNeighbors components) {
+	// ordered from the fewest moves to the most
+	static const int32_t HUMNavigationNeighborRanks[HUMSearchNeighborsCount] = {
+		[HUMSearchNeighborsCardinal] = 0,
+		[HUMSearchNeighborsDiagonalStrict] = 1,
+		[HUMSearchNeighborsDiagonalCrossBorders] = 2,
+		[HUMSearchNeighborsDiagonal] = 3
+	};
+
+	if (search >= HUMSearchNeighborsCount || components >= HUMSearchNeighborsCount) {
+		return false;
+	}
+
+	return HUMNavigationNeighborRanks[search] <= HUMNavigationNeighborRanks[components];
+}
+
+#pragma mark - Writing
+
+static bool HUMNavigationWritePadding(FILE *file, size_t offset) {
+	static const uint8_t zeros[HUMNavigationFileAlignment] = { 0 };
+	size_t padding = HUMNavigationAlign(offset) - offset;
+
+	return padding == 0 || fwrite(zeros, 1, padding, file) == padding;
+}
+
+HUMNavigationFileStatus HUMNavigationFileWrite(const char *path, int32_t width, int32_t height, uint64_t sourceChecksum, const uint8_t *walkable, const uint32_t *costs, const uint32_t *components, HUMSearchNeighbors componentNeighbors) {
+	size_t tileCount = (size_t)width * (size_t)height;
+	int32_t wordsPerRow = (width + 63) / 64;
+
+	HUMNavigationFileHeader header = {
+		.magic = HUMNavigationFileMagic,
+		.version = HUMNavigationFileVersion,
+		.width = (uint32_t)width,
+		.height = (uint32_t)height,
+		.sourceChecksum = sourceChecksum,
+		.componentNeighbors = componentNeighbors,
+		.sectionCount = 1 + (costs != NULL) + (components != NULL)
+	};
+
+	HUMNavigationSectionEntry sections[3];
+	const void *sectionData[3] = { NULL };
+	size_t offset = HUMNavigationAlign(sizeof(header) + header.sectionCount * sizeof(HUMNavigationSectionEntry));
+	uint32_t sectionIndex = 0;
+
+	sections[sectionIndex++] = (HUMNavigationSectionEntry){ HUMNavigationSectionWalkability, 0, offset, (size_t)wordsPerRow * height * sizeof(uint64_t) };
+	offset = HUMNavigationAlign(offset + sections[0].length);
+
+	if (costs) {
+		sectionData[sectionIndex] = costs;
+		sections[sectionIndex++] = (HUMNavigationSectionEntry){ HUMNavigationSectionCosts, 0, offset, tileCount * sizeof(uint32_t) };
+		offset = HUMNavigationAlign(offset + tileCount * sizeof(uint32_t));
+	}
+
+	if (components) {
+		sectionData[sectionIndex] = components;
+		sections[sectionIndex++] = (HUMNavigationSectionEntry){ HUMNavigationSectionComponents, 0, offset, tileCount * sizeof(uint32_t) };
+	}
+
+	uint64_t *row = calloc((size_t)wordsPerRow, sizeof(uint64_t));
+	size_t pathLength = strlen(path);
+	char *temporaryPath = malloc(pathLength + 5);
+
+	if (!row || !temporaryPath) {
+		free(row);
+		free(temporaryPath);
+		return HUMNavigationFileStatusUnreadable;
+	}
+
+	memcpy(temporaryPath, path, pathLength);
+	memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+	FILE *file = fopen(temporaryPath, "wb");
+	bool written = file != NULL;
+
+	written = written && fwrite(&header, sizeof(header), 1, file) == 1;
+	written = written && fwrite(sections, sizeof(HUMNavigationSectionEntry), header.sectionCount, file) == header.sectionCount;
+	written = written && HUMNavigationWritePadding(file, sizeof(header) + header.sectionCount * sizeof(HUMNavigationSectionEntry));
+
+	for (int32_t y = 0; written && y < height; y++) {
+		memset(row, 0, (size_t)wordsPerRow * sizeof(uint64_t));
+
+		for (int32_t x = 0; x < width; x++) {
+			if (walkable[(size_t)y * width + x]) {
+				row[x >> 6] |= 1ULL << (x & 63);
+			}
+		}
+
+		written = fwrite(row, sizeof(uint64_t), (size_t)wordsPerRow, file) == (size_t)wordsPerRow;
+	}
+
+	for (uint32_t i = 1; written && i < header.sectionCount; i++) {
+		written = HUMNavigationWritePadding(file, (size_t)(sections[i - 1].offset + sections[i - 1].length));
+		written = written && fwrite(sectionData[i], sizeof(uint32_t), tileCount, file) == tileCount;
+	}
+
+	if (file && fclose(file) != 0) {
+		written = false;
+	}
+
+	if (written) {
+		written = rename(temporaryPath, path) == 0;
+	}
+
+	if (!written) {
+		unlink(temporaryPath);
+	}
+
+	free(row);
+	free(temporaryPath);
+
+	return written ? HUMNavigationFileStatusOK : HUMNavigationFileStatusUnreadable;
+}
+
+#pragma mark - Reading
+
+/**
+ *	Determines if a section lies within the mapping, is aligned for its values, and is at least the expected size.
+ */
+static bool HUMNavigationSectionIsValid(const HUMNavigationSectionEntry *section, size_t fileLength, uint64_t expectedLength) {
+	return (section->offset % sizeof(uint64_t) == 0 &&
+			section->offset <= fileLength &&
+			section->length <= fileLength - section->offset &&
+			section->length >= expectedLength);
+}
+
+HUMNavigationData *HUMNavigationDataOpen(const char *path, uint64_t sourceChecksum, HUMNavigationFileStatus *status) {
+	HUMNavigationFileStatus result = HUMNavigationFileStatusUnreadable;
+	HUMNavigationData *data = NULL;
+	void *mapping = MAP_FAILED;
+	size_t length = 0;
+
+	int descriptor = open(path, O_RDONLY);
+	struct stat info;
+
+	if (descriptor >= 0 && fstat(descriptor, &info) == 0 && info.st_size > 0) {
+		length = (size_t)info.st_size;
+		mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	}
+
+	// the mapping holds its own reference to the file
+	if (descriptor >= 0) {
+		close(descriptor);
+	}
+
+	if (mapping == MAP_FAILED) {
+		goto done;
+	}
+
+	const HUMNavigationFileHeader *header = mapping;
+	result = HUMNavigationFileStatusInvalid;
+
+	if (length < sizeof(HUMNavigationFileHeader) || header->magic != HUMNavigationFileMagic) {
+		goto done;
+	}
+
+	if (header->version != HUMNavigationFileVersion) {
+		result = HUMNavigationFileStatusUnsupportedVersion;
+		goto done;
+	}
+
+	if (header->width == 0 || header->height == 0 || header->width > INT32_MAX || header->height > INT32_MAX ||
+		header->sectionCount > (length - sizeof(HUMNavigationFileHeader)) / sizeof(HUMNavigationSectionEntry)) {
+		goto done;
+	}
+
+	if (sourceChecksum != 0 && header->sourceChecksum != sourceChecksum) {
+		result = HUMNavigationFileStatusStale;
+		goto done;
+	}
+
+	data = calloc(1, sizeof(HUMNavigationData));
+	if (!data) {
+		result = HUMNavigationFileStatusUnreadable;
+		goto done;
+	}
+
+	data->mapping = mapping;
+	data->mappingLength = length;
+	data->width = (int32_t)header->width;
+	data->height = (int32_t)header->height;
+	data->sourceChecksum = header->sourceChecksum;
+	data->wordsPerRow = (data->width + 63) / 64;
+	data->componentNeighbors = header->componentNeighbors < HUMSearchNeighborsCount ? header->componentNeighbors : HUMSearchNeighborsCardinal;
+
+	uint64_t tileCount = (uint64_t)header->width * header->height;
+	const HUMNavigationSectionEntry *sections = (const HUMNavigationSectionEntry *)(header + 1);
+
+	for (uint32_t i = 0; i < header->sectionCount; i++) {
+		const HUMNavigationSectionEntry *section = &sections[i];
+		const void *bytes = (const uint8_t *)mapping + section->offset;
+
+		switch (section->type) {
+			case HUMNavigationSectionWalkability:
+				if (!HUMNavigationSectionIsValid(section, length, (uint64_t)data->wordsPerRow * header->height * sizeof(uint64_t))) {
+					goto done;
+				}
+
+				data->walkable = bytes;
+				break;
+
+			case HUMNavigationSectionCosts:
+				if (!HUMNavigationSectionIsValid(section, length, tileCount * sizeof(uint32_t))) {
+					goto done;
+				}
+
+				data->costs = bytes;
+				break;
+
+			case HUMNavigationSectionComponents:
+				if (!HUMNavigationSectionIsValid(section, length, tileCount * sizeof(uint32_t)) || header->componentNeighbors >= HUMSearchNeighborsCount) {
+					goto done;
+				}
+
+				data->components = bytes;
+				break;
+
+			default:
+				// written by a newer version of the format
+				break;
+		}
+	}
+
+	if (data->walkable) {
+		result = HUMNavigationFileStatusOK;
+	}
+
+done:
+	if (result != HUMNavigationFileStatusOK) {
+		free(data);
+		data = NULL;
+
+		if (mapping != MAP_FAILED) {
+			munmap(mapping, length);
+		}
+	}
+
+	if (status) {
+		*status = result;
+	}
+
+	return data;
+}
+
+void HUMNavigationDataClose(HUMNavigationData *data) {
+	if (!data) {
+		return;
+	}
+
+	munmap(data->mapping, data->mappingLength);
+	free(data);
+}
@@ -0,0 +1,167 @@
+//
+//  HUMAStarPathfinderNavigationFile.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderNavigationFile_h
+#define HUMAStarPathfinder_HUMAStarPathfinderNavigationFile_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "HUMAStarPathfinderSearch.h"
+
+/**
+ *	A navigation file holds everything the pathfinder would otherwise derive from a tile map at load time, laid out so it can be memory
+ *  mapped and used in place. It starts with a header and a table of sections, followed by the sections themselves, each aligned to
+ *  HUMNavigationFileAlignment bytes. All values are little-endian.
+ *
+ *	Readers skip section types they don't know, so new precomputed tables can be added without bumping the version. The version only
+ *  changes when the layout of an existing section does.
+ */
+#define HUMNavigationFileMagic 0x4e4d5548		// "HUMN"
+#define HUMNavigationFileVersion 1
+#define HUMNavigationFileAlignment 64
+
+typedef enum {
+	/**
+	 *	One bit per tile, set if the tile is walkable. Each row is padded to whole 64 bit words: tile (x, y) is bit x % 64 of word
+	 *  y * ((width + 63) / 64) + x / 64.
+	 */
+	HUMNavigationSectionWalkability = 1,
+
+	/**
+	 *	A uint32_t movement cost per tile, row-major. HUMNavigationDefaultCost means the pathfinder's baseMovementCost.
+	 */
+	HUMNavigationSectionCosts = 2,
+
+	/**
+	 *	A uint32_t connected component label per tile, row-major. Walkable tiles that can reach each other share a label. Blocked tiles are 0.
+	 */
+	HUMNavigationSectionComponents = 3
+} HUMNavigationSectionType;
+
+/**
+ *	Stored in the cost section for tiles without a cost of their own.
+ */
+#define HUMNavigationDefaultCost UINT32_MAX
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint64_t sourceChecksum;		// HUMNavigationChecksum of the map the file was built from
+	uint32_t componentNeighbors;	// the HUMSearchNeighbors the components were labeled with
+	uint32_t sectionCount;
+} HUMNavigationFileHeader;
+
+typedef struct {
+	uint32_t type;
+	uint32_t reserved;
+	uint64_t offset;				// from the start of the file
+	uint64_t length;
+} HUMNavigationSectionEntry;
+
+typedef enum {
+	HUMNavigationFileStatusOK = 0,
+	HUMNavigationFileStatusUnreadable,		// the file couldn't be opened, mapped, or written
+	HUMNavigationFileStatusInvalid,			// not a navigation file, truncated, or missing the walkability section
+	HUMNavigationFileStatusUnsupportedVersion,
+	HUMNavigationFileStatusStale			// built from a different version of the map
+} HUMNavigationFileStatus;
+
+/**
+ *	A mapped navigation file. The section pointers point straight into the mapping, which stays valid until the data is closed.
+ */
+typedef struct {
+	void *mapping;
+	size_t mappingLength;
+
+	int32_t width;
+	int32_t height;
+	uint64_t sourceChecksum;
+
+	const uint64_t *walkable;
+	int32_t wordsPerRow;
+	const uint32_t *costs;			// NULL if the file has no cost section
+	const uint32_t *components;		// NULL if the file has no component section
+	HUMSearchNeighbors componentNeighbors;
+} HUMNavigationData;
+
+/**
+ *	Maps a navigation file and checks its header and section table. Nothing else is read, so opening takes the same time for any map size.
+ *
+ *	@param	path			The path of the navigation file.
+ *	@param	sourceChecksum	The checksum of the map the file should have been built from, or 0 to skip the staleness check.
+ *	@param	status			Set to the reason the file couldn't be opened. May be NULL.
+ *
+ *	@return	The mapped data, or NULL.
+ */
+HUMNavigationData *HUMNavigationDataOpen(const char *path, uint64_t sourceChecksum, HUMNavigationFileStatus *status);
+void HUMNavigationDataClose(HUMNavigationData *data);
+
+/**
+ *	A 64 bit FNV-1a hash. Pass the result of one call as the seed of the next to hash data in pieces, and 0 to start.
+ */
+uint64_t HUMNavigationChecksum(const void *bytes, size_t length, uint64_t seed);
+
+/**
+ *	Hashes a whole file with HUMNavigationChecksum.
+ *
+ *	@return	The checksum, or 0 if the file couldn't be read.
+ */
+uint64_t HUMNavigationChecksumFile(const char *path);
+
+/**
+ *	Labels the connected components of a map under a neighbor policy. Every policy's moves can be made in both directions, so components
+ *  are well defined. Components under a looser policy contain those of a stricter one.
+ *
+ *	@param	walkable	width * height walkable flags, row-major.
+ *	@param	components	Filled with width * height labels, numbered from 1. Blocked tiles are labeled 0.
+ *
+ *	@return	The number of components.
+ */
+uint32_t HUMNavigationLabelComponents(int32_t width, int32_t height, const uint8_t *walkable, HUMSearchNeighbors neighbors, uint32_t *components);
+
+/**
+ *	Writes a navigation file. The file is written next to the destination and moved into place, so a reader never sees a partial file.
+ *
+ *	@param	walkable	width * height walkable flags, row-major. Required.
+ *	@param	costs		width * height costs, or NULL to leave out the cost section.
+ *	@param	components	width * height labels from HUMNavigationLabelComponents, or NULL to leave out the component section.
+ *
+ *	@return	HUMNavigationFileStatusOK, or HUMNavigationFileStatusUnreadable if the file couldn't be written.
+ */
+HUMNavigationFileStatus HUMNavigationFileWrite(const char *path, int32_t width, int32_t height, uint64_t sourceChecksum, const uint8_t *walkable, const uint32_t *costs, const uint32_t *components, HUMSearchNeighbors componentNeighbors);
+
+/**
+ *	Determines if a search with one neighbor policy can use components labeled with another. It can if its moves are a subset of theirs.
+ */
+bool HUMNavigationNeighborsCompatible(HUMSearchNeighbors search, HUMSearchNeighbors components);
+
+static inline bool HUMNavigationDataIsWalkable(const HUMNavigationData *data, int32_t x, int32_t y) {
+	return (data->walkable[(size_t)y * data->wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+}
+
+static inline uint32_t HUMNavigationDataComponent(const HUMNavigationData *data, int32_t x, int32_t y) {
+	return data->components[(size_t)y * data->width + x];
+}
+
+/**
+ *	The cost of a tile, or defaultCost if the file has no costs or the tile has no cost of its own.
+ */
+static inline uint32_t HUMNavigationDataCost(const HUMNavigationData *data, int32_t x, int32_t y, uint32_t defaultCost) {
+	if (!data->costs) {
+		return defaultCost;
+	}
+
+	uint32_t cost = data->costs[(size_t)y * data->width + x];
+	return cost == HUMNavigationDefaultCost ? defaultCost : cost;
+}
+
+#endif
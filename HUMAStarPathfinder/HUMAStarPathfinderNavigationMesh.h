@@ -0,0 +1,69 @@
+//
+//  HUMAStarPathfinderNavigationMesh.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HUMAStarPathfinder.h"
+#import "HUMAStarPathfinderNavMesh.h"
+
+/**
+ *	A navigation mesh of the walkable space of a tile map, as built by -[HUMAStarPathfinder navigationMeshWithObstaclePolygons:polylines:cellsPerTile:].
+ *  The walkable space is covered with as few rectangles as possible, so a large open area is a single node to search instead of thousands of
+ *  tiles. Paths are pulled taut through the rectangles with the funnel algorithm, so they cut straight across open ground instead of following
+ *  the grid, and turn only at the corners of obstacles.
+ *
+ *  The mesh never changes once built, so it can be searched from any number of threads at once. Build a new one when the map changes.
+ */
+@interface HUMAStarPathfinderNavigationMesh : NSObject
+
+/**
+ *	Creates a navigation mesh that takes ownership of a mesh created with HUMNavMeshCreate. The mesh is freed when the navigation mesh is deallocated.
+ *
+ *	@param	tileMapSize		The size of the tile map the mesh covers.
+ *	@param	tileSize		The size of each tile in points.
+ *	@param	origin			The coordinate system positions are given in.
+ *	@param	cellsPerTile	The number of mesh cells across each tile.
+ *	@param	mesh			A mesh of tileMapSize.width * cellsPerTile by tileMapSize.height * cellsPerTile cells.
+ */
+- (id)initWithTileMapSize:(CGSize)tileMapSize tileSize:(CGSize)tileSize coordinateSystemOrigin:(HUMCoodinateSystemOrigin)origin cellsPerTile:(NSUInteger)cellsPerTile meshNoCopy:(HUMNavMesh *)mesh;
+
+@property (nonatomic, readonly) CGSize tileMapSize;
+@property (nonatomic, readonly) CGSize tileSize;
+@property (nonatomic, readonly) HUMCoodinateSystemOrigin coordinateSystemOrigin;
+@property (nonatomic, readonly) NSUInteger cellsPerTile;
+
+/**
+ *	The number of polygons in the mesh, which is the most nodes a search can expand.
+ */
+@property (nonatomic, readonly) NSUInteger polygonCount;
+
+/**
+ *	The underlying mesh.
+ */
+@property (nonatomic, readonly) const HUMNavMesh *mesh;
+
+/**
+ *	Determines if a position lies in the walkable space of the mesh.
+ *
+ *	@param	position	A position relative to the coordinateSystemOrigin.
+ *
+ *	@return	YES, if the position is walkable. NO, otherwise.
+ */
+- (BOOL)isWalkableAtPosition:(CGPoint)position;
+
+/**
+ *	Finds a path from the start point to the target point through the mesh.
+ *
+ *	@param	start	A CGPoint where the path should start.
+ *	@param	target	A CGPoint where the path should end.
+ *
+ *	@return	An NSArray of NSValue-wrapped CGPoints, starting with start, ending with target, and in between the obstacle corners the path turns
+ *			at. nil if the start and target are equal or either isn't walkable. An empty array if there is no path between them.
+ */
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target;
+
+@end
@@ -0,0 +1,102 @@
+//
+//  HUMAStarPathfinderNavigationMesh.m
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import "HUMAStarPathfinderNavigationMesh.h"
+
+@implementation HUMAStarPathfinderNavigationMesh
+
+- (id)initWithTileMapSize:(CGSize)tileMapSize tileSize:(CGSize)tileSize coordinateSystemOrigin:(HUMCoodinateSystemOrigin)origin cellsPerTile:(NSUInteger)cellsPerTile meshNoCopy:(HUMNavMesh *)mesh {
+	NSParameterAssert(mesh);
+	NSParameterAssert(cellsPerTile > 0);
+
+	self = [super init];
+	if (self) {
+		_tileMapSize = tileMapSize;
+		_tileSize = tileSize;
+		_coordinateSystemOrigin = origin;
+		_cellsPerTile = cellsPerTile;
+		_mesh = mesh;
+	}
+
+	return self;
+}
+
+- (void)dealloc {
+	HUMNavMeshFree((HUMNavMesh *)_mesh);
+}
+
+- (NSUInteger)polygonCount {
+	return _mesh->polygonCount;
+}
+
+#pragma mark - Coordinates
+/**
+ *	Converts a position to mesh cell coordinates, where y grows downward from the top of the map.
+ */
+- (void)getCellX:(float *)x y:(float *)y forPosition:(CGPoint)position {
+	CGFloat tileY = position.y / self.tileSize.height;
+
+	if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		tileY = self.tileMapSize.height - tileY;
+	}
+
+	*x = position.x / self.tileSize.width * self.cellsPerTile;
+	*y = tileY * self.cellsPerTile;
+}
+
+- (CGPoint)positionForCellX:(float)x y:(float)y {
+	CGFloat tileY = y / self.cellsPerTile;
+
+	if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		tileY = self.tileMapSize.height - tileY;
+	}
+
+	return CGPointMake(x / self.cellsPerTile * self.tileSize.width, tileY * self.tileSize.height);
+}
+
+#pragma mark - Queries
+- (BOOL)isWalkableAtPosition:(CGPoint)position {
+	float x, y;
+	[self getCellX:&x y:&y forPosition:position];
+
+	return HUMNavMeshPolygonAt(_mesh, x, y) != -1;
+}
+
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target {
+	if (CGPointEqualToPoint(start, target) || ![self isWalkableAtPosition:start] || ![self isWalkableAtPosition:target]) {
+		return nil;
+	}
+
+	float startX, startY, targetX, targetY;
+	[self getCellX:&startX y:&startY forPosition:start];
+	[self getCellX:&targetX y:&targetY forPosition:target];
+
+	HUMNavMeshPath path;
+	if (!HUMNavMeshFindPath(_mesh, startX, startY, targetX, targetY, &path)) {
+		HUMNavMeshPathFree(&path);
+		return @[];
+	}
+
+	NSMutableArray *points = [NSMutableArray arrayWithCapacity:path.count];
+
+	for (int32_t i = 0; i < path.count; i++) {
+		// the ends are the exact points asked for, rather than their round trip through cell coordinates
+		CGPoint position = i == 0 ? start : (i == path.count - 1 ? target : [self positionForCellX:path.xs[i] y:path.ys[i]]);
+#if TARGET_OS_IPHONE
+		[points addObject:[NSValue valueWithCGPoint:position]];
+#else
+		[points addObject:[NSValue valueWithPoint:position]];
+#endif
+	}
+
+	HUMNavMeshPathFree(&path);
+
+	return [NSArray arrayWithArray:points];
+}
+
+@end
@@ -0,0 +1,186 @@
+//
+//  HUMAStarPathfinderPathRepair.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderPathRepair.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ *	Keeps a detour search within a window around the broken part of the path by reporting every tile outside it as unwalkable.
+ */
+typedef struct {
+	HUMSearchSampleFunction sample;
+	void *info;
+	HUMSearchTileRect window;
+} HUMPathRepairWindow;
+
+static inline bool HUMPathRepairRectContains(HUMSearchTileRect rect, int32_t x, int32_t y) {
+	return x >= rect.x && y >= rect.y && x < rect.x + rect.width && y < rect.y + rect.height;
+}
+
+static void HUMPathRepairSampleWindow(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost) {
+	HUMPathRepairWindow *window = info;
+
+	if (!HUMPathRepairRectContains(window->window, x, y)) {
+		*walkable = false;
+		return;
+	}
+
+	window->sample(window->info, x, y, walkable, cost);
+}
+
+static bool HUMPathRepairIsWalkable(const HUMPathRepairQuery *query, int32_t x, int32_t y) {
+	bool walkable = false;
+	uint32_t cost = 0;
+	query->sample(query->info, x, y, &walkable, &cost);
+
+	return walkable;
+}
+
+/**
+ *	Determines if a single move can still be made. Only the tile moved onto and the corners a diagonal move cuts matter, since the start tile
+ *  of a path doesn't have to be walkable.
+ */
+static bool HUMPathRepairIsMoveWalkable(const HUMPathRepairQuery *query, int32_t fromX, int32_t fromY, int32_t toX, int32_t toY) {
+	if (!HUMPathRepairIsWalkable(query, toX, toY)) {
+		return false;
+	}
+
+	if (fromX == toX || fromY == toY) {
+		return true;
+	}
+
+	switch (query->neighbors) {
+		case HUMSearchNeighborsCardinal:
+			return false;
+
+		case HUMSearchNeighborsDiagonalCrossBorders:
+			return HUMPathRepairIsWalkable(query, toX, fromY) || HUMPathRepairIsWalkable(query, fromX, toY);
+
+		case HUMSearchNeighborsDiagonalStrict:
+			return HUMPathRepairIsWalkable(query, toX, fromY) && HUMPathRepairIsWalkable(query, fromX, toY);
+
+		case HUMSearchNeighborsDiagonal:
+		default:
+			return true;
+	}
+}
+
+static bool HUMPathRepairMoveTouchesRect(HUMSearchTileRect rect, int32_t fromX, int32_t fromY, int32_t toX, int32_t toY) {
+	return HUMPathRepairRectContains(rect, toX, toY) || HUMPathRepairRectContains(rect, toX, fromY) || HUMPathRepairRectContains(rect, fromX, toY);
+}
+
+void HUMPathRepair(HUMSearchContext *context, const HUMPathRepairQuery *query, HUMPathRepairResult *result) {
+	memset(result, 0, sizeof(HUMPathRepairResult));
+	result->status = HUMPathRepairStatusFailed;
+	result->firstBrokenMove = -1;
+	result->lastBrokenMove = -1;
+
+	const int32_t *xs = query->xs;
+	const int32_t *ys = query->ys;
+
+	for (int32_t i = 1; i < query->count; i++) {
+		int32_t distanceX = abs(xs[i] - xs[i - 1]);
+		int32_t distanceY = abs(ys[i] - ys[i - 1]);
+
+		// a path that skips tiles, like an any-angle one, can't be checked a move at a time
+		if (distanceX > 1 || distanceY > 1 || (distanceX == 0 && distanceY == 0)) {
+			return;
+		}
+
+		if (!HUMPathRepairMoveTouchesRect(query->changedRect, xs[i - 1], ys[i - 1], xs[i], ys[i])) {
+			continue;
+		}
+
+		if (!HUMPathRepairIsMoveWalkable(query, xs[i - 1], ys[i - 1], xs[i], ys[i])) {
+			if (result->firstBrokenMove < 0) {
+				result->firstBrokenMove = i;
+			}
+
+			result->lastBrokenMove = i;
+		}
+	}
+
+	if (result->firstBrokenMove < 0) {
+		result->status = HUMPathRepairStatusUnchanged;
+		return;
+	}
+
+	// the last broken move may end on a tile that is now blocked, in which case the detour rejoins the path at the tile after it, which is
+	// only left out of the broken moves if it's still walkable
+	int32_t entry = result->firstBrokenMove - 1;
+	int32_t exit = result->lastBrokenMove;
+
+	if (!HUMPathRepairIsWalkable(query, xs[exit], ys[exit])) {
+		exit++;
+	}
+
+	if (exit >= query->count) {
+		return;
+	}
+
+	int32_t minimumX = xs[entry], maximumX = xs[entry];
+	int32_t minimumY = ys[entry], maximumY = ys[entry];
+
+	for (int32_t i = entry + 1; i <= exit; i++) {
+		minimumX = xs[i] < minimumX ? xs[i] : minimumX;
+		maximumX = xs[i] > maximumX ? xs[i] : maximumX;
+		minimumY = ys[i] < minimumY ? ys[i] : minimumY;
+		maximumY = ys[i] > maximumY ? ys[i] : maximumY;
+	}
+
+	minimumX = minimumX - HUMPathRepairWindowMargin > 0 ? minimumX - HUMPathRepairWindowMargin : 0;
+	minimumY = minimumY - HUMPathRepairWindowMargin > 0 ? minimumY - HUMPathRepairWindowMargin : 0;
+	maximumX = maximumX + HUMPathRepairWindowMargin < context->width - 1 ? maximumX + HUMPathRepairWindowMargin : context->width - 1;
+	maximumY = maximumY + HUMPathRepairWindowMargin < context->height - 1 ? maximumY + HUMPathRepairWindowMargin : context->height - 1;
+
+	HUMPathRepairWindow window = { query->sample, query->info, { minimumX, minimumY, maximumX - minimumX + 1, maximumY - minimumY + 1 } };
+
+	HUMSearchQuery search = { 0 };
+	search.startX = xs[entry];
+	search.startY = ys[entry];
+	search.targetX = xs[exit];
+	search.targetY = ys[exit];
+	search.neighbors = query->neighbors;
+	search.heuristic = query->heuristic;
+	search.sample = HUMPathRepairSampleWindow;
+	search.info = &window;
+
+	if (!HUMSearchFindPath(context, &search)) {
+		return;
+	}
+
+	// the detour includes both the entry and exit tiles
+	int32_t detourCount = HUMSearchCopyPath(context, NULL, NULL, 0);
+	int32_t count = entry + detourCount + (query->count - exit - 1);
+
+	result->xs = malloc((size_t)count * sizeof(int32_t));
+	result->ys = malloc((size_t)count * sizeof(int32_t));
+
+	if (!result->xs || !result->ys) {
+		return;
+	}
+
+	memcpy(result->xs, xs, (size_t)entry * sizeof(int32_t));
+	memcpy(result->ys, ys, (size_t)entry * sizeof(int32_t));
+	HUMSearchCopyPath(context, result->xs + entry, result->ys + entry, detourCount);
+	memcpy(result->xs + entry + detourCount, xs + exit + 1, (size_t)(query->count - exit - 1) * sizeof(int32_t));
+	memcpy(result->ys + entry + detourCount, ys + exit + 1, (size_t)(query->count - exit - 1) * sizeof(int32_t));
+
+	result->count = count;
+	result->status = HUMPathRepairStatusRepaired;
+}
+
+void HUMPathRepairResultFree(HUMPathRepairResult *result) {
+	free(result->xs);
+	free(result->ys);
+	result->xs = NULL;
+	result->ys = NULL;
+	result->count = 0;
+}
@@ -0,0 +1,63 @@
+//
+//  HUMAStarPathfinderPathRepair.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderPathRepair_h
+#define HUMAStarPathfinder_HUMAStarPathfinderPathRepair_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "HUMAStarPathfinderSearch.h"
+
+/**
+ *	How many tiles past the broken part of a path a detour may wander.
+ */
+#define HUMPathRepairWindowMargin 8
+
+typedef struct {
+	const int32_t *xs;					// every tile of the path, from the start tile to the target tile, each a single move from the last
+	const int32_t *ys;
+	int32_t count;
+
+	HUMSearchTileRect changedRect;		// the tiles whose walkability may have changed
+	HUMSearchNeighbors neighbors;
+	HUMSearchHeuristic heuristic;
+	HUMSearchSampleFunction sample;
+	void *info;
+} HUMPathRepairQuery;
+
+typedef enum {
+	HUMPathRepairStatusUnchanged = 0,	// every move of the path into the changed rect is still walkable
+	HUMPathRepairStatusRepaired,
+	HUMPathRepairStatusFailed			// no detour was found near the broken part, or the path isn't made of single moves
+} HUMPathRepairStatus;
+
+/**
+ *	The result of HUMPathRepair. Free it with HUMPathRepairResultFree.
+ */
+typedef struct {
+	HUMPathRepairStatus status;
+	int32_t *xs;						// the repaired path if it was repaired, otherwise NULL
+	int32_t *ys;
+	int32_t count;
+
+	int32_t firstBrokenMove;			// the first and last moves that were no longer walkable, where move i ends at tile i, or -1
+	int32_t lastBrokenMove;
+} HUMPathRepairResult;
+
+/**
+ *	Checks every move of a path that ends at, or cuts the corner of, a tile in the changed rect, with the same rules as HUMSearchFindPath. If
+ *  any is no longer walkable, searches for a detour from the tile before the first broken move to the first walkable tile after the last
+ *  one, staying within HUMPathRepairWindowMargin tiles of the broken part, and splices it into the path.
+ *
+ *	@param	context	A context for the whole map that hasn't been searched since it was last reset. Only searched if the path is broken.
+ *	@param	result	Filled with the result. Must be freed with HUMPathRepairResultFree, whatever the status.
+ */
+void HUMPathRepair(HUMSearchContext *context, const HUMPathRepairQuery *query, HUMPathRepairResult *result);
+void HUMPathRepairResultFree(HUMPathRepairResult *result);
+
+#endif
@@ -0,0 +1,90 @@
+//
+//  HUMAStarPathfinderReachableTiles.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *	The tiles that can be reached from an origin tile for at most a maximum movement cost, as found by
+ *  -[HUMAStarPathfinder reachableTilesFromTile:withinCost:]. Tile indexes are row-major: y * tileMapSize.width + x.
+ */
+@interface HUMAStarPathfinderReachableTiles : NSObject
+
+/**
+ *	Creates a result that takes ownership of buffers allocated with malloc. The buffers are freed when the result is deallocated.
+ *
+ *	@param	tileMapSize	The size of the tile map the buffers cover.
+ *	@param	origin		The tile location the search started from.
+ *	@param	maximumCost	The largest movement cost a reachable tile may have.
+ *	@param	count		The number of reachable tiles.
+ *	@param	bitmap		One bit per tile, rounded up to whole bytes. Required.
+ *	@param	costs		The movement cost of every tile, or UINT32_MAX if it isn't reachable. May be NULL.
+ *	@param	parents		The tile index of the tile before every tile on its cheapest path, or -1. May be NULL.
+ */
+- (id)initWithTileMapSize:(CGSize)tileMapSize originTileLocation:(CGPoint)origin maximumCost:(NSUInteger)maximumCost count:(NSUInteger)count bitmapNoCopy:(uint8_t *)bitmap costsNoCopy:(uint32_t *)costs parentsNoCopy:(int32_t *)parents;
+
+@property (nonatomic, readonly) CGSize tileMapSize;
+@property (nonatomic, readonly) CGPoint originTileLocation;
+@property (nonatomic, readonly) NSUInteger maximumCost;
+
+/**
+ *	The number of reachable tiles, including the origin.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ *	One bit per tile, set if the tile is reachable. The bit for tile index i is bit i % 8 of byte i / 8.
+ */
+@property (nonatomic, readonly) const uint8_t *bitmap;
+
+/**
+ *	The movement cost of the cheapest path to every tile, or UINT32_MAX if the tile isn't reachable. NULL if costs weren't requested.
+ */
+@property (nonatomic, readonly) const uint32_t *costs;
+
+/**
+ *	The tile index of the tile before every tile on its cheapest path, or -1 for the origin and tiles that aren't reachable. NULL if parents
+ *  weren't requested.
+ */
+@property (nonatomic, readonly) const int32_t *parents;
+
+/**
+ *	Determines if a tile can be reached.
+ *
+ *	@param	tileLocation	The tile location in question.
+ *
+ *	@return	YES, if the tile is within the tile map and reachable. NO, otherwise.
+ */
+- (BOOL)containsTileLocation:(CGPoint)tileLocation;
+
+/**
+ *	The movement cost of the cheapest path to a tile.
+ *
+ *	@param	tileLocation	The tile location in question.
+ *
+ *	@return	The cost, or NSNotFound if the tile isn't reachable or costs weren't requested.
+ */
+- (NSUInteger)costToTileLocation:(CGPoint)tileLocation;
+
+/**
+ *	Rebuilds the cheapest path to a reachable tile without running another search.
+ *
+ *	@param	tileLocation	The tile location the path should end at.
+ *
+ *	@return	An NSArray of NSValue-wrapped tile locations from the origin to tileLocation, or nil if the tile isn't reachable or parents weren't
+ *			requested. Use -[HUMAStarPathfinder positionForTileLocation:] to convert them to positions.
+ */
+- (NSArray *)pathToTileLocation:(CGPoint)tileLocation;
+
+/**
+ *	Calls the block with every reachable tile, in row-major order.
+ *
+ *	@param	block	The block to call. Set stop to YES to stop enumerating.
+ */
+- (void)enumerateTileLocationsUsingBlock:(void (^)(CGPoint tileLocation, BOOL *stop))block;
+
+@end
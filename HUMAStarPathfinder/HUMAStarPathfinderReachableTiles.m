@@ -0,0 +1,104 @@
+//
+//  HUMAStarPathfinderReachableTiles.m
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import "HUMAStarPathfinderReachableTiles.h"
+
+@implementation HUMAStarPathfinderReachableTiles
+
+- (id)initWithTileMapSize:(CGSize)tileMapSize originTileLocation:(CGPoint)origin maximumCost:(NSUInteger)maximumCost count:(NSUInteger)count bitmapNoCopy:(uint8_t *)bitmap costsNoCopy:(uint32_t *)costs parentsNoCopy:(int32_t *)parents {
+	NSParameterAssert(bitmap);
+	
+	self = [super init];
+	if (self) {
+		_tileMapSize = tileMapSize;
+		_originTileLocation = origin;
+		_maximumCost = maximumCost;
+		_count = count;
+		_bitmap = bitmap;
+		_costs = costs;
+		_parents = parents;
+	}
+	
+	return self;
+}
+
+- (void)dealloc {
+	free((void *)_bitmap);
+	free((void *)_costs);
+	free((void *)_parents);
+}
+
+/**
+ *	Converts a tile location to a tile index.
+ *
+ *	@return	The tile index, or -1 if the tile location is outside the tile map.
+ */
+- (NSInteger)indexForTileLocation:(CGPoint)tileLocation {
+	if (tileLocation.x < 0 || tileLocation.y < 0 || tileLocation.x >= self.tileMapSize.width || tileLocation.y >= self.tileMapSize.height) {
+		return -1;
+	}
+	
+	return (NSInteger)tileLocation.y * (NSInteger)self.tileMapSize.width + (NSInteger)tileLocation.x;
+}
+
+- (BOOL)containsTileLocation:(CGPoint)tileLocation {
+	NSInteger index = [self indexForTileLocation:tileLocation];
+	
+	return index != -1 && (_bitmap[index >> 3] & (1 << (index & 7)));
+}
+
+- (NSUInteger)costToTileLocation:(CGPoint)tileLocation {
+	if (!_costs || ![self containsTileLocation:tileLocation]) {
+		return NSNotFound;
+	}
+	
+	return _costs[[self indexForTileLocation:tileLocation]];
+}
+
+- (NSArray *)pathToTileLocation:(CGPoint)tileLocation {
+	if (!_parents || ![self containsTileLocation:tileLocation]) {
+		return nil;
+	}
+	
+	NSInteger width = self.tileMapSize.width;
+	NSMutableArray *path = [NSMutableArray array];
+	
+	for (int32_t index = (int32_t)[self indexForTileLocation:tileLocation]; index != -1; index = _parents[index]) {
+		CGPoint location = CGPointMake(index % width, index / width);
+#if TARGET_OS_IPHONE
+		[path addObject:[NSValue valueWithCGPoint:location]];
+#else
+		[path addObject:[NSValue valueWithPoint:location]];
+#endif
+	}
+	
+	return [[path reverseObjectEnumerator] allObjects];
+}
+
+- (void)enumerateTileLocationsUsingBlock:(void (^)(CGPoint tileLocation, BOOL *stop))block {
+	NSInteger width = self.tileMapSize.width;
+	NSInteger tileCount = width * (NSInteger)self.tileMapSize.height;
+	BOOL stop = NO;
+	
+	for (NSInteger byte = 0; byte < (tileCount + 7) / 8; byte++) {
+		uint8_t bits = _bitmap[byte];
+		
+		// skip over empty bytes, since most of the map is usually out of range
+		while (bits) {
+			NSInteger index = byte * 8 + __builtin_ctz(bits);
+			bits &= bits - 1;
+			
+			block(CGPointMake(index % width, index / width), &stop);
+			if (stop) {
+				return;
+			}
+		}
+	}
+}
+
+@end
@@ -0,0 +1,41 @@
+//
+//  HUMAStarPathfinderRepairedPath.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *	A path brought up to date after tiles along it changed, as returned by -[HUMAStarPathfinder repairPath:changedTilesInRect:unitSize:].
+ */
+@interface HUMAStarPathfinderRepairedPath : NSObject
+
+/**
+ *	Creates a repaired path.
+ *
+ *	@param	path		The path to follow now.
+ *	@param	repaired	Whether a detour was spliced into the original path.
+ *	@param	replanned	Whether the detour couldn't be found nearby and the whole path was searched again.
+ */
+- (id)initWithPath:(NSArray *)path repaired:(BOOL)repaired replanned:(BOOL)replanned;
+
+/**
+ *	An NSArray of NSValue-wrapped CGPoints from the start of the original path to its target, as -[HUMAStarPathfinder findPathFromStart:toTarget:]
+ *  returns. The original path if it's still walkable. @[] if there is no longer any path, or nil if the target is no longer walkable.
+ */
+@property (nonatomic, readonly) NSArray *path;
+
+/**
+ *	YES, if part of the original path was blocked and a detour around it was spliced in. The rest of the path is unchanged.
+ */
+@property (nonatomic, readonly, getter = isRepaired) BOOL repaired;
+
+/**
+ *	YES, if part of the original path was blocked and no detour was found near it, so the whole path was searched for again.
+ */
+@property (nonatomic, readonly, getter = isReplanned) BOOL replanned;
+
+@end
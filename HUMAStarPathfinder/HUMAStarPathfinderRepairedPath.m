@@ -0,0 +1,24 @@
+//
+//  HUMAStarPathfinderRepairedPath.m
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import "HUMAStarPathfinderRepairedPath.h"
+
+@implementation HUMAStarPathfinderRepairedPath
+
+- (id)initWithPath:(NSArray *)path repaired:(BOOL)repaired replanned:(BOOL)replanned {
+	self = [super init];
+	if (self) {
+		_path = path;
+		_repaired = repaired;
+		_replanned = replanned;
+	}
+	
+	return self;
+}
+
+@end
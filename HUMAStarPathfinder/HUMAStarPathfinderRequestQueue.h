@@ -0,0 +1,231 @@
+//
+//  HUMAStarPathfinderRequestQueue.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class HUMAStarPathfinder;
+
+/**
+ *	The priority class of a path request. Requests in a higher class are searched first.
+ */
+typedef NS_ENUM(NSUInteger, HUMAStarRequestPriority) {
+	HUMAStarRequestPriorityPlayer = 0,		// paths the player is waiting on
+	HUMAStarRequestPriorityAI,				// paths for computer controlled units
+	HUMAStarRequestPriorityBackground,		// speculative paths nobody is waiting on yet
+	HUMAStarRequestPriorityCount
+};
+
+/**
+ *	Called with the result of a path request. The path is the same as -[HUMAStarPathfinder findPathFromStart:toTarget:] would have returned.
+ */
+typedef void (^HUMAStarPathRequestCompletion)(NSArray *path);
+
+/**
+ *	Called with the provisional path of a progressive request, which the unit can start following while its full path is searched for. The path
+ *  is the same as -[HUMAStarPathfinder findProvisionalPathFromStart:toTarget:expansionLimit:] would have returned.
+ */
+typedef void (^HUMAStarProvisionalPathHandler)(NSArray *provisionalPath);
+
+/**
+ *	Spreads path requests over frames. Requests are queued, then searched in priority order from -update: until the frame's budget is used up.
+ *  Requests that wait long enough are promoted a class at a time, so a steady stream of player requests can't starve AI requests.
+ *
+ *  Requests from and to the same tiles are coalesced: only one search is run, and its path is delivered to every request. Each path still
+ *  starts at its own request's start position.
+ *
+ *  The queue runs searches on the thread -update: is called from, and isn't thread-safe. To drive it from Cocos2d, schedule it once:
+ *
+ *	[[[CCDirector sharedDirector] scheduler] scheduleUpdateForTarget:requestQueue priority:0 paused:NO];
+ */
+@interface HUMAStarPathfinderRequestQueue : NSObject
+
+///---------------------------
+/// @name Properties
+///---------------------------
+
+/**
+ *	The pathfinder requests are searched with.
+ */
+@property (nonatomic, strong, readonly) HUMAStarPathfinder *pathfinder;
+
+/**
+ *	The time -update: may spend searching per frame. At least one search is run per frame if any requests are pending, so a single slow search
+ *  can overrun the budget.
+ *
+ *  The default value is 0.004 (4 ms).
+ */
+@property (nonatomic, assign) NSTimeInterval frameBudget;
+
+/**
+ *	How long a request waits before it's treated as one class more important. A request that has waited twice this long is promoted two
+ *  classes, and so on. Set to 0 to disable aging.
+ *
+ *  The default value is 0.25.
+ */
+@property (nonatomic, assign) NSTimeInterval agingInterval;
+
+/**
+ *	The most tiles the greedy search for a progressive request's provisional path may expand. Larger limits reach the target more often, but
+ *  take longer and can commit the unit to a longer detour.
+ *
+ *  The default value is 256.
+ */
+@property (nonatomic, assign) NSUInteger provisionalExpansionLimit;
+
+///---------------------------
+/// @name Statistics
+///---------------------------
+
+/**
+ *	The number of searches waiting to be run. Coalesced requests share a search.
+ */
+@property (nonatomic, readonly) NSUInteger queueDepth;
+
+/**
+ *	The number of requests waiting for a path.
+ */
+@property (nonatomic, readonly) NSUInteger pendingRequestCount;
+
+/**
+ *	The number of requests that have received a path.
+ */
+@property (nonatomic, readonly) NSUInteger completedRequestCount;
+
+/**
+ *	The number of searches run. Lower than completedRequestCount by the number of requests that were coalesced.
+ */
+@property (nonatomic, readonly) NSUInteger searchCount;
+
+/**
+ *	The moving average of the time from a request being made to its path being delivered. For a progressive request, this is the time until
+ *  its final path is delivered.
+ */
+@property (nonatomic, readonly) NSTimeInterval averageLatency;
+
+/**
+ *	The longest time from a request being made to its path being delivered.
+ */
+@property (nonatomic, readonly) NSTimeInterval maximumLatency;
+
+/**
+ *	The moving average of the time from a request being made to the first path it's handed, which is the provisional path of a progressive
+ *  request that got one, and the final path otherwise. This is how long a unit waits before it can start moving.
+ */
+@property (nonatomic, readonly) NSTimeInterval averageTimeToFirstStep;
+
+/**
+ *	The longest time from a request being made to the first path it's handed.
+ */
+@property (nonatomic, readonly) NSTimeInterval maximumTimeToFirstStep;
+
+/**
+ *	The time spent searching and delivering paths during the last call to -update:.
+ */
+@property (nonatomic, readonly) NSTimeInterval lastUpdateDuration;
+
+///---------------------------
+/// @name Initialization
+///---------------------------
+
+/**
+ *	Creates a request queue.
+ *
+ *	@param	pathfinder	The pathfinder requests are searched with.
+ *
+ *	@return	A newly initialized HUMAStarPathfinderRequestQueue object.
+ */
++ (instancetype)requestQueueWithPathfinder:(HUMAStarPathfinder *)pathfinder;
+
+/**
+ *	Initializes a request queue.
+ *
+ *	@param	pathfinder	The pathfinder requests are searched with.
+ *
+ *	@return	An initialized HUMAStarPathfinderRequestQueue object.
+ */
+- (id)initWithPathfinder:(HUMAStarPathfinder *)pathfinder;
+
+///---------------------------
+/// @name Requests
+///---------------------------
+
+/**
+ *	Queues a path request. If a request from and to the same tiles is already queued, the two share a search, which runs at the higher of
+ *  their priorities.
+ *
+ *	@param	start		The start position.
+ *	@param	target		The target position.
+ *	@param	priority	The priority class of the request.
+ *	@param	completion	Called from -update: with the path once it has been found.
+ *
+ *	@return	A token identifying the request, which can be passed to -cancelRequest:.
+ */
+- (id)requestPathFromStart:(CGPoint)start toTarget:(CGPoint)target priority:(HUMAStarRequestPriority)priority completion:(HUMAStarPathRequestCompletion)completion;
+
+/**
+ *	Queues a path request that's first answered with a provisional path, found by a quick greedy search at the start of the next -update:
+ *  before any full search is run, so the unit can start moving right away. The full search still runs from the start position. Its shortest
+ *  path is then spliced onto the provisional path at the first tile ahead of the unit's last reported position that both paths cross, so
+ *  the final path starts with the provisional path and a unit that has been following it can switch over without jumping. Report the
+ *  unit's position with -reportPosition:forRequest: as it moves. A unit that never reports is treated as if it hadn't moved, so its final
+ *  path leads back along the tiles it has already walked.
+ *
+ *  The final path is the shortest path from the start if the unit hasn't moved yet. Otherwise it's the shortest path through the splice
+ *  tile: the unit finishes the stretch of the provisional path up to that tile even when leaving it earlier would be cheaper. If the
+ *  shortest path crosses no tile ahead of the unit, the rest of the path is searched for again from the unit's position.
+ *
+ *  Progressive requests are never coalesced with other requests, since each is answered with its own provisional path first.
+ *
+ *	@param	start		The start position.
+ *	@param	target		The target position.
+ *	@param	priority	The priority class of the full search.
+ *	@param	provisional	Called from -update: with the provisional path. Not called if no provisional path was found, in which case the full
+ *						search starts from the start position as usual.
+ *	@param	completion	Called from -update: with the final path once it has been found.
+ *
+ *	@return	A token identifying the request, which can be passed to -cancelRequest:.
+ */
+- (id)requestProgressivePathFromStart:(CGPoint)start toTarget:(CGPoint)target priority:(HUMAStarRequestPriority)priority provisional:(HUMAStarProvisionalPathHandler)provisional completion:(HUMAStarPathRequestCompletion)completion;
+
+/**
+ *	Tells the queue where the unit of a progressive request is along its provisional path, so its final path is spliced onto the stretch the
+ *  unit hasn't walked yet. Call it whenever the unit reaches a new tile. Positions off the provisional path, or behind the last reported one,
+ *  are ignored.
+ *
+ *	@param	position	The unit's position.
+ *	@param	request		The token returned when the request was made.
+ */
+- (void)reportPosition:(CGPoint)position forRequest:(id)request;
+
+/**
+ *	Cancels a request that hasn't received its path yet. Its completion is never called. If the request was coalesced with others, their
+ *  shared search still runs.
+ *
+ *	@param	request	The token returned when the request was made.
+ */
+- (void)cancelRequest:(id)request;
+
+/**
+ *	Cancels every pending request.
+ */
+- (void)cancelAllRequests;
+
+/**
+ *	Finds and delivers the provisional paths of the progressive requests made since the last call, then runs queued searches in priority order
+ *  until the frame budget is used up, and delivers their paths. Matches the update selector CCScheduler calls.
+ *
+ *	@param	delta	The time since the last frame. Unused.
+ */
+- (void)update:(float)delta;
+
+/**
+ *	Resets completedRequestCount, searchCount, averageLatency, maximumLatency, averageTimeToFirstStep, and maximumTimeToFirstStep.
+ */
+- (void)resetStatistics;
+
+@end
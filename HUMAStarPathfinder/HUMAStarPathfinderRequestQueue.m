@@ -0,0 +1,521 @@
+//
+//  HUMAStarPathfinderRequestQueue.m
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import "HUMAStarPathfinderRequestQueue.h"
+#import "HUMAStarPathfinder.h"
+
+/**
+ *	The weight of the newest latency in averageLatency.
+ */
+static const NSTimeInterval HUMAStarRequestLatencySmoothing = 0.1;
+
+/**
+ *	The start and target tiles requests are coalesced by.
+ */
+typedef struct {
+	int32_t startX;
+	int32_t startY;
+	int32_t targetX;
+	int32_t targetY;
+} HUMAStarPathRequestKey;
+
+@class HUMAStarPathRequest;
+
+/**
+ *	A single caller waiting on a search. This is the token handed back to the caller.
+ */
+@interface HUMAStarPathRequestWaiter : NSObject
+@property (nonatomic, assign) CGPoint startPoint;
+@property (nonatomic, copy) HUMAStarPathRequestCompletion completion;
+@property (nonatomic, copy) HUMAStarProvisionalPathHandler provisional;
+@property (nonatomic, strong) NSArray *provisionalPath;		// the provisional path handed to a progressive request, which the final path continues
+@property (nonatomic, assign) NSUInteger provisionalProgress;	// the index in provisionalPath of the last position the unit reported
+@property (nonatomic, assign) CFAbsoluteTime requestTime;
+@property (nonatomic, assign) BOOL receivedFirstStep;
+@property (nonatomic, weak) HUMAStarPathRequest *request;
+@end
+
+@implementation HUMAStarPathRequestWaiter
+@end
+
+/**
+ *	A queued search and everyone waiting on it.
+ */
+@interface HUMAStarPathRequest : NSObject
+@property (nonatomic, strong) NSValue *key;						// nil for a progressive request, which is never coalesced
+@property (nonatomic, assign) CGPoint startPoint;
+@property (nonatomic, assign) CGPoint targetPoint;
+@property (nonatomic, assign) HUMAStarRequestPriority priority;
+@property (nonatomic, assign) CFAbsoluteTime enqueueTime;
+@property (nonatomic, strong) NSMutableArray *waiters;
+@end
+
+@implementation HUMAStarPathRequest
+@end
+
+@interface HUMAStarPathfinderRequestQueue ()
+@property (nonatomic, strong, readwrite) HUMAStarPathfinder *pathfinder;
+@property (nonatomic, strong) NSArray *queues;					// one FIFO of HUMAStarPathRequest per priority class
+@property (nonatomic, strong) NSMutableDictionary *requestsByKey;
+@property (nonatomic, strong) NSMutableArray *provisionalRequests;		// progressive requests waiting for their provisional paths
+@property (nonatomic, readwrite) NSUInteger queueDepth;
+@property (nonatomic, readwrite) NSUInteger pendingRequestCount;
+@property (nonatomic, readwrite) NSUInteger completedRequestCount;
+@property (nonatomic, readwrite) NSUInteger searchCount;
+@property (nonatomic, readwrite) NSTimeInterval averageLatency;
+@property (nonatomic, readwrite) NSTimeInterval maximumLatency;
+@property (nonatomic, readwrite) NSTimeInterval averageTimeToFirstStep;
+@property (nonatomic, readwrite) NSTimeInterval maximumTimeToFirstStep;
+@property (nonatomic, assign) NSUInteger firstStepCount;
+@property (nonatomic, readwrite) NSTimeInterval lastUpdateDuration;
+@end
+
+@implementation HUMAStarPathfinderRequestQueue
+
+#pragma mark - Init
+
++ (instancetype)requestQueueWithPathfinder:(HUMAStarPathfinder *)pathfinder {
+	return [[self alloc] initWithPathfinder:pathfinder];
+}
+
+- (id)initWithPathfinder:(HUMAStarPathfinder *)pathfinder {
+	NSParameterAssert(pathfinder);
+
+	self = [super init];
+	if (self) {
+		self.pathfinder = pathfinder;
+		self.frameBudget = 0.004;
+		self.agingInterval = 0.25;
+		self.provisionalExpansionLimit = 256;
+		self.requestsByKey = [NSMutableDictionary dictionary];
+		self.provisionalRequests = [NSMutableArray array];
+
+		NSMutableArray *queues = [NSMutableArray arrayWithCapacity:HUMAStarRequestPriorityCount];
+		for (NSUInteger priority = 0; priority < HUMAStarRequestPriorityCount; priority++) {
+			[queues addObject:[NSMutableArray array]];
+		}
+
+		self.queues = queues;
+	}
+
+	return self;
+}
+
+#pragma mark - Requests
+
+- (id)requestPathFromStart:(CGPoint)start toTarget:(CGPoint)target priority:(HUMAStarRequestPriority)priority completion:(HUMAStarPathRequestCompletion)completion {
+	NSParameterAssert(priority < HUMAStarRequestPriorityCount);
+	NSParameterAssert(completion);
+
+	CGPoint startTile = [self.pathfinder tileLocationForPosition:start];
+	CGPoint targetTile = [self.pathfinder tileLocationForPosition:target];
+	HUMAStarPathRequestKey key = { (int32_t)startTile.x, (int32_t)startTile.y, (int32_t)targetTile.x, (int32_t)targetTile.y };
+	NSValue *keyValue = [NSValue valueWithBytes:&key objCType:@encode(HUMAStarPathRequestKey)];
+	CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+
+	HUMAStarPathRequest *request = self.requestsByKey[keyValue];
+
+	if (!request) {
+		request = [[HUMAStarPathRequest alloc] init];
+		request.key = keyValue;
+		request.startPoint = start;
+		request.targetPoint = target;
+		request.priority = priority;
+		request.enqueueTime = now;
+		request.waiters = [NSMutableArray array];
+
+		self.requestsByKey[keyValue] = request;
+		[self.queues[priority] addObject:request];
+		self.queueDepth++;
+	}
+	else if (priority < request.priority) {
+		// the shared search runs at the most important waiter's priority. It keeps its enqueue time, so it goes to the back of its new class
+		// only if it hasn't already aged past it.
+		[self.queues[request.priority] removeObjectIdenticalTo:request];
+		[self insertRequest:request intoQueue:self.queues[priority]];
+		request.priority = priority;
+	}
+
+	HUMAStarPathRequestWaiter *waiter = [[HUMAStarPathRequestWaiter alloc] init];
+	waiter.startPoint = start;
+	waiter.completion = completion;
+	waiter.requestTime = now;
+	waiter.request = request;
+
+	[request.waiters addObject:waiter];
+	self.pendingRequestCount++;
+
+	return waiter;
+}
+
+- (id)requestProgressivePathFromStart:(CGPoint)start toTarget:(CGPoint)target priority:(HUMAStarRequestPriority)priority provisional:(HUMAStarProvisionalPathHandler)provisional completion:(HUMAStarPathRequestCompletion)completion {
+	NSParameterAssert(priority < HUMAStarRequestPriorityCount);
+	NSParameterAssert(provisional);
+	NSParameterAssert(completion);
+
+	CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+
+	HUMAStarPathRequest *request = [[HUMAStarPathRequest alloc] init];
+	request.startPoint = start;
+	request.targetPoint = target;
+	request.priority = priority;
+	request.enqueueTime = now;
+	request.waiters = [NSMutableArray array];
+
+	[self.queues[priority] addObject:request];
+	[self.provisionalRequests addObject:request];
+	self.queueDepth++;
+
+	HUMAStarPathRequestWaiter *waiter = [[HUMAStarPathRequestWaiter alloc] init];
+	waiter.startPoint = start;
+	waiter.completion = completion;
+	waiter.provisional = provisional;
+	waiter.requestTime = now;
+	waiter.request = request;
+
+	[request.waiters addObject:waiter];
+	self.pendingRequestCount++;
+
+	return waiter;
+}
+
+/**
+ *	Inserts a request into a class's queue, keeping the queue ordered by enqueue time.
+ */
+- (void)insertRequest:(HUMAStarPathRequest *)request intoQueue:(NSMutableArray *)queue {
+	NSUInteger index = queue.count;
+
+	while (index > 0 && [queue[index - 1] enqueueTime] > request.enqueueTime) {
+		index--;
+	}
+
+	[queue insertObject:request atIndex:index];
+}
+
+- (void)cancelRequest:(id)request {
+	if (![request isKindOfClass:[HUMAStarPathRequestWaiter class]]) {
+		return;
+	}
+
+	HUMAStarPathRequestWaiter *waiter = request;
+	HUMAStarPathRequest *pathRequest = waiter.request;
+
+	if (!pathRequest || ![pathRequest.waiters containsObject:waiter]) {
+		return;
+	}
+
+	[pathRequest.waiters removeObjectIdenticalTo:waiter];
+	waiter.request = nil;
+	self.pendingRequestCount--;
+
+	if (pathRequest.waiters.count == 0) {
+		[self removeRequest:pathRequest];
+	}
+}
+
+- (void)reportPosition:(CGPoint)position forRequest:(id)request {
+	if (![request isKindOfClass:[HUMAStarPathRequestWaiter class]]) {
+		return;
+	}
+
+	HUMAStarPathRequestWaiter *waiter = request;
+	NSArray *provisionalPath = waiter.provisionalPath;
+
+	if (!waiter.request || !provisionalPath) {
+		return;
+	}
+
+	CGPoint tile = [self.pathfinder tileLocationForPosition:position];
+
+	// units only move forward along the provisional path, so only the tiles ahead of the last reported one are considered
+	for (NSUInteger index = waiter.provisionalProgress; index < provisionalPath.count; index++) {
+		if (CGPointEqualToPoint([self tileLocationOfPathPoint:provisionalPath[index]], tile)) {
+			waiter.provisionalProgress = index;
+			return;
+		}
+	}
+}
+
+- (void)cancelAllRequests {
+	// detach every waiter, so cancelling one of their tokens later finds nothing to cancel
+	for (NSMutableArray *queue in self.queues) {
+		for (HUMAStarPathRequest *request in queue) {
+			for (HUMAStarPathRequestWaiter *waiter in request.waiters) {
+				waiter.request = nil;
+			}
+
+			[request.waiters removeAllObjects];
+		}
+
+		[queue removeAllObjects];
+	}
+
+	[self.requestsByKey removeAllObjects];
+	[self.provisionalRequests removeAllObjects];
+	self.queueDepth = 0;
+	self.pendingRequestCount = 0;
+}
+
+/**
+ *	Takes a request off the queue. Does nothing if it isn't queued.
+ */
+- (void)removeRequest:(HUMAStarPathRequest *)request {
+	NSMutableArray *queue = request ? self.queues[request.priority] : nil;
+	NSUInteger index = request ? [queue indexOfObjectIdenticalTo:request] : NSNotFound;
+
+	if (index == NSNotFound) {
+		return;
+	}
+
+	[queue removeObjectAtIndex:index];
+	[self.provisionalRequests removeObjectIdenticalTo:request];
+
+	if (request.key) {
+		[self.requestsByKey removeObjectForKey:request.key];
+	}
+
+	self.queueDepth--;
+}
+
+#pragma mark - Scheduling
+
+/**
+ *	The request to search next: the front of the class whose front request has the best priority after aging. Ties go to the more important
+ *  class. Every class is FIFO, so its front request has waited the longest and is the only one that needs to be considered.
+ */
+- (HUMAStarPathRequest *)nextRequestAtTime:(CFAbsoluteTime)now {
+	HUMAStarPathRequest *next = nil;
+	double nextPriority = HUGE_VAL;
+
+	for (NSMutableArray *queue in self.queues) {
+		if (queue.count == 0) {
+			continue;
+		}
+
+		HUMAStarPathRequest *request = queue[0];
+
+		double priority = request.priority;
+
+		if (self.agingInterval > 0) {
+			priority -= floor((now - request.enqueueTime) / self.agingInterval);
+		}
+
+		if (priority < nextPriority) {
+			next = request;
+			nextPriority = priority;
+		}
+	}
+
+	return next;
+}
+
+- (void)update:(float)delta {
+	CFAbsoluteTime updateStart = CFAbsoluteTimeGetCurrent();
+	CFAbsoluteTime now = updateStart;
+
+	// provisional paths are what players see first and each search is capped, so they're all found before any full search, whatever the budget
+	if (self.provisionalRequests.count > 0) {
+		NSArray *requests = [self.provisionalRequests copy];
+		[self.provisionalRequests removeAllObjects];
+
+		for (HUMAStarPathRequest *request in requests) {
+			[self deliverProvisionalPathForRequest:request];
+		}
+
+		now = CFAbsoluteTimeGetCurrent();
+	}
+
+	while (self.queueDepth > 0) {
+		HUMAStarPathRequest *request = [self nextRequestAtTime:now];
+
+		// remove the request before delivering, so completions can queue new requests, including one for the same tiles
+		[self removeRequest:request];
+
+		NSArray *path = [self.pathfinder findPathFromStart:request.startPoint toTarget:request.targetPoint];
+		self.searchCount++;
+
+		now = CFAbsoluteTimeGetCurrent();
+		[self deliverPath:path forRequest:request atTime:now];
+
+		now = CFAbsoluteTimeGetCurrent();
+		if (now - updateStart >= self.frameBudget) {
+			break;
+		}
+	}
+
+	self.lastUpdateDuration = now - updateStart;
+}
+
+/**
+ *	Finds the provisional path of a progressive request and hands it to its waiter. The request's full search still runs from the start, and its
+ *  path is spliced onto the provisional path when it's delivered.
+ */
+- (void)deliverProvisionalPathForRequest:(HUMAStarPathRequest *)request {
+	HUMAStarPathRequestWaiter *waiter = request.waiters.firstObject;
+
+	// cancelled by the handler of an earlier provisional path
+	if (!waiter) {
+		return;
+	}
+
+	NSArray *path = [self.pathfinder findProvisionalPathFromStart:request.startPoint toTarget:request.targetPoint expansionLimit:self.provisionalExpansionLimit];
+
+	if (!path) {
+		return;
+	}
+
+	[self recordFirstStepForWaiter:waiter atTime:CFAbsoluteTimeGetCurrent()];
+	waiter.provisionalPath = path;
+	waiter.provisionalProgress = 0;
+	waiter.provisional(path);
+}
+
+/**
+ *	Counts the time a waiter waited for the first path it was handed, the first time it's handed one.
+ */
+- (void)recordFirstStepForWaiter:(HUMAStarPathRequestWaiter *)waiter atTime:(CFAbsoluteTime)now {
+	if (waiter.receivedFirstStep) {
+		return;
+	}
+
+	waiter.receivedFirstStep = YES;
+
+	NSTimeInterval timeToFirstStep = now - waiter.requestTime;
+	self.averageTimeToFirstStep = self.firstStepCount == 0 ? timeToFirstStep : self.averageTimeToFirstStep + (timeToFirstStep - self.averageTimeToFirstStep) * HUMAStarRequestLatencySmoothing;
+	self.maximumTimeToFirstStep = MAX(self.maximumTimeToFirstStep, timeToFirstStep);
+	self.firstStepCount++;
+}
+
+/**
+ *	Hands the path to every waiter, each with the path starting at its own start position. A waiter that was handed a provisional path gets
+ *  the path spliced onto its provisional path instead.
+ */
+- (void)deliverPath:(NSArray *)path forRequest:(HUMAStarPathRequest *)request atTime:(CFAbsoluteTime)now {
+	NSArray *waiters = [request.waiters copy];
+	[request.waiters removeAllObjects];
+
+	self.pendingRequestCount -= waiters.count;
+
+	for (HUMAStarPathRequestWaiter *waiter in waiters) {
+		waiter.request = nil;
+
+		NSTimeInterval latency = now - waiter.requestTime;
+		self.averageLatency = self.completedRequestCount == 0 ? latency : self.averageLatency + (latency - self.averageLatency) * HUMAStarRequestLatencySmoothing;
+		self.maximumLatency = MAX(self.maximumLatency, latency);
+		self.completedRequestCount++;
+
+		[self recordFirstStepForWaiter:waiter atTime:now];
+
+		NSArray *waiterPath = path;
+
+		if (waiter.provisionalPath) {
+			waiterPath = [self splicePath:path ontoProvisionalPathOfWaiter:waiter targetPoint:request.targetPoint];
+		}
+		else if (path.count > 0 && !CGPointEqualToPoint(waiter.startPoint, request.startPoint)) {
+			NSMutableArray *adjustedPath = [path mutableCopy];
+#if TARGET_OS_IPHONE
+			adjustedPath[0] = [NSValue valueWithCGPoint:waiter.startPoint];
+#else
+			adjustedPath[0] = [NSValue valueWithPoint:waiter.startPoint];
+#endif
+			waiterPath = adjustedPath;
+		}
+
+		waiter.completion(waiterPath);
+	}
+}
+
+/**
+ *	Joins the shortest path from a progressive request's start with the provisional path its unit is following. The unit keeps following the
+ *  provisional path from its last reported position to the first tile ahead that the shortest path also crosses, then takes the rest of the
+ *  shortest path from there. If the unit hasn't moved, that's the shortest path itself.
+ *
+ *  When the shortest path crosses none of the tiles ahead of the unit, the rest of the path is searched for again from the unit's position.
+ *
+ *	@param	path	The shortest path from the request's start position to its target.
+ *
+ *	@return	The provisional path up to the splice tile, followed by the shortest path from there.
+ */
+- (NSArray *)splicePath:(NSArray *)path ontoProvisionalPathOfWaiter:(HUMAStarPathRequestWaiter *)waiter targetPoint:(CGPoint)targetPoint {
+	NSArray *provisionalPath = waiter.provisionalPath;
+	NSUInteger progress = waiter.provisionalProgress;
+
+	if (path.count == 0) {
+		return path;
+	}
+
+	NSMutableDictionary *indexesByTile = [NSMutableDictionary dictionaryWithCapacity:path.count];
+
+	for (NSUInteger index = 0; index < path.count; index++) {
+		CGPoint tile = [self tileLocationOfPathPoint:path[index]];
+		NSValue *tileValue = [NSValue valueWithBytes:&tile objCType:@encode(CGPoint)];
+
+		if (!indexesByTile[tileValue]) {
+			indexesByTile[tileValue] = @(index);
+		}
+	}
+
+	NSArray *rest = nil;
+	NSUInteger spliceIndex = progress;
+
+	for (NSUInteger index = progress; index < provisionalPath.count; index++) {
+		CGPoint tile = [self tileLocationOfPathPoint:provisionalPath[index]];
+		NSNumber *pathIndex = indexesByTile[[NSValue valueWithBytes:&tile objCType:@encode(CGPoint)]];
+
+		if (pathIndex) {
+			rest = [path subarrayWithRange:NSMakeRange(pathIndex.unsignedIntegerValue, path.count - pathIndex.unsignedIntegerValue)];
+			spliceIndex = index;
+			break;
+		}
+	}
+
+	if (!rest) {
+#if TARGET_OS_IPHONE
+		CGPoint position = [provisionalPath[progress] CGPointValue];
+#else
+		CGPoint position = [provisionalPath[progress] pointValue];
+#endif
+
+		rest = [self.pathfinder findPathFromStart:position toTarget:targetPoint];
+		self.searchCount++;
+
+		if (rest.count == 0) {
+			return rest;
+		}
+	}
+
+	NSMutableArray *splicedPath = [[provisionalPath subarrayWithRange:NSMakeRange(0, spliceIndex + 1)] mutableCopy];
+	[splicedPath addObjectsFromArray:[rest subarrayWithRange:NSMakeRange(1, rest.count - 1)]];
+
+	return splicedPath;
+}
+
+/**
+ *	The tile under a point of a path returned by the pathfinder.
+ */
+- (CGPoint)tileLocationOfPathPoint:(NSValue *)point {
+#if TARGET_OS_IPHONE
+	return [self.pathfinder tileLocationForPosition:[point CGPointValue]];
+#else
+	return [self.pathfinder tileLocationForPosition:[point pointValue]];
+#endif
+}
+
+#pragma mark - Statistics
+
+- (void)resetStatistics {
+	self.completedRequestCount = 0;
+	self.searchCount = 0;
+	self.averageLatency = 0;
+	self.maximumLatency = 0;
+	self.averageTimeToFirstStep = 0;
+	self.maximumTimeToFirstStep = 0;
+	self.firstStepCount = 0;
+}
+
+@end
@@ -0,0 +1,999 @@
+//
+//  HUMAStarPathfinderSearch.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderSearch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define HUM_ALWAYS_INLINE static inline __attribute__((always_inline))
+
+#pragma mark - Context
+static bool HUMSearchFrontierAllocate(HUMSearchFrontier *frontier, size_t nodeCount, size_t tileCount) {
+	frontier->g = malloc(nodeCount * sizeof(uint32_t));
+	frontier->parent = malloc(nodeCount * sizeof(int32_t));
+	frontier->heapIndex = malloc(nodeCount * sizeof(int32_t));
+	frontier->heap = malloc(tileCount * sizeof(HUMSearchHeapEntry));
+	frontier->heapCount = 0;
+
+	return frontier->g && frontier->parent && frontier->heapIndex && frontier->heap;
+}
+
+static void HUMSearchFrontierFree(HUMSearchFrontier *frontier) {
+	free(frontier->g);
+	free(frontier->parent);
+	free(frontier->heapIndex);
+	free(frontier->heap);
+	memset(frontier, 0, sizeof(HUMSearchFrontier));
+}
+
+/**
+ *	Spreads the bits of a block coordinate out to every other bit of a Morton index.
+ */
+static int32_t HUMSearchMortonSpread(int32_t bits) {
+	bits = (bits | (bits << 2)) & 0x33;
+	bits = (bits | (bits << 1)) & 0x55;
+	return bits;
+}
+
+/**
+ *	Fills the column and row offsets whose sums give the node of every tile in the layout.
+ */
+static void HUMSearchLayoutOffsets(HUMSearchContext *context) {
+	const int32_t columns = context->width + 2;
+	const int32_t rows = context->height + 2;
+	const int32_t blockArea = HUMSearchBlockSize * HUMSearchBlockSize;
+	const int32_t mask = HUMSearchBlockSize - 1;
+
+	for (int32_t column = 0; column < columns; column++) {
+		int32_t local = column & mask;
+
+		switch (context->layout) {
+			case HUMSearchLayoutBlocked:
+				context->columnOffsets[column] = (column >> HUMSearchBlockShift) * blockArea + local;
+				break;
+
+			case HUMSearchLayoutMorton:
+				context->columnOffsets[column] = (column >> HUMSearchBlockShift) * blockArea + HUMSearchMortonSpread(local);
+				break;
+
+			case HUMSearchLayoutRowMajor:
+			default:
+				context->columnOffsets[column] = column;
+				break;
+		}
+	}
+
+	for (int32_t row = 0; row < rows; row++) {
+		int32_t local = row & mask;
+		int32_t blockRow = (row >> HUMSearchBlockShift) * context->blocksPerRow * blockArea;
+
+		switch (context->layout) {
+			case HUMSearchLayoutBlocked:
+				context->rowOffsets[row] = blockRow + (local << HUMSearchBlockShift);
+				break;
+
+			case HUMSearchLayoutMorton:
+				context->rowOffsets[row] = blockRow + (HUMSearchMortonSpread(local) << 1);
+				break;
+
+			case HUMSearchLayoutRowMajor:
+			default:
+				context->rowOffsets[row] = row * context->stride;
+				break;
+		}
+	}
+}
+
+HUMSearchContext *HUMSearchContextCreate(int32_t width, int32_t height, HUMSearchLayout layout) {
+	HUMSearchContext *context = calloc(1, sizeof(HUMSearchContext));
+	if (!context) {
+		return NULL;
+	}
+
+	int32_t stride = width + 2;
+	int32_t blocksPerRow = (width + 2 + HUMSearchBlockSize - 1) >> HUMSearchBlockShift;
+	int32_t blocksPerColumn = (height + 2 + HUMSearchBlockSize - 1) >> HUMSearchBlockShift;
+	size_t nodeCount = (size_t)stride * (size_t)(height + 2);
+	size_t tileCount = (size_t)width * (size_t)height;
+
+	if (layout != HUMSearchLayoutRowMajor) {
+		nodeCount = (size_t)blocksPerRow * (size_t)blocksPerColumn * HUMSearchBlockSize * HUMSearchBlockSize;
+	}
+
+	context->width = width;
+	context->height = height;
+	context->layout = layout;
+	context->stride = stride;
+	context->blocksPerRow = blocksPerRow;
+	context->nodeCount = (int32_t)nodeCount;
+	context->columnOffsets = malloc((size_t)(width + 2) * sizeof(int32_t));
+	context->rowOffsets = malloc((size_t)(height + 2) * sizeof(int32_t));
+	context->state = malloc(nodeCount * sizeof(uint8_t));
+	context->cost = malloc(nodeCount * sizeof(uint32_t));
+	context->touched = malloc(tileCount * sizeof(int32_t));
+
+	if (!context->columnOffsets || !context->rowOffsets || !context->state || !context->cost || !context->touched || !HUMSearchFrontierAllocate(&context->forward, nodeCount, tileCount)) {
+		HUMSearchContextFree(context);
+		return NULL;
+	}
+
+	HUMSearchLayoutOffsets(context);
+
+	// interior tiles start out unsampled. The sentinel border, and the padding that rounds the blocked layouts up to whole blocks, is sampled
+	// as blocked and stays that way, since it is never touched.
+	memset(context->state, HUMSearchTileSampled | HUMSearchTileClosed, nodeCount);
+	for (int32_t y = 0; y < height; y++) {
+		if (layout == HUMSearchLayoutRowMajor) {
+			memset(context->state + (size_t)(y + 1) * stride + 1, 0, (size_t)width);
+			continue;
+		}
+
+		for (int32_t x = 0; x < width; x++) {
+			context->state[HUMSearchNodeForTile(context, x, y)] = 0;
+		}
+	}
+
+	return context;
+}
+
+void HUMSearchContextFree(HUMSearchContext *context) {
+	if (!context) {
+		return;
+	}
+
+	free(context->columnOffsets);
+	free(context->rowOffsets);
+	free(context->state);
+	free(context->cost);
+	free(context->touched);
+	HUMSearchFrontierFree(&context->forward);
+	HUMSearchFrontierFree(&context->backward);
+	free(context);
+}
+
+void HUMSearchContextReset(HUMSearchContext *context) {
+	uint8_t *state = context->state;
+	const int32_t *touched = context->touched;
+
+	for (int32_t i = 0; i < context->touchedCount; i++) {
+		state[touched[i]] = 0;
+	}
+
+	context->touchedCount = 0;
+	context->forward.heapCount = 0;
+	context->backward.heapCount = 0;
+}
+
+HUMSearchNeighbors HUMSearchNeighborsForRules(bool pathDiagonally, bool ignoreDiagonalBarriers, bool pathCanCrossBorders) {
+	if (!pathDiagonally) {
+		return HUMSearchNeighborsCardinal;
+	}
+	else if (ignoreDiagonalBarriers) {
+		return HUMSearchNeighborsDiagonal;
+	}
+	else if (pathCanCrossBorders) {
+		return HUMSearchNeighborsDiagonalCrossBorders;
+	}
+	else {
+		return HUMSearchNeighborsDiagonalStrict;
+	}
+}
+
+#pragma mark - Sampling
+static bool HUMSearchIsTilePruned(const HUMSearchContext *context, int32_t x, int32_t y) {
+	int32_t index = y * context->width + x;
+	if (!(context->prunedTiles[index >> 3] & (1 << (index & 7)))) {
+		return false;
+	}
+
+	for (int32_t i = 0; i < 2; i++) {
+		const HUMSearchTileRect *rect = &context->keptRects[i];
+		if (x >= rect->x && y >= rect->y && x < rect->x + rect->width && y < rect->y + rect->height) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ *	Asks the sample function about a tile the search hasn't reached yet and records it so its state is cleared on reset.
+ */
+static uint8_t HUMSearchSample(HUMSearchContext *context, int32_t node) {
+	bool walkable = false;
+	uint32_t cost = 0;
+	int32_t x, y;
+
+	HUMSearchNodeTile(context, node, &x, &y);
+	context->sample(context->info, x, y, &walkable, &cost);
+
+	uint8_t state = HUMSearchTileSampled | (walkable ? HUMSearchTileWalkable : 0);
+
+	if (walkable && context->prunedTiles && HUMSearchIsTilePruned(context, x, y)) {
+		state |= HUMSearchTilePruned;
+	}
+
+	context->state[node] = state;
+	context->cost[node] = cost;
+	context->touched[context->touchedCount++] = node;
+
+	return state;
+}
+
+HUM_ALWAYS_INLINE uint8_t HUMSearchState(HUMSearchContext *context, int32_t node) {
+	uint8_t state = context->state[node];
+	return (state & HUMSearchTileSampled) ? state : HUMSearchSample(context, node);
+}
+
+#pragma mark - Open List
+HUM_ALWAYS_INLINE void HUMSearchHeapSiftUp(HUMSearchFrontier *frontier, int32_t index) {
+	HUMSearchHeapEntry *heap = frontier->heap;
+	HUMSearchHeapEntry entry = heap[index];
+
+	while (index > 0) {
+		int32_t parentIndex = (index - 1) >> 1;
+		if (heap[parentIndex].f <= entry.f) {
+			break;
+		}
+
+		heap[index] = heap[parentIndex];
+		frontier->heapIndex[heap[index].node] = index;
+		index = parentIndex;
+	}
+
+	heap[index] = entry;
+	frontier->heapIndex[entry.node] = index;
+}
+
+HUM_ALWAYS_INLINE void HUMSearchHeapSiftDown(HUMSearchFrontier *frontier, int32_t index) {
+	HUMSearchHeapEntry *heap = frontier->heap;
+	HUMSearchHeapEntry entry = heap[index];
+	int32_t count = frontier->heapCount;
+
+	while (1) {
+		int32_t child = (index << 1) + 1;
+		if (child >= count) {
+			break;
+		}
+
+		if (child + 1 < count && heap[child + 1].f < heap[child].f) {
+			child++;
+		}
+
+		if (entry.f <= heap[child].f) {
+			break;
+		}
+
+		heap[index] = heap[child];
+		frontier->heapIndex[heap[index].node] = index;
+		index = child;
+	}
+
+	heap[index] = entry;
+	frontier->heapIndex[entry.node] = index;
+}
+
+HUM_ALWAYS_INLINE void HUMSearchHeapPush(HUMSearchFrontier *frontier, int32_t node, float f) {
+	int32_t index = frontier->heapCount++;
+	frontier->heap[index].f = f;
+	frontier->heap[index].node = node;
+	HUMSearchHeapSiftUp(frontier, index);
+}
+
+HUM_ALWAYS_INLINE void HUMSearchHeapDecrease(HUMSearchFrontier *frontier, int32_t node, float f) {
+	int32_t index = frontier->heapIndex[node];
+	frontier->heap[index].f = f;
+	HUMSearchHeapSiftUp(frontier, index);
+}
+
+HUM_ALWAYS_INLINE int32_t HUMSearchHeapPop(HUMSearchFrontier *frontier) {
+	int32_t node = frontier->heap[0].node;
+
+	if (--frontier->heapCount > 0) {
+		frontier->heap[0] = frontier->heap[frontier->heapCount];
+		HUMSearchHeapSiftDown(frontier, 0);
+	}
+
+	return node;
+}
+
+#pragma mark - Expansion
+/**
+ *	What the open list is ordered by. A* orders tiles by g plus the estimate to the target, a cost search by g plus the estimate to the nearest
+ *  tile of the targets' bounds, and a greedy search by the estimate to the target alone.
+ */
+typedef enum {
+	HUMSearchOrderTarget = 0,
+	HUMSearchOrderTargetRect,
+	HUMSearchOrderGreedy
+} HUMSearchOrder;
+
+HUM_ALWAYS_INLINE float HUMSearchEstimate(HUMSearchHeuristic heuristic, int32_t x, int32_t y, int32_t targetX, int32_t targetY) {
+	int32_t distanceX = abs(x - targetX);
+	int32_t distanceY = abs(y - targetY);
+
+	switch (heuristic) {
+		case HUMSearchHeuristicEuclidian:
+			return sqrtf((float)(distanceX * distanceX + distanceY * distanceY));
+
+		case HUMSearchHeuristicChebyshev:
+			return (float)(distanceX > distanceY ? distanceX : distanceY);
+
+		case HUMSearchHeuristicNone:
+			return 0.0f;
+
+		case HUMSearchHeuristicManhattan:
+		default:
+			return (float)(distanceX + distanceY);
+	}
+}
+
+/**
+ *	The open list key of a tile. A unidirectional search uses f = g + h. A bidirectional search gives both directions the same potential, half the
+ *  difference between the estimates to the target and to the start, added going forward and subtracted going backward. Both searches then
+ *  see the same consistent edge costs whenever the heuristic is consistent, which is what lets the search stop as soon as the two smallest
+ *  keys add up to the best path found.
+ */
+HUM_ALWAYS_INLINE float HUMSearchKey(const HUMSearchContext *context, const HUMSearchHeuristic heuristic, const bool backward, const bool bidirectional, const HUMSearchOrder order, int32_t x, int32_t y, uint32_t g) {
+	// the distance to the nearest tile of a rect never overestimates the distance to any tile in it, and is as consistent as the heuristic
+	if (order == HUMSearchOrderTargetRect) {
+		const HUMSearchTileRect *rect = &context->targetRect;
+		int32_t distanceX = (x < rect->x) ? rect->x - x : (x >= rect->x + rect->width ? x - (rect->x + rect->width - 1) : 0);
+		int32_t distanceY = (y < rect->y) ? rect->y - y : (y >= rect->y + rect->height ? y - (rect->y + rect->height - 1) : 0);
+
+		return g + HUMSearchEstimate(heuristic, distanceX, distanceY, 0, 0);
+	}
+
+	float toTarget = HUMSearchEstimate(heuristic, x, y, context->targetX, context->targetY);
+
+	if (order == HUMSearchOrderGreedy) {
+		return toTarget;
+	}
+
+	if (!bidirectional) {
+		return g + toTarget;
+	}
+
+	float potential = 0.5f * (toTarget - HUMSearchEstimate(heuristic, x, y, context->startX, context->startY));
+	return backward ? g - potential : g + potential;
+}
+
+/**
+ *	Relaxes the edge between the node being expanded and one of its neighbors. Forward, the edge leads onto the neighbor and costs the
+ *  neighbor's entry cost. Backward, the edge leads from the neighbor onto the expanded node and costs the expanded node's entry cost, so
+ *  asymmetric tile costs are charged the same way in both directions. In a bidirectional search, reaching a node the other direction has
+ *  already reached records a candidate path through it.
+ *
+ *	@return	true if the neighbor is walkable.
+ */
+HUM_ALWAYS_INLINE bool HUMSearchRelax(HUMSearchContext *context, const HUMSearchHeuristic heuristic, const bool backward, const bool bidirectional, const HUMSearchOrder order, int32_t node, uint32_t g, int32_t neighbor, int32_t neighborX, int32_t neighborY, bool diagonal) {
+	const uint8_t open = backward ? HUMSearchTileOpenBackward : HUMSearchTileOpen;
+	const uint8_t closed = backward ? HUMSearchTileClosedBackward : HUMSearchTileClosed;
+	HUMSearchFrontier *frontier = backward ? &context->backward : &context->forward;
+
+	uint8_t state = HUMSearchState(context, neighbor);
+	bool walkable = state & HUMSearchTileWalkable;
+
+	// like the forward search, the backward search doesn't require the start tile to be walkable
+	if (!walkable && !(backward && neighbor == context->startNode)) {
+		return false;
+	}
+
+	// a pruned tile is never entered, but doesn't block diagonal moves past it
+	if (state & HUMSearchTilePruned) {
+		return true;
+	}
+
+	if (state & closed) {
+		return walkable;
+	}
+
+	uint32_t cost = backward ? context->cost[node] : context->cost[neighbor];
+	uint32_t neighborG = g + (diagonal ? HUMSearchDiagonalCost(cost) : cost);
+
+	if (!(state & open)) {
+		context->state[neighbor] = state | open;
+		frontier->g[neighbor] = neighborG;
+		frontier->parent[neighbor] = node;
+		HUMSearchHeapPush(frontier, neighbor, HUMSearchKey(context, heuristic, backward, bidirectional, order, neighborX, neighborY, neighborG));
+	}
+	else if (neighborG < frontier->g[neighbor]) {
+		frontier->g[neighbor] = neighborG;
+		frontier->parent[neighbor] = node;
+		HUMSearchHeapDecrease(frontier, neighbor, HUMSearchKey(context, heuristic, backward, bidirectional, order, neighborX, neighborY, neighborG));
+	}
+	else {
+		return walkable;
+	}
+
+	if (bidirectional) {
+		const uint8_t otherReached = backward ? (HUMSearchTileOpen | HUMSearchTileClosed) : (HUMSearchTileOpenBackward | HUMSearchTileClosedBackward);
+		const HUMSearchFrontier *other = backward ? &context->forward : &context->backward;
+
+		if (state & otherReached) {
+			uint64_t pathCost = (uint64_t)neighborG + other->g[neighbor];
+			if (pathCost < context->pathCost) {
+				context->pathCost = (uint32_t)pathCost;
+				context->meetingNode = neighbor;
+			}
+		}
+	}
+
+	return walkable;
+}
+
+/**
+ *	Expands a node in one direction. A diagonal move between two tiles is allowed by the same two corner tiles whichever of them it is
+ *  expanded from, so both directions share the neighbor policy.
+ */
+HUM_ALWAYS_INLINE void HUMSearchExpandNode(HUMSearchContext *context, const HUMSearchNeighbors neighbors, const HUMSearchHeuristic heuristic, const bool backward, const bool bidirectional, const HUMSearchOrder order, int32_t node) {
+	uint32_t g = backward ? context->backward.g[node] : context->forward.g[node];
+	int32_t x, y;
+	HUMSearchNodeTile(context, node, &x, &y);
+
+	// row-major neighbors are a constant offset away. In the blocked layouts they're the sum of a column and a row offset.
+	int32_t west, center, east, up, row, down;
+
+	if (context->layout == HUMSearchLayoutRowMajor) {
+		west = node - 1;
+		center = node;
+		east = node + 1;
+		up = -context->stride;
+		row = 0;
+		down = context->stride;
+	}
+	else {
+		const int32_t *columns = context->columnOffsets + x + 1;
+		const int32_t *rows = context->rowOffsets + y + 1;
+
+		west = columns[-1];
+		center = columns[0];
+		east = columns[1];
+		up = rows[-1];
+		row = rows[0];
+		down = rows[1];
+	}
+
+	bool northOpen = HUMSearchRelax(context, heuristic, backward, bidirectional, order, node, g, center + up, x, y - 1, false);
+	bool eastOpen = HUMSearchRelax(context, heuristic, backward, bidirectional, order, node, g, east + row, x + 1, y, false);
+	bool southOpen = HUMSearchRelax(context, heuristic, backward, bidirectional, order, node, g, center + down, x, y + 1, false);
+	bool westOpen = HUMSearchRelax(context, heuristic, backward, bidirectional, order, node, g, west + row, x - 1, y, false);
+
+	if (neighbors == HUMSearchNeighborsCardinal) {
+		return;
+	}
+
+	bool northEast = true, southEast = true, southWest = true, northWest = true;
+
+	if (neighbors == HUMSearchNeighborsDiagonalCrossBorders) {
+		northEast = northOpen || eastOpen;
+		southEast = southOpen || eastOpen;
+		southWest = southOpen || westOpen;
+		northWest = northOpen || westOpen;
+	}
+	else if (neighbors == HUMSearchNeighborsDiagonalStrict) {
+		northEast = northOpen && eastOpen;
+		southEast = southOpen && eastOpen;
+		southWest = southOpen && westOpen;
+		northWest = northOpen && westOpen;
+	}
+
+	if (northEast) {
+		HUMSearchRelax(context, heuristic, backward, bidirectional, order, node, g, east + up, x + 1, y - 1, true);
+	}
+
+	if (southEast) {
+		HUMSearchRelax(context, heuristic, backward, bidirectional, order, node, g, east + down, x + 1, y + 1, true);
+	}
+
+	if (southWest) {
+		HUMSearchRelax(context, heuristic, backward, bidirectional, order, node, g, west + down, x - 1, y + 1, true);
+	}
+
+	if (northWest) {
+		HUMSearchRelax(context, heuristic, backward, bidirectional, order, node, g, west + up, x - 1, y - 1, true);
+	}
+}
+
+/**
+ *	The A* expansion loop. Always inlined into one specialized copy per neighbor policy and heuristic below, so the movement rules and
+ *  heuristic are constants and every branch on them is compiled away.
+ */
+HUM_ALWAYS_INLINE bool HUMSearchExpand(HUMSearchContext *context, const HUMSearchNeighbors neighbors, const HUMSearchHeuristic heuristic) {
+	HUMSearchFrontier *forward = &context->forward;
+	const int32_t target = context->targetNode;
+
+	while (forward->heapCount > 0) {
+		int32_t node = HUMSearchHeapPop(forward);
+		context->state[node] = (context->state[node] & ~HUMSearchTileOpen) | HUMSearchTileClosed;
+
+		if (node == target) {
+			context->meetingNode = target;
+			context->pathCost = forward->g[target];
+			return true;
+		}
+
+		HUMSearchExpandNode(context, neighbors, heuristic, false, false, HUMSearchOrderTarget, node);
+	}
+
+	return false;
+}
+
+/**
+ *	The bidirectional expansion loop, specialized the same way. Every path not found yet has to pass through a node on each open list, so
+ *  once the smallest forward and backward keys add up to at least the cost of the best path where the searches have met, that path is optimal.
+ */
+HUM_ALWAYS_INLINE bool HUMSearchExpandBidirectional(HUMSearchContext *context, const HUMSearchNeighbors neighbors, const HUMSearchHeuristic heuristic) {
+	HUMSearchFrontier *forward = &context->forward;
+	HUMSearchFrontier *backward = &context->backward;
+
+	while (forward->heapCount > 0 && backward->heapCount > 0) {
+		if (context->meetingNode != -1 && forward->heap[0].f + backward->heap[0].f >= (float)context->pathCost) {
+			break;
+		}
+
+		// balance the two searches by expanding whichever has the smaller open list
+		if (forward->heapCount <= backward->heapCount) {
+			int32_t node = HUMSearchHeapPop(forward);
+			context->state[node] = (context->state[node] & ~HUMSearchTileOpen) | HUMSearchTileClosed;
+			HUMSearchExpandNode(context, neighbors, heuristic, false, true, HUMSearchOrderTarget, node);
+		}
+		else {
+			int32_t node = HUMSearchHeapPop(backward);
+			context->state[node] = (context->state[node] & ~HUMSearchTileOpenBackward) | HUMSearchTileClosedBackward;
+
+			// paths never need to pass back through the start, and it may not even be walkable
+			if (node != context->startNode) {
+				HUMSearchExpandNode(context, neighbors, heuristic, true, true, HUMSearchOrderTarget, node);
+			}
+		}
+	}
+
+	return context->meetingNode != -1;
+}
+
+typedef bool (*HUMSearchKernel)(HUMSearchContext *context);
+
+#define HUM_SEARCH_KERNEL(neighbors, heuristic) \
+	static bool HUMSearchKernel##neighbors##heuristic(HUMSearchContext *context) { \
+		return HUMSearchExpand(context, HUMSearchNeighbors##neighbors, HUMSearchHeuristic##heuristic); \
+	} \
+	static bool HUMSearchBidirectionalKernel##neighbors##heuristic(HUMSearchContext *context) { \
+		return HUMSearchExpandBidirectional(context, HUMSearchNeighbors##neighbors, HUMSearchHeuristic##heuristic); \
+	}
+
+#define HUM_SEARCH_KERNELS(neighbors) \
+	HUM_SEARCH_KERNEL(neighbors, Manhattan) \
+	HUM_SEARCH_KERNEL(neighbors, Euclidian) \
+	HUM_SEARCH_KERNEL(neighbors, Chebyshev) \
+	HUM_SEARCH_KERNEL(neighbors, None)
+
+HUM_SEARCH_KERNELS(Cardinal)
+HUM_SEARCH_KERNELS(Diagonal)
+HUM_SEARCH_KERNELS(DiagonalCrossBorders)
+HUM_SEARCH_KERNELS(DiagonalStrict)
+
+#define HUM_SEARCH_KERNEL_ROW(kernel, neighbors) \
+	{ kernel##neighbors##Manhattan, kernel##neighbors##Euclidian, kernel##neighbors##Chebyshev, kernel##neighbors##None }
+
+static const HUMSearchKernel HUMSearchKernels[HUMSearchNeighborsCount][HUMSearchHeuristicCount] = {
+	HUM_SEARCH_KERNEL_ROW(HUMSearchKernel, Cardinal),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchKernel, Diagonal),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchKernel, DiagonalCrossBorders),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchKernel, DiagonalStrict)
+};
+
+static const HUMSearchKernel HUMSearchBidirectionalKernels[HUMSearchNeighborsCount][HUMSearchHeuristicCount] = {
+	HUM_SEARCH_KERNEL_ROW(HUMSearchBidirectionalKernel, Cardinal),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchBidirectionalKernel, Diagonal),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchBidirectionalKernel, DiagonalCrossBorders),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchBidirectionalKernel, DiagonalStrict)
+};
+
+/**
+ *	The greedy loop, specialized the same way. Always expands the open tile that looks closest to the target, which heads straight for it on
+ *  open maps, and remembers the closest tile closed so far in case the expansion limit is reached first.
+ */
+HUM_ALWAYS_INLINE bool HUMSearchExpandGreedy(HUMSearchContext *context, const HUMSearchNeighbors neighbors, const HUMSearchHeuristic heuristic, int32_t expansionLimit) {
+	HUMSearchFrontier *forward = &context->forward;
+	const int32_t target = context->targetNode;
+	float closestEstimate = HUGE_VALF;
+	int32_t expansionCount = 0;
+
+	while (forward->heapCount > 0) {
+		float estimate = forward->heap[0].f;
+		int32_t node = HUMSearchHeapPop(forward);
+		context->state[node] = (context->state[node] & ~HUMSearchTileOpen) | HUMSearchTileClosed;
+
+		if (node == target || estimate < closestEstimate) {
+			closestEstimate = estimate;
+			context->meetingNode = node;
+			context->pathCost = forward->g[node];
+		}
+
+		if (node == target || expansionCount == expansionLimit) {
+			return true;
+		}
+
+		expansionCount++;
+		HUMSearchExpandNode(context, neighbors, heuristic, false, false, HUMSearchOrderGreedy, node);
+	}
+
+	// every tile reachable from the start was closed without reaching the target
+	context->meetingNode = -1;
+	context->pathCost = UINT32_MAX;
+
+	return false;
+}
+
+typedef bool (*HUMSearchGreedyKernel)(HUMSearchContext *context, int32_t expansionLimit);
+
+#define HUM_SEARCH_GREEDY_KERNEL(neighbors, heuristic) \
+	static bool HUMSearchGreedyKernel##neighbors##heuristic(HUMSearchContext *context, int32_t expansionLimit) { \
+		return HUMSearchExpandGreedy(context, HUMSearchNeighbors##neighbors, HUMSearchHeuristic##heuristic, expansionLimit); \
+	}
+
+#define HUM_SEARCH_GREEDY_KERNELS(neighbors) \
+	HUM_SEARCH_GREEDY_KERNEL(neighbors, Manhattan) \
+	HUM_SEARCH_GREEDY_KERNEL(neighbors, Euclidian) \
+	HUM_SEARCH_GREEDY_KERNEL(neighbors, Chebyshev) \
+	HUM_SEARCH_GREEDY_KERNEL(neighbors, None)
+
+HUM_SEARCH_GREEDY_KERNELS(Cardinal)
+HUM_SEARCH_GREEDY_KERNELS(Diagonal)
+HUM_SEARCH_GREEDY_KERNELS(DiagonalCrossBorders)
+HUM_SEARCH_GREEDY_KERNELS(DiagonalStrict)
+
+static const HUMSearchGreedyKernel HUMSearchGreedyKernels[HUMSearchNeighborsCount][HUMSearchHeuristicCount] = {
+	HUM_SEARCH_KERNEL_ROW(HUMSearchGreedyKernel, Cardinal),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchGreedyKernel, Diagonal),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchGreedyKernel, DiagonalCrossBorders),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchGreedyKernel, DiagonalStrict)
+};
+
+/**
+ *	The reachability loop, specialized per neighbor policy. Closes tiles in order of cost until the cheapest open tile is over the maximum cost.
+ */
+HUM_ALWAYS_INLINE int32_t HUMSearchExpandReachable(HUMSearchContext *context, const HUMSearchNeighbors neighbors, uint32_t maximumCost) {
+	HUMSearchFrontier *forward = &context->forward;
+	int32_t count = 0;
+
+	while (forward->heapCount > 0) {
+		int32_t node = HUMSearchHeapPop(forward);
+		if (forward->g[node] > maximumCost) {
+			break;
+		}
+
+		context->state[node] = (context->state[node] & ~HUMSearchTileOpen) | HUMSearchTileClosed;
+		count++;
+
+		HUMSearchExpandNode(context, neighbors, HUMSearchHeuristicNone, false, false, HUMSearchOrderTarget, node);
+	}
+
+	return count;
+}
+
+typedef int32_t (*HUMSearchReachKernel)(HUMSearchContext *context, uint32_t maximumCost);
+
+#define HUM_SEARCH_REACH_KERNEL(neighbors) \
+	static int32_t HUMSearchReachKernel##neighbors(HUMSearchContext *context, uint32_t maximumCost) { \
+		return HUMSearchExpandReachable(context, HUMSearchNeighbors##neighbors, maximumCost); \
+	}
+
+HUM_SEARCH_REACH_KERNEL(Cardinal)
+HUM_SEARCH_REACH_KERNEL(Diagonal)
+HUM_SEARCH_REACH_KERNEL(DiagonalCrossBorders)
+HUM_SEARCH_REACH_KERNEL(DiagonalStrict)
+
+static const HUMSearchReachKernel HUMSearchReachKernels[HUMSearchNeighborsCount] = {
+	HUMSearchReachKernelCardinal,
+	HUMSearchReachKernelDiagonal,
+	HUMSearchReachKernelDiagonalCrossBorders,
+	HUMSearchReachKernelDiagonalStrict
+};
+
+/**
+ *	The cost search loop, specialized per neighbor policy and heuristic. Every tile is closed at its cheapest cost, as the heuristic toward
+ *  the targets' rect is consistent, so the search stops as soon as every target is closed.
+ */
+HUM_ALWAYS_INLINE void HUMSearchExpandTargets(HUMSearchContext *context, const HUMSearchNeighbors neighbors, const HUMSearchHeuristic heuristic, int32_t targetCount) {
+	HUMSearchFrontier *forward = &context->forward;
+	int32_t closedTargetCount = 0;
+
+	while (forward->heapCount > 0 && closedTargetCount < targetCount) {
+		int32_t node = HUMSearchHeapPop(forward);
+		uint8_t state = context->state[node];
+		context->state[node] = (state & ~HUMSearchTileOpen) | HUMSearchTileClosed;
+
+		if (state & HUMSearchTileTarget) {
+			closedTargetCount++;
+		}
+
+		HUMSearchExpandNode(context, neighbors, heuristic, false, false, HUMSearchOrderTargetRect, node);
+	}
+}
+
+typedef void (*HUMSearchTargetsKernel)(HUMSearchContext *context, int32_t targetCount);
+
+#define HUM_SEARCH_TARGETS_KERNEL(neighbors, heuristic) \
+	static void HUMSearchTargetsKernel##neighbors##heuristic(HUMSearchContext *context, int32_t targetCount) { \
+		HUMSearchExpandTargets(context, HUMSearchNeighbors##neighbors, HUMSearchHeuristic##heuristic, targetCount); \
+	}
+
+#define HUM_SEARCH_TARGETS_KERNELS(neighbors) \
+	HUM_SEARCH_TARGETS_KERNEL(neighbors, Manhattan) \
+	HUM_SEARCH_TARGETS_KERNEL(neighbors, Euclidian) \
+	HUM_SEARCH_TARGETS_KERNEL(neighbors, Chebyshev) \
+	HUM_SEARCH_TARGETS_KERNEL(neighbors, None)
+
+HUM_SEARCH_TARGETS_KERNELS(Cardinal)
+HUM_SEARCH_TARGETS_KERNELS(Diagonal)
+HUM_SEARCH_TARGETS_KERNELS(DiagonalCrossBorders)
+HUM_SEARCH_TARGETS_KERNELS(DiagonalStrict)
+
+static const HUMSearchTargetsKernel HUMSearchTargetsKernels[HUMSearchNeighborsCount][HUMSearchHeuristicCount] = {
+	HUM_SEARCH_KERNEL_ROW(HUMSearchTargetsKernel, Cardinal),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchTargetsKernel, Diagonal),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchTargetsKernel, DiagonalCrossBorders),
+	HUM_SEARCH_KERNEL_ROW(HUMSearchTargetsKernel, DiagonalStrict)
+};
+
+#pragma mark - Queries
+bool HUMSearchFindPath(HUMSearchContext *context, const HUMSearchQuery *query) {
+	context->sample = query->sample;
+	context->info = query->info;
+	context->prunedTiles = query->prunedTiles;
+	context->keptRects[0] = query->keptRects[0];
+	context->keptRects[1] = query->keptRects[1];
+	context->startNode = HUMSearchNodeForTile(context, query->startX, query->startY);
+	context->startX = query->startX;
+	context->startY = query->startY;
+	context->targetNode = HUMSearchNodeForTile(context, query->targetX, query->targetY);
+	context->targetX = query->targetX;
+	context->targetY = query->targetY;
+	context->meetingNode = -1;
+	context->pathCost = UINT32_MAX;
+
+	bool bidirectional = query->bidirectional;
+	if (bidirectional && !context->backward.g) {
+		size_t tileCount = (size_t)context->width * (size_t)context->height;
+		if (!HUMSearchFrontierAllocate(&context->backward, (size_t)context->nodeCount, tileCount)) {
+			HUMSearchFrontierFree(&context->backward);
+			bidirectional = false;
+		}
+	}
+
+	// the start tile doesn't need to be walkable, but it has to be sampled so its state is cleared on reset
+	int32_t start = context->startNode;
+	uint8_t startState = HUMSearchState(context, start);
+	context->state[start] = (startState & ~HUMSearchTilePruned) | HUMSearchTileOpen;
+	context->forward.g[start] = 0;
+	context->forward.parent[start] = -1;
+	HUMSearchHeapPush(&context->forward, start, HUMSearchKey(context, query->heuristic, false, bidirectional, HUMSearchOrderTarget, query->startX, query->startY, 0));
+
+	if (!(startState & HUMSearchTileWalkable)) {
+		context->prunedTiles = NULL;
+	}
+
+	if (!bidirectional) {
+		return HUMSearchKernels[query->neighbors][query->heuristic](context);
+	}
+
+	// the forward search can only ever end on a walkable target, so the backward search mustn't start from any other
+	int32_t target = context->targetNode;
+	uint8_t targetState = HUMSearchState(context, target);
+	if (!(targetState & HUMSearchTileWalkable)) {
+		return false;
+	}
+
+	context->state[target] = targetState | HUMSearchTileOpenBackward;
+	context->backward.g[target] = 0;
+	context->backward.parent[target] = -1;
+	HUMSearchHeapPush(&context->backward, target, HUMSearchKey(context, query->heuristic, true, true, HUMSearchOrderTarget, query->targetX, query->targetY, 0));
+
+	return HUMSearchBidirectionalKernels[query->neighbors][query->heuristic](context);
+}
+
+bool HUMSearchFindProvisionalPath(HUMSearchContext *context, const HUMSearchQuery *query, int32_t expansionLimit) {
+	context->sample = query->sample;
+	context->info = query->info;
+	context->prunedTiles = NULL;
+	context->startNode = HUMSearchNodeForTile(context, query->startX, query->startY);
+	context->startX = query->startX;
+	context->startY = query->startY;
+	context->targetNode = HUMSearchNodeForTile(context, query->targetX, query->targetY);
+	context->targetX = query->targetX;
+	context->targetY = query->targetY;
+	context->meetingNode = -1;
+	context->pathCost = UINT32_MAX;
+
+	int32_t start = context->startNode;
+	context->state[start] = HUMSearchState(context, start) | HUMSearchTileOpen;
+	context->forward.g[start] = 0;
+	context->forward.parent[start] = -1;
+	HUMSearchHeapPush(&context->forward, start, HUMSearchKey(context, query->heuristic, false, false, HUMSearchOrderGreedy, query->startX, query->startY, 0));
+
+	return HUMSearchGreedyKernels[query->neighbors][query->heuristic](context, expansionLimit);
+}
+
+int32_t HUMSearchCopyPath(const HUMSearchContext *context, int32_t *xs, int32_t *ys, int32_t capacity) {
+	const int32_t meeting = context->meetingNode;
+	const int32_t *forwardParent = context->forward.parent;
+	int32_t length = 0;
+
+	for (int32_t node = meeting; node != -1; node = forwardParent[node]) {
+		length++;
+	}
+
+	// walk back from the meeting node to the start
+	int32_t index = length - 1;
+	for (int32_t node = meeting; node != -1; node = forwardParent[node], index--) {
+		if (index < capacity) {
+			HUMSearchNodeTile(context, node, &xs[index], &ys[index]);
+		}
+	}
+
+	// then forward from the meeting node to the target, if the backward search found that part of the path. A provisional path can stop
+	// short of the target at a node the backward search never reached.
+	if (meeting != context->targetNode && (context->state[meeting] & (HUMSearchTileOpenBackward | HUMSearchTileClosedBackward))) {
+		const int32_t *backwardParent = context->backward.parent;
+
+		for (int32_t node = backwardParent[meeting]; node != -1; node = backwardParent[node]) {
+			if (length < capacity) {
+				HUMSearchNodeTile(context, node, &xs[length], &ys[length]);
+			}
+			length++;
+		}
+	}
+
+	return length;
+}
+
+int32_t HUMSearchFindReachable(HUMSearchContext *context, const HUMSearchReachQuery *query) {
+	context->sample = query->sample;
+	context->info = query->info;
+	context->prunedTiles = NULL;
+	context->startNode = HUMSearchNodeForTile(context, query->startX, query->startY);
+	context->startX = query->startX;
+	context->startY = query->startY;
+	context->targetNode = -1;
+	context->targetX = query->startX;
+	context->targetY = query->startY;
+	context->meetingNode = -1;
+	context->pathCost = UINT32_MAX;
+
+	int32_t start = context->startNode;
+	context->state[start] = HUMSearchState(context, start) | HUMSearchTileOpen;
+	context->forward.g[start] = 0;
+	context->forward.parent[start] = -1;
+	HUMSearchHeapPush(&context->forward, start, 0.0f);
+
+	return HUMSearchReachKernels[query->neighbors](context, query->maximumCost);
+}
+
+void HUMSearchCopyReachable(const HUMSearchContext *context, uint8_t *bitmap, uint32_t *costs, int32_t *parents) {
+	const int32_t width = context->width;
+	const size_t tileCount = (size_t)width * (size_t)context->height;
+
+	if (bitmap) {
+		memset(bitmap, 0, (tileCount + 7) / 8);
+	}
+
+	if (costs) {
+		for (size_t i = 0; i < tileCount; i++) {
+			costs[i] = UINT32_MAX;
+		}
+	}
+
+	if (parents) {
+		memset(parents, 0xff, tileCount * sizeof(int32_t));
+	}
+
+	// every closed tile was touched, so only the touched tiles need to be scattered into the buffers
+	for (int32_t i = 0; i < context->touchedCount; i++) {
+		int32_t node = context->touched[i];
+		if (!(context->state[node] & HUMSearchTileClosed)) {
+			continue;
+		}
+
+		int32_t x, y;
+		HUMSearchNodeTile(context, node, &x, &y);
+		int32_t tile = y * width + x;
+
+		if (bitmap) {
+			bitmap[tile >> 3] |= (uint8_t)(1 << (tile & 7));
+		}
+
+		if (costs) {
+			costs[tile] = context->forward.g[node];
+		}
+
+		if (parents) {
+			int32_t parent = context->forward.parent[node];
+			if (parent == -1) {
+				parents[tile] = -1;
+			}
+			else {
+				HUMSearchNodeTile(context, parent, &x, &y);
+				parents[tile] = y * width + x;
+			}
+		}
+	}
+}
+
+int32_t HUMSearchFindCosts(HUMSearchContext *context, const HUMSearchCostQuery *query, uint32_t *costs) {
+	context->sample = query->sample;
+	context->info = query->info;
+	context->prunedTiles = NULL;
+	context->startNode = HUMSearchNodeForTile(context, query->startX, query->startY);
+	context->startX = query->startX;
+	context->startY = query->startY;
+	context->targetNode = -1;
+	context->meetingNode = -1;
+	context->pathCost = UINT32_MAX;
+
+	int32_t start = context->startNode;
+	HUMSearchState(context, start);
+
+	// the start tile doesn't need to be walkable to be a target, since reaching it costs nothing
+	if (query->targetCount > 0) {
+		int32_t minimumX = INT32_MAX, maximumX = INT32_MIN;
+		int32_t minimumY = INT32_MAX, maximumY = INT32_MIN;
+		int32_t targetCount = 0;
+
+		for (int32_t i = 0; i < query->targetCount; i++) {
+			int32_t x = query->targetXs[i];
+			int32_t y = query->targetYs[i];
+			int32_t node = HUMSearchNodeForTile(context, x, y);
+			uint8_t state = HUMSearchState(context, node);
+
+			if ((state & HUMSearchTileTarget) || (!(state & HUMSearchTileWalkable) && node != start)) {
+				continue;
+			}
+
+			context->state[node] = state | HUMSearchTileTarget;
+			targetCount++;
+
+			minimumX = x < minimumX ? x : minimumX;
+			maximumX = x > maximumX ? x : maximumX;
+			minimumY = y < minimumY ? y : minimumY;
+			maximumY = y > maximumY ? y : maximumY;
+		}
+
+		if (targetCount > 0) {
+			context->targetRect = (HUMSearchTileRect){ minimumX, minimumY, maximumX - minimumX + 1, maximumY - minimumY + 1 };
+			context->targetX = minimumX;
+			context->targetY = minimumY;
+
+			context->state[start] = context->state[start] | HUMSearchTileOpen;
+			context->forward.g[start] = 0;
+			context->forward.parent[start] = -1;
+			HUMSearchHeapPush(&context->forward, start, HUMSearchKey(context, query->heuristic, false, false, HUMSearchOrderTargetRect, query->startX, query->startY, 0));
+
+			HUMSearchTargetsKernels[query->neighbors][query->heuristic](context, targetCount);
+		}
+	}
+
+	int32_t reachedCount = 0;
+
+	for (int32_t i = 0; i < query->targetCount; i++) {
+		int32_t node = HUMSearchNodeForTile(context, query->targetXs[i], query->targetYs[i]);
+		uint8_t state = context->state[node];
+
+		if ((state & HUMSearchTileTarget) && (state & HUMSearchTileClosed)) {
+			costs[i] = context->forward.g[node];
+			reachedCount++;
+		}
+		else {
+			costs[i] = UINT32_MAX;
+		}
+	}
+
+	return reachedCount;
+}
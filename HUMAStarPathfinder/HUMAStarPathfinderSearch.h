@@ -0,0 +1,313 @@
+//
+//  HUMAStarPathfinderSearch.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderSearch_h
+#define HUMAStarPathfinder_HUMAStarPathfinderSearch_h
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ *	The movement rules a search expands neighbors with. Each combination of pathDiagonally, ignoreDiagonalBarriers, and pathCanCrossBorders
+ *  maps to exactly one policy, which is resolved once per query.
+ */
+typedef enum {
+	HUMSearchNeighborsCardinal = 0,			// pathDiagonally = NO
+	HUMSearchNeighborsDiagonal,				// ignoreDiagonalBarriers = YES
+	HUMSearchNeighborsDiagonalCrossBorders,	// pathCanCrossBorders = YES, diagonal needs one walkable cardinal tile
+	HUMSearchNeighborsDiagonalStrict,		// pathCanCrossBorders = NO, diagonal needs both walkable cardinal tiles
+	HUMSearchNeighborsCount
+} HUMSearchNeighbors;
+
+/**
+ *	The heuristic a search estimates the remaining distance with. Matches the values of HUMAStarDistanceType, plus a zero estimate that turns
+ *  the search into Dijkstra's algorithm.
+ */
+typedef enum {
+	HUMSearchHeuristicManhattan = 0,
+	HUMSearchHeuristicEuclidian,
+	HUMSearchHeuristicChebyshev,
+	HUMSearchHeuristicNone,
+	HUMSearchHeuristicCount
+} HUMSearchHeuristic;
+
+/**
+ *	How nodes are laid out in memory. Row-major puts vertical neighbors a whole row apart, which on wide maps means a cache miss for nearly
+ *  every north or south neighbor. The blocked layouts store the map as square blocks of HUMSearchBlockSize tiles, so a tile's neighbors are
+ *  almost always in the same block. Blocked orders the tiles of a block row by row, Morton orders them along a Z-order curve, which also keeps
+ *  each quarter of a block contiguous.
+ */
+typedef enum {
+	HUMSearchLayoutRowMajor = 0,
+	HUMSearchLayoutBlocked,
+	HUMSearchLayoutMorton,
+	HUMSearchLayoutCount
+} HUMSearchLayout;
+
+#define HUMSearchBlockShift 4
+#define HUMSearchBlockSize (1 << HUMSearchBlockShift)
+
+/**
+ *	Asked for the walkability and entry cost of a tile the first time a search reaches it. Tiles are in map coordinates. The cost is only
+ *  needed if the tile is walkable.
+ */
+typedef void (*HUMSearchSampleFunction)(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost);
+
+/**
+ *	Per-tile state flags.
+ */
+enum {
+	HUMSearchTileSampled = 1 << 0,
+	HUMSearchTileWalkable = 1 << 1,
+	HUMSearchTileOpen = 1 << 2,
+	HUMSearchTileClosed = 1 << 3,
+	HUMSearchTileOpenBackward = 1 << 4,
+	HUMSearchTileClosedBackward = 1 << 5,
+	HUMSearchTilePruned = 1 << 6,
+	HUMSearchTileTarget = 1 << 7
+};
+
+/**
+ *	A rect of tiles in map coordinates.
+ */
+typedef struct {
+	int32_t x;
+	int32_t y;
+	int32_t width;
+	int32_t height;
+} HUMSearchTileRect;
+
+typedef struct {
+	float f;
+	int32_t node;
+} HUMSearchHeapEntry;
+
+/**
+ *	The g costs, parents, and open list of one search direction. Forward g is the cost from the start to a node. Backward g is the cost from a
+ *  node to the target, and a backward parent is the next node on the path toward the target.
+ */
+typedef struct {
+	uint32_t *g;
+	int32_t *parent;
+	int32_t *heapIndex;
+
+	HUMSearchHeapEntry *heap;
+	int32_t heapCount;
+} HUMSearchFrontier;
+
+/**
+ *	The scratch memory of a search over a map of a fixed size. Every array is indexed by node, where the grid is surrounded by a one tile sentinel
+ *  border of permanently blocked tiles so neighbor expansion never has to check bounds.
+ *
+ *	Whatever the layout, the node of a tile is the sum of a per-column and a per-row offset, so any neighbor is two table lookups away.
+ */
+typedef struct {
+	int32_t width;			// map width in tiles
+	int32_t height;			// map height in tiles
+	HUMSearchLayout layout;
+	int32_t stride;			// width + 2, the distance between rows of nodes in the row-major layout
+	int32_t blocksPerRow;	// the number of blocks across the bordered map in the blocked layouts
+	int32_t nodeCount;		// (width + 2) * (height + 2), rounded up to whole blocks in the blocked layouts
+
+	int32_t *columnOffsets;	// width + 2 offsets, indexed by x + 1
+	int32_t *rowOffsets;	// height + 2 offsets, indexed by y + 1
+
+	uint8_t *state;
+	uint32_t *cost;
+
+	HUMSearchFrontier forward;
+	HUMSearchFrontier backward;	// only allocated once a bidirectional search is run
+
+	int32_t *touched;
+	int32_t touchedCount;
+
+	HUMSearchSampleFunction sample;
+	void *info;
+
+	const uint8_t *prunedTiles;
+	HUMSearchTileRect keptRects[2];
+
+	int32_t startNode;
+	int32_t startX;
+	int32_t startY;
+	int32_t targetNode;
+	int32_t targetX;
+	int32_t targetY;
+	HUMSearchTileRect targetRect;	// the bounds of the targets of a cost search
+
+	int32_t meetingNode;	// where the forward and backward paths join. The target for a unidirectional search.
+	uint32_t pathCost;
+} HUMSearchContext;
+
+typedef struct {
+	int32_t startX;
+	int32_t startY;
+	int32_t targetX;
+	int32_t targetY;
+	HUMSearchNeighbors neighbors;
+	HUMSearchHeuristic heuristic;
+	HUMSearchSampleFunction sample;
+	void *info;
+	bool bidirectional;
+
+	const uint8_t *prunedTiles;			// width * height bits, laid out like HUMSearchCopyReachable's bitmap, of tiles the search never enters, or NULL
+	HUMSearchTileRect keptRects[2];		// tiles in these rects are entered even if they're pruned
+} HUMSearchQuery;
+
+HUMSearchContext *HUMSearchContextCreate(int32_t width, int32_t height, HUMSearchLayout layout);
+void HUMSearchContextFree(HUMSearchContext *context);
+
+/**
+ *	Clears the state of every tile touched by the last search. Runs in time proportional to the tiles touched, not the size of the map.
+ */
+void HUMSearchContextReset(HUMSearchContext *context);
+
+/**
+ *	Resolves the neighbor policy for a combination of movement rules.
+ */
+HUMSearchNeighbors HUMSearchNeighborsForRules(bool pathDiagonally, bool ignoreDiagonalBarriers, bool pathCanCrossBorders);
+
+/**
+ *	Runs an A* search from the start to the target. The start and target must lie within the map. The expansion loop is specialized for the
+ *  query's neighbor policy and heuristic. Call HUMSearchContextReset before reusing the context.
+ *
+ *	A bidirectional query searches backward from the target at the same time, always expanding the direction with the smaller open list, and
+ *  stops once no node left on either open list can lead to a cheaper path than the best one where the two searches have met. The path
+ *  found is optimal whenever a unidirectional search's would be. If the backward frontier can't be allocated, the search runs unidirectionally.
+ *
+ *	@return	true if a path was found.
+ */
+bool HUMSearchFindPath(HUMSearchContext *context, const HUMSearchQuery *query);
+
+/**
+ *	Runs a greedy best-first search from the start toward the target, which always expands the open tile with the smallest estimate to the
+ *  target and ignores the cost of getting there. It closes far fewer tiles than A* on open maps, but the path it finds can be much longer than
+ *  the shortest one. The query's bidirectional flag and pruned tiles are ignored. Call HUMSearchContextReset before reusing the context.
+ *
+ *	@param	expansionLimit	The most tiles the search may expand. If the target hasn't been reached by then, the search stops at the closed
+ *							tile with the smallest estimate, which may be the start.
+ *
+ *	@return	true if the search reached the target or the expansion limit, in which case HUMSearchCopyPath copies the path to the target or to
+ *			the tile it stopped at. false if the target can't be reached at all.
+ */
+bool HUMSearchFindProvisionalPath(HUMSearchContext *context, const HUMSearchQuery *query, int32_t expansionLimit);
+
+typedef struct {
+	int32_t startX;
+	int32_t startY;
+	uint32_t maximumCost;
+	HUMSearchNeighbors neighbors;
+	HUMSearchSampleFunction sample;
+	void *info;
+} HUMSearchReachQuery;
+
+/**
+ *	Runs a Dijkstra search from the start that stops at the maximum cost, finding every tile that can be reached for at most that cost. The start
+ *  must lie within the map, and is always reachable. Call HUMSearchContextReset before reusing the context.
+ *
+ *	@return	The number of reachable tiles.
+ */
+int32_t HUMSearchFindReachable(HUMSearchContext *context, const HUMSearchReachQuery *query);
+
+/**
+ *	Copies the result of the last reachability search into the buffers, any of which may be NULL. Every tile of the map is written.
+ *
+ *	@param	bitmap	width * height bits, rounded up to whole bytes. Bit (y * width + x) % 8 of byte (y * width + x) / 8 is set for reachable tiles.
+ *	@param	costs	width * height costs of the cheapest path to each tile, or UINT32_MAX for unreachable tiles.
+ *	@param	parents	width * height tile indexes (y * width + x) of the tile before each tile on its cheapest path, or -1 for the start and
+ *					unreachable tiles.
+ */
+void HUMSearchCopyReachable(const HUMSearchContext *context, uint8_t *bitmap, uint32_t *costs, int32_t *parents);
+
+/**
+ *	Copies the tiles of the path found by the last search into the buffers, from the start tile to the target tile.
+ *
+ *	@return	The number of tiles in the path. If larger than capacity, only the first capacity tiles are copied.
+ */
+int32_t HUMSearchCopyPath(const HUMSearchContext *context, int32_t *xs, int32_t *ys, int32_t capacity);
+
+typedef struct {
+	int32_t startX;
+	int32_t startY;
+	const int32_t *targetXs;
+	const int32_t *targetYs;
+	int32_t targetCount;
+	HUMSearchNeighbors neighbors;
+	HUMSearchHeuristic heuristic;
+	HUMSearchSampleFunction sample;
+	void *info;
+} HUMSearchCostQuery;
+
+/**
+ *	Finds the cost of the cheapest path from the start to each of several targets with a single search. The start and targets must lie within
+ *  the map, and the targets may repeat. The search is guided toward the bounds of the targets and stops as soon as every walkable target has
+ *  been reached, so nearby targets cost little more to answer than one. Call HUMSearchContextReset before reusing the context.
+ *
+ *	@param	costs	targetCount costs, in the order of the targets. 0 for a target on the start, UINT32_MAX for a target that can't be reached.
+ *
+ *	@return	The number of targets reached.
+ */
+int32_t HUMSearchFindCosts(HUMSearchContext *context, const HUMSearchCostQuery *query, uint32_t *costs);
+
+/**
+ *	The cost of the path found by the last search.
+ */
+static inline uint32_t HUMSearchPathCost(const HUMSearchContext *context) {
+	return context->pathCost;
+}
+
+static inline int32_t HUMSearchNodeForTile(const HUMSearchContext *context, int32_t x, int32_t y) {
+	return context->columnOffsets[x + 1] + context->rowOffsets[y + 1];
+}
+
+/**
+ *	Removes every other bit of a Morton index, leaving the bits of one coordinate.
+ */
+static inline int32_t HUMSearchMortonCompact(int32_t bits) {
+	bits &= 0x55;
+	bits = (bits | (bits >> 1)) & 0x33;
+	bits = (bits | (bits >> 2)) & 0x0f;
+	return bits;
+}
+
+/**
+ *	The tile location of a node.
+ */
+static inline void HUMSearchNodeTile(const HUMSearchContext *context, int32_t node, int32_t *x, int32_t *y) {
+	if (context->layout == HUMSearchLayoutRowMajor) {
+		*x = node % context->stride - 1;
+		*y = node / context->stride - 1;
+		return;
+	}
+
+	int32_t block = node >> (2 * HUMSearchBlockShift);
+	int32_t local = node & (HUMSearchBlockSize * HUMSearchBlockSize - 1);
+	int32_t localX, localY;
+
+	if (context->layout == HUMSearchLayoutMorton) {
+		localX = HUMSearchMortonCompact(local);
+		localY = HUMSearchMortonCompact(local >> 1);
+	}
+	else {
+		localX = local & (HUMSearchBlockSize - 1);
+		localY = local >> HUMSearchBlockShift;
+	}
+
+	*x = ((block % context->blocksPerRow) << HUMSearchBlockShift | localX) - 1;
+	*y = ((block / context->blocksPerRow) << HUMSearchBlockShift | localY) - 1;
+}
+
+/**
+ *	The cost to move diagonally onto a tile with the provided cost: the hypotenuse of a cost x cost triangle, truncated.
+ */
+static inline uint32_t HUMSearchDiagonalCost(uint32_t cost) {
+	return (uint32_t)sqrtf((float)(2 * (uint64_t)cost * cost));
+}
+
+#endif
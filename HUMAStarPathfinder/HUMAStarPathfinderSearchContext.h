@@ -0,0 +1,106 @@
+//
+//  HUMAStarPathfinderSearchContext.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HUMAStarPathfinder.h"
+#import "HUMAStarPathfinderSearch.h"
+#import "HUMAStarPathfinderBitSearch.h"
+#import "HUMAStarPathfinderChunkCache.h"
+
+/**
+ *	A snapshot of the map data and movement rules a single query runs against. Taken once when a query starts so changes made to the
+ *  pathfinder from another thread can't alter a search that is already in flight.
+ */
+typedef struct {
+	CGSize tileMapSize;
+	CGSize tileSize;
+	HUMAStarDistanceType distanceType;
+	HUMCoodinateSystemOrigin coordinateSystemOrigin;
+	BOOL pathDiagonally;
+	BOOL ignoreDiagonalBarriers;
+	BOOL pathCanCrossBorders;
+	NSUInteger baseMovementCost;
+	CGFloat diagonalMovementCost;
+	HUMAStarMemoryLayout memoryLayout;
+	NSUInteger boundedSearchMemoryLimit;
+} HUMAStarSearchSettings;
+
+/**
+ *	The per-query scratch state of a search. A pathfinder hands out one context per in-flight query from its pool, so any number of threads
+ *  can search the same map at once without sharing open or closed lists.
+ */
+@interface HUMAStarPathfinderSearchContext : NSObject
+
+@property (nonatomic, assign) HUMAStarSearchSettings settings;
+
+@property (nonatomic, assign) CGPoint startPoint;
+
+/**
+ *	The width and height in tiles of the unit the query is finding a path for. Defaults to 1.
+ */
+@property (nonatomic, assign) NSUInteger unitSize;
+
+/**
+ *	Whether the query searches from the start only, or from the start and target at once. Defaults to HUMAStarSearchModeUnidirectional.
+ */
+@property (nonatomic, assign) HUMAStarSearchMode searchMode;
+
+/**
+ *	Whether the query skips swamps. Only set while the pathfinder's swamp map is locked. Defaults to NO.
+ */
+@property (nonatomic, assign) BOOL prunesSwamps;
+
+/**
+ *	The scratch memory of the search, sized and laid out for the tile map in the current settings. Owned by the context.
+ */
+@property (nonatomic, readonly) HUMSearchContext *search;
+
+/**
+ *	The scratch memory of a breadth-first search, sized for the tile map in the current settings, or NULL until one is prepared. Owned by the
+ *  context.
+ */
+@property (nonatomic, readonly) HUMBitSearchContext *bitSearch;
+
+/**
+ *	Makes sure the scratch memory matches the tile map size and memory layout, reallocating it if either has changed since the context was
+ *  last used.
+ *
+ *	@param	tileMapSize		The size of the tile map the next query runs on.
+ *	@param	memoryLayout	The memory layout the next query runs with.
+ *
+ *	@return	NO if the scratch memory couldn't be allocated.
+ */
+- (BOOL)prepareForTileMapSize:(CGSize)tileMapSize memoryLayout:(HUMAStarMemoryLayout)memoryLayout;
+
+/**
+ *	Makes sure the breadth-first scratch memory matches the tile map size, reallocating it if the map has been resized since it was last used.
+ *
+ *	@param	tileMapSize	The size of the tile map the next query runs on.
+ *
+ *	@return	NO if the scratch memory couldn't be allocated.
+ */
+- (BOOL)prepareBitSearchForTileMapSize:(CGSize)tileMapSize;
+
+/**
+ *	The query's cursor into a paged map, or NULL if the map isn't paged. Holds the chunks the query is reading pinned until -reset.
+ */
+@property (nonatomic, readonly) HUMChunkCursor *chunkCursor;
+
+/**
+ *	Starts a cursor into a paged map for the next query.
+ *
+ *	@param	chunkCache	The chunks of the paged map.
+ */
+- (void)beginChunkCursorWithCache:(HUMChunkCache *)chunkCache;
+
+/**
+ *	Clears all scratch state so the context can be reused for another query.
+ */
+- (void)reset;
+
+@end
@@ -0,0 +1,88 @@
+//
+//  HUMAStarPathfinderSearchContext.m
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import "HUMAStarPathfinderSearchContext.h"
+
+@implementation HUMAStarPathfinderSearchContext {
+	HUMChunkCursor _chunkCursorStorage;
+}
+
+- (id)init {
+	self = [super init];
+	if (self) {
+		_unitSize = 1;
+	}
+
+	return self;
+}
+
+- (void)dealloc {
+	if (_chunkCursor) {
+		HUMChunkCursorFinish(_chunkCursor);
+	}
+	
+	HUMSearchContextFree(_search);
+	HUMBitSearchContextFree(_bitSearch);
+}
+
+- (BOOL)prepareForTileMapSize:(CGSize)tileMapSize memoryLayout:(HUMAStarMemoryLayout)memoryLayout {
+	int32_t width = (int32_t)tileMapSize.width;
+	int32_t height = (int32_t)tileMapSize.height;
+	HUMSearchLayout layout = (HUMSearchLayout)memoryLayout;
+	
+	if (_search && _search->width == width && _search->height == height && _search->layout == layout) {
+		return YES;
+	}
+	
+	HUMSearchContextFree(_search);
+	_search = HUMSearchContextCreate(width, height, layout);
+	
+	return _search != NULL;
+}
+
+- (BOOL)prepareBitSearchForTileMapSize:(CGSize)tileMapSize {
+	int32_t width = (int32_t)tileMapSize.width;
+	int32_t height = (int32_t)tileMapSize.height;
+	
+	if (_bitSearch && _bitSearch->width == width && _bitSearch->height == height) {
+		return YES;
+	}
+	
+	HUMBitSearchContextFree(_bitSearch);
+	_bitSearch = HUMBitSearchContextCreate(width, height);
+	
+	return _bitSearch != NULL;
+}
+
+- (void)beginChunkCursorWithCache:(HUMChunkCache *)chunkCache {
+	if (_chunkCursor) {
+		HUMChunkCursorFinish(_chunkCursor);
+	}
+	
+	HUMChunkCursorInit(&_chunkCursorStorage, chunkCache);
+	_chunkCursor = &_chunkCursorStorage;
+}
+
+- (void)reset {
+	if (_search) {
+		HUMSearchContextReset(_search);
+	}
+	
+	if (_chunkCursor) {
+		HUMChunkCacheRecordQuery(_chunkCursor->cache, _chunkCursor->faultCount);
+		HUMChunkCursorFinish(_chunkCursor);
+		_chunkCursor = NULL;
+	}
+
+	self.startPoint = CGPointZero;
+	self.unitSize = 1;
+	self.searchMode = HUMAStarSearchModeUnidirectional;
+	self.prunesSwamps = NO;
+}
+
+@end
@@ -0,0 +1,67 @@
+//
+//  HUMAStarPathfinderSubgoalGraph.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "HUMAStarPathfinder.h"
+#import "HUMAStarPathfinderSubgoals.h"
+
+/**
+ *	A subgoal graph of a tile map, as built by -[HUMAStarPathfinder subgoalGraph]. Subgoals sit next to the corners of unwalkable tiles, and
+ *  are joined wherever a unit can walk between them moving only toward its destination. Searches connect the start and target to the graph
+ *  and expand a handful of subgoals instead of every tile between them, then fill in the tiles between the subgoals of the result. Paths are
+ *  the same shortest tile paths the pathfinder finds when every tile costs the same.
+ *
+ *  The graph never changes once built, so it can be searched from any number of threads at once. Build a new one when the map changes.
+ */
+@interface HUMAStarPathfinderSubgoalGraph : NSObject
+
+/**
+ *	Creates a subgoal graph that takes ownership of a graph created with HUMSubgoalGraphCreate or HUMSubgoalGraphCreateWithData. The graph is
+ *  freed when the subgoal graph is deallocated.
+ *
+ *	@param	tileSize	The size of each tile in points.
+ *	@param	origin		The coordinate system positions are given in.
+ *	@param	graph		The graph of the tile map.
+ */
+- (id)initWithTileSize:(CGSize)tileSize coordinateSystemOrigin:(HUMCoodinateSystemOrigin)origin graphNoCopy:(HUMSubgoalGraph *)graph;
+
+@property (nonatomic, readonly) CGSize tileMapSize;
+@property (nonatomic, readonly) CGSize tileSize;
+@property (nonatomic, readonly) HUMCoodinateSystemOrigin coordinateSystemOrigin;
+
+/**
+ *	The number of subgoals, which is the most nodes a search can expand besides the start and target.
+ */
+@property (nonatomic, readonly) NSUInteger subgoalCount;
+
+/**
+ *	The underlying graph.
+ */
+@property (nonatomic, readonly) const HUMSubgoalGraph *graph;
+
+/**
+ *	Serializes the graph, along with the walkability it was built from, so it can be built offline and read back with
+ *  -[HUMAStarPathfinder subgoalGraphWithData:error:].
+ *
+ *	@return	The serialized graph, or nil if it couldn't be allocated.
+ */
+- (NSData *)dataRepresentation;
+
+/**
+ *	Finds a shortest path from the start point to the target point through the graph.
+ *
+ *	@param	start	A CGPoint where the path should start.
+ *	@param	target	A CGPoint where the path should end.
+ *
+ *	@return	An NSArray of NSValue-wrapped CGPoints, starting with start and followed by the center of every tile after the start tile, as
+ *			returned by -[HUMAStarPathfinder findPathFromStart:toTarget:]. nil if the start and target are in the same tile, either is outside
+ *			the map, or the target isn't walkable. An empty array if there is no path between them.
+ */
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target;
+
+@end
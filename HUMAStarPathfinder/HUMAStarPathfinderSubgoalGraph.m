@@ -0,0 +1,114 @@
+//
+//  HUMAStarPathfinderSubgoalGraph.m
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#import "HUMAStarPathfinderSubgoalGraph.h"
+
+@implementation HUMAStarPathfinderSubgoalGraph
+
+- (id)initWithTileSize:(CGSize)tileSize coordinateSystemOrigin:(HUMCoodinateSystemOrigin)origin graphNoCopy:(HUMSubgoalGraph *)graph {
+	NSParameterAssert(graph);
+
+	self = [super init];
+	if (self) {
+		_tileMapSize = CGSizeMake(graph->width, graph->height);
+		_tileSize = tileSize;
+		_coordinateSystemOrigin = origin;
+		_graph = graph;
+	}
+
+	return self;
+}
+
+- (void)dealloc {
+	HUMSubgoalGraphFree((HUMSubgoalGraph *)_graph);
+}
+
+- (NSUInteger)subgoalCount {
+	return _graph->nodeCount;
+}
+
+- (NSData *)dataRepresentation {
+	size_t size = 0;
+	void *bytes = HUMSubgoalGraphCopyData(_graph, &size);
+
+	if (!bytes) {
+		return nil;
+	}
+
+	return [NSData dataWithBytesNoCopy:bytes length:size freeWhenDone:YES];
+}
+
+#pragma mark - Coordinates
+/**
+ *	Converts a position to the tile it lies in, where y grows downward from the top of the map.
+ */
+- (BOOL)getTileX:(int32_t *)x y:(int32_t *)y forPosition:(CGPoint)position {
+	CGFloat tileY = position.y / self.tileSize.height;
+
+	if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		tileY = self.tileMapSize.height - tileY;
+	}
+
+	CGFloat tileX = position.x / self.tileSize.width;
+
+	if (tileX < 0 || tileY < 0 || tileX >= self.tileMapSize.width || tileY >= self.tileMapSize.height) {
+		return NO;
+	}
+
+	*x = (int32_t)tileX;
+	*y = (int32_t)tileY;
+
+	return YES;
+}
+
+- (CGPoint)positionForTileX:(int32_t)x y:(int32_t)y {
+	CGFloat tileY = y + 0.5;
+
+	if (self.coordinateSystemOrigin == HUMCoodinateSystemOriginBottomLeft) {
+		tileY = self.tileMapSize.height - tileY;
+	}
+
+	return CGPointMake((x + 0.5) * self.tileSize.width, tileY * self.tileSize.height);
+}
+
+#pragma mark - Queries
+- (NSArray *)findPathFromStart:(CGPoint)start toTarget:(CGPoint)target {
+	int32_t startX, startY, targetX, targetY;
+
+	if (![self getTileX:&startX y:&startY forPosition:start] || ![self getTileX:&targetX y:&targetY forPosition:target]) {
+		return nil;
+	}
+
+	if ((startX == targetX && startY == targetY) || !_graph->walkable[targetY * _graph->width + targetX]) {
+		return nil;
+	}
+
+	HUMSubgoalPath path;
+	if (!HUMSubgoalGraphFindPath(_graph, startX, startY, targetX, targetY, &path)) {
+		HUMSubgoalPathFree(&path);
+		return @[];
+	}
+
+	NSMutableArray *points = [NSMutableArray arrayWithCapacity:path.count];
+
+	// the first tile is the start tile, which is replaced by the exact start point
+	for (int32_t i = 0; i < path.count; i++) {
+		CGPoint position = i == 0 ? start : [self positionForTileX:path.xs[i] y:path.ys[i]];
+#if TARGET_OS_IPHONE
+		[points addObject:[NSValue valueWithCGPoint:position]];
+#else
+		[points addObject:[NSValue valueWithPoint:position]];
+#endif
+	}
+
+	HUMSubgoalPathFree(&path);
+
+	return [NSArray arrayWithArray:points];
+}
+
+@end
@@ -0,0 +1,955 @@
+//
+//  HUMAStarPathfinderSubgoals.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderSubgoals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	int32_t width;
+	int32_t height;
+	uint32_t neighbors;
+	uint32_t cardinalCost;
+	int32_t nodeCount;
+	int32_t edgeCount;
+} HUMSubgoalGraphHeader;
+
+/**
+ *	A direction tiles are reached in, and what each step costs.
+ */
+typedef struct {
+	int32_t x;
+	int32_t y;
+	uint32_t cost;
+} HUMSubgoalStep;
+
+#pragma mark - Tiles
+
+static inline bool HUMSubgoalGraphIsWalkable(const HUMSubgoalGraph *graph, int32_t x, int32_t y) {
+	if (x < 0 || y < 0 || x >= graph->width || y >= graph->height) {
+		return false;
+	}
+
+	return graph->walkable[y * graph->width + x] != 0;
+}
+
+/**
+ *	Determines if a unit can step from a tile to its neighbor, under the same corner rules as HUMSearchFindPath.
+ */
+static inline bool HUMSubgoalGraphCanStep(const HUMSubgoalGraph *graph, int32_t x, int32_t y, HUMSubgoalStep step) {
+	if (!HUMSubgoalGraphIsWalkable(graph, x + step.x, y + step.y)) {
+		return false;
+	}
+
+	if (step.x == 0 || step.y == 0) {
+		return true;
+	}
+
+	switch (graph->neighbors) {
+		case HUMSearchNeighborsDiagonalCrossBorders:
+			return HUMSubgoalGraphIsWalkable(graph, x + step.x, y) || HUMSubgoalGraphIsWalkable(graph, x, y + step.y);
+
+		case HUMSearchNeighborsDiagonalStrict:
+			return HUMSubgoalGraphIsWalkable(graph, x + step.x, y) && HUMSubgoalGraphIsWalkable(graph, x, y + step.y);
+
+		default:
+			return true;
+	}
+}
+
+/**
+ *	Determines if a shortest path may have to turn at a tile. Every policy turns around a convex corner, where the tile diagonal to this one is
+ *  unwalkable but both tiles beside it are walkable. Policies that cut corners can also slip diagonally past the end of an obstacle, so they
+ *  turn at the tiles beside its tip as well.
+ */
+static bool HUMSubgoalGraphIsSubgoal(const HUMSubgoalGraph *graph, int32_t x, int32_t y) {
+	if (!HUMSubgoalGraphIsWalkable(graph, x, y)) {
+		return false;
+	}
+
+	bool cutsCorners = (graph->neighbors == HUMSearchNeighborsDiagonal || graph->neighbors == HUMSearchNeighborsDiagonalCrossBorders);
+	bool needsSide = (graph->neighbors == HUMSearchNeighborsDiagonalCrossBorders);
+
+	for (int32_t dy = -1; dy <= 1; dy += 2) {
+		for (int32_t dx = -1; dx <= 1; dx += 2) {
+			bool horizontal = HUMSubgoalGraphIsWalkable(graph, x + dx, y);
+			bool vertical = HUMSubgoalGraphIsWalkable(graph, x, y + dy);
+			bool diagonal = HUMSubgoalGraphIsWalkable(graph, x + dx, y + dy);
+
+			if (!diagonal && horizontal && vertical) {
+				return true;
+			}
+
+			if (cutsCorners && diagonal && ((!horizontal && (vertical || !needsSide)) || (!vertical && (horizontal || !needsSide)))) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+/**
+ *	The cost of a path that only ever moves toward the target, which is the least a path between two tiles can cost.
+ */
+static inline uint32_t HUMSubgoalGraphDistance(const HUMSubgoalGraph *graph, int32_t fromTile, int32_t toTile) {
+	int32_t distanceX = abs(fromTile % graph->width - toTile % graph->width);
+	int32_t distanceY = abs(fromTile / graph->width - toTile / graph->width);
+
+	if (graph->neighbors == HUMSearchNeighborsCardinal) {
+		return (uint32_t)(distanceX + distanceY) * graph->cardinalCost;
+	}
+
+	int32_t diagonal = distanceX < distanceY ? distanceX : distanceY;
+	int32_t straight = (distanceX > distanceY ? distanceX : distanceY) - diagonal;
+
+	return (uint32_t)diagonal * graph->diagonalCost + (uint32_t)straight * graph->cardinalCost;
+}
+
+/**
+ *	The two steps a path from one tile to another is made of when it only moves toward the target: diagonal and straight steps under a diagonal
+ *  policy, vertical and horizontal steps otherwise.
+ */
+static void HUMSubgoalGraphStepsBetween(const HUMSubgoalGraph *graph, int32_t fromX, int32_t fromY, int32_t toX, int32_t toY, HUMSubgoalStep *first, int32_t *firstCount, HUMSubgoalStep *second, int32_t *secondCount) {
+	int32_t dx = toX - fromX;
+	int32_t dy = toY - fromY;
+	int32_t signX = dx < 0 ? -1 : 1;
+	int32_t signY = dy < 0 ? -1 : 1;
+
+	if (graph->neighbors == HUMSearchNeighborsCardinal) {
+		*first = (HUMSubgoalStep){ 0, signY, graph->cardinalCost };
+		*firstCount = abs(dy);
+		*second = (HUMSubgoalStep){ signX, 0, graph->cardinalCost };
+		*secondCount = abs(dx);
+		return;
+	}
+
+	*first = (HUMSubgoalStep){ signX, signY, graph->diagonalCost };
+
+	if (abs(dx) >= abs(dy)) {
+		*firstCount = abs(dy);
+		*second = (HUMSubgoalStep){ signX, 0, graph->cardinalCost };
+		*secondCount = abs(dx) - abs(dy);
+	}
+	else {
+		*firstCount = abs(dx);
+		*second = (HUMSubgoalStep){ 0, signY, graph->cardinalCost };
+		*secondCount = abs(dy) - abs(dx);
+	}
+}
+
+#pragma mark - H-Reachability
+
+typedef void (*HUMSubgoalFoundFunction)(void *info, int32_t tile, uint32_t cost);
+
+/**
+ *	The scratch memory of an exploration: two rows of flags, as long as the longest side of the map.
+ */
+typedef struct {
+	uint8_t *rows[2];
+} HUMSubgoalFloodBuffers;
+
+static bool HUMSubgoalFloodBuffersInit(HUMSubgoalFloodBuffers *buffers, const HUMSubgoalGraph *graph) {
+	size_t length = (size_t)(graph->width > graph->height ? graph->width : graph->height) + 1;
+
+	buffers->rows[0] = malloc(length);
+	buffers->rows[1] = malloc(length);
+
+	return buffers->rows[0] && buffers->rows[1];
+}
+
+static void HUMSubgoalFloodBuffersFree(HUMSubgoalFloodBuffers *buffers) {
+	free(buffers->rows[0]);
+	free(buffers->rows[1]);
+}
+
+/**
+ *	Explores the tiles reachable from a tile by taking i first steps and j second steps in any order, for every i and j, row by row of i.
+ *  Reaching a subgoal or the goal tile reports it and goes no further through it.
+ */
+static void HUMSubgoalGraphFloodSector(const HUMSubgoalGraph *graph, int32_t x, int32_t y, HUMSubgoalStep first, HUMSubgoalStep second, int32_t goalTile, HUMSubgoalFloodBuffers *buffers, HUMSubgoalFoundFunction found, void *info) {
+	uint8_t *previous = buffers->rows[0];
+	uint8_t *current = buffers->rows[1];
+	int32_t previousLength = 0;
+
+	for (int32_t i = 0; ; i++) {
+		int32_t length = 0;
+		bool propagates = false;
+
+		for (int32_t j = 0; ; j++) {
+			int32_t tileX = x + i * first.x + j * second.x;
+			int32_t tileY = y + i * first.y + j * second.y;
+			bool fromPrevious = (j < previousLength && previous[j]);
+			bool fromLeft = (j > 0 && current[j - 1]);
+
+			// the rest of the row is out of the map, or can't be reached from either direction
+			if (tileX < 0 || tileY < 0 || tileX >= graph->width || tileY >= graph->height || (j >= previousLength && !fromLeft && (i > 0 || j > 0))) {
+				break;
+			}
+
+			bool reached = (i == 0 && j == 0) ||
+						   (fromPrevious && HUMSubgoalGraphCanStep(graph, tileX - first.x, tileY - first.y, first)) ||
+						   (fromLeft && HUMSubgoalGraphCanStep(graph, tileX - second.x, tileY - second.y, second));
+			int32_t tile = tileY * graph->width + tileX;
+
+			if (reached && (i > 0 || j > 0) && (graph->nodeAtTile[tile] != -1 || tile == goalTile)) {
+				found(info, tile, (uint32_t)i * first.cost + (uint32_t)j * second.cost);
+				reached = false;
+			}
+
+			current[j] = reached;
+			propagates |= reached;
+			length = j + 1;
+		}
+
+		if (!propagates) {
+			break;
+		}
+
+		uint8_t *swap = previous;
+		previous = current;
+		current = swap;
+		previousLength = length;
+	}
+}
+
+/**
+ *	Finds every subgoal, and the goal tile if there is one, that a tile can h-reach without passing through another subgoal.
+ *
+ *	@param	goalTile	A tile to report if reached, or -1.
+ */
+static void HUMSubgoalGraphFlood(const HUMSubgoalGraph *graph, int32_t tile, int32_t goalTile, HUMSubgoalFloodBuffers *buffers, HUMSubgoalFoundFunction found, void *info) {
+	int32_t x = tile % graph->width;
+	int32_t y = tile / graph->width;
+
+	for (int32_t signY = -1; signY <= 1; signY += 2) {
+		for (int32_t signX = -1; signX <= 1; signX += 2) {
+			if (graph->neighbors == HUMSearchNeighborsCardinal) {
+				HUMSubgoalStep vertical = { 0, signY, graph->cardinalCost };
+				HUMSubgoalStep horizontal = { signX, 0, graph->cardinalCost };
+				HUMSubgoalGraphFloodSector(graph, x, y, vertical, horizontal, goalTile, buffers, found, info);
+			}
+			else {
+				HUMSubgoalStep diagonal = { signX, signY, graph->diagonalCost };
+				HUMSubgoalStep horizontal = { signX, 0, graph->cardinalCost };
+				HUMSubgoalStep vertical = { 0, signY, graph->cardinalCost };
+				HUMSubgoalGraphFloodSector(graph, x, y, diagonal, horizontal, goalTile, buffers, found, info);
+				HUMSubgoalGraphFloodSector(graph, x, y, diagonal, vertical, goalTile, buffers, found, info);
+			}
+		}
+	}
+}
+
+#pragma mark - Building
+
+/**
+ *	Collects the edges found by exploring from one subgoal or query tile. The same tile can be found from two sectors, so each is only kept
+ *  the first time.
+ */
+typedef struct {
+	const HUMSubgoalGraph *graph;
+	int32_t source;			// marks the nodes already found
+	int32_t *marks;			// nodeCount marks
+	int32_t *nodes;
+	uint32_t *costs;
+	int32_t count;
+	int32_t capacity;
+	bool failed;
+	int32_t goalTile;
+	uint32_t goalCost;		// UINT32_MAX until the goal is found
+} HUMSubgoalEdgeCollector;
+
+static void HUMSubgoalEdgeCollectorFound(void *info, int32_t tile, uint32_t cost) {
+	HUMSubgoalEdgeCollector *collector = info;
+
+	if (tile == collector->goalTile) {
+		collector->goalCost = cost;
+	}
+
+	int32_t node = collector->graph->nodeAtTile[tile];
+
+	if (node == -1 || collector->marks[node] == collector->source || collector->failed) {
+		return;
+	}
+
+	collector->marks[node] = collector->source;
+
+	if (collector->count == collector->capacity) {
+		int32_t capacity = collector->capacity ? collector->capacity * 2 : 256;
+		int32_t *nodes = realloc(collector->nodes, capacity * sizeof(int32_t));
+		uint32_t *costs = nodes ? realloc(collector->costs, capacity * sizeof(uint32_t)) : NULL;
+
+		if (nodes) {
+			collector->nodes = nodes;
+		}
+
+		if (!nodes || !costs) {
+			collector->failed = true;
+			return;
+		}
+
+		collector->costs = costs;
+		collector->capacity = capacity;
+	}
+
+	collector->nodes[collector->count] = node;
+	collector->costs[collector->count] = cost;
+	collector->count++;
+}
+
+static HUMSubgoalGraph *HUMSubgoalGraphAllocate(int32_t width, int32_t height, HUMSearchNeighbors neighbors, uint32_t cardinalCost) {
+	if (width <= 0 || height <= 0 || neighbors >= HUMSearchNeighborsCount || cardinalCost == 0) {
+		return NULL;
+	}
+
+	// a diagonal step has to cost more than a straight one for paths that only move toward the target to be the only shortest paths
+	if (neighbors != HUMSearchNeighborsCardinal && HUMSearchDiagonalCost(cardinalCost) <= cardinalCost) {
+		return NULL;
+	}
+
+	HUMSubgoalGraph *graph = calloc(1, sizeof(HUMSubgoalGraph));
+	if (!graph) {
+		return NULL;
+	}
+
+	graph->width = width;
+	graph->height = height;
+	graph->neighbors = neighbors;
+	graph->cardinalCost = cardinalCost;
+	graph->diagonalCost = HUMSearchDiagonalCost(cardinalCost);
+	graph->walkable = malloc((size_t)width * height);
+	graph->nodeAtTile = malloc((size_t)width * height * sizeof(int32_t));
+
+	if (!graph->walkable || !graph->nodeAtTile) {
+		HUMSubgoalGraphFree(graph);
+		return NULL;
+	}
+
+	return graph;
+}
+
+HUMSubgoalGraph *HUMSubgoalGraphCreate(int32_t width, int32_t height, const uint8_t *walkable, HUMSearchNeighbors neighbors, uint32_t cardinalCost) {
+	HUMSubgoalGraph *graph = HUMSubgoalGraphAllocate(width, height, neighbors, cardinalCost);
+	if (!graph) {
+		return NULL;
+	}
+
+	size_t tileCount = (size_t)width * height;
+
+	for (size_t i = 0; i < tileCount; i++) {
+		graph->walkable[i] = walkable[i] ? 1 : 0;
+	}
+
+	int32_t nodeCount = 0;
+
+	for (int32_t y = 0; y < height; y++) {
+		for (int32_t x = 0; x < width; x++) {
+			graph->nodeAtTile[y * width + x] = HUMSubgoalGraphIsSubgoal(graph, x, y) ? nodeCount++ : -1;
+		}
+	}
+
+	graph->nodeCount = nodeCount;
+	graph->nodeTiles = malloc((nodeCount + 1) * sizeof(int32_t));
+	graph->firstEdge = malloc((nodeCount + 1) * sizeof(int32_t));
+
+	HUMSubgoalFloodBuffers buffers;
+	bool buffersReady = HUMSubgoalFloodBuffersInit(&buffers, graph);
+	HUMSubgoalEdgeCollector collector = { graph, -1, malloc((nodeCount + 1) * sizeof(int32_t)), NULL, NULL, 0, 0, false, -1, UINT32_MAX };
+
+	if (!graph->nodeTiles || !graph->firstEdge || !buffersReady || !collector.marks) {
+		collector.failed = true;
+		goto done;
+	}
+
+	for (size_t i = 0; i < tileCount; i++) {
+		if (graph->nodeAtTile[i] != -1) {
+			graph->nodeTiles[graph->nodeAtTile[i]] = (int32_t)i;
+			collector.marks[graph->nodeAtTile[i]] = -1;
+		}
+	}
+
+	// the edges of each node are found in node order, so they're already grouped by node
+	for (int32_t node = 0; node < nodeCount && !collector.failed; node++) {
+		graph->firstEdge[node] = collector.count;
+		collector.source = node;
+		collector.marks[node] = node;
+		HUMSubgoalGraphFlood(graph, graph->nodeTiles[node], -1, &buffers, HUMSubgoalEdgeCollectorFound, &collector);
+	}
+
+	graph->firstEdge[nodeCount] = collector.count;
+	graph->edges = collector.nodes;
+	graph->edgeCosts = collector.costs;
+	graph->edgeCount = collector.count;
+	collector.nodes = NULL;
+	collector.costs = NULL;
+
+done:
+	HUMSubgoalFloodBuffersFree(&buffers);
+
+	free(collector.marks);
+	free(collector.nodes);
+	free(collector.costs);
+
+	if (collector.failed) {
+		HUMSubgoalGraphFree(graph);
+		return NULL;
+	}
+
+	return graph;
+}
+
+void HUMSubgoalGraphFree(HUMSubgoalGraph *graph) {
+	if (!graph) {
+		return;
+	}
+
+	free(graph->walkable);
+	free(graph->nodeAtTile);
+	free(graph->nodeTiles);
+	free(graph->firstEdge);
+	free(graph->edges);
+	free(graph->edgeCosts);
+	free(graph);
+}
+
+#pragma mark - Searching
+
+typedef struct {
+	uint32_t f;
+	int32_t node;
+} HUMSubgoalHeapEntry;
+
+/**
+ *	The scratch memory of one search. The graph's nodes are followed by the start and the target.
+ */
+typedef struct {
+	uint32_t *g;
+	int32_t *parent;
+	int32_t *heapIndex;		// -1 if not on the open list, -2 once closed
+	HUMSubgoalHeapEntry *heap;
+	int32_t heapCount;
+} HUMSubgoalSearch;
+
+static void HUMSubgoalHeapSwap(HUMSubgoalSearch *search, int32_t a, int32_t b) {
+	HUMSubgoalHeapEntry entry = search->heap[a];
+	search->heap[a] = search->heap[b];
+	search->heap[b] = entry;
+	search->heapIndex[search->heap[a].node] = a;
+	search->heapIndex[search->heap[b].node] = b;
+}
+
+static void HUMSubgoalHeapPush(HUMSubgoalSearch *search, int32_t node, uint32_t f) {
+	int32_t index = search->heapIndex[node];
+
+	if (index < 0) {
+		index = search->heapCount++;
+		search->heap[index].node = node;
+		search->heapIndex[node] = index;
+	}
+
+	search->heap[index].f = f;
+
+	while (index > 0) {
+		int32_t parent = (index - 1) / 2;
+		if (search->heap[parent].f <= search->heap[index].f) {
+			break;
+		}
+
+		HUMSubgoalHeapSwap(search, parent, index);
+		index = parent;
+	}
+}
+
+static int32_t HUMSubgoalHeapPop(HUMSubgoalSearch *search) {
+	int32_t node = search->heap[0].node;
+	search->heapCount--;
+
+	if (search->heapCount > 0) {
+		search->heap[0] = search->heap[search->heapCount];
+		search->heapIndex[search->heap[0].node] = 0;
+
+		int32_t index = 0;
+		for (;;) {
+			int32_t smallest = index;
+			int32_t left = index * 2 + 1;
+			int32_t right = left + 1;
+
+			if (left < search->heapCount && search->heap[left].f < search->heap[smallest].f) {
+				smallest = left;
+			}
+
+			if (right < search->heapCount && search->heap[right].f < search->heap[smallest].f) {
+				smallest = right;
+			}
+
+			if (smallest == index) {
+				break;
+			}
+
+			HUMSubgoalHeapSwap(search, smallest, index);
+			index = smallest;
+		}
+	}
+
+	search->heapIndex[node] = -2;
+	return node;
+}
+
+static void HUMSubgoalRelax(HUMSubgoalSearch *search, int32_t from, int32_t to, uint32_t cost, uint32_t h) {
+	if (search->heapIndex[to] == -2) {
+		return;
+	}
+
+	uint32_t g = search->g[from] + cost;
+
+	if (search->heapIndex[to] >= 0 && g >= search->g[to]) {
+		return;
+	}
+
+	search->g[to] = g;
+	search->parent[to] = from;
+	HUMSubgoalHeapPush(search, to, g + h);
+}
+
+/**
+ *	Appends the tiles of an h-reachable run between two tiles to a path, leaving out the first tile. Walks all the first steps then all the
+ *  second steps, or the other way around, and only when both are blocked falls back to finding a run through the tiles in between.
+ *
+ *	@return	false if the run is blocked or memory runs out.
+ */
+static bool HUMSubgoalGraphAppendRun(const HUMSubgoalGraph *graph, int32_t fromTile, int32_t toTile, HUMSubgoalPath *path) {
+	int32_t fromX = fromTile % graph->width;
+	int32_t fromY = fromTile / graph->width;
+	HUMSubgoalStep steps[2];
+	int32_t counts[2];
+	HUMSubgoalGraphStepsBetween(graph, fromX, fromY, toTile % graph->width, toTile / graph->width, &steps[0], &counts[0], &steps[1], &counts[1]);
+
+	for (int32_t order = 0; order < 2; order++) {
+		int32_t x = fromX;
+		int32_t y = fromY;
+		int32_t count = path->count;
+		bool clear = true;
+
+		for (int32_t part = 0; part < 2 && clear; part++) {
+			HUMSubgoalStep step = steps[part ^ order];
+
+			for (int32_t i = 0; i < counts[part ^ order]; i++) {
+				if (!HUMSubgoalGraphCanStep(graph, x, y, step)) {
+					clear = false;
+					break;
+				}
+
+				x += step.x;
+				y += step.y;
+				path->xs[count] = x;
+				path->ys[count] = y;
+				count++;
+			}
+		}
+
+		if (clear) {
+			path->count = count;
+			return true;
+		}
+	}
+
+	// which tiles of the (i, j) grid of first and second steps can be reached from the start of the run
+	int32_t columns = counts[1] + 1;
+	uint8_t *reached = calloc((size_t)(counts[0] + 1) * columns, 1);
+
+	if (!reached) {
+		return false;
+	}
+
+	for (int32_t i = 0; i <= counts[0]; i++) {
+		for (int32_t j = 0; j <= counts[1]; j++) {
+			int32_t x = fromX + i * steps[0].x + j * steps[1].x;
+			int32_t y = fromY + i * steps[0].y + j * steps[1].y;
+
+			reached[i * columns + j] = (i == 0 && j == 0) ||
+									   (i > 0 && reached[(i - 1) * columns + j] && HUMSubgoalGraphCanStep(graph, x - steps[0].x, y - steps[0].y, steps[0])) ||
+									   (j > 0 && reached[i * columns + j - 1] && HUMSubgoalGraphCanStep(graph, x - steps[1].x, y - steps[1].y, steps[1]));
+		}
+	}
+
+	bool clear = reached[counts[0] * columns + counts[1]];
+
+	if (clear) {
+		// walk back from the end of the run, filling in the tiles from the back
+		int32_t i = counts[0];
+		int32_t j = counts[1];
+		int32_t index = path->count + counts[0] + counts[1] - 1;
+
+		while (i > 0 || j > 0) {
+			path->xs[index] = fromX + i * steps[0].x + j * steps[1].x;
+			path->ys[index] = fromY + i * steps[0].y + j * steps[1].y;
+			index--;
+
+			if (i > 0 && reached[(i - 1) * columns + j] && HUMSubgoalGraphCanStep(graph, path->xs[index + 1] - steps[0].x, path->ys[index + 1] - steps[0].y, steps[0])) {
+				i--;
+			}
+			else {
+				j--;
+			}
+		}
+
+		path->count += counts[0] + counts[1];
+	}
+
+	free(reached);
+
+	return clear;
+}
+
+/**
+ *	Expands a list of tiles, each h-reachable from the one before it, into every tile of the path.
+ */
+static bool HUMSubgoalGraphExpandPath(const HUMSubgoalGraph *graph, const int32_t *tiles, int32_t tileCount, HUMSubgoalPath *path) {
+	int32_t length = 1;
+
+	for (int32_t i = 1; i < tileCount; i++) {
+		int32_t distanceX = abs(tiles[i] % graph->width - tiles[i - 1] % graph->width);
+		int32_t distanceY = abs(tiles[i] / graph->width - tiles[i - 1] / graph->width);
+
+		length += graph->neighbors == HUMSearchNeighborsCardinal ? distanceX + distanceY : (distanceX > distanceY ? distanceX : distanceY);
+	}
+
+	path->xs = malloc(length * sizeof(int32_t));
+	path->ys = malloc(length * sizeof(int32_t));
+
+	if (!path->xs || !path->ys) {
+		return false;
+	}
+
+	path->xs[0] = tiles[0] % graph->width;
+	path->ys[0] = tiles[0] / graph->width;
+	path->count = 1;
+
+	for (int32_t i = 1; i < tileCount; i++) {
+		if (!HUMSubgoalGraphAppendRun(graph, tiles[i - 1], tiles[i], path)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool HUMSubgoalGraphFindPath(const HUMSubgoalGraph *graph, int32_t startX, int32_t startY, int32_t targetX, int32_t targetY, HUMSubgoalPath *path) {
+	memset(path, 0, sizeof(HUMSubgoalPath));
+
+	if (!HUMSubgoalGraphIsWalkable(graph, startX, startY) || !HUMSubgoalGraphIsWalkable(graph, targetX, targetY)) {
+		return false;
+	}
+
+	int32_t startTile = startY * graph->width + startX;
+	int32_t targetTile = targetY * graph->width + targetX;
+	int32_t nodeCount = graph->nodeCount;
+	int32_t start = nodeCount;
+	int32_t target = nodeCount + 1;
+
+	HUMSubgoalFloodBuffers buffers;
+	bool buffersReady = HUMSubgoalFloodBuffersInit(&buffers, graph);
+	HUMSubgoalEdgeCollector startEdges = { graph, start, malloc((nodeCount + 2) * sizeof(int32_t)), NULL, NULL, 0, 0, false, targetTile, UINT32_MAX };
+	uint32_t *targetCosts = malloc((nodeCount + 1) * sizeof(uint32_t));
+
+	HUMSubgoalSearch search;
+	search.g = malloc((nodeCount + 2) * sizeof(uint32_t));
+	search.parent = malloc((nodeCount + 2) * sizeof(int32_t));
+	search.heapIndex = malloc((nodeCount + 2) * sizeof(int32_t));
+	search.heap = malloc((nodeCount + 2) * sizeof(HUMSubgoalHeapEntry));
+	search.heapCount = 0;
+
+	int32_t *tiles = NULL;
+	bool found = false;
+
+	if (!buffersReady || !startEdges.marks || !targetCosts || !search.g || !search.parent || !search.heapIndex || !search.heap) {
+		goto done;
+	}
+
+	if (startTile == targetTile) {
+		found = HUMSubgoalGraphExpandPath(graph, &startTile, 1, path);
+		goto done;
+	}
+
+	for (int32_t i = 0; i < nodeCount + 2; i++) {
+		startEdges.marks[i] = -1;
+		search.heapIndex[i] = -1;
+	}
+
+	// the start connects to the subgoals it can h-reach, or straight to the target when it can h-reach that
+	if (graph->nodeAtTile[startTile] != -1) {
+		HUMSubgoalEdgeCollectorFound(&startEdges, startTile, 0);
+	}
+
+	HUMSubgoalGraphFlood(graph, startTile, targetTile, &buffers, HUMSubgoalEdgeCollectorFound, &startEdges);
+
+	if (startEdges.failed) {
+		goto done;
+	}
+
+	if (startEdges.goalCost != UINT32_MAX) {
+		int32_t direct[2] = { startTile, targetTile };
+		found = HUMSubgoalGraphExpandPath(graph, direct, 2, path);
+		path->cost = startEdges.goalCost;
+		goto done;
+	}
+
+	// and the target to the subgoals that can h-reach it
+	HUMSubgoalEdgeCollector targetEdges = { graph, target, startEdges.marks, NULL, NULL, 0, 0, false, -1, UINT32_MAX };
+
+	if (graph->nodeAtTile[targetTile] != -1) {
+		HUMSubgoalEdgeCollectorFound(&targetEdges, targetTile, 0);
+	}
+
+	HUMSubgoalGraphFlood(graph, targetTile, -1, &buffers, HUMSubgoalEdgeCollectorFound, &targetEdges);
+
+	for (int32_t i = 0; i < nodeCount; i++) {
+		targetCosts[i] = UINT32_MAX;
+	}
+
+	for (int32_t i = 0; i < targetEdges.count; i++) {
+		targetCosts[targetEdges.nodes[i]] = targetEdges.costs[i];
+	}
+
+	bool targetFailed = targetEdges.failed;
+	free(targetEdges.nodes);
+	free(targetEdges.costs);
+
+	if (targetFailed) {
+		goto done;
+	}
+
+	search.g[start] = 0;
+	search.parent[start] = -1;
+	HUMSubgoalHeapPush(&search, start, HUMSubgoalGraphDistance(graph, startTile, targetTile));
+
+	while (search.heapCount > 0) {
+		int32_t current = HUMSubgoalHeapPop(&search);
+		path->nodesExpanded++;
+
+		if (current == target) {
+			found = true;
+			break;
+		}
+
+		if (current == start) {
+			for (int32_t i = 0; i < startEdges.count; i++) {
+				int32_t neighbor = startEdges.nodes[i];
+				HUMSubgoalRelax(&search, start, neighbor, startEdges.costs[i], HUMSubgoalGraphDistance(graph, graph->nodeTiles[neighbor], targetTile));
+			}
+
+			continue;
+		}
+
+		for (int32_t e = graph->firstEdge[current]; e < graph->firstEdge[current + 1]; e++) {
+			int32_t neighbor = graph->edges[e];
+			HUMSubgoalRelax(&search, current, neighbor, graph->edgeCosts[e], HUMSubgoalGraphDistance(graph, graph->nodeTiles[neighbor], targetTile));
+		}
+
+		if (targetCosts[current] != UINT32_MAX) {
+			HUMSubgoalRelax(&search, current, target, targetCosts[current], 0);
+		}
+	}
+
+	if (found) {
+		int32_t count = 0;
+		for (int32_t node = target; node != -1; node = search.parent[node]) {
+			count++;
+		}
+
+		tiles = malloc(count * sizeof(int32_t));
+		if (!tiles) {
+			found = false;
+			goto done;
+		}
+
+		int32_t index = count - 1;
+		for (int32_t node = target; node != -1; node = search.parent[node], index--) {
+			tiles[index] = node == start ? startTile : (node == target ? targetTile : graph->nodeTiles[node]);
+		}
+
+		found = HUMSubgoalGraphExpandPath(graph, tiles, count, path);
+		path->cost = search.g[target];
+	}
+
+done:
+	HUMSubgoalFloodBuffersFree(&buffers);
+
+	free(startEdges.marks);
+	free(startEdges.nodes);
+	free(startEdges.costs);
+	free(targetCosts);
+	free(search.g);
+	free(search.parent);
+	free(search.heapIndex);
+	free(search.heap);
+	free(tiles);
+
+	return found;
+}
+
+void HUMSubgoalPathFree(HUMSubgoalPath *path) {
+	free(path->xs);
+	free(path->ys);
+	path->xs = NULL;
+	path->ys = NULL;
+	path->count = 0;
+}
+
+#pragma mark - Serialization
+
+/**
+ *	The sizes of the parts of serialized data, each padded to 4 bytes: the header, the walkable bits, the node tiles, the edge offsets, the
+ *  edges, and the edge costs.
+ */
+static uint64_t HUMSubgoalGraphDataSize(int32_t width, int32_t height, int32_t nodeCount, int32_t edgeCount, uint64_t *walkableSize) {
+	*walkableSize = (((uint64_t)width * height + 7) / 8 + 3) & ~(uint64_t)3;
+
+	return sizeof(HUMSubgoalGraphHeader) + *walkableSize + (uint64_t)nodeCount * 4 + ((uint64_t)nodeCount + 1) * 4 + (uint64_t)edgeCount * 8;
+}
+
+void *HUMSubgoalGraphCopyData(const HUMSubgoalGraph *graph, size_t *size) {
+	uint64_t walkableSize = 0;
+	uint64_t dataSize = HUMSubgoalGraphDataSize(graph->width, graph->height, graph->nodeCount, graph->edgeCount, &walkableSize);
+
+	if (dataSize > SIZE_MAX) {
+		return NULL;
+	}
+
+	uint8_t *data = calloc(1, (size_t)dataSize);
+	if (!data) {
+		return NULL;
+	}
+
+	HUMSubgoalGraphHeader header = { HUMSubgoalGraphMagic, HUMSubgoalGraphVersion, graph->width, graph->height, graph->neighbors, graph->cardinalCost, graph->nodeCount, graph->edgeCount };
+	uint8_t *cursor = data;
+
+	memcpy(cursor, &header, sizeof(header));
+	cursor += sizeof(header);
+
+	size_t tileCount = (size_t)graph->width * graph->height;
+	for (size_t i = 0; i < tileCount; i++) {
+		if (graph->walkable[i]) {
+			cursor[i / 8] |= (uint8_t)(1 << (i % 8));
+		}
+	}
+	cursor += walkableSize;
+
+	memcpy(cursor, graph->nodeTiles, (size_t)graph->nodeCount * 4);
+	cursor += (size_t)graph->nodeCount * 4;
+	memcpy(cursor, graph->firstEdge, ((size_t)graph->nodeCount + 1) * 4);
+	cursor += ((size_t)graph->nodeCount + 1) * 4;
+
+	if (graph->edgeCount > 0) {
+		memcpy(cursor, graph->edges, (size_t)graph->edgeCount * 4);
+		cursor += (size_t)graph->edgeCount * 4;
+		memcpy(cursor, graph->edgeCosts, (size_t)graph->edgeCount * 4);
+	}
+
+	*size = (size_t)dataSize;
+
+	return data;
+}
+
+HUMSubgoalGraph *HUMSubgoalGraphCreateWithData(const void *bytes, size_t size, HUMSubgoalGraphStatus *status) {
+	HUMSubgoalGraphHeader header;
+	*status = HUMSubgoalGraphStatusInvalid;
+
+	if (size < sizeof(header)) {
+		return NULL;
+	}
+
+	memcpy(&header, bytes, sizeof(header));
+
+	if (header.magic != HUMSubgoalGraphMagic) {
+		return NULL;
+	}
+
+	if (header.version != HUMSubgoalGraphVersion) {
+		*status = HUMSubgoalGraphStatusUnsupportedVersion;
+		return NULL;
+	}
+
+	if (header.width <= 0 || header.height <= 0 || header.nodeCount < 0 || header.edgeCount < 0 || header.neighbors >= HUMSearchNeighborsCount) {
+		return NULL;
+	}
+
+	uint64_t walkableSize = 0;
+	if (HUMSubgoalGraphDataSize(header.width, header.height, header.nodeCount, header.edgeCount, &walkableSize) != size) {
+		return NULL;
+	}
+
+	HUMSubgoalGraph *graph = HUMSubgoalGraphAllocate(header.width, header.height, header.neighbors, header.cardinalCost);
+	if (!graph) {
+		// the header checks out, so only unsupported costs are left to reject besides running out of memory
+		if (header.cardinalCost > 0 && (header.neighbors == HUMSearchNeighborsCardinal || HUMSearchDiagonalCost(header.cardinalCost) > header.cardinalCost)) {
+			*status = HUMSubgoalGraphStatusOutOfMemory;
+		}
+
+		return NULL;
+	}
+
+	graph->nodeCount = header.nodeCount;
+	graph->edgeCount = header.edgeCount;
+	graph->nodeTiles = malloc(((size_t)header.nodeCount + 1) * sizeof(int32_t));
+	graph->firstEdge = malloc(((size_t)header.nodeCount + 1) * sizeof(int32_t));
+	graph->edges = malloc(((size_t)header.edgeCount + 1) * sizeof(int32_t));
+	graph->edgeCosts = malloc(((size_t)header.edgeCount + 1) * sizeof(uint32_t));
+
+	if (!graph->nodeTiles || !graph->firstEdge || !graph->edges || !graph->edgeCosts) {
+		HUMSubgoalGraphFree(graph);
+		*status = HUMSubgoalGraphStatusOutOfMemory;
+		return NULL;
+	}
+
+	const uint8_t *cursor = (const uint8_t *)bytes + sizeof(header);
+	size_t tileCount = (size_t)header.width * header.height;
+
+	for (size_t i = 0; i < tileCount; i++) {
+		graph->walkable[i] = (cursor[i / 8] >> (i % 8)) & 1;
+		graph->nodeAtTile[i] = -1;
+	}
+	cursor += walkableSize;
+
+	memcpy(graph->nodeTiles, cursor, (size_t)header.nodeCount * 4);
+	cursor += (size_t)header.nodeCount * 4;
+	memcpy(graph->firstEdge, cursor, ((size_t)header.nodeCount + 1) * 4);
+	cursor += ((size_t)header.nodeCount + 1) * 4;
+	memcpy(graph->edges, cursor, (size_t)header.edgeCount * 4);
+	cursor += (size_t)header.edgeCount * 4;
+	memcpy(graph->edgeCosts, cursor, (size_t)header.edgeCount * 4);
+
+	// every index has to be in range before the graph can be searched
+	bool valid = graph->firstEdge[0] == 0 && graph->firstEdge[header.nodeCount] == header.edgeCount;
+
+	for (int32_t i = 0; i < header.nodeCount && valid; i++) {
+		int32_t tile = graph->nodeTiles[i];
+
+		valid = tile >= 0 && (size_t)tile < tileCount && graph->walkable[tile] && graph->nodeAtTile[tile] == -1 && graph->firstEdge[i] <= graph->firstEdge[i + 1];
+
+		if (valid) {
+			graph->nodeAtTile[tile] = i;
+		}
+	}
+
+	for (int32_t e = 0; e < header.edgeCount && valid; e++) {
+		valid = graph->edges[e] >= 0 && graph->edges[e] < header.nodeCount;
+	}
+
+	if (!valid) {
+		HUMSubgoalGraphFree(graph);
+		return NULL;
+	}
+
+	*status = HUMSubgoalGraphStatusOK;
+
+	return graph;
+}
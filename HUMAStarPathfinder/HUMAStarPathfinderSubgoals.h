@@ -0,0 +1,111 @@
+//
+//  HUMAStarPathfinderSubgoals.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderSubgoals_h
+#define HUMAStarPathfinder_HUMAStarPathfinderSubgoals_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "HUMAStarPathfinderSearch.h"
+
+/**
+ *	A simple subgoal graph of a grid where every tile costs the same. Subgoals are the walkable tiles a shortest path may have to turn at,
+ *  next to the corners of unwalkable tiles. Two tiles are h-reachable if a path between them costs exactly the heuristic distance, meaning it
+ *  only ever moves toward the other tile, and every pair of subgoals that is h-reachable without passing through a third subgoal is joined by
+ *  an edge. A shortest path between any two tiles can be split into such steps, so searching the graph finds a shortest path while expanding
+ *  a few subgoals instead of every tile on the way.
+ *
+ *	The graph is built for one neighbor policy. Diagonal moves follow the same corner rules as HUMSearchFindPath.
+ */
+typedef struct {
+	int32_t width;
+	int32_t height;
+	HUMSearchNeighbors neighbors;
+	uint32_t cardinalCost;
+	uint32_t diagonalCost;		// HUMSearchDiagonalCost(cardinalCost)
+
+	uint8_t *walkable;			// width * height flags, row-major. The graph's own copy.
+	int32_t *nodeAtTile;		// width * height, the subgoal at each tile, or -1
+
+	int32_t nodeCount;
+	int32_t *nodeTiles;			// the tile index (y * width + x) of each subgoal
+
+	int32_t *firstEdge;			// nodeCount + 1 offsets into edges: the edges of node i are firstEdge[i] to firstEdge[i + 1] - 1
+	int32_t *edges;				// the node at the other end of each edge
+	uint32_t *edgeCosts;
+	int32_t edgeCount;
+} HUMSubgoalGraph;
+
+/**
+ *	A path found by HUMSubgoalGraphFindPath. Free it with HUMSubgoalPathFree.
+ */
+typedef struct {
+	int32_t *xs;				// every tile of the path, from the start tile to the target tile, both included
+	int32_t *ys;
+	int32_t count;
+	uint32_t cost;
+	int32_t nodesExpanded;		// subgoals taken off the open list, counting the start and target
+} HUMSubgoalPath;
+
+#define HUMSubgoalGraphMagic 0x53475548		// "HUGS"
+#define HUMSubgoalGraphVersion 1
+
+/**
+ *	The result of reading a serialized graph.
+ */
+typedef enum {
+	HUMSubgoalGraphStatusOK = 0,
+	HUMSubgoalGraphStatusInvalid,				// not a subgoal graph, truncated, or inconsistent
+	HUMSubgoalGraphStatusUnsupportedVersion,
+	HUMSubgoalGraphStatusOutOfMemory
+} HUMSubgoalGraphStatus;
+
+/**
+ *	Builds the subgoal graph of a grid. Each subgoal is connected by exploring the tiles it can reach by only moving toward them, which stops at
+ *  unwalkable tiles and other subgoals, so building takes time proportional to the number of subgoals times the open area around each.
+ *
+ *	@param	walkable		width * height flags, row-major.
+ *	@param	neighbors		The movement rules of the paths.
+ *	@param	cardinalCost	The cost of every cardinal move. Diagonal moves cost HUMSearchDiagonalCost(cardinalCost), which has to be more than
+ *							cardinalCost, so at least 3, for a diagonal policy.
+ *
+ *	@return	The graph, or NULL if it couldn't be allocated or the costs aren't supported.
+ */
+HUMSubgoalGraph *HUMSubgoalGraphCreate(int32_t width, int32_t height, const uint8_t *walkable, HUMSearchNeighbors neighbors, uint32_t cardinalCost);
+void HUMSubgoalGraphFree(HUMSubgoalGraph *graph);
+
+/**
+ *	Finds a shortest path between two walkable tiles. The start and target are connected to the subgoals they can h-reach, the graph is
+ *  searched with A*, and the subgoals of the result are joined by h-reachable runs of tiles. Each run is walked directly when its diagonal
+ *  or straight moves can all be made first, which is almost always, so expanding the path takes time linear in its length. The graph isn't
+ *  changed, so it can be searched from any number of threads at once.
+ *
+ *	@param	path	Filled with the path if one is found. Must be freed with HUMSubgoalPathFree, whatever the result.
+ *
+ *	@return	true if a path was found.
+ */
+bool HUMSubgoalGraphFindPath(const HUMSubgoalGraph *graph, int32_t startX, int32_t startY, int32_t targetX, int32_t targetY, HUMSubgoalPath *path);
+void HUMSubgoalPathFree(HUMSubgoalPath *path);
+
+/**
+ *	Serializes a graph, including the walkability it was built from. The data starts with a header holding HUMSubgoalGraphMagic and
+ *  HUMSubgoalGraphVersion, and all values are little-endian.
+ *
+ *	@return	A malloc'd buffer the caller frees, or NULL if it couldn't be allocated.
+ */
+void *HUMSubgoalGraphCopyData(const HUMSubgoalGraph *graph, size_t *size);
+
+/**
+ *	Reads a graph serialized by HUMSubgoalGraphCopyData, checking that every count and index in it is consistent.
+ *
+ *	@return	The graph, or NULL with the reason in status.
+ */
+HUMSubgoalGraph *HUMSubgoalGraphCreateWithData(const void *bytes, size_t size, HUMSubgoalGraphStatus *status);
+
+#endif
@@ -0,0 +1,672 @@
+//
+//  HUMAStarPathfinderSwamps.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderSwamps.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// a region, its doors, and the margin around them
+#define HUMSwampWindowSide (HUMSwampMaximumExtent + 2 + 2 * HUMSwampWindowMargin)
+#define HUMSwampWindowCapacity (HUMSwampWindowSide * HUMSwampWindowSide)
+
+static const int32_t HUMSwampDirectionX[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+static const int32_t HUMSwampDirectionY[8] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+
+/**
+ *	A region a growth stopped at with few enough doors to be a swamp. The region is the first tileCount tiles grown, and its doors are the
+ *  next layer of tiles grown, followed by the first blockedCount tiles that couldn't be grown into.
+ */
+typedef struct {
+	int32_t tileCount;
+	int32_t layerCount;
+	int32_t blockedCount;
+	HUMSearchTileRect bounds;
+} HUMSwampCandidate;
+
+typedef struct {
+	uint32_t distance;
+	int32_t tile;
+} HUMSwampHeapEntry;
+
+enum {
+	HUMSwampKindOther = 0,
+	HUMSwampKindRegion,
+	HUMSwampKindDoor
+};
+
+struct HUMSwampScratch {
+	int32_t *visits;		// width * height, the growth that last saw each tile
+	int32_t visit;
+	uint8_t *tried;			// width * height flags of tiles grown into by a growth that found no swamp
+
+	int32_t *tiles;			// the tiles grown, in layers, followed by the layer being grown
+	int32_t *blocked;		// walkable tiles next to the region that can't be part of a swamp
+	int32_t grownCount;		// the tiles grown into the region before the growth stopped
+	HUMSwampCandidate *candidates;
+	int32_t candidateCount;
+
+	uint8_t kinds[HUMSwampWindowCapacity];
+	uint32_t through[HUMSwampWindowCapacity];
+	uint32_t around[HUMSwampWindowCapacity];
+	HUMSwampHeapEntry heap[HUMSwampWindowCapacity * 8];
+};
+
+#pragma mark - Tiles
+static inline bool HUMSwampMapIsWalkable(const HUMSwampMap *map, int32_t x, int32_t y) {
+	return x >= 0 && y >= 0 && x < map->width && y < map->height && map->walkable[y * map->width + x];
+}
+
+static inline int32_t HUMSwampMapDirectionCount(const HUMSwampMap *map) {
+	return map->neighbors == HUMSearchNeighborsCardinal ? 4 : 8;
+}
+
+/**
+ *	Determines if a move onto a neighboring tile is allowed by the map's movement rules, the same way HUMSearchFindPath does.
+ */
+static bool HUMSwampMapCanMove(const HUMSwampMap *map, int32_t x, int32_t y, int32_t directionX, int32_t directionY) {
+	if (!HUMSwampMapIsWalkable(map, x + directionX, y + directionY)) {
+		return false;
+	}
+
+	if (directionX == 0 || directionY == 0) {
+		return true;
+	}
+
+	bool horizontalOpen = HUMSwampMapIsWalkable(map, x + directionX, y);
+	bool verticalOpen = HUMSwampMapIsWalkable(map, x, y + directionY);
+
+	switch (map->neighbors) {
+		case HUMSearchNeighborsCardinal:
+			return false;
+
+		case HUMSearchNeighborsDiagonalCrossBorders:
+			return horizontalOpen || verticalOpen;
+
+		case HUMSearchNeighborsDiagonalStrict:
+			return horizontalOpen && verticalOpen;
+
+		default:
+			return true;
+	}
+}
+
+/**
+ *	Determines if a tile can become part of a new swamp: it has to be walkable, and neither it nor any tile around it can be in a swamp already.
+ */
+static bool HUMSwampMapIsEligible(const HUMSwampMap *map, int32_t x, int32_t y) {
+	if (!HUMSwampMapIsWalkable(map, x, y)) {
+		return false;
+	}
+
+	for (int32_t aroundY = y - 1; aroundY <= y + 1; aroundY++) {
+		for (int32_t aroundX = x - 1; aroundX <= x + 1; aroundX++) {
+			if (aroundX >= 0 && aroundY >= 0 && aroundX < map->width && aroundY < map->height && map->swampAtTile[aroundY * map->width + aroundX] >= 0) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ *	The number of walkable tiles a tile could step onto. Regions are only grown from tiles with few, in corners, corridors, and the ends of
+ *  corridors, where pockets and dead ends start.
+ */
+static int32_t HUMSwampMapOpenNeighborCount(const HUMSwampMap *map, int32_t x, int32_t y) {
+	int32_t open = 0;
+
+	for (int32_t direction = 0; direction < HUMSwampMapDirectionCount(map); direction++) {
+		open += HUMSwampMapIsWalkable(map, x + HUMSwampDirectionX[direction], y + HUMSwampDirectionY[direction]);
+	}
+
+	return open;
+}
+
+static inline void HUMSwampSetBit(uint8_t *bits, int32_t index, bool set) {
+	if (set) {
+		bits[index >> 3] |= (uint8_t)(1 << (index & 7));
+	}
+	else {
+		bits[index >> 3] &= (uint8_t)~(1 << (index & 7));
+	}
+}
+
+static HUMSearchTileRect HUMSwampRectUnion(HUMSearchTileRect rect, int32_t x, int32_t y) {
+	if (rect.width == 0) {
+		return (HUMSearchTileRect){ x, y, 1, 1 };
+	}
+
+	int32_t maxX = rect.x + rect.width > x + 1 ? rect.x + rect.width : x + 1;
+	int32_t maxY = rect.y + rect.height > y + 1 ? rect.y + rect.height : y + 1;
+	rect.x = rect.x < x ? rect.x : x;
+	rect.y = rect.y < y ? rect.y : y;
+	rect.width = maxX - rect.x;
+	rect.height = maxY - rect.y;
+
+	return rect;
+}
+
+/**
+ *	Grows a rect on every side and clips it to the map.
+ */
+static HUMSearchTileRect HUMSwampMapExpandRect(const HUMSwampMap *map, HUMSearchTileRect rect, int32_t margin) {
+	int32_t minX = rect.x - margin > 0 ? rect.x - margin : 0;
+	int32_t minY = rect.y - margin > 0 ? rect.y - margin : 0;
+	int32_t maxX = rect.x + rect.width + margin < map->width ? rect.x + rect.width + margin : map->width;
+	int32_t maxY = rect.y + rect.height + margin < map->height ? rect.y + rect.height + margin : map->height;
+
+	return (HUMSearchTileRect){ minX, minY, maxX - minX, maxY - minY };
+}
+
+static bool HUMSwampRectsIntersect(HUMSearchTileRect a, HUMSearchTileRect b) {
+	return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+#pragma mark - Checking
+static void HUMSwampHeapPush(HUMSwampHeapEntry *heap, int32_t *count, uint32_t distance, int32_t tile) {
+	int32_t index = (*count)++;
+
+	while (index > 0) {
+		int32_t parent = (index - 1) >> 1;
+		if (heap[parent].distance <= distance) {
+			break;
+		}
+
+		heap[index] = heap[parent];
+		index = parent;
+	}
+
+	heap[index].distance = distance;
+	heap[index].tile = tile;
+}
+
+static HUMSwampHeapEntry HUMSwampHeapPop(HUMSwampHeapEntry *heap, int32_t *count) {
+	HUMSwampHeapEntry top = heap[0];
+	HUMSwampHeapEntry last = heap[--(*count)];
+	int32_t index = 0;
+
+	while (1) {
+		int32_t child = (index << 1) + 1;
+		if (child >= *count) {
+			break;
+		}
+
+		if (child + 1 < *count && heap[child + 1].distance < heap[child].distance) {
+			child++;
+		}
+
+		if (last.distance <= heap[child].distance) {
+			break;
+		}
+
+		heap[index] = heap[child];
+		index = child;
+	}
+
+	if (*count > 0) {
+		heap[index] = last;
+	}
+
+	return top;
+}
+
+/**
+ *	Runs Dijkstra's algorithm from a door over the tiles of the window, where every move costs the map's cost. Going through, the first move
+ *  has to enter the region, and the search only continues through the region, so every other door is reached by the cheapest path through
+ *  the region. Going around, the region and every swamp found before it are avoided.
+ */
+static void HUMSwampMapMeasure(const HUMSwampMap *map, HUMSwampScratch *scratch, HUMSearchTileRect window, int32_t door, bool through, uint32_t *distances) {
+	const uint32_t cardinalCost = map->cost;
+	const uint32_t diagonalCost = HUMSearchDiagonalCost(map->cost);
+	const int32_t directionCount = HUMSwampMapDirectionCount(map);
+	const int32_t tileCount = window.width * window.height;
+
+	for (int32_t i = 0; i < tileCount; i++) {
+		distances[i] = UINT32_MAX;
+	}
+
+	int32_t heapCount = 0;
+	distances[door] = 0;
+	HUMSwampHeapPush(scratch->heap, &heapCount, 0, door);
+
+	while (heapCount > 0) {
+		HUMSwampHeapEntry entry = HUMSwampHeapPop(scratch->heap, &heapCount);
+		int32_t tile = entry.tile;
+
+		if (entry.distance > distances[tile]) {
+			continue;
+		}
+
+		// a path through the region ends at the first door it reaches
+		if (through && tile != door && scratch->kinds[tile] == HUMSwampKindDoor) {
+			continue;
+		}
+
+		int32_t localX = tile % window.width;
+		int32_t localY = tile / window.width;
+
+		for (int32_t direction = 0; direction < directionCount; direction++) {
+			int32_t neighborX = localX + HUMSwampDirectionX[direction];
+			int32_t neighborY = localY + HUMSwampDirectionY[direction];
+
+			if (neighborX < 0 || neighborY < 0 || neighborX >= window.width || neighborY >= window.height) {
+				continue;
+			}
+
+			int32_t neighbor = neighborY * window.width + neighborX;
+			uint8_t kind = scratch->kinds[neighbor];
+
+			if (through) {
+				if (kind == HUMSwampKindOther || (tile == door && kind != HUMSwampKindRegion)) {
+					continue;
+				}
+			}
+			else if (kind == HUMSwampKindRegion || map->swampAtTile[(window.y + neighborY) * map->width + window.x + neighborX] >= 0) {
+				continue;
+			}
+
+			if (!HUMSwampMapCanMove(map, window.x + localX, window.y + localY, HUMSwampDirectionX[direction], HUMSwampDirectionY[direction])) {
+				continue;
+			}
+
+			uint32_t distance = entry.distance + (direction < 4 ? cardinalCost : diagonalCost);
+			if (distance < distances[neighbor]) {
+				distances[neighbor] = distance;
+				HUMSwampHeapPush(scratch->heap, &heapCount, distance, neighbor);
+			}
+		}
+	}
+}
+
+static inline int32_t HUMSwampCandidateDoorCount(const HUMSwampCandidate *candidate) {
+	return candidate->layerCount + candidate->blockedCount;
+}
+
+static inline int32_t HUMSwampCandidateDoor(const HUMSwampScratch *scratch, const HUMSwampCandidate *candidate, int32_t i) {
+	return i < candidate->layerCount ? scratch->tiles[candidate->tileCount + i] : scratch->blocked[i - candidate->layerCount];
+}
+
+/**
+ *	The rect around a region and its doors that paths around the region are looked for in.
+ */
+static HUMSearchTileRect HUMSwampMapCandidateWindow(const HUMSwampMap *map, const HUMSwampScratch *scratch, const HUMSwampCandidate *candidate) {
+	HUMSearchTileRect bounds = candidate->bounds;
+
+	for (int32_t i = 0; i < HUMSwampCandidateDoorCount(candidate); i++) {
+		int32_t door = HUMSwampCandidateDoor(scratch, candidate, i);
+		bounds = HUMSwampRectUnion(bounds, door % map->width, door / map->width);
+	}
+
+	return HUMSwampMapExpandRect(map, bounds, HUMSwampWindowMargin);
+}
+
+/**
+ *	Determines if a region with more than one door is a swamp: for every two of its doors, the cheapest path between them that goes around the
+ *  region, inside the window, must cost no more than the cheapest one through it.
+ */
+static bool HUMSwampMapCheckCandidate(const HUMSwampMap *map, HUMSwampScratch *scratch, const HUMSwampCandidate *candidate, HUMSearchTileRect window) {
+	memset(scratch->kinds, HUMSwampKindOther, (size_t)(window.width * window.height));
+
+	for (int32_t i = 0; i < candidate->tileCount; i++) {
+		int32_t tile = scratch->tiles[i];
+		scratch->kinds[(tile / map->width - window.y) * window.width + tile % map->width - window.x] = HUMSwampKindRegion;
+	}
+
+	int32_t doorCount = HUMSwampCandidateDoorCount(candidate);
+	int32_t doors[HUMSwampMaximumDoors];
+
+	for (int32_t i = 0; i < doorCount; i++) {
+		int32_t tile = HUMSwampCandidateDoor(scratch, candidate, i);
+		doors[i] = (tile / map->width - window.y) * window.width + tile % map->width - window.x;
+		scratch->kinds[doors[i]] = HUMSwampKindDoor;
+	}
+
+	// moves cost the same both ways, so each pair of doors only has to be measured from one end
+	for (int32_t i = 0; i < doorCount - 1; i++) {
+		HUMSwampMapMeasure(map, scratch, window, doors[i], true, scratch->through);
+		HUMSwampMapMeasure(map, scratch, window, doors[i], false, scratch->around);
+
+		for (int32_t j = i + 1; j < doorCount; j++) {
+			if (scratch->through[doors[j]] != UINT32_MAX && scratch->around[doors[j]] > scratch->through[doors[j]]) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+#pragma mark - Growing
+/**
+ *	Grows a region from a tile one layer at a time, as long as it stays within the size limits, and records every layer the region's doors
+ *  could be few enough for it to be a swamp.
+ */
+static void HUMSwampMapGrow(const HUMSwampMap *map, HUMSwampScratch *scratch, int32_t seed) {
+	const int32_t width = map->width;
+	const int32_t directionCount = HUMSwampMapDirectionCount(map);
+	const int32_t visit = ++scratch->visit;
+
+	int32_t tileCount = 1;
+	int32_t layerStart = 0;
+	int32_t blockedCount = 0;
+	HUMSearchTileRect bounds = { seed % width, seed / width, 1, 1 };
+
+	scratch->tiles[0] = seed;
+	scratch->visits[seed] = visit;
+	scratch->candidateCount = 0;
+
+	while (1) {
+		int32_t count = tileCount;
+
+		for (int32_t i = layerStart; i < tileCount; i++) {
+			int32_t x = scratch->tiles[i] % width;
+			int32_t y = scratch->tiles[i] / width;
+
+			for (int32_t direction = 0; direction < directionCount; direction++) {
+				int32_t neighborX = x + HUMSwampDirectionX[direction];
+				int32_t neighborY = y + HUMSwampDirectionY[direction];
+				int32_t neighbor = neighborY * width + neighborX;
+
+				if (!HUMSwampMapIsWalkable(map, neighborX, neighborY) || scratch->visits[neighbor] == visit) {
+					continue;
+				}
+
+				scratch->visits[neighbor] = visit;
+
+				if (HUMSwampMapIsEligible(map, neighborX, neighborY)) {
+					scratch->tiles[count++] = neighbor;
+				}
+				else {
+					scratch->blocked[blockedCount++] = neighbor;
+				}
+			}
+		}
+
+		int32_t layerCount = count - tileCount;
+
+		if (layerCount + blockedCount <= HUMSwampMaximumDoors) {
+			HUMSwampCandidate *candidate = &scratch->candidates[scratch->candidateCount++];
+			candidate->tileCount = tileCount;
+			candidate->layerCount = layerCount;
+			candidate->blockedCount = blockedCount;
+			candidate->bounds = bounds;
+		}
+
+		if (layerCount == 0 || count > HUMSwampMaximumTiles) {
+			break;
+		}
+
+		HUMSearchTileRect grownBounds = bounds;
+		for (int32_t i = tileCount; i < count; i++) {
+			grownBounds = HUMSwampRectUnion(grownBounds, scratch->tiles[i] % width, scratch->tiles[i] / width);
+		}
+
+		if (grownBounds.width > HUMSwampMaximumExtent || grownBounds.height > HUMSwampMaximumExtent) {
+			break;
+		}
+
+		bounds = grownBounds;
+		layerStart = tileCount;
+		tileCount = count;
+	}
+
+	scratch->grownCount = tileCount;
+}
+
+static bool HUMSwampMapAddSwamp(HUMSwampMap *map, const HUMSwampScratch *scratch, const HUMSwampCandidate *candidate, HUMSearchTileRect window) {
+	if (map->swampCount == map->swampCapacity) {
+		int32_t capacity = map->swampCapacity ? map->swampCapacity * 2 : 64;
+		HUMSwamp *swamps = realloc(map->swamps, (size_t)capacity * sizeof(HUMSwamp));
+
+		if (!swamps) {
+			return false;
+		}
+
+		map->swamps = swamps;
+		map->swampCapacity = capacity;
+	}
+
+	int32_t index = map->swampCount++;
+	HUMSwamp *swamp = &map->swamps[index];
+	swamp->bounds = candidate->bounds;
+	swamp->window = window;
+	swamp->doorCount = HUMSwampCandidateDoorCount(candidate);
+	swamp->removed = false;
+
+	for (int32_t i = 0; i < candidate->tileCount; i++) {
+		int32_t tile = scratch->tiles[i];
+		map->swampAtTile[tile] = index;
+		HUMSwampSetBit(map->swampTiles, tile, true);
+		HUMSwampSetBit(map->deadEndTiles, tile, swamp->doorCount <= 1);
+	}
+
+	return true;
+}
+
+/**
+ *	Grows a region from a seed and makes the largest region that passes the check into a swamp. A region with at most one door always passes.
+ *  Only the largest few regions with more doors are checked, and when none of them pass, none of the tiles grown are used as seeds again.
+ */
+static bool HUMSwampMapGrowSwamp(HUMSwampMap *map, int32_t seed) {
+	HUMSwampScratch *scratch = map->scratch;
+	HUMSwampMapGrow(map, scratch, seed);
+
+	int32_t checkCount = 0;
+
+	for (int32_t i = scratch->candidateCount - 1; i >= 0; i--) {
+		const HUMSwampCandidate *candidate = &scratch->candidates[i];
+		HUMSearchTileRect window = HUMSwampMapCandidateWindow(map, scratch, candidate);
+		bool accepted = HUMSwampCandidateDoorCount(candidate) <= 1;
+
+		if (!accepted && checkCount < HUMSwampCheckLimit) {
+			checkCount++;
+			accepted = HUMSwampMapCheckCandidate(map, scratch, candidate, window);
+		}
+
+		if (accepted) {
+			return HUMSwampMapAddSwamp(map, scratch, candidate, window);
+		}
+	}
+
+	for (int32_t i = 0; i < scratch->grownCount; i++) {
+		scratch->tried[scratch->tiles[i]] = 1;
+	}
+
+	return true;
+}
+
+/**
+ *	Grows a region from every eligible seed in a rect. The ends of corridors go first, so the dead ends they lead into are found whole before
+ *  regions grown from other seeds run into them.
+ */
+static bool HUMSwampMapFindSwamps(HUMSwampMap *map, HUMSearchTileRect rect) {
+	HUMSwampScratch *scratch = map->scratch;
+
+	for (int32_t y = rect.y; y < rect.y + rect.height; y++) {
+		memset(scratch->tried + y * map->width + rect.x, 0, (size_t)rect.width);
+	}
+
+	for (int32_t pass = 0; pass < 2; pass++) {
+		int32_t maximumOpen = pass == 0 ? 1 : 3;
+
+		for (int32_t y = rect.y; y < rect.y + rect.height; y++) {
+			for (int32_t x = rect.x; x < rect.x + rect.width; x++) {
+				int32_t seed = y * map->width + x;
+
+				if (scratch->tried[seed] || !HUMSwampMapIsEligible(map, x, y) || HUMSwampMapOpenNeighborCount(map, x, y) > maximumOpen) {
+					continue;
+				}
+
+				if (!HUMSwampMapGrowSwamp(map, seed)) {
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+#pragma mark - Maps
+HUMSwampMap *HUMSwampMapCreate(int32_t width, int32_t height, const uint8_t *walkable, HUMSearchNeighbors neighbors, uint32_t cost) {
+	HUMSwampMap *map = calloc(1, sizeof(HUMSwampMap));
+	if (!map) {
+		return NULL;
+	}
+
+	size_t tileCount = (size_t)width * (size_t)height;
+	size_t bitCount = (tileCount + 7) / 8;
+
+	map->width = width;
+	map->height = height;
+	map->neighbors = neighbors;
+	map->cost = cost;
+	map->walkable = malloc(tileCount);
+	map->swampAtTile = malloc(tileCount * sizeof(int32_t));
+	map->swampTiles = calloc(bitCount ? bitCount : 1, 1);
+	map->deadEndTiles = calloc(bitCount ? bitCount : 1, 1);
+	map->scratch = calloc(1, sizeof(HUMSwampScratch));
+
+	if (!map->walkable || !map->swampAtTile || !map->swampTiles || !map->deadEndTiles || !map->scratch) {
+		HUMSwampMapFree(map);
+		return NULL;
+	}
+
+	HUMSwampScratch *scratch = map->scratch;
+	scratch->visits = calloc(tileCount ? tileCount : 1, sizeof(int32_t));
+	scratch->tried = calloc(tileCount ? tileCount : 1, 1);
+	scratch->tiles = malloc(HUMSwampMaximumTiles * 9 * sizeof(int32_t));
+	scratch->blocked = malloc(HUMSwampMaximumTiles * 8 * sizeof(int32_t));
+	scratch->candidates = malloc((HUMSwampMaximumTiles + 1) * sizeof(HUMSwampCandidate));
+
+	if (!scratch->visits || !scratch->tried || !scratch->tiles || !scratch->blocked || !scratch->candidates) {
+		HUMSwampMapFree(map);
+		return NULL;
+	}
+
+	memcpy(map->walkable, walkable, tileCount);
+	memset(map->swampAtTile, 0xff, tileCount * sizeof(int32_t));
+
+	if (!HUMSwampMapFindSwamps(map, (HUMSearchTileRect){ 0, 0, width, height })) {
+		HUMSwampMapFree(map);
+		return NULL;
+	}
+
+	return map;
+}
+
+void HUMSwampMapFree(HUMSwampMap *map) {
+	if (!map) {
+		return;
+	}
+
+	if (map->scratch) {
+		free(map->scratch->visits);
+		free(map->scratch->tried);
+		free(map->scratch->tiles);
+		free(map->scratch->blocked);
+		free(map->scratch->candidates);
+		free(map->scratch);
+	}
+
+	free(map->walkable);
+	free(map->swampAtTile);
+	free(map->swampTiles);
+	free(map->deadEndTiles);
+	free(map->swamps);
+	free(map);
+}
+
+static void HUMSwampMapRemoveSwamp(HUMSwampMap *map, int32_t index) {
+	HUMSwamp *swamp = &map->swamps[index];
+
+	for (int32_t y = swamp->bounds.y; y < swamp->bounds.y + swamp->bounds.height; y++) {
+		for (int32_t x = swamp->bounds.x; x < swamp->bounds.x + swamp->bounds.width; x++) {
+			int32_t tile = y * map->width + x;
+
+			if (map->swampAtTile[tile] == index) {
+				map->swampAtTile[tile] = -1;
+				HUMSwampSetBit(map->swampTiles, tile, false);
+				HUMSwampSetBit(map->deadEndTiles, tile, false);
+			}
+		}
+	}
+
+	swamp->removed = true;
+	map->removedCount++;
+}
+
+/**
+ *	Drops removed swamps from the list, keeping the rest in the order they were found.
+ */
+static void HUMSwampMapCompact(HUMSwampMap *map) {
+	int32_t *indexes = malloc((size_t)map->swampCount * sizeof(int32_t));
+	if (!indexes) {
+		return;
+	}
+
+	int32_t count = 0;
+	for (int32_t i = 0; i < map->swampCount; i++) {
+		indexes[i] = map->swamps[i].removed ? -1 : count;
+
+		if (!map->swamps[i].removed) {
+			map->swamps[count++] = map->swamps[i];
+		}
+	}
+
+	size_t tileCount = (size_t)map->width * (size_t)map->height;
+	for (size_t tile = 0; tile < tileCount; tile++) {
+		if (map->swampAtTile[tile] >= 0) {
+			map->swampAtTile[tile] = indexes[map->swampAtTile[tile]];
+		}
+	}
+
+	free(indexes);
+	map->swampCount = count;
+	map->removedCount = 0;
+}
+
+bool HUMSwampMapUpdate(HUMSwampMap *map, int32_t x, int32_t y, int32_t width, int32_t height, const uint8_t *walkable) {
+	for (int32_t row = 0; row < height; row++) {
+		memcpy(map->walkable + (y + row) * map->width + x, walkable + row * width, (size_t)width);
+	}
+
+	// a swamp only depends on the walkability of the tiles in its window
+	HUMSearchTileRect changed = { x, y, width, height };
+	HUMSearchTileRect affected = changed;
+
+	for (int32_t i = 0; i < map->swampCount; i++) {
+		HUMSwamp *swamp = &map->swamps[i];
+
+		if (!swamp->removed && HUMSwampRectsIntersect(swamp->window, changed)) {
+			affected = HUMSwampRectUnion(HUMSwampRectUnion(affected, swamp->bounds.x, swamp->bounds.y), swamp->bounds.x + swamp->bounds.width - 1, swamp->bounds.y + swamp->bounds.height - 1);
+			HUMSwampMapRemoveSwamp(map, i);
+		}
+	}
+
+	if (map->removedCount > 64 && map->removedCount > map->swampCount / 2) {
+		HUMSwampMapCompact(map);
+	}
+
+	// any region whose window reaches the changed tiles or the removed swamps could be a swamp now
+	return HUMSwampMapFindSwamps(map, HUMSwampMapExpandRect(map, affected, HUMSwampMaximumExtent + 2 + HUMSwampWindowMargin));
+}
+
+bool HUMSwampMapGetSwampBounds(const HUMSwampMap *map, int32_t x, int32_t y, HUMSearchTileRect *bounds) {
+	int32_t index = map->swampAtTile[y * map->width + x];
+
+	if (index < 0) {
+		*bounds = (HUMSearchTileRect){ 0, 0, 0, 0 };
+		return false;
+	}
+
+	*bounds = map->swamps[index].bounds;
+	return true;
+}
@@ -0,0 +1,110 @@
+//
+//  HUMAStarPathfinderSwamps.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderSwamps_h
+#define HUMAStarPathfinder_HUMAStarPathfinderSwamps_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "HUMAStarPathfinderSearch.h"
+
+/**
+ *	The most tiles outside a swamp that can be stepped onto from it, its doors.
+ */
+#define HUMSwampMaximumDoors 4
+
+/**
+ *	The most tiles a swamp can have, and the most tiles it can span in either direction.
+ */
+#define HUMSwampMaximumTiles 256
+#define HUMSwampMaximumExtent 32
+
+/**
+ *	How far past a swamp and its doors a path between two doors is looked for around the swamp.
+ */
+#define HUMSwampWindowMargin 8
+
+/**
+ *	The most regions with more than one door checked for each tile a region is grown from.
+ */
+#define HUMSwampCheckLimit 4
+
+typedef struct {
+	HUMSearchTileRect bounds;	// the smallest rect holding every tile of the swamp
+	HUMSearchTileRect window;	// the tiles whose walkability the swamp was checked against
+	int32_t doorCount;
+	bool removed;
+} HUMSwamp;
+
+typedef struct HUMSwampScratch HUMSwampScratch;
+
+/**
+ *	The swamps of a grid: small regions of walkable tiles, like dead-end rooms and the pockets along corridors, that a cheapest path never has
+ *  to enter unless it starts or ends inside one. A search can skip every swamp except the ones holding its start and target tiles and still
+ *  find a path of the same cost, while never wandering into them.
+ *
+ *	A region is a swamp if it has at most one door, so any path that enters it has to leave the way it came in, or if between every two of
+ *  its doors there is a path around it that costs no more than the cheapest one through it. The second kind only holds when every tile costs
+ *  the cost the map was built with and units are a single tile, while a swamp with a single door holds for any costs and any unit size.
+ *
+ *	No two swamps touch, and each one was checked against paths that avoid every swamp found before it, so skipping any of them never makes
+ *  a path more expensive.
+ */
+typedef struct {
+	int32_t width;
+	int32_t height;
+	HUMSearchNeighbors neighbors;
+	uint32_t cost;				// the entry cost of every tile the paths around swamps were measured with
+
+	uint8_t *walkable;			// width * height flags, row-major. The map's own copy.
+	int32_t *swampAtTile;		// width * height, the index of the swamp holding each tile, or -1
+
+	uint8_t *swampTiles;		// width * height bits of the tiles in any swamp, as read by HUMSearchQuery's prunedTiles
+	uint8_t *deadEndTiles;		// width * height bits of the tiles in swamps with at most one door
+
+	HUMSwamp *swamps;			// in the order they were found, including removed swamps until the list is compacted
+	int32_t swampCount;
+	int32_t swampCapacity;
+	int32_t removedCount;
+
+	HUMSwampScratch *scratch;
+} HUMSwampMap;
+
+/**
+ *	Finds the swamps of a grid. Regions are grown one layer of tiles at a time from tiles in corners and corridors, and the largest region
+ *  with few enough doors that passes the check becomes a swamp.
+ *
+ *	@param	walkable	width * height flags, row-major.
+ *	@param	neighbors	The movement rules paths through the map follow.
+ *	@param	cost		The entry cost of every tile, used to compare paths around and through a region.
+ *
+ *	@return	The map, or NULL if it couldn't be allocated.
+ */
+HUMSwampMap *HUMSwampMapCreate(int32_t width, int32_t height, const uint8_t *walkable, HUMSearchNeighbors neighbors, uint32_t cost);
+void HUMSwampMapFree(HUMSwampMap *map);
+
+/**
+ *	Changes the walkability of a rect of tiles and brings the swamps up to date. Only swamps checked against a tile in the rect are removed, and
+ *  new swamps are only looked for near the rect and the removed swamps.
+ *
+ *	@param	walkable	width * height flags for the tiles in the rect, row-major.
+ *
+ *	@return	false if memory ran out, in which case the map should be discarded.
+ */
+bool HUMSwampMapUpdate(HUMSwampMap *map, int32_t x, int32_t y, int32_t width, int32_t height, const uint8_t *walkable);
+
+/**
+ *	Finds the swamp holding a tile, to be kept open for a search that starts or ends on it.
+ *
+ *	@param	bounds	Set to the bounds of the swamp, or to an empty rect if the tile isn't in one.
+ *
+ *	@return	true if the tile is in a swamp.
+ */
+bool HUMSwampMapGetSwampBounds(const HUMSwampMap *map, int32_t x, int32_t y, HUMSearchTileRect *bounds);
+
+#endif
@@ -0,0 +1,149 @@
+//
+//  HUMAStarPathfinderTileCache.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderTileCache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+HUMTileCache *HUMTileCacheCreate(int32_t width, int32_t height, bool cachesWalkability, bool cachesCosts, HUMTileCacheFillFunction fill, void *info) {
+	HUMTileCache *cache = calloc(1, sizeof(HUMTileCache));
+	if (!cache) {
+		return NULL;
+	}
+
+	size_t tileCount = (size_t)width * (size_t)height;
+
+	cache->width = width;
+	cache->height = height;
+	cache->blockColumns = (width + HUMTileCacheBlockSize - 1) / HUMTileCacheBlockSize;
+	cache->blockRows = (height + HUMTileCacheBlockSize - 1) / HUMTileCacheBlockSize;
+	cache->fill = fill;
+	cache->info = info;
+	cache->walkable = cachesWalkability ? malloc(tileCount * sizeof(uint8_t)) : NULL;
+	cache->costs = cachesCosts ? malloc(tileCount * sizeof(uint32_t)) : NULL;
+	cache->blockLoaded = calloc((size_t)cache->blockColumns * (size_t)cache->blockRows, sizeof(uint8_t));
+	pthread_mutex_init(&cache->lock, NULL);
+
+	if ((cachesWalkability && !cache->walkable) || (cachesCosts && !cache->costs) || !cache->blockLoaded) {
+		HUMTileCacheFree(cache);
+		return NULL;
+	}
+
+	return cache;
+}
+
+void HUMTileCacheFree(HUMTileCache *cache) {
+	if (!cache) {
+		return;
+	}
+
+	pthread_mutex_destroy(&cache->lock);
+	free(cache->walkable);
+	free(cache->costs);
+	free(cache->blockLoaded);
+	free(cache);
+}
+
+void HUMTileCacheLoadBlock(HUMTileCache *cache, int32_t blockIndex) {
+	pthread_mutex_lock(&cache->lock);
+
+	// another thread may have loaded the block while we were waiting on the lock
+	if (!cache->blockLoaded[blockIndex]) {
+		int32_t x = (blockIndex % cache->blockColumns) * HUMTileCacheBlockSize;
+		int32_t y = (blockIndex / cache->blockColumns) * HUMTileCacheBlockSize;
+		int32_t width = HUMTileCacheBlockSize;
+		int32_t height = HUMTileCacheBlockSize;
+
+		if (x + width > cache->width) {
+			width = cache->width - x;
+		}
+
+		if (y + height > cache->height) {
+			height = cache->height - y;
+		}
+
+		size_t offset = (size_t)y * cache->width + x;
+		cache->fill(cache->info, x, y, width, height,
+					cache->walkable ? cache->walkable + offset : NULL,
+					cache->costs ? cache->costs + offset : NULL,
+					cache->width);
+
+		__atomic_store_n(&cache->blockLoaded[blockIndex], 1, __ATOMIC_RELEASE);
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ *	Clips a tile rect to the map and converts it to an inclusive range of blocks.
+ *
+ *	@return	false if the rect doesn't intersect the map.
+ */
+static bool HUMTileCacheBlockRange(const HUMTileCache *cache, int32_t x, int32_t y, int32_t width, int32_t height, int32_t *minBlockX, int32_t *minBlockY, int32_t *maxBlockX, int32_t *maxBlockY) {
+	int32_t maxX = x + width - 1;
+	int32_t maxY = y + height - 1;
+
+	x = x < 0 ? 0 : x;
+	y = y < 0 ? 0 : y;
+	maxX = maxX >= cache->width ? cache->width - 1 : maxX;
+	maxY = maxY >= cache->height ? cache->height - 1 : maxY;
+
+	if (width <= 0 || height <= 0 || x > maxX || y > maxY) {
+		return false;
+	}
+
+	*minBlockX = x / HUMTileCacheBlockSize;
+	*minBlockY = y / HUMTileCacheBlockSize;
+	*maxBlockX = maxX / HUMTileCacheBlockSize;
+	*maxBlockY = maxY / HUMTileCacheBlockSize;
+
+	return true;
+}
+
+void HUMTileCachePrefetch(HUMTileCache *cache, int32_t x, int32_t y, int32_t width, int32_t height) {
+	int32_t minBlockX, minBlockY, maxBlockX, maxBlockY;
+
+	if (!HUMTileCacheBlockRange(cache, x, y, width, height, &minBlockX, &minBlockY, &maxBlockX, &maxBlockY)) {
+		return;
+	}
+
+	for (int32_t blockY = minBlockY; blockY <= maxBlockY; blockY++) {
+		for (int32_t blockX = minBlockX; blockX <= maxBlockX; blockX++) {
+			int32_t blockIndex = blockY * cache->blockColumns + blockX;
+
+			if (!__atomic_load_n(&cache->blockLoaded[blockIndex], __ATOMIC_ACQUIRE)) {
+				HUMTileCacheLoadBlock(cache, blockIndex);
+			}
+		}
+	}
+}
+
+void HUMTileCacheInvalidate(HUMTileCache *cache, int32_t x, int32_t y, int32_t width, int32_t height) {
+	int32_t minBlockX, minBlockY, maxBlockX, maxBlockY;
+
+	if (!HUMTileCacheBlockRange(cache, x, y, width, height, &minBlockX, &minBlockY, &maxBlockX, &maxBlockY)) {
+		return;
+	}
+
+	pthread_mutex_lock(&cache->lock);
+
+	for (int32_t blockY = minBlockY; blockY <= maxBlockY; blockY++) {
+		for (int32_t blockX = minBlockX; blockX <= maxBlockX; blockX++) {
+			__atomic_store_n(&cache->blockLoaded[blockY * cache->blockColumns + blockX], 0, __ATOMIC_RELEASE);
+		}
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+}
+
+void HUMTileCacheInvalidateAll(HUMTileCache *cache) {
+	pthread_mutex_lock(&cache->lock);
+	memset(cache->blockLoaded, 0, (size_t)cache->blockColumns * (size_t)cache->blockRows);
+	pthread_mutex_unlock(&cache->lock);
+}
@@ -0,0 +1,86 @@
+//
+//  HUMAStarPathfinderTileCache.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderTileCache_h
+#define HUMAStarPathfinder_HUMAStarPathfinderTileCache_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+/**
+ *	The width and height in tiles of the square regions the cache fetches at once.
+ */
+#define HUMTileCacheBlockSize 32
+
+/**
+ *	Called by the cache to fill a rect of tiles in a single call. Rows are written stride entries apart starting at the provided pointers.
+ *  Either walkable or costs is NULL when the cache doesn't hold that plane.
+ */
+typedef void (*HUMTileCacheFillFunction)(void *info, int32_t x, int32_t y, int32_t width, int32_t height, uint8_t *walkable, uint32_t *costs, int32_t stride);
+
+/**
+ *	A dense, row-major copy of the walkability and cost of every tile, filled lazily one block at a time. Safe to read from multiple threads.
+ */
+typedef struct {
+	int32_t width;
+	int32_t height;
+	int32_t blockColumns;
+	int32_t blockRows;
+
+	uint8_t *walkable;
+	uint32_t *costs;
+	uint8_t *blockLoaded;
+
+	HUMTileCacheFillFunction fill;
+	void *info;
+	pthread_mutex_t lock;
+} HUMTileCache;
+
+/**
+ *	Creates a cache for a map of the provided size. Pass cachesWalkability and/or cachesCosts to choose which planes are held.
+ */
+HUMTileCache *HUMTileCacheCreate(int32_t width, int32_t height, bool cachesWalkability, bool cachesCosts, HUMTileCacheFillFunction fill, void *info);
+void HUMTileCacheFree(HUMTileCache *cache);
+
+/**
+ *	Fetches every block intersecting the rect that isn't already loaded.
+ */
+void HUMTileCachePrefetch(HUMTileCache *cache, int32_t x, int32_t y, int32_t width, int32_t height);
+
+/**
+ *	Marks every block intersecting the rect as stale so it is fetched again the next time it is read.
+ */
+void HUMTileCacheInvalidate(HUMTileCache *cache, int32_t x, int32_t y, int32_t width, int32_t height);
+void HUMTileCacheInvalidateAll(HUMTileCache *cache);
+
+void HUMTileCacheLoadBlock(HUMTileCache *cache, int32_t blockIndex);
+
+static inline int32_t HUMTileCacheBlockIndex(const HUMTileCache *cache, int32_t x, int32_t y) {
+	return (y / HUMTileCacheBlockSize) * cache->blockColumns + (x / HUMTileCacheBlockSize);
+}
+
+static inline void HUMTileCacheEnsureLoaded(HUMTileCache *cache, int32_t x, int32_t y) {
+	int32_t blockIndex = HUMTileCacheBlockIndex(cache, x, y);
+
+	if (!__atomic_load_n(&cache->blockLoaded[blockIndex], __ATOMIC_ACQUIRE)) {
+		HUMTileCacheLoadBlock(cache, blockIndex);
+	}
+}
+
+static inline bool HUMTileCacheIsWalkable(HUMTileCache *cache, int32_t x, int32_t y) {
+	HUMTileCacheEnsureLoaded(cache, x, y);
+	return cache->walkable[y * cache->width + x];
+}
+
+static inline uint32_t HUMTileCacheCost(HUMTileCache *cache, int32_t x, int32_t y) {
+	HUMTileCacheEnsureLoaded(cache, x, y);
+	return cache->costs[y * cache->width + x];
+}
+
+#endif
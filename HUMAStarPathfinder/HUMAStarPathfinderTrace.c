@@ -0,0 +1,672 @@
+//
+//  HUMAStarPathfinderTrace.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderTrace.h"
+#include "HUMAStarPathfinderNavigationFile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ *	The largest record a reader accepts, which is far larger than any map a search context can be created for.
+ */
+#define HUMTraceMaximumRecordLength (1ull << 34)
+
+typedef struct {
+	uint8_t *bytes;
+	size_t count;
+	size_t capacity;
+	bool failed;
+} HUMTraceBuffer;
+
+typedef struct {
+	const uint8_t *bytes;
+	size_t count;
+	size_t offset;
+	bool failed;
+} HUMTraceCursor;
+
+typedef struct {
+	uint64_t hash;
+	int32_t width;
+	int32_t height;
+	uint8_t *walkable;
+	uint32_t *costs;
+} HUMTraceSnapshot;
+
+struct HUMTraceWriter {
+	FILE *file;
+	bool failed;
+
+	HUMTraceBuffer payload;
+	HUMTraceBuffer tiles;
+
+	uint64_t *hashes;			// the hashes of every snapshot written so far
+	int32_t hashCount;
+	int32_t hashCapacity;
+
+	HUMTraceSettings settings;
+	bool wroteSettings;
+};
+
+struct HUMTraceReader {
+	FILE *file;
+	HUMTraceBuffer payload;
+
+	HUMTraceSnapshot *snapshots;
+	int32_t snapshotCount;
+	int32_t snapshotCapacity;
+
+	uint8_t *editWalkable;
+	uint32_t *editCosts;
+	size_t editCapacity;
+};
+
+#pragma mark - Buffers
+static bool HUMTraceBufferReserve(HUMTraceBuffer *buffer, size_t count) {
+	if (buffer->count + count <= buffer->capacity) {
+		return true;
+	}
+
+	size_t capacity = buffer->capacity ? buffer->capacity : 256;
+	while (capacity < buffer->count + count) {
+		capacity *= 2;
+	}
+
+	uint8_t *bytes = realloc(buffer->bytes, capacity);
+	if (!bytes) {
+		buffer->failed = true;
+		return false;
+	}
+
+	buffer->bytes = bytes;
+	buffer->capacity = capacity;
+	return true;
+}
+
+static void HUMTraceBufferAppend(HUMTraceBuffer *buffer, const void *bytes, size_t count) {
+	if (HUMTraceBufferReserve(buffer, count)) {
+		memcpy(buffer->bytes + buffer->count, bytes, count);
+		buffer->count += count;
+	}
+}
+
+static void HUMTraceBufferAppendVarint(HUMTraceBuffer *buffer, uint64_t value) {
+	uint8_t bytes[10];
+	size_t count = 0;
+
+	do {
+		bytes[count] = (uint8_t)(value & 0x7f);
+		value >>= 7;
+
+		if (value) {
+			bytes[count] |= 0x80;
+		}
+
+		count++;
+	} while (value);
+
+	HUMTraceBufferAppend(buffer, bytes, count);
+}
+
+static void HUMTraceBufferAppendUInt64(HUMTraceBuffer *buffer, uint64_t value) {
+	uint8_t bytes[8];
+
+	for (int i = 0; i < 8; i++) {
+		bytes[i] = (uint8_t)(value >> (8 * i));
+	}
+
+	HUMTraceBufferAppend(buffer, bytes, 8);
+}
+
+static uint64_t HUMTraceCursorReadVarint(HUMTraceCursor *cursor) {
+	uint64_t value = 0;
+
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (cursor->offset >= cursor->count) {
+			break;
+		}
+
+		uint8_t byte = cursor->bytes[cursor->offset++];
+		value |= (uint64_t)(byte & 0x7f) << shift;
+
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+
+	cursor->failed = true;
+	return 0;
+}
+
+static uint64_t HUMTraceCursorReadUInt64(HUMTraceCursor *cursor) {
+	if (cursor->count - cursor->offset < 8) {
+		cursor->failed = true;
+		return 0;
+	}
+
+	uint64_t value = 0;
+
+	for (int i = 0; i < 8; i++) {
+		value |= (uint64_t)cursor->bytes[cursor->offset++] << (8 * i);
+	}
+
+	return value;
+}
+
+/**
+ *	Reads a varint that has to fit in an int32_t, such as a tile coordinate or a map size.
+ */
+static int32_t HUMTraceCursorReadInt32(HUMTraceCursor *cursor) {
+	uint64_t value = HUMTraceCursorReadVarint(cursor);
+
+	if (value > INT32_MAX) {
+		cursor->failed = true;
+		return 0;
+	}
+
+	return (int32_t)value;
+}
+
+#pragma mark - Tiles
+static void HUMTraceEncodeTiles(HUMTraceBuffer *buffer, size_t tileCount, const uint8_t *walkable, const uint32_t *costs) {
+	size_t bitmapLength = (tileCount + 7) / 8;
+
+	if (!HUMTraceBufferReserve(buffer, bitmapLength)) {
+		return;
+	}
+
+	uint8_t *bitmap = buffer->bytes + buffer->count;
+	memset(bitmap, 0, bitmapLength);
+	buffer->count += bitmapLength;
+
+	for (size_t i = 0; i < tileCount; i++) {
+		if (walkable[i]) {
+			bitmap[i >> 3] |= (uint8_t)(1 << (i & 7));
+		}
+	}
+
+	for (size_t i = 0; i < tileCount; i++) {
+		if (walkable[i]) {
+			HUMTraceBufferAppendVarint(buffer, costs[i]);
+		}
+	}
+}
+
+static bool HUMTraceDecodeTiles(HUMTraceCursor *cursor, size_t tileCount, uint8_t *walkable, uint32_t *costs) {
+	size_t bitmapLength = (tileCount + 7) / 8;
+
+	if (cursor->count - cursor->offset < bitmapLength) {
+		return false;
+	}
+
+	const uint8_t *bitmap = cursor->bytes + cursor->offset;
+	cursor->offset += bitmapLength;
+
+	for (size_t i = 0; i < tileCount; i++) {
+		walkable[i] = (bitmap[i >> 3] >> (i & 7)) & 1;
+		costs[i] = 0;
+
+		if (walkable[i]) {
+			uint64_t cost = HUMTraceCursorReadVarint(cursor);
+			costs[i] = cost > UINT32_MAX ? UINT32_MAX : (uint32_t)cost;
+		}
+	}
+
+	return !cursor->failed;
+}
+
+#pragma mark - Writing
+static void HUMTraceWriterEmit(HUMTraceWriter *writer, HUMTraceRecordType type) {
+	if (writer->payload.failed) {
+		writer->failed = true;
+		writer->payload.failed = false;
+		return;
+	}
+
+	uint8_t header[11];
+	size_t headerLength = 0;
+	uint64_t length = writer->payload.count;
+
+	header[headerLength++] = (uint8_t)type;
+
+	do {
+		header[headerLength] = (uint8_t)(length & 0x7f);
+		length >>= 7;
+
+		if (length) {
+			header[headerLength] |= 0x80;
+		}
+
+		headerLength++;
+	} while (length);
+
+	if (fwrite(header, 1, headerLength, writer->file) != headerLength || fwrite(writer->payload.bytes, 1, writer->payload.count, writer->file) != writer->payload.count) {
+		writer->failed = true;
+	}
+}
+
+HUMTraceWriter *HUMTraceWriterOpen(const char *path) {
+	HUMTraceWriter *writer = calloc(1, sizeof(HUMTraceWriter));
+	if (!writer) {
+		return NULL;
+	}
+
+	writer->file = fopen(path, "wb");
+	if (!writer->file) {
+		free(writer);
+		return NULL;
+	}
+
+	uint8_t header[8];
+	for (int i = 0; i < 4; i++) {
+		header[i] = (uint8_t)(HUMTraceMagic >> (8 * i));
+		header[4 + i] = (uint8_t)(HUMTraceVersion >> (8 * i));
+	}
+
+	writer->failed = fwrite(header, 1, sizeof(header), writer->file) != sizeof(header);
+
+	return writer;
+}
+
+bool HUMTraceWriterClose(HUMTraceWriter *writer) {
+	if (!writer) {
+		return false;
+	}
+
+	bool succeeded = !writer->failed;
+
+	if (fclose(writer->file) != 0) {
+		succeeded = false;
+	}
+
+	free(writer->payload.bytes);
+	free(writer->tiles.bytes);
+	free(writer->hashes);
+	free(writer);
+
+	return succeeded;
+}
+
+uint64_t HUMTraceWriteMap(HUMTraceWriter *writer, int32_t width, int32_t height, const uint8_t *walkable, const uint32_t *costs) {
+	writer->tiles.count = 0;
+	HUMTraceEncodeTiles(&writer->tiles, (size_t)width * (size_t)height, walkable, costs);
+
+	if (writer->tiles.failed) {
+		writer->tiles.failed = false;
+		writer->failed = true;
+		return 0;
+	}
+
+	uint32_t size[2] = { (uint32_t)width, (uint32_t)height };
+	uint64_t hash = HUMNavigationChecksum(writer->tiles.bytes, writer->tiles.count, HUMNavigationChecksum(size, sizeof(size), 0));
+
+	bool written = false;
+	for (int32_t i = 0; i < writer->hashCount && !written; i++) {
+		written = writer->hashes[i] == hash;
+	}
+
+	if (!written) {
+		if (writer->hashCount == writer->hashCapacity) {
+			int32_t capacity = writer->hashCapacity ? writer->hashCapacity * 2 : 16;
+			uint64_t *hashes = realloc(writer->hashes, (size_t)capacity * sizeof(uint64_t));
+
+			if (!hashes) {
+				writer->failed = true;
+				return hash;
+			}
+
+			writer->hashes = hashes;
+			writer->hashCapacity = capacity;
+		}
+
+		writer->hashes[writer->hashCount++] = hash;
+
+		writer->payload.count = 0;
+		HUMTraceBufferAppendUInt64(&writer->payload, hash);
+		HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)width);
+		HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)height);
+		HUMTraceBufferAppendVarint(&writer->payload, writer->tiles.count);
+		HUMTraceBufferAppend(&writer->payload, writer->tiles.bytes, writer->tiles.count);
+		HUMTraceWriterEmit(writer, HUMTraceRecordSnapshot);
+	}
+
+	writer->payload.count = 0;
+	HUMTraceBufferAppendUInt64(&writer->payload, hash);
+	HUMTraceWriterEmit(writer, HUMTraceRecordMap);
+
+	return hash;
+}
+
+void HUMTraceWriteEdit(HUMTraceWriter *writer, HUMTraceEditSource source, HUMSearchTileRect rect, const uint8_t *walkable, const uint32_t *costs) {
+	writer->tiles.count = 0;
+	HUMTraceEncodeTiles(&writer->tiles, (size_t)rect.width * (size_t)rect.height, walkable, costs);
+
+	if (writer->tiles.failed) {
+		writer->tiles.failed = false;
+		writer->failed = true;
+		return;
+	}
+
+	writer->payload.count = 0;
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)source);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)rect.x);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)rect.y);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)rect.width);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)rect.height);
+	HUMTraceBufferAppendVarint(&writer->payload, writer->tiles.count);
+	HUMTraceBufferAppend(&writer->payload, writer->tiles.bytes, writer->tiles.count);
+	HUMTraceWriterEmit(writer, HUMTraceRecordEdit);
+}
+
+void HUMTraceWriteSettings(HUMTraceWriter *writer, const HUMTraceSettings *settings) {
+	const HUMTraceSettings *last = &writer->settings;
+
+	if (writer->wroteSettings && last->neighbors == settings->neighbors && last->heuristic == settings->heuristic && last->layout == settings->layout &&
+		last->baseMovementCost == settings->baseMovementCost && last->boundedSearchMemoryLimit == settings->boundedSearchMemoryLimit &&
+		last->prunesSwamps == settings->prunesSwamps && last->uniformCosts == settings->uniformCosts) {
+		return;
+	}
+
+	writer->settings = *settings;
+	writer->wroteSettings = true;
+
+	writer->payload.count = 0;
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)settings->neighbors);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)settings->heuristic);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)settings->layout);
+	HUMTraceBufferAppendVarint(&writer->payload, settings->baseMovementCost);
+	HUMTraceBufferAppendVarint(&writer->payload, settings->boundedSearchMemoryLimit);
+	HUMTraceBufferAppendVarint(&writer->payload, settings->prunesSwamps ? 1 : 0);
+	HUMTraceBufferAppendVarint(&writer->payload, settings->uniformCosts ? 1 : 0);
+	HUMTraceWriterEmit(writer, HUMTraceRecordSettings);
+}
+
+void HUMTraceWriteQuery(HUMTraceWriter *writer, const HUMTraceQuery *query) {
+	writer->payload.count = 0;
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)query->startX);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)query->startY);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)query->targetX);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)query->targetY);
+	HUMTraceBufferAppendVarint(&writer->payload, query->unitSize);
+	HUMTraceBufferAppendVarint(&writer->payload, query->searchMode);
+	HUMTraceBufferAppendVarint(&writer->payload, (uint64_t)query->result);
+	HUMTraceBufferAppendVarint(&writer->payload, query->pathCount);
+	HUMTraceBufferAppendVarint(&writer->payload, query->latency);
+	HUMTraceWriterEmit(writer, HUMTraceRecordQuery);
+}
+
+#pragma mark - Reading
+HUMTraceReader *HUMTraceReaderOpen(const char *path, HUMTraceStatus *status) {
+	HUMTraceStatus openStatus = HUMTraceStatusUnreadable;
+	HUMTraceReader *reader = calloc(1, sizeof(HUMTraceReader));
+	uint8_t header[8];
+
+	if (!reader || !(reader->file = fopen(path, "rb"))) {
+		free(reader);
+		reader = NULL;
+	}
+	else if (fread(header, 1, sizeof(header), reader->file) != sizeof(header)) {
+		openStatus = HUMTraceStatusInvalid;
+	}
+	else {
+		uint32_t magic = header[0] | (header[1] << 8) | (header[2] << 16) | ((uint32_t)header[3] << 24);
+		uint32_t version = header[4] | (header[5] << 8) | (header[6] << 16) | ((uint32_t)header[7] << 24);
+
+		if (magic != HUMTraceMagic) {
+			openStatus = HUMTraceStatusInvalid;
+		}
+		else if (version != HUMTraceVersion) {
+			openStatus = HUMTraceStatusUnsupportedVersion;
+		}
+		else {
+			openStatus = HUMTraceStatusOK;
+		}
+	}
+
+	if (reader && openStatus != HUMTraceStatusOK) {
+		HUMTraceReaderClose(reader);
+		reader = NULL;
+	}
+
+	if (status) {
+		*status = openStatus;
+	}
+
+	return reader;
+}
+
+void HUMTraceReaderClose(HUMTraceReader *reader) {
+	if (!reader) {
+		return;
+	}
+
+	for (int32_t i = 0; i < reader->snapshotCount; i++) {
+		free(reader->snapshots[i].walkable);
+		free(reader->snapshots[i].costs);
+	}
+
+	if (reader->file) {
+		fclose(reader->file);
+	}
+
+	free(reader->snapshots);
+	free(reader->payload.bytes);
+	free(reader->editWalkable);
+	free(reader->editCosts);
+	free(reader);
+}
+
+static const HUMTraceSnapshot *HUMTraceReaderFindSnapshot(const HUMTraceReader *reader, uint64_t hash) {
+	for (int32_t i = 0; i < reader->snapshotCount; i++) {
+		if (reader->snapshots[i].hash == hash) {
+			return &reader->snapshots[i];
+		}
+	}
+
+	return NULL;
+}
+
+static HUMTraceStatus HUMTraceReaderReadSnapshot(HUMTraceReader *reader, HUMTraceCursor *cursor) {
+	HUMTraceSnapshot snapshot = { 0 };
+	snapshot.hash = HUMTraceCursorReadUInt64(cursor);
+	snapshot.width = HUMTraceCursorReadInt32(cursor);
+	snapshot.height = HUMTraceCursorReadInt32(cursor);
+	uint64_t tilesLength = HUMTraceCursorReadVarint(cursor);
+
+	if (cursor->failed || snapshot.width <= 0 || snapshot.height <= 0 || tilesLength > cursor->count - cursor->offset) {
+		return HUMTraceStatusInvalid;
+	}
+
+	// a trace written by one session never stores the same map twice, but the first copy wins if it does
+	if (HUMTraceReaderFindSnapshot(reader, snapshot.hash)) {
+		return HUMTraceStatusOK;
+	}
+
+	size_t tileCount = (size_t)snapshot.width * (size_t)snapshot.height;
+	if ((tileCount + 7) / 8 > tilesLength) {
+		return HUMTraceStatusInvalid;
+	}
+
+	if (reader->snapshotCount == reader->snapshotCapacity) {
+		int32_t capacity = reader->snapshotCapacity ? reader->snapshotCapacity * 2 : 4;
+		HUMTraceSnapshot *snapshots = realloc(reader->snapshots, (size_t)capacity * sizeof(HUMTraceSnapshot));
+
+		if (!snapshots) {
+			return HUMTraceStatusUnreadable;
+		}
+
+		reader->snapshots = snapshots;
+		reader->snapshotCapacity = capacity;
+	}
+
+	snapshot.walkable = malloc(tileCount);
+	snapshot.costs = malloc(tileCount * sizeof(uint32_t));
+
+	if (!snapshot.walkable || !snapshot.costs) {
+		free(snapshot.walkable);
+		free(snapshot.costs);
+		return HUMTraceStatusUnreadable;
+	}
+
+	HUMTraceCursor tiles = { cursor->bytes + cursor->offset, (size_t)tilesLength, 0, false };
+
+	if (!HUMTraceDecodeTiles(&tiles, tileCount, snapshot.walkable, snapshot.costs)) {
+		free(snapshot.walkable);
+		free(snapshot.costs);
+		return HUMTraceStatusInvalid;
+	}
+
+	reader->snapshots[reader->snapshotCount++] = snapshot;
+	return HUMTraceStatusOK;
+}
+
+static HUMTraceStatus HUMTraceReaderReadEdit(HUMTraceReader *reader, HUMTraceCursor *cursor, HUMTraceEdit *edit) {
+	edit->source = (HUMTraceEditSource)HUMTraceCursorReadVarint(cursor);
+	edit->rect.x = HUMTraceCursorReadInt32(cursor);
+	edit->rect.y = HUMTraceCursorReadInt32(cursor);
+	edit->rect.width = HUMTraceCursorReadInt32(cursor);
+	edit->rect.height = HUMTraceCursorReadInt32(cursor);
+	uint64_t tilesLength = HUMTraceCursorReadVarint(cursor);
+
+	size_t tileCount = (size_t)edit->rect.width * (size_t)edit->rect.height;
+
+	if (cursor->failed || tilesLength > cursor->count - cursor->offset || (tileCount + 7) / 8 > tilesLength) {
+		return HUMTraceStatusInvalid;
+	}
+
+	if (tileCount > reader->editCapacity) {
+		free(reader->editWalkable);
+		free(reader->editCosts);
+		reader->editWalkable = malloc(tileCount);
+		reader->editCosts = malloc(tileCount * sizeof(uint32_t));
+		reader->editCapacity = tileCount;
+
+		if (!reader->editWalkable || !reader->editCosts) {
+			reader->editCapacity = 0;
+			return HUMTraceStatusUnreadable;
+		}
+	}
+
+	HUMTraceCursor tiles = { cursor->bytes + cursor->offset, (size_t)tilesLength, 0, false };
+
+	if (!HUMTraceDecodeTiles(&tiles, tileCount, reader->editWalkable, reader->editCosts)) {
+		return HUMTraceStatusInvalid;
+	}
+
+	edit->walkable = reader->editWalkable;
+	edit->costs = reader->editCosts;
+	return HUMTraceStatusOK;
+}
+
+HUMTraceStatus HUMTraceReaderNext(HUMTraceReader *reader, HUMTraceRecord *record) {
+	while (true) {
+		memset(record, 0, sizeof(HUMTraceRecord));
+
+		int type = fgetc(reader->file);
+		if (type == EOF) {
+			return ferror(reader->file) ? HUMTraceStatusUnreadable : HUMTraceStatusEnd;
+		}
+
+		uint64_t length = 0;
+		int shift = 0;
+		int byte = 0;
+
+		do {
+			byte = fgetc(reader->file);
+			if (byte == EOF || shift > 63) {
+				return HUMTraceStatusInvalid;
+			}
+
+			length |= (uint64_t)(byte & 0x7f) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+
+		if (length > HUMTraceMaximumRecordLength) {
+			return HUMTraceStatusInvalid;
+		}
+
+		reader->payload.count = 0;
+		if (!HUMTraceBufferReserve(&reader->payload, (size_t)length)) {
+			return HUMTraceStatusUnreadable;
+		}
+
+		if (fread(reader->payload.bytes, 1, (size_t)length, reader->file) != length) {
+			return HUMTraceStatusInvalid;
+		}
+
+		HUMTraceCursor cursor = { reader->payload.bytes, (size_t)length, 0, false };
+		HUMTraceStatus status = HUMTraceStatusOK;
+		record->type = (HUMTraceRecordType)type;
+
+		switch (type) {
+			case HUMTraceRecordSnapshot:
+				status = HUMTraceReaderReadSnapshot(reader, &cursor);
+
+				if (status != HUMTraceStatusOK) {
+					return status;
+				}
+
+				// snapshots are only ever returned through the map records that refer to them
+				continue;
+
+			case HUMTraceRecordMap: {
+				const HUMTraceSnapshot *snapshot = HUMTraceReaderFindSnapshot(reader, HUMTraceCursorReadUInt64(&cursor));
+
+				if (!snapshot) {
+					return HUMTraceStatusInvalid;
+				}
+
+				record->map.hash = snapshot->hash;
+				record->map.width = snapshot->width;
+				record->map.height = snapshot->height;
+				record->map.walkable = snapshot->walkable;
+				record->map.costs = snapshot->costs;
+				break;
+			}
+
+			case HUMTraceRecordEdit:
+				status = HUMTraceReaderReadEdit(reader, &cursor, &record->edit);
+				break;
+
+			case HUMTraceRecordSettings:
+				record->settings.neighbors = (HUMSearchNeighbors)HUMTraceCursorReadVarint(&cursor);
+				record->settings.heuristic = (HUMSearchHeuristic)HUMTraceCursorReadVarint(&cursor);
+				record->settings.layout = (HUMSearchLayout)HUMTraceCursorReadVarint(&cursor);
+				record->settings.baseMovementCost = (uint32_t)HUMTraceCursorReadVarint(&cursor);
+				record->settings.boundedSearchMemoryLimit = HUMTraceCursorReadVarint(&cursor);
+				record->settings.prunesSwamps = HUMTraceCursorReadVarint(&cursor) != 0;
+				record->settings.uniformCosts = HUMTraceCursorReadVarint(&cursor) != 0;
+
+				if (record->settings.neighbors >= HUMSearchNeighborsCount || record->settings.heuristic >= HUMSearchHeuristicCount || record->settings.layout >= HUMSearchLayoutCount) {
+					status = HUMTraceStatusInvalid;
+				}
+				break;
+
+			case HUMTraceRecordQuery:
+				record->query.startX = HUMTraceCursorReadInt32(&cursor);
+				record->query.startY = HUMTraceCursorReadInt32(&cursor);
+				record->query.targetX = HUMTraceCursorReadInt32(&cursor);
+				record->query.targetY = HUMTraceCursorReadInt32(&cursor);
+				record->query.unitSize = (uint32_t)HUMTraceCursorReadVarint(&cursor);
+				record->query.searchMode = (uint32_t)HUMTraceCursorReadVarint(&cursor);
+				record->query.result = (HUMTraceResult)HUMTraceCursorReadVarint(&cursor);
+				record->query.pathCount = (uint32_t)HUMTraceCursorReadVarint(&cursor);
+				record->query.latency = HUMTraceCursorReadVarint(&cursor);
+				break;
+
+			default:
+				// a record type added after this reader was written
+				continue;
+		}
+
+		// records may grow new fields at the end, so only running out of payload is an error
+		return (status == HUMTraceStatusOK && cursor.failed) ? HUMTraceStatusInvalid : status;
+	}
+}
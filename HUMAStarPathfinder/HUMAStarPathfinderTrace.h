@@ -0,0 +1,185 @@
+//
+//  HUMAStarPathfinderTrace.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderTrace_h
+#define HUMAStarPathfinder_HUMAStarPathfinderTrace_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "HUMAStarPathfinderSearch.h"
+
+/**
+ *	A trace records the queries a pathfinder ran and the maps it ran them against, so they can be run again offline. It starts with the magic
+ *  and version as two little-endian uint32_t values, followed by records. Each record is a type byte, the length of its payload as a varint,
+ *  and the payload, so readers skip record types they don't know. Every number in a payload is an unsigned LEB128 varint unless noted.
+ *
+ *	Tiles are stored as one bit per tile, set if it's walkable, in row-major order and rounded up to whole bytes, followed by the cost of
+ *  every walkable tile as a varint. A map is stored once per trace, in a snapshot record, and referred to by the hash of its size and tiles.
+ */
+#define HUMTraceMagic 0x544d5548		// "HUMT"
+#define HUMTraceVersion 1
+
+typedef enum {
+	/**
+	 *	The hash as a little-endian uint64_t, the width and height, the length of the tiles, and the tiles. Always followed by a map record.
+	 */
+	HUMTraceRecordSnapshot = 1,
+
+	/**
+	 *	The hash of a snapshot, as a little-endian uint64_t. Queries and edits that follow apply to that map.
+	 */
+	HUMTraceRecordMap = 2,
+
+	/**
+	 *	The source, the x, y, width, and height of a rect of tiles, the length of the tiles, and the new tiles of the rect.
+	 */
+	HUMTraceRecordEdit = 3,
+
+	/**
+	 *	The neighbors, heuristic, memory layout, base movement cost, bounded search memory limit, whether swamps were skipped, and whether every
+	 *  tile cost the base movement cost, for the queries that follow.
+	 */
+	HUMTraceRecordSettings = 4,
+
+	/**
+	 *	The start x and y, the target x and y, the unit size, the search mode, the result, the number of points in the path, and the time the
+	 *  query took in nanoseconds.
+	 */
+	HUMTraceRecordQuery = 5
+} HUMTraceRecordType;
+
+typedef enum {
+	HUMTraceEditInvalidation = 0,	// the tiles were invalidated, so their walkability or cost may have changed
+	HUMTraceEditCostLayer			// a cost layer changed the costs of the tiles
+} HUMTraceEditSource;
+
+typedef enum {
+	HUMTraceResultNone = 0,			// the query returned nil
+	HUMTraceResultNoPath,			// the query returned an empty path
+	HUMTraceResultPath
+} HUMTraceResult;
+
+typedef enum {
+	HUMTraceStatusOK = 0,
+	HUMTraceStatusEnd,				// there are no more records
+	HUMTraceStatusUnreadable,		// the file couldn't be opened, read, or written
+	HUMTraceStatusInvalid,			// not a trace, truncated, or refers to a snapshot it doesn't hold
+	HUMTraceStatusUnsupportedVersion
+} HUMTraceStatus;
+
+typedef struct {
+	uint64_t hash;
+	int32_t width;
+	int32_t height;
+	const uint8_t *walkable;		// width * height flags, row-major
+	const uint32_t *costs;			// width * height costs, 0 for blocked tiles
+} HUMTraceMap;
+
+typedef struct {
+	HUMTraceEditSource source;
+	HUMSearchTileRect rect;
+	const uint8_t *walkable;		// rect.width * rect.height flags, row-major
+	const uint32_t *costs;
+} HUMTraceEdit;
+
+typedef struct {
+	HUMSearchNeighbors neighbors;
+	HUMSearchHeuristic heuristic;
+	HUMSearchLayout layout;
+	uint32_t baseMovementCost;
+	uint64_t boundedSearchMemoryLimit;
+	bool prunesSwamps;
+	bool uniformCosts;				// no delegate, navigation file, or cost layer gave tiles their own costs
+} HUMTraceSettings;
+
+typedef struct {
+	int32_t startX;
+	int32_t startY;
+	int32_t targetX;
+	int32_t targetY;
+	uint32_t unitSize;
+	uint32_t searchMode;			// a HUMAStarSearchMode
+	HUMTraceResult result;
+	uint32_t pathCount;				// the points in the path, including the start point
+	uint64_t latency;				// nanoseconds
+} HUMTraceQuery;
+
+/**
+ *	A record read from a trace. Only the member matching the type is filled in. Snapshot records are read into the reader and never returned,
+ *  and the map records that follow them refer to the snapshot's tiles.
+ */
+typedef struct {
+	HUMTraceRecordType type;
+	HUMTraceMap map;
+	HUMTraceEdit edit;
+	HUMTraceSettings settings;
+	HUMTraceQuery query;
+} HUMTraceRecord;
+
+typedef struct HUMTraceWriter HUMTraceWriter;
+
+/**
+ *	Creates a trace file, replacing any file at the path. Records are buffered, and the trace is complete once the writer is closed. A writer
+ *  must only be used by one thread at a time.
+ *
+ *	@return	The writer, or NULL if the file couldn't be created.
+ */
+HUMTraceWriter *HUMTraceWriterOpen(const char *path);
+
+/**
+ *	Flushes and closes the trace.
+ *
+ *	@return	false if any record couldn't be written.
+ */
+bool HUMTraceWriterClose(HUMTraceWriter *writer);
+
+/**
+ *	Records the map the queries that follow run against. The tiles are only stored if no map with the same hash was stored before.
+ *
+ *	@param	walkable	width * height flags, row-major.
+ *	@param	costs		width * height costs, row-major. The costs of blocked tiles are ignored.
+ *
+ *	@return	The hash of the map.
+ */
+uint64_t HUMTraceWriteMap(HUMTraceWriter *writer, int32_t width, int32_t height, const uint8_t *walkable, const uint32_t *costs);
+
+/**
+ *	Records the new walkability and costs of a rect of tiles.
+ *
+ *	@param	walkable	rect.width * rect.height flags, row-major.
+ *	@param	costs		rect.width * rect.height costs, row-major.
+ */
+void HUMTraceWriteEdit(HUMTraceWriter *writer, HUMTraceEditSource source, HUMSearchTileRect rect, const uint8_t *walkable, const uint32_t *costs);
+
+/**
+ *	Records the settings the queries that follow run with, unless they're the ones recorded last.
+ */
+void HUMTraceWriteSettings(HUMTraceWriter *writer, const HUMTraceSettings *settings);
+void HUMTraceWriteQuery(HUMTraceWriter *writer, const HUMTraceQuery *query);
+
+typedef struct HUMTraceReader HUMTraceReader;
+
+/**
+ *	Opens a trace and checks its magic and version.
+ *
+ *	@param	status	Set to the reason the trace couldn't be opened. May be NULL.
+ *
+ *	@return	The reader, or NULL.
+ */
+HUMTraceReader *HUMTraceReaderOpen(const char *path, HUMTraceStatus *status);
+void HUMTraceReaderClose(HUMTraceReader *reader);
+
+/**
+ *	Reads the next record. The tiles of map and edit records belong to the reader, and those of an edit are only valid until the next call.
+ *
+ *	@return	HUMTraceStatusOK if a record was read, HUMTraceStatusEnd at the end of the trace, or the reason it couldn't be read.
+ */
+HUMTraceStatus HUMTraceReaderNext(HUMTraceReader *reader, HUMTraceRecord *record);
+
+#endif
@@ -0,0 +1,794 @@
+//
+//  HUMAStarPathfinderVisibilityGraph.c
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#include "HUMAStarPathfinderVisibilityGraph.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma mark - Line of Sight
+
+static inline bool HUMVisibilityGraphIsBlocked(const HUMVisibilityGraph *graph, int32_t x, int32_t y) {
+	if (x < 0 || y < 0 || x >= graph->width || y >= graph->height) {
+		return true;
+	}
+
+	return !graph->walkable[y * graph->width + x];
+}
+
+/**
+ *	Determines if a line passing straight through a corner squeezes between two unwalkable tiles that only touch there.
+ *
+ *	@param	diagonalDown	true if the line runs from the tile above and left of the corner to the one below and right, or back.
+ */
+static inline bool HUMVisibilityGraphSqueezesThroughCorner(const HUMVisibilityGraph *graph, int32_t x, int32_t y, bool diagonalDown) {
+	if (diagonalDown) {
+		return HUMVisibilityGraphIsBlocked(graph, x, y - 1) && HUMVisibilityGraphIsBlocked(graph, x - 1, y);
+	}
+
+	return HUMVisibilityGraphIsBlocked(graph, x - 1, y - 1) && HUMVisibilityGraphIsBlocked(graph, x, y);
+}
+
+/**
+ *	The line of sight along a grid line, which is clear as long as one side of it is walkable everywhere and it doesn't cross a corner
+ *  between two unwalkable tiles on opposite sides.
+ *
+ *	@param	horizontal	true if the line runs along y = line, false if along x = line.
+ */
+static bool HUMVisibilityGraphLineOfSightAlongGridLine(const HUMVisibilityGraph *graph, int32_t line, double from, double to, bool horizontal) {
+	if (from > to) {
+		double swap = from;
+		from = to;
+		to = swap;
+	}
+
+	for (int32_t i = (int32_t)floor(from); i < to; i++) {
+		bool before = horizontal ? HUMVisibilityGraphIsBlocked(graph, i, line - 1) : HUMVisibilityGraphIsBlocked(graph, line - 1, i);
+		bool after = horizontal ? HUMVisibilityGraphIsBlocked(graph, i, line) : HUMVisibilityGraphIsBlocked(graph, line, i);
+
+		if (before && after) {
+			return false;
+		}
+
+		// the corner at the end of this tile, if the line goes past it
+		if (i + 1 > from && i + 1 < to) {
+			int32_t x = horizontal ? i + 1 : line;
+			int32_t y = horizontal ? line : i + 1;
+
+			if (HUMVisibilityGraphSqueezesThroughCorner(graph, x, y, true) || HUMVisibilityGraphSqueezesThroughCorner(graph, x, y, false)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool HUMVisibilityGraphLineOfSight(const HUMVisibilityGraph *graph, double x0, double y0, double x1, double y1) {
+	double dx = x1 - x0;
+	double dy = y1 - y0;
+
+	if (dx == 0.0 && dy == 0.0) {
+		return true;
+	}
+
+	if (dy == 0.0 && y0 == floor(y0)) {
+		return HUMVisibilityGraphLineOfSightAlongGridLine(graph, (int32_t)y0, x0, x1, true);
+	}
+
+	if (dx == 0.0 && x0 == floor(x0)) {
+		return HUMVisibilityGraphLineOfSightAlongGridLine(graph, (int32_t)x0, y0, y1, false);
+	}
+
+	// walk the times the line crosses a vertical or horizontal grid line, checking the tile between each pair of crossings
+	int32_t stepX = dx > 0.0 ? 1 : -1;
+	int32_t stepY = dy > 0.0 ? 1 : -1;
+	int32_t nextX = dx > 0.0 ? (int32_t)floor(x0) + 1 : (int32_t)ceil(x0) - 1;
+	int32_t nextY = dy > 0.0 ? (int32_t)floor(y0) + 1 : (int32_t)ceil(y0) - 1;
+	double previous = 0.0;
+
+	for (;;) {
+		double crossX = dx != 0.0 ? (nextX - x0) / dx : INFINITY;
+		double crossY = dy != 0.0 ? (nextY - y0) / dy : INFINITY;
+		double crossing = fmin(fmin(crossX, crossY), 1.0);
+
+		if (crossing > previous + 1e-9) {
+			double middle = (previous + crossing) * 0.5;
+			if (HUMVisibilityGraphIsBlocked(graph, (int32_t)floor(x0 + dx * middle), (int32_t)floor(y0 + dy * middle))) {
+				return false;
+			}
+		}
+
+		if (crossing >= 1.0 - 1e-9) {
+			return true;
+		}
+
+		if (fabs(crossX - crossY) < 1e-9) {
+			if (HUMVisibilityGraphSqueezesThroughCorner(graph, nextX, nextY, stepX == stepY)) {
+				return false;
+			}
+
+			nextX += stepX;
+			nextY += stepY;
+		}
+		else if (crossX < crossY) {
+			nextX += stepX;
+		}
+		else {
+			nextY += stepY;
+		}
+
+		previous = crossing;
+	}
+}
+
+#pragma mark - Corners
+
+/**
+ *	Determines if a path can turn at a corner, which it can if exactly one of the four tiles around it is unwalkable, or two on opposite sides.
+ *  In the second case the direction of the unwalkable tile is 0, since the path can turn on either side of the corner. It can't cross from one
+ *  side to the other, which the search enforces with HUMVisibilityGraphSide.
+ */
+static bool HUMVisibilityGraphCornerAt(const HUMVisibilityGraph *graph, int32_t x, int32_t y, int8_t *blockedX, int8_t *blockedY) {
+	bool topLeft = HUMVisibilityGraphIsBlocked(graph, x - 1, y - 1);
+	bool topRight = HUMVisibilityGraphIsBlocked(graph, x, y - 1);
+	bool bottomLeft = HUMVisibilityGraphIsBlocked(graph, x - 1, y);
+	bool bottomRight = HUMVisibilityGraphIsBlocked(graph, x, y);
+	int32_t blockedCount = topLeft + topRight + bottomLeft + bottomRight;
+
+	if (blockedCount == 1) {
+		*blockedX = (topRight || bottomRight) ? 1 : -1;
+		*blockedY = (bottomLeft || bottomRight) ? 1 : -1;
+		return true;
+	}
+
+	if (blockedCount == 2 && topLeft == bottomRight) {
+		*blockedX = 0;
+		*blockedY = 0;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ *	Determines if a line leaving a node in a direction can be part of a shortest path. It can't if it heads into the node's unwalkable tile,
+ *  or straight away from it, since a path arriving that way could always cut the corner instead of turning at it.
+ */
+static inline bool HUMVisibilityGraphIsTangent(const HUMVisibilityGraph *graph, int32_t node, double dx, double dy) {
+	double alongX = dx * graph->blockedX[node];
+	double alongY = dy * graph->blockedY[node];
+
+	return !((alongX > 0.0 && alongY > 0.0) || (alongX < 0.0 && alongY < 0.0));
+}
+
+/**
+ *	The side of a node a line leaving it in a direction is on. A corner with one unwalkable tile has a single side. A corner between two
+ *  unwalkable tiles on opposite sides has two, the walkable tiles on either side of the diagonal, and a path that turns there has to arrive
+ *  and leave on the same side, or it would squeeze between the two tiles. Lines of sight never head into an unwalkable tile, so every line
+ *  leaving such a corner runs through or along one of its walkable tiles.
+ *
+ *	@return	0 or 1.
+ */
+static inline int32_t HUMVisibilityGraphSide(const HUMVisibilityGraph *graph, int32_t node, double dx, double dy) {
+	if (graph->blockedX[node] != 0) {
+		return 0;
+	}
+
+	// the walkable tiles are either the top right and bottom left ones, or the top left and bottom right ones. Side 0 holds the one above.
+	if (HUMVisibilityGraphIsBlocked(graph, graph->nodeX[node] - 1, graph->nodeY[node] - 1)) {
+		return (dx > 0.0 || (dx == 0.0 && dy < 0.0)) ? 0 : 1;
+	}
+
+	return (dx < 0.0 || (dx == 0.0 && dy < 0.0)) ? 0 : 1;
+}
+
+/**
+ *	Determines if a segment touches a closed rect.
+ */
+static bool HUMVisibilityGraphSegmentTouchesRect(double x0, double y0, double x1, double y1, double minX, double minY, double maxX, double maxY) {
+	double dx = x1 - x0;
+	double dy = y1 - y0;
+	double t0 = 0.0;
+	double t1 = 1.0;
+	double p[4] = { -dx, dx, -dy, dy };
+	double q[4] = { x0 - minX, maxX - x0, y0 - minY, maxY - y0 };
+
+	for (int i = 0; i < 4; i++) {
+		if (p[i] == 0.0) {
+			if (q[i] < 0.0) {
+				return false;
+			}
+
+			continue;
+		}
+
+		double t = q[i] / p[i];
+
+		if (p[i] < 0.0) {
+			t0 = fmax(t0, t);
+		}
+		else {
+			t1 = fmin(t1, t);
+		}
+
+		if (t0 > t1) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#pragma mark - Building
+
+typedef struct {
+	int32_t *pairs;		// two nodes per edge, the lower first
+	int32_t count;
+	int32_t capacity;
+} HUMVisibilityEdgeList;
+
+static bool HUMVisibilityEdgeListAdd(HUMVisibilityEdgeList *list, int32_t a, int32_t b) {
+	if (list->count == list->capacity) {
+		int32_t capacity = list->capacity ? list->capacity * 2 : 256;
+		int32_t *pairs = realloc(list->pairs, 2 * (size_t)capacity * sizeof(int32_t));
+		if (!pairs) {
+			return false;
+		}
+
+		list->pairs = pairs;
+		list->capacity = capacity;
+	}
+
+	list->pairs[2 * list->count] = a;
+	list->pairs[2 * list->count + 1] = b;
+	list->count++;
+
+	return true;
+}
+
+/**
+ *	Rebuilds the nodes and edges after the walkability of a rect of tiles has changed. Corners outside the rect and edges that don't touch it
+ *  are carried over from the current graph.
+ */
+static bool HUMVisibilityGraphRebuild(HUMVisibilityGraph *graph, int32_t rectX, int32_t rectY, int32_t rectWidth, int32_t rectHeight) {
+	int32_t oldCount = graph->nodeCount;
+	int32_t capacity = oldCount + (rectWidth + 1) * (rectHeight + 1);
+	size_t cornerCount = (size_t)(graph->width + 1) * (graph->height + 1);
+
+	int32_t *nodeAtCorner = malloc(cornerCount * sizeof(int32_t));
+	int32_t *nodeX = malloc(capacity * sizeof(int32_t));
+	int32_t *nodeY = malloc(capacity * sizeof(int32_t));
+	int8_t *blockedX = malloc(capacity * sizeof(int8_t));
+	int8_t *blockedY = malloc(capacity * sizeof(int8_t));
+	int32_t *oldNodes = malloc(capacity * sizeof(int32_t));		// the old index of each new node, or -1 for new corners
+	int32_t *newNodes = malloc((oldCount + 1) * sizeof(int32_t));	// the new index of each old node, or -1 if it's gone
+	int32_t *marks = malloc(capacity * sizeof(int32_t));
+	HUMVisibilityEdgeList list = { NULL, 0, 0 };
+	int32_t *firstEdge = NULL;
+	int32_t *edges = NULL;
+	float *edgeLengths = NULL;
+	bool built = false;
+
+	if (!nodeAtCorner || !nodeX || !nodeY || !blockedX || !blockedY || !oldNodes || !newNodes || !marks) {
+		goto done;
+	}
+
+	memcpy(nodeAtCorner, graph->nodeAtCorner, cornerCount * sizeof(int32_t));
+
+	int32_t count = 0;
+	int32_t lastX = rectX + rectWidth;
+	int32_t lastY = rectY + rectHeight;
+
+	// keep the old nodes that are still the same corner
+	for (int32_t i = 0; i < oldCount; i++) {
+		int32_t x = graph->nodeX[i];
+		int32_t y = graph->nodeY[i];
+		size_t corner = (size_t)y * (graph->width + 1) + x;
+
+		if (x >= rectX && x <= lastX && y >= rectY && y <= lastY) {
+			int8_t cornerBlockedX, cornerBlockedY;
+
+			if (!HUMVisibilityGraphCornerAt(graph, x, y, &cornerBlockedX, &cornerBlockedY) || cornerBlockedX != graph->blockedX[i] || cornerBlockedY != graph->blockedY[i]) {
+				newNodes[i] = -1;
+				nodeAtCorner[corner] = -1;
+				continue;
+			}
+		}
+
+		nodeX[count] = x;
+		nodeY[count] = y;
+		blockedX[count] = graph->blockedX[i];
+		blockedY[count] = graph->blockedY[i];
+		oldNodes[count] = i;
+		newNodes[i] = count;
+		nodeAtCorner[corner] = count;
+		count++;
+	}
+
+	// and add the corners around the rect that are new
+	for (int32_t y = rectY; y <= lastY; y++) {
+		for (int32_t x = rectX; x <= lastX; x++) {
+			size_t corner = (size_t)y * (graph->width + 1) + x;
+			int8_t cornerBlockedX, cornerBlockedY;
+
+			if (nodeAtCorner[corner] != -1 || !HUMVisibilityGraphCornerAt(graph, x, y, &cornerBlockedX, &cornerBlockedY)) {
+				continue;
+			}
+
+			nodeX[count] = x;
+			nodeY[count] = y;
+			blockedX[count] = cornerBlockedX;
+			blockedY[count] = cornerBlockedY;
+			oldNodes[count] = -1;
+			nodeAtCorner[corner] = count;
+			count++;
+		}
+	}
+
+	// the tangency test reads the new node arrays through a view of the graph
+	HUMVisibilityGraph view = *graph;
+	view.blockedX = blockedX;
+	view.blockedY = blockedY;
+	graph->lineOfSightTestCount = 0;
+
+	for (int32_t i = 0; i < count; i++) {
+		marks[i] = -1;
+	}
+
+	for (int32_t a = 0; a < count; a++) {
+		int32_t oldA = oldNodes[a];
+
+		// mark the nodes a was connected to before
+		if (oldA != -1) {
+			for (int32_t e = graph->firstEdge[oldA]; e < graph->firstEdge[oldA + 1]; e++) {
+				int32_t b = newNodes[graph->edges[e]];
+				if (b != -1) {
+					marks[b] = a;
+				}
+			}
+		}
+
+		for (int32_t b = a + 1; b < count; b++) {
+			double dx = nodeX[b] - nodeX[a];
+			double dy = nodeY[b] - nodeY[a];
+			bool connected;
+
+			if (oldA != -1 && oldNodes[b] != -1 && !HUMVisibilityGraphSegmentTouchesRect(nodeX[a], nodeY[a], nodeX[b], nodeY[b], rectX, rectY, lastX, lastY)) {
+				connected = (marks[b] == a);
+			}
+			else if (!HUMVisibilityGraphIsTangent(&view, a, dx, dy) || !HUMVisibilityGraphIsTangent(&view, b, -dx, -dy)) {
+				connected = false;
+			}
+			else {
+				graph->lineOfSightTestCount++;
+				connected = HUMVisibilityGraphLineOfSight(graph, nodeX[a], nodeY[a], nodeX[b], nodeY[b]);
+			}
+
+			if (connected && !HUMVisibilityEdgeListAdd(&list, a, b)) {
+				goto done;
+			}
+		}
+	}
+
+	// store the edges in both directions, grouped by node
+	firstEdge = calloc(count + 1, sizeof(int32_t));
+	edges = malloc((2 * (size_t)list.count + 1) * sizeof(int32_t));
+	edgeLengths = malloc((2 * (size_t)list.count + 1) * sizeof(float));
+
+	if (!firstEdge || !edges || !edgeLengths) {
+		goto done;
+	}
+
+	for (int32_t i = 0; i < list.count; i++) {
+		firstEdge[list.pairs[2 * i] + 1]++;
+		firstEdge[list.pairs[2 * i + 1] + 1]++;
+	}
+
+	for (int32_t i = 0; i < count; i++) {
+		firstEdge[i + 1] += firstEdge[i];
+	}
+
+	for (int32_t i = 0; i < count; i++) {
+		marks[i] = firstEdge[i];
+	}
+
+	for (int32_t i = 0; i < list.count; i++) {
+		int32_t a = list.pairs[2 * i];
+		int32_t b = list.pairs[2 * i + 1];
+		float length = hypotf(nodeX[b] - nodeX[a], nodeY[b] - nodeY[a]);
+
+		edges[marks[a]] = b;
+		edgeLengths[marks[a]++] = length;
+		edges[marks[b]] = a;
+		edgeLengths[marks[b]++] = length;
+	}
+
+	free(graph->nodeAtCorner);
+	free(graph->nodeX);
+	free(graph->nodeY);
+	free(graph->blockedX);
+	free(graph->blockedY);
+	free(graph->firstEdge);
+	free(graph->edges);
+	free(graph->edgeLengths);
+
+	graph->nodeAtCorner = nodeAtCorner;
+	graph->nodeX = nodeX;
+	graph->nodeY = nodeY;
+	graph->blockedX = blockedX;
+	graph->blockedY = blockedY;
+	graph->nodeCount = count;
+	graph->firstEdge = firstEdge;
+	graph->edges = edges;
+	graph->edgeLengths = edgeLengths;
+	graph->edgeCount = 2 * list.count;
+	built = true;
+
+done:
+	if (!built) {
+		free(nodeAtCorner);
+		free(nodeX);
+		free(nodeY);
+		free(blockedX);
+		free(blockedY);
+		free(firstEdge);
+		free(edges);
+		free(edgeLengths);
+	}
+
+	free(oldNodes);
+	free(newNodes);
+	free(marks);
+	free(list.pairs);
+
+	return built;
+}
+
+HUMVisibilityGraph *HUMVisibilityGraphCreate(int32_t width, int32_t height, const uint8_t *walkable) {
+	if (width <= 0 || height <= 0) {
+		return NULL;
+	}
+
+	HUMVisibilityGraph *graph = calloc(1, sizeof(HUMVisibilityGraph));
+	if (!graph) {
+		return NULL;
+	}
+
+	size_t cornerCount = (size_t)(width + 1) * (height + 1);
+
+	graph->width = width;
+	graph->height = height;
+	graph->walkable = malloc((size_t)width * height);
+	graph->nodeAtCorner = malloc(cornerCount * sizeof(int32_t));
+	graph->firstEdge = calloc(1, sizeof(int32_t));
+
+	if (!graph->walkable || !graph->nodeAtCorner || !graph->firstEdge) {
+		HUMVisibilityGraphFree(graph);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < (size_t)width * height; i++) {
+		graph->walkable[i] = walkable[i] ? 1 : 0;
+	}
+
+	for (size_t i = 0; i < cornerCount; i++) {
+		graph->nodeAtCorner[i] = -1;
+	}
+
+	if (!HUMVisibilityGraphRebuild(graph, 0, 0, width, height)) {
+		HUMVisibilityGraphFree(graph);
+		return NULL;
+	}
+
+	return graph;
+}
+
+void HUMVisibilityGraphFree(HUMVisibilityGraph *graph) {
+	if (!graph) {
+		return;
+	}
+
+	free(graph->walkable);
+	free(graph->nodeAtCorner);
+	free(graph->nodeX);
+	free(graph->nodeY);
+	free(graph->blockedX);
+	free(graph->blockedY);
+	free(graph->firstEdge);
+	free(graph->edges);
+	free(graph->edgeLengths);
+	free(graph);
+}
+
+bool HUMVisibilityGraphUpdate(HUMVisibilityGraph *graph, int32_t x, int32_t y, int32_t width, int32_t height, const uint8_t *walkable) {
+	if (x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > graph->width || y + height > graph->height) {
+		return true;
+	}
+
+	uint8_t *previous = malloc((size_t)width * height);
+	if (!previous) {
+		return false;
+	}
+
+	bool changed = false;
+
+	for (int32_t row = 0; row < height; row++) {
+		for (int32_t column = 0; column < width; column++) {
+			uint8_t *tile = &graph->walkable[(y + row) * graph->width + x + column];
+			uint8_t flag = walkable[row * width + column] ? 1 : 0;
+
+			previous[row * width + column] = *tile;
+			changed |= (*tile != flag);
+			*tile = flag;
+		}
+	}
+
+	bool updated = !changed || HUMVisibilityGraphRebuild(graph, x, y, width, height);
+
+	if (!updated) {
+		for (int32_t row = 0; row < height; row++) {
+			memcpy(&graph->walkable[(y + row) * graph->width + x], &previous[row * width], width);
+		}
+	}
+
+	free(previous);
+
+	return updated;
+}
+
+#pragma mark - Searching
+
+typedef struct {
+	float f;
+	int32_t node;
+} HUMVisibilityHeapEntry;
+
+/**
+ *	The scratch memory of one search. Each of the graph's nodes has two states, one for each side it can be reached on, which are followed by
+ *  the start and the target. A node with a single side only ever uses its first state.
+ */
+typedef struct {
+	float *g;
+	int32_t *parent;
+	int32_t *heapIndex;		// -1 if not on the open list, -2 once closed
+	HUMVisibilityHeapEntry *heap;
+	int32_t heapCount;
+} HUMVisibilitySearch;
+
+static void HUMVisibilityHeapSwap(HUMVisibilitySearch *search, int32_t a, int32_t b) {
+	HUMVisibilityHeapEntry entry = search->heap[a];
+	search->heap[a] = search->heap[b];
+	search->heap[b] = entry;
+	search->heapIndex[search->heap[a].node] = a;
+	search->heapIndex[search->heap[b].node] = b;
+}
+
+static void HUMVisibilityHeapPush(HUMVisibilitySearch *search, int32_t node, float f) {
+	int32_t index = search->heapIndex[node];
+
+	if (index < 0) {
+		index = search->heapCount++;
+		search->heap[index].node = node;
+		search->heapIndex[node] = index;
+	}
+
+	search->heap[index].f = f;
+
+	while (index > 0) {
+		int32_t parent = (index - 1) / 2;
+		if (search->heap[parent].f <= search->heap[index].f) {
+			break;
+		}
+
+		HUMVisibilityHeapSwap(search, parent, index);
+		index = parent;
+	}
+}
+
+static int32_t HUMVisibilityHeapPop(HUMVisibilitySearch *search) {
+	int32_t node = search->heap[0].node;
+	search->heapCount--;
+
+	if (search->heapCount > 0) {
+		search->heap[0] = search->heap[search->heapCount];
+		search->heapIndex[search->heap[0].node] = 0;
+
+		int32_t index = 0;
+		for (;;) {
+			int32_t smallest = index;
+			int32_t left = index * 2 + 1;
+			int32_t right = left + 1;
+
+			if (left < search->heapCount && search->heap[left].f < search->heap[smallest].f) {
+				smallest = left;
+			}
+
+			if (right < search->heapCount && search->heap[right].f < search->heap[smallest].f) {
+				smallest = right;
+			}
+
+			if (smallest == index) {
+				break;
+			}
+
+			HUMVisibilityHeapSwap(search, smallest, index);
+			index = smallest;
+		}
+	}
+
+	search->heapIndex[node] = -2;
+	return node;
+}
+
+static void HUMVisibilityRelax(HUMVisibilitySearch *search, int32_t from, int32_t to, float length, float h) {
+	if (search->heapIndex[to] == -2) {
+		return;
+	}
+
+	float g = search->g[from] + length;
+
+	if (search->heapIndex[to] >= 0 && g >= search->g[to]) {
+		return;
+	}
+
+	search->g[to] = g;
+	search->parent[to] = from;
+	HUMVisibilityHeapPush(search, to, g + h);
+}
+
+/**
+ *	The state of a node reached from, or leaving toward, a point in a direction.
+ */
+static inline int32_t HUMVisibilityGraphState(const HUMVisibilityGraph *graph, int32_t node, double dx, double dy) {
+	return 2 * node + HUMVisibilityGraphSide(graph, node, dx, dy);
+}
+
+bool HUMVisibilityGraphFindPath(const HUMVisibilityGraph *graph, double startX, double startY, double targetX, double targetY, HUMVisibilityPath *path) {
+	memset(path, 0, sizeof(HUMVisibilityPath));
+
+	if (HUMVisibilityGraphLineOfSight(graph, startX, startY, targetX, targetY)) {
+		path->xs = malloc(2 * sizeof(float));
+		path->ys = malloc(2 * sizeof(float));
+
+		if (!path->xs || !path->ys) {
+			return false;
+		}
+
+		path->xs[0] = startX;
+		path->ys[0] = startY;
+		path->xs[1] = targetX;
+		path->ys[1] = targetY;
+		path->count = 2;
+		path->length = hypot(targetX - startX, targetY - startY);
+
+		return true;
+	}
+
+	int32_t nodeCount = graph->nodeCount;
+	int32_t stateCount = 2 * nodeCount + 2;
+	int32_t start = 2 * nodeCount;
+	int32_t target = 2 * nodeCount + 1;
+
+	HUMVisibilitySearch search;
+	search.g = malloc(stateCount * sizeof(float));
+	search.parent = malloc(stateCount * sizeof(int32_t));
+	search.heapIndex = malloc(stateCount * sizeof(int32_t));
+	search.heap = malloc(stateCount * sizeof(HUMVisibilityHeapEntry));
+	search.heapCount = 0;
+
+	// the states the target can be reached from, and how far away it is from each
+	float *targetLengths = malloc(stateCount * sizeof(float));
+	bool found = false;
+
+	if (!search.g || !search.parent || !search.heapIndex || !search.heap || !targetLengths) {
+		goto done;
+	}
+
+	for (int32_t i = 0; i < stateCount; i++) {
+		targetLengths[i] = -1.0f;
+		search.heapIndex[i] = -1;
+	}
+
+	for (int32_t i = 0; i < nodeCount; i++) {
+		double dx = targetX - graph->nodeX[i];
+		double dy = targetY - graph->nodeY[i];
+
+		if (HUMVisibilityGraphIsTangent(graph, i, dx, dy) && HUMVisibilityGraphLineOfSight(graph, graph->nodeX[i], graph->nodeY[i], targetX, targetY)) {
+			targetLengths[HUMVisibilityGraphState(graph, i, dx, dy)] = hypot(dx, dy);
+		}
+	}
+
+	search.g[start] = 0.0f;
+	search.parent[start] = -1;
+	HUMVisibilityHeapPush(&search, start, hypot(targetX - startX, targetY - startY));
+
+	while (search.heapCount > 0) {
+		int32_t current = HUMVisibilityHeapPop(&search);
+		path->nodesExpanded++;
+
+		if (current == target) {
+			found = true;
+			break;
+		}
+
+		if (current == start) {
+			for (int32_t i = 0; i < nodeCount; i++) {
+				double dx = startX - graph->nodeX[i];
+				double dy = startY - graph->nodeY[i];
+
+				if (HUMVisibilityGraphIsTangent(graph, i, dx, dy) && HUMVisibilityGraphLineOfSight(graph, startX, startY, graph->nodeX[i], graph->nodeY[i])) {
+					HUMVisibilityRelax(&search, start, HUMVisibilityGraphState(graph, i, dx, dy), hypot(dx, dy), hypot(targetX - graph->nodeX[i], targetY - graph->nodeY[i]));
+				}
+			}
+
+			continue;
+		}
+
+		int32_t node = current / 2;
+
+		for (int32_t e = graph->firstEdge[node]; e < graph->firstEdge[node + 1]; e++) {
+			int32_t neighbor = graph->edges[e];
+			double dx = graph->nodeX[neighbor] - graph->nodeX[node];
+			double dy = graph->nodeY[neighbor] - graph->nodeY[node];
+
+			// leave on the side the node was reached on
+			if (HUMVisibilityGraphState(graph, node, dx, dy) != current) {
+				continue;
+			}
+
+			HUMVisibilityRelax(&search, current, HUMVisibilityGraphState(graph, neighbor, -dx, -dy), graph->edgeLengths[e], hypot(targetX - graph->nodeX[neighbor], targetY - graph->nodeY[neighbor]));
+		}
+
+		if (targetLengths[current] >= 0.0f) {
+			HUMVisibilityRelax(&search, current, target, targetLengths[current], 0.0f);
+		}
+	}
+
+	if (found) {
+		int32_t count = 0;
+		for (int32_t node = target; node != -1; node = search.parent[node]) {
+			count++;
+		}
+
+		path->xs = malloc(count * sizeof(float));
+		path->ys = malloc(count * sizeof(float));
+
+		if (!path->xs || !path->ys) {
+			found = false;
+			goto done;
+		}
+
+		path->count = count;
+		path->length = search.g[target];
+
+		int32_t index = count - 1;
+		for (int32_t node = target; node != -1; node = search.parent[node], index--) {
+			path->xs[index] = node == start ? startX : (node == target ? targetX : graph->nodeX[node / 2]);
+			path->ys[index] = node == start ? startY : (node == target ? targetY : graph->nodeY[node / 2]);
+		}
+	}
+
+done:
+	free(search.g);
+	free(search.parent);
+	free(search.heapIndex);
+	free(search.heap);
+	free(targetLengths);
+
+	return found;
+}
+
+void HUMVisibilityPathFree(HUMVisibilityPath *path) {
+	free(path->xs);
+	free(path->ys);
+	path->xs = NULL;
+	path->ys = NULL;
+	path->count = 0;
+}
@@ -0,0 +1,94 @@
+//
+//  HUMAStarPathfinderVisibilityGraph.h
+//  HUMAStarPathfinder
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+
+#ifndef HUMAStarPathfinder_HUMAStarPathfinderVisibilityGraph_h
+#define HUMAStarPathfinder_HUMAStarPathfinderVisibilityGraph_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ *	The visibility graph of a grid: a node at every convex corner of the unwalkable tiles, and an edge between every two corners that can see
+ *  each other. The shortest path between two points that may move in any direction only ever turns at convex corners, so searching the
+ *  graph finds exact any-angle shortest paths while visiting only a handful of nodes on maps with few obstacles.
+ *
+ *	Coordinates are in tiles, with tile (x, y) covering [x, x + 1) x [y, y + 1), and corners at whole coordinates. Tiles outside the map count
+ *  as unwalkable. A line of sight may run along the edge of an unwalkable tile, but never between two unwalkable tiles that share an edge
+ *  or touch at a corner.
+ */
+typedef struct {
+	int32_t width;
+	int32_t height;
+	uint8_t *walkable;			// width * height flags, row-major. The graph's own copy.
+	int32_t *nodeAtCorner;		// (width + 1) * (height + 1), the node at each corner, or -1
+
+	int32_t nodeCount;
+	int32_t *nodeX;				// the corner of each node
+	int32_t *nodeY;
+	int8_t *blockedX;			// the direction of the node's unwalkable tile from its corner, -1 or 1, or 0 if two opposite tiles are unwalkable
+	int8_t *blockedY;
+
+	int32_t *firstEdge;			// nodeCount + 1 offsets into edges: the edges of node i are firstEdge[i] to firstEdge[i + 1] - 1
+	int32_t *edges;				// the node at the other end of each edge
+	float *edgeLengths;
+	int32_t edgeCount;
+
+	uint64_t lineOfSightTestCount;	// line of sight tests run by the last build or update
+} HUMVisibilityGraph;
+
+/**
+ *	A path found by HUMVisibilityGraphFindPath. Free it with HUMVisibilityPathFree.
+ */
+typedef struct {
+	float *xs;					// the points of the path, from the start to the target, both included
+	float *ys;
+	int32_t count;
+	float length;
+	int32_t nodesExpanded;
+} HUMVisibilityPath;
+
+/**
+ *	Builds the visibility graph of a grid. Takes time proportional to the square of the number of corners, so it's suited to mostly open maps.
+ *
+ *	@param	walkable	width * height flags, row-major.
+ *
+ *	@return	The graph, or NULL if it couldn't be allocated.
+ */
+HUMVisibilityGraph *HUMVisibilityGraphCreate(int32_t width, int32_t height, const uint8_t *walkable);
+void HUMVisibilityGraphFree(HUMVisibilityGraph *graph);
+
+/**
+ *	Changes the walkability of a rect of tiles and brings the graph up to date. Only corners next to the rect are found again, and only lines of
+ *  sight that touch the rect or end at a new corner are tested again.
+ *
+ *	@param	walkable	width * height flags for the tiles in the rect, row-major.
+ *
+ *	@return	false if memory ran out, in which case the graph is left as it was before the call.
+ */
+bool HUMVisibilityGraphUpdate(HUMVisibilityGraph *graph, int32_t x, int32_t y, int32_t width, int32_t height, const uint8_t *walkable);
+
+/**
+ *	Determines if the straight line between two points stays clear of unwalkable tiles.
+ */
+bool HUMVisibilityGraphLineOfSight(const HUMVisibilityGraph *graph, double x0, double y0, double x1, double y1);
+
+/**
+ *	Finds the shortest path between two points. Both must lie in walkable tiles. If they can see each other, the path is the straight line
+ *  between them. Otherwise they are connected to every corner they can see, and the graph is searched with A*. A path may turn at a corner
+ *  between two unwalkable tiles touching there, but only if it arrives and leaves on the same side, so like grid A* it never crosses a wall
+ *  of tiles that only touch at their corners. The graph isn't changed, so it can be searched from any number of threads at once, as long as
+ *  it isn't updated at the same time.
+ *
+ *	@param	path	Filled with the path if one is found. Must be freed with HUMVisibilityPathFree, whatever the result.
+ *
+ *	@return	true if a path was found.
+ */
+bool HUMVisibilityGraphFindPath(const HUMVisibilityGraph *graph, double startX, double startY, double targetX, double targetY, HUMVisibilityPath *path);
+void HUMVisibilityPathFree(HUMVisibilityPath *path);
+
+#endif
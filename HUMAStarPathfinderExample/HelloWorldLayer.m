@@ -14,11 +14,13 @@
 #import "AppDelegate.h"
 
 #import "HUMAStarPathfinder.h"
+#import "HUMAStarPathfinderTMXLayerAdapter.h"
 
-@interface HelloWorldLayer () <HUMAStarPathfinderDelegate>
+@interface HelloWorldLayer ()
 @property (nonatomic, strong) CCTMXTiledMap *tileMap;
 @property (nonatomic, strong) CCSprite *player;
 @property (nonatomic, strong) HUMAStarPathfinder *pathfinder;
+@property (nonatomic, strong) HUMAStarPathfinderTMXLayerAdapter *tileMapAdapter;
 @end
 
 #pragma mark - HelloWorldLayer
@@ -62,7 +64,13 @@
 
 		self.pathfinder = [HUMAStarPathfinder pathfinderWithTileMapSize:self.tileMap.mapSize
 															   tileSize:self.tileMap.tileSize
-															   delegate:self];
+															   delegate:nil];
+		
+		// walkability comes from the Meta layer and movement cost from the Ground layer
+		self.tileMapAdapter = [HUMAStarPathfinderTMXLayerAdapter adapterWithTiledMap:self.tileMap
+															   walkabilityLayerNamed:@"Meta"
+																	  costLayerNamed:@"Ground"];
+		self.tileMapAdapter.pathfinder = self.pathfinder;
 	}
 	return self;
 }
@@ -90,35 +98,4 @@
 	[self.player runAction:sequence];
 }
 
-#pragma mark - HUMAStarPathfinderDelegate
-- (BOOL)pathfinder:(HUMAStarPathfinder *)pathFinder canWalkToNodeAtTileLocation:(CGPoint)tileLocation {
-	CCTMXLayer *meta = [self.tileMap layerNamed:@"Meta"];
-	uint8_t gid = [meta tileGIDAt:tileLocation];
-
-	BOOL walkable = YES;
-	
-	if (gid) {
-		NSDictionary *properties = [self.tileMap propertiesForGID:gid];
-		walkable = [properties[@"walkable"] boolValue];
-	}
-	
-	return walkable;
-}
-
-- (NSUInteger)pathfinder:(HUMAStarPathfinder *)pathfinder costForNodeAtTileLocation:(CGPoint)tileLocation {
-	CCTMXLayer *ground = [self.tileMap layerNamed:@"Ground"];
-	uint32_t gid = [ground tileGIDAt:tileLocation];
-	
-	NSUInteger cost = pathfinder.baseMovementCost;
-	
-	if (gid) {
-		NSDictionary *properties = [self.tileMap propertiesForGID:gid];
-		if (properties[@"cost"]) {
-			cost = [properties[@"cost"] integerValue];
-		}
-	}
-	
-	return cost;
-}
-
 @end
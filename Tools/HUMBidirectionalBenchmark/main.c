@@ -0,0 +1,197 @@
+//
+//  main.c
+//  HUMBidirectionalBenchmark
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Runs the same queries through unidirectional and bidirectional A*, checks that both find paths of the same cost, and reports how long
+//  each took and how many tiles each sampled. Every query runs from the top rows of the map to the bottom rows, on maps of random
+//  obstacles with large and unit tile costs and on a map of serpentine corridors.
+//
+//  Build from the root of the repository with:
+//
+//	cc -std=gnu99 -O2 -IHUMAStarPathfinder Tools/HUMBidirectionalBenchmark/main.c HUMAStarPathfinder/HUMAStarPathfinderSearch.c -lm -o humbidibench
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "HUMAStarPathfinderSearch.h"
+
+#define HUMBidirectionalBenchmarkEdgeRows 16
+
+typedef struct {
+	int32_t width;
+	const uint8_t *walkable;
+	uint32_t cost;
+	int64_t samples;
+} HUMBidirectionalBenchmarkMap;
+
+typedef struct {
+	const char *name;
+	bool corridors;
+	uint32_t cost;
+	HUMSearchNeighbors neighbors;
+} HUMBidirectionalBenchmarkCase;
+
+static double HUMBidirectionalBenchmarkNow(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/**
+ *	The sample function of both searches. Every walkable tile costs the map's cost, and every call is counted.
+ */
+static void HUMBidirectionalBenchmarkSampleTile(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost) {
+	HUMBidirectionalBenchmarkMap *map = info;
+
+	map->samples++;
+	*walkable = map->walkable[y * map->width + x] != 0;
+	*cost = map->cost;
+}
+
+/**
+ *	Fills a map with either scattered single-tile obstacles covering 30% of its tiles, or a wall every 8 rows whose only gap alternates
+ *	between the left and right ends, so the path between the top and bottom of the map winds across its whole width.
+ */
+static void HUMBidirectionalBenchmarkGenerateMap(uint8_t *walkable, int32_t width, int32_t height, bool corridors) {
+	memset(walkable, 1, (size_t)width * height);
+
+	if (corridors) {
+		for (int32_t y = 8; y < height; y += 8) {
+			int32_t gap = (y / 8) % 2 ? width - 3 : 1;
+
+			memset(&walkable[y * width], 0, width);
+			walkable[y * width + gap] = 1;
+			walkable[y * width + gap + 1] = 1;
+		}
+	}
+	else {
+		for (size_t i = 0; i < (size_t)width * height; i++) {
+			walkable[i] = rand() % 100 >= 30;
+		}
+	}
+}
+
+static void HUMBidirectionalBenchmarkPrintUsage(void) {
+	fprintf(stderr,
+			"usage: humbidibench [options]\n"
+			"\n"
+			"  --size WIDTHxHEIGHT  the size of the maps. Defaults to 512x512.\n"
+			"  --queries COUNT      the number of queries per map. Defaults to 20.\n"
+			"  --seed SEED          the seed of the maps and the queries. Defaults to 1.\n");
+}
+
+int main(int argc, const char * argv[]) {
+	int32_t width = 512;
+	int32_t height = 512;
+	int32_t queryCount = 20;
+	unsigned int seed = 1;
+
+	for (int i = 1; i < argc; i++) {
+		const char *argument = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (strcmp(argument, "--size") == 0 && value && sscanf(value, "%dx%d", &width, &height) == 2 && width >= 8 && height >= 2 * HUMBidirectionalBenchmarkEdgeRows) {
+		}
+		else if (strcmp(argument, "--queries") == 0 && value && sscanf(value, "%d", &queryCount) == 1 && queryCount > 0) {
+		}
+		else if (strcmp(argument, "--seed") == 0 && value && sscanf(value, "%u", &seed) == 1) {
+		}
+		else {
+			HUMBidirectionalBenchmarkPrintUsage();
+			return 1;
+		}
+
+		i++;
+	}
+
+	const HUMBidirectionalBenchmarkCase cases[] = {
+		{ "30% obstacles, cost 10", false, 10, HUMSearchNeighborsCardinal },
+		{ "30% obstacles, cost 10", false, 10, HUMSearchNeighborsDiagonalStrict },
+		{ "serpentine corridors", true, 10, HUMSearchNeighborsCardinal },
+		{ "30% obstacles, cost 1", false, 1, HUMSearchNeighborsCardinal },
+	};
+	const char *neighborNames[] = { "cardinal", "diagonal", "cross-borders", "strict" };
+
+	uint8_t *walkable = malloc((size_t)width * height);
+	int32_t *queries = malloc(4 * (size_t)queryCount * sizeof(int32_t));
+	HUMSearchContext *search = HUMSearchContextCreate(width, height, HUMSearchLayoutRowMajor);
+
+	if (!walkable || !queries || !search) {
+		fprintf(stderr, "humbidibench: out of memory\n");
+		return 1;
+	}
+
+	printf("%d x %d maps, %d queries each, milliseconds and tiles sampled per query\n\n", width, height, queryCount);
+	printf("%-24s %-9s %22s %22s\n", "map", "rules", "unidirectional", "bidirectional");
+
+	int32_t mismatches = 0;
+
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		const HUMBidirectionalBenchmarkCase *benchmarkCase = &cases[c];
+
+		srand(seed);
+		HUMBidirectionalBenchmarkGenerateMap(walkable, width, height, benchmarkCase->corridors);
+
+		for (int32_t i = 0; i < queryCount; i++) {
+			int32_t *query = &queries[4 * i];
+
+			query[0] = rand() % width;
+			query[1] = rand() % HUMBidirectionalBenchmarkEdgeRows;
+			query[2] = rand() % width;
+			query[3] = height - 1 - rand() % HUMBidirectionalBenchmarkEdgeRows;
+
+			walkable[query[1] * width + query[0]] = 1;
+			walkable[query[3] * width + query[2]] = 1;
+		}
+
+		HUMBidirectionalBenchmarkMap map = { width, walkable, benchmarkCase->cost, 0 };
+		uint32_t costs[2] = { 0, 0 };
+		double times[2] = { 0.0, 0.0 };
+		int64_t samples[2] = { 0, 0 };
+
+		for (int32_t i = 0; i < queryCount; i++) {
+			const int32_t *query = &queries[4 * i];
+
+			for (int bidirectional = 0; bidirectional < 2; bidirectional++) {
+				HUMSearchQuery searchQuery = { 0 };
+				searchQuery.startX = query[0];
+				searchQuery.startY = query[1];
+				searchQuery.targetX = query[2];
+				searchQuery.targetY = query[3];
+				searchQuery.neighbors = benchmarkCase->neighbors;
+				searchQuery.heuristic = HUMSearchHeuristicManhattan;
+				searchQuery.sample = HUMBidirectionalBenchmarkSampleTile;
+				searchQuery.info = &map;
+				searchQuery.bidirectional = bidirectional;
+
+				map.samples = 0;
+				HUMSearchContextReset(search);
+
+				double start = HUMBidirectionalBenchmarkNow();
+				costs[bidirectional] = HUMSearchFindPath(search, &searchQuery) ? search->pathCost : UINT32_MAX;
+				times[bidirectional] += HUMBidirectionalBenchmarkNow() - start;
+				samples[bidirectional] += map.samples;
+			}
+
+			if (costs[0] != costs[1]) {
+				mismatches++;
+			}
+		}
+
+		printf("%-24s %-9s %9.2f / %10.0f %9.2f / %10.0f\n", benchmarkCase->name, neighborNames[benchmarkCase->neighbors],
+			   times[0] * 1000.0 / queryCount, (double)samples[0] / queryCount, times[1] * 1000.0 / queryCount, (double)samples[1] / queryCount);
+	}
+
+	printf("\n%d queries found paths of a different cost\n", mismatches);
+
+	HUMSearchContextFree(search);
+	free(queries);
+	free(walkable);
+
+	return mismatches == 0 ? 0 : 2;
+}
@@ -0,0 +1,255 @@
+//
+//  main.c
+//  HUMBitSearchBenchmark
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Runs the same queries across a map through A* and through the bit-parallel breadth-first search with every expansion kernel this CPU
+//  supports, checks that every search finds paths of the same length and that every kernel finds the same tiles, and reports the time per
+//  query and the time to pack the map. The maps are 4096x4096 with 10% random obstacles and 1024x1024 with none, and every query runs from
+//  the left eighth of the map to the right eighth.
+//
+//  Build from the root of the repository with:
+//
+//	cc -std=gnu99 -O2 -IHUMAStarPathfinder Tools/HUMBitSearchBenchmark/main.c HUMAStarPathfinder/HUMAStarPathfinderBitSearch.c HUMAStarPathfinder/HUMAStarPathfinderSearch.c -lm -o humbitsearchbench
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "HUMAStarPathfinderBitSearch.h"
+#include "HUMAStarPathfinderSearch.h"
+
+#define HUMBitSearchBenchmarkCost 10
+
+typedef struct {
+	int32_t width;
+	const uint8_t *walkable;
+} HUMBitSearchBenchmarkMap;
+
+typedef struct {
+	const char *name;
+	int32_t size;
+	int32_t blockedPercent;
+} HUMBitSearchBenchmarkCase;
+
+static double HUMBitSearchBenchmarkNow(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+static void HUMBitSearchBenchmarkSampleTile(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost) {
+	const HUMBitSearchBenchmarkMap *map = info;
+
+	*walkable = map->walkable[y * map->width + x] != 0;
+	*cost = HUMBitSearchBenchmarkCost;
+}
+
+/**
+ *	Determines if a kernel can run on this CPU. A kernel that wasn't compiled in falls back to the scalar one, so only the best instruction set
+ *  and the ones it extends are timed.
+ */
+static bool HUMBitSearchBenchmarkIsSupported(HUMBitSearchInstructionSet instructionSet) {
+	HUMBitSearchInstructionSet best = HUMBitSearchBestInstructionSet();
+
+	switch (instructionSet) {
+		case HUMBitSearchInstructionSetScalar:
+			return true;
+		case HUMBitSearchInstructionSetSSE2:
+			return best == HUMBitSearchInstructionSetSSE2 || best == HUMBitSearchInstructionSetAVX2;
+		default:
+			return best == instructionSet;
+	}
+}
+
+static void HUMBitSearchBenchmarkPrintUsage(void) {
+	fprintf(stderr,
+			"usage: humbitsearchbench [options]\n"
+			"\n"
+			"  --queries COUNT  the number of queries per map. Defaults to 5.\n"
+			"  --seed SEED      the seed of the maps and the queries. Defaults to 1.\n");
+}
+
+int main(int argc, const char * argv[]) {
+	int32_t queryCount = 5;
+	unsigned int seed = 1;
+
+	for (int i = 1; i < argc; i++) {
+		const char *argument = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (strcmp(argument, "--queries") == 0 && value && sscanf(value, "%d", &queryCount) == 1 && queryCount > 0) {
+		}
+		else if (strcmp(argument, "--seed") == 0 && value && sscanf(value, "%u", &seed) == 1) {
+		}
+		else {
+			HUMBitSearchBenchmarkPrintUsage();
+			return 1;
+		}
+
+		i++;
+	}
+
+	const HUMBitSearchBenchmarkCase cases[] = {
+		{ "4096^2, 10% blocked", 4096, 10 },
+		{ "1024^2, open", 1024, 0 },
+	};
+	const char *instructionSetNames[] = { "scalar", "SSE2", "AVX2", "NEON" };
+
+	int32_t *queries = malloc(4 * (size_t)queryCount * sizeof(int32_t));
+	int32_t *distances = malloc((size_t)queryCount * sizeof(int32_t));
+
+	if (!queries || !distances) {
+		fprintf(stderr, "humbitsearchbench: out of memory\n");
+		return 1;
+	}
+
+	printf("%d queries per map, milliseconds per query\n\n", queryCount);
+	printf("%-22s %10s", "", "A*");
+
+	for (int set = 0; set < HUMBitSearchInstructionSetCount; set++) {
+		if (HUMBitSearchBenchmarkIsSupported((HUMBitSearchInstructionSet)set)) {
+			printf(" %10s", instructionSetNames[set]);
+		}
+	}
+
+	printf(" %10s\n", "packing");
+
+	int32_t mismatches = 0;
+
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		const HUMBitSearchBenchmarkCase *benchmarkCase = &cases[c];
+		int32_t size = benchmarkCase->size;
+		size_t tileCount = (size_t)size * size;
+		uint8_t *walkable = malloc(tileCount);
+		int32_t *pathXs = malloc(tileCount * sizeof(int32_t));
+		int32_t *pathYs = malloc(tileCount * sizeof(int32_t));
+		HUMSearchContext *search = HUMSearchContextCreate(size, size, HUMSearchLayoutRowMajor);
+
+		if (!walkable || !pathXs || !pathYs || !search) {
+			fprintf(stderr, "humbitsearchbench: out of memory\n");
+			return 1;
+		}
+
+		srand(seed);
+
+		for (size_t i = 0; i < tileCount; i++) {
+			walkable[i] = rand() % 100 >= benchmarkCase->blockedPercent;
+		}
+
+		for (int32_t i = 0; i < queryCount; i++) {
+			int32_t *query = &queries[4 * i];
+
+			query[0] = rand() % (size / 8);
+			query[1] = rand() % size;
+			query[2] = size - 1 - rand() % (size / 8);
+			query[3] = rand() % size;
+
+			walkable[query[1] * size + query[0]] = 1;
+			walkable[query[3] * size + query[2]] = 1;
+		}
+
+		HUMBitSearchBenchmarkMap map = { size, walkable };
+		double start = HUMBitSearchBenchmarkNow();
+
+		for (int32_t i = 0; i < queryCount; i++) {
+			const int32_t *query = &queries[4 * i];
+
+			HUMSearchQuery searchQuery = { 0 };
+			searchQuery.startX = query[0];
+			searchQuery.startY = query[1];
+			searchQuery.targetX = query[2];
+			searchQuery.targetY = query[3];
+			searchQuery.neighbors = HUMSearchNeighborsCardinal;
+			searchQuery.heuristic = HUMSearchHeuristicManhattan;
+			searchQuery.sample = HUMBitSearchBenchmarkSampleTile;
+			searchQuery.info = &map;
+
+			HUMSearchContextReset(search);
+			distances[i] = HUMSearchFindPath(search, &searchQuery) ? (int32_t)(search->pathCost / HUMBitSearchBenchmarkCost) : -1;
+		}
+
+		printf("%-22s %7.1f ms", benchmarkCase->name, (HUMBitSearchBenchmarkNow() - start) * 1000.0 / queryCount);
+
+		double packTime = 0.0;
+		uint64_t *referenceChecksums = calloc((size_t)queryCount, sizeof(uint64_t));
+		bool hasReference = false;
+
+		if (!referenceChecksums) {
+			fprintf(stderr, "humbitsearchbench: out of memory\n");
+			return 1;
+		}
+
+		for (int set = 0; set < HUMBitSearchInstructionSetCount; set++) {
+			if (!HUMBitSearchBenchmarkIsSupported((HUMBitSearchInstructionSet)set)) {
+				continue;
+			}
+
+			HUMBitSearchContext *bitSearch = HUMBitSearchContextCreate(size, size);
+
+			if (!bitSearch) {
+				fprintf(stderr, "humbitsearchbench: out of memory\n");
+				return 1;
+			}
+
+			bitSearch->instructionSet = (HUMBitSearchInstructionSet)set;
+
+			// the map's walkability doubles as a clearance map for units one tile wide
+			double packStart = HUMBitSearchBenchmarkNow();
+			HUMBitSearchLoadClearance(bitSearch, walkable, 1);
+			packTime = HUMBitSearchBenchmarkNow() - packStart;
+
+			double searchTime = 0.0;
+
+			for (int32_t i = 0; i < queryCount; i++) {
+				const int32_t *query = &queries[4 * i];
+
+				start = HUMBitSearchBenchmarkNow();
+				bool found = HUMBitSearchFindPath(bitSearch, query[0], query[1], query[2], query[3]);
+				int32_t length = found ? HUMBitSearchCopyPath(bitSearch, pathXs, pathYs, (int32_t)tileCount) : 0;
+				searchTime += HUMBitSearchBenchmarkNow() - start;
+
+				if ((found ? bitSearch->distance : -1) != distances[i]) {
+					mismatches++;
+				}
+
+				// the kernels are compared by a checksum of the tiles of each path, so the scalar paths don't all have to be kept
+				uint64_t checksum = (uint64_t)length;
+
+				for (int32_t j = 0; j < length; j++) {
+					checksum = checksum * 1099511628211ULL + ((uint64_t)pathYs[j] * (uint64_t)size + (uint64_t)pathXs[j]);
+				}
+
+				if (!hasReference) {
+					referenceChecksums[i] = checksum;
+				}
+				else if (checksum != referenceChecksums[i]) {
+					mismatches++;
+				}
+			}
+
+			hasReference = true;
+			printf(" %7.1f ms", searchTime * 1000.0 / queryCount);
+
+			HUMBitSearchContextFree(bitSearch);
+		}
+
+		printf(" %7.1f ms\n", packTime * 1000.0);
+
+		free(referenceChecksums);
+		HUMSearchContextFree(search);
+		free(pathYs);
+		free(pathXs);
+		free(walkable);
+	}
+
+	printf("\n%d searches found paths of a different length than A*, or other tiles than the scalar kernel\n", mismatches);
+
+	free(distances);
+	free(queries);
+
+	return mismatches == 0 ? 0 : 2;
+}
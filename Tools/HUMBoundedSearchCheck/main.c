@@ -0,0 +1,263 @@
+//
+//  main.c
+//  HUMBoundedSearchCheck
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Checks the bounded memory search against plain A*. Each case runs a set of queries on a generated map through both, and fails if the
+//  bounded search doesn't return a path of the same cost, doesn't report NoPath when A* finds none, or takes longer than the case allows.
+//  The cases cover open and obstructed maps far larger than the memory limit, which the search can only finish with iterative deepening,
+//  and unreachable targets under the smallest limits. Exits with 1 if any case fails.
+//
+//  Build from the root of the repository with:
+//
+//	cc -std=gnu99 -O2 -IHUMAStarPathfinder Tools/HUMBoundedSearchCheck/main.c HUMAStarPathfinder/HUMAStarPathfinderSearch.c HUMAStarPathfinder/HUMAStarPathfinderBoundedSearch.c -lm -o humboundedcheck
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "HUMAStarPathfinderBoundedSearch.h"
+#include "HUMAStarPathfinderSearch.h"
+
+#define HUMBoundedSearchCheckCost 10
+
+typedef struct {
+	int32_t width;
+	int32_t height;
+	uint8_t *walkable;
+	uint32_t *costs;
+} HUMBoundedSearchCheckMap;
+
+typedef enum {
+	HUMBoundedSearchCheckWallNone = 0,
+	HUMBoundedSearchCheckWallTarget,		// the target is surrounded, so a search has to reach every tile it can before giving up
+	HUMBoundedSearchCheckWallStart			// the start is shut in a small room
+} HUMBoundedSearchCheckWall;
+
+typedef struct {
+	const char *name;
+	int32_t width;
+	int32_t height;
+	int32_t blockedPercent;		// of the tiles, blocked at random
+	int32_t maximumCost;		// tile costs are drawn between HUMBoundedSearchCheckCost and this
+	HUMBoundedSearchCheckWall wall;
+	HUMSearchNeighbors neighbors;
+	size_t memoryLimit;
+	uint64_t expansionLimit;	// 0 for the default. If set, every query is expected to stop at it.
+	int32_t queryDistance;		// the furthest a random query's target is from its start along either axis, or 0 for anywhere
+	int32_t queryCount;			// random queries, after one from corner to corner if queryDistance is 0
+	double timeLimit;			// seconds all the case's bounded searches may take together
+} HUMBoundedSearchCheckCase;
+
+static const HUMBoundedSearchCheckCase HUMBoundedSearchCheckCases[] = {
+	// the direction map fits, but not the fringe
+	{ "open 256x256, 256 KB", 256, 256, 0, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallNone, HUMSearchNeighborsDiagonal, 256 * 1024, 0, 0, 8, 1 },
+	{ "open 256x256 cardinal, 256 KB", 256, 256, 0, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallNone, HUMSearchNeighborsCardinal, 256 * 1024, 0, 0, 8, 1 },
+	{ "open 512x512, 256 KB", 512, 512, 0, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallNone, HUMSearchNeighborsDiagonal, 256 * 1024, 0, 0, 8, 2 },
+	{ "30% blocked 128x128, 256 KB", 128, 128, 30, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallNone, HUMSearchNeighborsDiagonalStrict, 256 * 1024, 0, 0, 16, 1 },
+	{ "20% blocked 96x96 weighted, 16 KB", 96, 96, 20, 3 * HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallNone, HUMSearchNeighborsDiagonalCrossBorders, 16 * 1024, 0, 0, 16, 1 },
+	{ "unreachable 28x28, 8 KB", 28, 28, 0, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallTarget, HUMSearchNeighborsDiagonal, 8 * 1024, 0, 0, 4, 1 },
+	{ "unreachable 128x128, 256 KB", 128, 128, 10, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallTarget, HUMSearchNeighborsDiagonalStrict, 256 * 1024, 0, 0, 4, 1 },
+
+	// only iterative deepening fits
+	{ "open 200x200, 8 KB", 200, 200, 0, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallNone, HUMSearchNeighborsDiagonal, 8 * 1024, 0, 12, 32, 10 },
+	{ "15% blocked 200x200, 8 KB", 200, 200, 15, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallNone, HUMSearchNeighborsDiagonalCrossBorders, 8 * 1024, 0, 12, 32, 10 },
+	{ "10% blocked 64x64 weighted, minimum limit", 64, 64, 10, 3 * HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallNone, HUMSearchNeighborsCardinal, HUMBoundedSearchMinimumMemoryLimit, 0, 6, 32, 10 },
+	{ "start shut in 200x200, 8 KB", 200, 200, 0, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallStart, HUMSearchNeighborsDiagonal, 8 * 1024, 0, 30, 8, 10 },
+	{ "open 200x200 corners, 8 KB, 1M expansions", 200, 200, 0, HUMBoundedSearchCheckCost, HUMBoundedSearchCheckWallNone, HUMSearchNeighborsDiagonal, 8 * 1024, 1 << 20, 0, 0, 2 }
+};
+
+static uint32_t HUMBoundedSearchCheckSeed = 1;
+
+static int32_t HUMBoundedSearchCheckRandom(int32_t count) {
+	HUMBoundedSearchCheckSeed = HUMBoundedSearchCheckSeed * 1103515245 + 12345;
+	return (int32_t)((HUMBoundedSearchCheckSeed >> 8) % (uint32_t)count);
+}
+
+static double HUMBoundedSearchCheckNow(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void HUMBoundedSearchCheckSampleTile(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost) {
+	const HUMBoundedSearchCheckMap *map = info;
+	*walkable = map->walkable[y * map->width + x];
+	*cost = map->costs[y * map->width + x];
+}
+
+static void HUMBoundedSearchCheckBuildMap(const HUMBoundedSearchCheckCase *check, HUMBoundedSearchCheckMap *map) {
+	for (int32_t i = 0; i < map->width * map->height; i++) {
+		map->walkable[i] = HUMBoundedSearchCheckRandom(100) >= check->blockedPercent;
+		map->costs[i] = HUMBoundedSearchCheckCost + HUMBoundedSearchCheckRandom(check->maximumCost - HUMBoundedSearchCheckCost + 1);
+	}
+
+	// the corners stay walkable for the first query
+	map->walkable[0] = 1;
+	map->walkable[map->width * map->height - 1] = 1;
+}
+
+/**
+ *	Clears the tiles within radius of a tile, and blocks the ring around them.
+ */
+static void HUMBoundedSearchCheckBuildRoom(HUMBoundedSearchCheckMap *map, int32_t centerX, int32_t centerY, int32_t radius) {
+	for (int32_t y = centerY - radius - 1; y <= centerY + radius + 1; y++) {
+		for (int32_t x = centerX - radius - 1; x <= centerX + radius + 1; x++) {
+			if (x >= 0 && y >= 0 && x < map->width && y < map->height) {
+				map->walkable[y * map->width + x] = (abs(x - centerX) <= radius && abs(y - centerY) <= radius);
+			}
+		}
+	}
+}
+
+/**
+ *	Runs a case's queries through A* and the bounded search.
+ *
+ *	@return	The number of queries the bounded search got wrong, or counting the time limit, one more if it ran out of time.
+ */
+static int32_t HUMBoundedSearchCheckRunCase(const HUMBoundedSearchCheckCase *check) {
+	HUMBoundedSearchCheckMap map = { check->width, check->height, NULL, NULL };
+	map.walkable = malloc((size_t)check->width * (size_t)check->height);
+	map.costs = malloc((size_t)check->width * (size_t)check->height * sizeof(uint32_t));
+	HUMSearchContext *search = HUMSearchContextCreate(check->width, check->height, HUMSearchLayoutRowMajor);
+
+	if (!map.walkable || !map.costs || !search) {
+		fprintf(stderr, "humboundedcheck: out of memory\n");
+		exit(1);
+	}
+
+	HUMBoundedSearchCheckBuildMap(check, &map);
+
+	int32_t failures = 0;
+	int32_t iterativeDeepeningCount = 0;
+	uint64_t expandedCount = 0;
+	double boundedTime = 0;
+
+	const int32_t firstQuery = check->queryDistance > 0 ? 1 : 0;
+
+	for (int32_t i = firstQuery; i <= check->queryCount; i++) {
+		int32_t startX = 0;
+		int32_t startY = 0;
+		int32_t targetX = check->width - 1;
+		int32_t targetY = check->height - 1;
+
+		while (i > 0) {
+			startX = HUMBoundedSearchCheckRandom(check->width);
+			startY = HUMBoundedSearchCheckRandom(check->height);
+
+			if (check->queryDistance > 0) {
+				targetX = startX + HUMBoundedSearchCheckRandom(2 * check->queryDistance + 1) - check->queryDistance;
+				targetY = startY + HUMBoundedSearchCheckRandom(2 * check->queryDistance + 1) - check->queryDistance;
+			}
+			else {
+				targetX = HUMBoundedSearchCheckRandom(check->width);
+				targetY = HUMBoundedSearchCheckRandom(check->height);
+			}
+
+			if (targetX >= 0 && targetY >= 0 && targetX < check->width && targetY < check->height && map.walkable[targetY * check->width + targetX] && (startX != targetX || startY != targetY)) {
+				break;
+			}
+		}
+
+		if (check->wall == HUMBoundedSearchCheckWallTarget) {
+			HUMBoundedSearchCheckBuildMap(check, &map);
+			HUMBoundedSearchCheckBuildRoom(&map, targetX, targetY, 0);
+			map.walkable[startY * check->width + startX] = 1;
+		}
+		else if (check->wall == HUMBoundedSearchCheckWallStart) {
+			HUMBoundedSearchCheckBuildMap(check, &map);
+			HUMBoundedSearchCheckBuildRoom(&map, startX, startY, 8);
+			map.walkable[targetY * check->width + targetX] = 1;
+		}
+
+		HUMSearchQuery searchQuery = { 0 };
+		searchQuery.startX = startX;
+		searchQuery.startY = startY;
+		searchQuery.targetX = targetX;
+		searchQuery.targetY = targetY;
+		searchQuery.neighbors = check->neighbors;
+		searchQuery.heuristic = HUMSearchHeuristicManhattan;
+		searchQuery.sample = HUMBoundedSearchCheckSampleTile;
+		searchQuery.info = &map;
+
+		HUMSearchContextReset(search);
+		bool found = HUMSearchFindPath(search, &searchQuery);
+
+		HUMBoundedSearchQuery boundedQuery = { 0 };
+		boundedQuery.width = check->width;
+		boundedQuery.height = check->height;
+		boundedQuery.startX = startX;
+		boundedQuery.startY = startY;
+		boundedQuery.targetX = targetX;
+		boundedQuery.targetY = targetY;
+		boundedQuery.neighbors = check->neighbors;
+		boundedQuery.heuristic = HUMSearchHeuristicManhattan;
+		boundedQuery.sample = HUMBoundedSearchCheckSampleTile;
+		boundedQuery.info = &map;
+		boundedQuery.memoryLimit = check->memoryLimit;
+		boundedQuery.expansionLimit = check->expansionLimit;
+
+		double start = HUMBoundedSearchCheckNow();
+		HUMBoundedSearchResult result;
+		HUMBoundedSearchFindPath(&boundedQuery, &result);
+		boundedTime += HUMBoundedSearchCheckNow() - start;
+
+		iterativeDeepeningCount += result.iterativeDeepening ? 1 : 0;
+		expandedCount += result.expandedCount;
+
+		bool correct = found ? (result.status == HUMBoundedSearchStatusFound && result.cost == search->pathCost) : (result.status == HUMBoundedSearchStatusNoPath);
+
+		if (check->expansionLimit > 0) {
+			correct = (result.status == HUMBoundedSearchStatusExpansionLimit && result.expandedCount == check->expansionLimit);
+		}
+
+		if (correct && result.status == HUMBoundedSearchStatusFound) {
+			// the path has to be connected and charge what it claims
+			uint32_t cost = 0;
+
+			for (int32_t j = 1; j < result.count && correct; j++) {
+				int32_t dx = abs(result.xs[j] - result.xs[j - 1]);
+				int32_t dy = abs(result.ys[j] - result.ys[j - 1]);
+				uint32_t tileCost = map.costs[result.ys[j] * check->width + result.xs[j]];
+
+				correct = (dx <= 1 && dy <= 1 && dx + dy > 0) && map.walkable[result.ys[j] * check->width + result.xs[j]];
+				cost += (dx + dy == 2) ? HUMSearchDiagonalCost(tileCost) : tileCost;
+			}
+
+			correct = correct && cost == result.cost && result.xs[0] == startX && result.ys[0] == startY && result.xs[result.count - 1] == targetX && result.ys[result.count - 1] == targetY;
+		}
+
+		if (!correct) {
+			fprintf(stderr, "  (%d, %d) to (%d, %d): A* %s %u, bounded search status %d cost %u\n", startX, startY, targetX, targetY, found ? "found" : "no path", found ? search->pathCost : 0, result.status, result.cost);
+			failures++;
+		}
+
+		HUMBoundedSearchResultFree(&result);
+	}
+
+	bool late = boundedTime > check->timeLimit;
+	printf("%-44s %s  %d of %d queries by iterative deepening, %llu expanded, %.3f s%s\n", check->name, (failures == 0 && !late) ? "ok  " : "FAIL", iterativeDeepeningCount, check->queryCount + 1 - firstQuery, (unsigned long long)expandedCount, boundedTime, late ? " (over the time limit)" : "");
+
+	HUMSearchContextFree(search);
+	free(map.walkable);
+	free(map.costs);
+
+	return failures + (late ? 1 : 0);
+}
+
+int main(int argc, const char *argv[]) {
+	(void)argc;
+	(void)argv;
+
+	int32_t failures = 0;
+
+	for (size_t i = 0; i < sizeof(HUMBoundedSearchCheckCases) / sizeof(HUMBoundedSearchCheckCases[0]); i++) {
+		failures += HUMBoundedSearchCheckRunCase(&HUMBoundedSearchCheckCases[i]);
+	}
+
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,325 @@
+//
+//  main.c
+//  HUMFlowFieldCheck
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Checks the parallel block flow field solver against HUMFlowFieldSolveSequential on random maps of every size up to 90x90, with every
+//  movement rule and with blocks run both on the calling thread and on a pool of threads. The integration and direction fields must be
+//  identical, a few tiles of each map are checked against an A* search to the target, and following the directions from those tiles must
+//  reach the target for exactly the integrated cost. Then it times both solvers on a large map.
+//
+//  Build from the root of the repository with:
+//
+//	cc -std=gnu99 -O2 -IHUMAStarPathfinder Tools/HUMFlowFieldCheck/main.c HUMAStarPathfinder/HUMAStarPathfinderFlowFieldSolver.c HUMAStarPathfinder/HUMAStarPathfinderSearch.c -lm -lpthread -o humflowcheck
+//
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "HUMAStarPathfinderFlowFieldSolver.h"
+
+#define HUMFlowFieldCheckMaximumThreads 64
+
+typedef struct {
+	int32_t width;
+	const uint8_t *walkable;
+	const uint32_t *costs;
+} HUMFlowFieldCheckMap;
+
+typedef struct {
+	size_t iterations;
+	void *context;
+	void (*work)(void *context, size_t iteration);
+	size_t next;
+	pthread_mutex_t lock;
+} HUMFlowFieldCheckJob;
+
+static double HUMFlowFieldCheckNow(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+#pragma mark - Apply
+
+static void *HUMFlowFieldCheckRunJob(void *argument) {
+	HUMFlowFieldCheckJob *job = argument;
+
+	while (true) {
+		pthread_mutex_lock(&job->lock);
+		size_t iteration = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if (iteration >= job->iterations) {
+			return NULL;
+		}
+
+		job->work(job->context, iteration);
+	}
+}
+
+/**
+ *	Stands in for dispatch_apply_f: info points to the number of threads, which take iterations in order until none are left.
+ */
+static void HUMFlowFieldCheckApply(void *info, size_t iterations, void *context, void (*work)(void *context, size_t iteration)) {
+	int threadCount = *(const int *)info;
+	HUMFlowFieldCheckJob job = { iterations, context, work, 0, PTHREAD_MUTEX_INITIALIZER };
+	pthread_t threads[HUMFlowFieldCheckMaximumThreads];
+
+	for (int i = 0; i < threadCount; i++) {
+		pthread_create(&threads[i], NULL, HUMFlowFieldCheckRunJob, &job);
+	}
+
+	for (int i = 0; i < threadCount; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	pthread_mutex_destroy(&job.lock);
+}
+
+#pragma mark - Checks
+
+static void HUMFlowFieldCheckSampleTile(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost) {
+	const HUMFlowFieldCheckMap *map = info;
+
+	*walkable = map->walkable[y * map->width + x] != 0;
+	*cost = map->costs[y * map->width + x];
+}
+
+/**
+ *	Solves one random map both ways and checks a few of its tiles against A*.
+ *
+ *	@return	the number of failed checks.
+ */
+static int HUMFlowFieldCheckRandomMap(int iteration, int *threadCount) {
+	int32_t width = 1 + rand() % 90;
+	int32_t height = 1 + rand() % 90;
+	size_t tileCount = (size_t)width * height;
+	uint8_t *walkable = malloc(tileCount);
+	uint32_t *costs = malloc(tileCount * sizeof(uint32_t));
+	uint32_t *sequentialIntegration = malloc(tileCount * sizeof(uint32_t));
+	uint32_t *integration = malloc(tileCount * sizeof(uint32_t));
+	int8_t *sequentialDirections = malloc(tileCount);
+	int8_t *directions = malloc(tileCount);
+	HUMSearchContext *search = HUMSearchContextCreate(width, height, HUMSearchLayoutRowMajor);
+
+	if (!walkable || !costs || !sequentialIntegration || !integration || !sequentialDirections || !directions || !search) {
+		fprintf(stderr, "humflowcheck: out of memory\n");
+		exit(1);
+	}
+
+	for (size_t i = 0; i < tileCount; i++) {
+		walkable[i] = rand() % 100 >= 30;
+		costs[i] = 1 + rand() % 20;
+	}
+
+	HUMFlowFieldQuery query = { 0 };
+	query.width = width;
+	query.height = height;
+	query.walkable = walkable;
+	query.costs = costs;
+	query.neighbors = (HUMSearchNeighbors)(rand() % HUMSearchNeighborsCount);
+	query.targetX = rand() % width;
+	query.targetY = rand() % height;
+
+	// a quarter of the targets are left unwalkable
+	if (rand() % 4) {
+		walkable[query.targetY * width + query.targetX] = 1;
+	}
+
+	if (rand() % 2) {
+		query.apply = HUMFlowFieldCheckApply;
+		query.applyInfo = threadCount;
+	}
+
+	int failures = 0;
+
+	if (!HUMFlowFieldSolveSequential(&query, sequentialIntegration, sequentialDirections) || !HUMFlowFieldSolve(&query, integration, directions)) {
+		fprintf(stderr, "humflowcheck: out of memory\n");
+		exit(1);
+	}
+
+	if (memcmp(sequentialIntegration, integration, tileCount * sizeof(uint32_t)) != 0 || memcmp(sequentialDirections, directions, tileCount) != 0) {
+		printf("map %d (%d x %d): the block solver's fields differ from the sequential solver's\n", iteration, width, height);
+		failures++;
+	}
+
+	HUMFlowFieldCheckMap map = { width, walkable, costs };
+
+	for (int k = 0; k < 5; k++) {
+		int32_t x = rand() % width;
+		int32_t y = rand() % height;
+
+		if (x == query.targetX && y == query.targetY) {
+			continue;
+		}
+
+		HUMSearchQuery searchQuery = { 0 };
+		searchQuery.startX = x;
+		searchQuery.startY = y;
+		searchQuery.targetX = query.targetX;
+		searchQuery.targetY = query.targetY;
+		searchQuery.neighbors = query.neighbors;
+		searchQuery.heuristic = HUMSearchHeuristicNone;
+		searchQuery.sample = HUMFlowFieldCheckSampleTile;
+		searchQuery.info = &map;
+
+		HUMSearchContextReset(search);
+
+		uint32_t value = integration[y * width + x];
+		uint32_t searchCost = HUMSearchFindPath(search, &searchQuery) ? search->pathCost : UINT32_MAX;
+
+		if (searchCost != value) {
+			printf("map %d (%d x %d): tile %d,%d integrates to %u but A* costs %u\n", iteration, width, height, x, y, value, searchCost);
+			failures++;
+		}
+
+		if (value == UINT32_MAX) {
+			continue;
+		}
+
+		uint64_t walkedCost = 0;
+		size_t steps = 0;
+
+		while ((x != query.targetX || y != query.targetY) && steps++ < tileCount) {
+			int8_t direction = directions[y * width + x];
+
+			if (direction == HUMFlowFieldDirectionNone) {
+				break;
+			}
+
+			x += HUMFlowFieldDirectionX[direction];
+			y += HUMFlowFieldDirectionY[direction];
+			walkedCost += direction < 4 ? costs[y * width + x] : HUMSearchDiagonalCost(costs[y * width + x]);
+		}
+
+		if (x != query.targetX || y != query.targetY || walkedCost != value) {
+			printf("map %d (%d x %d): following the directions costs %llu instead of %u\n", iteration, width, height, (unsigned long long)walkedCost, value);
+			failures++;
+		}
+	}
+
+	HUMSearchContextFree(search);
+	free(directions);
+	free(sequentialDirections);
+	free(integration);
+	free(sequentialIntegration);
+	free(costs);
+	free(walkable);
+
+	return failures;
+}
+
+static void HUMFlowFieldCheckPrintUsage(void) {
+	fprintf(stderr,
+			"usage: humflowcheck [options]\n"
+			"\n"
+			"  --maps COUNT         the number of random maps to check. Defaults to 300.\n"
+			"  --size WIDTHxHEIGHT  the size of the timed map. Defaults to 1024x1024.\n"
+			"  --threads COUNT      the number of threads blocks run on. Defaults to 4.\n"
+			"  --seed SEED          the seed of the maps. Defaults to 1.\n");
+}
+
+int main(int argc, const char * argv[]) {
+	int mapCount = 300;
+	int32_t width = 1024;
+	int32_t height = 1024;
+	int threadCount = 4;
+	unsigned int seed = 1;
+
+	for (int i = 1; i < argc; i++) {
+		const char *argument = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (strcmp(argument, "--maps") == 0 && value && sscanf(value, "%d", &mapCount) == 1 && mapCount >= 0) {
+		}
+		else if (strcmp(argument, "--size") == 0 && value && sscanf(value, "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+		}
+		else if (strcmp(argument, "--threads") == 0 && value && sscanf(value, "%d", &threadCount) == 1 && threadCount > 0 && threadCount <= HUMFlowFieldCheckMaximumThreads) {
+		}
+		else if (strcmp(argument, "--seed") == 0 && value && sscanf(value, "%u", &seed) == 1) {
+		}
+		else {
+			HUMFlowFieldCheckPrintUsage();
+			return 1;
+		}
+
+		i++;
+	}
+
+	srand(seed);
+
+	int failures = 0;
+
+	for (int i = 0; i < mapCount; i++) {
+		failures += HUMFlowFieldCheckRandomMap(i, &threadCount);
+	}
+
+	printf("%d random maps checked, %d failures\n", mapCount, failures);
+
+	size_t tileCount = (size_t)width * height;
+	uint8_t *walkable = malloc(tileCount);
+	uint32_t *costs = malloc(tileCount * sizeof(uint32_t));
+	uint32_t *sequentialIntegration = malloc(tileCount * sizeof(uint32_t));
+	uint32_t *integration = malloc(tileCount * sizeof(uint32_t));
+	int8_t *sequentialDirections = malloc(tileCount);
+	int8_t *directions = malloc(tileCount);
+
+	if (!walkable || !costs || !sequentialIntegration || !integration || !sequentialDirections || !directions) {
+		fprintf(stderr, "humflowcheck: out of memory\n");
+		return 1;
+	}
+
+	for (size_t i = 0; i < tileCount; i++) {
+		walkable[i] = rand() % 100 >= 20;
+		costs[i] = 10 + rand() % 5;
+	}
+
+	HUMFlowFieldQuery query = { 0 };
+	query.width = width;
+	query.height = height;
+	query.walkable = walkable;
+	query.costs = costs;
+	query.neighbors = HUMSearchNeighborsDiagonalStrict;
+	query.targetX = width / 2;
+	query.targetY = height / 2;
+	walkable[query.targetY * width + query.targetX] = 1;
+
+	double start = HUMFlowFieldCheckNow();
+	HUMFlowFieldSolveSequential(&query, sequentialIntegration, sequentialDirections);
+	double sequentialTime = HUMFlowFieldCheckNow() - start;
+
+	start = HUMFlowFieldCheckNow();
+	HUMFlowFieldSolve(&query, integration, directions);
+	double serialTime = HUMFlowFieldCheckNow() - start;
+
+	query.apply = HUMFlowFieldCheckApply;
+	query.applyInfo = &threadCount;
+
+	start = HUMFlowFieldCheckNow();
+	HUMFlowFieldSolve(&query, integration, directions);
+	double threadedTime = HUMFlowFieldCheckNow() - start;
+
+	if (memcmp(sequentialIntegration, integration, tileCount * sizeof(uint32_t)) != 0 || memcmp(sequentialDirections, directions, tileCount) != 0) {
+		printf("%d x %d map: the block solver's fields differ from the sequential solver's\n", width, height);
+		failures++;
+	}
+
+	printf("%d x %d map, 20%% obstacles\n", width, height);
+	printf("sequential Dijkstra   %.1f ms\n", sequentialTime * 1000.0);
+	printf("blocks, one thread    %.1f ms\n", serialTime * 1000.0);
+	printf("blocks, %2d threads    %.1f ms\n", threadCount, threadedTime * 1000.0);
+
+	free(directions);
+	free(sequentialDirections);
+	free(integration);
+	free(sequentialIntegration);
+	free(costs);
+	free(walkable);
+
+	return failures == 0 ? 0 : 2;
+}
@@ -0,0 +1,198 @@
+//
+//  main.c
+//  HUMLayoutBenchmark
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Runs the same queries from the left edge of a map to its right edge with the search state in each memory layout, checks that every
+//  layout finds paths of the same cost, and reports the best of a few runs for each. The maps are covered with 25% random obstacles, and
+//  are searched both with unit costs and A*, and with costs of 10 to 29 and no heuristic.
+//
+//  Build from the root of the repository with:
+//
+//	cc -std=gnu99 -O2 -IHUMAStarPathfinder Tools/HUMLayoutBenchmark/main.c HUMAStarPathfinder/HUMAStarPathfinderSearch.c -lm -o humlayoutbench
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "HUMAStarPathfinderSearch.h"
+
+#define HUMLayoutBenchmarkEdgeColumns 64
+
+typedef struct {
+	int32_t width;
+	const uint8_t *walkable;
+	const uint32_t *costs;
+} HUMLayoutBenchmarkMap;
+
+typedef struct {
+	const char *name;
+	int32_t size;
+	bool unitCost;
+	HUMSearchHeuristic heuristic;
+	HUMSearchNeighbors neighbors;
+} HUMLayoutBenchmarkCase;
+
+static double HUMLayoutBenchmarkNow(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+static void HUMLayoutBenchmarkSampleTile(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost) {
+	const HUMLayoutBenchmarkMap *map = info;
+
+	*walkable = map->walkable[y * map->width + x] != 0;
+	*cost = map->costs[y * map->width + x];
+}
+
+static void HUMLayoutBenchmarkPrintUsage(void) {
+	fprintf(stderr,
+			"usage: humlayoutbench [options]\n"
+			"\n"
+			"  --queries COUNT  the number of queries per map. Defaults to 12.\n"
+			"  --runs COUNT     the number of runs the best time is taken from. Defaults to 3.\n"
+			"  --seed SEED      the seed of the maps and the queries. Defaults to 1.\n");
+}
+
+int main(int argc, const char * argv[]) {
+	int32_t queryCount = 12;
+	int runCount = 3;
+	unsigned int seed = 1;
+
+	for (int i = 1; i < argc; i++) {
+		const char *argument = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (strcmp(argument, "--queries") == 0 && value && sscanf(value, "%d", &queryCount) == 1 && queryCount > 0) {
+		}
+		else if (strcmp(argument, "--runs") == 0 && value && sscanf(value, "%d", &runCount) == 1 && runCount > 0) {
+		}
+		else if (strcmp(argument, "--seed") == 0 && value && sscanf(value, "%u", &seed) == 1) {
+		}
+		else {
+			HUMLayoutBenchmarkPrintUsage();
+			return 1;
+		}
+
+		i++;
+	}
+
+	const HUMLayoutBenchmarkCase cases[] = {
+		{ "4096^2, unit cost A*, strict", 4096, true, HUMSearchHeuristicManhattan, HUMSearchNeighborsDiagonalStrict },
+		{ "4096^2, cost 10-29, Dijkstra", 4096, false, HUMSearchHeuristicNone, HUMSearchNeighborsCardinal },
+		{ "2048^2, cost 10-29, Dijkstra", 2048, false, HUMSearchHeuristicNone, HUMSearchNeighborsCardinal },
+		{ "1024^2, cost 10-29, Dijkstra", 1024, false, HUMSearchHeuristicNone, HUMSearchNeighborsCardinal },
+	};
+
+	int32_t *queries = malloc(4 * (size_t)queryCount * sizeof(int32_t));
+	uint32_t *costs = malloc((size_t)queryCount * sizeof(uint32_t));
+
+	if (!queries || !costs) {
+		fprintf(stderr, "humlayoutbench: out of memory\n");
+		return 1;
+	}
+
+	printf("25%% obstacles, %d queries, best of %d runs, milliseconds per query\n\n", queryCount, runCount);
+	printf("%-30s %10s %10s %10s\n", "", "row-major", "blocked", "morton");
+
+	int32_t mismatches = 0;
+
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		const HUMLayoutBenchmarkCase *benchmarkCase = &cases[c];
+		int32_t size = benchmarkCase->size;
+		size_t tileCount = (size_t)size * size;
+		uint8_t *walkable = malloc(tileCount);
+		uint32_t *tileCosts = malloc(tileCount * sizeof(uint32_t));
+
+		if (!walkable || !tileCosts) {
+			fprintf(stderr, "humlayoutbench: out of memory\n");
+			return 1;
+		}
+
+		srand(seed);
+
+		for (size_t i = 0; i < tileCount; i++) {
+			walkable[i] = rand() % 100 >= 25;
+			tileCosts[i] = benchmarkCase->unitCost ? 1 : 10 + rand() % 20;
+		}
+
+		for (int32_t i = 0; i < queryCount; i++) {
+			int32_t *query = &queries[4 * i];
+
+			query[0] = rand() % HUMLayoutBenchmarkEdgeColumns;
+			query[1] = rand() % size;
+			query[2] = size - 1 - rand() % HUMLayoutBenchmarkEdgeColumns;
+			query[3] = rand() % size;
+
+			walkable[query[1] * size + query[0]] = 1;
+			walkable[query[3] * size + query[2]] = 1;
+		}
+
+		HUMLayoutBenchmarkMap map = { size, walkable, tileCosts };
+		double bestTimes[HUMSearchLayoutCount];
+
+		for (int layout = 0; layout < HUMSearchLayoutCount; layout++) {
+			HUMSearchContext *search = HUMSearchContextCreate(size, size, (HUMSearchLayout)layout);
+
+			if (!search) {
+				fprintf(stderr, "humlayoutbench: out of memory\n");
+				return 1;
+			}
+
+			bestTimes[layout] = 0.0;
+
+			for (int run = 0; run < runCount; run++) {
+				double start = HUMLayoutBenchmarkNow();
+
+				for (int32_t i = 0; i < queryCount; i++) {
+					const int32_t *query = &queries[4 * i];
+
+					HUMSearchQuery searchQuery = { 0 };
+					searchQuery.startX = query[0];
+					searchQuery.startY = query[1];
+					searchQuery.targetX = query[2];
+					searchQuery.targetY = query[3];
+					searchQuery.neighbors = benchmarkCase->neighbors;
+					searchQuery.heuristic = benchmarkCase->heuristic;
+					searchQuery.sample = HUMLayoutBenchmarkSampleTile;
+					searchQuery.info = &map;
+
+					HUMSearchContextReset(search);
+
+					uint32_t cost = HUMSearchFindPath(search, &searchQuery) ? search->pathCost : UINT32_MAX;
+
+					if (layout == HUMSearchLayoutRowMajor && run == 0) {
+						costs[i] = cost;
+					}
+					else if (cost != costs[i]) {
+						mismatches++;
+					}
+				}
+
+				double time = (HUMLayoutBenchmarkNow() - start) * 1000.0 / queryCount;
+
+				if (run == 0 || time < bestTimes[layout]) {
+					bestTimes[layout] = time;
+				}
+			}
+
+			HUMSearchContextFree(search);
+		}
+
+		printf("%-30s %7.0f ms %7.0f ms %7.0f ms\n", benchmarkCase->name, bestTimes[HUMSearchLayoutRowMajor], bestTimes[HUMSearchLayoutBlocked], bestTimes[HUMSearchLayoutMorton]);
+
+		free(tileCosts);
+		free(walkable);
+	}
+
+	printf("\n%d queries found paths of a different cost than in the row-major layout\n", mismatches);
+
+	free(costs);
+	free(queries);
+
+	return mismatches == 0 ? 0 : 2;
+}
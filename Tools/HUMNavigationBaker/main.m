@@ -0,0 +1,380 @@
+//
+//  main.m
+//  HUMNavigationBaker
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Bakes a Tiled (.tmx) map into a navigation file for -[HUMAStarPathfinder loadNavigationFileAtPath:sourceMapPath:error:]. Tiles are read
+//  the same way HUMAStarPathfinderTMXLayerAdapter reads them: a tile with a GID is walkable if its walkable property is true, a tile without
+//  a GID is walkable, and a tile's cost is its cost property, or the pathfinder's baseMovementCost if it has none.
+//
+//  Build from the root of the repository with:
+//
+//	clang -fobjc-arc -O2 -framework Foundation -lz -IHUMAStarPathfinder Tools/HUMNavigationBaker/main.m HUMAStarPathfinder/HUMAStarPathfinderNavigationFile.c -o humnavbake
+//
+
+#import <Foundation/Foundation.h>
+#import <zlib.h>
+#import "HUMAStarPathfinderNavigationFile.h"
+
+static const uint32_t HUMTMXFlippedMask = 0x1fffffff;
+
+#pragma mark - Map
+
+/**
+ *	The parts of a Tiled map the baker needs: its size, the properties of every tile with any, and the GIDs of every layer.
+ */
+@interface HUMTMXMap : NSObject <NSXMLParserDelegate>
+@property (nonatomic, assign) int32_t width;
+@property (nonatomic, assign) int32_t height;
+@property (nonatomic, strong) NSMutableDictionary *propertiesByGID;		// NSNumber GID -> NSDictionary of property names to NSString values
+@property (nonatomic, strong) NSMutableDictionary *layers;				// NSString name -> NSData of width * height uint32_t GIDs
+@property (nonatomic, copy) NSString *error;
+
+@property (nonatomic, strong) NSURL *baseURL;
+@property (nonatomic, assign) uint32_t firstGID;
+@property (nonatomic, assign) int64_t tileGID;
+@property (nonatomic, strong) NSMutableDictionary *tileProperties;
+@property (nonatomic, copy) NSString *layerName;
+@property (nonatomic, copy) NSString *encoding;
+@property (nonatomic, copy) NSString *compression;
+@property (nonatomic, strong) NSMutableString *characters;
+@property (nonatomic, strong) NSMutableData *layerGIDs;
+@end
+
+@implementation HUMTMXMap
+
++ (instancetype)mapWithContentsOfURL:(NSURL *)url error:(NSString **)error {
+	HUMTMXMap *map = [[self alloc] init];
+	map.propertiesByGID = [NSMutableDictionary dictionary];
+	map.layers = [NSMutableDictionary dictionary];
+
+	if (![map parseURL:url firstGID:0]) {
+		*error = map.error ?: [NSString stringWithFormat:@"couldn't parse %@", url.path];
+		return nil;
+	}
+
+	return map;
+}
+
+/**
+ *	Parses a map, or an external tileset whose tile IDs start at firstGID.
+ */
+- (BOOL)parseURL:(NSURL *)url firstGID:(uint32_t)firstGID {
+	NSXMLParser *parser = [[NSXMLParser alloc] initWithContentsOfURL:url];
+	NSURL *baseURL = self.baseURL;
+
+	self.baseURL = [url URLByDeletingLastPathComponent];
+	self.firstGID = firstGID;
+	parser.delegate = self;
+
+	BOOL parsed = [parser parse] && !self.error;
+
+	self.baseURL = baseURL;
+
+	return parsed;
+}
+
+- (void)parser:(NSXMLParser *)parser didStartElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName attributes:(NSDictionary *)attributes {
+	if ([elementName isEqualToString:@"map"]) {
+		self.width = [attributes[@"width"] intValue];
+		self.height = [attributes[@"height"] intValue];
+
+		if ([attributes[@"infinite"] boolValue]) {
+			self.error = @"infinite maps aren't supported";
+			[parser abortParsing];
+		}
+	}
+	else if ([elementName isEqualToString:@"tileset"]) {
+		// a tileset inside an external tileset file has no firstgid of its own
+		if (attributes[@"firstgid"]) {
+			self.firstGID = (uint32_t)[attributes[@"firstgid"] longLongValue];
+		}
+
+		if (attributes[@"source"]) {
+			NSURL *tilesetURL = [NSURL URLWithString:attributes[@"source"] relativeToURL:self.baseURL];
+			uint32_t mapFirstGID = self.firstGID;
+
+			if (![self parseURL:tilesetURL firstGID:mapFirstGID]) {
+				self.error = self.error ?: [NSString stringWithFormat:@"couldn't parse the tileset %@", tilesetURL.path];
+				[parser abortParsing];
+			}
+
+			self.firstGID = mapFirstGID;
+		}
+	}
+	else if ([elementName isEqualToString:@"tile"] && !self.layerName) {
+		self.tileGID = self.firstGID + [attributes[@"id"] longLongValue];
+		self.tileProperties = [NSMutableDictionary dictionary];
+	}
+	else if ([elementName isEqualToString:@"property"] && self.tileProperties && attributes[@"name"]) {
+		self.tileProperties[attributes[@"name"]] = attributes[@"value"] ?: @"";
+	}
+	else if ([elementName isEqualToString:@"layer"]) {
+		self.layerName = attributes[@"name"] ?: @"";
+		self.layerGIDs = [NSMutableData dataWithCapacity:(NSUInteger)self.width * self.height * sizeof(uint32_t)];
+	}
+	else if ([elementName isEqualToString:@"data"] && self.layerName) {
+		self.encoding = attributes[@"encoding"];
+		self.compression = attributes[@"compression"];
+		self.characters = [NSMutableString string];
+
+		if ([attributes[@"encoding"] length] == 0 && self.compression) {
+			self.error = @"compressed XML layer data isn't supported";
+			[parser abortParsing];
+		}
+	}
+	else if ([elementName isEqualToString:@"chunk"]) {
+		self.error = @"infinite maps aren't supported";
+		[parser abortParsing];
+	}
+	else if ([elementName isEqualToString:@"tile"] && self.layerName) {
+		// layer data written as one XML element per tile
+		uint32_t gid = (uint32_t)[attributes[@"gid"] longLongValue];
+		[self.layerGIDs appendBytes:&gid length:sizeof(gid)];
+	}
+}
+
+- (void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string {
+	[self.characters appendString:string];
+}
+
+- (void)parser:(NSXMLParser *)parser didEndElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName {
+	if ([elementName isEqualToString:@"tile"] && self.tileProperties) {
+		if (self.tileProperties.count > 0) {
+			self.propertiesByGID[@(self.tileGID)] = self.tileProperties;
+		}
+
+		self.tileProperties = nil;
+	}
+	else if ([elementName isEqualToString:@"data"] && self.characters) {
+		if (![self decodeLayerData]) {
+			[parser abortParsing];
+		}
+
+		self.characters = nil;
+	}
+	else if ([elementName isEqualToString:@"layer"]) {
+		if (self.layerGIDs.length != (NSUInteger)self.width * self.height * sizeof(uint32_t)) {
+			self.error = self.error ?: [NSString stringWithFormat:@"the layer %@ doesn't have a tile for every map tile", self.layerName];
+			[parser abortParsing];
+		}
+
+		self.layers[self.layerName] = self.layerGIDs;
+		self.layerName = nil;
+		self.layerGIDs = nil;
+	}
+}
+
+/**
+ *	Appends the GIDs of a layer's base64 or CSV data element.
+ */
+- (BOOL)decodeLayerData {
+	if ([self.encoding isEqualToString:@"csv"]) {
+		for (NSString *value in [self.characters componentsSeparatedByString:@","]) {
+			NSString *trimmed = [value stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+
+			if (trimmed.length > 0) {
+				uint32_t gid = (uint32_t)[trimmed longLongValue];
+				[self.layerGIDs appendBytes:&gid length:sizeof(gid)];
+			}
+		}
+
+		return YES;
+	}
+
+	if (![self.encoding isEqualToString:@"base64"]) {
+		return YES;
+	}
+
+	NSData *data = [[NSData alloc] initWithBase64EncodedString:self.characters options:NSDataBase64DecodingIgnoreUnknownCharacters];
+
+	if (data && ([self.compression isEqualToString:@"zlib"] || [self.compression isEqualToString:@"gzip"])) {
+		data = [self inflateData:data expectedLength:(NSUInteger)self.width * self.height * sizeof(uint32_t)];
+	}
+	else if (data && self.compression.length > 0) {
+		self.error = [NSString stringWithFormat:@"%@ compressed layer data isn't supported", self.compression];
+		return NO;
+	}
+
+	if (!data) {
+		self.error = [NSString stringWithFormat:@"couldn't decode the data of the layer %@", self.layerName];
+		return NO;
+	}
+
+	// GIDs are stored little-endian, the same as the layer's buffer
+	[self.layerGIDs appendData:data];
+
+	return YES;
+}
+
+- (NSData *)inflateData:(NSData *)data expectedLength:(NSUInteger)expectedLength {
+	NSMutableData *inflated = [NSMutableData dataWithLength:expectedLength];
+	z_stream stream = { 0 };
+
+	stream.next_in = (Bytef *)data.bytes;
+	stream.avail_in = (uInt)data.length;
+	stream.next_out = inflated.mutableBytes;
+	stream.avail_out = (uInt)inflated.length;
+
+	// 15 + 32 detects zlib and gzip headers
+	if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+		return nil;
+	}
+
+	int result = inflate(&stream, Z_FINISH);
+	inflateEnd(&stream);
+
+	return (result == Z_STREAM_END && stream.total_out == expectedLength) ? inflated : nil;
+}
+
+@end
+
+#pragma mark - Baking
+
+static void HUMNavigationBakerPrintUsage(void) {
+	fprintf(stderr,
+			"usage: humnavbake map.tmx -o map.nav [options]\n"
+			"\n"
+			"  --walkability-layer NAME  the layer whose tiles determine walkability. Every tile is walkable if omitted.\n"
+			"  --cost-layer NAME         the layer whose tiles determine movement cost. No costs are stored if omitted.\n"
+			"  --walkable-property NAME  the tile property holding walkability. Defaults to walkable.\n"
+			"  --cost-property NAME      the tile property holding movement cost. Defaults to cost.\n"
+			"  --neighbors RULES         the movement rules connected components are labeled with: cardinal, strict,\n"
+			"                            cross-borders, or diagonal. Searches with rules that allow no other moves skip\n"
+			"                            targets they can't reach. Defaults to cross-borders, the pathfinder's default.\n");
+}
+
+static BOOL HUMNavigationBakerParseNeighbors(NSString *name, HUMSearchNeighbors *neighbors) {
+	NSDictionary *neighborsByName = @{ @"cardinal" : @(HUMSearchNeighborsCardinal),
+									   @"strict" : @(HUMSearchNeighborsDiagonalStrict),
+									   @"cross-borders" : @(HUMSearchNeighborsDiagonalCrossBorders),
+									   @"diagonal" : @(HUMSearchNeighborsDiagonal) };
+
+	NSNumber *value = neighborsByName[name];
+	if (!value) {
+		return NO;
+	}
+
+	*neighbors = [value intValue];
+	return YES;
+}
+
+int main(int argc, const char * argv[]) {
+	@autoreleasepool {
+		NSString *mapPath = nil;
+		NSString *outputPath = nil;
+		NSString *walkabilityLayerName = nil;
+		NSString *costLayerName = nil;
+		NSString *walkablePropertyName = @"walkable";
+		NSString *costPropertyName = @"cost";
+		HUMSearchNeighbors neighbors = HUMSearchNeighborsDiagonalCrossBorders;
+
+		for (int i = 1; i < argc; i++) {
+			NSString *argument = @(argv[i]);
+			NSString *value = i + 1 < argc ? @(argv[i + 1]) : nil;
+
+			if ([argument isEqualToString:@"-o"] && value) {
+				outputPath = value;
+				i++;
+			}
+			else if ([argument isEqualToString:@"--walkability-layer"] && value) {
+				walkabilityLayerName = value;
+				i++;
+			}
+			else if ([argument isEqualToString:@"--cost-layer"] && value) {
+				costLayerName = value;
+				i++;
+			}
+			else if ([argument isEqualToString:@"--walkable-property"] && value) {
+				walkablePropertyName = value;
+				i++;
+			}
+			else if ([argument isEqualToString:@"--cost-property"] && value) {
+				costPropertyName = value;
+				i++;
+			}
+			else if ([argument isEqualToString:@"--neighbors"] && value && HUMNavigationBakerParseNeighbors(value, &neighbors)) {
+				i++;
+			}
+			else if (![argument hasPrefix:@"-"] && !mapPath) {
+				mapPath = argument;
+			}
+			else {
+				HUMNavigationBakerPrintUsage();
+				return 1;
+			}
+		}
+
+		if (!mapPath || !outputPath) {
+			HUMNavigationBakerPrintUsage();
+			return 1;
+		}
+
+		NSData *mapData = [NSData dataWithContentsOfFile:mapPath];
+		if (!mapData) {
+			fprintf(stderr, "humnavbake: couldn't read %s\n", mapPath.fileSystemRepresentation);
+			return 1;
+		}
+
+		NSString *error = nil;
+		HUMTMXMap *map = [HUMTMXMap mapWithContentsOfURL:[NSURL fileURLWithPath:mapPath] error:&error];
+
+		if (!map) {
+			fprintf(stderr, "humnavbake: %s\n", error.UTF8String);
+			return 1;
+		}
+
+		NSData *walkabilityGIDs = walkabilityLayerName ? map.layers[walkabilityLayerName] : nil;
+		NSData *costGIDs = costLayerName ? map.layers[costLayerName] : nil;
+
+		if ((walkabilityLayerName && !walkabilityGIDs) || (costLayerName && !costGIDs)) {
+			fprintf(stderr, "humnavbake: the map has no layer named %s\n", (walkabilityGIDs ? costLayerName : walkabilityLayerName).UTF8String);
+			return 1;
+		}
+
+		int32_t width = map.width;
+		int32_t height = map.height;
+		size_t tileCount = (size_t)width * (size_t)height;
+		uint8_t *walkable = malloc(tileCount);
+		uint32_t *costs = costGIDs ? malloc(tileCount * sizeof(uint32_t)) : NULL;
+		uint32_t *components = malloc(tileCount * sizeof(uint32_t));
+
+		const uint32_t *walkabilityTiles = walkabilityGIDs.bytes;
+		const uint32_t *costTiles = costGIDs.bytes;
+
+		for (size_t i = 0; i < tileCount; i++) {
+			walkable[i] = 1;
+
+			uint32_t gid = walkabilityTiles ? walkabilityTiles[i] & HUMTMXFlippedMask : 0;
+			if (gid != 0) {
+				walkable[i] = [map.propertiesByGID[@(gid)][walkablePropertyName] boolValue] ? 1 : 0;
+			}
+
+			if (costs) {
+				gid = costTiles[i] & HUMTMXFlippedMask;
+				NSString *cost = gid != 0 ? map.propertiesByGID[@(gid)][costPropertyName] : nil;
+				costs[i] = cost ? (uint32_t)MIN(MAX([cost longLongValue], 0LL), (long long)UINT32_MAX - 1) : HUMNavigationDefaultCost;
+			}
+		}
+
+		uint32_t componentCount = HUMNavigationLabelComponents(width, height, walkable, neighbors, components);
+		uint64_t sourceChecksum = HUMNavigationChecksum(mapData.bytes, mapData.length, 0);
+
+		HUMNavigationFileStatus status = HUMNavigationFileWrite(outputPath.fileSystemRepresentation, width, height, sourceChecksum, walkable, costs, components, neighbors);
+
+		free(walkable);
+		free(costs);
+		free(components);
+
+		if (status != HUMNavigationFileStatusOK) {
+			fprintf(stderr, "humnavbake: couldn't write %s\n", outputPath.fileSystemRepresentation);
+			return 1;
+		}
+
+		printf("%s: %dx%d tiles, %u components%s\n", outputPath.fileSystemRepresentation, width, height, componentCount, costGIDs ? ", costs" : "");
+	}
+
+	return 0;
+}
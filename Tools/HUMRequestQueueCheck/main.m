@@ -0,0 +1,114 @@
+//
+//  main.m
+//  HUMRequestQueueCheck
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Checks the bookkeeping of HUMAStarPathfinderRequestQueue when requests are cancelled: cancelling tokens again after -cancelAllRequests,
+//  after their paths were delivered, or twice, must leave queueDepth and pendingRequestCount alone, run no searches, and call no completions.
+//  Exits with 1 if any check fails.
+//
+//  Build from the root of the repository with:
+//
+//	clang -fobjc-arc -O2 -framework Foundation -IHUMAStarPathfinder Tools/HUMRequestQueueCheck/main.m HUMAStarPathfinder/*.m HUMAStarPathfinder/*.c -o humqueuecheck
+//
+
+#import <Foundation/Foundation.h>
+#import "HUMAStarPathfinder.h"
+#import "HUMAStarPathfinderRequestQueue.h"
+
+static const NSInteger HUMRequestQueueCheckMapSize = 16;
+
+/**
+ *	A delegate for a map where every tile is walkable.
+ */
+@interface HUMRequestQueueCheckMap : NSObject <HUMAStarPathfinderDelegate>
+@end
+
+@implementation HUMRequestQueueCheckMap
+
+- (BOOL)pathfinder:(HUMAStarPathfinder *)pathfinder canWalkToNodeAtTileLocation:(CGPoint)tileLocation {
+	return YES;
+}
+
+@end
+
+static NSInteger HUMRequestQueueCheckFailures = 0;
+
+static void HUMRequestQueueCheckExpect(BOOL condition, NSString *check) {
+	if (!condition) {
+		printf("FAIL  %s\n", check.UTF8String);
+		HUMRequestQueueCheckFailures++;
+	}
+}
+
+static void HUMRequestQueueCheckExpectIdle(HUMAStarPathfinderRequestQueue *queue, NSString *check) {
+	HUMRequestQueueCheckExpect(queue.queueDepth == 0, [check stringByAppendingFormat:@": queueDepth is %lu", (unsigned long)queue.queueDepth]);
+	HUMRequestQueueCheckExpect(queue.pendingRequestCount == 0, [check stringByAppendingFormat:@": pendingRequestCount is %lu", (unsigned long)queue.pendingRequestCount]);
+}
+
+int main(int argc, const char *argv[]) {
+	@autoreleasepool {
+		HUMRequestQueueCheckMap *map = [[HUMRequestQueueCheckMap alloc] init];
+		HUMAStarPathfinder *pathfinder = [HUMAStarPathfinder pathfinderWithTileMapSize:CGSizeMake(HUMRequestQueueCheckMapSize, HUMRequestQueueCheckMapSize)
+																			  tileSize:CGSizeMake(32, 32)
+																			  delegate:map];
+		HUMAStarPathfinderRequestQueue *queue = [HUMAStarPathfinderRequestQueue requestQueueWithPathfinder:pathfinder];
+		CGPoint start = [pathfinder positionForTileLocation:CGPointMake(1, 1)];
+		CGPoint target = [pathfinder positionForTileLocation:CGPointMake(HUMRequestQueueCheckMapSize - 2, HUMRequestQueueCheckMapSize - 2)];
+		__block NSInteger completionCount = 0;
+		__block NSInteger provisionalCount = 0;
+
+		HUMAStarPathRequestCompletion completion = ^(NSArray *path) {
+			completionCount++;
+		};
+		HUMAStarProvisionalPathHandler provisional = ^(NSArray *provisionalPath) {
+			provisionalCount++;
+		};
+
+		// cancelling tokens again after cancelling everything
+		NSArray *tokens = @[ [queue requestPathFromStart:start toTarget:target priority:HUMAStarRequestPriorityPlayer completion:completion],
+							 [queue requestPathFromStart:start toTarget:target priority:HUMAStarRequestPriorityAI completion:completion],
+							 [queue requestPathFromStart:target toTarget:start priority:HUMAStarRequestPriorityBackground completion:completion],
+							 [queue requestProgressivePathFromStart:start toTarget:target priority:HUMAStarRequestPriorityPlayer provisional:provisional completion:completion] ];
+
+		[queue cancelAllRequests];
+
+		for (id token in tokens) {
+			[queue cancelRequest:token];
+		}
+
+		[queue update:0];
+
+		HUMRequestQueueCheckExpectIdle(queue, @"cancelAllRequests, then cancelRequest:");
+		HUMRequestQueueCheckExpect(queue.searchCount == 0, @"cancelAllRequests, then cancelRequest:: searches were run");
+		HUMRequestQueueCheckExpect(completionCount == 0 && provisionalCount == 0, @"cancelAllRequests, then cancelRequest:: a cancelled request was answered");
+
+		// the queue still works afterwards, and cancelling a delivered token does nothing
+		id token = [queue requestPathFromStart:start toTarget:target priority:HUMAStarRequestPriorityPlayer completion:completion];
+		[queue update:0];
+		[queue cancelRequest:token];
+		[queue update:0];
+
+		HUMRequestQueueCheckExpectIdle(queue, @"cancelRequest: after delivery");
+		HUMRequestQueueCheckExpect(queue.searchCount == 1 && completionCount == 1, @"cancelRequest: after delivery: the request wasn't answered exactly once");
+
+		// cancelling one of two coalesced requests twice
+		id first = [queue requestPathFromStart:start toTarget:target priority:HUMAStarRequestPriorityAI completion:completion];
+		[queue requestPathFromStart:start toTarget:target priority:HUMAStarRequestPriorityAI completion:completion];
+		[queue cancelRequest:first];
+		[queue cancelRequest:first];
+
+		HUMRequestQueueCheckExpect(queue.queueDepth == 1 && queue.pendingRequestCount == 1, @"cancelRequest: twice: the other coalesced request was dropped");
+
+		[queue update:0];
+
+		HUMRequestQueueCheckExpectIdle(queue, @"cancelRequest: twice");
+		HUMRequestQueueCheckExpect(queue.searchCount == 2 && completionCount == 2, @"cancelRequest: twice: the other coalesced request wasn't answered exactly once");
+
+		printf("%s\n", HUMRequestQueueCheckFailures == 0 ? "ok" : "FAIL");
+	}
+
+	return HUMRequestQueueCheckFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,272 @@
+//
+//  main.c
+//  HUMSubgoalBenchmark
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Runs the same random queries through plain A* and through a subgoal graph, checks that both find paths of the same cost, and reports how
+//  long each took and how many nodes each expanded. The map is either the walkability of a navigation file baked by humnavbake, or a
+//  generated map of rectangular obstacles.
+//
+//  Build from the root of the repository with:
+//
+//	cc -std=gnu99 -O2 -IHUMAStarPathfinder Tools/HUMSubgoalBenchmark/main.c HUMAStarPathfinder/HUMAStarPathfinderSearch.c HUMAStarPathfinder/HUMAStarPathfinderSubgoals.c HUMAStarPathfinder/HUMAStarPathfinderNavigationFile.c -lm -o humsubgoalbench
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "HUMAStarPathfinderNavigationFile.h"
+#include "HUMAStarPathfinderSearch.h"
+#include "HUMAStarPathfinderSubgoals.h"
+
+#define HUMSubgoalBenchmarkCost 10
+
+typedef struct {
+	int32_t width;
+	int32_t height;
+	const uint8_t *walkable;
+} HUMSubgoalBenchmarkMap;
+
+static double HUMSubgoalBenchmarkNow(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/**
+ *	The sample function of the A* searches. Every walkable tile costs the same, as the subgoal graph requires.
+ */
+static void HUMSubgoalBenchmarkSampleTile(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost) {
+	const HUMSubgoalBenchmarkMap *map = info;
+
+	*walkable = map->walkable[y * map->width + x] != 0;
+	*cost = HUMSubgoalBenchmarkCost;
+}
+
+/**
+ *	Fills a map with rectangular obstacles of random sizes, covering roughly the given fraction of its tiles.
+ */
+static void HUMSubgoalBenchmarkGenerateMap(uint8_t *walkable, int32_t width, int32_t height, double coverage) {
+	memset(walkable, 1, (size_t)width * height);
+
+	int64_t blocked = 0;
+	int64_t goal = (int64_t)(coverage * width * height);
+
+	while (blocked < goal) {
+		int32_t obstacleWidth = 1 + rand() % (width / 8 + 1);
+		int32_t obstacleHeight = 1 + rand() % (height / 8 + 1);
+		int32_t x = rand() % width;
+		int32_t y = rand() % height;
+
+		for (int32_t j = y; j < y + obstacleHeight && j < height; j++) {
+			for (int32_t i = x; i < x + obstacleWidth && i < width; i++) {
+				blocked += walkable[j * width + i];
+				walkable[j * width + i] = 0;
+			}
+		}
+	}
+}
+
+static void HUMSubgoalBenchmarkPrintUsage(void) {
+	fprintf(stderr,
+			"usage: humsubgoalbench [options]\n"
+			"\n"
+			"  --navigation-file PATH  benchmark the walkability of a navigation file instead of a generated map.\n"
+			"  --size WIDTHxHEIGHT     the size of the generated map. Defaults to 512x512.\n"
+			"  --coverage FRACTION     the fraction of the generated map covered by obstacles. Defaults to 0.2.\n"
+			"  --queries COUNT         the number of queries. Defaults to 1000.\n"
+			"  --seed SEED             the seed of the generated map and the queries. Defaults to 1.\n"
+			"  --neighbors RULES       the movement rules: cardinal, strict, cross-borders, or diagonal. Defaults to\n"
+			"                          cross-borders, the pathfinder's default.\n");
+}
+
+static bool HUMSubgoalBenchmarkParseNeighbors(const char *name, HUMSearchNeighbors *neighbors) {
+	const char *names[] = { "cardinal", "diagonal", "cross-borders", "strict" };
+
+	for (int i = 0; i < HUMSearchNeighborsCount; i++) {
+		if (strcmp(name, names[i]) == 0) {
+			*neighbors = (HUMSearchNeighbors)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int main(int argc, const char * argv[]) {
+	const char *navigationPath = NULL;
+	int32_t width = 512;
+	int32_t height = 512;
+	double coverage = 0.2;
+	int32_t queryCount = 1000;
+	unsigned int seed = 1;
+	HUMSearchNeighbors neighbors = HUMSearchNeighborsDiagonalCrossBorders;
+
+	for (int i = 1; i < argc; i++) {
+		const char *argument = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (strcmp(argument, "--navigation-file") == 0 && value) {
+			navigationPath = value;
+		}
+		else if (strcmp(argument, "--size") == 0 && value && sscanf(value, "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+		}
+		else if (strcmp(argument, "--coverage") == 0 && value && sscanf(value, "%lf", &coverage) == 1 && coverage >= 0.0 && coverage < 1.0) {
+		}
+		else if (strcmp(argument, "--queries") == 0 && value && sscanf(value, "%d", &queryCount) == 1 && queryCount > 0) {
+		}
+		else if (strcmp(argument, "--seed") == 0 && value && sscanf(value, "%u", &seed) == 1) {
+		}
+		else if (strcmp(argument, "--neighbors") == 0 && value && HUMSubgoalBenchmarkParseNeighbors(value, &neighbors)) {
+		}
+		else {
+			HUMSubgoalBenchmarkPrintUsage();
+			return 1;
+		}
+
+		i++;
+	}
+
+	srand(seed);
+
+	uint8_t *walkable = NULL;
+
+	if (navigationPath) {
+		HUMNavigationFileStatus status = HUMNavigationFileStatusOK;
+		HUMNavigationData *navigationData = HUMNavigationDataOpen(navigationPath, 0, &status);
+
+		if (!navigationData) {
+			fprintf(stderr, "humsubgoalbench: couldn't open %s\n", navigationPath);
+			return 1;
+		}
+
+		width = navigationData->width;
+		height = navigationData->height;
+		walkable = malloc((size_t)width * height);
+
+		for (int32_t y = 0; walkable && y < height; y++) {
+			for (int32_t x = 0; x < width; x++) {
+				walkable[y * width + x] = HUMNavigationDataIsWalkable(navigationData, x, y);
+			}
+		}
+
+		HUMNavigationDataClose(navigationData);
+	}
+	else {
+		walkable = malloc((size_t)width * height);
+
+		if (walkable) {
+			HUMSubgoalBenchmarkGenerateMap(walkable, width, height, coverage);
+		}
+	}
+
+	int32_t *queries = malloc(4 * (size_t)queryCount * sizeof(int32_t));
+	HUMSearchContext *search = HUMSearchContextCreate(width, height, HUMSearchLayoutRowMajor);
+
+	if (!walkable || !queries || !search) {
+		fprintf(stderr, "humsubgoalbench: out of memory\n");
+		return 1;
+	}
+
+	int64_t walkableCount = 0;
+	for (size_t i = 0; i < (size_t)width * height; i++) {
+		walkableCount += walkable[i];
+	}
+
+	if (walkableCount == 0) {
+		fprintf(stderr, "humsubgoalbench: the map has no walkable tiles\n");
+		return 1;
+	}
+
+	for (int32_t i = 0; i < 2 * queryCount; i++) {
+		int32_t x, y;
+
+		do {
+			x = rand() % width;
+			y = rand() % height;
+		} while (!walkable[y * width + x]);
+
+		queries[2 * i] = x;
+		queries[2 * i + 1] = y;
+	}
+
+	double buildStart = HUMSubgoalBenchmarkNow();
+	HUMSubgoalGraph *graph = HUMSubgoalGraphCreate(width, height, walkable, neighbors, HUMSubgoalBenchmarkCost);
+	double buildTime = HUMSubgoalBenchmarkNow() - buildStart;
+
+	if (!graph) {
+		fprintf(stderr, "humsubgoalbench: couldn't build the subgoal graph\n");
+		return 1;
+	}
+
+	size_t dataSize = 0;
+	free(HUMSubgoalGraphCopyData(graph, &dataSize));
+
+	printf("map            %d x %d, %lld walkable tiles\n", width, height, (long long)walkableCount);
+	printf("subgoal graph  %d subgoals, %d edges, %.1f KB serialized, built in %.1f ms\n", graph->nodeCount, graph->edgeCount, dataSize / 1024.0, buildTime * 1000.0);
+
+	HUMSubgoalBenchmarkMap map = { width, height, walkable };
+	uint32_t *costs = malloc((size_t)queryCount * sizeof(uint32_t));
+
+	if (!costs) {
+		fprintf(stderr, "humsubgoalbench: out of memory\n");
+		return 1;
+	}
+
+	int64_t aStarExpanded = 0;
+	int64_t subgoalExpanded = 0;
+	int32_t mismatches = 0;
+
+	// plain A* the way the pathfinder runs it, with its default Manhattan heuristic
+	double aStarStart = HUMSubgoalBenchmarkNow();
+
+	for (int32_t i = 0; i < queryCount; i++) {
+		const int32_t *query = &queries[4 * i];
+		HUMSearchQuery searchQuery = { 0 };
+		searchQuery.startX = query[0];
+		searchQuery.startY = query[1];
+		searchQuery.targetX = query[2];
+		searchQuery.targetY = query[3];
+		searchQuery.neighbors = neighbors;
+		searchQuery.heuristic = HUMSearchHeuristicManhattan;
+		searchQuery.sample = HUMSubgoalBenchmarkSampleTile;
+		searchQuery.info = &map;
+
+		HUMSearchContextReset(search);
+		costs[i] = HUMSearchFindPath(search, &searchQuery) ? search->pathCost : UINT32_MAX;
+		aStarExpanded += search->touchedCount;
+	}
+
+	double aStarTime = HUMSubgoalBenchmarkNow() - aStarStart;
+	double subgoalStart = HUMSubgoalBenchmarkNow();
+
+	for (int32_t i = 0; i < queryCount; i++) {
+		const int32_t *query = &queries[4 * i];
+		HUMSubgoalPath path;
+
+		uint32_t cost = HUMSubgoalGraphFindPath(graph, query[0], query[1], query[2], query[3], &path) ? path.cost : UINT32_MAX;
+		subgoalExpanded += path.nodesExpanded;
+		HUMSubgoalPathFree(&path);
+
+		if (cost != costs[i]) {
+			mismatches++;
+		}
+	}
+
+	double subgoalTime = HUMSubgoalBenchmarkNow() - subgoalStart;
+
+	printf("A*             %.3f ms per query, %.0f tiles touched per query\n", aStarTime * 1000.0 / queryCount, (double)aStarExpanded / queryCount);
+	printf("subgoal graph  %.3f ms per query, %.0f subgoals expanded per query, %.1fx faster\n", subgoalTime * 1000.0 / queryCount, (double)subgoalExpanded / queryCount, aStarTime / subgoalTime);
+	printf("%d of %d queries found paths of a different cost\n", mismatches, queryCount);
+
+	HUMSubgoalGraphFree(graph);
+	HUMSearchContextFree(search);
+	free(costs);
+	free(queries);
+	free(walkable);
+
+	return mismatches == 0 ? 0 : 2;
+}
@@ -0,0 +1,674 @@
+//
+//  main.c
+//  HUMTraceReplay
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Replays a trace recorded by HUMAStarPathfinder's -startRecordingTraceToPath:error: against the same maps, edits, and settings, through the
+//  same search cores the pathfinder dispatches to, and reports how long each query took when it was recorded and when it was replayed. It
+//  can also write the replayed latencies to a CSV file, and compare a replay against a CSV written by an earlier build to catch regressions.
+//
+//  The replay runs without a delegate or Objective-C, so its latencies leave out the time the pathfinder spent asking its delegate for tiles
+//  and building the path's NSArray. They're best compared with other replays, while the recorded latencies show where the time went in the app.
+//
+//  Build from the root of the repository with:
+//
+//	cc -std=gnu99 -O2 -IHUMAStarPathfinder Tools/HUMTraceReplay/main.c HUMAStarPathfinder/HUMAStarPathfinderTrace.c HUMAStarPathfinder/HUMAStarPathfinderSearch.c HUMAStarPathfinder/HUMAStarPathfinderBitSearch.c HUMAStarPathfinder/HUMAStarPathfinderBoundedSearch.c HUMAStarPathfinder/HUMAStarPathfinderClearanceMap.c HUMAStarPathfinder/HUMAStarPathfinderVisibilityGraph.c HUMAStarPathfinder/HUMAStarPathfinderSwamps.c HUMAStarPathfinder/HUMAStarPathfinderNavigationFile.c -lm -o humtracereplay
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "HUMAStarPathfinderBitSearch.h"
+#include "HUMAStarPathfinderBoundedSearch.h"
+#include "HUMAStarPathfinderClearanceMap.h"
+#include "HUMAStarPathfinderSearch.h"
+#include "HUMAStarPathfinderSwamps.h"
+#include "HUMAStarPathfinderTrace.h"
+#include "HUMAStarPathfinderVisibilityGraph.h"
+
+// the values of HUMAStarSearchMode
+enum {
+	HUMTraceReplayModeUnidirectional = 0,
+	HUMTraceReplayModeBidirectional,
+	HUMTraceReplayModeBreadthFirst,
+	HUMTraceReplayModeVisibilityGraph,
+	HUMTraceReplayModeBoundedMemory
+};
+
+/**
+ *	The map as the pathfinder saw it, along with the structures it builds from the map on demand. Those are built the first time a query needs
+ *  them, inside the time of that query, just as the pathfinder builds them.
+ */
+typedef struct {
+	int32_t width;
+	int32_t height;
+	uint8_t *walkable;
+	uint32_t *costs;
+	HUMTraceSettings settings;
+
+	HUMSearchContext *search;
+	HUMBitSearchContext *bitSearch;
+	HUMClearanceMap *clearanceMap;
+	HUMVisibilityGraph *visibilityGraph;
+	HUMSwampMap *swampMap;
+} HUMTraceReplayState;
+
+typedef struct {
+	const HUMTraceReplayState *state;
+	uint32_t unitSize;
+} HUMTraceReplaySampleInfo;
+
+typedef struct {
+	HUMTraceQuery recorded;
+	HUMTraceResult result;
+	uint32_t pathCount;
+	uint64_t latency;
+} HUMTraceReplayQuery;
+
+static uint64_t HUMTraceReplayNow(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+}
+
+static void HUMTraceReplaySampleTile(void *info, int32_t x, int32_t y, bool *walkable, uint32_t *cost) {
+	const HUMTraceReplaySampleInfo *sampleInfo = info;
+	const HUMTraceReplayState *state = sampleInfo->state;
+	int32_t index = y * state->width + x;
+
+	if (sampleInfo->unitSize > 1) {
+		*walkable = HUMClearanceMapClearance(state->clearanceMap, x, y) >= sampleInfo->unitSize;
+	}
+	else {
+		*walkable = state->walkable[index] != 0;
+	}
+
+	*cost = state->costs[index];
+}
+
+/**
+ *	Frees everything built from the map, for when the map is replaced.
+ */
+static void HUMTraceReplayDiscardDerivedState(HUMTraceReplayState *state) {
+	HUMSearchContextFree(state->search);
+	HUMBitSearchContextFree(state->bitSearch);
+	HUMClearanceMapFree(state->clearanceMap);
+	HUMVisibilityGraphFree(state->visibilityGraph);
+	HUMSwampMapFree(state->swampMap);
+
+	state->search = NULL;
+	state->bitSearch = NULL;
+	state->clearanceMap = NULL;
+	state->visibilityGraph = NULL;
+	state->swampMap = NULL;
+}
+
+static bool HUMTraceReplayLoadMap(HUMTraceReplayState *state, const HUMTraceMap *map) {
+	size_t tileCount = (size_t)map->width * map->height;
+
+	HUMTraceReplayDiscardDerivedState(state);
+	free(state->walkable);
+	free(state->costs);
+
+	state->width = map->width;
+	state->height = map->height;
+	state->walkable = malloc(tileCount ? tileCount : 1);
+	state->costs = malloc((tileCount ? tileCount : 1) * sizeof(uint32_t));
+
+	if (!state->walkable || !state->costs) {
+		return false;
+	}
+
+	memcpy(state->walkable, map->walkable, tileCount);
+	memcpy(state->costs, map->costs, tileCount * sizeof(uint32_t));
+
+	return true;
+}
+
+/**
+ *	Applies an edit to the map and brings whatever was built from it up to date. Done outside the time of any query, since the pathfinder
+ *  applies most edits as they're made.
+ */
+static void HUMTraceReplayApplyEdit(HUMTraceReplayState *state, const HUMTraceEdit *edit) {
+	HUMSearchTileRect rect = edit->rect;
+
+	if (rect.x < 0 || rect.y < 0 || rect.width <= 0 || rect.height <= 0 || rect.x + rect.width > state->width || rect.y + rect.height > state->height) {
+		return;
+	}
+
+	for (int32_t y = 0; y < rect.height; y++) {
+		memcpy(&state->walkable[(rect.y + y) * state->width + rect.x], &edit->walkable[y * rect.width], (size_t)rect.width);
+		memcpy(&state->costs[(rect.y + y) * state->width + rect.x], &edit->costs[y * rect.width], (size_t)rect.width * sizeof(uint32_t));
+	}
+
+	// a cost layer only changes costs, which nothing built from the map depends on
+	if (edit->source == HUMTraceEditCostLayer) {
+		return;
+	}
+
+	if (state->clearanceMap) {
+		HUMClearanceMapUpdate(state->clearanceMap, rect.x, rect.y, rect.width, rect.height, edit->walkable);
+	}
+
+	if (state->visibilityGraph && !HUMVisibilityGraphUpdate(state->visibilityGraph, rect.x, rect.y, rect.width, rect.height, edit->walkable)) {
+		HUMVisibilityGraphFree(state->visibilityGraph);
+		state->visibilityGraph = NULL;
+	}
+
+	if (state->swampMap && !HUMSwampMapUpdate(state->swampMap, rect.x, rect.y, rect.width, rect.height, edit->walkable)) {
+		HUMSwampMapFree(state->swampMap);
+		state->swampMap = NULL;
+	}
+}
+
+static void HUMTraceReplayApplySettings(HUMTraceReplayState *state, const HUMTraceSettings *settings) {
+	if (state->search && state->search->layout != settings->layout) {
+		HUMSearchContextFree(state->search);
+		state->search = NULL;
+	}
+
+	state->settings = *settings;
+}
+
+static HUMTraceResult HUMTraceReplayBitSearch(HUMTraceReplayState *state, const HUMTraceQuery *query, uint32_t *pathCount) {
+	if (!state->bitSearch) {
+		state->bitSearch = HUMBitSearchContextCreate(state->width, state->height);
+
+		if (!state->bitSearch) {
+			return HUMTraceResultNone;
+		}
+	}
+
+	HUMBitSearchLoadClearance(state->bitSearch, state->clearanceMap->clearance, (uint8_t)query->unitSize);
+
+	if (!HUMBitSearchFindPath(state->bitSearch, query->startX, query->startY, query->targetX, query->targetY)) {
+		return HUMTraceResultNoPath;
+	}
+
+	*pathCount = (uint32_t)HUMBitSearchCopyPath(state->bitSearch, NULL, NULL, 0);
+
+	return HUMTraceResultPath;
+}
+
+static HUMTraceResult HUMTraceReplayVisibilityGraphSearch(HUMTraceReplayState *state, const HUMTraceQuery *query, uint32_t *pathCount) {
+	if (!state->walkable[query->startY * state->width + query->startX]) {
+		return HUMTraceResultNoPath;
+	}
+
+	// the trace only holds the start tile, so the path starts at its center
+	HUMVisibilityPath path;
+	HUMTraceResult result = HUMTraceResultNoPath;
+
+	if (HUMVisibilityGraphFindPath(state->visibilityGraph, query->startX + 0.5, query->startY + 0.5, query->targetX + 0.5, query->targetY + 0.5, &path)) {
+		*pathCount = (uint32_t)path.count;
+		result = HUMTraceResultPath;
+	}
+
+	HUMVisibilityPathFree(&path);
+
+	return result;
+}
+
+static HUMTraceResult HUMTraceReplayBoundedSearch(HUMTraceReplayState *state, const HUMTraceQuery *query, HUMTraceReplaySampleInfo *sampleInfo, uint32_t *pathCount) {
+	HUMBoundedSearchQuery boundedQuery = { 0 };
+	boundedQuery.width = state->width;
+	boundedQuery.height = state->height;
+	boundedQuery.startX = query->startX;
+	boundedQuery.startY = query->startY;
+	boundedQuery.targetX = query->targetX;
+	boundedQuery.targetY = query->targetY;
+	boundedQuery.neighbors = state->settings.neighbors;
+	boundedQuery.heuristic = state->settings.heuristic;
+	boundedQuery.sample = HUMTraceReplaySampleTile;
+	boundedQuery.info = sampleInfo;
+	boundedQuery.memoryLimit = (size_t)state->settings.boundedSearchMemoryLimit;
+
+	HUMBoundedSearchResult boundedResult;
+	HUMBoundedSearchFindPath(&boundedQuery, &boundedResult);
+
+	HUMTraceResult result = HUMTraceResultNone;
+
+	if (boundedResult.status == HUMBoundedSearchStatusFound) {
+		*pathCount = (uint32_t)boundedResult.count;
+		result = HUMTraceResultPath;
+	}
+	else if (boundedResult.status == HUMBoundedSearchStatusNoPath) {
+		result = HUMTraceResultNoPath;
+	}
+
+	HUMBoundedSearchResultFree(&boundedResult);
+
+	return result;
+}
+
+/**
+ *	Runs a query the way -findPathFromStart:toTarget:unitSize:searchMode: does, building whatever the search mode needs first.
+ */
+static HUMTraceResult HUMTraceReplayRunQuery(HUMTraceReplayState *state, const HUMTraceQuery *query, uint32_t *pathCount) {
+	const HUMTraceSettings *settings = &state->settings;
+	uint32_t searchMode = query->searchMode;
+	*pathCount = 0;
+
+	if (query->unitSize == 0 || query->unitSize > HUMClearanceMapMaximumClearance) {
+		return HUMTraceResultNone;
+	}
+
+	bool usesClearanceMap = (query->unitSize > 1 || searchMode == HUMTraceReplayModeBreadthFirst);
+	bool usesVisibilityGraph = (query->unitSize == 1 && searchMode == HUMTraceReplayModeVisibilityGraph);
+	bool prunesSwamps = settings->prunesSwamps && searchMode != HUMTraceReplayModeBoundedMemory;
+
+	if (usesClearanceMap && !state->clearanceMap) {
+		state->clearanceMap = HUMClearanceMapCreate(state->width, state->height, state->walkable);
+	}
+
+	if (usesVisibilityGraph && !state->visibilityGraph) {
+		state->visibilityGraph = HUMVisibilityGraphCreate(state->width, state->height, state->walkable);
+	}
+
+	if (prunesSwamps && state->swampMap && (state->swampMap->neighbors != settings->neighbors || state->swampMap->cost != settings->baseMovementCost)) {
+		HUMSwampMapFree(state->swampMap);
+		state->swampMap = NULL;
+	}
+
+	if (prunesSwamps && !state->swampMap) {
+		state->swampMap = HUMSwampMapCreate(state->width, state->height, state->walkable, settings->neighbors, settings->baseMovementCost);
+	}
+
+	if (usesClearanceMap && !state->clearanceMap) {
+		return HUMTraceResultNone;
+	}
+
+	if (query->startX == query->targetX && query->startY == query->targetY) {
+		return HUMTraceResultNone;
+	}
+
+	if (query->startX < 0 || query->startY < 0 || query->startX >= state->width || query->startY >= state->height ||
+		query->targetX < 0 || query->targetY < 0 || query->targetX >= state->width || query->targetY >= state->height) {
+		return HUMTraceResultNone;
+	}
+
+	HUMTraceReplaySampleInfo sampleInfo = { state, query->unitSize };
+
+	bool targetWalkable = false;
+	uint32_t targetCost = 0;
+	HUMTraceReplaySampleTile(&sampleInfo, query->targetX, query->targetY, &targetWalkable, &targetCost);
+
+	if (!targetWalkable) {
+		return HUMTraceResultNone;
+	}
+
+	if (searchMode == HUMTraceReplayModeBreadthFirst && settings->neighbors == HUMSearchNeighborsCardinal && settings->uniformCosts) {
+		return HUMTraceReplayBitSearch(state, query, pathCount);
+	}
+
+	if (usesVisibilityGraph && settings->neighbors != HUMSearchNeighborsCardinal && state->visibilityGraph && settings->uniformCosts) {
+		return HUMTraceReplayVisibilityGraphSearch(state, query, pathCount);
+	}
+
+	if (searchMode == HUMTraceReplayModeBoundedMemory) {
+		return HUMTraceReplayBoundedSearch(state, query, &sampleInfo, pathCount);
+	}
+
+	if (!state->search) {
+		state->search = HUMSearchContextCreate(state->width, state->height, settings->layout);
+
+		if (!state->search) {
+			return HUMTraceResultNone;
+		}
+	}
+
+	HUMSearchQuery searchQuery = { 0 };
+	searchQuery.startX = query->startX;
+	searchQuery.startY = query->startY;
+	searchQuery.targetX = query->targetX;
+	searchQuery.targetY = query->targetY;
+	searchQuery.neighbors = settings->neighbors;
+	searchQuery.heuristic = settings->heuristic;
+	searchQuery.sample = HUMTraceReplaySampleTile;
+	searchQuery.info = &sampleInfo;
+	searchQuery.bidirectional = (searchMode == HUMTraceReplayModeBidirectional);
+
+	HUMSwampMap *swampMap = prunesSwamps ? state->swampMap : NULL;
+
+	if (swampMap) {
+		bool measuredCosts = (query->unitSize == 1 && settings->uniformCosts && swampMap->cost == settings->baseMovementCost);
+		searchQuery.prunedTiles = measuredCosts ? swampMap->swampTiles : swampMap->deadEndTiles;
+		HUMSwampMapGetSwampBounds(swampMap, searchQuery.startX, searchQuery.startY, &searchQuery.keptRects[0]);
+		HUMSwampMapGetSwampBounds(swampMap, searchQuery.targetX, searchQuery.targetY, &searchQuery.keptRects[1]);
+	}
+
+	HUMSearchContextReset(state->search);
+
+	if (!HUMSearchFindPath(state->search, &searchQuery)) {
+		return HUMTraceResultNoPath;
+	}
+
+	*pathCount = (uint32_t)HUMSearchCopyPath(state->search, NULL, NULL, 0);
+
+	return HUMTraceResultPath;
+}
+
+/**
+ *	Reads the replayed latency of every query from a CSV file written with --csv.
+ *
+ *	@return	The latencies in nanoseconds, or NULL if the file couldn't be read.
+ */
+static uint64_t *HUMTraceReplayReadBaseline(const char *path, int32_t *count) {
+	FILE *file = fopen(path, "r");
+
+	if (!file) {
+		return NULL;
+	}
+
+	int32_t capacity = 256;
+	uint64_t *latencies = malloc((size_t)capacity * sizeof(uint64_t));
+	char line[256];
+	*count = 0;
+
+	while (latencies && fgets(line, sizeof(line), file)) {
+		int32_t index;
+		unsigned long long latency;
+
+		// the header and anything else that isn't a row are skipped
+		if (sscanf(line, "%d,%*u,%*u,%*u,%*u,%*u,%llu", &index, &latency) != 2 || index != *count) {
+			continue;
+		}
+
+		if (*count == capacity) {
+			capacity *= 2;
+			uint64_t *grown = realloc(latencies, (size_t)capacity * sizeof(uint64_t));
+
+			if (!grown) {
+				free(latencies);
+				latencies = NULL;
+				break;
+			}
+
+			latencies = grown;
+		}
+
+		latencies[(*count)++] = latency;
+	}
+
+	fclose(file);
+
+	return latencies;
+}
+
+static int HUMTraceReplayCompareDoubles(const void *a, const void *b) {
+	double first = *(const double *)a;
+	double second = *(const double *)b;
+
+	return (first > second) - (first < second);
+}
+
+/**
+ *	The median of the ratios of two sets of latencies.
+ */
+static double HUMTraceReplayMedianRatio(const uint64_t *numerators, const uint64_t *denominators, int32_t count) {
+	double *ratios = malloc((size_t)(count ? count : 1) * sizeof(double));
+	int32_t ratioCount = 0;
+
+	for (int32_t i = 0; ratios && i < count; i++) {
+		if (denominators[i] > 0) {
+			ratios[ratioCount++] = (double)numerators[i] / denominators[i];
+		}
+	}
+
+	double median = 0.0;
+
+	if (ratioCount > 0) {
+		qsort(ratios, (size_t)ratioCount, sizeof(double), HUMTraceReplayCompareDoubles);
+		median = ratios[ratioCount / 2];
+	}
+
+	free(ratios);
+
+	return median;
+}
+
+static void HUMTraceReplayPrintUsage(void) {
+	fprintf(stderr,
+			"usage: humtracereplay TRACE [options]\n"
+			"\n"
+			"  --repeat COUNT   run every query COUNT times and keep the fastest. Defaults to 1.\n"
+			"  --csv PATH       write the replayed result and latency of every query to a CSV file.\n"
+			"  --baseline PATH  compare the replayed latencies with those of a CSV file written by an earlier replay.\n"
+			"  --quiet          only print the summary.\n");
+}
+
+static const char *HUMTraceReplayResultName(HUMTraceResult result) {
+	switch (result) {
+		case HUMTraceResultNoPath:
+			return "no path";
+
+		case HUMTraceResultPath:
+			return "path";
+
+		case HUMTraceResultNone:
+		default:
+			return "nil";
+	}
+}
+
+int main(int argc, const char * argv[]) {
+	const char *tracePath = NULL;
+	const char *csvPath = NULL;
+	const char *baselinePath = NULL;
+	int32_t repeatCount = 1;
+	bool quiet = false;
+
+	for (int i = 1; i < argc; i++) {
+		const char *argument = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (strcmp(argument, "--quiet") == 0) {
+			quiet = true;
+			continue;
+		}
+		else if (argument[0] != '-' && !tracePath) {
+			tracePath = argument;
+			continue;
+		}
+		else if (strcmp(argument, "--repeat") == 0 && value && sscanf(value, "%d", &repeatCount) == 1 && repeatCount > 0) {
+		}
+		else if (strcmp(argument, "--csv") == 0 && value) {
+			csvPath = value;
+		}
+		else if (strcmp(argument, "--baseline") == 0 && value) {
+			baselinePath = value;
+		}
+		else {
+			HUMTraceReplayPrintUsage();
+			return 1;
+		}
+
+		i++;
+	}
+
+	if (!tracePath) {
+		HUMTraceReplayPrintUsage();
+		return 1;
+	}
+
+	HUMTraceStatus status = HUMTraceStatusOK;
+	HUMTraceReader *reader = HUMTraceReaderOpen(tracePath, &status);
+
+	if (!reader) {
+		fprintf(stderr, "humtracereplay: couldn't open %s%s\n", tracePath, status == HUMTraceStatusUnsupportedVersion ? ", it was written by a newer version" : "");
+		return 1;
+	}
+
+	int32_t baselineCount = 0;
+	uint64_t *baseline = NULL;
+
+	if (baselinePath) {
+		baseline = HUMTraceReplayReadBaseline(baselinePath, &baselineCount);
+
+		if (!baseline) {
+			fprintf(stderr, "humtracereplay: couldn't read %s\n", baselinePath);
+			return 1;
+		}
+	}
+
+	HUMTraceReplayState state = { 0 };
+	HUMTraceReplayQuery *queries = NULL;
+	int32_t queryCount = 0;
+	int32_t queryCapacity = 0;
+	bool hasMap = false;
+	HUMTraceRecord record;
+
+	while ((status = HUMTraceReaderNext(reader, &record)) == HUMTraceStatusOK) {
+		switch (record.type) {
+			case HUMTraceRecordMap:
+				hasMap = HUMTraceReplayLoadMap(&state, &record.map);
+				break;
+
+			case HUMTraceRecordEdit:
+				if (hasMap) {
+					HUMTraceReplayApplyEdit(&state, &record.edit);
+				}
+				break;
+
+			case HUMTraceRecordSettings:
+				HUMTraceReplayApplySettings(&state, &record.settings);
+				break;
+
+			case HUMTraceRecordQuery: {
+				if (!hasMap) {
+					break;
+				}
+
+				if (queryCount == queryCapacity) {
+					queryCapacity = queryCapacity ? queryCapacity * 2 : 256;
+					HUMTraceReplayQuery *grown = realloc(queries, (size_t)queryCapacity * sizeof(HUMTraceReplayQuery));
+
+					if (!grown) {
+						fprintf(stderr, "humtracereplay: out of memory\n");
+						return 1;
+					}
+
+					queries = grown;
+				}
+
+				HUMTraceReplayQuery *replayed = &queries[queryCount++];
+				replayed->recorded = record.query;
+				replayed->latency = UINT64_MAX;
+
+				for (int32_t i = 0; i < repeatCount; i++) {
+					uint64_t start = HUMTraceReplayNow();
+					replayed->result = HUMTraceReplayRunQuery(&state, &record.query, &replayed->pathCount);
+					uint64_t latency = HUMTraceReplayNow() - start;
+
+					replayed->latency = latency < replayed->latency ? latency : replayed->latency;
+				}
+				break;
+			}
+
+			case HUMTraceRecordSnapshot:
+			default:
+				break;
+		}
+	}
+
+	HUMTraceReaderClose(reader);
+	HUMTraceReplayDiscardDerivedState(&state);
+	free(state.walkable);
+	free(state.costs);
+
+	if (status != HUMTraceStatusEnd) {
+		fprintf(stderr, "humtracereplay: %s is damaged, replayed the %d queries before the damage\n", tracePath, queryCount);
+	}
+
+	FILE *csv = NULL;
+
+	if (csvPath) {
+		csv = fopen(csvPath, "w");
+
+		if (!csv) {
+			fprintf(stderr, "humtracereplay: couldn't create %s\n", csvPath);
+			return 1;
+		}
+
+		fprintf(csv, "query,search_mode,unit_size,result,path_count,recorded_ns,replayed_ns\n");
+	}
+
+	uint64_t *recordedLatencies = malloc((size_t)(queryCount ? queryCount : 1) * sizeof(uint64_t));
+	uint64_t *replayedLatencies = malloc((size_t)(queryCount ? queryCount : 1) * sizeof(uint64_t));
+
+	if (!recordedLatencies || !replayedLatencies) {
+		fprintf(stderr, "humtracereplay: out of memory\n");
+		return 1;
+	}
+
+	uint64_t recordedTotal = 0;
+	uint64_t replayedTotal = 0;
+	uint64_t baselineTotal = 0;
+	int32_t mismatches = 0;
+
+	for (int32_t i = 0; i < queryCount; i++) {
+		const HUMTraceReplayQuery *query = &queries[i];
+		const HUMTraceQuery *recorded = &query->recorded;
+		bool mismatch = (query->result != recorded->result || (query->result == HUMTraceResultPath && query->pathCount != recorded->pathCount));
+
+		recordedLatencies[i] = recorded->latency;
+		replayedLatencies[i] = query->latency;
+		recordedTotal += recorded->latency;
+		replayedTotal += query->latency;
+		mismatches += mismatch ? 1 : 0;
+
+		if (baseline && i < baselineCount) {
+			baselineTotal += baseline[i];
+		}
+
+		if (csv) {
+			fprintf(csv, "%d,%u,%u,%u,%u,%llu,%llu\n", i, recorded->searchMode, recorded->unitSize, (unsigned int)query->result, query->pathCount, (unsigned long long)recorded->latency, (unsigned long long)query->latency);
+		}
+
+		if (quiet) {
+			continue;
+		}
+
+		printf("%6d  mode %u  unit %u  (%d, %d) -> (%d, %d)  recorded %9.1f us  replayed %9.1f us", i, recorded->searchMode, recorded->unitSize, recorded->startX, recorded->startY, recorded->targetX, recorded->targetY, recorded->latency / 1000.0, query->latency / 1000.0);
+
+		if (baseline && i < baselineCount) {
+			printf("  baseline %9.1f us  %+6.1f%%", baseline[i] / 1000.0, baseline[i] ? 100.0 * ((double)query->latency - baseline[i]) / baseline[i] : 0.0);
+		}
+
+		if (mismatch) {
+			printf("  recorded %s of %u points, replayed %s of %u points", HUMTraceReplayResultName(recorded->result), recorded->pathCount, HUMTraceReplayResultName(query->result), query->pathCount);
+		}
+
+		printf("\n");
+	}
+
+	if (csv && fclose(csv) != 0) {
+		fprintf(stderr, "humtracereplay: couldn't write %s\n", csvPath);
+	}
+
+	printf("queries        %d, each replayed %d %s\n", queryCount, repeatCount, repeatCount == 1 ? "time" : "times, keeping the fastest");
+	printf("recorded       %.3f ms in total\n", recordedTotal / 1e6);
+	printf("replayed       %.3f ms in total, the median query took %.2fx the time it was recorded with\n", replayedTotal / 1e6, HUMTraceReplayMedianRatio(replayedLatencies, recordedLatencies, queryCount));
+
+	if (baseline) {
+		int32_t comparedCount = queryCount < baselineCount ? queryCount : baselineCount;
+
+		printf("baseline       %.3f ms in total over %d queries, the median query took %.2fx the time of the baseline\n", baselineTotal / 1e6, comparedCount, HUMTraceReplayMedianRatio(replayedLatencies, baseline, comparedCount));
+
+		if (baselineCount != queryCount) {
+			printf("the baseline has %d queries, the trace %d\n", baselineCount, queryCount);
+		}
+	}
+
+	printf("%d of %d queries replayed with a different result or path length than they were recorded with\n", mismatches, queryCount);
+
+	free(recordedLatencies);
+	free(replayedLatencies);
+	free(queries);
+	free(baseline);
+
+	return 0;
+}
@@ -0,0 +1,364 @@
+//
+//  main.c
+//  HUMVisibilityGraphCheck
+//
+//  Created by Colin Humber on 7/29/13.
+//  Copyright (c) 2013 Colin Humber. All rights reserved.
+//
+//  Checks the visibility graph's paths. Walls of unwalkable tiles that only touch at their corners must stop a path, as they stop grid A*.
+//  On random maps, a path must be found exactly when the start and target tiles are connected through shared edges. It must never be longer
+//  than the shortest grid path, every segment must be a line of sight, and it must never turn from one side of a corner between two
+//  unwalkable tiles to the other. Graphs brought up to date with HUMVisibilityGraphUpdate must find paths as long as freshly built ones.
+//  Exits with 1 if any check fails.
+//
+//  Build from the root of the repository with:
+//
+//	cc -std=gnu99 -O2 -IHUMAStarPathfinder Tools/HUMVisibilityGraphCheck/main.c HUMAStarPathfinder/HUMAStarPathfinderVisibilityGraph.c -lm -o humvisibilitycheck
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HUMAStarPathfinderVisibilityGraph.h"
+
+#define HUMVisibilityGraphCheckMaximumSize 24
+#define HUMVisibilityGraphCheckTolerance 1e-3
+
+static uint32_t HUMVisibilityGraphCheckSeed = 1;
+
+static int32_t HUMVisibilityGraphCheckRandom(int32_t count) {
+	HUMVisibilityGraphCheckSeed = HUMVisibilityGraphCheckSeed * 1103515245 + 12345;
+	return (int32_t)((HUMVisibilityGraphCheckSeed >> 8) % (uint32_t)count);
+}
+
+static bool HUMVisibilityGraphCheckIsBlocked(const uint8_t *walkable, int32_t width, int32_t height, int32_t x, int32_t y) {
+	return x < 0 || y < 0 || x >= width || y >= height || !walkable[y * width + x];
+}
+
+#pragma mark - Reference
+
+/**
+ *	Determines if two tiles are connected through tiles that share an edge, which is how a path that can't squeeze between unwalkable tiles
+ *  touching at a corner gets around.
+ */
+static bool HUMVisibilityGraphCheckConnected(const uint8_t *walkable, int32_t width, int32_t height, int32_t start, int32_t target) {
+	int32_t stack[HUMVisibilityGraphCheckMaximumSize * HUMVisibilityGraphCheckMaximumSize];
+	uint8_t seen[HUMVisibilityGraphCheckMaximumSize * HUMVisibilityGraphCheckMaximumSize] = { 0 };
+	int32_t count = 0;
+	const int32_t offsetX[4] = { 1, -1, 0, 0 };
+	const int32_t offsetY[4] = { 0, 0, 1, -1 };
+
+	stack[count++] = start;
+	seen[start] = 1;
+
+	while (count > 0) {
+		int32_t tile = stack[--count];
+
+		if (tile == target) {
+			return true;
+		}
+
+		for (int i = 0; i < 4; i++) {
+			int32_t x = tile % width + offsetX[i];
+			int32_t y = tile / width + offsetY[i];
+
+			if (!HUMVisibilityGraphCheckIsBlocked(walkable, width, height, x, y) && !seen[y * width + x]) {
+				seen[y * width + x] = 1;
+				stack[count++] = y * width + x;
+			}
+		}
+	}
+
+	return false;
+}
+
+/**
+ *	The length of the shortest path between the centers of two tiles moving between the centers of neighboring tiles, cutting a corner
+ *  diagonally only if one of the two tiles beside the move is walkable, as grid A* does by default. Any such path is also a path the
+ *  visibility graph can take, so the graph's path is never longer.
+ */
+static double HUMVisibilityGraphCheckGridLength(const uint8_t *walkable, int32_t width, int32_t height, int32_t start, int32_t target) {
+	double distances[HUMVisibilityGraphCheckMaximumSize * HUMVisibilityGraphCheckMaximumSize];
+	uint8_t done[HUMVisibilityGraphCheckMaximumSize * HUMVisibilityGraphCheckMaximumSize] = { 0 };
+	int32_t tileCount = width * height;
+
+	for (int32_t i = 0; i < tileCount; i++) {
+		distances[i] = INFINITY;
+	}
+
+	distances[start] = 0.0;
+
+	for (;;) {
+		int32_t tile = -1;
+
+		for (int32_t i = 0; i < tileCount; i++) {
+			if (!done[i] && distances[i] < INFINITY && (tile == -1 || distances[i] < distances[tile])) {
+				tile = i;
+			}
+		}
+
+		if (tile == -1 || tile == target) {
+			return tile == -1 ? INFINITY : distances[tile];
+		}
+
+		done[tile] = 1;
+
+		for (int32_t dy = -1; dy <= 1; dy++) {
+			for (int32_t dx = -1; dx <= 1; dx++) {
+				int32_t x = tile % width + dx;
+				int32_t y = tile / width + dy;
+
+				if ((dx == 0 && dy == 0) || HUMVisibilityGraphCheckIsBlocked(walkable, width, height, x, y)) {
+					continue;
+				}
+
+				if (dx != 0 && dy != 0 && HUMVisibilityGraphCheckIsBlocked(walkable, width, height, x, y - dy) && HUMVisibilityGraphCheckIsBlocked(walkable, width, height, x - dx, y)) {
+					continue;
+				}
+
+				double distance = distances[tile] + ((dx != 0 && dy != 0) ? M_SQRT2 : 1.0);
+
+				if (distance < distances[y * width + x]) {
+					distances[y * width + x] = distance;
+				}
+			}
+		}
+	}
+}
+
+/**
+ *	Determines if a path turns at a corner between two unwalkable tiles touching there and leaves on the other side of the diagonal than it
+ *  arrived on.
+ */
+static bool HUMVisibilityGraphCheckCrossesCorner(const uint8_t *walkable, int32_t width, int32_t height, const HUMVisibilityPath *path, int32_t point) {
+	double x = path->xs[point];
+	double y = path->ys[point];
+
+	if (x != floor(x) || y != floor(y)) {
+		return false;
+	}
+
+	int32_t cornerX = (int32_t)x;
+	int32_t cornerY = (int32_t)y;
+	bool topLeft = HUMVisibilityGraphCheckIsBlocked(walkable, width, height, cornerX - 1, cornerY - 1);
+	bool topRight = HUMVisibilityGraphCheckIsBlocked(walkable, width, height, cornerX, cornerY - 1);
+	bool bottomLeft = HUMVisibilityGraphCheckIsBlocked(walkable, width, height, cornerX - 1, cornerY);
+	bool bottomRight = HUMVisibilityGraphCheckIsBlocked(walkable, width, height, cornerX, cornerY);
+
+	if (topLeft + topRight + bottomLeft + bottomRight != 2 || topLeft != bottomRight) {
+		return false;
+	}
+
+	// which side of the blocked diagonal each neighboring point lies on, using the direction of the diagonal the two walkable tiles are on
+	double diagonalX = topLeft ? 1.0 : -1.0;
+	double diagonalY = -1.0;
+	double inX = path->xs[point - 1] - x;
+	double inY = path->ys[point - 1] - y;
+	double outX = path->xs[point + 1] - x;
+	double outY = path->ys[point + 1] - y;
+
+	return (inX * diagonalX + inY * diagonalY) * (outX * diagonalX + outY * diagonalY) < 0.0;
+}
+
+#pragma mark - Checks
+
+/**
+ *	Runs one query through a graph and checks its path.
+ *
+ *	@return	the number of failed checks.
+ */
+static int HUMVisibilityGraphCheckQuery(const HUMVisibilityGraph *graph, const uint8_t *walkable, int32_t start, int32_t target, const char *name, double *length) {
+	int32_t width = graph->width;
+	int32_t height = graph->height;
+	HUMVisibilityPath path;
+	bool found = HUMVisibilityGraphFindPath(graph, start % width + 0.5, start / width + 0.5, target % width + 0.5, target / width + 0.5, &path);
+	bool connected = HUMVisibilityGraphCheckConnected(walkable, width, height, start, target);
+	int failures = 0;
+
+	*length = found ? path.length : INFINITY;
+
+	if (found != connected) {
+		printf("%s: (%d, %d) to (%d, %d) %s a path, but the tiles are %s\n", name, start % width, start / width, target % width, target / width, found ? "found" : "didn't find", connected ? "connected" : "not connected");
+		failures++;
+	}
+
+	if (found) {
+		double gridLength = HUMVisibilityGraphCheckGridLength(walkable, width, height, start, target);
+		double straightLength = hypot(target % width - start % width, target / width - start / width);
+
+		if (path.length > gridLength + HUMVisibilityGraphCheckTolerance || path.length < straightLength - HUMVisibilityGraphCheckTolerance) {
+			printf("%s: (%d, %d) to (%d, %d) is %.3f long, outside %.3f to %.3f\n", name, start % width, start / width, target % width, target / width, path.length, straightLength, gridLength);
+			failures++;
+		}
+
+		for (int32_t i = 0; i + 1 < path.count; i++) {
+			if (!HUMVisibilityGraphLineOfSight(graph, path.xs[i], path.ys[i], path.xs[i + 1], path.ys[i + 1])) {
+				printf("%s: (%d, %d) to (%d, %d) has a blocked segment\n", name, start % width, start / width, target % width, target / width);
+				failures++;
+			}
+
+			if (i > 0 && HUMVisibilityGraphCheckCrossesCorner(walkable, width, height, &path, i)) {
+				printf("%s: (%d, %d) to (%d, %d) squeezes through the corner at (%g, %g)\n", name, start % width, start / width, target % width, target / width, path.xs[i], path.ys[i]);
+				failures++;
+			}
+		}
+	}
+
+	HUMVisibilityPathFree(&path);
+
+	return failures;
+}
+
+/**
+ *	A 5x5 map cut in two by a diagonal wall of tiles that only touch at their corners, in both directions. No path may cross it.
+ */
+static int HUMVisibilityGraphCheckDiagonalWalls(void) {
+	int failures = 0;
+
+	for (int direction = 0; direction < 2; direction++) {
+		uint8_t walkable[25];
+		memset(walkable, 1, sizeof(walkable));
+
+		for (int32_t i = 0; i < 5; i++) {
+			walkable[(direction ? i : 4 - i) * 5 + i] = 0;
+		}
+
+		HUMVisibilityGraph *graph = HUMVisibilityGraphCreate(5, 5, walkable);
+
+		if (!graph) {
+			fprintf(stderr, "humvisibilitycheck: out of memory\n");
+			exit(1);
+		}
+
+		int32_t start = direction ? 4 : 0;
+		int32_t target = direction ? 20 : 24;
+		HUMVisibilityPath path;
+
+		if (HUMVisibilityGraphFindPath(graph, start % 5 + 0.5, start / 5 + 0.5, target % 5 + 0.5, target / 5 + 0.5, &path)) {
+			printf("diagonal wall %d: found a path %.3f long through it\n", direction, path.length);
+			failures++;
+		}
+
+		HUMVisibilityPathFree(&path);
+		HUMVisibilityGraphFree(graph);
+	}
+
+	printf("%-36s %s\n", "diagonal walls", failures == 0 ? "ok" : "FAIL");
+
+	return failures;
+}
+
+/**
+ *	Random maps with queries between random walkable tiles. Half the maps get extra pairs of unwalkable tiles touching at a corner. Each map is
+ *  then changed a few times through HUMVisibilityGraphUpdate, and its paths compared with a freshly built graph's.
+ */
+static int HUMVisibilityGraphCheckRandomMaps(int mapCount) {
+	int failures = 0;
+	int queryCount = 0;
+
+	for (int m = 0; m < mapCount; m++) {
+		int32_t width = 2 + HUMVisibilityGraphCheckRandom(HUMVisibilityGraphCheckMaximumSize - 1);
+		int32_t height = 2 + HUMVisibilityGraphCheckRandom(HUMVisibilityGraphCheckMaximumSize - 1);
+		int32_t blockedPercent = 5 + HUMVisibilityGraphCheckRandom(36);
+		uint8_t walkable[HUMVisibilityGraphCheckMaximumSize * HUMVisibilityGraphCheckMaximumSize];
+
+		for (int32_t i = 0; i < width * height; i++) {
+			walkable[i] = HUMVisibilityGraphCheckRandom(100) >= blockedPercent;
+		}
+
+		if (m % 2) {
+			for (int32_t k = 0; k < width * height / 8; k++) {
+				int32_t x = HUMVisibilityGraphCheckRandom(width - 1);
+				int32_t y = HUMVisibilityGraphCheckRandom(height - 1);
+				bool down = HUMVisibilityGraphCheckRandom(2);
+
+				walkable[y * width + x + (down ? 0 : 1)] = 0;
+				walkable[(y + 1) * width + x + (down ? 1 : 0)] = 0;
+				walkable[y * width + x + (down ? 1 : 0)] = 1;
+				walkable[(y + 1) * width + x + (down ? 0 : 1)] = 1;
+			}
+		}
+
+		HUMVisibilityGraph *graph = HUMVisibilityGraphCreate(width, height, walkable);
+
+		if (!graph) {
+			fprintf(stderr, "humvisibilitycheck: out of memory\n");
+			exit(1);
+		}
+
+		for (int update = 0; update < 3; update++) {
+			if (update > 0) {
+				int32_t rectWidth = 1 + HUMVisibilityGraphCheckRandom(width < 4 ? width : 4);
+				int32_t rectHeight = 1 + HUMVisibilityGraphCheckRandom(height < 4 ? height : 4);
+				int32_t rectX = HUMVisibilityGraphCheckRandom(width - rectWidth + 1);
+				int32_t rectY = HUMVisibilityGraphCheckRandom(height - rectHeight + 1);
+				uint8_t rect[16];
+
+				for (int32_t i = 0; i < rectWidth * rectHeight; i++) {
+					rect[i] = HUMVisibilityGraphCheckRandom(100) >= 50;
+				}
+
+				for (int32_t row = 0; row < rectHeight; row++) {
+					memcpy(&walkable[(rectY + row) * width + rectX], &rect[row * rectWidth], rectWidth);
+				}
+
+				if (!HUMVisibilityGraphUpdate(graph, rectX, rectY, rectWidth, rectHeight, rect)) {
+					fprintf(stderr, "humvisibilitycheck: out of memory\n");
+					exit(1);
+				}
+			}
+
+			HUMVisibilityGraph *freshGraph = update > 0 ? HUMVisibilityGraphCreate(width, height, walkable) : NULL;
+
+			if (update > 0 && !freshGraph) {
+				fprintf(stderr, "humvisibilitycheck: out of memory\n");
+				exit(1);
+			}
+
+			for (int q = 0; q < 8; q++) {
+				int32_t start = HUMVisibilityGraphCheckRandom(width * height);
+				int32_t target = HUMVisibilityGraphCheckRandom(width * height);
+
+				if (!walkable[start] || !walkable[target] || start == target) {
+					continue;
+				}
+
+				double length, freshLength;
+				failures += HUMVisibilityGraphCheckQuery(graph, walkable, start, target, update > 0 ? "updated map" : "random map", &length);
+				queryCount++;
+
+				if (freshGraph) {
+					failures += HUMVisibilityGraphCheckQuery(freshGraph, walkable, start, target, "rebuilt map", &freshLength);
+
+					if (fabs(length - freshLength) > HUMVisibilityGraphCheckTolerance && !(isinf(length) && isinf(freshLength))) {
+						printf("updated map: (%d, %d) to (%d, %d) is %.3f long, but %.3f in a rebuilt graph\n", start % width, start / width, target % width, target / width, length, freshLength);
+						failures++;
+					}
+				}
+			}
+
+			HUMVisibilityGraphFree(freshGraph);
+		}
+
+		HUMVisibilityGraphFree(graph);
+	}
+
+	printf("%-36s %s  %d queries\n", "random maps", failures == 0 ? "ok" : "FAIL", queryCount);
+
+	return failures;
+}
+
+int main(int argc, const char *argv[]) {
+	int mapCount = 2000;
+
+	if (argc > 1 && (sscanf(argv[1], "%d", &mapCount) != 1 || mapCount < 0)) {
+		fprintf(stderr, "usage: humvisibilitycheck [map count]\n");
+		return 1;
+	}
+
+	int failures = HUMVisibilityGraphCheckDiagonalWalls();
+	failures += HUMVisibilityGraphCheckRandomMaps(mapCount);
+
+	return failures == 0 ? 0 : 1;
+}